@@ -0,0 +1,549 @@
+/**
+ * @file bench.c
+ * @brief Benchmarks of the containers.
+ *
+ * Run by <tt>make bench</tt>, or as <tt>bench/bench [name ...]</tt> to run only
+ * the benchmarks whose names contain one of the arguments. Each benchmark runs
+ * at several sizes; each size runs in a child process, so that its peak
+ * resident set is its own, and reports the best of <tt>REPS</tt> runs as
+ * nanoseconds per operation and millions of operations per second.
+ *
+ * On Linux, the timed part of each run is also measured by hardware counters
+ * read through <tt>perf_event_open</tt>: cycles, instructions, L1 data and
+ * last level cache read misses, branch misses and data TLB read misses, each
+ * reported per operation for the fastest run. Counters the kernel or hardware
+ * does not provide are left out. With <tt>--json</tt> among the arguments the
+ * results are written as a JSON array of one object per size, for comparing
+ * runs.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <stdint.h>
+# include <string.h>
+# include <time.h>
+# include <unistd.h>
+# include <sys/resource.h>
+# include <sys/wait.h>
+# if HAVE_LINUX_PERF_EVENT_H
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+# endif
+
+# include <arrays.h>
+# include <bit_sets.h>
+# include <hashtabs.h>
+# include <queues.h>
+# include <stacks.h>
+# include <staticstacks.h>
+
+/**
+ * @brief Runs of each size, of which the fastest is reported.
+ */
+# define REPS 3
+
+/**
+ * @brief Largest number of sizes of a benchmark.
+ */
+# define SIZES 4
+
+/**
+ * @brief Number of hardware counters.
+ */
+# define COUNTERS 6
+
+/**
+ * @brief One benchmark.
+ */
+typedef struct {
+  const char *name;                 ///< name matched by the arguments
+  double (*run)(size_t n, size_t *ops); ///< seconds taken by <tt>*ops</tt> ops
+  size_t sizes[SIZES];              ///< sizes run, up to the first 0
+} bench_t;
+
+/**
+ * @brief Results are added here so that the timed loops are kept.
+ */
+static volatile uint64_t sink;
+
+static uint64_t rs = 88172645463325252ULL;
+
+static inline
+uint64_t _rnd(void)
+{
+  rs ^= rs << 13;
+  rs ^= rs >> 7;
+  rs ^= rs << 17;
+  return rs;
+}
+
+static inline
+double _now(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Names of the hardware counters, as written in the results.
+ */
+static const char *const counter_names[COUNTERS] = {
+  "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses",
+  "dtlb_misses"
+};
+
+/**
+ * @brief Column headings of the hardware counters.
+ */
+static const char *const counter_heads[COUNTERS] = {
+  "cyc/op", "ins/op", "L1d/op", "LLC/op", "brm/op", "dTLB/op"
+};
+
+# if HAVE_LINUX_PERF_EVENT_H
+/**
+ * @brief Configuration of a read miss event of a cache.
+ */
+#  define MISSES(c)                                                       \
+  ((c) | (PERF_COUNT_HW_CACHE_OP_READ << 8)                               \
+   | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/**
+ * @brief Events of the hardware counters.
+ */
+static const struct {
+  uint32_t type;   ///< type of event
+  uint64_t config; ///< event within type
+} counter_events[COUNTERS] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HW_CACHE, MISSES(PERF_COUNT_HW_CACHE_L1D) },
+  { PERF_TYPE_HW_CACHE, MISSES(PERF_COUNT_HW_CACHE_LL) },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { PERF_TYPE_HW_CACHE, MISSES(PERF_COUNT_HW_CACHE_DTLB) },
+};
+# endif
+
+/**
+ * @brief Descriptors of the hardware counters, -1 where unavailable.
+ */
+static int counter_fds[COUNTERS];
+
+/**
+ * @brief Counts of the last timed part, -1 where unavailable.
+ */
+static double counts[COUNTERS];
+
+/* opens the counters of this process, disabled, counting user space only */
+static
+void _counters_open(void)
+{
+  for ( int i = 0; i < COUNTERS; i++ ) {
+    counter_fds[i] = -1;
+# if HAVE_LINUX_PERF_EVENT_H
+    struct perf_event_attr a;
+    memset(&a, 0, sizeof(a));
+    a.size = sizeof(a);
+    a.type = counter_events[i].type;
+    a.config = counter_events[i].config;
+    a.disabled = 1;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    a.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+      | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    counter_fds[i] = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+# endif
+  }
+}
+
+/* starts the timed part of a run: resets and enables the counters */
+static inline
+double _tic(void)
+{
+# if HAVE_LINUX_PERF_EVENT_H
+  for ( int i = 0; i < COUNTERS; i++ )
+    if ( counter_fds[i] >= 0 ) {
+      ioctl(counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+# endif
+  return _now();
+}
+
+/*
+ * ends the timed part of a run started at t, returning its seconds; the
+ * counters are read into counts, scaled up if they were multiplexed
+ */
+static inline
+double _toc(double t)
+{
+  t = _now() - t;
+  for ( int i = 0; i < COUNTERS; i++ ) {
+    counts[i] = -1;
+# if HAVE_LINUX_PERF_EVENT_H
+    uint64_t v[3];
+    if ( counter_fds[i] < 0 ) continue;
+    ioctl(counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    if ( read(counter_fds[i], v, sizeof(v)) == sizeof(v) && v[2] != 0 )
+      counts[i] = (double)v[0] * ((double)v[1] / (double)v[2]);
+# endif
+  }
+  return t;
+}
+
+static
+int _cmp(const void *x, const void *y)
+{
+  uint32_t a = *(const uint32_t*)x, b = *(const uint32_t*)y;
+  return (a > b) - (a < b);
+}
+
+static
+uint64_t _hash(const void *x)
+{
+  uint64_t h = *(const uint32_t*)x * 0x9E3779B97F4A7C15ULL;
+  return h ^ (h >> 29);
+}
+
+/* n distinct keys, in random order; odd keys when miss is set */
+static
+uint32_t *_keys(size_t n, int miss)
+{
+  uint32_t *k = (uint32_t*)malloc(n * sizeof(*k));
+  for ( size_t i = 0; i < n; i++ ) k[i] = (uint32_t)(2 * i + (miss != 0));
+  for ( size_t i = n; i > 1; i-- ) {
+    size_t j = _rnd() % i;
+    uint32_t t = k[i - 1];
+    k[i - 1] = k[j];
+    k[j] = t;
+  }
+  return k;
+}
+
+static
+hashtabs_t _table(const uint32_t *k, size_t n, int pooled)
+{
+  hashtabs_t t = pooled ? hashtabs_new_pooled(_cmp, NULL, _hash, NULL, 16)
+    : hashtabs_new(_cmp, NULL, _hash, NULL, 16);
+  for ( size_t i = 0; i < n; i++ ) hashtabs_insert(t, k + i);
+  return t;
+}
+
+static
+double _insert(size_t n, size_t *ops, int pooled)
+{
+  uint32_t *k = _keys(n, 0);
+  double t = _tic();
+  hashtabs_t h = _table(k, n, pooled);
+  t = _toc(t);
+  sink += hashtabs_size(h);
+  hashtabs_free(&h);
+  free(k);
+  *ops = n;
+  return t;
+}
+
+static
+double _hashtabs_insert(size_t n, size_t *ops)
+{
+  return _insert(n, ops, 0);
+}
+
+static
+double _hashtabs_insert_pooled(size_t n, size_t *ops)
+{
+  return _insert(n, ops, 1);
+}
+
+static
+double _find(size_t n, size_t *ops, int miss)
+{
+  uint32_t *k = _keys(n, 0), *q = _keys(n, miss);
+  hashtabs_t h = _table(k, n, 0);
+  double t = _tic();
+  for ( size_t i = 0; i < n; i++ ) sink += hashtabs_find(h, q + i) != NULL;
+  t = _toc(t);
+  hashtabs_free(&h);
+  free(k);
+  free(q);
+  *ops = n;
+  return t;
+}
+
+static
+double _hashtabs_find_hit(size_t n, size_t *ops)
+{
+  return _find(n, ops, 0);
+}
+
+static
+double _hashtabs_find_miss(size_t n, size_t *ops)
+{
+  return _find(n, ops, 1);
+}
+
+static
+double _enqueu(size_t n, size_t *ops, int ascending)
+{
+  uint32_t *k = _keys(n, 0);
+  if ( ascending ) for ( size_t i = 0; i < n; i++ ) k[i] = (uint32_t)i;
+  queues_t q = queues_new(_cmp, NULL);
+  double t = _tic();
+  for ( size_t i = 0; i < n; i++ ) queues_enqueu(q, k + i);
+  t = _toc(t);
+  sink += queues_size(q);
+  queues_free(&q);
+  free(k);
+  *ops = n;
+  return t;
+}
+
+static
+double _queues_enqueu_random(size_t n, size_t *ops)
+{
+  return _enqueu(n, ops, 0);
+}
+
+static
+double _queues_enqueu_ascending(size_t n, size_t *ops)
+{
+  return _enqueu(n, ops, 1);
+}
+
+static
+double _stacks_push_pop(size_t n, size_t *ops)
+{
+  uint32_t x = 0;
+  stacks_t s = stacks_new();
+  double t = _tic();
+  for ( size_t i = 0; i < n; i++ ) stacks_push(s, &x);
+  for ( size_t i = 0; i < n; i++ ) sink += (uintptr_t)stacks_pop(s);
+  t = _toc(t);
+  stacks_free(&s);
+  *ops = 2 * n;
+  return t;
+}
+
+static
+double _sstacks_push_pop(size_t n, size_t *ops)
+{
+  sstacks_t *s;
+  sstacks_new(s, sizeof(uint32_t), n);
+  double t = _tic();
+  for ( uint32_t i = 0; i < n; i++ ) sstacks_push(s, &i);
+  for ( size_t i = 0; i < n; i++ ) sink += *(uint32_t*)sstacks_pop(s);
+  t = _toc(t);
+  sstacks_free(s);
+  *ops = 2 * n;
+  return t;
+}
+
+static
+double _arrays_dynpush(size_t n, size_t *ops)
+{
+  arrays_t a = arrays_new(sizeof(uint32_t), 1);
+  double t = _tic();
+  for ( uint32_t i = 0; i < n; i++ ) arrays_dynpush(a, &i);
+  t = _toc(t);
+  sink += arrays_nmem(a);
+  arrays_free(&a);
+  *ops = n;
+  return t;
+}
+
+static
+double _arrays_sort(size_t n, size_t *ops)
+{
+  arrays_t a = arrays_new(sizeof(uint32_t), n);
+  for ( size_t i = 0; i < n; i++ ) {
+    uint32_t x = (uint32_t)_rnd();
+    arrays_push(a, &x);
+  }
+  double t = _tic();
+  arrays_sort(a, _cmp);
+  t = _toc(t);
+  sink += *(uint32_t*)arrays_at(a, 0);
+  arrays_free(&a);
+  *ops = n;
+  return t;
+}
+
+/* set of n elements, each present with probability one half */
+static
+sets_t *_set(size_t n, size_t *m)
+{
+  *m = _SETWORDSNEEDED(n);
+  sets_t *s = (sets_t*)malloc(*m * sizeof(sets_t));
+  for ( size_t i = 0; i < *m; i++ ) s[i] = _rnd();
+  if ( n % _WORDSIZE ) s[*m - 1] &= ~_BITMASK(n % _WORDSIZE - 1);
+  return s;
+}
+
+/* each op is one setword; small sets are counted repeatedly */
+static
+double _bit_setsize(size_t n, size_t *ops)
+{
+  size_t m;
+  sets_t *s = _set(n, &m);
+  size_t reps = ((size_t)1 << 24) / m + 1;
+  double t = _tic();
+  for ( size_t r = 0; r < reps; r++ ) sink += bit_setsize(s, m);
+  t = _toc(t);
+  free(s);
+  *ops = reps * m;
+  return t;
+}
+
+/* each op is one element visited */
+static
+double _bit_nextelement(size_t n, size_t *ops)
+{
+  size_t m, count = 0;
+  sets_t *s = _set(n, &m);
+  size_t reps = ((size_t)1 << 23) / n + 1;
+  double t = _tic();
+  for ( size_t r = 0; r < reps; r++ )
+    for ( int p = -1; (p = bit_nextelement(s, m, p)) >= 0; count++ ) sink += p;
+  t = _toc(t);
+  free(s);
+  *ops = count;
+  return t;
+}
+
+static const bench_t benches[] = {
+  { "hashtabs_insert", _hashtabs_insert, { 1000, 100000, 1000000, 0 } },
+  { "hashtabs_insert_pooled", _hashtabs_insert_pooled,
+    { 1000, 100000, 1000000, 0 } },
+  { "hashtabs_find_hit", _hashtabs_find_hit, { 1000, 100000, 1000000, 0 } },
+  { "hashtabs_find_miss", _hashtabs_find_miss, { 1000, 100000, 1000000, 0 } },
+  { "queues_enqueu_random", _queues_enqueu_random, { 100, 1000, 10000, 0 } },
+  { "queues_enqueu_ascending", _queues_enqueu_ascending,
+    { 1000, 100000, 1000000, 0 } },
+  { "stacks_push_pop", _stacks_push_pop, { 1000, 100000, 10000000, 0 } },
+  { "sstacks_push_pop", _sstacks_push_pop, { 1000, 100000, 10000000, 0 } },
+  { "arrays_dynpush", _arrays_dynpush, { 1000, 100000, 10000000, 0 } },
+  { "arrays_sort", _arrays_sort, { 1000, 100000, 1000000, 0 } },
+  { "bit_setsize", _bit_setsize, { 64, 4096, 1 << 20, 1 << 26 } },
+  { "bit_nextelement", _bit_nextelement, { 64, 4096, 1 << 20, 1 << 26 } },
+};
+
+/*
+ * runs one size in a child process, placing the counts per operation of the
+ * fastest run in c; returns -1 if the child failed
+ */
+static
+int _case(const bench_t *b, size_t n, double *ns, long *rss,
+          double c[static COUNTERS])
+{
+  int fd[2];
+  double r[2 + COUNTERS] = { 0 };
+  if ( pipe(fd) != 0 ) return -1;
+  pid_t pid = fork();
+  if ( pid < 0 ) return -1;
+  if ( pid == 0 ) {
+    close(fd[0]);
+    _counters_open();
+    for ( int i = 0; i < REPS; i++ ) {
+      size_t ops;
+      double t = b->run(n, &ops) / (double)ops;
+      if ( i == 0 || t < r[0] ) {
+        r[0] = t;
+        for ( int j = 0; j < COUNTERS; j++ )
+          r[2 + j] = counts[j] < 0 ? -1 : counts[j] / (double)ops;
+      }
+      r[1] = (double)ops;
+    }
+    _exit(write(fd[1], r, sizeof(r)) == sizeof(r) ? 0 : 1);
+  }
+  close(fd[1]);
+  ssize_t got = read(fd[0], r, sizeof(r));
+  close(fd[0]);
+  int status;
+  struct rusage ru;
+  if ( wait4(pid, &status, 0, &ru) < 0 || got != sizeof(r)
+       || !WIFEXITED(status) || WEXITSTATUS(status) != 0 )
+    return -1;
+  *ns = r[0] * 1e9;
+  *rss = ru.ru_maxrss;
+  memcpy(c, r + 2, sizeof(double) * COUNTERS);
+  return 1;
+}
+
+static
+int _selected(const char *name, int argc, char **argv)
+{
+  int filtered = 0;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "--json") == 0 ) continue;
+    filtered = 1;
+    if ( strstr(name, argv[i]) != NULL ) return 1;
+  }
+  return !filtered;
+}
+
+/* one row of the table */
+static
+void _row(const bench_t *b, size_t n, double ns, long rss,
+          const double c[static COUNTERS])
+{
+  printf("%-24s %10zu %10.2f %10.2f %12ld", b->name, n, ns, 1e3 / ns, rss);
+  for ( int i = 0; i < COUNTERS; i++ )
+    if ( c[i] < 0 ) printf(" %9s", "-");
+    else printf(" %9.2f", c[i]);
+  printf("\n");
+}
+
+/* one object of the JSON array, after another if first is not set */
+static
+void _object(const bench_t *b, size_t n, double ns, long rss,
+             const double c[static COUNTERS], int first)
+{
+  printf("%s\n  { \"benchmark\": \"%s\", \"size\": %zu, ", first ? "" : ",",
+         b->name, n);
+  if ( ns < 0 ) {
+    printf("\"failed\": true }");
+    return;
+  }
+  printf("\"ns_per_op\": %.4f, \"mops\": %.4f, \"peak_rss_kb\": %ld, "
+         "\"per_op\": {", ns, 1e3 / ns, rss);
+  for ( int i = 0, k = 0; i < COUNTERS; i++ )
+    if ( c[i] >= 0 )
+      printf("%s \"%s\": %.4f", k++ ? "," : "", counter_names[i], c[i]);
+  printf(" } }");
+}
+
+int main(int argc, char **argv)
+{
+  int status = EXIT_SUCCESS, json = 0, first = 1;
+  for ( int i = 1; i < argc; i++ )
+    if ( strcmp(argv[i], "--json") == 0 ) json = 1;
+  if ( json ) printf("[");
+  else {
+    printf("%-24s %10s %10s %10s %12s", "benchmark", "size", "ns/op", "Mop/s",
+           "peak RSS KB");
+    for ( int i = 0; i < COUNTERS; i++ ) printf(" %9s", counter_heads[i]);
+    printf("\n");
+  }
+  fflush(stdout);
+  for ( size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++ ) {
+    const bench_t *b = benches + i;
+    if ( !_selected(b->name, argc, argv) ) continue;
+    for ( size_t j = 0; j < SIZES && b->sizes[j] != 0; j++ ) {
+      double ns, c[COUNTERS];
+      long rss;
+      if ( _case(b, b->sizes[j], &ns, &rss, c) < 0 ) {
+        status = EXIT_FAILURE;
+        if ( json ) _object(b, b->sizes[j], -1, 0, c, first);
+        else printf("%-24s %10zu %10s\n", b->name, b->sizes[j], "failed");
+      }
+      else if ( json ) _object(b, b->sizes[j], ns, rss, c, first);
+      else _row(b, b->sizes[j], ns, rss, c);
+      first = 0;
+      fflush(stdout);
+    }
+  }
+  if ( json ) printf("\n]\n");
+  return status;
+}
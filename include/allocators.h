@@ -0,0 +1,75 @@
+/**
+ * @file allocators.h
+ * @brief Public interface of <tt>allocators_t</tt> allocator vtable
+ *
+ * An <tt>allocators_t</tt> bundles the three functions through which a container
+ * obtains and returns memory, together with a context pointer passed to each of
+ * them. Every container constructor of this library has a variant with suffix
+ * <tt>_new_alloc</tt> taking an allocator as its last argument; the container
+ * then makes every allocation of its own through that allocator, and the
+ * constructors without the suffix use <tt>allocators_std</tt>. This lets memory
+ * come from an arena, a NUMA node or huge pages without changing the containers.
+ *
+ * The allocator is copied into the container, so the <tt>allocators_t</tt>
+ * object need not outlive the call to the constructor, but its context must
+ * outlive the container.
+ *
+ * An allocation returning <tt>NULL</tt> is treated as fatal, as is a failing
+ * <tt>malloc</tt> elsewhere in this library.
+ *
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_ALLOCATORS_H
+# define INCLUDED_ALLOCATORS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+/**
+ * @brief Allocator vtable.
+ */
+typedef struct {
+  void *(*alloc)(size_t n, void *ctx);            ///< allocate <tt>n</tt> bytes
+  void *(*realloc)(void *p, size_t n, void *ctx); ///< resize <tt>p</tt> to n bytes
+  void (*free)(void *p, void *ctx);               ///< release <tt>p</tt>
+  void *ctx;                                      ///< context of the functions
+} allocators_t;
+
+/**
+ * @brief Allocator using <tt>malloc</tt>, <tt>realloc</tt> and <tt>free</tt>.
+ *
+ * Its functions ignore their context, which is <tt>NULL</tt>.
+ */
+extern const allocators_t allocators_std;
+
+/**
+ * @brief Allocator of memory aligned to 64 bytes.
+ *
+ * Allocations start on a cache line, as needed by aligned vector loads. A
+ * reallocation that <tt>realloc</tt> leaves misaligned is copied once more.
+ * Memory is freed by <tt>free</tt>. Its functions ignore their context, which
+ * is <tt>NULL</tt>.
+ */
+extern const allocators_t allocators_aligned;
+
+/**
+ * @brief Allocator of memory backed by transparent huge pages.
+ *
+ * Allocations of at least 1 MB are anonymous mappings aligned to 2 MB and
+ * advised with <tt>MADV_HUGEPAGE</tt>, so that an array of several GB needs few
+ * TLB entries. Such mappings shrink in place, and on Linux grow with
+ * <tt>mremap</tt>, which moves pages rather than copying bytes. Smaller
+ * allocations come from <tt>allocators_aligned</tt>. All allocations are aligned
+ * to 64 bytes, and are preceded by a 64-byte header. Its functions ignore their
+ * context, which is <tt>NULL</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Passing memory not from this allocator to its functions.</dd>
+ * </dl>
+ */
+extern const allocators_t allocators_huge;
+
+# endif
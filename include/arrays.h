@@ -7,6 +7,14 @@
  * to generate an <tt>arrays_t</tt> instance. The function <tt>arrays_push</tt>
  * copies the data passed to it by the user.
  *
+ * If <tt>CONTAINERS_INLINE</tt> is defined before this header is included,
+ * <tt>arrays_push</tt>, <tt>arrays_at</tt>, <tt>arrays_nmem</tt>,
+ * <tt>arrays_capacity</tt> and <tt>arrays_size</tt> are defined as
+ * <tt>static inline</tt> functions reading the array object through
+ * <tt>struct arrays_head_t</tt>, so that element access in a loop costs no
+ * call. The library is built without it, so both kinds of translation unit can
+ * be linked together.
+ *
  * @warning This class is meant to be used in time restricted settings. As such,
  * some runtime errors, such as out-of-bounds-type errors, are note explicitly
  * checked for. It is left to the user to use the interface responsibly.
@@ -17,14 +25,45 @@
 # ifndef INCLUDED_ARRAYS_H
 # define INCLUDED_ARRAYS_H
 
+# include <stdio.h>
 # include <stddef.h>
 # include <stdlib.h>
 # include <errno.h>
 # include <error.h>
 # include <string.h>
 
+# include "allocators.h"
+# include "configs.h"
+# include "workers.h"
+
 typedef struct arrays_t* arrays_t;
 
+/**
+ * @brief Leading members of an array object, as laid out by arrays.c.
+ *
+ * Read by the inline functions of <tt>CONTAINERS_INLINE</tt>, and not to be
+ * written by the user.
+ */
+struct
+# ifdef __GNUC__
+__attribute__((__may_alias__))
+# endif
+arrays_head_t {
+  size_t size;     ///< size of elements of array
+  size_t capacity; ///< number of possible elements of the array
+  size_t nmem;     ///< number of elements currently in array
+  char *x;         ///< data array
+};
+
+/**
+ * @brief Growth policies of <tt>arrays_dynpush</tt> and <tt>arrays_append</tt>.
+ */
+typedef enum {
+  ARRAYS_GROW_3_2,  ///< capacity 1, 2, then times 3/2, the default
+  ARRAYS_GROW_2,    ///< capacity doubles
+  ARRAYS_GROW_PAGE  ///< capacity times 3/2, data rounded up to 4096 bytes
+} arrays_growth_t;
+
 /**
  * @brief Instantiates an <tt>arrays_t</tt> instance.
  *
@@ -43,6 +82,98 @@ typedef struct arrays_t* arrays_t;
  */
 extern arrays_t arrays_new(size_t size, size_t capacity);
 
+/**
+ * @brief Instantiates an <tt>arrays_t</tt> instance with a user allocator.
+ *
+ * As <tt>arrays_new</tt>, but the array object and its data array are
+ * allocated, resized and freed through <tt>al</tt>. With
+ * <tt>allocators_aligned</tt> the data array starts on a cache line, and with
+ * <tt>allocators_huge</tt> a large data array also lies in huge pages and grows
+ * without being copied.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to totoal size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Initialize array to hold <tt>capacity</tt> elements.
+ * @param[in] al Allocator of the array.
+ *
+ * @return Instance of an allocated array object.
+ */
+extern arrays_t arrays_new_alloc(size_t size, size_t capacity,
+                                 const allocators_t *al);
+
+/**
+ * @brief Instantiates a file backed <tt>arrays_t</tt> instance.
+ *
+ * The file at <tt>path</tt> is created, or truncated if it exists, to a header
+ * followed by room for <tt>capacity</tt> elements, and is mapped into memory.
+ * The elements of the array are the bytes of the file: growing the array grows
+ * the file, and the elements persist once the array is freed. The header
+ * records the size and number of elements, and is updated by
+ * <tt>arrays_sync</tt> and <tt>arrays_free</tt>. The array object needs to be
+ * freed by a call to <tt>arrays_free</tt>, which unmaps the file.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to totoal size of data.</dd>
+ * <dd>Elements hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] path Path of file backing the array.
+ * @param[in] size Size of elements of the array.
+ * @param[in] capacity Number of possible elements of the array.
+ *
+ * @return Instance of array object. <tt>NULL</tt> if the file could not be
+ * created or mapped, with <tt>errno</tt> set.
+ */
+extern arrays_t arrays_create(const char *path, size_t size, size_t capacity);
+
+/**
+ * @brief Instantiates an <tt>arrays_t</tt> instance from a file.
+ *
+ * The file at <tt>path</tt>, written by an array of <tt>arrays_create</tt>, is
+ * mapped into memory, so that the elements are read from disk as they are
+ * used rather than loaded up front. The capacity of the array is that of the
+ * file. If <tt>writable</tt> is zero the file is mapped read-only, and functions
+ * changing the array must not be called. The array object needs to be freed by
+ * a call to <tt>arrays_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Changing an array mapped read-only.</dd>
+ * <dd>The file being changed by another process while mapped.</dd>
+ * </dl>
+ *
+ * @param[in] path Path of file backing the array.
+ * @param[in] writable Nonzero to map the file for reading and writing.
+ *
+ * @return Instance of array object. <tt>NULL</tt> if the file could not be
+ * opened or mapped, with <tt>errno</tt> set, <tt>EINVAL</tt> if its header is
+ * not that of an array.
+ */
+extern arrays_t arrays_open(const char *path, int writable);
+
+/**
+ * @brief Write file backed array to disk.
+ *
+ * Records the number of elements in the header of the file and waits for the
+ * mapped file to be written. Nothing is done for arrays on the heap or mapped
+ * read-only.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_sync</tt> on a <tt>NULL</tt> array object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being written.
+ *
+ * @return 1 upon success, -1 if the file could not be written.
+ */
+extern int arrays_sync(arrays_t a);
+
 /**
  * @brief Copies data object to array.
  *
@@ -60,14 +191,26 @@ extern arrays_t arrays_new(size_t size, size_t capacity);
  *
  * @return 1 upon successfull pushing. -1 if array is at capacity.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+int arrays_push(arrays_t a, const void *x)
+{
+  struct arrays_head_t *h = (struct arrays_head_t*)(void*)a;
+  if ( h->nmem == h->capacity ) return -1;
+  memcpy(h->x + (h->nmem * h->size), x, h->size);
+  h->nmem++;
+  return 1;
+}
+# else
 extern int arrays_push(arrays_t a, const void *x);
+# endif
 
 /**
  * @brief Copies data object to array.
  *
  * The supplied data object is deep copied to the end of the array object. If the
- * array is already at capacity, then the array is resized before pushing the new
- * data object onto the tail of the array.
+ * array is already at capacity, then the array is resized according to its
+ * growth policy before pushing the new data object onto the tail of the array.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -79,6 +222,76 @@ extern int arrays_push(arrays_t a, const void *x);
  */
 extern void arrays_dynpush(arrays_t a, const void *x);
 
+/**
+ * @brief Append many data objects to end of array object.
+ *
+ * The <tt>n</tt> contiguous data objects at <tt>x</tt> are copied to the end of
+ * the array object by one <tt>memcpy</tt>, after growing the array at most once
+ * according to its growth policy.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_append</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd><tt>x</tt> holds fewer than <tt>n</tt> data objects, or lies in the
+ * array.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being appended to.
+ * @param[in] x Data objects being copied into array.
+ * @param[in] n Number of data objects.
+ */
+extern void arrays_append(arrays_t a, const void *x, size_t n);
+
+/**
+ * @brief Ensure room for a number of elements.
+ *
+ * If the capacity of the array object is below <tt>n</tt>, the array is resized
+ * to exactly <tt>n</tt> elements. Otherwise nothing is done.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_reserve</tt> on a <tt>NULL</tt> array object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reserved.
+ * @param[in] n Number of possible elements.
+ */
+extern void arrays_reserve(arrays_t a, size_t n);
+
+/**
+ * @brief Release unused capacity of array object.
+ *
+ * Resizes the array object to its number of elements.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_shrink_to_fit</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being shrunk.
+ */
+extern void arrays_shrink_to_fit(arrays_t a);
+
+/**
+ * @brief Set growth policy of array object.
+ *
+ * Sets the policy by which <tt>arrays_dynpush</tt> and <tt>arrays_append</tt>
+ * grow a full array. Doubling halves the number of copies of a large array
+ * made by <tt>realloc</tt> compared to the default, at the price of more unused
+ * capacity. Rounding to pages suits file backed arrays, and lets the allocator
+ * grow large arrays by remapping pages.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_set_growth</tt> on a <tt>NULL</tt> array object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object.
+ * @param[in] growth Growth policy.
+ */
+extern void arrays_set_growth(arrays_t a, arrays_growth_t growth);
+
 /**
  * @brief Applies user defined function to each element of the array.
  *
@@ -134,7 +347,16 @@ extern int arrays_map_r(arrays_t a, int apply(void *x, void *y), void *y);
  *
  * @return Pointer to <tt>i</tt>th element of array object.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+void *arrays_at(arrays_t a, size_t i)
+{
+  const struct arrays_head_t *h = (const struct arrays_head_t*)(void*)a;
+  return h->x + (h->size * i);
+}
+# else
 extern void *arrays_at(arrays_t a, size_t i);
+# endif
 
 /**
  * @brief Binary search of array.
@@ -193,11 +415,386 @@ extern void arrays_sort(arrays_t a, int cmp(const void *x, const void *y));
 extern void arrays_sort_r(arrays_t a,
                           int cmp(const void *x, const void *y, void *z), void *z);
 
+/**
+ * @brief Sort contents of the array on an unsigned integer key.
+ *
+ * Stable radix sort of the array on the unsigned <tt>width</tt>-byte integer,
+ * in native byte order, at the start of each element. No compare function is
+ * called. Keys are sorted a byte at a time from the least significant byte, and
+ * bytes on which every key agrees are skipped. Keys with more than four distinct
+ * bytes are first split on their most significant distinct byte, and each
+ * bucket is then sorted on the bytes below. A buffer the size of the array is
+ * allocated for the duration of the sort.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_radix_sort</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Key width is not 4 or 8, or exceeds the size of the elements.</dd>
+ * <dd>Keys are signed or floating point.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being sorted.
+ * @param[in] width Size in bytes of the keys, 4 for <tt>uint32_t</tt> or 8 for
+ * <tt>uint64_t</tt>.
+ */
+extern void arrays_radix_sort(arrays_t a, size_t width);
+
+# if CONTAINERS_THREADS
+/**
+ * @brief Apply user defined function to each element of array in parallel.
+ *
+ * The array is halved recursively into ranges of at least a few thousand
+ * elements, and the ranges are handed to the threads of the worker pool
+ * <tt>w</tt>, which set the number of threads used. Elements are visited in no
+ * particular order, and <tt>apply</tt> runs concurrently on distinct elements.
+ * If an application returns negative, the pool is stopped: ranges already
+ * started are left part way, those not yet started are skipped, and
+ * <tt>w</tt> must be freed and not reused. Available only if the library is
+ * configured with threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_map_parallel</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>User defined function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>arrays_map_parallel</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being mapped.
+ * @param[in] apply User defined function.
+ * @param[in] w Worker pool running the applications.
+ *
+ * @return 1 upon success, -1 if some application returned negative.
+ */
+extern int arrays_map_parallel(arrays_t a, int apply(void *x), workers_t w);
+
+/**
+ * @brief Apply user defined function to each element of array in parallel.
+ *
+ * Reentrant version of <tt>arrays_map_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_map_parallel_r</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>User defined function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>arrays_map_parallel_r</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being mapped.
+ * @param[in] apply User defined function.
+ * @param[in] y Argument to reentrant user defined function.
+ * @param[in] w Worker pool running the applications.
+ *
+ * @return 1 upon success, -1 if some application returned negative.
+ */
+extern int arrays_map_parallel_r(arrays_t a, int apply(void *x, void *y),
+                                 void *y, workers_t w);
+
+/**
+ * @brief Reduce array in parallel.
+ *
+ * The array is split into ranges as by <tt>arrays_map_parallel</tt>. Each
+ * thread of the worker pool <tt>w</tt> folds the elements of its ranges into an
+ * accumulator of its own, of <tt>size</tt> bytes, started as a copy of
+ * <tt>*acc</tt>; no locking is done. Once every range is folded, the
+ * accumulators of the threads are merged into <tt>*acc</tt> by
+ * <tt>merge</tt>, one after another. <tt>*acc</tt> must therefore hold the
+ * identity of <tt>merge</tt>, such as 0 for a sum, and <tt>merge</tt> be
+ * associative and commutative, as elements are folded in no particular order.
+ * If a fold returns negative, the pool is stopped as by
+ * <tt>arrays_map_parallel</tt>, and <tt>*acc</tt> holds the merge of the
+ * elements folded so far. Available only if the library is configured with
+ * threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_reduce_parallel</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>User defined functions are <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>arrays_reduce_parallel</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reduced.
+ * @param[in] fold User defined function folding element <tt>x</tt> into
+ * accumulator <tt>acc</tt>.
+ * @param[in] merge User defined function merging accumulator <tt>part</tt>
+ * into accumulator <tt>acc</tt>.
+ * @param[in,out] acc Accumulator, holding the identity of <tt>merge</tt>.
+ * @param[in] size Size of accumulator.
+ * @param[in] w Worker pool running the folds.
+ *
+ * @return 1 upon success, -1 if some fold returned negative.
+ */
+extern int arrays_reduce_parallel(arrays_t a, int fold(void *acc, const void *x),
+                                  void merge(void *acc, const void *part),
+                                  void *acc, size_t size, workers_t w);
+
+/**
+ * @brief Reduce array in parallel.
+ *
+ * Reentrant version of <tt>arrays_reduce_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_reduce_parallel_r</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>User defined functions are <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>arrays_reduce_parallel_r</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reduced.
+ * @param[in] fold User defined function folding element <tt>x</tt> into
+ * accumulator <tt>acc</tt>.
+ * @param[in] merge User defined function merging accumulator <tt>part</tt>
+ * into accumulator <tt>acc</tt>.
+ * @param[in,out] acc Accumulator, holding the identity of <tt>merge</tt>.
+ * @param[in] size Size of accumulator.
+ * @param[in] y Argument to reentrant user defined functions.
+ * @param[in] w Worker pool running the folds.
+ *
+ * @return 1 upon success, -1 if some fold returned negative.
+ */
+extern int arrays_reduce_parallel_r(arrays_t a,
+                                    int fold(void *acc, const void *x, void *y),
+                                    void merge(void *acc, const void *part,
+                                               void *y),
+                                    void *acc, size_t size, void *y,
+                                    workers_t w);
+
+/**
+ * @brief Sort contents of the array in parallel.
+ *
+ * Parallel merge sort on the threads of the worker pool <tt>w</tt>, which set
+ * the number of threads used. The array is cut into a few runs per thread,
+ * which are sorted by <tt>qsort</tt> concurrently. Runs are then merged
+ * pairwise, each merge being split into independent merges of at least a few
+ * thousand elements by binary search, so every round keeps all threads busy.
+ * The sort is not stable. A buffer the size of the array is allocated for the
+ * duration of the sort. Available only if the library is configured with
+ * threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_sort_parallel</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Compare function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>arrays_sort_parallel</tt> from a task of <tt>w</tt>, or on a
+ * stopped pool.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being sorted.
+ * @param[in] cmp User defined compare function.
+ * @param[in] w Worker pool running the sort.
+ */
+extern void arrays_sort_parallel(arrays_t a,
+                                 int cmp(const void *x, const void *y),
+                                 workers_t w);
+
+/**
+ * @brief Sort contents of the array in parallel.
+ *
+ * Reentrant version of <tt>arrays_sort_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_sort_parallel_r</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Compare function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>arrays_sort_parallel_r</tt> from a task of <tt>w</tt>, or on a
+ * stopped pool.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being sorted.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ * @param[in] w Worker pool running the sort.
+ */
+extern void arrays_sort_parallel_r(arrays_t a,
+                                   int cmp(const void *x, const void *y, void *z),
+                                   void *z, workers_t w);
+# endif
+
+/**
+ * @brief Sort the records of a file descriptor into array, in bounded memory.
+ *
+ * Reads <tt>fd</tt> to its end in runs of <tt>mem</tt> bytes of records of the
+ * size of the elements of <tt>out</tt>, sorts each run in memory, in parallel
+ * on <tt>w</tt> if not <tt>NULL</tt>, and writes it to an unlinked temporary
+ * file in the directory named by <tt>TMPDIR</tt>, or <tt>/tmp</tt>. The runs
+ * are then merged in one pass, each read through an equal share of
+ * <tt>mem</tt> bytes with the next share read ahead, and appended to
+ * <tt>out</tt>, grown once to their total. Input fitting in one run is sorted
+ * in memory and never written.
+ *
+ * The output may be a file backed array of <tt>arrays_create</tt>, so that
+ * neither the input nor the output need fit in memory. About <tt>2 mem</tt>
+ * bytes are allocated, and the temporary file is as large as the input.
+ * Equal records are not kept in their order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_sort_external</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Elements hold pointers, which do not survive the process.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] out Array object being appended to.
+ * @param[in] fd File descriptor being read from, from its current offset.
+ * @param[in] mem Bytes of a run.
+ * @param[in] cmp User defined compare function.
+ * @param[in] w Worker pool sorting the runs, or <tt>NULL</tt>. Ignored if the
+ * library is built without threads.
+ *
+ * @return 1 upon success. -1 if <tt>fd</tt> could not be read or the temporary
+ * file made, written or read, with <tt>errno</tt> set to <tt>EINVAL</tt> if the
+ * file ends within a record; <tt>out</tt> is then left as it was, short of the
+ * records of a merge cut short.
+ */
+extern int arrays_sort_external(arrays_t out, int fd, size_t mem,
+                                int cmp(const void *x, const void *y),
+                                workers_t w);
+
+/**
+ * @brief Sort the records of a file descriptor into array, in bounded memory.
+ *
+ * Reentrant version of <tt>arrays_sort_external</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_sort_external_r</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Elements hold pointers, which do not survive the process.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] out Array object being appended to.
+ * @param[in] fd File descriptor being read from, from its current offset.
+ * @param[in] mem Bytes of a run.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ * @param[in] w Worker pool sorting the runs, or <tt>NULL</tt>. Ignored if the
+ * library is built without threads.
+ *
+ * @return 1 upon success. -1 if <tt>fd</tt> could not be read or the temporary
+ * file made, written or read, with <tt>errno</tt> set to <tt>EINVAL</tt> if the
+ * file ends within a record; <tt>out</tt> is then left as it was, short of the
+ * records of a merge cut short.
+ */
+extern int arrays_sort_external_r(arrays_t out, int fd, size_t mem,
+                                  int cmp(const void *x, const void *y, void *z),
+                                  void *z, workers_t w);
+
+/**
+ * @brief Write array object to a stream.
+ *
+ * Writes a header recording the size and number of elements, then the elements
+ * straight from the array, with no copy made. The bytes written are those of a
+ * file of <tt>arrays_create</tt>, so a file holding only them may be mapped by
+ * <tt>arrays_open</tt> as well as read by <tt>arrays_read</tt>. Integers are
+ * written in native byte order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_write</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Elements hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being written.
+ * @param[in] f Stream being written to.
+ *
+ * @return 1 upon success, -1 if the stream could not be written.
+ */
+extern int arrays_write(arrays_t a, FILE *f);
+
+/**
+ * @brief Read array object from a stream.
+ *
+ * Replaces the elements of the array by those written by
+ * <tt>arrays_write</tt>, read straight into the array, which grows if needed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_read</tt> on a <tt>NULL</tt> array object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being read into.
+ * @param[in] f Stream being read from.
+ *
+ * @return 1 upon success. -1 if the stream could not be read, leaving the array
+ * empty, with <tt>errno</tt> set to <tt>EINVAL</tt> if the header is not that of
+ * an array of elements of the size of <tt>a</tt>.
+ */
+extern int arrays_read(arrays_t a, FILE *f);
+
+/**
+ * @brief Append the records of a file descriptor to array.
+ *
+ * Reads <tt>fd</tt> to its end in blocks of <tt>block</tt> bytes, each read
+ * straight into the spare capacity of the array, which grows as by
+ * <tt>arrays_dynpush</tt>, and appends the records of the size of the elements
+ * it holds. Records are raw bytes, as for <tt>arrays_append</tt>, and may
+ * straddle blocks. The records completed by every block are handed to
+ * <tt>apply</tt>, if not <tt>NULL</tt>, before they are appended; the kernel is
+ * meanwhile told to read the next block ahead, so that reading overlaps the
+ * work of <tt>apply</tt>. A <tt>block</tt> of 0 reads a megabyte at a time.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_ingest</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Elements hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being appended to.
+ * @param[in] fd File descriptor being read from, from its current offset.
+ * @param[in] block Bytes read at a time.
+ * @param[in] apply User defined function, given the first of <tt>n</tt> new
+ * records, which it may modify.
+ *
+ * @return 1 upon success. -1 if <tt>fd</tt> could not be read or
+ * <tt>apply</tt> returned a negative value, the records of the blocks read
+ * before then appended, or if the file ends within a record, with
+ * <tt>errno</tt> set to <tt>EINVAL</tt>.
+ */
+extern int arrays_ingest(arrays_t a, int fd, size_t block,
+                         int apply(void *x, size_t n));
+
+/**
+ * @brief Append the records of a file descriptor to array.
+ *
+ * Reentrant version of <tt>arrays_ingest</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_ingest_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Elements hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being appended to.
+ * @param[in] fd File descriptor being read from, from its current offset.
+ * @param[in] block Bytes read at a time.
+ * @param[in] apply User defined function, given the first of <tt>n</tt> new
+ * records, which it may modify.
+ * @param[in] y Argument to reentrant user defined function.
+ *
+ * @return 1 upon success. -1 if <tt>fd</tt> could not be read or
+ * <tt>apply</tt> returned a negative value, the records of the blocks read
+ * before then appended, or if the file ends within a record, with
+ * <tt>errno</tt> set to <tt>EINVAL</tt>.
+ */
+extern int arrays_ingest_r(arrays_t a, int fd, size_t block,
+                           int apply(void *x, size_t n, void *y), void *y);
+
 /**
  * @brief Change size of dynamic array object.
  *
  * Change size of dynamic array object. If changed to a larger size, the contents
- * are copied. If changed to a smaller size, the elements are truncated.
+ * are copied. If changed to a smaller size, the elements are truncated, and the
+ * number of elements drops to the new size. The
+ * file of a file backed array is resized and mapped again, which moves the
+ * elements in memory.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -212,12 +809,27 @@ extern void arrays_resize(arrays_t a, size_t nmem);
 /**
  * @brief Free data allocated for the dynamic array.
  *
- * Free data allocated for the dynamic array.
+ * Free data allocated for the dynamic array. The file of a file backed array
+ * is kept, its header updated, and unmapped.
  *
  * @param[in] *a Pointer to <tt>arrays_t</tt> object.
  */
 extern void arrays_free(arrays_t *a);
 
+/**
+ * @brief Remove every element of array.
+ *
+ * The number of elements is set to 0 and the capacity is kept.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_clear</tt> on a <tt>NULL</tt> array object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being cleared.
+ */
+extern void arrays_clear(arrays_t a);
+
 /**
  * @brief Return number of elements in array object.
  *
@@ -227,7 +839,15 @@ extern void arrays_free(arrays_t *a);
  *
  * @return Number of elements in array.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+size_t arrays_nmem(arrays_t a)
+{
+  return ((const struct arrays_head_t*)(void*)a)->nmem;
+}
+# else
 extern size_t arrays_nmem(arrays_t a);
+# endif
 
 /**
  * @brief Return number of possible elements in array object.
@@ -238,7 +858,15 @@ extern size_t arrays_nmem(arrays_t a);
  *
  * @return Capacity of array object.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+size_t arrays_capacity(arrays_t a)
+{
+  return ((const struct arrays_head_t*)(void*)a)->capacity;
+}
+# else
 extern size_t arrays_capacity(arrays_t a);
+# endif
 
 /**
  * @brief Return size of elements in array object.
@@ -249,12 +877,43 @@ extern size_t arrays_capacity(arrays_t a);
  *
  * @return Size of array elements.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+size_t arrays_size(arrays_t a)
+{
+  return ((const struct arrays_head_t*)(void*)a)->size;
+}
+# else
 extern size_t arrays_size(arrays_t a);
+# endif
+
+/**
+ * @brief Number of bytes allocated for array.
+ *
+ * Number of bytes allocated for the array object and its data array, of
+ * <tt>capacity</tt> elements. The data array of a file backed array is counted
+ * as mapped. If <tt>payload</tt> is not <tt>NULL</tt>, it is set to the number
+ * of those bytes holding the <tt>nmem</tt> elements in the array; the rest is
+ * overhead.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_memory_usage</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being checked.
+ * @param[out] payload Bytes of payload, if not <tt>NULL</tt>.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t arrays_memory_usage(arrays_t a, size_t *payload);
 
 /**
  * @brief Check if contents of two arrays are equal in value.
  *
- * Check if contents of two arrays are equal in value.
+ * Check if contents of two arrays are equal in value. The contents are compared
+ * by a single <tt>memcmp</tt>.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -268,6 +927,47 @@ extern size_t arrays_size(arrays_t a);
  */
 extern int arrays_equal(arrays_t a1, arrays_t a2);
 
+/**
+ * @brief Index of first element at which two arrays differ.
+ *
+ * The arrays are compared bytewise, 32 or 16 bytes at a time with AVX2 or
+ * SSE2, up to the length of the shorter one.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_find_first_mismatch</tt> when any parameter is
+ * <tt>NULL</tt>.</dd>
+ * <dd>Elements of the arrays differ in size.</dd>
+ * </dl>
+ *
+ * @param[in] a1 First array.
+ * @param[in] a2 Second array.
+ *
+ * @return Index of first differing element, or number of elements of the
+ * shorter array if none differ.
+ */
+extern size_t arrays_find_first_mismatch(arrays_t a1, arrays_t a2);
+
+/**
+ * @brief Number of elements of array equal to a data object.
+ *
+ * Elements are compared bytewise to <tt>x</tt>. Elements of 1, 2, 4 or 8 bytes
+ * are compared a vector at a time with AVX2 or SSE2, others one at a time by
+ * <tt>memcmp</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_count</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd><tt>x</tt> is smaller than the elements of the array.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being counted.
+ * @param[in] x Data object being counted.
+ *
+ * @return Number of elements equal to <tt>x</tt>.
+ */
+extern size_t arrays_count(arrays_t a, const void *x);
+
 /**
  * @brief Swap opaque pointers for arrays.
  *
@@ -289,6 +989,311 @@ void arrays_swap(arrays_t *restrict a1, arrays_t *restrict a2)
   *a2 = tmp;
 }
 
+/**
+ * @brief Remove elements of array not satisfying a predicate.
+ *
+ * Keeps the elements for which <tt>pred</tt> returns a positive <tt>int</tt>,
+ * in their order, moving each kept element at most once. Done in one pass over
+ * the array, without allocating.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_filter</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Predicate is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being filtered.
+ * @param[in] pred User defined predicate.
+ */
+extern void arrays_filter(arrays_t a, int pred(const void *x));
+
+/**
+ * @brief Remove elements of array not satisfying a predicate.
+ *
+ * Reentrant version of <tt>arrays_filter</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_filter_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Predicate is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being filtered.
+ * @param[in] pred User defined predicate.
+ * @param[in] y Argument to reentrant user defined predicate.
+ */
+extern void arrays_filter_r(arrays_t a, int pred(const void *x, void *y),
+                            void *y);
+
+/**
+ * @brief Move elements of array satisfying a predicate to its front.
+ *
+ * Reorders the array so that the elements for which <tt>pred</tt> returns a
+ * positive <tt>int</tt> precede the others, by exchanging misplaced elements
+ * from both ends in one pass, without allocating. The order within either part is not kept.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_partition</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Predicate is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being partitioned.
+ * @param[in] pred User defined predicate.
+ *
+ * @return Number of elements satisfying the predicate, the index of the first
+ * element not satisfying it.
+ */
+extern size_t arrays_partition(arrays_t a, int pred(const void *x));
+
+/**
+ * @brief Move elements of array satisfying a predicate to its front.
+ *
+ * Reentrant version of <tt>arrays_partition</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_partition_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Predicate is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being partitioned.
+ * @param[in] pred User defined predicate.
+ * @param[in] y Argument to reentrant user defined predicate.
+ *
+ * @return Number of elements satisfying the predicate, the index of the first
+ * element not satisfying it.
+ */
+extern size_t arrays_partition_r(arrays_t a, int pred(const void *x, void *y),
+                                 void *y);
+
+/**
+ * @brief Remove repeated adjacent elements of array.
+ *
+ * Keeps the first element of every run of consecutive elements comparing
+ * equal, in their order, in one pass without allocating. On a sorted array
+ * this leaves each distinct element once.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_unique</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being deduplicated.
+ * @param[in] cmp User defined compare function.
+ */
+extern void arrays_unique(arrays_t a, int cmp(const void *x, const void *y));
+
+/**
+ * @brief Remove repeated adjacent elements of array.
+ *
+ * Reentrant version of <tt>arrays_unique</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_unique_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being deduplicated.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ */
+extern void arrays_unique_r(arrays_t a,
+                            int cmp(const void *x, const void *y, void *z),
+                            void *z);
+
+/**
+ * @brief Merge sorted arrays into array.
+ *
+ * Appends the elements of <tt>in[0]</tt>, ..., <tt>in[k - 1]</tt>, each sorted
+ * by <tt>cmp</tt>, to <tt>out</tt> in sorted order. A loser tree picks the next
+ * element in about <tt>log2(k)</tt> comparisons, and <tt>out</tt> is grown once
+ * up front. Equal elements keep the order of their inputs.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_merge_k</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Input arrays are not sorted, or their element size differs from that of
+ * <tt>out</tt>.</dd>
+ * <dd><tt>out</tt> is one of the input arrays.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] out Array object being appended to.
+ * @param[in] in Sorted array objects being merged.
+ * @param[in] k Number of input arrays.
+ * @param[in] cmp User defined compare function.
+ */
+extern void arrays_merge_k(arrays_t out, arrays_t *in, size_t k,
+                           int cmp(const void *x, const void *y));
+
+/**
+ * @brief Merge sorted arrays into array.
+ *
+ * Reentrant version of <tt>arrays_merge_k</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_merge_k_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Input arrays are not sorted, or their element size differs from that of
+ * <tt>out</tt>.</dd>
+ * <dd><tt>out</tt> is one of the input arrays.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] out Array object being appended to.
+ * @param[in] in Sorted array objects being merged.
+ * @param[in] k Number of input arrays.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ */
+extern void arrays_merge_k_r(arrays_t out, arrays_t *in, size_t k,
+                             int cmp(const void *x, const void *y, void *z),
+                             void *z);
+
+/**
+ * @brief Put element of array in its sorted position.
+ *
+ * Reorders the array so that element <tt>k</tt> is the one that would be there
+ * were the array sorted by <tt>cmp</tt>, no element before it greater, and no
+ * element after it less. Quickselect on the median of three elements takes
+ * <tt>O(n)</tt> comparisons on average, without allocating; a range not
+ * narrowing fast enough is sorted instead, bounding the worst case by
+ * <tt>O(n log n)</tt>. Nothing is done if <tt>k</tt> is not less than the
+ * number of elements.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_nth_element</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reordered.
+ * @param[in] k Index of element put in its sorted position.
+ * @param[in] cmp User defined compare function.
+ */
+extern void arrays_nth_element(arrays_t a, size_t k,
+                               int cmp(const void *x, const void *y));
+
+/**
+ * @brief Put element of array in its sorted position.
+ *
+ * Reentrant version of <tt>arrays_nth_element</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_nth_element_r</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reordered.
+ * @param[in] k Index of element put in its sorted position.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ */
+extern void arrays_nth_element_r(arrays_t a, size_t k,
+                                 int cmp(const void *x, const void *y, void *z),
+                                 void *z);
+
+/**
+ * @brief Sort the least elements of array.
+ *
+ * Moves the <tt>k</tt> least elements of the array to its front in sorted
+ * order, leaving the others after them in no particular order. Selecting the
+ * elements first with <tt>arrays_nth_element</tt> costs <tt>O(n + k log k)</tt>
+ * comparisons on average. The whole array is sorted if <tt>k</tt> is not less
+ * than the number of elements.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_partial_sort</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reordered.
+ * @param[in] k Number of elements sorted.
+ * @param[in] cmp User defined compare function.
+ */
+extern void arrays_partial_sort(arrays_t a, size_t k,
+                                int cmp(const void *x, const void *y));
+
+/**
+ * @brief Sort the least elements of array.
+ *
+ * Reentrant version of <tt>arrays_partial_sort</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_partial_sort_r</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being reordered.
+ * @param[in] k Number of elements sorted.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ */
+extern void arrays_partial_sort_r(arrays_t a, size_t k,
+                                  int cmp(const void *x, const void *y, void *z),
+                                  void *z);
+
+/**
+ * @brief Append greatest elements of array to another array.
+ *
+ * Appends copies of the <tt>k</tt> greatest elements of <tt>a</tt> by
+ * <tt>cmp</tt> to <tt>out</tt>, greatest first, leaving <tt>a</tt> unchanged.
+ * One scan keeps a bounded heap of the greatest elements seen in the spare
+ * capacity of <tt>out</tt>, grown once up front, so that an element not among
+ * them costs a single comparison. The least elements are had by reversing the
+ * compare function.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_top_k</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Element size of <tt>out</tt> differs from that of <tt>a</tt>.</dd>
+ * <dd><tt>out</tt> is <tt>a</tt>.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being scanned.
+ * @param[in] out Array object being appended to.
+ * @param[in] k Number of elements appended, at most the number of elements of
+ * <tt>a</tt>.
+ * @param[in] cmp User defined compare function.
+ */
+extern void arrays_top_k(arrays_t a, arrays_t out, size_t k,
+                         int cmp(const void *x, const void *y));
+
+/**
+ * @brief Append greatest elements of array to another array.
+ *
+ * Reentrant version of <tt>arrays_top_k</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>arrays_top_k_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Element size of <tt>out</tt> differs from that of <tt>a</tt>.</dd>
+ * <dd><tt>out</tt> is <tt>a</tt>.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object being scanned.
+ * @param[in] out Array object being appended to.
+ * @param[in] k Number of elements appended, at most the number of elements of
+ * <tt>a</tt>.
+ * @param[in] cmp User defined compare function.
+ * @param[in] z Argument to reentrant user defined compare function.
+ */
+extern void arrays_top_k_r(arrays_t a, arrays_t out, size_t k,
+                           int cmp(const void *x, const void *y, void *z),
+                           void *z);
+
 /**
  * @brief Reset number of elements to smaller number.
  *
@@ -15,53 +15,49 @@
 /**
  * @brief Bit representations of powers of 2.
  *
- * Bit representations of powers of 2.
- */
-static uint64_t _BITT[64] = {
-  1,2,4,8,16,32,64,128,256,512,1024,2048,4096,8192,16384,32768,65536,131072,262144,
-  524288,1048576,2097152,4194304,8388608,16777216,33554432,67108864,134217728,
-  268435456,536870912,1073741824,2147483648,4294967296,8589934592,17179869184,
-  34359738368,68719476736,137438953472,274877906944,549755813888,1099511627776,
-  2199023255552,4398046511104,8796093022208,17592186044416,35184372088832,
-  70368744177664,140737488355328,281474976710656,562949953421312,1125899906842624,
-  2251799813685248,4503599627370496,9007199254740992,18014398509481984,
-  36028797018963968,72057594037927936,144115188075855872,288230376151711744,
-  576460752303423488,1152921504606846976,2305843009213693952,4611686018427387904,
-  9223372036854775808ULL,
-};
+ * Bit representations of powers of 2. The tables of this header are
+ * <tt>const</tt> and defined once, in the library, rather than copied into each
+ * translation unit; the element macros shift rather than read this one.
+ */
+extern const uint64_t _BITT[64];
+
+/**
+ * @brief Word operations are compiler builtins.
+ *
+ * Set when the compiler provides <tt>__builtin_popcountll</tt> and
+ * <tt>__builtin_ctzll</tt>, which become single POPCNT and TZCNT (or BSF)
+ * instructions when the target has them, e.g. under <tt>-mpopcnt -mbmi</tt> or
+ * <tt>-march=native</tt>. Define <tt>BIT_SETS_NO_BUILTINS</tt> before including
+ * this header to use the lookup tables instead.
+ */
+# if (defined(__GNUC__) || defined(__clang__)) && !defined(BIT_SETS_NO_BUILTINS)
+# define BIT_SETS_BUILTINS 1
+# endif
 
 /**
  * @brief Bit counts for the possible 256 bytes.
  *
  * Bit counts for the possible 256 bytes.
  */
-static uint64_t _BITTCOUNT[256] = {
-  0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,1,2,2,3,2,3,3,4,
-  2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
-  2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,
-  4,5,5,6,5,6,6,7,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-  2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,2,3,3,4,3,4,4,5,
-  3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
-  4,5,5,6,5,6,6,7,5,6,6,7,6,7,7,8,
-};
+extern const uint64_t _BITTCOUNT[256];
 
 /**
  * @brief Rightmost bits for 256 possible bytes.
  *
  * Rightmost bits for 256 possible bytes.
  */
-static uint64_t _RIGHTBITT[256] = {
-  _WORDSIZE,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,0,1,0,
-  2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,6,0,1,0,2,0,1,0,3,0,1,0,
-  2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,
-  2,0,1,0,3,0,1,0,2,0,1,0,7,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,
-  2,0,1,0,5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,6,0,1,0,
-  2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,0,1,0,2,0,1,0,3,0,1,0,
-  2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
-};
+extern const uint64_t _RIGHTBITT[256];
 
 typedef uint64_t setwords_t, sets_t;
 
+/**
+ * @brief Setword holding only bit <tt>b</tt>.
+ *
+ * Setword holding only bit <tt>b</tt>, by a shift rather than a lookup in
+ * <tt>_BITT</tt>.
+ */
+# define _BIT(b) (((setwords_t)1) << (b))
+
 /**
  * @brief Return quotient of <tt>pos</tt> with respect to <tt>setwords_t</tt>.
  *
@@ -97,14 +93,14 @@ typedef uint64_t setwords_t, sets_t;
  *
  * Add element indexed by <tt>pos</tt> to set.
  */
-# define _ADDELEMENT(setadd, pos)  ((setadd)[_SETWD(pos)] |= _BITT[_SETBT(pos)])
+# define _ADDELEMENT(setadd, pos)  ((setadd)[_SETWD(pos)] |= _BIT(_SETBT(pos)))
 
 /**
  * @brief Remove element indexed by <tt>pos</tt> from set.
  *
  * Remove element indexed by <tt>pos</tt> from set.
  */
-# define _DELELEMENT(setadd, pos)  ((setadd)[_SETWD(pos)] &= ~_BITT[_SETBT(pos)])
+# define _DELELEMENT(setadd, pos)  ((setadd)[_SETWD(pos)] &= ~_BIT(_SETBT(pos)))
 
 /**
  * @brief Flip membership od element indexed by <tt>pos</tt>.
@@ -112,14 +108,14 @@ typedef uint64_t setwords_t, sets_t;
  * Remove element indexed by <tt>pos</tt> from set if it is not already
  * included. If it is included, remove it.
  */
-# define _FLIPELEMENT(setadd, pos) ((setadd)[_SETWD(pos)] ^= _BITT[_SETBT(pos)])
+# define _FLIPELEMENT(setadd, pos) ((setadd)[_SETWD(pos)] ^= _BIT(_SETBT(pos)))
 
 /**
  * @brief Test if element indexed by <tt>pos</tt> is in the set.
  *
  * Test if element indexed by <tt>pos</tt> is in the set.
  */
-# define _ISELEMENT(setadd, pos) (((setadd)[_SETWD(pos)] & _BITT[_SETBT(pos)])!= 0)
+# define _ISELEMENT(setadd, pos) (((setadd)[_SETWD(pos)] & _BIT(_SETBT(pos)))!= 0)
 
 /**
  * @brief Dump contents of set.
@@ -158,6 +154,29 @@ typedef uint64_t setwords_t, sets_t;
 # define MSK08000000 0x00FF000000000000UL
 # define MSK64       0xFFFFFFFFFFFFFFFEUL
 
+# ifdef BIT_SETS_BUILTINS
+/**
+ * @brief Number of elements in the set.
+ *
+ * Number of elements in the set.
+ */
+# define _POPCOUNT(x) ((uint64_t)__builtin_popcountll(x))
+
+/**
+ * @brief Return the smallest element of the set.
+ *
+ * Return the smallest element of the set. If the set is empty, <tt>_WORDSIZE</tt>
+ * is returned.
+ */
+# define _FIRSTBIT(x) ((x) ? __builtin_ctzll(x) : _WORDSIZE)
+
+/**
+ * @brief Return the smallest element of the set.
+ *
+ * Return the smallest element of the set. Assumes the set is nonempty.
+ */
+# define _FIRSTBITNZ(x) (__builtin_ctzll(x))
+# else
 /**
  * @brief Number of elements in the set.
  *
@@ -196,6 +215,7 @@ typedef uint64_t setwords_t, sets_t;
                       : (40+_RIGHTBITT[((x)>>40)&0xFF])) : ((x) & MSK08000000 \
                       ? (48+_RIGHTBITT[((x)>>48)&0xFF]) : \
                       (56+_RIGHTBITT[((x)>>56)&0xFF]))))
+# endif
 
 /**
  * @brief Set 64-bit mask <tt>x</tt> positions to the right.
@@ -223,7 +243,7 @@ typedef uint64_t setwords_t, sets_t;
  *
  * Takes and removes smallest element of <tt>setwords_t</tt>.
  */
-# define _TAKEBIT(_i, word) {_i = _FIRSTBITNZ(word); (word) ^= _BITT[_i];}
+# define _TAKEBIT(_i, word) {_i = _FIRSTBITNZ(word); (word) &= (word) - 1;}
 
 /**
  * @brief Return element of set.
@@ -237,7 +257,90 @@ typedef uint64_t setwords_t, sets_t;
  * @retval int Next element of set after <tt>pos</tt> or first element if
  * <tt>pos</tt> is -1.
  */
-extern int bit_nextelement(const sets_t set1[static 1], size_t m, int pos);
+extern int bit_nextelement(const sets_t *set1, size_t m, int pos);
+
+/**
+ * @brief Iterator over the elements of a set.
+ *
+ * Keeps the setword being visited, with the elements already returned
+ * removed, so that each element costs one <tt>_TAKEBIT</tt>.
+ */
+typedef struct {
+  const sets_t *s;   ///< set being visited
+  size_t m;          ///< number of setwords in set
+  size_t w;          ///< setword being visited
+  setwords_t word;   ///< elements of setword not yet returned
+} setiters_t;
+
+/**
+ * @brief Visits every element of a set in increasing order.
+ *
+ * Assigns each element of <tt>setadd</tt> to <tt>_i</tt> in turn and runs the
+ * statement following the macro. The loop is two nested <tt>for</tt>
+ * statements, so <tt>break</tt> only leaves the current setword.
+ */
+# define _FOREACHELEMENT(_i, setadd, m)                                 \
+  for ( size_t _fw = 0; _fw < (m); _fw++ )                              \
+    for ( setwords_t _fx = (setadd)[_fw];                               \
+          _fx != 0 && ((_i) = _TIMESWORDSIZE(_fw) + _FIRSTBITNZ(_fx),   \
+                       _fx &= _fx - 1, 1); )
+
+/**
+ * @brief Starts iterator at the first element of set.
+ *
+ * @param[in] it Iterator being started.
+ * @param[in] s Set being visited. Must not change while visited.
+ * @param[in] m Number of setwords in set.
+ */
+static inline
+void bit_iterinit(setiters_t *it, const sets_t s[static 1], size_t m)
+{
+  it->s = s;
+  it->m = m;
+  it->w = 0;
+  it->word = m != 0 ? s[0] : 0;
+}
+
+/**
+ * @brief Next element of iterator.
+ *
+ * @param[in] it Iterator of set.
+ *
+ * @retval int Next element of set in increasing order. Returns -1 once every
+ * element has been returned.
+ */
+static inline
+int bit_iternext(setiters_t *it)
+{
+  while ( it->word == 0 ) {
+    if ( it->w + 1 >= it->m ) return -1;
+    it->word = it->s[++it->w];
+  }
+  int b = _FIRSTBITNZ(it->word);
+  it->word &= it->word - 1;
+  return (int)_TIMESWORDSIZE(it->w) + b;
+}
+
+/**
+ * @brief Stores the elements of a set in an array.
+ *
+ * Writes the elements of <tt>s</tt> to <tt>out</tt> in increasing order. AVX2
+ * builds decode a byte of the set at a time with a table lookup and one vector
+ * store.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>out</tt> holds fewer than <tt>bit_setsize(s, m)</tt> elements.</dd>
+ * </dl>
+ *
+ * @param[in] s Set being decoded.
+ * @param[in] m Number of setwords in set.
+ * @param[out] out Destination of elements.
+ *
+ * @retval size_t Number of elements written.
+ */
+extern size_t bit_to_indices(const sets_t s[restrict static 1], size_t m,
+                             uint32_t *restrict out);
 
 /**
  * @brief Applies permutation to set.
@@ -265,6 +368,409 @@ extern void bit_permset(sets_t s1[restrict static 1],
 extern int bit_permaut(const sets_t s1[static 1],
                        const uint32_t p[static 1], size_t m);
 
+/**
+ * @brief Applies many permutations to set.
+ *
+ * Places the image of <tt>s</tt> under <tt>p[i]</tt> in the <tt>m</tt>
+ * setwords of <tt>d</tt> from <tt>d + i * m</tt>, for each <tt>i</tt> below
+ * <tt>n</tt>. The elements of <tt>s</tt> are decoded once for all of the
+ * permutations.
+ *
+ * @param[in] d Destination of the <tt>n</tt> images, of <tt>n * m</tt>
+ * setwords.
+ * @param[in] s Set being permuted.
+ * @param[in] p Permutations being applied to set.
+ * @param[in] n Number of permutations.
+ * @param[in] m Number of setwords in set.
+ */
+extern void bit_permset_many(sets_t d[restrict static 1],
+                             const sets_t s[restrict static 1],
+                             const uint32_t *const p[static 1], size_t n,
+                             size_t m);
+
+/**
+ * @brief Test if many permutations fix the set.
+ *
+ * As <tt>bit_permaut</tt> for each of <tt>p[0]</tt>, ..., <tt>p[n - 1]</tt>,
+ * decoding the elements of <tt>s</tt> once, and returning at the first
+ * element moved out of the set.
+ *
+ * @param[in] s Set being acted upon by permutations.
+ * @param[in] p Permutations acting on set.
+ * @param[in] n Number of permutations.
+ * @param[in] m Number of setwords in set.
+ *
+ * @retval int Returns 1 if every permutation fixes the set. Returns -1
+ * otherwise.
+ */
+extern int bit_permaut_many(const sets_t s[static 1],
+                            const uint32_t *const p[static 1], size_t n,
+                            size_t m);
+
+/**
+ * @brief Number of words of the lookup table of a permutation of sets of
+ * <tt>m</tt> setwords.
+ *
+ * The table holds, for each of the <tt>8m</tt> bytes of a set and each of their
+ * 256 values, the image of that byte as a set of <tt>m</tt> setwords: 16 KB when
+ * <tt>m</tt> is 1, growing as <tt>m</tt> squared.
+ */
+# define _PERMTABLEWORDS(m) (2048 * (m) * (m))
+
+/**
+ * @brief Builds lookup table of permutation.
+ *
+ * Fills <tt>t</tt>, of <tt>_PERMTABLEWORDS(m)</tt> words, for
+ * <tt>bit_permset_table</tt>, <tt>bit_permset_batch</tt> and
+ * <tt>bit_permaut_table</tt>. Worth building for a permutation applied to many
+ * sets.
+ *
+ * @param[in] t Destination of lookup table.
+ * @param[in] p Permutation being tabulated.
+ * @param[in] m Number of setwords in sets.
+ */
+extern void bit_permtable(uint64_t t[restrict static 1],
+                          const uint32_t p[static 1], size_t m);
+
+/**
+ * @brief Applies tabulated permutation to set.
+ *
+ * As <tt>bit_permset</tt>, mapping each nonzero byte of <tt>s</tt> in one
+ * table lookup.
+ *
+ * @param[in] d Destination for image of set under permutation.
+ * @param[in] s Set being permuted.
+ * @param[in] t Lookup table of permutation.
+ * @param[in] m Number of setwords in set.
+ */
+extern void bit_permset_table(sets_t d[restrict static 1],
+                              const sets_t s[restrict static 1],
+                              const uint64_t t[restrict static 1], size_t m);
+
+/**
+ * @brief Applies tabulated permutation to many sets.
+ *
+ * Places the image of the set of <tt>m</tt> setwords at <tt>s + i * m</tt> in
+ * <tt>d + i * m</tt>, for each <tt>i</tt> below <tt>n</tt>.
+ *
+ * @param[in] d Destination of the <tt>n</tt> images.
+ * @param[in] s Sets being permuted, of <tt>n * m</tt> setwords.
+ * @param[in] n Number of sets.
+ * @param[in] t Lookup table of permutation.
+ * @param[in] m Number of setwords in each set.
+ */
+extern void bit_permset_batch(sets_t d[restrict static 1],
+                              const sets_t s[restrict static 1], size_t n,
+                              const uint64_t t[restrict static 1], size_t m);
+
+/**
+ * @brief Test if tabulated permutation fixes the set.
+ *
+ * As <tt>bit_permaut</tt>. The image of each nonzero byte of <tt>s</tt> is
+ * looked up and tested for inclusion in <tt>s</tt>, returning at the first
+ * that is not included.
+ *
+ * @param[in] s Set being acted upon by permutation.
+ * @param[in] t Lookup table of permutation.
+ * @param[in] m Number of setwords in set.
+ *
+ * @retval int Returns 1 if the permutation fixes the set. Returns -1 otherwise.
+ */
+extern int bit_permaut_table(const sets_t s[static 1],
+                             const uint64_t t[static 1], size_t m);
+
+/**
+ * @brief Write set to a stream.
+ *
+ * Writes a header recording the number of setwords, then the setwords straight
+ * from the set. Setwords are written in native byte order.
+ *
+ * @param[in] s Set being written.
+ * @param[in] m Number of setwords in set.
+ * @param[in] f Stream being written to.
+ *
+ * @retval int Returns 1 upon success. Returns -1 if the stream could not be
+ * written.
+ */
+extern int bit_write(const sets_t s[static 1], size_t m, FILE *f);
+
+/**
+ * @brief Read set from a stream.
+ *
+ * Reads the setwords written by <tt>bit_write</tt> straight into <tt>s</tt>.
+ *
+ * @param[in] s Destination of set, of <tt>m</tt> setwords.
+ * @param[in] m Number of setwords in set.
+ * @param[in] f Stream being read from.
+ *
+ * @retval int Returns 1 upon success. Returns -1 if the stream could not be
+ * read, with <tt>errno</tt> set to <tt>EINVAL</tt> if the header is not that of
+ * a set of <tt>m</tt> setwords.
+ */
+extern int bit_read(sets_t s[static 1], size_t m, FILE *f);
+
+/**
+ * @brief Union of two sets.
+ *
+ * Places <tt>s1 | s2</tt> in <tt>d</tt>, several setwords at a time when the
+ * library is built with SIMD kernels. <tt>d</tt> may be an alias of either
+ * operand.
+ *
+ * @param[in] d Destination of union.
+ * @param[in] s1 First operand.
+ * @param[in] s2 Second operand.
+ * @param[in] m Number of setwords in sets.
+ */
+extern void bit_union(sets_t *d, const sets_t *s1, const sets_t *s2, size_t m);
+
+/**
+ * @brief Intersection of two sets.
+ *
+ * Places <tt>s1 & s2</tt> in <tt>d</tt>, several setwords at a time when the
+ * library is built with SIMD kernels. <tt>d</tt> may be an alias of either
+ * operand.
+ *
+ * @param[in] d Destination of intersection.
+ * @param[in] s1 First operand.
+ * @param[in] s2 Second operand.
+ * @param[in] m Number of setwords in sets.
+ */
+extern void bit_intersection(sets_t *d, const sets_t *s1, const sets_t *s2,
+                             size_t m);
+
+/**
+ * @brief Difference of two sets.
+ *
+ * Places <tt>s1 & ~s2</tt> in <tt>d</tt>, several setwords at a time when the
+ * library is built with SIMD kernels. <tt>d</tt> may be an alias of either
+ * operand.
+ *
+ * @param[in] d Destination of difference.
+ * @param[in] s1 First operand.
+ * @param[in] s2 Second operand.
+ * @param[in] m Number of setwords in sets.
+ */
+extern void bit_difference(sets_t *d, const sets_t *s1, const sets_t *s2,
+                           size_t m);
+
+/**
+ * @brief Intersection of two sets and its size.
+ *
+ * As <tt>bit_intersection</tt>, counting the elements of the intersection in
+ * the same pass.
+ *
+ * @param[in] d Destination of intersection.
+ * @param[in] s1 First conjunct of intersection.
+ * @param[in] s2 Second conjunct of intersection.
+ * @param[in] m Number of setwords in sets.
+ *
+ * @retval size_t Number of elements in intersection.
+ */
+extern size_t bit_intersectioncount(sets_t *d, const sets_t *s1,
+                                    const sets_t *s2, size_t m);
+
+/**
+ * @brief Size of intersection of two sets.
+ *
+ * Counts the elements of <tt>s1 & s2</tt> without storing the intersection.
+ *
+ * @param[in] s1 First conjunct of intersection.
+ * @param[in] s2 Second conjunct of intersection.
+ * @param[in] m Number of setwords in sets.
+ *
+ * @retval size_t Number of elements in intersection.
+ */
+extern size_t bit_intersectsize(const sets_t *s1, const sets_t *s2, size_t m);
+
+/**
+ * @brief Sizes of the intersections of a set with many sets.
+ *
+ * Places the size of <tt>s & t_i</tt> in <tt>c[i]</tt>, for each <tt>i</tt>
+ * below <tt>n</tt>, where <tt>t_i</tt> is the set of <tt>m</tt> setwords at
+ * <tt>t + i * stride</tt>: one set against the rows of a matrix, such as the
+ * rows of a <tt>bitmatrices_t</tt>. The setwords of <tt>s</tt> are held in
+ * vector registers across the rows when they fit, and counted with AVX-512
+ * VPOPCNTDQ when the target has it, or 16 setwords at a time by Harley-Seal
+ * carry-save adders in AVX2 builds.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>stride</tt> is less than <tt>m</tt>.</dd>
+ * <dd>Sets of more than <tt>UINT32_MAX</tt> elements.</dd>
+ * </dl>
+ *
+ * @param[out] c Destination of the <tt>n</tt> sizes.
+ * @param[in] s Set being intersected.
+ * @param[in] t First of the sets being intersected with <tt>s</tt>.
+ * @param[in] n Number of sets of <tt>t</tt>.
+ * @param[in] stride Setwords between the starts of the sets of <tt>t</tt>.
+ * @param[in] m Number of setwords in sets.
+ */
+extern void bit_intersectsizes(uint32_t c[restrict static 1],
+                               const sets_t s[restrict static 1],
+                               const sets_t t[restrict static 1], size_t n,
+                               size_t stride, size_t m);
+
+/**
+ * @brief Sets meeting a set in at least a given number of elements.
+ *
+ * As <tt>bit_intersectsizes</tt>, placing <tt>i</tt> in the set <tt>r</tt>
+ * when <tt>s & t_i</tt> has at least <tt>num</tt> elements, instead of
+ * storing the sizes. <tt>r</tt> holds <tt>_SETWORDSNEEDED(n)</tt> setwords, all
+ * of which are written.
+ *
+ * @param[out] r Destination of the set of indices of the passing sets.
+ * @param[in] s Set being intersected.
+ * @param[in] t First of the sets being intersected with <tt>s</tt>.
+ * @param[in] n Number of sets of <tt>t</tt>.
+ * @param[in] stride Setwords between the starts of the sets of <tt>t</tt>.
+ * @param[in] m Number of setwords in sets.
+ * @param[in] num Least size of intersection.
+ *
+ * @retval size_t Number of elements of <tt>r</tt>.
+ */
+extern size_t bit_intersectfilter(sets_t r[restrict static 1],
+                                  const sets_t s[restrict static 1],
+                                  const sets_t t[restrict static 1], size_t n,
+                                  size_t stride, size_t m, size_t num);
+
+/**
+ * @brief Test if set is a subset of another.
+ *
+ * Returns at the first setwords with an element of <tt>s1</tt> missing from
+ * <tt>s2</tt>.
+ *
+ * @param[in] s1 Candidate subset.
+ * @param[in] s2 Candidate superset.
+ * @param[in] m Number of setwords in sets.
+ *
+ * @retval int Returns 1 if <tt>s1</tt> is a subset of <tt>s2</tt>. Returns -1
+ * otherwise.
+ */
+extern int bit_subset(const sets_t *s1, const sets_t *s2, size_t m);
+
+/**
+ * @brief Test if two sets are disjoint.
+ *
+ * Returns at the first setwords sharing an element.
+ *
+ * @param[in] s1 First set.
+ * @param[in] s2 Second set.
+ * @param[in] m Number of setwords in sets.
+ *
+ * @retval int Returns 1 if <tt>s1</tt> and <tt>s2</tt> are disjoint. Returns -1
+ * otherwise.
+ */
+extern int bit_disjoint(const sets_t *s1, const sets_t *s2, size_t m);
+
+/**
+ * @brief Number of words of the rank index of a set of <tt>m</tt> setwords.
+ *
+ * The index holds two words for every superblock of 8 setwords (512 elements):
+ * the number of elements before the superblock, and, in 9 bits each, the
+ * number of elements of the superblock before each of its setwords 1 to 7.
+ */
+# define _RANKWORDS(m) (2 * (((m)>>3) + 1))
+
+/**
+ * @brief Builds rank index of set.
+ *
+ * Fills <tt>r</tt>, of <tt>_RANKWORDS(m)</tt> words, for <tt>bit_rank</tt> and
+ * <tt>bit_select</tt>. The index is a little over an eighth the size of the set.
+ * It must be rebuilt after the set changes.
+ *
+ * @param[in] r Destination of rank index.
+ * @param[in] s Set being indexed.
+ * @param[in] m Number of setwords in set.
+ */
+extern void bit_rankindex(uint64_t r[restrict static 1],
+                          const sets_t s[restrict static 1], size_t m);
+
+/**
+ * @brief Number of elements of set less than <tt>pos</tt>.
+ *
+ * Reads one index entry and one setword, whatever the size of the set.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>r</tt> is not the current rank index of <tt>s</tt>.</dd>
+ * <dd><tt>pos</tt> is larger than the number of elements of the universe.</dd>
+ * </dl>
+ *
+ * @param[in] r Rank index of set.
+ * @param[in] s Set being ranked in.
+ * @param[in] pos Element of universe.
+ *
+ * @retval size_t Number of elements less than <tt>pos</tt>; the position of
+ * <tt>pos</tt> in the set if an element.
+ */
+static inline
+size_t bit_rank(const uint64_t r[static 1], const sets_t s[static 1], size_t pos)
+{
+  size_t w = _SETWD(pos), j = w >> 3, k = w & 7, b = _SETBT(pos);
+  size_t rank = r[2 * j];
+  if ( k != 0 ) rank += (r[2 * j + 1] >> (9 * (k - 1))) & 0x1FF;
+  if ( b != 0 ) rank += _POPCOUNT(s[w] & (~(uint64_t)0 >> (_WORDSIZE - b)));
+  return rank;
+}
+
+/**
+ * @brief Element of set of given rank.
+ *
+ * Finds the superblock by binary search over the index, then the setword from
+ * the counts of the superblock, then the element within the setword.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>r</tt> is not the current rank index of <tt>s</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] r Rank index of set.
+ * @param[in] s Set being searched.
+ * @param[in] m Number of setwords in set.
+ * @param[in] k Rank of element, from 0.
+ *
+ * @retval int Element of set with <tt>k</tt> elements less than it. Returns -1
+ * if the set has no more than <tt>k</tt> elements.
+ */
+extern int bit_select(const uint64_t r[static 1], const sets_t s[static 1],
+                      size_t m, size_t k);
+
+/**
+ * @brief Hash function for sets.
+ *
+ * Equal to <tt>hashes_bytes(s, m * sizeof(sets_t), seed)</tt>, which reads the
+ * set a word at a time. The hash of <tt>flathashtabs_new_sets</tt> tables is
+ * that of seed 0.
+ *
+ * @param[in] s Set being hashed.
+ * @param[in] m Number of setwords in set.
+ * @param[in] seed Seed of the hash function.
+ *
+ * @retval uint64_t Hash value of set.
+ */
+extern uint64_t bit_hash(const sets_t s[static 1], size_t m, uint64_t seed);
+
+/**
+ * @brief Test if two sets are equal.
+ *
+ * Compares all setwords without branching on them, which for sets of a few
+ * setwords is faster than stopping at the first difference.
+ *
+ * @param[in] s1 First set.
+ * @param[in] s2 Second set.
+ * @param[in] m Number of setwords in sets.
+ *
+ * @retval int Returns 1 if the sets are equal. Returns -1 otherwise.
+ */
+static inline
+int bit_equal(const sets_t s1[static 1], const sets_t s2[static 1], size_t m)
+{
+  setwords_t d = 0;
+  for ( size_t i = 0; i < m; i++ ) d |= s1[i] ^ s2[i];
+  return d == 0 ? 1 : -1;
+}
+
 /**
  * @brief Check if cardinality of intersection of two sets is a given value.
  *
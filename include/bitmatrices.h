@@ -0,0 +1,292 @@
+/**
+ * @file bitmatrices.h
+ * @brief Public interface of <tt>bitmatrices_t</tt> class
+ *
+ * The <tt>bitmatrices_t</tt> object instantiates a dense matrix of bits, such
+ * as the adjacency matrix of a graph. Each row is a set of <tt>bit_sets.h</tt>
+ * of <tt>bitmatrices_setwords</tt> setwords, so rows can be handed to the
+ * <tt>bit_*</tt> functions directly. Rows start on 64-byte cache lines, and
+ * the setwords past the last column are kept zero.
+ *
+ * Whole-matrix operations (column extraction, transpose, the union of the rows
+ * selected by a set, transitive closure) go through the multi-word set kernels
+ * of <tt>bit_sets.h</tt>.
+ *
+ * The <tt>bitmatrices_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_BITMATRICES_H
+# define INCLUDED_BITMATRICES_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+# include "bit_sets.h"
+
+typedef struct bitmatrices_t* bitmatrices_t;
+
+/**
+ * @brief Instantiates a <tt>bitmatrices_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>rows</tt> by <tt>cols</tt> matrix of zero
+ * bits. This memory needs to be freed by a call to <tt>bitmatrices_free</tt>.
+ *
+ * @param[in] rows Number of rows.
+ * @param[in] cols Number of columns.
+ *
+ * @return New matrix object.
+ */
+extern bitmatrices_t bitmatrices_new(size_t rows, size_t cols);
+
+/**
+ * @brief Instantiates a <tt>bitmatrices_t</tt> instance through an allocator.
+ *
+ * As <tt>bitmatrices_new</tt>, but the matrix object and its rows are allocated
+ * through <tt>al</tt>, which is copied. The rows are aligned to cache lines
+ * whatever the alignment of the allocator.
+ *
+ * @param[in] rows Number of rows.
+ * @param[in] cols Number of columns.
+ * @param[in] al Allocator of matrix object.
+ *
+ * @return New matrix object.
+ */
+extern bitmatrices_t bitmatrices_new_alloc(size_t rows, size_t cols,
+                                           const allocators_t *al);
+
+/**
+ * @brief Frees memory of matrix object.
+ *
+ * @param[in] b Pointer to matrix object being freed.
+ */
+extern void bitmatrices_free(bitmatrices_t *b);
+
+/**
+ * @brief Number of rows of matrix object.
+ *
+ * @param[in] b Matrix object.
+ *
+ * @return Number of rows.
+ */
+extern size_t bitmatrices_rows(bitmatrices_t b);
+
+/**
+ * @brief Number of columns of matrix object.
+ *
+ * @param[in] b Matrix object.
+ *
+ * @return Number of columns.
+ */
+extern size_t bitmatrices_cols(bitmatrices_t b);
+
+/**
+ * @brief Number of setwords of the rows of matrix object.
+ *
+ * @param[in] b Matrix object.
+ *
+ * @return <tt>_SETWORDSNEEDED</tt> of the number of columns.
+ */
+extern size_t bitmatrices_setwords(bitmatrices_t b);
+
+/**
+ * @brief Row of matrix object.
+ *
+ * The row may be read and written as a set of <tt>bitmatrices_setwords</tt>
+ * setwords. Elements of the set must be less than the number of columns.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than the number of rows.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] i Index of row.
+ *
+ * @return Pointer to the first setword of the row, aligned to 64 bytes.
+ */
+extern sets_t *bitmatrices_row(bitmatrices_t b, size_t i);
+
+/**
+ * @brief Sets bit of matrix object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> or <tt>j</tt> is out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] i Row of bit.
+ * @param[in] j Column of bit.
+ */
+extern void bitmatrices_add(bitmatrices_t b, size_t i, size_t j);
+
+/**
+ * @brief Clears bit of matrix object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> or <tt>j</tt> is out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] i Row of bit.
+ * @param[in] j Column of bit.
+ */
+extern void bitmatrices_del(bitmatrices_t b, size_t i, size_t j);
+
+/**
+ * @brief Test bit of matrix object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> or <tt>j</tt> is out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] i Row of bit.
+ * @param[in] j Column of bit.
+ *
+ * @retval int Returns 1 if the bit is set. Returns -1 otherwise.
+ */
+extern int bitmatrices_iselement(bitmatrices_t b, size_t i, size_t j);
+
+/**
+ * @brief Column of matrix object.
+ *
+ * Places the set of rows with bit <tt>j</tt> set in <tt>s</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>j</tt> is not less than the number of columns.</dd>
+ * <dd><tt>s</tt> holds fewer than <tt>_SETWORDSNEEDED</tt> of the number of
+ * rows setwords.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] j Index of column.
+ * @param[out] s Destination of column.
+ */
+extern void bitmatrices_column(bitmatrices_t b, size_t j, sets_t s[static 1]);
+
+/**
+ * @brief Transpose of matrix object.
+ *
+ * Returns a new matrix, allocated as <tt>b</tt>, with bit <tt>(j, i)</tt> set
+ * when bit <tt>(i, j)</tt> of <tt>b</tt> is set. The matrix is transposed in
+ * blocks of 64 by 64 bits, each transposed within registers, so that every
+ * setword is read and written once.
+ *
+ * @param[in] b Matrix object being transposed.
+ *
+ * @return New matrix object of <tt>cols</tt> rows and <tt>rows</tt> columns.
+ */
+extern bitmatrices_t bitmatrices_transpose(bitmatrices_t b);
+
+/**
+ * @brief Union of the rows selected by a set.
+ *
+ * Places the union of the rows <tt>i</tt> of <tt>b</tt> for the elements
+ * <tt>i</tt> of <tt>v</tt> in <tt>s</tt>: the product of the vector
+ * <tt>v</tt> and the matrix over the Boolean semiring. For an adjacency
+ * matrix, the neighbours of the vertices of <tt>v</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>v</tt> holds fewer than <tt>_SETWORDSNEEDED</tt> of the number of
+ * rows setwords, or has elements beyond the last row.</dd>
+ * <dd><tt>s</tt> holds fewer than <tt>bitmatrices_setwords</tt> setwords, or
+ * is an alias of a row.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] v Set of rows.
+ * @param[out] s Destination of union.
+ */
+extern void bitmatrices_orrows(bitmatrices_t b, const sets_t v[static 1],
+                               sets_t s[static 1]);
+
+/**
+ * @brief Sizes of the intersections of a set with the rows.
+ *
+ * Places the size of the intersection of <tt>s</tt> and row <tt>i</tt> in
+ * <tt>c[i]</tt>, for every row, through <tt>bit_intersectsizes</tt>. For an
+ * adjacency matrix, the number of neighbours of each vertex in <tt>s</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>s</tt> holds fewer than <tt>bitmatrices_setwords</tt> setwords.</dd>
+ * <dd><tt>c</tt> holds fewer than the number of rows elements.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] s Set being intersected with the rows.
+ * @param[out] c Destination of sizes.
+ */
+extern void bitmatrices_intersectsizes(bitmatrices_t b,
+                                       const sets_t s[static 1],
+                                       uint32_t c[static 1]);
+
+/**
+ * @brief Rows meeting a set in at least a given number of elements.
+ *
+ * Places the set of rows whose intersection with <tt>s</tt> has at least
+ * <tt>num</tt> elements in <tt>r</tt>, through <tt>bit_intersectfilter</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>s</tt> holds fewer than <tt>bitmatrices_setwords</tt> setwords.</dd>
+ * <dd><tt>r</tt> holds fewer than <tt>_SETWORDSNEEDED</tt> of the number of
+ * rows setwords, or is an alias of a row.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object.
+ * @param[in] s Set being intersected with the rows.
+ * @param[in] num Least size of intersection.
+ * @param[out] r Destination of set of rows.
+ *
+ * @return Number of rows placed in <tt>r</tt>.
+ */
+extern size_t bitmatrices_intersectfilter(bitmatrices_t b,
+                                          const sets_t s[static 1],
+                                          size_t num, sets_t r[static 1]);
+
+/**
+ * @brief Transitive closure of matrix object.
+ *
+ * Replaces the square matrix <tt>b</tt> by its transitive closure, in the
+ * manner of Warshall: for each <tt>k</tt>, every row <tt>i</tt> with bit
+ * <tt>(i, k)</tt> set takes the union of itself and row <tt>k</tt>. For an
+ * adjacency matrix, bit <tt>(i, j)</tt> ends up set when <tt>j</tt> is
+ * reachable from <tt>i</tt> by a nonempty path.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Matrix object is not square.</dd>
+ * </dl>
+ *
+ * @param[in] b Matrix object being closed.
+ */
+extern void bitmatrices_closure(bitmatrices_t b);
+
+/**
+ * @brief Swaps two matrix objects.
+ *
+ * @param[in] b1 First matrix.
+ * @param[in] b2 Second matrix.
+ */
+static inline
+void bitmatrices_swap(bitmatrices_t *restrict b1, bitmatrices_t *restrict b2)
+{
+  volatile bitmatrices_t tmp = *b1;
+  *b1 = *b2;
+  *b2 = tmp;
+}
+
+# endif
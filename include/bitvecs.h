@@ -0,0 +1,244 @@
+/**
+ * @file bitvecs.h
+ * @brief Public interface of <tt>bitvecs_t</tt> class
+ *
+ * The <tt>bitvecs_t</tt> object instantiates a growable set of bits owning its
+ * setwords, and keeping track of its universe, the number of possible
+ * elements. Adding an element past the universe grows it, so that callers no
+ * longer size sets with <tt>_SETWORDSNEEDED</tt> themselves.
+ *
+ * The setwords are a set of <tt>bit_sets.h</tt> of
+ * <tt>bitvecs_setwords</tt> setwords, handed out by <tt>bitvecs_words</tt> to
+ * be passed to the <tt>bit_*</tt> functions and macros directly, without
+ * copying. They start on 64-byte cache lines, and the setwords and bits past
+ * the universe are kept zero. Storage grows geometrically, by whole cache
+ * lines.
+ *
+ * The <tt>bitvecs_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_BITVECS_H
+# define INCLUDED_BITVECS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+# include "bit_sets.h"
+
+typedef struct bitvecs_t* bitvecs_t;
+
+/**
+ * @brief Instantiates a <tt>bitvecs_t</tt> instance.
+ *
+ * Memory is allocated for a new, empty set of universe <tt>n</tt>. This memory
+ * needs to be freed by a call to <tt>bitvecs_free</tt>.
+ *
+ * @param[in] n Universe of the set.
+ *
+ * @return New set object.
+ */
+extern bitvecs_t bitvecs_new(size_t n);
+
+/**
+ * @brief Instantiates a <tt>bitvecs_t</tt> instance through an allocator.
+ *
+ * As <tt>bitvecs_new</tt>, but the set object and its setwords are allocated
+ * through <tt>al</tt>, which is copied. The setwords are aligned to cache
+ * lines whatever the alignment of the allocator.
+ *
+ * @param[in] n Universe of the set.
+ * @param[in] al Allocator of set object.
+ *
+ * @return New set object.
+ */
+extern bitvecs_t bitvecs_new_alloc(size_t n, const allocators_t *al);
+
+/**
+ * @brief Free set object.
+ *
+ * @param[in] *v Pointer to <tt>bitvecs_t</tt> object.
+ */
+extern void bitvecs_free(bitvecs_t *v);
+
+/**
+ * @brief Copy of set object.
+ *
+ * @param[in] v Set object being copied.
+ *
+ * @return New set object, of the universe, elements and allocator of
+ * <tt>v</tt>.
+ */
+extern bitvecs_t bitvecs_copy(bitvecs_t v);
+
+/**
+ * @brief Universe of set object.
+ *
+ * @param[in] v Set object.
+ *
+ * @return Number of possible elements.
+ */
+extern size_t bitvecs_universe(bitvecs_t v);
+
+/**
+ * @brief Number of setwords of set object.
+ *
+ * @param[in] v Set object.
+ *
+ * @return Setwords holding the universe, <tt>m</tt> of the <tt>bit_*</tt>
+ * functions.
+ */
+extern size_t bitvecs_setwords(bitvecs_t v);
+
+/**
+ * @brief Setwords of set object.
+ *
+ * The setwords may be read and written by the <tt>bit_*</tt> functions and
+ * macros as a set of <tt>bitvecs_setwords</tt> setwords. Elements of the set
+ * must be less than the universe.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Using the pointer after the set grows.</dd>
+ * </dl>
+ *
+ * @param[in] v Set object.
+ *
+ * @return Pointer to the first setword, aligned to 64 bytes, and valid until
+ * the universe grows.
+ */
+extern sets_t *bitvecs_words(bitvecs_t v);
+
+/**
+ * @brief Change universe of set object.
+ *
+ * Elements not less than the new universe are removed.
+ *
+ * @param[in] v Set object.
+ * @param[in] n New universe of the set.
+ */
+extern void bitvecs_resize(bitvecs_t v, size_t n);
+
+/**
+ * @brief Add element to set object.
+ *
+ * If <tt>i</tt> is not less than the universe, the universe grows to
+ * <tt>i + 1</tt>.
+ *
+ * @param[in] v Set object.
+ * @param[in] i Element being added.
+ */
+extern void bitvecs_add(bitvecs_t v, size_t i);
+
+/**
+ * @brief Remove element from set object.
+ *
+ * Elements past the universe are not in the set, and removing them leaves the
+ * universe as is.
+ *
+ * @param[in] v Set object.
+ * @param[in] i Element being removed.
+ */
+extern void bitvecs_del(bitvecs_t v, size_t i);
+
+/**
+ * @brief Test element of set object.
+ *
+ * @param[in] v Set object.
+ * @param[in] i Element being tested.
+ *
+ * @retval int Returns 1 if <tt>i</tt> is in the set. Returns -1 otherwise,
+ * including if <tt>i</tt> is past the universe.
+ */
+extern int bitvecs_iselement(bitvecs_t v, size_t i);
+
+/**
+ * @brief Remove every element of set object.
+ *
+ * The universe is left as is.
+ *
+ * @param[in] v Set object.
+ */
+extern void bitvecs_clear(bitvecs_t v);
+
+/**
+ * @brief Number of elements of set object.
+ *
+ * @param[in] v Set object.
+ *
+ * @return Number of elements in set.
+ */
+extern size_t bitvecs_size(bitvecs_t v);
+
+/**
+ * @brief Union of set objects into the first.
+ *
+ * Places <tt>d | s</tt> in <tt>d</tt>, through <tt>bit_union</tt>. The
+ * universe of <tt>d</tt> grows to that of <tt>s</tt> if smaller.
+ *
+ * @param[in] d Destination and first operand of union.
+ * @param[in] s Second operand.
+ */
+extern void bitvecs_union(bitvecs_t d, bitvecs_t s);
+
+/**
+ * @brief Intersection of set objects into the first.
+ *
+ * Places <tt>d & s</tt> in <tt>d</tt>, through <tt>bit_intersection</tt>. The
+ * universe of <tt>d</tt> is left as is, elements past that of <tt>s</tt> being
+ * removed.
+ *
+ * @param[in] d Destination and first operand of intersection.
+ * @param[in] s Second operand.
+ */
+extern void bitvecs_intersection(bitvecs_t d, bitvecs_t s);
+
+/**
+ * @brief Difference of set objects into the first.
+ *
+ * Places <tt>d & ~s</tt> in <tt>d</tt>, through <tt>bit_difference</tt>. The
+ * universe of <tt>d</tt> is left as is.
+ *
+ * @param[in] d Destination and first operand of difference.
+ * @param[in] s Second operand.
+ */
+extern void bitvecs_difference(bitvecs_t d, bitvecs_t s);
+
+/**
+ * @brief Test if set objects are equal.
+ *
+ * Sets of different universes are equal if they have the same elements.
+ *
+ * @param[in] v1 First set object.
+ * @param[in] v2 Second set object.
+ *
+ * @retval int Returns 1 if the sets are equal. Returns -1 otherwise.
+ */
+extern int bitvecs_equal(bitvecs_t v1, bitvecs_t v2);
+
+/**
+ * @brief Swap opaque pointers for set objects.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Set objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] v1 First set object.
+ * @param[in] v2 Second set object.
+ */
+static inline
+void bitvecs_swap(bitvecs_t *restrict v1, bitvecs_t *restrict v2)
+{
+  volatile bitvecs_t tmp = *v1;
+  *v1 = *v2;
+  *v2 = tmp;
+}
+
+# endif
@@ -0,0 +1,141 @@
+/**
+ * @file blooms.h
+ * @brief Public interface of <tt>blooms_t</tt> class
+ *
+ * The <tt>blooms_t</tt> object instantiates a blocked Bloom filter of 64-bit
+ * hash values, answering whether a hash value may have been added, or surely
+ * has not. Each hash value picks one block of 512 bits, one cache line of 8
+ * setwords of <tt>bit_sets.h</tt>, by its high bits, and sets or tests a few
+ * bits of that block picked by a remix of it through <tt>hashes_u64</tt>. A
+ * test then reads a single cache line.
+ *
+ * Hash values cannot be removed. A filter answers "may be present" for every
+ * hash value added since it was made or last cleared, and for a small fraction
+ * of the others, falling as the bits per element grow.
+ *
+ * A filter may be attached to a <tt>hashtabs_t</tt> with
+ * <tt>hashtabs_setfilter</tt>, so that finds of data not in the table return
+ * before touching its buckets.
+ *
+ * The <tt>blooms_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_BLOOMS_H
+# define INCLUDED_BLOOMS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+
+typedef struct blooms_t* blooms_t;
+
+/**
+ * @brief Instantiates a <tt>blooms_t</tt> instance.
+ *
+ * Memory is allocated for a filter of <tt>bits</tt> bits for each of
+ * <tt>n</tt> hash values, rounded up to a power of two number of blocks. About
+ * 0.7 bits of a block are set per hash value and bit of <tt>bits</tt>, at most
+ * 7. This memory needs to be freed by a call to <tt>blooms_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>bits</tt> is 0.</dd>
+ * </dl>
+ *
+ * @param[in] n Number of hash values expected.
+ * @param[in] bits Bits of the filter per hash value.
+ *
+ * @return New filter object.
+ */
+extern blooms_t blooms_new(size_t n, size_t bits);
+
+/**
+ * @brief Instantiates a <tt>blooms_t</tt> instance through an allocator.
+ *
+ * As <tt>blooms_new</tt>, but the filter object and its blocks are allocated
+ * through <tt>al</tt>, which is copied.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>bits</tt> is 0.</dd>
+ * </dl>
+ *
+ * @param[in] n Number of hash values expected.
+ * @param[in] bits Bits of the filter per hash value.
+ * @param[in] al Allocator of filter object.
+ *
+ * @return New filter object.
+ */
+extern blooms_t blooms_new_alloc(size_t n, size_t bits,
+                                 const allocators_t *al);
+
+/**
+ * @brief Frees memory of filter object.
+ *
+ * @param[in] b Pointer to filter object being freed.
+ */
+extern void blooms_free(blooms_t *b);
+
+/**
+ * @brief Adds hash value to filter object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>blooms_add</tt> on a <tt>NULL</tt> filter object.</dd>
+ * </dl>
+ *
+ * @param[in] b Filter object being added to.
+ * @param[in] h Hash value being added.
+ */
+extern void blooms_add(blooms_t b, uint64_t h);
+
+/**
+ * @brief Test membership in filter object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>blooms_contains</tt> on a <tt>NULL</tt> filter object.</dd>
+ * </dl>
+ *
+ * @param[in] b Filter object being searched.
+ * @param[in] h Hash value being searched for.
+ *
+ * @retval int Returns 1 if <tt>h</tt> may have been added. Returns -1 if it
+ * surely has not.
+ */
+extern int blooms_contains(blooms_t b, uint64_t h);
+
+/**
+ * @brief Removes every hash value from filter object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>blooms_clear</tt> on a <tt>NULL</tt> filter object.</dd>
+ * </dl>
+ *
+ * @param[in] b Filter object being cleared.
+ */
+extern void blooms_clear(blooms_t b);
+
+/**
+ * @brief Bits of filter object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>blooms_bits</tt> on a <tt>NULL</tt> filter object.</dd>
+ * </dl>
+ *
+ * @param[in] b Filter object.
+ *
+ * @return Number of bits of the blocks of the filter.
+ */
+extern size_t blooms_bits(blooms_t b);
+
+# endif
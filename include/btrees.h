@@ -0,0 +1,477 @@
+/**
+ * @file btrees.h
+ * @brief Public interface of <tt>btrees_t</tt> class
+ *
+ * The <tt>btrees_t</tt> object instantiates shallow ordered-set associations
+ * between already existing data, stored in a B-tree. Each node holds up to
+ * <tt>2 * BTREES_ORDER - 1</tt> pointers to data in one contiguous array, so that
+ * a search visits O(log n) nodes instead of O(n) links of <tt>queues_t</tt>,
+ * and a range of data is visited node by node.
+ *
+ * Besides inserting, finding and removing data, the tree answers
+ * <tt>btrees_lower_bound</tt> and <tt>btrees_upper_bound</tt> queries, applies a
+ * function to the data of a range with <tt>btrees_range</tt>, and pops its least
+ * or greatest data object.
+ *
+ * The user is responsible for allocating and deallocating the data. The routine
+ * <tt>btrees_free</tt> only deallocates the nodes of the tree.
+ *
+ * Repetitions are not allowed, and data must be linearly ordered.
+ *
+ * The <tt>btrees_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_BTREES_H
+# define INCLUDED_BTREES_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Minimum degree of the B-tree. Nodes other than the root hold between
+ * <tt>BTREES_ORDER - 1</tt> and <tt>2 * BTREES_ORDER - 1</tt> data objects.
+ */
+# define BTREES_ORDER 16
+
+typedef struct btrees_t* btrees_t;
+
+/**
+ * @brief User provided compare function. Must provide a linear ordering of the
+ * data.
+ */
+typedef int (*btrees_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must provide a linear ordering
+ * of the data.
+ */
+typedef int (*btrees_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief Instantiates a <tt>btrees_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>btrees_t</tt> instance. This memory needs to
+ * be freed by a call to <tt>btrees_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>btrees_data_cmp</tt> and <tt>btrees_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ *
+ * @return Instance of tree object.
+ */
+extern btrees_t btrees_new(btrees_data_cmp cmp, btrees_data_cmp_r cmp_r);
+
+/**
+ * @brief Instantiates a <tt>btrees_t</tt> instance with a user allocator.
+ *
+ * As <tt>btrees_new</tt>, but the tree object and its nodes are allocated and
+ * freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>btrees_data_cmp</tt> and <tt>btrees_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ * @param[in] al Allocator of the tree.
+ *
+ * @return Instance of tree object.
+ */
+extern btrees_t btrees_new_alloc(btrees_data_cmp cmp, btrees_data_cmp_r cmp_r,
+                                 const allocators_t *al);
+
+/**
+ * @brief Inserts pointer to data object into tree object.
+ *
+ * If a data object equal to the user provided data parameter is not present in
+ * the tree, then a pointer to the data is added to the tree.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_insert</tt> on a <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being added to.
+ * @param[in] x Pointer to data being added to tree object.
+ */
+extern void btrees_insert(btrees_t t, const void *x);
+
+/**
+ * @brief Inserts pointer to data object into tree object.
+ *
+ * Reentrant version of <tt>btrees_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_insert_r</tt> on a <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being added to.
+ * @param[in] x Pointer to data being added to tree object.
+ * @param[in] y Argument to user provided reentrant compare function.
+ */
+extern void btrees_insert_r(btrees_t t, const void *x, void *y);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in tree
+ * object.
+ *
+ * Check if data equal to user provided data object is contained in tree object.
+ * Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_find</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ * @param[in] x Data whose membership is being checked.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_find(btrees_t t, const void *x);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in tree
+ * object.
+ *
+ * Reentrant version of <tt>btrees_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_find_r</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ * @param[in] x Data whose membership is being checked.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_find_r(btrees_t t, const void *x, void *y);
+
+/**
+ * @brief Least data object of tree object not less than the user provided data
+ * object.
+ *
+ * Least data object of tree object not less than the user provided data object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_lower_bound</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ * @param[in] x Data object bounding the result from below.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_lower_bound(btrees_t t, const void *x);
+
+/**
+ * @brief Least data object of tree object not less than the user provided data
+ * object.
+ *
+ * Reentrant version of <tt>btrees_lower_bound</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_lower_bound_r</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ * @param[in] x Data object bounding the result from below.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_lower_bound_r(btrees_t t, const void *x, void *y);
+
+/**
+ * @brief Least data object of tree object greater than the user provided data
+ * object.
+ *
+ * Least data object of tree object greater than the user provided data object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_upper_bound</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ * @param[in] x Data object bounding the result from below.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_upper_bound(btrees_t t, const void *x);
+
+/**
+ * @brief Least data object of tree object greater than the user provided data
+ * object.
+ *
+ * Reentrant version of <tt>btrees_upper_bound</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_upper_bound_r</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ * @param[in] x Data object bounding the result from below.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_upper_bound_r(btrees_t t, const void *x, void *y);
+
+/**
+ * @brief Remove pointer to data object in tree object (if present) equal in
+ * value to the data object parameter provided by the user.
+ *
+ * If found, the pointer to the data object is removed from the tree and
+ * returned to the user. If not found, <tt>NULL</tt> is returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_remove</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_remove(btrees_t t, const void *x);
+
+/**
+ * @brief Remove pointer to data object in tree object (if present) equal in
+ * value to the data object parameter provided by the user.
+ *
+ * Reentrant version of <tt>btrees_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_remove_r</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_remove_r(btrees_t t, const void *x, void *y);
+
+/**
+ * @brief Least data object of tree object.
+ *
+ * Least data object of tree object, which is left in the tree.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_min</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_min(btrees_t t);
+
+/**
+ * @brief Greatest data object of tree object.
+ *
+ * Greatest data object of tree object, which is left in the tree.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_max</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being searched.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_max(btrees_t t);
+
+/**
+ * @brief Remove least data object of tree object.
+ *
+ * The pointer to the least data object is removed from the tree and returned to
+ * the user. No compare function is called.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_pop_min</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being popped.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_pop_min(btrees_t t);
+
+/**
+ * @brief Remove greatest data object of tree object.
+ *
+ * The pointer to the greatest data object is removed from the tree and returned
+ * to the user. No compare function is called.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_pop_max</tt> on <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being popped.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *btrees_pop_max(btrees_t t);
+
+/**
+ * @brief Apply function to the members of a range of tree object.
+ *
+ * The function <tt>apply</tt> is applied, in order, to every member of the tree
+ * not less than <tt>lo</tt> and less than <tt>hi</tt>. A <tt>NULL</tt> bound
+ * leaves the range unbounded on its side. Early termination is possible if
+ * <tt>apply</tt> returns a negative <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_range</tt> on <tt>NULL</tt> tree object.</dd>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being acted upon.
+ * @param[in] lo Least data object of range, or <tt>NULL</tt>.
+ * @param[in] hi Data object ending range, or <tt>NULL</tt>.
+ * @param[in] apply Function being applied to members of the range.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int btrees_range(btrees_t t, const void *lo, const void *hi,
+                        int apply(void **x));
+
+/**
+ * @brief Apply function to the members of a range of tree object.
+ *
+ * Reentrant version of <tt>btrees_range</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_range_r</tt> on <tt>NULL</tt> tree object.</dd>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being acted upon.
+ * @param[in] lo Least data object of range, or <tt>NULL</tt>.
+ * @param[in] hi Data object ending range, or <tt>NULL</tt>.
+ * @param[in] apply Function being applied to members of the range.
+ * @param[in] y Argument to user provided function apply.
+ * @param[in] cmp_arg Argument to user provided compare function.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int btrees_range_r(btrees_t t, const void *lo, const void *hi,
+                          int apply(void **x, void *y), void *y, void *cmp_arg);
+
+/**
+ * @brief Apply function to every member of tree object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the tree, in order.
+ * Early termination is possible if <tt>apply</tt> returns a negative
+ * <tt>int</tt>. In all other cases, we continue to apply <tt>apply</tt> to the
+ * succeeding data object (if any) of the tree.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being acted upon.
+ * @param[in] apply Function being applied to members of the tree.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int btrees_map(btrees_t t, int apply(void **x));
+
+/**
+ * @brief Apply function to every member of tree object.
+ *
+ * Reentrant version of <tt>btrees_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being acted upon.
+ * @param[in] apply Function being applied to members of the tree.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int btrees_map_r(btrees_t t, int apply(void **x, void *y), void *y);
+
+/**
+ * @brief Free data allocated for the tree associations.
+ *
+ * Only the nodes of the tree are freed.
+ *
+ * @param[in] *t Pointer to <tt>btrees_t</tt> object.
+ */
+extern void btrees_free(btrees_t *t);
+
+/**
+ * @brief Number of elements in tree.
+ *
+ * Number of elements in tree.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>btrees_size</tt> on a <tt>NULL</tt> tree object.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object being checked.
+ *
+ * @return Number of members of the tree.
+ */
+extern size_t btrees_size(btrees_t t);
+
+/**
+ * @brief Swap opaque pointers for trees.
+ *
+ * Swap opaque pointers for trees.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Tree objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] t1 First tree.
+ * @param[in] t2 Second tree.
+ */
+static inline
+void btrees_swap(btrees_t *restrict t1, btrees_t *restrict t2)
+{
+  volatile btrees_t tmp = *t1;
+  *t1 = *t2;
+  *t2 = tmp;
+}
+
+# endif
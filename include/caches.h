@@ -0,0 +1,338 @@
+/**
+ * @file caches.h
+ * @brief Public interface of <tt>caches_t</tt> class
+ *
+ * The <tt>caches_t</tt> object instantiates a bounded cache of already existing
+ * data, found by a <tt>hashtabs_t</tt> of this same library and ordered from
+ * most to least recently used by links held with each element. A find, an
+ * insert and an eviction each cost one probe of the hash table and a constant
+ * number of link updates; the recency order does not depend on the user
+ * provided compare function.
+ *
+ * Once the cache holds <tt>capacity</tt> elements, inserting another evicts the
+ * least recently used one, which is handed to the eviction function set by
+ * <tt>caches_onevict</tt>. As with <tt>hashtabs_t</tt>, the user is responsible
+ * for allocating and deallocating the data.
+ *
+ * Repetitions are not allowed, and data must be linearly ordered.
+ *
+ * The <tt>caches_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_CACHES_H
+# define INCLUDED_CACHES_H
+
+# include <stdint.h>
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+# include "hashtabs.h"
+
+typedef struct caches_t* caches_t;
+
+/**
+ * @brief User provided compare function. Must return -1, 0, or 1.
+ */
+typedef int (*caches_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must return -1, 0, or 1.
+ */
+typedef int (*caches_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief User provided hashing function.
+ */
+typedef uint64_t (*caches_hash)(const void*);
+
+/**
+ * @brief User provided reentrant hashing function.
+ */
+typedef uint64_t (*caches_hash_r)(const void*, const void*);
+
+/**
+ * @brief Counts of a cache, filled in by <tt>caches_stats</tt>.
+ */
+typedef struct {
+  size_t size;      ///< number of elements
+  size_t capacity;  ///< most elements held
+  size_t hits;      ///< finds of data in the cache
+  size_t misses;    ///< finds of data not in the cache
+  size_t evictions; ///< elements evicted by inserts
+} caches_stats_t;
+
+/**
+ * @brief Instantiates a <tt>caches_t</tt> instance.
+ *
+ * Memory is allocated for a cache of at most <tt>capacity</tt> elements, all of
+ * it up front. This memory needs to be freed by a call to
+ * <tt>caches_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>caches_data_cmp</tt> and <tt>caches_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>caches_hash</tt> and <tt>caches_hash_r</tt> arguments are
+ * <tt>NULL</tt>.</dd>
+ * <dd><tt>capacity</tt> is 0.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] capacity Most elements held by the cache.
+ *
+ * @return Instance of cache object.
+ */
+extern caches_t caches_new(caches_data_cmp cmp, caches_data_cmp_r cmp_r,
+                           caches_hash hash, caches_hash_r hash_r,
+                           size_t capacity);
+
+/**
+ * @brief Instantiates a <tt>caches_t</tt> instance with a user allocator.
+ *
+ * As <tt>caches_new</tt>, but the cache object, its hash table and its links
+ * are allocated and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>caches_data_cmp</tt> and <tt>caches_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>caches_hash</tt> and <tt>caches_hash_r</tt> arguments are
+ * <tt>NULL</tt>.</dd>
+ * <dd><tt>capacity</tt> is 0.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] capacity Most elements held by the cache.
+ * @param[in] al Allocator of the cache.
+ *
+ * @return Instance of cache object.
+ */
+extern caches_t caches_new_alloc(caches_data_cmp cmp, caches_data_cmp_r cmp_r,
+                                 caches_hash hash, caches_hash_r hash_r,
+                                 size_t capacity, const allocators_t *al);
+
+/**
+ * @brief Sets the function called with each evicted element.
+ *
+ * <tt>evict</tt> is called with an element evicted by an insert, and with
+ * <tt>y</tt>, once the element has left the cache; it may, for one, free the
+ * element. Evictions are not reported if <tt>evict</tt> is <tt>NULL</tt>, as
+ * they are not before <tt>caches_onevict</tt> is first called.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_onevict</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object.
+ * @param[in] evict User provided eviction function, or <tt>NULL</tt>.
+ * @param[in] y Argument to <tt>evict</tt>.
+ */
+extern void caches_onevict(caches_t c, void evict(void *x, void *y), void *y);
+
+/**
+ * @brief Finds data object in cache object, marking it most recently used.
+ *
+ * Counts a hit if data equal to <tt>x</tt> is found, and a miss otherwise.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_get</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *caches_get(caches_t c, const void *x);
+
+/**
+ * @brief Finds data object in cache object, marking it most recently used.
+ *
+ * Reentrant version of <tt>caches_get</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_get_r</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *caches_get_r(caches_t c, const void *x, const void *hash_arg,
+                          void *queue_arg);
+
+/**
+ * @brief Inserts pointer to data object into cache object as most recently
+ * used.
+ *
+ * If data equal to <tt>x</tt> is in the cache, it is replaced by <tt>x</tt> and
+ * handed back. Otherwise, if the cache is full, the least recently used element
+ * is evicted first.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_put</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being added to.
+ * @param[in] x Pointer to data being added to cache object.
+ *
+ * @return Pointer to the data replaced, or <tt>NULL</tt> if none.
+ */
+extern void *caches_put(caches_t c, const void *x);
+
+/**
+ * @brief Inserts pointer to data object into cache object as most recently
+ * used.
+ *
+ * Reentrant version of <tt>caches_put</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_put_r</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being added to.
+ * @param[in] x Pointer to data being added to cache object.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the data replaced, or <tt>NULL</tt> if none.
+ */
+extern void *caches_put_r(caches_t c, const void *x, const void *hash_arg,
+                          void *queue_arg);
+
+/**
+ * @brief Removes pointer to data object from cache object.
+ *
+ * The element is not handed to the eviction function.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_remove</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being removed from.
+ * @param[in] x Pointer to data equal to the data being removed.
+ *
+ * @return Pointer to the removed data, or <tt>NULL</tt> if not present.
+ */
+extern void *caches_remove(caches_t c, const void *x);
+
+/**
+ * @brief Removes pointer to data object from cache object.
+ *
+ * Reentrant version of <tt>caches_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_remove_r</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being removed from.
+ * @param[in] x Pointer to data equal to the data being removed.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the removed data, or <tt>NULL</tt> if not present.
+ */
+extern void *caches_remove_r(caches_t c, const void *x, const void *hash_arg,
+                             void *queue_arg);
+
+/**
+ * @brief Apply function to every member of cache object, from most to least
+ * recently used.
+ *
+ * The recency order is left unchanged. Early termination is possible if
+ * <tt>apply</tt> returns a negative <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_map</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being acted upon.
+ * @param[in] apply Function being applied to members of the cache.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int caches_map(caches_t c, int apply(void **x));
+
+/**
+ * @brief Apply function to every member of cache object, from most to least
+ * recently used.
+ *
+ * Reentrant version of <tt>caches_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_map_r</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being acted upon.
+ * @param[in] apply Function being applied to members of the cache.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int caches_map_r(caches_t c, int apply(void **x, void *y), void *y);
+
+/**
+ * @brief Free data allocated for the cache.
+ *
+ * The data pointed to by the cache is neither freed nor evicted.
+ *
+ * @param[in] *c Pointer to cache object.
+ */
+extern void caches_free(caches_t *c);
+
+/**
+ * @brief Number of elements in cache.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_size</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being checked.
+ *
+ * @return Number of members of the cache.
+ */
+extern size_t caches_size(caches_t c);
+
+/**
+ * @brief Counts of cache.
+ *
+ * Fill in <tt>s</tt> with the size and capacity of the cache, and the hits,
+ * misses and evictions counted since it was made.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>caches_stats</tt> on a <tt>NULL</tt> cache object.</dd>
+ * </dl>
+ *
+ * @param[in] c Cache object being checked.
+ * @param[out] s Counts of <tt>c</tt>.
+ */
+extern void caches_stats(caches_t c, caches_stats_t *s);
+
+# endif
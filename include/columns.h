@@ -0,0 +1,313 @@
+/**
+ * @file columns.h
+ * @brief Public interface of <tt>columns_t</tt> class
+ *
+ * The <tt>columns_t</tt> object instantiates a dynamic array of records stored
+ * by field rather than by record. The schema, a fixed number of fields of fixed
+ * sizes, is given at instantiation, and each field is kept in a contiguous
+ * column of its own. A scan over one field, by <tt>columns_map</tt> or through
+ * the pointer of <tt>columns_column</tt>, then reads that field only, instead
+ * of pulling whole records of an <tt>arrays_t</tt> through the cache.
+ *
+ * The function <tt>columns_push</tt> copies the fields passed to it by the
+ * user. Sorting by one column permutes every column alike, so that records stay
+ * whole.
+ *
+ * The <tt>columns_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_COLUMNS_H
+# define INCLUDED_COLUMNS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+typedef struct columns_t* columns_t;
+
+/**
+ * @brief Instantiates a <tt>columns_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>columns_t</tt> instance of
+ * <tt>nfields</tt> columns, with room for <tt>capacity</tt> records. This
+ * memory needs to be freed by a call to <tt>columns_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>sizes</tt> holds fewer than <tt>nfields</tt> sizes, or a size of
+ * 0.</dd>
+ * </dl>
+ *
+ * @param[in] nfields Number of fields of records.
+ * @param[in] sizes Size of each field.
+ * @param[in] capacity Number of possible records.
+ *
+ * @return Instance of columns object.
+ */
+extern columns_t columns_new(size_t nfields, const size_t *sizes,
+                             size_t capacity);
+
+/**
+ * @brief Instantiates a <tt>columns_t</tt> instance with a user allocator.
+ *
+ * As <tt>columns_new</tt>, but the columns object and its columns are
+ * allocated, resized and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>sizes</tt> holds fewer than <tt>nfields</tt> sizes, or a size of
+ * 0.</dd>
+ * </dl>
+ *
+ * @param[in] nfields Number of fields of records.
+ * @param[in] sizes Size of each field.
+ * @param[in] capacity Number of possible records.
+ * @param[in] al Allocator of the columns.
+ *
+ * @return Instance of columns object.
+ */
+extern columns_t columns_new_alloc(size_t nfields, const size_t *sizes,
+                                   size_t capacity, const allocators_t *al);
+
+/**
+ * @brief Push record to end of columns object.
+ *
+ * Field <tt>j</tt> of the record is copied from <tt>x[j]</tt> to the end of
+ * column <tt>j</tt>. If the columns are at capacity, they are first grown by
+ * half.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_push</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd><tt>x</tt> holds fewer pointers than there are fields.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object being pushed onto.
+ * @param[in] x Pointers to the fields of the record.
+ */
+extern void columns_push(columns_t c, const void *const *x);
+
+/**
+ * @brief Copy record out of columns object.
+ *
+ * Field <tt>j</tt> of record <tt>i</tt> is copied to <tt>x[j]</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_get</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Index out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object.
+ * @param[in] i Index of record.
+ * @param[out] x Pointers to destinations of the fields.
+ */
+extern void columns_get(columns_t c, size_t i, void *const *x);
+
+/**
+ * @brief Return pointer to field of record.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_at</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Field or index out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object.
+ * @param[in] j Index of field.
+ * @param[in] i Index of record.
+ *
+ * @return Pointer to field <tt>j</tt> of record <tt>i</tt>.
+ */
+extern void *columns_at(columns_t c, size_t j, size_t i);
+
+/**
+ * @brief Return pointer to column.
+ *
+ * The fields <tt>j</tt> of the records lie contiguously from the pointer
+ * returned, which stays valid until the columns are resized or sorted.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_column</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Field out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object.
+ * @param[in] j Index of field.
+ *
+ * @return Pointer to column <tt>j</tt>.
+ */
+extern void *columns_column(columns_t c, size_t j);
+
+/**
+ * @brief Applies user defined function to each field of a column.
+ *
+ * Applies user defined function to field <tt>j</tt> of each record, in order.
+ * Early termination is possible when <tt>apply</tt> returns a negative value.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_map</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Field out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object being acted upon.
+ * @param[in] j Index of field.
+ * @param[in] apply User defined function being applied to every field.
+ *
+ * @return -1 if early termination. 1 if completed without terminating early.
+ */
+extern int columns_map(columns_t c, size_t j, int apply(void *x));
+
+/**
+ * @brief Applies user defined function to each field of a column.
+ *
+ * Reentrant version of <tt>columns_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_map_r</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Field out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object being acted upon.
+ * @param[in] j Index of field.
+ * @param[in] apply User defined function being applied to every field.
+ * @param[in] y Argument to reentrant user defined function.
+ *
+ * @return -1 if early termination. 1 if completed without terminating early.
+ */
+extern int columns_map_r(columns_t c, size_t j, int apply(void *x, void *y),
+                         void *y);
+
+/**
+ * @brief Sort records by a column.
+ *
+ * The records are sorted by their field <tt>j</tt> according to the user
+ * defined compare function. Records of equal fields keep their order. The
+ * permutation is found by sorting indices on column <tt>j</tt> alone, and is
+ * then applied to each column in turn, through a buffer the size of the column.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_sort</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Field out of bounds.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object being sorted.
+ * @param[in] j Index of field sorted by.
+ * @param[in] cmp User defined compare function of fields.
+ */
+extern void columns_sort(columns_t c, size_t j,
+                         int cmp(const void *x, const void *y));
+
+/**
+ * @brief Sort records by a column.
+ *
+ * Reentrant version of <tt>columns_sort</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_sort_r</tt> on a <tt>NULL</tt> columns object.</dd>
+ * <dd>Field out of bounds.</dd>
+ * <dd>Compare function is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object being sorted.
+ * @param[in] j Index of field sorted by.
+ * @param[in] cmp User defined compare function of fields.
+ * @param[in] z Argument to reentrant user defined compare function.
+ */
+extern void columns_sort_r(columns_t c, size_t j,
+                           int cmp(const void *x, const void *y, void *z),
+                           void *z);
+
+/**
+ * @brief Change capacity of columns object.
+ *
+ * Every column is resized to <tt>capacity</tt> records. If changed to a
+ * smaller size, the records are truncated.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>columns_resize</tt> on a <tt>NULL</tt> columns object.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object being resized.
+ * @param[in] capacity Number of possible records.
+ */
+extern void columns_resize(columns_t c, size_t capacity);
+
+/**
+ * @brief Free data allocated for the columns object.
+ *
+ * @param[in] c Pointer to <tt>columns_t</tt> object.
+ */
+extern void columns_free(columns_t *c);
+
+/**
+ * @brief Return number of records.
+ *
+ * @param[in] c Columns object.
+ *
+ * @return Number of records.
+ */
+extern size_t columns_nmem(columns_t c);
+
+/**
+ * @brief Return capacity of columns object.
+ *
+ * @param[in] c Columns object.
+ *
+ * @return Number of possible records.
+ */
+extern size_t columns_capacity(columns_t c);
+
+/**
+ * @brief Return number of fields.
+ *
+ * @param[in] c Columns object.
+ *
+ * @return Number of fields of records.
+ */
+extern size_t columns_nfields(columns_t c);
+
+/**
+ * @brief Return size of field.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Field out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] c Columns object.
+ * @param[in] j Index of field.
+ *
+ * @return Size of field <tt>j</tt>.
+ */
+extern size_t columns_size(columns_t c, size_t j);
+
+/**
+ * @brief Swaps two columns objects.
+ *
+ * @param[in] c1 First columns.
+ * @param[in] c2 Second columns.
+ */
+static inline
+void columns_swap(columns_t *restrict c1, columns_t *restrict c2)
+{
+  volatile columns_t tmp = *c1;
+  *c1 = *c2;
+  *c2 = tmp;
+}
+
+# endif
@@ -0,0 +1,252 @@
+/**
+ * @file concurrentdisjointsets.h
+ * @brief Public interface of <tt>cdisjointsets_t</tt> class
+ *
+ * The <tt>cdisjointsets_t</tt> object instantiates a partition of the elements
+ * 0 to <tt>n - 1</tt> into disjoint sets whose finds and unions may be called
+ * from several threads without locks. As in <tt>disjointsets_t</tt>, each set
+ * is a tree held in one contiguous array of <tt>uint32_t</tt> parents.
+ *
+ * A union is one compare-and-swap linking the root of larger index under the
+ * other, retried if that root gained a parent in between, so that no cycle can
+ * form. Finds halve their path with compare-and-swaps which may fail without
+ * harm. Sets are not ranked by size.
+ *
+ * <tt>cdisjointsets_union_parallel</tt> joins the sets of an array of edges on
+ * the threads of a worker pool, and <tt>cdisjointsets_labels_parallel</tt>
+ * labels the components found.
+ *
+ * The <tt>cdisjointsets_t</tt> class is implemented as an opaque pointer. The
+ * library must be configured with threads enabled (the default) for this class
+ * to be available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_CONCURRENTDISJOINTSETS_H
+# define INCLUDED_CONCURRENTDISJOINTSETS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+# include "workers.h"
+
+typedef struct cdisjointsets_t* cdisjointsets_t;
+
+/**
+ * @brief Instantiates a <tt>cdisjointsets_t</tt> instance.
+ *
+ * Memory is allocated for a partition of the elements 0 to <tt>n - 1</tt> into
+ * singletons. This memory needs to be freed by a call to
+ * <tt>cdisjointsets_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>n</tt> is larger than <tt>UINT32_MAX</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] n Number of elements.
+ *
+ * @return New partition object.
+ */
+extern cdisjointsets_t cdisjointsets_new(size_t n);
+
+/**
+ * @brief Instantiates a <tt>cdisjointsets_t</tt> instance through an
+ * allocator.
+ *
+ * As <tt>cdisjointsets_new</tt>, but the partition object and its array are
+ * allocated through <tt>al</tt>, which is copied.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>n</tt> is larger than <tt>UINT32_MAX</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] n Number of elements.
+ * @param[in] al Allocator of partition object.
+ *
+ * @return New partition object.
+ */
+extern cdisjointsets_t cdisjointsets_new_alloc(size_t n,
+                                               const allocators_t *al);
+
+/**
+ * @brief Frees memory of partition object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Other threads are using the partition object.</dd>
+ * </dl>
+ *
+ * @param[in] d Pointer to partition object being freed.
+ */
+extern void cdisjointsets_free(cdisjointsets_t *d);
+
+/**
+ * @brief Root of the set of element.
+ *
+ * The root may change as soon as it is returned if other threads are joining
+ * sets.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_find</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ *
+ * @return Root of the set of <tt>x</tt>.
+ */
+extern uint32_t cdisjointsets_find(cdisjointsets_t d, uint32_t x);
+
+/**
+ * @brief Joins the sets of two elements.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_union</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> or <tt>y</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ * @param[in] y Element.
+ *
+ * @retval int Returns 1 if two sets were joined by this call. Returns -1 if
+ * <tt>x</tt> and <tt>y</tt> were in one set.
+ */
+extern int cdisjointsets_union(cdisjointsets_t d, uint32_t x, uint32_t y);
+
+/**
+ * @brief Test whether two elements are in one set.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_same</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> or <tt>y</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ * @param[in] y Element.
+ *
+ * @retval int Returns 1 if <tt>x</tt> and <tt>y</tt> are in one set. Returns
+ * -1 if they were not at some point of the call.
+ */
+extern int cdisjointsets_same(cdisjointsets_t d, uint32_t x, uint32_t y);
+
+/**
+ * @brief Joins the sets of the ends of each of an array of edges in parallel.
+ *
+ * Edge <tt>i</tt> joins elements <tt>e[2 * i]</tt> and <tt>e[2 * i + 1]</tt>.
+ * The edges are halved recursively into ranges of at least a few thousand
+ * edges, and the ranges are handed to the threads of the worker pool
+ * <tt>w</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_union_parallel</tt> on a <tt>NULL</tt>
+ * partition object.</dd>
+ * <dd><tt>e</tt> holds fewer than <tt>2 * m</tt> elements, or one that is not
+ * an element.</dd>
+ * <dd>Calling <tt>cdisjointsets_union_parallel</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] e Edges, as pairs of elements.
+ * @param[in] m Number of edges.
+ * @param[in] w Worker pool running the unions.
+ *
+ * @return Number of edges which joined two sets.
+ */
+extern size_t cdisjointsets_union_parallel(cdisjointsets_t d,
+                                           const uint32_t *e, size_t m,
+                                           workers_t w);
+
+/**
+ * @brief Labels every element by the root of its set.
+ *
+ * Sets <tt>out[x]</tt> to the root of the set of <tt>x</tt> for every element
+ * <tt>x</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_labels</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>out</tt> holds fewer than <tt>cdisjointsets_size</tt>
+ * elements.</dd>
+ * <dd>Other threads are joining sets.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[out] out Root of the set of every element.
+ */
+extern void cdisjointsets_labels(cdisjointsets_t d, uint32_t *out);
+
+/**
+ * @brief Labels every element by the root of its set in parallel.
+ *
+ * As <tt>cdisjointsets_labels</tt>, the elements being split among the threads
+ * of the worker pool <tt>w</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_labels_parallel</tt> on a <tt>NULL</tt>
+ * partition object.</dd>
+ * <dd><tt>out</tt> holds fewer than <tt>cdisjointsets_size</tt>
+ * elements.</dd>
+ * <dd>Other threads are joining sets.</dd>
+ * <dd>Calling <tt>cdisjointsets_labels_parallel</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[out] out Root of the set of every element.
+ * @param[in] w Worker pool labeling the elements.
+ */
+extern void cdisjointsets_labels_parallel(cdisjointsets_t d, uint32_t *out,
+                                          workers_t w);
+
+/**
+ * @brief Number of sets of partition object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_count</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ *
+ * @return Number of sets.
+ */
+extern size_t cdisjointsets_count(cdisjointsets_t d);
+
+/**
+ * @brief Number of elements of partition object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cdisjointsets_size</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ *
+ * @return Number of elements.
+ */
+extern size_t cdisjointsets_size(cdisjointsets_t d);
+
+# endif
@@ -0,0 +1,360 @@
+/**
+ * @file concurrenthashtabs.h
+ * @brief Public interface of <tt>chashtabs_t</tt> class
+ *
+ * The <tt>chashtabs_t</tt> object instantiates shallow hash-table-type
+ * associations between already existing data which may be shared by several
+ * threads. As with <tt>hashtabs_t</tt>, the user is responsible for allocating
+ * and deallocating the data; <tt>chashtabs_free</tt> only deallocates the links
+ * between data.
+ *
+ * <tt>chashtabs_find</tt> takes no locks. Inserts and removes lock one of a
+ * fixed number of stripes of buckets, so writers to different stripes proceed in
+ * parallel. Links removed from the table, and bucket arrays replaced by growth,
+ * are freed only once no thread can still be reading them (epoch based
+ * reclamation).
+ *
+ * The table grows once the number of elements exceeds
+ * <tt>chashtabs_setmaxload</tt> elements per bucket. The growing thread blocks
+ * the other writers while the links are copied into a bucket array of the next
+ * prime length, and writers arriving in the meantime help with the copying in
+ * place of waiting. Finds are never blocked.
+ *
+ * The compare function is only used to test equality. Repetitions are not
+ * allowed.
+ *
+ * The <tt>chashtabs_t</tt> class is implemented as an opaque pointer. The
+ * library must be configured with threads enabled (the default) for this class
+ * to be available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_CONCURRENTHASHTABS_H
+# define INCLUDED_CONCURRENTHASHTABS_H
+
+# include <stdint.h>
+# include <stdlib.h>
+# include <stddef.h>
+
+/**
+ * @brief Default maximum average number of elements per bucket before a hash
+ * table grows.
+ */
+# define CHASHTABS_MAXLOAD 2
+
+typedef struct chashtabs_t* chashtabs_t;
+
+/**
+ * @brief User provided compare function. Must return 0 exactly when the data
+ * objects are equal.
+ */
+typedef int (*chashtabs_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must return 0 exactly when
+ * the data objects are equal.
+ */
+typedef int (*chashtabs_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief User provided hash function.
+ */
+typedef uint64_t (*chashtabs_hash)(const void*);
+
+/**
+ * @brief User provided reentrant hash function.
+ */
+typedef uint64_t (*chashtabs_hash_r)(const void*, const void*);
+
+/**
+ * @brief Instantiates a <tt>chashtabs_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>chashtabs_t</tt> instance. This memory needs
+ * to be freed by a call to <tt>chashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>chashtabs_data_cmp</tt> and <tt>chashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>chashtabs_hash</tt> and <tt>chashtabs_hash_r</tt> arguments are
+ * <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ *
+ * @return Instance of hash table object.
+ */
+extern chashtabs_t chashtabs_new(chashtabs_data_cmp cmp,
+                                 chashtabs_data_cmp_r cmp_r,
+                                 chashtabs_hash hash, chashtabs_hash_r hash_r,
+                                 size_t n);
+
+/**
+ * @brief Inserts pointer to data object into hash table object.
+ *
+ * If a data object equal to the user provided data parameter is not present in
+ * the hash table object, then a pointer is created and added to the hash table
+ * which points to the data. May be called concurrently with any function of this
+ * class other than <tt>chashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_insert</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being added to hash table object.
+ *
+ * @return 1 if the pointer was added. -1 if equal data was already present.
+ */
+extern int chashtabs_insert(chashtabs_t t, const void *x);
+
+/**
+ * @brief Inserts pointer to data object into hash table object.
+ *
+ * Reentrant version of <tt>chashtabs_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_insert_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being added to hash table object.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] cmp_arg Argument to user provided reentrant compare function.
+ *
+ * @return 1 if the pointer was added. -1 if equal data was already present.
+ */
+extern int chashtabs_insert_r(chashtabs_t t, const void *x,
+                              const void *hash_arg, void *cmp_arg);
+
+/**
+ * @brief Remove pointer to data object in hash table object (if present) equal
+ * in value to the data object parameter provided by the user.
+ *
+ * The data object is hashed and only the corresponding bucket is searched. If
+ * found, the pointer is removed from the hash table and returned to the user.
+ * If not found, <tt>NULL</tt> is returned. May be called concurrently with any
+ * function of this class other than <tt>chashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_remove</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *chashtabs_remove(chashtabs_t t, const void *x);
+
+/**
+ * @brief Remove pointer to data object in hash table object (if present) equal
+ * in value to the data object parameter provided by the user.
+ *
+ * Reentrant version of <tt>chashtabs_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_remove_r</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] cmp_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *chashtabs_remove_r(chashtabs_t t, const void *x,
+                                const void *hash_arg, void *cmp_arg);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in hash
+ * table object.
+ *
+ * Check if data equal to user provided data object is contained in hash table
+ * object. Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
+ * No lock is taken, and the search is never blocked by writers.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_find</tt> on <tt>NULL</tt> hash table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Data whose membership is being checked.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *chashtabs_find(chashtabs_t t, const void *x);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in hash
+ * table object.
+ *
+ * Reentrant version of <tt>chashtabs_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_find_r</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Data whose membership is being checked.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] cmp_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *chashtabs_find_r(chashtabs_t t, const void *x,
+                              const void *hash_arg, void *cmp_arg);
+
+/**
+ * @brief Apply function to every member of hash table object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the hash table. Early
+ * termination is possible if <tt>apply</tt> returns a negative <tt>int</tt>.
+ * Writers are blocked for the duration of the call; finds are not.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> inserts into or removes from the hash table.</dd>
+ * <dd><tt>apply</tt> alters the members in a way which changes their hash
+ * value.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int chashtabs_map(chashtabs_t t, int apply(void **x));
+
+/**
+ * @brief Apply function to every member of hash table object.
+ *
+ * Reentrant version of <tt>chashtabs_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> inserts into or removes from the hash table.</dd>
+ * <dd><tt>apply</tt> alters the members in a way which changes their hash
+ * value.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] y Argument to user provided function <tt>apply</tt>.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int chashtabs_map_r(chashtabs_t t, int apply(void **x, void *y), void *y);
+
+/**
+ * @brief Free data allocated for the shallow hash-table-type associations.
+ *
+ * The links constructed between the existing data allocated by the user are
+ * freed, along with any links of this library still awaiting reclamation. The
+ * data pointed to by the structure is not freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Another thread is using the hash table.</dd>
+ * </dl>
+ *
+ * @param[in] *t Pointer to <tt>chashtabs_t</tt> object.
+ */
+extern void chashtabs_free(chashtabs_t *t);
+
+/**
+ * @brief Number of spaces allocated for hash table buckets.
+ *
+ * Number of spaces allocated for hash table buckets.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_capacity</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of space allocated for hash table buckets.
+ */
+extern size_t chashtabs_capacity(chashtabs_t t);
+
+/**
+ * @brief Number of elements in hash table.
+ *
+ * Number of elements in hash table. With concurrent writers, the value may be
+ * out of date by the time it is returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_size</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of members of the hash table.
+ */
+extern size_t chashtabs_size(chashtabs_t t);
+
+/**
+ * @brief Set the load at which the hash table grows.
+ *
+ * When an insert leaves more than <tt>maxload</tt> elements per bucket on
+ * average, the hash table grows to the next prime length. Tables start with a
+ * maximum load of <tt>CHASHTABS_MAXLOAD</tt>. A value of 0 disables growth.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>chashtabs_setmaxload</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being configured.
+ * @param[in] maxload Average number of elements per bucket triggering growth.
+ */
+extern void chashtabs_setmaxload(chashtabs_t t, size_t maxload);
+
+/**
+ * @brief Swap opaque pointers for concurrent hash tables.
+ *
+ * Swap opaque pointers for concurrent hash tables.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Hash table objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] t1 First hash table.
+ * @param[in] t2 Second hash table.
+ */
+static inline
+void chashtabs_swap(chashtabs_t *restrict t1, chashtabs_t *restrict t2)
+{
+  volatile chashtabs_t tmp = *t1;
+  *t1 = *t2;
+  *t2 = tmp;
+}
+
+# endif
@@ -0,0 +1,255 @@
+/**
+ * @file concurrentqueues.h
+ * @brief Public interface of <tt>spscqueues_t</tt> and <tt>mpmcqueues_t</tt>
+ * classes
+ *
+ * The <tt>spscqueues_t</tt> and <tt>mpmcqueues_t</tt> objects instantiate
+ * bounded first-in-first-out queues handing elements between threads without
+ * locks. A <tt>spscqueues_t</tt> is shared by exactly one pushing thread and
+ * one popping thread; its push and pop are a copy and one release store. A
+ * <tt>mpmcqueues_t</tt> may be pushed and popped by any number of threads; a
+ * push or a pop claims its slot with a compare-and-swap. In both, the indices
+ * written by producers and by consumers sit on separate cache lines.
+ *
+ * As for <tt>sstacks_t</tt>, elements are <tt>size</tt> bytes copied into and
+ * out of the queue. To hand over pointers, take <tt>size</tt> to be
+ * <tt>sizeof(void*)</tt> and pass the address of the pointer.
+ *
+ * The capacity is fixed at creation and rounded up to a power of two. A push
+ * onto a full queue, or a pop from an empty one, fails at once rather than
+ * waiting; the caller decides whether to spin, yield or block.
+ *
+ * Both classes are implemented as opaque pointers. The library must be
+ * configured with threads enabled (the default) for these classes to be
+ * available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_CONCURRENTQUEUES_H
+# define INCLUDED_CONCURRENTQUEUES_H
+
+# include <stddef.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include "allocators.h"
+
+typedef struct spscqueues_t* spscqueues_t;
+typedef struct mpmcqueues_t* mpmcqueues_t;
+
+/**
+ * @brief Instantiates a <tt>spscqueues_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>spscqueues_t</tt> instance. This memory
+ * needs to be freed by a call to <tt>spscqueues_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Minimum number of elements the queue holds.
+ *
+ * @return Instance of queue object.
+ */
+extern spscqueues_t spscqueues_new(size_t size, size_t capacity);
+
+/**
+ * @brief Instantiates a <tt>spscqueues_t</tt> instance with a user allocator.
+ *
+ * As <tt>spscqueues_new</tt>, but the queue object and its ring buffer are
+ * allocated and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Minimum number of elements the queue holds.
+ * @param[in] al Allocator of the queue.
+ *
+ * @return Instance of queue object.
+ */
+extern spscqueues_t spscqueues_new_alloc(size_t size, size_t capacity,
+                                         const allocators_t *al);
+
+/**
+ * @brief Push a copy of data onto queue.
+ *
+ * The <tt>size</tt> bytes at <tt>x</tt> are copied to the back of the queue.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Two threads push onto the same queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Pointer to data being copied into queue object.
+ *
+ * @return 1 if pushed. -1 if the queue is full.
+ */
+extern int spscqueues_push(spscqueues_t q, const void *x);
+
+/**
+ * @brief Pop the front element of queue.
+ *
+ * The front element is removed from the queue and copied to <tt>x</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Two threads pop from the same queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being popped.
+ * @param[out] x Buffer of <tt>size</tt> bytes receiving the element.
+ *
+ * @return 1 if popped. -1 if the queue is empty.
+ */
+extern int spscqueues_pop(spscqueues_t q, void *x);
+
+/**
+ * @brief Number of elements in queue.
+ *
+ * Number of elements in queue. The count may be stale by the time it is
+ * returned if other threads are pushing or popping.
+ *
+ * @param[in] q Queue object being checked.
+ *
+ * @return Number of elements in queue.
+ */
+extern size_t spscqueues_nmem(spscqueues_t q);
+
+/**
+ * @brief Number of elements queue holds.
+ *
+ * Number of elements queue holds.
+ *
+ * @param[in] q Queue object being checked.
+ *
+ * @return Capacity of queue.
+ */
+extern size_t spscqueues_capacity(spscqueues_t q);
+
+/**
+ * @brief Free memory allocated for queue.
+ *
+ * Free memory allocated for queue.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Another thread is still using the queue.</dd>
+ * </dl>
+ *
+ * @param[in] *q Pointer to <tt>spscqueues_t</tt> object.
+ */
+extern void spscqueues_free(spscqueues_t *q);
+
+/**
+ * @brief Instantiates a <tt>mpmcqueues_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>mpmcqueues_t</tt> instance. This memory
+ * needs to be freed by a call to <tt>mpmcqueues_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Minimum number of elements the queue holds.
+ *
+ * @return Instance of queue object.
+ */
+extern mpmcqueues_t mpmcqueues_new(size_t size, size_t capacity);
+
+/**
+ * @brief Instantiates a <tt>mpmcqueues_t</tt> instance with a user allocator.
+ *
+ * As <tt>mpmcqueues_new</tt>, but the queue object and its cells are allocated
+ * and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Minimum number of elements the queue holds.
+ * @param[in] al Allocator of the queue.
+ *
+ * @return Instance of queue object.
+ */
+extern mpmcqueues_t mpmcqueues_new_alloc(size_t size, size_t capacity,
+                                         const allocators_t *al);
+
+/**
+ * @brief Push a copy of data onto queue.
+ *
+ * The <tt>size</tt> bytes at <tt>x</tt> are copied to the back of the queue.
+ * Safe to call from any number of threads.
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Pointer to data being copied into queue object.
+ *
+ * @return 1 if pushed. -1 if the queue is full.
+ */
+extern int mpmcqueues_push(mpmcqueues_t q, const void *x);
+
+/**
+ * @brief Pop the front element of queue.
+ *
+ * The front element is removed from the queue and copied to <tt>x</tt>. Safe
+ * to call from any number of threads.
+ *
+ * @param[in] q Queue object being popped.
+ * @param[out] x Buffer of <tt>size</tt> bytes receiving the element.
+ *
+ * @return 1 if popped. -1 if the queue is empty.
+ */
+extern int mpmcqueues_pop(mpmcqueues_t q, void *x);
+
+/**
+ * @brief Number of elements in queue.
+ *
+ * Number of elements in queue. The count may be stale by the time it is
+ * returned if other threads are pushing or popping.
+ *
+ * @param[in] q Queue object being checked.
+ *
+ * @return Number of elements in queue.
+ */
+extern size_t mpmcqueues_nmem(mpmcqueues_t q);
+
+/**
+ * @brief Number of elements queue holds.
+ *
+ * Number of elements queue holds.
+ *
+ * @param[in] q Queue object being checked.
+ *
+ * @return Capacity of queue.
+ */
+extern size_t mpmcqueues_capacity(mpmcqueues_t q);
+
+/**
+ * @brief Free memory allocated for queue.
+ *
+ * Free memory allocated for queue.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Another thread is still using the queue.</dd>
+ * </dl>
+ *
+ * @param[in] *q Pointer to <tt>mpmcqueues_t</tt> object.
+ */
+extern void mpmcqueues_free(mpmcqueues_t *q);
+
+# endif
@@ -0,0 +1,157 @@
+/**
+ * @file concurrentstacks.h
+ * @brief Public interface of <tt>cstacks_t</tt> class
+ *
+ * The <tt>cstacks_t</tt> object instantiates a last-in-first-out stack of
+ * pointers to already existing data which may be pushed and popped by several
+ * threads without locks (a Treiber stack). As with <tt>stacks_t</tt>, the user
+ * is responsible for allocating and deallocating the data.
+ *
+ * A push or a pop is one compare-and-swap on the top of the stack. Popped links
+ * are kept by the stack and reused by later pushes, so that, once the stack has
+ * reached its largest size, pushes make no allocation. Link storage is returned
+ * to the allocator only by <tt>cstacks_free</tt>.
+ *
+ * The <tt>cstacks_t</tt> class is implemented as an opaque pointer. The library
+ * must be configured with threads enabled (the default) for this class to be
+ * available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_CONCURRENTSTACKS_H
+# define INCLUDED_CONCURRENTSTACKS_H
+
+# include <stddef.h>
+# include <stdlib.h>
+
+# include "allocators.h"
+
+typedef struct cstacks_t* cstacks_t;
+
+/**
+ * @brief Instantiates a <tt>cstacks_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>cstacks_t</tt> instance. This memory needs
+ * to be freed by a call to <tt>cstacks_free</tt>.
+ *
+ * @return Instance of stack object.
+ */
+extern cstacks_t cstacks_new(void);
+
+/**
+ * @brief Instantiates a <tt>cstacks_t</tt> instance with a user allocator.
+ *
+ * As <tt>cstacks_new</tt>, but the stack object and its links are allocated and
+ * freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The functions of <tt>al</tt> are not safe to call from several
+ * threads.</dd>
+ * </dl>
+ *
+ * @param[in] al Allocator of the stack.
+ *
+ * @return Instance of stack object.
+ */
+extern cstacks_t cstacks_new_alloc(const allocators_t *al);
+
+/**
+ * @brief Push pointer to data object onto stack.
+ *
+ * Push pointer to data object onto stack. Safe to call from any number of
+ * threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cstacks_push</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object.
+ * @param[in] x Pointer to data object.
+ */
+extern void cstacks_push(cstacks_t s, void *x);
+
+/**
+ * @brief Pop the top of stack.
+ *
+ * Remove the top of the stack and return the pointer to data object it holds.
+ * Safe to call from any number of threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cstacks_pop</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object.
+ *
+ * @return Pointer to data object. <tt>NULL</tt> if the stack is empty.
+ */
+extern void *cstacks_pop(cstacks_t s);
+
+/**
+ * @brief Free memory allocated for stack.
+ *
+ * Only the stack is freed, not the data.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Another thread is still using the stack.</dd>
+ * </dl>
+ *
+ * @param[in] *s Pointer to <tt>cstacks_t</tt> object.
+ */
+extern void cstacks_free(cstacks_t *s);
+
+/**
+ * @brief Check if stack is empty.
+ *
+ * Check if stack is empty. The answer may be stale by the time it is returned
+ * if other threads are using the stack.
+ *
+ * @param[in] s Stack object.
+ *
+ * @return True if empty. False otherwise.
+ */
+extern int cstacks_empty(cstacks_t s);
+
+/**
+ * @brief Number of elements in stack.
+ *
+ * Number of elements in stack. The count may be stale by the time it is
+ * returned if other threads are using the stack.
+ *
+ * @param[in] s Stack object.
+ *
+ * @return Number of elements in stack.
+ */
+extern size_t cstacks_size(cstacks_t s);
+
+/**
+ * @brief Swap opaque pointers for stacks.
+ *
+ * Swap opaque pointers for stacks.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Stack objects are aliases.</dd>
+ * <dd>Another thread is using either stack.</dd>
+ * </dl>
+ *
+ * @param[in] s1 First stack.
+ * @param[in] s2 Second stack.
+ */
+static inline
+void cstacks_swap(cstacks_t *restrict s1, cstacks_t *restrict s2)
+{
+  volatile cstacks_t tmp = *s1;
+  *s1 = *s2;
+  *s2 = tmp;
+}
+
+# endif
@@ -1,18 +1,58 @@
 # ifndef INCLUDED_CONTAINERS_H
 # define INCLUDED_CONTAINERS_H
 
+# include <containers/configs.h>
+# include <containers/allocators.h>
+# include <containers/pools.h>
+# include <containers/counters.h>
+
 # include <containers/stacks.h>
 # include <containers/deepstacks.h>
 # include <containers/staticstacks.h>
+# include <containers/unrolledstacks.h>
 
 # include <containers/queues.h>
 # include <containers/deepqueues.h>
+# include <containers/deques.h>
+# include <containers/spillqueues.h>
+# include <containers/skiplists.h>
+# include <containers/btrees.h>
+# include <containers/heaps.h>
 
+# include <containers/hashes.h>
 # include <containers/hashtabs.h>
 # include <containers/deephashtabs.h>
+# include <containers/flathashtabs.h>
+# include <containers/shardedhashtabs.h>
+# include <containers/caches.h>
+# include <containers/frozenhashtabs.h>
+# include <containers/interns.h>
+# include <containers/blooms.h>
+# include <containers/hyperloglogs.h>
+# include <containers/workers.h>
+# if CONTAINERS_THREADS
+#  include <containers/concurrenthashtabs.h>
+#  include <containers/cowhashtabs.h>
+#  include <containers/concurrentqueues.h>
+#  include <containers/wsdeques.h>
+#  include <containers/concurrentstacks.h>
+#  include <containers/concurrentdisjointsets.h>
+# endif
 
 # include <containers/arrays.h>
+# include <containers/eytzingers.h>
+# include <containers/columns.h>
+# include <containers/fenwicks.h>
+# include <containers/segtrees.h>
 
 # include <containers/bit_sets.h>
+# include <containers/roarings.h>
+# include <containers/bitmatrices.h>
+# include <containers/bitvecs.h>
+# include <containers/disjointsets.h>
+
+# include <containers/pipes.h>
+
+# include <containers/generics.h>
 
 # endif
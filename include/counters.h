@@ -0,0 +1,135 @@
+/**
+ * @file counters.h
+ * @brief Public interface of the operation counters
+ *
+ * When the library is configured with <tt>--enable-counters</tt>, the
+ * containers count, for each kind of container, the allocations and frees they
+ * make through their allocator, the calls they make to user compare and hash
+ * functions, their resizes and rehashes, and the longest bucket chain or probe
+ * sequence walked by a hash table. A hook may also be set to be called on each
+ * resize and rehash, as they happen.
+ *
+ * The counts are kept for each kind of container rather than for each container
+ * object, and are incremented atomically, so the containers of any thread add to
+ * them. Allocations made by a pooled container are counted once per slab, under
+ * <tt>COUNTERS_POOLS</tt>; those allocations of the library belonging to no
+ * container are counted under <tt>COUNTERS_OTHER</tt>.
+ *
+ * Without <tt>--enable-counters</tt>, the containers do no counting at all; the
+ * functions of this header are still defined, the counts are all 0 and the hook
+ * is never called.
+ *
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_COUNTERS_H
+# define INCLUDED_COUNTERS_H
+
+# include <stddef.h>
+# include <stdio.h>
+
+/**
+ * @brief Kinds of containers counted.
+ */
+typedef enum {
+  COUNTERS_ARRAYS,
+  COUNTERS_BITMATRICES,
+  COUNTERS_BTREES,
+  COUNTERS_COLUMNS,
+  COUNTERS_CONCURRENTQUEUES,
+  COUNTERS_CONCURRENTSTACKS,
+  COUNTERS_DEEPHASHTABS,
+  COUNTERS_DEEPQUEUES,
+  COUNTERS_DEEPSTACKS,
+  COUNTERS_DEQUES,
+  COUNTERS_EYTZINGERS,
+  COUNTERS_FLATHASHTABS,
+  COUNTERS_HASHTABS,
+  COUNTERS_HEAPS,
+  COUNTERS_POOLS,
+  COUNTERS_QUEUES,
+  COUNTERS_ROARINGS,
+  COUNTERS_SKIPLISTS,
+  COUNTERS_STACKS,
+  COUNTERS_UNROLLEDSTACKS,
+  COUNTERS_WSDEQUES,
+  COUNTERS_OTHER,
+  COUNTERS_KINDS ///< number of kinds
+} counters_kind_t;
+
+/**
+ * @brief Events passed to the hook.
+ */
+typedef enum {
+  COUNTERS_RESIZE, ///< storage of an array-like container resized
+  COUNTERS_REHASH  ///< buckets or slots of a hash table replaced
+} counters_event_t;
+
+/**
+ * @brief Counts of one kind of container, filled in by <tt>counters_get</tt>.
+ */
+typedef struct {
+  size_t mallocs;   ///< allocations and reallocations
+  size_t frees;     ///< frees
+  size_t cmps;      ///< calls to compare functions
+  size_t hashes;    ///< calls to hash functions
+  size_t resizes;   ///< resizes and rehashes
+  size_t max_chain; ///< longest bucket chain or probe sequence walked
+} counters_t;
+
+/**
+ * @brief User provided hook, called with the kind of container, the event and
+ * the capacities before and after it.
+ */
+typedef void (*counters_hook)(counters_kind_t kind, counters_event_t e,
+                              size_t from, size_t to, void *arg);
+
+/**
+ * @brief Check whether the operation counters are compiled in.
+ *
+ * @retval int Returns 1 if the library is configured with
+ * <tt>--enable-counters</tt>. Returns -1 otherwise.
+ */
+extern int counters_enabled(void);
+
+/**
+ * @brief Counts of a kind of container.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>kind</tt> is not less than <tt>COUNTERS_KINDS</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] kind Kind of container.
+ * @param[out] c Counts of <tt>kind</tt>.
+ */
+extern void counters_get(counters_kind_t kind, counters_t *c);
+
+/**
+ * @brief Sets every count of every kind of container to 0.
+ */
+extern void counters_reset(void);
+
+/**
+ * @brief Prints counts.
+ *
+ * Writes a line for each kind of container with a nonzero count to
+ * <tt>f</tt>, below a line naming the columns.
+ *
+ * @param[in] f Stream written to.
+ */
+extern void counters_report(FILE *f);
+
+/**
+ * @brief Sets the hook called on resizes and rehashes.
+ *
+ * The hook is called by the thread resizing the container, after the resize,
+ * and replaces any hook set before. A <tt>NULL</tt> hook removes it.
+ *
+ * @param[in] hook Hook, or <tt>NULL</tt>.
+ * @param[in] arg Argument passed to <tt>hook</tt>.
+ */
+extern void counters_sethook(counters_hook hook, void *arg);
+
+# endif
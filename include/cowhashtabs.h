@@ -0,0 +1,430 @@
+/**
+ * @file cowhashtabs.h
+ * @brief Public interface of <tt>cowhashtabs_t</tt> class
+ *
+ * The <tt>cowhashtabs_t</tt> object instantiates a shallow hash table of
+ * already existing data, changed by one writer thread, whose versions may be
+ * published as read-only snapshots to any number of reader threads. As with
+ * <tt>hashtabs_t</tt>, the user is responsible for allocating and deallocating
+ * the data.
+ *
+ * The bucket array is cut into chunks of buckets, each counting the versions
+ * sharing it. Publishing the writer's version costs constant time: the version
+ * is shared, not copied. The next change by the writer copies only the array
+ * of chunk pointers, and each change copies the chunk it modifies if that
+ * chunk is still shared, so that a snapshot costs memory only for the chunks
+ * changed since it was published. A snapshot is freed once it is released by
+ * its readers and replaced by a newer publication, the latter after an epoch
+ * has passed.
+ *
+ * Readers acquire the last published snapshot with
+ * <tt>cowhashtabs_acquire</tt>, search it without locks, and release it with
+ * <tt>cowhashtabs_release</tt>. A snapshot never changes.
+ *
+ * Repetitions are not allowed, and data must be linearly ordered.
+ *
+ * The <tt>cowhashtabs_t</tt> class is implemented as an opaque pointer. The
+ * library must be configured with threads enabled (the default) for this class
+ * to be available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_COWHASHTABS_H
+# define INCLUDED_COWHASHTABS_H
+
+# include <stdint.h>
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Default maximum average number of elements per bucket before the
+ * writer's version grows.
+ */
+# define COWHASHTABS_MAXLOAD 2
+
+typedef struct cowhashtabs_t* cowhashtabs_t;
+
+/**
+ * @brief Read-only snapshot of a <tt>cowhashtabs_t</tt>.
+ */
+typedef struct cowhashtabs_snap_t* cowhashtabs_snap_t;
+
+/**
+ * @brief User provided compare function. Must return -1, 0, or 1.
+ */
+typedef int (*cowhashtabs_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must return -1, 0, or 1.
+ */
+typedef int (*cowhashtabs_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief User provided hashing function.
+ */
+typedef uint64_t (*cowhashtabs_hash)(const void*);
+
+/**
+ * @brief User provided reentrant hashing function.
+ */
+typedef uint64_t (*cowhashtabs_hash_r)(const void*, const void*);
+
+/**
+ * @brief Instantiates a <tt>cowhashtabs_t</tt> instance.
+ *
+ * Memory is allocated for a new, empty hash table with nothing published. This
+ * memory needs to be freed by a call to <tt>cowhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>cowhashtabs_data_cmp</tt> and <tt>cowhashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>cowhashtabs_hash</tt> and <tt>cowhashtabs_hash_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ *
+ * @return Instance of hash table object.
+ */
+extern cowhashtabs_t cowhashtabs_new(cowhashtabs_data_cmp cmp,
+                                     cowhashtabs_data_cmp_r cmp_r,
+                                     cowhashtabs_hash hash,
+                                     cowhashtabs_hash_r hash_r, size_t n);
+
+/**
+ * @brief Instantiates a <tt>cowhashtabs_t</tt> instance with a user allocator.
+ *
+ * As <tt>cowhashtabs_new</tt>, but the hash table object, its versions, chunks
+ * and links are allocated and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>cowhashtabs_data_cmp</tt> and <tt>cowhashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>cowhashtabs_hash</tt> and <tt>cowhashtabs_hash_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>The functions of <tt>al</tt> are not safe to call from several
+ * threads.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] al Allocator of the hash table.
+ *
+ * @return Instance of hash table object.
+ */
+extern cowhashtabs_t cowhashtabs_new_alloc(cowhashtabs_data_cmp cmp,
+                                           cowhashtabs_data_cmp_r cmp_r,
+                                           cowhashtabs_hash hash,
+                                           cowhashtabs_hash_r hash_r,
+                                           size_t n, const allocators_t *al);
+
+/**
+ * @brief Inserts pointer to data object into the writer's version of hash table
+ * object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_insert</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_insert</tt> from any thread but the
+ * writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being added to hash table object.
+ */
+extern void cowhashtabs_insert(cowhashtabs_t t, const void *x);
+
+/**
+ * @brief Inserts pointer to data object into the writer's version of hash table
+ * object.
+ *
+ * Reentrant version of <tt>cowhashtabs_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_insert_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_insert_r</tt> from any thread but the
+ * writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being added to hash table object.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ */
+extern void cowhashtabs_insert_r(cowhashtabs_t t, const void *x,
+                                 const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Removes pointer to data object from the writer's version of hash
+ * table object.
+ *
+ * Published snapshots keep the data.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_remove</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_remove</tt> from any thread but the
+ * writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being removed from.
+ * @param[in] x Pointer to data equal to the data being removed.
+ *
+ * @return Pointer to the removed data, or <tt>NULL</tt> if not present.
+ */
+extern void *cowhashtabs_remove(cowhashtabs_t t, const void *x);
+
+/**
+ * @brief Removes pointer to data object from the writer's version of hash
+ * table object.
+ *
+ * Reentrant version of <tt>cowhashtabs_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_remove_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_remove_r</tt> from any thread but the
+ * writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being removed from.
+ * @param[in] x Pointer to data equal to the data being removed.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the removed data, or <tt>NULL</tt> if not present.
+ */
+extern void *cowhashtabs_remove_r(cowhashtabs_t t, const void *x,
+                                  const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Finds data object in the writer's version of hash table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_find</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_find</tt> from any thread but the writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *cowhashtabs_find(cowhashtabs_t t, const void *x);
+
+/**
+ * @brief Finds data object in the writer's version of hash table object.
+ *
+ * Reentrant version of <tt>cowhashtabs_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_find_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_find_r</tt> from any thread but the
+ * writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *cowhashtabs_find_r(cowhashtabs_t t, const void *x,
+                                const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Number of elements of the writer's version of hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_size</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of members of the writer's version.
+ */
+extern size_t cowhashtabs_size(cowhashtabs_t t);
+
+/**
+ * @brief Publishes the writer's version of hash table object.
+ *
+ * The writer's version becomes the snapshot handed out by
+ * <tt>cowhashtabs_acquire</tt>, in constant time. The snapshot published
+ * before is freed once an epoch has passed and its readers have released it.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_publish</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>cowhashtabs_publish</tt> from any thread but the
+ * writer.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being published.
+ */
+extern void cowhashtabs_publish(cowhashtabs_t t);
+
+/**
+ * @brief Acquires the last published snapshot of hash table object.
+ *
+ * May be called from any thread. The snapshot must be released by a call to
+ * <tt>cowhashtabs_release</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_acquire</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object.
+ *
+ * @return Snapshot, or <tt>NULL</tt> if nothing was published.
+ */
+extern cowhashtabs_snap_t cowhashtabs_acquire(cowhashtabs_t t);
+
+/**
+ * @brief Releases snapshot.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The hash table of the snapshot has been freed.</dd>
+ * </dl>
+ *
+ * @param[in] *s Pointer to snapshot, set to <tt>NULL</tt>.
+ */
+extern void cowhashtabs_release(cowhashtabs_snap_t *s);
+
+/**
+ * @brief Finds data object in snapshot.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_snap_find</tt> on a <tt>NULL</tt>
+ * snapshot.</dd>
+ * </dl>
+ *
+ * @param[in] s Snapshot being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *cowhashtabs_snap_find(cowhashtabs_snap_t s, const void *x);
+
+/**
+ * @brief Finds data object in snapshot.
+ *
+ * Reentrant version of <tt>cowhashtabs_snap_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_snap_find_r</tt> on a <tt>NULL</tt>
+ * snapshot.</dd>
+ * </dl>
+ *
+ * @param[in] s Snapshot being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *cowhashtabs_snap_find_r(cowhashtabs_snap_t s, const void *x,
+                                     const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Apply function to every member of snapshot.
+ *
+ * Early termination is possible if <tt>apply</tt> returns a negative
+ * <tt>int</tt>. The data pointed to may be changed, not the pointers.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_snap_map</tt> on a <tt>NULL</tt> snapshot.</dd>
+ * </dl>
+ *
+ * @param[in] s Snapshot being acted upon.
+ * @param[in] apply Function being applied to members of the snapshot.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int cowhashtabs_snap_map(cowhashtabs_snap_t s, int apply(void *x));
+
+/**
+ * @brief Apply function to every member of snapshot.
+ *
+ * Reentrant version of <tt>cowhashtabs_snap_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_snap_map_r</tt> on a <tt>NULL</tt>
+ * snapshot.</dd>
+ * </dl>
+ *
+ * @param[in] s Snapshot being acted upon.
+ * @param[in] apply Function being applied to members of the snapshot.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int cowhashtabs_snap_map_r(cowhashtabs_snap_t s,
+                                  int apply(void *x, void *y), void *y);
+
+/**
+ * @brief Number of elements of snapshot.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>cowhashtabs_snap_size</tt> on a <tt>NULL</tt>
+ * snapshot.</dd>
+ * </dl>
+ *
+ * @param[in] s Snapshot being checked.
+ *
+ * @return Number of members of the snapshot.
+ */
+extern size_t cowhashtabs_snap_size(cowhashtabs_snap_t s);
+
+/**
+ * @brief Free data allocated for the hash table.
+ *
+ * Waits for the retired snapshots to be freed. The data pointed to by the hash
+ * table is not freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Snapshots of the hash table have not been released.</dd>
+ * </dl>
+ *
+ * @param[in] *t Pointer to hash table object.
+ */
+extern void cowhashtabs_free(cowhashtabs_t *t);
+
+# endif
@@ -8,11 +8,25 @@
  * instance. The function <tt>dhashtabs_insert</tt> copies the data passed to it by
  * the user.
  *
- * The <tt>dqueues_t</tt> data structure of this same library is used for the
- * hash tables' buckets.
+ * A bucket holds the copies of up to two elements inline, and only once it
+ * overflows are they linked into a <tt>dqueues_t</tt> of this same library.
+ *
+ * Each copy is a record shared by every deep container of this library. The
+ * pointers handed back by <tt>dhashtabs_remove</tt> and <tt>dhashtabs_del</tt>
+ * are records, which <tt>dhashtabs_insert_adopt</tt>,
+ * <tt>dqueues_enqueu_adopt</tt> and <tt>dstacks_push_adopt</tt> take over
+ * without copying, for containers of the same data size and allocator.
  *
  * Repetitions are not allowed, and data must be linearly ordered.
  *
+ * A hash table made by <tt>dhashtabs_new_map</tt> is in map mode: each element
+ * is a record of a fixed size key followed by a fixed size value, stored inline
+ * in one allocation. Keys are compared bytewise by the table itself, so no user
+ * compare function is needed, and values found with <tt>dhashtabs_get</tt> may
+ * be updated in place. Map mode tables are accessed with <tt>dhashtabs_put</tt>,
+ * <tt>dhashtabs_get</tt> and <tt>dhashtabs_del</tt>; all functions not handling
+ * single elements work in both modes.
+ *
  * The <tt>dhashtabs_t</tt> class is implemented as an opaque pointer.
  *
  * @warning This class is meant to be used in time restricted settings. As such,
@@ -25,12 +39,41 @@
 # ifndef INCLUDED_DEEPHASHTABS_H
 # define INCLUDED_DEEPHASHTABS_H
 
+# include <stdio.h>
 # include <stdint.h>
 # include <stdlib.h>
 # include <stddef.h>
 
+# include "allocators.h"
+# include "configs.h"
+# include "deepqueues.h"
+# include "frozenhashtabs.h"
+# include "workers.h"
+
 typedef struct dhashtabs_t* dhashtabs_t;
 
+/**
+ * @brief Number of entries of the bucket occupancy histogram of
+ * <tt>dhashtabs_stats_t</tt>.
+ */
+# define DHASHTABS_HISTOGRAM 8
+
+/**
+ * @brief Statistics of a hash table, filled in by <tt>dhashtabs_stats</tt>.
+ */
+typedef struct {
+  size_t buckets;                        ///< number of buckets
+  size_t empty;                          ///< number of empty buckets
+  size_t max_chain;                      ///< length of the longest bucket
+  double mean_chain;                     ///< mean length of nonempty buckets
+  size_t histogram[DHASHTABS_HISTOGRAM]; ///< buckets by number of elements
+  size_t bytes;                          ///< bytes allocated by the hash table
+  size_t inserts;                        ///< number of inserts
+  size_t insert_cmps;                    ///< compare calls made by inserts
+  size_t finds;                          ///< number of finds and removes
+  size_t find_cmps;                      ///< compare calls made by finds
+} dhashtabs_stats_t;
+
 /**
  * @brief User provided compare function. Must provide a linear ordering of the
  * data.
@@ -58,7 +101,9 @@ typedef uint64_t (*dhashtabs_hash_r)(const void*, const void*);
  * integer type.
  *
  * Standard hash function for dynamic arrays of <tt>uint32_t</tt> unsigned
- * integer type. Implements a version from the Boost library.
+ * integer type. Implements a version from the Boost library. The length and the
+ * seed are both read from <tt>_n</tt>; see <tt>hashes_bytes_r</tt> of
+ * <tt>hashes.h</tt> for a faster hash with a separate seed.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -99,6 +144,38 @@ extern dhashtabs_t dhashtabs_new(dhashtabs_data_cmp cmp,
                                  dhashtabs_hash hash,
                                  dhashtabs_hash_r hash_r, size_t n, size_t size);
 
+/**
+ * @brief Instantiates a <tt>dhashtabs_t</tt> instance with a user allocator.
+ *
+ * As <tt>dhashtabs_new</tt>, but the hash table object, its buckets and its
+ * copies of the data are allocated and freed through <tt>al</tt>. Data objects
+ * returned to the user by <tt>dhashtabs_remove</tt> are to be freed through
+ * <tt>al</tt> as well.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>dhashtabs_data_cmp</tt> and <tt>dhashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>dhashtabs_hash</tt> and <tt>dhashtabs_hash_r_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] size Total size of data objects.
+ * @param[in] al Allocator of the hash table.
+ *
+ * @return Instance of hash table object.
+ */
+extern dhashtabs_t dhashtabs_new_alloc(dhashtabs_data_cmp cmp,
+                                       dhashtabs_data_cmp_r cmp_r,
+                                       dhashtabs_hash hash,
+                                       dhashtabs_hash_r hash_r, size_t n,
+                                       size_t size, const allocators_t *al);
+
 /**
  * @brief Inserts copy of data object into hash table object.
  *
@@ -139,13 +216,107 @@ extern void dhashtabs_insert(dhashtabs_t t, const void *x);
 extern void dhashtabs_insert_r(dhashtabs_t t, const void *x,
                                const void *hash_arg, void *queue_arg);
 
+/**
+ * @brief Inserts record into hash table object, taking ownership of it.
+ *
+ * As <tt>dhashtabs_insert</tt>, but <tt>x</tt> is not copied: it is a record
+ * handed back by a deep container of the same data size and allocator, such as
+ * a pointer returned by <tt>dhashtabs_remove</tt>, <tt>dqueues_dequeue_front</tt>
+ * or <tt>dstacks_pop</tt>, and becomes the copy held by the table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_insert_adopt</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd><tt>x</tt> is not such a record.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Record being added to hash table object.
+ *
+ * @retval int Returns 1 if <tt>x</tt> is adopted. Returns -1 if equal data is
+ * already in the hash table, <tt>x</tt> remaining the user's.
+ */
+extern int dhashtabs_insert_adopt(dhashtabs_t t, void *x);
+
+/**
+ * @brief Inserts record into hash table object, taking ownership of it.
+ *
+ * Reentrant version of <tt>dhashtabs_insert_adopt</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_insert_adopt_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd><tt>x</tt> is not such a record.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Record being added to hash table object.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @retval int Returns 1 if <tt>x</tt> is adopted. Returns -1 if equal data is
+ * already in the hash table, <tt>x</tt> remaining the user's.
+ */
+extern int dhashtabs_insert_adopt_r(dhashtabs_t t, void *x,
+                                    const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Finds data object in hash table object, inserting it if absent.
+ *
+ * A single probe of the hash table either finds data equal to <tt>x</tt> or
+ * inserts a copy of <tt>x</tt>, so that a find followed by an insert costs one
+ * traversal.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_find_or_insert</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched and added to.
+ * @param[in] x Pointer to data being searched for and added.
+ * @param[out] inserted Set to 1 if <tt>x</tt> was inserted and 0 if it was
+ * found, unless <tt>NULL</tt>.
+ *
+ * @return Pointer to the copy held by the hash table, found or made.
+ */
+extern void *dhashtabs_find_or_insert(dhashtabs_t t, const void *x,
+                                      int *inserted);
+
+/**
+ * @brief Finds data object in hash table object, inserting it if absent.
+ *
+ * Reentrant version of <tt>dhashtabs_find_or_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_find_or_insert_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched and added to.
+ * @param[in] x Pointer to data being searched for and added.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ * @param[out] inserted Set to 1 if <tt>x</tt> was inserted and 0 if it was
+ * found, unless <tt>NULL</tt>.
+ *
+ * @return Pointer to the copy held by the hash table, found or made.
+ */
+extern void *dhashtabs_find_or_insert_r(dhashtabs_t t, const void *x,
+                                        const void *hash_arg, void *queue_arg,
+                                        int *inserted);
+
 /**
  * @brief Remove data object in hash table object (if present) equal in value to
  * the data object parameter provided by the user.
  *
- * The hash table object is searched for data equal in value to the user provided
- * data object. If found, the data object is removed from the hash table and a
- * pointer returned to the user. If not found, <tt>NULL</tt> is returned.
+ * The data object is hashed and only the corresponding bucket of the hash table
+ * object is searched for data equal in value to the user provided data object. If
+ * found, the data object is removed from the hash table and a pointer returned to
+ * the user. If not found, <tt>NULL</tt> is returned.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -172,18 +343,21 @@ extern void *dhashtabs_remove(dhashtabs_t t, const void *x);
  *
  * @param[in] t Hash table object being altered.
  * @param[in] x Pointer to data object being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
  * @param[in] queue_arg Argument to user provided reentrant compare function.
  *
  * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
  */
-extern void *dhashtabs_remove_r(dhashtabs_t t, const void *x, void *queue_arg);
+extern void *dhashtabs_remove_r(dhashtabs_t t, const void *x,
+                                const void *hash_arg, void *queue_arg);
 
 /**
  * @brief Check if data equal to user provided data object is contained in hash
  * table object.
  *
  * Check if data equal to user provided data object is contained in hash table
- * object. Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
+ * object. The data object is hashed and only the corresponding bucket is
+ * searched. Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -214,11 +388,56 @@ extern void *dhashtabs_find(dhashtabs_t t, const void *x);
  *
  * @param[in] t Hash table object being searched.
  * @param[in] x Data whose membership is being checked.
- * @param[in] y Argument to user provided reentrant compare function.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
  *
  * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
  */
-extern void *dhashtabs_find_r(dhashtabs_t t, const void *x, void *y);
+extern void *dhashtabs_find_r(dhashtabs_t t, const void *x,
+                              const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Remove every data object of hash table object passing a predicate.
+ *
+ * The buckets are walked once, and every data object <tt>pred</tt> returns a
+ * positive <tt>int</tt> for is removed and freed, a pointer to it first being
+ * handed to <tt>dispose</tt> unless it is <tt>NULL</tt>, to release what the
+ * data object owns. Nothing is hashed or compared, so removing any number of
+ * elements costs one pass over the table. In map mode the predicate is handed
+ * whole records, key then value.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>pred</tt> or <tt>dispose</tt> alter the hash table object.</dd>
+ * <dd><tt>dispose</tt> keeps the pointer it is handed.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t dhashtabs_remove_if(dhashtabs_t t, int pred(const void *x),
+                                  void dispose(void *x));
+
+/**
+ * @brief Remove every data object of hash table object passing a predicate.
+ *
+ * Reentrant version of <tt>dhashtabs_remove_if</tt>.
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ * @param[in] y Argument to <tt>pred</tt> and <tt>dispose</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t dhashtabs_remove_if_r(dhashtabs_t t,
+                                    int pred(const void *x, void *y),
+                                    void dispose(void *x, void *y), void *y);
 
 /**
  * @brief Apply function to every member of hash table object.
@@ -259,6 +478,338 @@ extern int dhashtabs_map(dhashtabs_t t, int apply(void **x));
 extern int dhashtabs_map_r(dhashtabs_t t,
                            int apply(void **x, void *queue_arg), void *queue_arg);
 
+# if CONTAINERS_THREADS
+/**
+ * @brief Apply function to every member of deep hash table object in parallel.
+ *
+ * The buckets of the table are split into ranges, which are visited by the
+ * threads of the worker pool <tt>w</tt> with cursors of
+ * <tt>dhashtabs_iterrange</tt>, so that members are visited in no particular
+ * order and <tt>apply</tt> runs concurrently on distinct members. If an
+ * application returns negative, the pool is stopped as by
+ * <tt>arrays_map_parallel</tt>, and <tt>w</tt> must be freed and not reused.
+ * Available only if the library is configured with threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_map_parallel</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>dhashtabs_map_parallel</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] w Worker pool running the applications.
+ *
+ * @return 1 upon success, -1 if some application returned negative.
+ */
+extern int dhashtabs_map_parallel(dhashtabs_t t, int apply(void **x),
+                                  workers_t w);
+
+/**
+ * @brief Apply function to every member of deep hash table object in parallel.
+ *
+ * Reentrant version of <tt>dhashtabs_map_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_map_parallel_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>dhashtabs_map_parallel_r</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] y Argument to reentrant user defined function.
+ * @param[in] w Worker pool running the applications.
+ *
+ * @return 1 upon success, -1 if some application returned negative.
+ */
+extern int dhashtabs_map_parallel_r(dhashtabs_t t,
+                                    int apply(void **x, void *y), void *y,
+                                    workers_t w);
+
+/**
+ * @brief Reduce deep hash table in parallel.
+ *
+ * The buckets of the table are split between the threads of the worker pool
+ * <tt>w</tt> as by <tt>dhashtabs_map_parallel</tt>, each thread folding the
+ * members of its buckets into an accumulator of its own, merged into
+ * <tt>*acc</tt> at the end, as by <tt>arrays_reduce_parallel</tt>. Available
+ * only if the library is configured with threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_reduce_parallel</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined functions are <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>dhashtabs_reduce_parallel</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being reduced.
+ * @param[in] fold User defined function folding member <tt>x</tt> into
+ * accumulator <tt>acc</tt>.
+ * @param[in] merge User defined function merging accumulator <tt>part</tt>
+ * into accumulator <tt>acc</tt>.
+ * @param[in,out] acc Accumulator, holding the identity of <tt>merge</tt>.
+ * @param[in] size Size of accumulator.
+ * @param[in] w Worker pool running the folds.
+ *
+ * @return 1 upon success, -1 if some fold returned negative.
+ */
+extern int dhashtabs_reduce_parallel(dhashtabs_t t,
+                                     int fold(void *acc, const void *x),
+                                     void merge(void *acc, const void *part),
+                                     void *acc, size_t size, workers_t w);
+
+/**
+ * @brief Reduce deep hash table in parallel.
+ *
+ * Reentrant version of <tt>dhashtabs_reduce_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_reduce_parallel_r</tt> on a <tt>NULL</tt> hash
+ * table object.</dd>
+ * <dd>User defined functions are <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>dhashtabs_reduce_parallel_r</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being reduced.
+ * @param[in] fold User defined function folding member <tt>x</tt> into
+ * accumulator <tt>acc</tt>.
+ * @param[in] merge User defined function merging accumulator <tt>part</tt>
+ * into accumulator <tt>acc</tt>.
+ * @param[in,out] acc Accumulator, holding the identity of <tt>merge</tt>.
+ * @param[in] size Size of accumulator.
+ * @param[in] y Argument to reentrant user defined functions.
+ * @param[in] w Worker pool running the folds.
+ *
+ * @return 1 upon success, -1 if some fold returned negative.
+ */
+extern int dhashtabs_reduce_parallel_r(dhashtabs_t t,
+                                       int fold(void *acc, const void *x,
+                                                void *y),
+                                       void merge(void *acc, const void *part,
+                                                  void *y),
+                                       void *acc, size_t size, void *y,
+                                       workers_t w);
+# endif
+
+/**
+ * @brief Cursor over the elements of a deep hash table, in bucket order.
+ *
+ * A cursor is started by <tt>dhashtabs_iterinit</tt> and advanced by
+ * <tt>dhashtabs_iternext</tt>; unlike <tt>dhashtabs_map</tt>, the loop body is the
+ * user's own code, and two tables may be walked together without copying
+ * either out. A cursor stays valid while the table is not changed, and across
+ * finds; inserts and removes invalidate it.
+ */
+typedef struct {
+  dqueues_iter_t q; ///< cursor within bucket of element at cursor
+  dhashtabs_t t;    ///< hash table visited
+  size_t bucket;    ///< bucket of element at cursor
+  size_t slot;      ///< slot of element within an inline bucket
+  size_t end;       ///< one past the last bucket visited
+} dhashtabs_iter_t;
+
+/**
+ * @brief Starts cursor at first element of deep hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_iterinit</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being visited.
+ * @param[out] it Cursor being started.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the hash
+ * table is empty.
+ */
+extern int dhashtabs_iterinit(dhashtabs_t t, dhashtabs_iter_t *it);
+
+/**
+ * @brief Starts cursor at first element of a range of buckets of deep hash
+ * table.
+ *
+ * The cursor visits the elements of buckets <tt>lo</tt> to <tt>hi - 1</tt>
+ * only, so that the buckets of a table, from 0 to <tt>dhashtabs_capacity</tt>,
+ * may be split between threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_iterrange</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd><tt>hi</tt> is greater than <tt>dhashtabs_capacity(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being visited.
+ * @param[out] it Cursor being started.
+ * @param[in] lo First bucket visited.
+ * @param[in] hi One past the last bucket visited.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the
+ * buckets are empty.
+ */
+extern int dhashtabs_iterrange(dhashtabs_t t, dhashtabs_iter_t *it, size_t lo,
+                               size_t hi);
+
+/**
+ * @brief Advances cursor to the next element of deep hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the last element of the hash table.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor being advanced.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 once every
+ * element has been visited.
+ */
+extern int dhashtabs_iternext(dhashtabs_iter_t *it);
+
+/**
+ * @brief Element at cursor.
+ *
+ * The element is the copy held by the table, and is not to be freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the last element of the hash table.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor of hash table.
+ *
+ * @return Pointer to the data object at the cursor.
+ */
+static inline
+void *dhashtabs_iterget(const dhashtabs_iter_t *it)
+{
+  return dqueues_iterget(&it->q);
+}
+
+/**
+ * @brief Write hash table object to a stream.
+ *
+ * Writes a header followed by the data objects, bucket by bucket, straight from
+ * the table, so that a table too large for a second copy in memory can be
+ * written. Only the data objects are written, not the buckets. Integers are
+ * written in native byte order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_write</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Data objects hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being written.
+ * @param[in] f Stream being written to.
+ *
+ * @return 1 upon success, -1 if the stream could not be written.
+ */
+extern int dhashtabs_write(dhashtabs_t t, FILE *f);
+
+/**
+ * @brief Read hash table object from a stream.
+ *
+ * The data objects written by <tt>dhashtabs_write</tt> are inserted one by one
+ * into <tt>t</tt>, or put into it if in map mode. The table is to be
+ * instantiated with the size, map mode and functions of the table written, and
+ * with a hint of its number of elements so that no rehash is needed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_read</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] f Stream being read from.
+ *
+ * @return 1 upon success. -1 if the stream could not be read, leaving the data
+ * objects read so far in the table, with <tt>errno</tt> set to <tt>EINVAL</tt>
+ * if the header is not that of a table of data objects of the size and map mode
+ * of <tt>t</tt>.
+ */
+extern int dhashtabs_read(dhashtabs_t t, FILE *f);
+
+/**
+ * @brief Read hash table object from a stream.
+ *
+ * Reentrant version of <tt>dhashtabs_read</tt>. Map mode tables are put into
+ * as by <tt>dhashtabs_read</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_read_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] f Stream being read from.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return 1 upon success. -1 if the stream could not be read, leaving the data
+ * objects read so far in the table, with <tt>errno</tt> set to <tt>EINVAL</tt>
+ * if the header is not that of a table of data objects of the size and map mode
+ * of <tt>t</tt>.
+ */
+extern int dhashtabs_read_r(dhashtabs_t t, FILE *f,
+                            const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Freeze hash table into an immutable table.
+ *
+ * The data objects of the hash table are hashed and copied into a new
+ * <tt>fhashtabs_t</tt> of the functions and allocator of <tt>t</tt>. A map
+ * mode table is frozen into a map mode table, searched with
+ * <tt>fhashtabs_get</tt>. The hash table is left as is, and the frozen table
+ * needs to be freed by a call to <tt>fhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_freeze</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Calling <tt>dhashtabs_freeze</tt> on a table, not in map mode, with no
+ * <tt>dhashtabs_hash</tt> function.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being frozen.
+ *
+ * @return Instance of frozen table object. <tt>NULL</tt>, with <tt>errno</tt>
+ * set to <tt>EINVAL</tt>, if data objects have equal hash values.
+ */
+extern fhashtabs_t dhashtabs_freeze(dhashtabs_t t);
+
+/**
+ * @brief Freeze hash table into an immutable table.
+ *
+ * Reentrant version of <tt>dhashtabs_freeze</tt>. Map mode tables are frozen
+ * as by <tt>dhashtabs_freeze</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_freeze_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being frozen.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ *
+ * @return Instance of frozen table object. <tt>NULL</tt>, with <tt>errno</tt>
+ * set to <tt>EINVAL</tt>, if data objects have equal hash values.
+ */
+extern fhashtabs_t dhashtabs_freeze_r(dhashtabs_t t, const void *hash_arg);
+
 /**
  * @brief Free data allocated for the deep hash-table-type associations.
  *
@@ -360,6 +911,142 @@ extern size_t dhashtabs_size(dhashtabs_t t);
  */
 extern size_t dhashtabs_loadfactor(dhashtabs_t t);
 
+/**
+ * @brief Statistics of hash table.
+ *
+ * Fill in <tt>s</tt> with the occupancy of the buckets of the hash table:
+ * <tt>histogram[i]</tt> is the number of buckets holding <tt>i</tt> elements,
+ * its last entry counting every bucket holding more. A long longest bucket next
+ * to a small mean suggests a poor hash function, while a large mean with few
+ * empty buckets suggests an undersized table.
+ *
+ * The operation counters are only maintained if the library is configured with
+ * <tt>--enable-counters</tt>, and are 0 otherwise. Compare calls are made inside
+ * the <tt>dqueues_t</tt> buckets and are not counted.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_stats</tt> on a <tt>NULL</tt> hash table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ * @param[out] s Statistics of <tt>t</tt>.
+ */
+extern void dhashtabs_stats(dhashtabs_t t, dhashtabs_stats_t *s);
+
+/**
+ * @brief Instantiates a <tt>dhashtabs_t</tt> instance in map mode.
+ *
+ * Memory is allocated for a new <tt>dhashtabs_t</tt> instance whose elements are
+ * records of <tt>ksize</tt> key bytes followed by <tt>vsize</tt> value bytes.
+ * Keys are equal if their bytes are equal. This memory needs to be freed by a
+ * call to <tt>dhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>ksize</tt> is 0.</dd>
+ * <dd><tt>hash</tt> reads more than the <tt>ksize</tt> key bytes.</dd>
+ * <dd>Calling <tt>dhashtabs_insert</tt>, <tt>dhashtabs_find</tt>,
+ * <tt>dhashtabs_remove</tt> or their reentrant versions on the instance.</dd>
+ * </dl>
+ *
+ * @param[in] hash User provided hashing function of keys, or <tt>NULL</tt> for
+ * <tt>hashes_bytes</tt> with seed 0.
+ * @param[in] n Anticipated number of keys.
+ * @param[in] ksize Size of keys.
+ * @param[in] vsize Size of values.
+ *
+ * @return Instance of hash table object.
+ */
+extern dhashtabs_t dhashtabs_new_map(dhashtabs_hash hash, size_t n,
+                                     size_t ksize, size_t vsize);
+
+/**
+ * @brief Instantiates a <tt>dhashtabs_t</tt> instance in map mode with a user
+ * allocator.
+ *
+ * As <tt>dhashtabs_new_map</tt>, but the hash table object, its buckets and its
+ * records are allocated and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>ksize</tt> is 0.</dd>
+ * <dd><tt>hash</tt> reads more than the <tt>ksize</tt> key bytes.</dd>
+ * <dd>Calling <tt>dhashtabs_insert</tt>, <tt>dhashtabs_find</tt>,
+ * <tt>dhashtabs_remove</tt> or their reentrant versions on the instance.</dd>
+ * </dl>
+ *
+ * @param[in] hash User provided hashing function of keys, or <tt>NULL</tt> for
+ * <tt>hashes_bytes</tt> with seed 0.
+ * @param[in] n Anticipated number of keys.
+ * @param[in] ksize Size of keys.
+ * @param[in] vsize Size of values.
+ * @param[in] al Allocator of the hash table.
+ *
+ * @return Instance of hash table object.
+ */
+extern dhashtabs_t dhashtabs_new_map_alloc(dhashtabs_hash hash, size_t n,
+                                           size_t ksize, size_t vsize,
+                                           const allocators_t *al);
+
+/**
+ * @brief Associate value to key in map mode hash table object.
+ *
+ * If the key is present in the hash table object, its value is overwritten in
+ * place. Otherwise a record is allocated and the key and value are copied into
+ * it.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_put</tt> on a hash table object not in map mode.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] k Pointer to key.
+ * @param[in] v Pointer to value.
+ */
+extern void dhashtabs_put(dhashtabs_t t, const void *k, const void *v);
+
+/**
+ * @brief Value of key in map mode hash table object.
+ *
+ * Value of key in map mode hash table object. Only the key bytes are compared.
+ * The value may be updated through the returned pointer, which stays valid until
+ * the key is removed or the hash table is freed. The value sits <tt>ksize</tt>
+ * bytes into its record, and so is only suitably aligned for its type if
+ * <tt>ksize</tt> is a multiple of that alignment.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_get</tt> on a hash table object not in map mode.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] k Pointer to key.
+ *
+ * @return Pointer to value if found. <tt>NULL</tt> otherwise.
+ */
+extern void *dhashtabs_get(dhashtabs_t t, const void *k);
+
+/**
+ * @brief Remove key from map mode hash table object.
+ *
+ * If found, the record holding the key is removed from the hash table and a
+ * pointer to it returned to the user, who is responsible for freeing it. The
+ * value follows the key bytes of the record.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dhashtabs_del</tt> on a hash table object not in map mode.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] k Pointer to key.
+ *
+ * @return Pointer to record if found. <tt>NULL</tt> otherwise.
+ */
+extern void *dhashtabs_del(dhashtabs_t t, const void *k);
+
 /**
  * @brief Swap opaque pointers for deep hash tables.
  *
@@ -10,6 +10,13 @@
  *
  * Repetitions are not allowed, and data must be linearly ordered.
  *
+ * Each data object is copied into a single allocation together with its links,
+ * a record shared by every deep container of this library. Pointers returned by
+ * <tt>dqueues_dequeue_front</tt>, <tt>dqueues_dequeue_back</tt> and
+ * <tt>dqueues_remove</tt> are to be freed by the user with <tt>free</tt>, or
+ * handed to <tt>dqueues_enqueu_adopt</tt>, <tt>dstacks_push_adopt</tt> or
+ * <tt>dhashtabs_insert_adopt</tt> to be taken over without copying.
+ *
  * The <tt>dqueues_t</tt> class is implemented as an opaque pointer.
  *
  * @warning This class is meant to be used in time restricted settings. As such,
@@ -28,6 +35,8 @@
 # include <error.h>
 # include <string.h>
 
+# include "allocators.h"
+
 typedef struct dqueues_t* dqueues_t;
 
 /**
@@ -62,6 +71,29 @@ typedef int (*dqueues_data_cmp_r)(const void*, const void*, void*);
 extern dqueues_t dqueues_new(dqueues_data_cmp cmp, dqueues_data_cmp_r cmp_r,
                              size_t size);
 
+/**
+ * @brief Instantiates a <tt>dqueues_t</tt> instance with a user allocator.
+ *
+ * As <tt>dqueues_new</tt>, but the queue object and its copies of the data are
+ * allocated and freed through <tt>al</tt>. Data objects returned to the user
+ * are to be freed through <tt>al</tt> as well.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>One of the <tt>dqueues_data_cmp</tt> or <tt>queues_data_cmp_r</tt>
+ * arguments must be non<tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ * @param[in] size Total size of data objects.
+ * @param[in] al Allocator of the queue.
+ *
+ * @return Instance of queue object.
+ */
+extern dqueues_t dqueues_new_alloc(dqueues_data_cmp cmp, dqueues_data_cmp_r cmp_r,
+                                   size_t size, const allocators_t *al);
+
 /**
  * @brief Inserts deep copied data object into queue object.
  *
@@ -96,6 +128,95 @@ extern void dqueues_enqueu(dqueues_t q, const void *x);
  */
 extern void dqueues_enqueu_r(dqueues_t q, const void *x, void *y);
 
+/**
+ * @brief Finds data object in queue object, inserting it if absent.
+ *
+ * A single probe of the queue either finds data equal to <tt>x</tt> or inserts
+ * a copy of <tt>x</tt> in order, so that a find followed by an insert costs one
+ * traversal.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dqueues_find_or_enqueu</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being searched and added to.
+ * @param[in] x Pointer to data being searched for and added.
+ * @param[out] inserted Set to 1 if <tt>x</tt> was inserted and 0 if it was
+ * found, unless <tt>NULL</tt>.
+ *
+ * @return Pointer to the copy held by the queue, found or made.
+ */
+extern void *dqueues_find_or_enqueu(dqueues_t q, const void *x, int *inserted);
+
+/**
+ * @brief Finds data object in queue object, inserting it if absent.
+ *
+ * Reentrant version of <tt>dqueues_find_or_enqueu</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dqueues_find_or_enqueu_r</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being searched and added to.
+ * @param[in] x Pointer to data being searched for and added.
+ * @param[in] y Argument to user provided reentrant compare function.
+ * @param[out] inserted Set to 1 if <tt>x</tt> was inserted and 0 if it was
+ * found, unless <tt>NULL</tt>.
+ *
+ * @return Pointer to the copy held by the queue, found or made.
+ */
+extern void *dqueues_find_or_enqueu_r(dqueues_t q, const void *x, void *y,
+                                      int *inserted);
+
+/**
+ * @brief Inserts record into queue object, taking ownership of it.
+ *
+ * As <tt>dqueues_enqueu</tt>, but <tt>x</tt> is not copied: it is a record
+ * handed back by a deep container of the same data size and allocator, such as
+ * a pointer returned by <tt>dqueues_dequeue_front</tt>,
+ * <tt>dhashtabs_remove</tt> or <tt>dstacks_pop</tt>, and is linked into the
+ * queue in place.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dqueues_enqueu_adopt</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * <dd><tt>x</tt> is not such a record.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Record being added to queue object.
+ *
+ * @retval int Returns 1 if <tt>x</tt> is adopted. Returns -1 if equal data is
+ * already in the queue, <tt>x</tt> remaining the user's.
+ */
+extern int dqueues_enqueu_adopt(dqueues_t q, void *x);
+
+/**
+ * @brief Inserts record into queue object, taking ownership of it.
+ *
+ * Reentrant version of <tt>dqueues_enqueu_adopt</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dqueues_enqueu_adopt_r</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * <dd><tt>x</tt> is not such a record.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Record being added to queue object.
+ * @param[in] y Argument to user provided reentrant compare function.
+ *
+ * @retval int Returns 1 if <tt>x</tt> is adopted. Returns -1 if equal data is
+ * already in the queue, <tt>x</tt> remaining the user's.
+ */
+extern int dqueues_enqueu_adopt_r(dqueues_t q, void *x, void *y);
+
 /**
  * @brief Remove object from front of queue object.
  *
@@ -211,6 +332,47 @@ extern void *dqueues_remove(dqueues_t q, const void *x);
  */
 extern void *dqueues_remove_r(dqueues_t q, const void *x, void *y);
 
+/**
+ * @brief Remove every data object of queue object passing a predicate.
+ *
+ * The queue is walked once from front to back, and every data object
+ * <tt>pred</tt> returns a positive <tt>int</tt> for is unlinked and freed, a
+ * pointer to it first being handed to <tt>dispose</tt> unless it is
+ * <tt>NULL</tt>, to release what the data object owns. Unlike
+ * <tt>dqueues_remove</tt>, removed data objects are not handed back.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>pred</tt> or <tt>dispose</tt> alter the queue object.</dd>
+ * <dd><tt>dispose</tt> keeps the pointer it is handed.</dd>
+ * </dl>
+ *
+ * @param[in] q Queues object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t dqueues_remove_if(dqueues_t q, int pred(const void *x),
+                                void dispose(void *x));
+
+/**
+ * @brief Remove every data object of queue object passing a predicate.
+ *
+ * Reentrant version of <tt>dqueues_remove_if</tt>.
+ *
+ * @param[in] q Queues object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ * @param[in] y Argument to <tt>pred</tt> and <tt>dispose</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t dqueues_remove_if_r(dqueues_t q, int pred(const void *x, void *y),
+                                  void dispose(void *x, void *y), void *y);
+
 /**
  * @brief Apply function to every member of queue object.
  *
@@ -222,6 +384,8 @@ extern void *dqueues_remove_r(dqueues_t q, const void *x, void *y);
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
  * <dd>Calling <tt>dqueues_map</tt> on a <tt>NULL</tt> queue object.</dd>
+ * <dd><tt>apply</tt> frees the data object pointed to by <tt>*x</tt>. The data
+ * objects may be modified in place, but are freed by <tt>dqueues_free</tt>.</dd>
  * </dl>
  *
  * @param[in] q Queue object being acted upon.
@@ -249,6 +413,67 @@ extern int dqueues_map(dqueues_t q, int apply(void **x));
  */
 extern int dqueues_map_r(dqueues_t q, int apply(void **x, void *y), void *y);
 
+/**
+ * @brief Cursor over the elements of a deep queue, from front to back.
+ *
+ * A cursor is started by <tt>dqueues_iterinit</tt> and advanced by
+ * <tt>dqueues_iternext</tt>; unlike <tt>dqueues_map</tt>, the loop body is the
+ * user's own code. A cursor stays valid while the queue is not changed, and
+ * across finds; enqueues and removes invalidate it.
+ */
+typedef struct {
+  void *x;    ///< copy of element at cursor, <tt>NULL</tt> past the back
+  size_t off; ///< offset of links within the allocation of an element
+} dqueues_iter_t;
+
+/**
+ * @brief Starts cursor at front of deep queue.
+ *
+ * A <tt>NULL</tt> queue object is visited as an empty queue.
+ *
+ * @param[in] q Queue object being visited.
+ * @param[out] it Cursor being started.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the queue
+ * is empty.
+ */
+extern int dqueues_iterinit(dqueues_t q, dqueues_iter_t *it);
+
+/**
+ * @brief Advances cursor to the next element of deep queue.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the back of the queue.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor being advanced.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 once it is
+ * past the back of the queue.
+ */
+extern int dqueues_iternext(dqueues_iter_t *it);
+
+/**
+ * @brief Element at cursor.
+ *
+ * The element is the copy held by the queue, and is not to be freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the back of the queue.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor of queue.
+ *
+ * @return Pointer to the data object at the cursor.
+ */
+static inline
+void *dqueues_iterget(const dqueues_iter_t *it)
+{
+  return it->x;
+}
+
 /**
  * @brief Free data allocated for the deep queues-type associations.
  *
@@ -274,6 +499,44 @@ extern void dqueues_free(dqueues_t *q);
  */
 extern size_t dqueues_size(dqueues_t q);
 
+/**
+ * @brief Number of bytes allocated for queue.
+ *
+ * Number of bytes allocated for the queue object, its links and the deep copied
+ * data.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dqueues_bytes</tt> on a <tt>NULL</tt> queue object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being checked.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t dqueues_bytes(dqueues_t q);
+
+/**
+ * @brief Number of bytes allocated for queue.
+ *
+ * Number of bytes allocated for the queue object, its links and the deep copied
+ * data, as <tt>dqueues_bytes</tt>. If <tt>payload</tt> is not <tt>NULL</tt>, it
+ * is set to the number of those bytes holding the copied data, padding
+ * excluded; the rest is overhead.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dqueues_memory_usage</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being checked.
+ * @param[out] payload Bytes of payload, if not <tt>NULL</tt>.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t dqueues_memory_usage(dqueues_t q, size_t *payload);
+
 /**
  * @brief Swap opaque pointers for deep queues.
  *
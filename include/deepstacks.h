@@ -8,6 +8,12 @@
  * instance. The function <tt>dstack_push</tt> copies the data passed to it by the
  * user.
  *
+ * Each data object is copied into a single allocation together with its link,
+ * a record shared by every deep container of this library. Pointers returned by
+ * <tt>dstacks_pop</tt> are to be freed by the user with <tt>free</tt>, or handed
+ * to <tt>dstacks_push_adopt</tt>, <tt>dqueues_enqueu_adopt</tt> or
+ * <tt>dhashtabs_insert_adopt</tt> to be taken over without copying.
+ *
  * The <tt>dstacks_t</tt> class is implemented as an opaque pointer.
  *
  * @warning This class is meant to be used in time restricted settings. As such,
@@ -24,6 +30,8 @@
 # include <stddef.h>
 # include <string.h>
 
+# include "allocators.h"
+
 typedef struct dstacks_t* dstacks_t;
 
 /**
@@ -43,6 +51,25 @@ typedef struct dstacks_t* dstacks_t;
  */
 extern dstacks_t dstacks_new(size_t size);
 
+/**
+ * @brief Instantiate a <tt>dstacks_t</tt> instance with a user allocator.
+ *
+ * As <tt>dstacks_new</tt>, but the stack object and its copies of the data are
+ * allocated and freed through <tt>al</tt>. Data objects returned to the user
+ * are to be freed through <tt>al</tt> as well.
+ *
+ * <dl>
+ * <dt><strong>Uncheck Runtime Error</strong></dt>
+ * <dd>The size parameter is unequal to the total size of the data.</dd>
+ * </dl>
+ *
+ * @param[in] size The total size of the data objects.
+ * @param[in] al Allocator of the stack.
+ *
+ * @return Opaque pointer to stack object.
+ */
+extern dstacks_t dstacks_new_alloc(size_t size, const allocators_t *al);
+
 /**
  * @brief Push existing data onto stack.
  *
@@ -60,6 +87,26 @@ extern dstacks_t dstacks_new(size_t size);
  */
 extern void dstacks_push(dstacks_t s, void *x);
 
+/**
+ * @brief Push record onto stack object, taking ownership of it.
+ *
+ * As <tt>dstacks_push</tt>, but <tt>x</tt> is not copied: it is a record handed
+ * back by a deep container of the same data size and allocator, such as a
+ * pointer returned by <tt>dstacks_pop</tt>, <tt>dqueues_dequeue_front</tt> or
+ * <tt>dhashtabs_remove</tt>, and is linked onto the stack in place.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>dstacks_push_adopt</tt> with a <tt>NULL</tt>
+ * <tt>dstacks_t</tt> parameter <tt>s</tt>.</dd>
+ * <dd><tt>x</tt> is not such a record.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being pushed upon.
+ * @param[in] x Record being pushed onto top of stack object <tt>s</tt>.
+ */
+extern void dstacks_push_adopt(dstacks_t s, void *x);
+
 /**
  * @brief Pop data object on top of stack and return to user.
  *
@@ -133,6 +180,8 @@ extern size_t dstacks_size(dstacks_t s);
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
  * <dd>Calling <tt>dstacks_map</tt> on a <tt>NULL</tt> stack object.</dd>
+ * <dd><tt>apply</tt> frees the data object pointed to by <tt>*x</tt>. The data
+ * objects may be modified in place, but are freed by <tt>dstacks_free</tt>.</dd>
  * </dl>
  *
  * @param[in] s Stack object being acted upon.
@@ -0,0 +1,318 @@
+/**
+ * @file deques.h
+ * @brief Public interface of <tt>deques_t</tt> class
+ *
+ * The <tt>deques_t</tt> object instantiates a double ended queue held in one
+ * growable ring buffer. Elements are pushed and popped at either end in
+ * amortized constant time, and no allocation is made per element. Unlike
+ * <tt>queues_t</tt>, the order of the elements is the order in which they were
+ * pushed, and repetitions are allowed.
+ *
+ * As for <tt>arrays_t</tt>, elements are <tt>size</tt> bytes copied into and
+ * out of the deque. To store pointers, take <tt>size</tt> to be
+ * <tt>sizeof(void*)</tt> and pass the address of the pointer.
+ *
+ * The capacity of the ring buffer is a power of two and doubles when full. It
+ * never shrinks, short of a call to <tt>deques_free</tt>.
+ *
+ * The <tt>deques_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_DEQUES_H
+# define INCLUDED_DEQUES_H
+
+# include <stddef.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include "allocators.h"
+
+typedef struct deques_t* deques_t;
+
+/**
+ * @brief Instantiates a <tt>deques_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>deques_t</tt> instance. This memory needs
+ * to be freed by a call to <tt>deques_free</tt>. The capacity is rounded up to
+ * a power of two.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Initialize deque to hold <tt>capacity</tt> elements.
+ *
+ * @return Instance of an allocated deque object.
+ */
+extern deques_t deques_new(size_t size, size_t capacity);
+
+/**
+ * @brief Instantiates a <tt>deques_t</tt> instance with a user allocator.
+ *
+ * As <tt>deques_new</tt>, but the deque object and its ring buffer are
+ * allocated and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] capacity Initialize deque to hold <tt>capacity</tt> elements.
+ * @param[in] al Allocator of the deque.
+ *
+ * @return Instance of an allocated deque object.
+ */
+extern deques_t deques_new_alloc(size_t size, size_t capacity,
+                                 const allocators_t *al);
+
+/**
+ * @brief Push a copy of data to the back of deque.
+ *
+ * The <tt>size</tt> bytes at <tt>x</tt> are copied to the back of the deque.
+ * The ring buffer is doubled if full.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>deques_push_back</tt> on a <tt>NULL</tt> deque object.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being added to.
+ * @param[in] x Pointer to data being copied into deque object.
+ */
+extern void deques_push_back(deques_t d, const void *x);
+
+/**
+ * @brief Push a copy of data to the front of deque.
+ *
+ * The <tt>size</tt> bytes at <tt>x</tt> are copied to the front of the deque.
+ * The ring buffer is doubled if full.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>deques_push_front</tt> on a <tt>NULL</tt> deque object.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being added to.
+ * @param[in] x Pointer to data being copied into deque object.
+ */
+extern void deques_push_front(deques_t d, const void *x);
+
+/**
+ * @brief Pop the front element of deque.
+ *
+ * The front element is removed from the deque and, if <tt>x</tt> is not
+ * <tt>NULL</tt>, copied to <tt>x</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>deques_pop_front</tt> on a <tt>NULL</tt> deque object.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being popped.
+ * @param[out] x Buffer of <tt>size</tt> bytes receiving the element, or
+ * <tt>NULL</tt>.
+ *
+ * @return 1 if an element was popped. -1 if the deque is empty.
+ */
+extern int deques_pop_front(deques_t d, void *x);
+
+/**
+ * @brief Pop the back element of deque.
+ *
+ * The back element is removed from the deque and, if <tt>x</tt> is not
+ * <tt>NULL</tt>, copied to <tt>x</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>deques_pop_back</tt> on a <tt>NULL</tt> deque object.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being popped.
+ * @param[out] x Buffer of <tt>size</tt> bytes receiving the element, or
+ * <tt>NULL</tt>.
+ *
+ * @return 1 if an element was popped. -1 if the deque is empty.
+ */
+extern int deques_pop_back(deques_t d, void *x);
+
+/**
+ * @brief Pointer to front element of deque.
+ *
+ * Pointer to front element of deque. The pointer is invalidated by the next
+ * push onto the deque.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>deques_front</tt> on a <tt>NULL</tt> deque object.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being accessed.
+ *
+ * @return Pointer to front element. <tt>NULL</tt> if the deque is empty.
+ */
+extern void *deques_front(deques_t d);
+
+/**
+ * @brief Pointer to back element of deque.
+ *
+ * Pointer to back element of deque. The pointer is invalidated by the next push
+ * onto the deque.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>deques_back</tt> on a <tt>NULL</tt> deque object.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being accessed.
+ *
+ * @return Pointer to back element. <tt>NULL</tt> if the deque is empty.
+ */
+extern void *deques_back(deques_t d);
+
+/**
+ * @brief Pointer to element of deque at a given position.
+ *
+ * Pointer to the <tt>i</tt>th element counted from the front of the deque.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Index is out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being accessed.
+ * @param[in] i Position of element from the front.
+ *
+ * @return Pointer to element at position <tt>i</tt>.
+ */
+extern void *deques_at(deques_t d, size_t i);
+
+/**
+ * @brief Apply function to every member of deque object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the deque, from
+ * front to back. Early termination is possible if <tt>apply</tt> returns a
+ * negative <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> pushes onto or pops from the deque.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being acted upon.
+ * @param[in] apply Function being applied to members of the deque.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int deques_map(deques_t d, int apply(void *x));
+
+/**
+ * @brief Apply function to every member of deque object.
+ *
+ * Reentrant version of <tt>deques_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> pushes onto or pops from the deque.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being acted upon.
+ * @param[in] apply Function being applied to members of the deque.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int deques_map_r(deques_t d, int apply(void *x, void *y), void *y);
+
+/**
+ * @brief Grow deque to hold at least a given number of elements.
+ *
+ * Grow deque to hold at least <tt>nmem</tt> elements without further
+ * allocation. Never shrinks the deque.
+ *
+ * @param[in] d Deque object being resized.
+ * @param[in] nmem Number of elements the deque must hold.
+ */
+extern void deques_reserve(deques_t d, size_t nmem);
+
+/**
+ * @brief Remove every element of deque.
+ *
+ * Remove every element of deque. The ring buffer is kept for reuse.
+ *
+ * @param[in] d Deque object being cleared.
+ */
+extern void deques_clear(deques_t d);
+
+/**
+ * @brief Free memory allocated for deque.
+ *
+ * Free memory allocated for deque.
+ *
+ * @param[in] *d Pointer to <tt>deques_t</tt> object.
+ */
+extern void deques_free(deques_t *d);
+
+/**
+ * @brief Number of elements in deque.
+ *
+ * Number of elements in deque.
+ *
+ * @param[in] d Deque object being checked.
+ *
+ * @return Number of elements in deque.
+ */
+extern size_t deques_nmem(deques_t d);
+
+/**
+ * @brief Number of elements deque holds before growing.
+ *
+ * Number of elements deque holds before growing.
+ *
+ * @param[in] d Deque object being checked.
+ *
+ * @return Capacity of deque.
+ */
+extern size_t deques_capacity(deques_t d);
+
+/**
+ * @brief Size of elements of deque.
+ *
+ * Size of elements of deque.
+ *
+ * @param[in] d Deque object being checked.
+ *
+ * @return Size of elements.
+ */
+extern size_t deques_size(deques_t d);
+
+/**
+ * @brief Swap opaque pointers for deques.
+ *
+ * Swap opaque pointers for deques.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Deque objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] d1 First deque.
+ * @param[in] d2 Second deque.
+ */
+static inline
+void deques_swap(deques_t *restrict d1, deques_t *restrict d2)
+{
+  volatile deques_t tmp = *d1;
+  *d1 = *d2;
+  *d2 = tmp;
+}
+
+# endif
@@ -0,0 +1,221 @@
+/**
+ * @file disjointsets.h
+ * @brief Public interface of <tt>disjointsets_t</tt> class
+ *
+ * The <tt>disjointsets_t</tt> object instantiates a partition of the elements
+ * 0 to <tt>n - 1</tt> into disjoint sets, joined by <tt>disjointsets_union</tt>
+ * (a union-find structure). Each set is a tree held in one contiguous array of
+ * <tt>uint32_t</tt> parents, its root naming the set. Unions link the root of
+ * the smaller set under that of the larger, and finds halve the path they walk,
+ * so that a sequence of operations costs nearly constant time each.
+ *
+ * The sets of a graph given by an array of edges, such as the orbits of a group
+ * given by the images of its generators, are made in one call of
+ * <tt>disjointsets_union_edges</tt>. <tt>cdisjointsets_t</tt> of
+ * <tt>concurrentdisjointsets.h</tt> joins sets from several threads at once.
+ *
+ * The <tt>disjointsets_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_DISJOINTSETS_H
+# define INCLUDED_DISJOINTSETS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+
+typedef struct disjointsets_t* disjointsets_t;
+
+/**
+ * @brief Instantiates a <tt>disjointsets_t</tt> instance.
+ *
+ * Memory is allocated for a partition of the elements 0 to <tt>n - 1</tt> into
+ * singletons. This memory needs to be freed by a call to
+ * <tt>disjointsets_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>n</tt> is larger than <tt>UINT32_MAX</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] n Number of elements.
+ *
+ * @return New partition object.
+ */
+extern disjointsets_t disjointsets_new(size_t n);
+
+/**
+ * @brief Instantiates a <tt>disjointsets_t</tt> instance through an allocator.
+ *
+ * As <tt>disjointsets_new</tt>, but the partition object and its arrays are
+ * allocated through <tt>al</tt>, which is copied.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>n</tt> is larger than <tt>UINT32_MAX</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] n Number of elements.
+ * @param[in] al Allocator of partition object.
+ *
+ * @return New partition object.
+ */
+extern disjointsets_t disjointsets_new_alloc(size_t n, const allocators_t *al);
+
+/**
+ * @brief Frees memory of partition object.
+ *
+ * @param[in] d Pointer to partition object being freed.
+ */
+extern void disjointsets_free(disjointsets_t *d);
+
+/**
+ * @brief Root of the set of element.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_find</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ *
+ * @return Root of the set of <tt>x</tt>.
+ */
+extern uint32_t disjointsets_find(disjointsets_t d, uint32_t x);
+
+/**
+ * @brief Joins the sets of two elements.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_union</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> or <tt>y</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ * @param[in] y Element.
+ *
+ * @retval int Returns 1 if two sets were joined. Returns -1 if <tt>x</tt> and
+ * <tt>y</tt> were in one set.
+ */
+extern int disjointsets_union(disjointsets_t d, uint32_t x, uint32_t y);
+
+/**
+ * @brief Joins the sets of the ends of each of an array of edges.
+ *
+ * Edge <tt>i</tt> joins elements <tt>e[2 * i]</tt> and <tt>e[2 * i + 1]</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_union_edges</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>e</tt> holds fewer than <tt>2 * m</tt> elements, or one that is not
+ * an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] e Edges, as pairs of elements.
+ * @param[in] m Number of edges.
+ *
+ * @return Number of edges which joined two sets.
+ */
+extern size_t disjointsets_union_edges(disjointsets_t d, const uint32_t *e,
+                                       size_t m);
+
+/**
+ * @brief Test whether two elements are in one set.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_same</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> or <tt>y</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ * @param[in] y Element.
+ *
+ * @retval int Returns 1 if <tt>x</tt> and <tt>y</tt> are in one set. Returns
+ * -1 otherwise.
+ */
+extern int disjointsets_same(disjointsets_t d, uint32_t x, uint32_t y);
+
+/**
+ * @brief Number of elements of the set of element.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_setsize</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>x</tt> is not an element.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[in] x Element.
+ *
+ * @return Number of elements of the set of <tt>x</tt>.
+ */
+extern size_t disjointsets_setsize(disjointsets_t d, uint32_t x);
+
+/**
+ * @brief Labels every element by the root of its set.
+ *
+ * Sets <tt>out[x]</tt> to the root of the set of <tt>x</tt> for every element
+ * <tt>x</tt>, leaving every element a child of its root.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_labels</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * <dd><tt>out</tt> holds fewer than <tt>disjointsets_size</tt> elements.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ * @param[out] out Root of the set of every element.
+ */
+extern void disjointsets_labels(disjointsets_t d, uint32_t *out);
+
+/**
+ * @brief Number of sets of partition object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_count</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ *
+ * @return Number of sets.
+ */
+extern size_t disjointsets_count(disjointsets_t d);
+
+/**
+ * @brief Number of elements of partition object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>disjointsets_size</tt> on a <tt>NULL</tt> partition
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] d Partition object.
+ *
+ * @return Number of elements.
+ */
+extern size_t disjointsets_size(disjointsets_t d);
+
+# endif
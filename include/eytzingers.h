@@ -0,0 +1,223 @@
+/**
+ * @file eytzingers.h
+ * @brief Public interface of <tt>eytzingers_t</tt> class
+ *
+ * The <tt>eytzingers_t</tt> object instantiates a read-only search index built
+ * from a sorted <tt>arrays_t</tt>. The elements are copied into Eytzinger
+ * order: the root at position 1 and the children of position <tt>k</tt> at
+ * positions <tt>2k</tt> and <tt>2k + 1</tt>, so that the first levels of every
+ * search share a few cache lines, and the positions visited four levels down
+ * are adjacent and can be prefetched while the current level is compared.
+ * Queries descend without branching on the result of the compare function.
+ *
+ * <tt>eytzingers_lower_bound_batch</tt> answers many queries in lock-step,
+ * so that the cache misses of distinct queries overlap.
+ *
+ * An index answers far more queries than it costs to build, compared to
+ * <tt>arrays_bsearch</tt> on arrays larger than the caches. The index does
+ * not follow changes to the array it was built from.
+ *
+ * The <tt>eytzingers_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_EYTZINGERS_H
+# define INCLUDED_EYTZINGERS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+# include "arrays.h"
+
+typedef struct eytzingers_t* eytzingers_t;
+
+/**
+ * @brief User provided compare function. Must agree with the order of the
+ * array the index is built from.
+ */
+typedef int (*eytzingers_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must agree with the order
+ * of the array the index is built from.
+ */
+typedef int (*eytzingers_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief Instantiates an <tt>eytzingers_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>eytzingers_t</tt> instance, and the
+ * elements of <tt>a</tt> are copied into it. This memory needs to be freed by a
+ * call to <tt>eytzingers_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>eytzingers_new</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd>Array object is not sorted according to the compare function.</dd>
+ * <dd>Both <tt>eytzingers_data_cmp</tt> and <tt>eytzingers_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Sorted array object being indexed.
+ * @param[in] cmp User function to compare an element to a query.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ *
+ * @return Instance of index object.
+ */
+extern eytzingers_t eytzingers_new(arrays_t a, eytzingers_data_cmp cmp,
+                                   eytzingers_data_cmp_r cmp_r);
+
+/**
+ * @brief Instantiates an <tt>eytzingers_t</tt> instance with a user allocator.
+ *
+ * As <tt>eytzingers_new</tt>, but the index object is allocated and freed
+ * through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>eytzingers_new_alloc</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Array object is not sorted according to the compare function.</dd>
+ * <dd>Both <tt>eytzingers_data_cmp</tt> and <tt>eytzingers_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Sorted array object being indexed.
+ * @param[in] cmp User function to compare an element to a query.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ * @param[in] al Allocator of the index.
+ *
+ * @return Instance of index object.
+ */
+extern eytzingers_t eytzingers_new_alloc(arrays_t a, eytzingers_data_cmp cmp,
+                                         eytzingers_data_cmp_r cmp_r,
+                                         const allocators_t *al);
+
+/**
+ * @brief Least element of index object not less than the user provided query.
+ *
+ * The compare function is called with an element of the index as first
+ * argument and <tt>x</tt> as second argument.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>eytzingers_lower_bound</tt> on <tt>NULL</tt> index
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] e Index object being searched.
+ * @param[in] x Query bounding the result from below.
+ *
+ * @return Pointer to element of index if any. <tt>NULL</tt> otherwise.
+ */
+extern void *eytzingers_lower_bound(eytzingers_t e, const void *x);
+
+/**
+ * @brief Least element of index object not less than the user provided query.
+ *
+ * Reentrant version of <tt>eytzingers_lower_bound</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>eytzingers_lower_bound_r</tt> on <tt>NULL</tt> index
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] e Index object being searched.
+ * @param[in] x Query bounding the result from below.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to element of index if any. <tt>NULL</tt> otherwise.
+ */
+extern void *eytzingers_lower_bound_r(eytzingers_t e, const void *x, void *y);
+
+/**
+ * @brief Least elements of index object not less than each of many queries.
+ *
+ * Sets <tt>r[i]</tt> to <tt>eytzingers_lower_bound(e, x[i])</tt> for every
+ * <tt>i</tt> below <tt>n</tt>. Queries are descended in groups, one level of
+ * every query of a group at a time, so that their memory accesses are in flight
+ * together.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>eytzingers_lower_bound_batch</tt> on <tt>NULL</tt> index
+ * object.</dd>
+ * <dd><tt>x</tt> or <tt>r</tt> hold fewer than <tt>n</tt> pointers.</dd>
+ * </dl>
+ *
+ * @param[in] e Index object being searched.
+ * @param[in] x Queries bounding the results from below.
+ * @param[in] n Number of queries.
+ * @param[out] r Pointers to elements of index, or <tt>NULL</tt>.
+ */
+extern void eytzingers_lower_bound_batch(eytzingers_t e, const void *const *x,
+                                         size_t n, void **r);
+
+/**
+ * @brief Least elements of index object not less than each of many queries.
+ *
+ * Reentrant version of <tt>eytzingers_lower_bound_batch</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>eytzingers_lower_bound_batch_r</tt> on <tt>NULL</tt> index
+ * object.</dd>
+ * <dd><tt>x</tt> or <tt>r</tt> hold fewer than <tt>n</tt> pointers.</dd>
+ * </dl>
+ *
+ * @param[in] e Index object being searched.
+ * @param[in] x Queries bounding the results from below.
+ * @param[in] n Number of queries.
+ * @param[out] r Pointers to elements of index, or <tt>NULL</tt>.
+ * @param[in] y Argument to user provided compare function.
+ */
+extern void eytzingers_lower_bound_batch_r(eytzingers_t e, const void *const *x,
+                                           size_t n, void **r, void *y);
+
+/**
+ * @brief Frees memory of index object.
+ *
+ * @param[in] e Pointer to index object being freed.
+ */
+extern void eytzingers_free(eytzingers_t *e);
+
+/**
+ * @brief Number of elements of index object.
+ *
+ * @param[in] e Index object.
+ *
+ * @return Number of elements.
+ */
+extern size_t eytzingers_nmem(eytzingers_t e);
+
+/**
+ * @brief Size of elements of index object.
+ *
+ * @param[in] e Index object.
+ *
+ * @return Size of elements.
+ */
+extern size_t eytzingers_size(eytzingers_t e);
+
+/**
+ * @brief Swaps two index objects.
+ *
+ * @param[in] e1 First index.
+ * @param[in] e2 Second index.
+ */
+static inline
+void eytzingers_swap(eytzingers_t *restrict e1, eytzingers_t *restrict e2)
+{
+  volatile eytzingers_t tmp = *e1;
+  *e1 = *e2;
+  *e2 = tmp;
+}
+
+# endif
@@ -0,0 +1,216 @@
+/**
+ * @file fenwicks.h
+ * @brief Public interface of <tt>fenwicks_t</tt> class
+ *
+ * The <tt>fenwicks_t</tt> object instantiates a Fenwick tree (binary indexed
+ * tree) of <tt>uint64_t</tt> counts, answering the sum of the first elements
+ * and updating one element in <tt>O(log n)</tt> steps each. Position
+ * <tt>k</tt> of the tree, counted from 1, holds the sum of the
+ * <tt>k & -k</tt> elements ending at element <tt>k - 1</tt>, so that a prefix
+ * is the sum of the positions reached by clearing the lowest set bit of its
+ * length, and an update adds to the positions reached by adding it.
+ *
+ * A tree is built alongside an <tt>arrays_t</tt> of <tt>uint64_t</tt> in
+ * <tt>O(n)</tt> steps, and does not follow later changes to the array. Sums
+ * wrap modulo <tt>2^64</tt>, so that negative deltas may be added.
+ * <tt>fenwicks_search</tt> finds the number of leading elements whose sum does
+ * not exceed a bound in one descent, which ranks a score or samples an element
+ * by weight. Minima, maxima and other aggregates of ranges are kept by
+ * <tt>segtrees_t</tt> of <tt>segtrees.h</tt>.
+ *
+ * The <tt>fenwicks_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_FENWICKS_H
+# define INCLUDED_FENWICKS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+# include "arrays.h"
+
+typedef struct fenwicks_t* fenwicks_t;
+
+/**
+ * @brief Instantiates a <tt>fenwicks_t</tt> instance.
+ *
+ * Memory is allocated for a tree of <tt>n</tt> zero counts. This memory needs
+ * to be freed by a call to <tt>fenwicks_free</tt>.
+ *
+ * @param[in] n Number of elements.
+ *
+ * @return New tree object.
+ */
+extern fenwicks_t fenwicks_new(size_t n);
+
+/**
+ * @brief Instantiates a <tt>fenwicks_t</tt> instance through an allocator.
+ *
+ * As <tt>fenwicks_new</tt>, but the tree object and its array are allocated
+ * through <tt>al</tt>, which is copied.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] al Allocator of tree object.
+ *
+ * @return New tree object.
+ */
+extern fenwicks_t fenwicks_new_alloc(size_t n, const allocators_t *al);
+
+/**
+ * @brief Instantiates a <tt>fenwicks_t</tt> instance of the counts of an
+ * array.
+ *
+ * The tree holds the elements of <tt>a</tt>, and is built in <tt>O(n)</tt>
+ * steps. This memory needs to be freed by a call to <tt>fenwicks_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>fenwicks_new_array</tt> on a <tt>NULL</tt> array
+ * object.</dd>
+ * <dd>Elements of <tt>a</tt> are not of type <tt>uint64_t</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object of counts.
+ *
+ * @return New tree object.
+ */
+extern fenwicks_t fenwicks_new_array(arrays_t a);
+
+/**
+ * @brief Frees memory of tree object.
+ *
+ * @param[in] f Pointer to tree object being freed.
+ */
+extern void fenwicks_free(fenwicks_t *f);
+
+/**
+ * @brief Adds to an element of tree object.
+ *
+ * Takes <tt>O(log n)</tt> steps.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than <tt>fenwicks_nmem(f)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] f Tree object.
+ * @param[in] i Index of element.
+ * @param[in] d Amount added, negative to subtract.
+ */
+extern void fenwicks_add(fenwicks_t f, size_t i, int64_t d);
+
+/**
+ * @brief Sets an element of tree object.
+ *
+ * Takes <tt>O(log n)</tt> steps.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than <tt>fenwicks_nmem(f)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] f Tree object.
+ * @param[in] i Index of element.
+ * @param[in] x New value of element.
+ */
+extern void fenwicks_set(fenwicks_t f, size_t i, uint64_t x);
+
+/**
+ * @brief Element of tree object.
+ *
+ * Takes <tt>O(log n)</tt> steps, and one on average.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than <tt>fenwicks_nmem(f)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] f Tree object.
+ * @param[in] i Index of element.
+ *
+ * @return Value of element.
+ */
+extern uint64_t fenwicks_get(fenwicks_t f, size_t i);
+
+/**
+ * @brief Sum of the first elements of tree object.
+ *
+ * Takes <tt>O(log n)</tt> steps.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is larger than <tt>fenwicks_nmem(f)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] f Tree object.
+ * @param[in] i Number of leading elements summed.
+ *
+ * @return Sum of elements 0 to <tt>i - 1</tt>.
+ */
+extern uint64_t fenwicks_prefix(fenwicks_t f, size_t i);
+
+/**
+ * @brief Sum of a range of elements of tree object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>lo</tt> is larger than <tt>hi</tt>.</dd>
+ * <dd><tt>hi</tt> is larger than <tt>fenwicks_nmem(f)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] f Tree object.
+ * @param[in] lo Index of first element summed.
+ * @param[in] hi Index one past the last element summed.
+ *
+ * @return Sum of elements <tt>lo</tt> to <tt>hi - 1</tt>.
+ */
+extern uint64_t fenwicks_range(fenwicks_t f, size_t lo, size_t hi);
+
+/**
+ * @brief Number of leading elements of tree object whose sum does not exceed
+ * a bound.
+ *
+ * The largest <tt>i</tt> such that <tt>fenwicks_prefix(f, i) <= s</tt>, found
+ * in one descent of <tt>O(log n)</tt> steps. Element <tt>i</tt>, if any, is
+ * the one whose range of prefix sums holds <tt>s</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Sums of the elements wrap, as with negative elements.</dd>
+ * </dl>
+ *
+ * @param[in] f Tree object.
+ * @param[in] s Bound on the sum.
+ *
+ * @return Number of elements.
+ */
+extern size_t fenwicks_search(fenwicks_t f, uint64_t s);
+
+/**
+ * @brief Appends an element to tree object.
+ *
+ * The array of the tree grows geometrically, so that an append takes
+ * <tt>O(log n)</tt> steps amortized.
+ *
+ * @param[in] f Tree object.
+ * @param[in] x Value of new element.
+ */
+extern void fenwicks_push(fenwicks_t f, uint64_t x);
+
+/**
+ * @brief Number of elements of tree object.
+ *
+ * @param[in] f Tree object.
+ *
+ * @return Number of elements.
+ */
+extern size_t fenwicks_nmem(fenwicks_t f);
+
+# endif
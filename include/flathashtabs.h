@@ -0,0 +1,465 @@
+/**
+ * @file flathashtabs.h
+ * @brief Public interface of <tt>flathashtabs_t</tt> class
+ *
+ * The <tt>flathashtabs_t</tt> object instantiates an open addressing hash table.
+ * Data objects are deep copied into one contiguous array of slots by
+ * <tt>flathashtabs_insert</tt>. Alongside the slots, the table keeps one control
+ * byte per slot recording whether the slot is empty, deleted, or full. A full
+ * slot's control byte holds seven bits of the element's hash, so a lookup only
+ * calls the user compare function on slots whose stored bits match.
+ *
+ * Slots are probed a group of control bytes at a time: 16 bytes with SSE2, 32
+ * bytes with AVX2, or 16 bytes one at a time when the library is configured with
+ * <tt>--enable-simd=no</tt>. The capacity is always a power of two, and the table
+ * doubles before more than 7/8 of the slots are in use.
+ *
+ * Growing is done in place: the slot array is extended with <tt>realloc</tt> and
+ * the elements are moved within it, so no second slot array is allocated next to
+ * the first. Deleted slots are dropped the same way once they make up the bulk of
+ * a full table.
+ *
+ * The compare function is only used to test equality. Repetitions are not
+ * allowed.
+ *
+ * The <tt>flathashtabs_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_FLATHASHTABS_H
+# define INCLUDED_FLATHASHTABS_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <stddef.h>
+# include <string.h>
+
+# include "allocators.h"
+
+typedef struct flathashtabs_t* flathashtabs_t;
+
+/**
+ * @brief User provided compare function. Must return 0 exactly when the data
+ * objects are equal.
+ */
+typedef int (*flathashtabs_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must return 0 exactly when
+ * the data objects are equal.
+ */
+typedef int (*flathashtabs_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief User provided hashing function.
+ */
+typedef uint64_t (*flathashtabs_hash)(const void*);
+
+/**
+ * @brief User provided reentrant hashing function.
+ */
+typedef uint64_t (*flathashtabs_hash_r)(const void*, const void*);
+
+/**
+ * @brief Instantiates a <tt>flathashtabs_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>flathashtabs_t</tt> instance with room for
+ * at least <tt>n</tt> data objects before the table needs to grow. This memory
+ * needs to be freed by a call to <tt>flathashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>flathashtabs_data_cmp</tt> and <tt>flathashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>flathashtabs_hash</tt> and <tt>flathashtabs_hash_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>The size parameter is unequal to the total size of the data.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] size Total size of data objects.
+ *
+ * @return Instance of hash table object.
+ */
+extern flathashtabs_t flathashtabs_new(flathashtabs_data_cmp cmp,
+                                       flathashtabs_data_cmp_r cmp_r,
+                                       flathashtabs_hash hash,
+                                       flathashtabs_hash_r hash_r,
+                                       size_t n, size_t size);
+
+/**
+ * @brief Instantiates a <tt>flathashtabs_t</tt> instance with a user allocator.
+ *
+ * As <tt>flathashtabs_new</tt>, but the hash table object and its arrays are
+ * allocated, resized and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>flathashtabs_data_cmp</tt> and <tt>flathashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>flathashtabs_hash</tt> and <tt>flathashtabs_hash_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>The size parameter is unequal to the total size of the data.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] size Total size of data objects.
+ * @param[in] al Allocator of the hash table.
+ *
+ * @return Instance of hash table object.
+ */
+extern flathashtabs_t flathashtabs_new_alloc(flathashtabs_data_cmp cmp,
+                                             flathashtabs_data_cmp_r cmp_r,
+                                             flathashtabs_hash hash,
+                                             flathashtabs_hash_r hash_r,
+                                             size_t n, size_t size,
+                                             const allocators_t *al);
+
+/**
+ * @brief Instantiates a <tt>flathashtabs_t</tt> instance keyed by bit sets.
+ *
+ * As <tt>flathashtabs_new</tt> for data objects that are sets of
+ * <tt>bit_sets.h</tt> of <tt>m</tt> setwords, stored inline in the slots. No
+ * user functions are called: sets are hashed with <tt>hashes_bytes</tt> under
+ * seed 0, as <tt>bit_hash</tt> does, and compared a setword at a time. The
+ * functions with suffix <tt>_r</tt> ignore their hash and compare arguments.
+ *
+ * @param[in] m Number of setwords in the sets.
+ * @param[in] n Hint for the number of elements.
+ *
+ * @return Instance of hash table object.
+ */
+extern flathashtabs_t flathashtabs_new_sets(size_t m, size_t n);
+
+/**
+ * @brief Instantiates a <tt>flathashtabs_t</tt> instance keyed by bit sets with
+ * a user allocator.
+ *
+ * As <tt>flathashtabs_new_sets</tt>, but the hash table object and its arrays
+ * are allocated, resized and freed through <tt>al</tt>.
+ *
+ * @param[in] m Number of setwords in the sets.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] al Allocator of the hash table.
+ *
+ * @return Instance of hash table object.
+ */
+extern flathashtabs_t flathashtabs_new_sets_alloc(size_t m, size_t n,
+                                                  const allocators_t *al);
+
+/**
+ * @brief Inserts copy of data object into hash table object.
+ *
+ * If a data object equal to the user provided data parameter is not present in the
+ * hash table object, then the data object is copied into a free slot of the hash
+ * table. The table doubles in capacity if it would otherwise become more than 7/8
+ * full.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_insert</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being copied into hash table object.
+ */
+extern void flathashtabs_insert(flathashtabs_t t, const void *x);
+
+/**
+ * @brief Inserts copy of data object into hash table object.
+ *
+ * Reentrant version of <tt>flathashtabs_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_insert_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being copied into hash table object.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] cmp_arg Argument to user provided reentrant compare function.
+ */
+extern void flathashtabs_insert_r(flathashtabs_t t, const void *x,
+                                  const void *hash_arg, void *cmp_arg);
+
+/**
+ * @brief Remove data object in hash table object (if present) equal in value to
+ * the data object parameter provided by the user.
+ *
+ * The hash table object is searched for data equal in value to the user provided
+ * data object. If found, the data object is copied into <tt>out</tt> (unless
+ * <tt>out</tt> is <tt>NULL</tt>) and its slot is marked deleted.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_remove</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ * @param[out] out Destination for the removed data object, or <tt>NULL</tt>.
+ *
+ * @return 1 if a data object was removed. -1 otherwise.
+ */
+extern int flathashtabs_remove(flathashtabs_t t, const void *x, void *out);
+
+/**
+ * @brief Remove data object in hash table object (if present) equal in value to
+ * the data object parameter provided by the user.
+ *
+ * Reentrant version of <tt>flathashtabs_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_remove_r</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ * @param[out] out Destination for the removed data object, or <tt>NULL</tt>.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] cmp_arg Argument to user provided reentrant compare function.
+ *
+ * @return 1 if a data object was removed. -1 otherwise.
+ */
+extern int flathashtabs_remove_r(flathashtabs_t t, const void *x, void *out,
+                                 const void *hash_arg, void *cmp_arg);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in hash
+ * table object.
+ *
+ * Check if data equal to user provided data object is contained in hash table
+ * object. Return pointer to the slot holding the data if found; otherwise,
+ * <tt>NULL</tt> is returned. The pointer remains valid until the next insert
+ * into the table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_find</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Data whose membership is being checked.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *flathashtabs_find(flathashtabs_t t, const void *x);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in hash
+ * table object.
+ *
+ * Reentrant version of <tt>flathashtabs_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_find_r</tt> on <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Data whose membership is being checked.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] cmp_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *flathashtabs_find_r(flathashtabs_t t, const void *x,
+                                 const void *hash_arg, void *cmp_arg);
+
+/**
+ * @brief Apply function to every member of hash table object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the hash table. Early
+ * termination is possible if <tt>apply</tt> returns a negative <tt>int</tt>. In
+ * all other cases, we continue to apply <tt>apply</tt> to the succeeding data
+ * object (if any) of the hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> alters the members in a way which changes their hash
+ * value.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int flathashtabs_map(flathashtabs_t t, int apply(void *x));
+
+/**
+ * @brief Apply function to every member of hash table object.
+ *
+ * Reentrant version of <tt>flathashtabs_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> alters the members in a way which changes their hash
+ * value.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] y Argument to user provided function <tt>apply</tt>.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int flathashtabs_map_r(flathashtabs_t t, int apply(void *x, void *y),
+                              void *y);
+
+/**
+ * @brief Write hash table object to a stream.
+ *
+ * Writes a header, the control bytes and the slot array straight from the
+ * table, with no copy made, so that a table too large for a second copy in
+ * memory can be written. Empty slots are written along with full ones.
+ * Integers are written in native byte order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_write</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>Data objects hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being written.
+ * @param[in] f Stream being written to.
+ *
+ * @return 1 upon success, -1 if the stream could not be written.
+ */
+extern int flathashtabs_write(flathashtabs_t t, FILE *f);
+
+/**
+ * @brief Read hash table object from a stream.
+ *
+ * Replaces the contents of the hash table by those written by
+ * <tt>flathashtabs_write</tt>. The control bytes and slots are read straight
+ * into place, and no element is hashed or inserted, unless the table was
+ * written by a library probing groups of another width, in which case it is
+ * rehashed in place once read.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_read</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The hash function of <tt>t</tt> is not that of the table written.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being read into.
+ * @param[in] f Stream being read from.
+ *
+ * @return 1 upon success. -1 if the stream could not be read, leaving the table
+ * empty, with <tt>errno</tt> set to <tt>EINVAL</tt> if the header is not that of
+ * a table of data objects of the size of <tt>t</tt>.
+ */
+extern int flathashtabs_read(flathashtabs_t t, FILE *f);
+
+/**
+ * @brief Read hash table object from a stream.
+ *
+ * Reentrant version of <tt>flathashtabs_read</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_read_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The hash function of <tt>t</tt> is not that of the table written.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being read into.
+ * @param[in] f Stream being read from.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ *
+ * @return 1 upon success. -1 if the stream could not be read, leaving the table
+ * empty, with <tt>errno</tt> set to <tt>EINVAL</tt> if the header is not that of
+ * a table of data objects of the size of <tt>t</tt>.
+ */
+extern int flathashtabs_read_r(flathashtabs_t t, FILE *f, const void *hash_arg);
+
+/**
+ * @brief Free data allocated for the hash table.
+ *
+ * The slot and control arrays are freed along with the table.
+ *
+ * @param[in] *t Pointer to <tt>flathashtabs_t</tt> object.
+ */
+extern void flathashtabs_free(flathashtabs_t *t);
+
+/**
+ * @brief Number of slots allocated for the hash table.
+ *
+ * Number of slots allocated for the hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_capacity</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of slots of the hash table.
+ */
+extern size_t flathashtabs_capacity(flathashtabs_t t);
+
+/**
+ * @brief Number of elements in hash table.
+ *
+ * Number of elements in hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>flathashtabs_size</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of members of the hash table.
+ */
+extern size_t flathashtabs_size(flathashtabs_t t);
+
+/**
+ * @brief Swap opaque pointers for flat hash tables.
+ *
+ * Swap opaque pointers for flat hash tables.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Hash table objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] t1 First hash table.
+ * @param[in] t2 Second hash table.
+ */
+static inline
+void flathashtabs_swap(flathashtabs_t *restrict t1, flathashtabs_t *restrict t2)
+{
+  volatile flathashtabs_t tmp = *t1;
+  *t1 = *t2;
+  *t2 = tmp;
+}
+
+# endif
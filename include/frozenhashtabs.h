@@ -0,0 +1,392 @@
+/**
+ * @file frozenhashtabs.h
+ * @brief Public interface of <tt>fhashtabs_t</tt> class
+ *
+ * The <tt>fhashtabs_t</tt> object instantiates an immutable hash table of
+ * fixed size data objects, built once from a known set of data and then only
+ * searched. The data objects are copied into one contiguous array, in the
+ * order of a minimal perfect hash function of their hash values: each element
+ * has a slot of its own, and a find costs one probe and one compare.
+ *
+ * The perfect hash function is found by hash and displace, in the manner of
+ * PTHash: hash values are spread over buckets of a few elements, and each
+ * bucket is given the first 16 bit pilot placing all of its elements into free
+ * slots of a table slightly larger than the number of elements. Slots past the
+ * number of elements are then remapped onto the free slots below it, so that
+ * the function is minimal. Past the data objects, a table costs about five
+ * bits per element.
+ *
+ * A table is made from an array of data objects by <tt>fhashtabs_new</tt>, or
+ * frozen from a hash table by <tt>hashtabs_freeze</tt> or
+ * <tt>dhashtabs_freeze</tt>. A table made by <tt>fhashtabs_new_map</tt>, or
+ * frozen from a map mode <tt>dhashtabs_t</tt>, is in map mode: each element is
+ * a record of a fixed size key followed by a fixed size value, keys being
+ * compared bytewise, and is searched with <tt>fhashtabs_get</tt>.
+ *
+ * A table is one image in memory, written as is by <tt>fhashtabs_write</tt>,
+ * and either read back with <tt>fhashtabs_read</tt> or mapped into memory with
+ * <tt>fhashtabs_open</tt>. Functions are not written, and are provided again
+ * when the image is loaded.
+ *
+ * Repetitions are not allowed. Distinct data objects of equal hash values
+ * cannot be perfectly hashed.
+ *
+ * The <tt>fhashtabs_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_FROZENHASHTABS_H
+# define INCLUDED_FROZENHASHTABS_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+typedef struct fhashtabs_t* fhashtabs_t;
+
+/**
+ * @brief User provided compare function. Must return 0 for equal data.
+ */
+typedef int (*fhashtabs_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must return 0 for equal
+ * data.
+ */
+typedef int (*fhashtabs_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief User provided hashing function.
+ */
+typedef uint64_t (*fhashtabs_hash)(const void*);
+
+/**
+ * @brief User provided reentrant hashing function.
+ */
+typedef uint64_t (*fhashtabs_hash_r)(const void*, const void*);
+
+/**
+ * @brief Instantiates a <tt>fhashtabs_t</tt> instance.
+ *
+ * The <tt>n</tt> data objects of size <tt>size</tt> at <tt>x</tt> are hashed
+ * with <tt>hash</tt> and copied into a new table. The table needs to be freed
+ * by a call to <tt>fhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>hash</tt> is <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>fhashtabs_data_cmp</tt> and <tt>fhashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd><tt>n</tt> is not less than 2^32.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] x Array of data objects.
+ * @param[in] n Number of data objects.
+ * @param[in] size Size of data objects.
+ *
+ * @return Instance of table object. <tt>NULL</tt>, with <tt>errno</tt> set to
+ * <tt>EINVAL</tt>, if data objects have equal hash values.
+ */
+extern fhashtabs_t fhashtabs_new(fhashtabs_data_cmp cmp,
+                                 fhashtabs_data_cmp_r cmp_r,
+                                 fhashtabs_hash hash, fhashtabs_hash_r hash_r,
+                                 const void *x, size_t n, size_t size);
+
+/**
+ * @brief Instantiates a <tt>fhashtabs_t</tt> instance with a user allocator.
+ *
+ * As <tt>fhashtabs_new</tt>, but the hash values of the data objects may be
+ * given, as by a reentrant hashing function, and the table is allocated and
+ * freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>h</tt> and <tt>hash</tt> are <tt>NULL</tt>.</dd>
+ * <dd>The hash values of <tt>h</tt> are not those of the hashing
+ * functions.</dd>
+ * <dd>Both <tt>fhashtabs_data_cmp</tt> and <tt>fhashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd><tt>n</tt> is not less than 2^32.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] x Array of data objects.
+ * @param[in] h Array of hash values of data objects, or <tt>NULL</tt> to hash
+ * them with <tt>hash</tt>.
+ * @param[in] n Number of data objects.
+ * @param[in] size Size of data objects.
+ * @param[in] al Allocator of the table.
+ *
+ * @return Instance of table object. <tt>NULL</tt>, with <tt>errno</tt> set to
+ * <tt>EINVAL</tt>, if data objects have equal hash values.
+ */
+extern fhashtabs_t fhashtabs_new_alloc(fhashtabs_data_cmp cmp,
+                                       fhashtabs_data_cmp_r cmp_r,
+                                       fhashtabs_hash hash,
+                                       fhashtabs_hash_r hash_r,
+                                       const void *x, const uint64_t *h,
+                                       size_t n, size_t size,
+                                       const allocators_t *al);
+
+/**
+ * @brief Instantiates a <tt>fhashtabs_t</tt> instance in map mode.
+ *
+ * The <tt>n</tt> records at <tt>x</tt>, each a key of size <tt>ksize</tt>
+ * followed by a value of size <tt>vsize</tt>, are copied into a new table.
+ * Keys are hashed with <tt>hash</tt>, or with <tt>hashes_bytes</tt> of seed
+ * zero if <tt>hash</tt> is <tt>NULL</tt>, and compared bytewise, as in a map
+ * mode <tt>dhashtabs_t</tt>. The table needs to be freed by a call to
+ * <tt>fhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>ksize</tt> is zero.</dd>
+ * <dd><tt>n</tt> is not less than 2^32.</dd>
+ * </dl>
+ *
+ * @param[in] hash User provided hashing function of keys, or <tt>NULL</tt>.
+ * @param[in] x Array of records.
+ * @param[in] n Number of records.
+ * @param[in] ksize Size of keys.
+ * @param[in] vsize Size of values.
+ *
+ * @return Instance of table object. <tt>NULL</tt>, with <tt>errno</tt> set to
+ * <tt>EINVAL</tt>, if keys have equal hash values.
+ */
+extern fhashtabs_t fhashtabs_new_map(fhashtabs_hash hash, const void *x,
+                                     size_t n, size_t ksize, size_t vsize);
+
+/**
+ * @brief Instantiates a <tt>fhashtabs_t</tt> instance in map mode with a user
+ * allocator.
+ *
+ * As <tt>fhashtabs_new_map</tt>, but the hash values of the keys may be given,
+ * and the table is allocated and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>ksize</tt> is zero.</dd>
+ * <dd>The hash values of <tt>h</tt> are not those of the keys.</dd>
+ * <dd><tt>n</tt> is not less than 2^32.</dd>
+ * </dl>
+ *
+ * @param[in] hash User provided hashing function of keys, or <tt>NULL</tt>.
+ * @param[in] x Array of records.
+ * @param[in] h Array of hash values of keys, or <tt>NULL</tt> to hash them.
+ * @param[in] n Number of records.
+ * @param[in] ksize Size of keys.
+ * @param[in] vsize Size of values.
+ * @param[in] al Allocator of the table.
+ *
+ * @return Instance of table object. <tt>NULL</tt>, with <tt>errno</tt> set to
+ * <tt>EINVAL</tt>, if keys have equal hash values.
+ */
+extern fhashtabs_t fhashtabs_new_map_alloc(fhashtabs_hash hash, const void *x,
+                                           const uint64_t *h, size_t n,
+                                           size_t ksize, size_t vsize,
+                                           const allocators_t *al);
+
+/**
+ * @brief Finds data object in table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>fhashtabs_find</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd>Calling <tt>fhashtabs_find</tt> on a map mode table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object being searched.
+ * @param[in] x Pointer to data being searched for.
+ *
+ * @return Pointer to the copy of data in the table, which must not be changed.
+ * <tt>NULL</tt> if not found.
+ */
+extern void *fhashtabs_find(fhashtabs_t t, const void *x);
+
+/**
+ * @brief Finds data object in table object.
+ *
+ * Reentrant version of <tt>fhashtabs_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>fhashtabs_find_r</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd>Calling <tt>fhashtabs_find_r</tt> on a map mode table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object being searched.
+ * @param[in] x Pointer to data being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the copy of data in the table, which must not be changed.
+ * <tt>NULL</tt> if not found.
+ */
+extern void *fhashtabs_find_r(fhashtabs_t t, const void *x,
+                              const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Finds value of key in a map mode table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>fhashtabs_get</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd>Calling <tt>fhashtabs_get</tt> on a table object not in map mode.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object being searched.
+ * @param[in] k Pointer to key being searched for.
+ *
+ * @return Pointer to the value of the key, which must not be changed.
+ * <tt>NULL</tt> if not found.
+ */
+extern void *fhashtabs_get(fhashtabs_t t, const void *k);
+
+/**
+ * @brief Applies function to each data object of table object.
+ *
+ * Data objects, or records in map mode, are visited in the order of their
+ * slots.
+ *
+ * @param[in] t Table object.
+ * @param[in] apply User provided function being applied to data.
+ *
+ * @return 1 if every call of <tt>apply</tt> returned a nonnegative value, -1
+ * upon the first negative value, stopping the traversal.
+ */
+extern int fhashtabs_map(fhashtabs_t t, int apply(const void *x));
+
+/**
+ * @brief Applies function to each data object of table object.
+ *
+ * Reentrant version of <tt>fhashtabs_map</tt>.
+ *
+ * @param[in] t Table object.
+ * @param[in] apply User provided function being applied to data.
+ * @param[in] y Argument to <tt>apply</tt>.
+ *
+ * @return 1 if every call of <tt>apply</tt> returned a nonnegative value, -1
+ * upon the first negative value, stopping the traversal.
+ */
+extern int fhashtabs_map_r(fhashtabs_t t, int apply(const void *x, void *y),
+                           void *y);
+
+/**
+ * @brief Write table object to a stream.
+ *
+ * The image of the table is written as is: a header, the pilots and remapped
+ * slots of the perfect hash function, and the data objects. Integers are
+ * written in native byte order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>fhashtabs_write</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd>Data objects hold pointers, which do not survive the process.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object being written.
+ * @param[in] f Stream being written to.
+ *
+ * @return 1 upon success, -1 if the stream could not be written.
+ */
+extern int fhashtabs_write(fhashtabs_t t, FILE *f);
+
+/**
+ * @brief Instantiates a <tt>fhashtabs_t</tt> instance from a stream.
+ *
+ * The image written by <tt>fhashtabs_write</tt> is read into memory. The
+ * functions are those of the table written; in map mode only <tt>hash</tt>,
+ * hashing keys, is used, and may be <tt>NULL</tt> as for
+ * <tt>fhashtabs_new_map</tt>. The table needs to be freed by a call to
+ * <tt>fhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The functions are not those of the table written.</dd>
+ * </dl>
+ *
+ * @param[in] f Stream being read from.
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ *
+ * @return Instance of table object. <tt>NULL</tt> if the stream could not be
+ * read, with <tt>errno</tt> set to <tt>EINVAL</tt> if the header is not that of
+ * a table.
+ */
+extern fhashtabs_t fhashtabs_read(FILE *f, fhashtabs_data_cmp cmp,
+                                  fhashtabs_data_cmp_r cmp_r,
+                                  fhashtabs_hash hash, fhashtabs_hash_r hash_r);
+
+/**
+ * @brief Instantiates a <tt>fhashtabs_t</tt> instance from a file.
+ *
+ * The file at <tt>path</tt>, written by <tt>fhashtabs_write</tt>, is mapped
+ * into memory read-only, so that the table is read from disk as it is searched
+ * rather than loaded up front. The functions are as for
+ * <tt>fhashtabs_read</tt>. The table needs to be freed by a call to
+ * <tt>fhashtabs_free</tt>, which unmaps the file.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The functions are not those of the table written.</dd>
+ * <dd>The file being changed by another process while mapped.</dd>
+ * </dl>
+ *
+ * @param[in] path Path of file holding the table.
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ *
+ * @return Instance of table object. <tt>NULL</tt> if the file could not be
+ * opened or mapped, with <tt>errno</tt> set, <tt>EINVAL</tt> if it does not
+ * hold a table, and <tt>ENOSYS</tt> if files cannot be mapped on this system.
+ */
+extern fhashtabs_t fhashtabs_open(const char *path, fhashtabs_data_cmp cmp,
+                                  fhashtabs_data_cmp_r cmp_r,
+                                  fhashtabs_hash hash, fhashtabs_hash_r hash_r);
+
+/**
+ * @brief Free data allocated for the table object.
+ *
+ * @param[in] *t Pointer to <tt>fhashtabs_t</tt> object.
+ */
+extern void fhashtabs_free(fhashtabs_t *t);
+
+/**
+ * @brief Number of elements in table object.
+ *
+ * @param[in] t Table object.
+ *
+ * @return Number of elements.
+ */
+extern size_t fhashtabs_size(fhashtabs_t t);
+
+/**
+ * @brief Bytes of the perfect hash function of the table object.
+ *
+ * @param[in] t Table object.
+ *
+ * @return Bytes of the pilots and remapped slots, not counting the data
+ * objects.
+ */
+extern size_t fhashtabs_bytes(fhashtabs_t t);
+
+# endif
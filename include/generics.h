@@ -0,0 +1,372 @@
+/**
+ * @file generics.h
+ * @brief Generators of type specialized containers.
+ *
+ * The containers of this library hold <tt>void*</tt> pointers, or elements whose
+ * size is known only at runtime, and call their compare and hash functions
+ * through pointers. The macros of this header instead emit, for a given element
+ * type and given comparison, hash and equality functions, a container whose
+ * functions are <tt>static inline</tt>. The element size is then a compile time
+ * constant and the comparisons may be inlined.
+ *
+ * <tt>DEFINE_ARRAY(name, T)</tt> emits a dynamic array <tt>name_t</tt> of
+ * <tt>T</tt>.
+ *
+ * <tt>DEFINE_HASHTAB(name, K, hash, eq)</tt> emits an open addressing hash set
+ * <tt>name_t</tt> of <tt>K</tt>, with <tt>uint64_t hash(K)</tt> and
+ * <tt>int eq(K, K)</tt>, true when equal.
+ *
+ * <tt>DEFINE_HEAP(name, T, less)</tt> emits a 4-ary min-heap <tt>name_t</tt> of
+ * <tt>T</tt>, with <tt>int less(T, T)</tt>, true when strictly less.
+ *
+ * The functions and macros given as <tt>hash</tt>, <tt>eq</tt> and
+ * <tt>less</tt> are applied to elements by value. Each container is a struct
+ * held by the user, set up by <tt>name_init</tt> and released by
+ * <tt>name_destroy</tt>.
+ *
+ * @warning This is meant to be a lightweight and fast implementation. As such,
+ * various checks for out-of-bounds-type errors are not implemented. It is left
+ * to the user for responsible use of the data structures.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_GENERICS_H
+# define INCLUDED_GENERICS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <string.h>
+# include <errno.h>
+# include <error.h>
+
+/**
+ * @brief Emit a dynamic array <tt>name_t</tt> of <tt>T</tt>.
+ *
+ * Emits <tt>name_init(a, capacity)</tt>, <tt>name_push(a, x)</tt>, which grows
+ * the array by half when full, <tt>name_pop(a)</tt>, <tt>name_at(a, i)</tt>,
+ * <tt>name_resize(a, capacity)</tt>, <tt>name_nmem(a)</tt> and
+ * <tt>name_destroy(a)</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Popping from an empty array.</dd>
+ * <dd>Index out of bounds.</dd>
+ * </dl>
+ *
+ * @param[in] name Prefix of the emitted type and functions.
+ * @param[in] T Element type.
+ */
+# define DEFINE_ARRAY(name, T)                                              \
+  typedef struct {                                                          \
+    size_t nmem;                                                            \
+    size_t capacity;                                                        \
+    T *x;                                                                   \
+  } name##_t;                                                               \
+                                                                            \
+  static inline                                                             \
+  void name##_resize(name##_t *a, size_t capacity)                          \
+  {                                                                         \
+    if ( (a->x = (T*)realloc(a->x, capacity * sizeof(T))) == NULL           \
+         && capacity > 0 )                                                  \
+      error(1, errno, "realloc failure");                                   \
+    a->capacity = capacity;                                                 \
+    if ( a->nmem > capacity ) a->nmem = capacity;                           \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_init(name##_t *a, size_t capacity)                            \
+  {                                                                         \
+    a->nmem = 0;                                                            \
+    a->capacity = 0;                                                        \
+    a->x = NULL;                                                            \
+    if ( capacity > 0 ) name##_resize(a, capacity);                         \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_push(name##_t *a, T x)                                        \
+  {                                                                         \
+    if ( a->nmem == a->capacity )                                           \
+      name##_resize(a, a->nmem < 2 ? a->nmem + 1 : (3 * a->nmem) >> 1);     \
+    a->x[a->nmem++] = x;                                                    \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  T name##_pop(name##_t *a)                                                 \
+  {                                                                         \
+    return a->x[--a->nmem];                                                 \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  T *name##_at(name##_t *a, size_t i)                                       \
+  {                                                                         \
+    return a->x + i;                                                        \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  size_t name##_nmem(const name##_t *a)                                     \
+  {                                                                         \
+    return a->nmem;                                                         \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_destroy(name##_t *a)                                          \
+  {                                                                         \
+    free(a->x);                                                             \
+    a->x = NULL;                                                            \
+    a->nmem = a->capacity = 0;                                              \
+  }
+
+/**
+ * @brief Emit an open addressing hash set <tt>name_t</tt> of <tt>K</tt>.
+ *
+ * Emits <tt>name_init(t, n)</tt>, <tt>name_insert(t, k)</tt>,
+ * <tt>name_find(t, k)</tt>, <tt>name_remove(t, k)</tt>,
+ * <tt>name_map(t, apply)</tt>, <tt>name_size(t)</tt> and
+ * <tt>name_destroy(t)</tt>. Keys are stored in one power-of-two array probed
+ * linearly, which is doubled past a load of 3/4. A removal shifts the following
+ * keys of its run back, so no tombstones are left.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>eq</tt> is not an equivalence, or keys equal under <tt>eq</tt> have
+ * distinct hashes.</dd>
+ * </dl>
+ *
+ * @param[in] name Prefix of the emitted type and functions.
+ * @param[in] K Key type.
+ * @param[in] hash Function or macro of a key returning a <tt>uint64_t</tt>.
+ * @param[in] eq Function or macro of two keys, true when they are equal.
+ */
+# define DEFINE_HASHTAB(name, K, hash, eq)                                  \
+  typedef struct {                                                          \
+    size_t size;                                                            \
+    size_t mask;                                                            \
+    K *k;                                                                   \
+    unsigned char *used;                                                    \
+  } name##_t;                                                               \
+                                                                            \
+  /* empty table of exactly c slots, c a power of two */                  \
+  static inline                                                             \
+  void name##_slots(name##_t *t, size_t c)                                  \
+  {                                                                         \
+    t->size = 0;                                                            \
+    t->mask = c - 1;                                                        \
+    if ( (t->k = (K*)malloc(c * sizeof(K))) == NULL                         \
+         || (t->used = (unsigned char*)calloc(c, 1)) == NULL )              \
+      error(1, errno, "malloc failure");                                    \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_init(name##_t *t, size_t n)                                   \
+  {                                                                         \
+    size_t c = 8;                                                           \
+    while ( c - (c >> 2) < n ) c <<= 1;                                     \
+    name##_slots(t, c);                                                     \
+  }                                                                         \
+                                                                            \
+  /* slot of k, or the empty slot ending its run */                         \
+  static inline                                                             \
+  size_t name##_slot(const name##_t *t, K k)                                \
+  {                                                                         \
+    size_t i = (size_t)(hash(k)) & t->mask;                                 \
+    while ( t->used[i] && !(eq(t->k[i], k)) ) i = (i + 1) & t->mask;        \
+    return i;                                                               \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_destroy(name##_t *t)                                          \
+  {                                                                         \
+    free(t->k);                                                             \
+    free(t->used);                                                          \
+    t->k = NULL;                                                            \
+    t->used = NULL;                                                         \
+    t->size = 0;                                                            \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_grow(name##_t *t)                                             \
+  {                                                                         \
+    name##_t n;                                                             \
+    name##_slots(&n, 2 * (t->mask + 1));                                    \
+    for ( size_t i = 0; i <= t->mask; i++ )                                 \
+      if ( t->used[i] ) {                                                   \
+        size_t j = name##_slot(&n, t->k[i]);                                \
+        n.k[j] = t->k[i];                                                   \
+        n.used[j] = 1;                                                      \
+      }                                                                     \
+    n.size = t->size;                                                       \
+    name##_destroy(t);                                                      \
+    *t = n;                                                                 \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  int name##_insert(name##_t *t, K k)                                       \
+  {                                                                         \
+    size_t i = name##_slot(t, k);                                           \
+    if ( t->used[i] ) return -1;                                            \
+    if ( t->size + 1 > (t->mask + 1) - ((t->mask + 1) >> 2) ) {             \
+      name##_grow(t);                                                       \
+      i = name##_slot(t, k);                                                \
+    }                                                                       \
+    t->k[i] = k;                                                            \
+    t->used[i] = 1;                                                         \
+    t->size++;                                                              \
+    return 1;                                                               \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  K *name##_find(const name##_t *t, K k)                                    \
+  {                                                                         \
+    size_t i = name##_slot(t, k);                                           \
+    return t->used[i] ? t->k + i : NULL;                                    \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  int name##_remove(name##_t *t, K k)                                       \
+  {                                                                         \
+    size_t i = name##_slot(t, k), j = i, h;                                 \
+    if ( !t->used[i] ) return -1;                                           \
+    for ( ;; ) {                                                            \
+      j = (j + 1) & t->mask;                                                \
+      if ( !t->used[j] ) break;                                             \
+      h = (size_t)(hash(t->k[j])) & t->mask;                                \
+      /* move k[j] back unless its home lies cyclically in (i, j] */        \
+      if ( ((j - h) & t->mask) >= ((j - i) & t->mask) ) {                   \
+        t->k[i] = t->k[j];                                                  \
+        i = j;                                                              \
+      }                                                                     \
+    }                                                                       \
+    t->used[i] = 0;                                                         \
+    t->size--;                                                              \
+    return 1;                                                               \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  int name##_map(name##_t *t, int apply(K *k))                              \
+  {                                                                         \
+    for ( size_t i = 0; i <= t->mask; i++ )                                 \
+      if ( t->used[i] && apply(t->k + i) < 0 ) return -1;                   \
+    return 1;                                                               \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  size_t name##_size(const name##_t *t)                                     \
+  {                                                                         \
+    return t->size;                                                         \
+  }
+
+/**
+ * @brief Emit a 4-ary min-heap <tt>name_t</tt> of <tt>T</tt>.
+ *
+ * Emits <tt>name_init(h, capacity)</tt>, <tt>name_push(h, x)</tt>,
+ * <tt>name_pop(h)</tt>, <tt>name_peek(h)</tt>,
+ * <tt>name_heapify(h, x, n)</tt>, which adds <tt>n</tt> elements in linear
+ * time, <tt>name_size(h)</tt> and <tt>name_destroy(h)</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Popping or peeking an empty heap.</dd>
+ * <dd><tt>less</tt> is not a strict weak ordering.</dd>
+ * </dl>
+ *
+ * @param[in] name Prefix of the emitted type and functions.
+ * @param[in] T Element type.
+ * @param[in] less Function or macro of two elements, true when the first is
+ * strictly less.
+ */
+# define DEFINE_HEAP(name, T, less)                                         \
+  typedef struct {                                                          \
+    size_t size;                                                            \
+    size_t capacity;                                                        \
+    T *x;                                                                   \
+  } name##_t;                                                               \
+                                                                            \
+  static inline                                                             \
+  void name##_reserve(name##_t *h, size_t n)                                \
+  {                                                                         \
+    if ( n <= h->capacity ) return;                                         \
+    size_t c = h->capacity < 2 ? n + 1 : (3 * h->capacity) >> 1;            \
+    if ( c < n ) c = n;                                                     \
+    if ( (h->x = (T*)realloc(h->x, c * sizeof(T))) == NULL )                \
+      error(1, errno, "realloc failure");                                   \
+    h->capacity = c;                                                        \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_init(name##_t *h, size_t capacity)                            \
+  {                                                                         \
+    h->size = h->capacity = 0;                                              \
+    h->x = NULL;                                                            \
+    name##_reserve(h, capacity);                                            \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_down(name##_t *h, size_t i)                                   \
+  {                                                                         \
+    T e = h->x[i];                                                          \
+    for ( ;; ) {                                                            \
+      size_t c = 4 * i + 1, m = c, k;                                       \
+      if ( c >= h->size ) break;                                            \
+      for ( k = c + 1; k < c + 4 && k < h->size; k++ )                      \
+        if ( less(h->x[k], h->x[m]) ) m = k;                                \
+      if ( !(less(h->x[m], e)) ) break;                                     \
+      h->x[i] = h->x[m];                                                    \
+      i = m;                                                                \
+    }                                                                       \
+    h->x[i] = e;                                                            \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_push(name##_t *h, T x)                                        \
+  {                                                                         \
+    size_t i = h->size++, p;                                                \
+    name##_reserve(h, h->size);                                             \
+    for ( ; i > 0 && less(x, h->x[p = (i - 1) >> 2]); i = p )               \
+      h->x[i] = h->x[p];                                                    \
+    h->x[i] = x;                                                            \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  T name##_pop(name##_t *h)                                                 \
+  {                                                                         \
+    T x = h->x[0];                                                          \
+    if ( --h->size > 0 ) {                                                  \
+      h->x[0] = h->x[h->size];                                              \
+      name##_down(h, 0);                                                    \
+    }                                                                       \
+    return x;                                                               \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  T *name##_peek(name##_t *h)                                               \
+  {                                                                         \
+    return h->x;                                                            \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_heapify(name##_t *h, const T *x, size_t n)                    \
+  {                                                                         \
+    name##_reserve(h, h->size + n);                                         \
+    memcpy(h->x + h->size, x, n * sizeof(T));                               \
+    h->size += n;                                                           \
+    if ( h->size > 1 )                                                      \
+      for ( size_t i = (h->size - 2) / 4 + 1; i-- > 0; ) name##_down(h, i); \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  size_t name##_size(const name##_t *h)                                     \
+  {                                                                         \
+    return h->size;                                                         \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_destroy(name##_t *h)                                          \
+  {                                                                         \
+    free(h->x);                                                             \
+    h->x = NULL;                                                            \
+    h->size = h->capacity = 0;                                              \
+  }
+
+# endif
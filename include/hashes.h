@@ -0,0 +1,152 @@
+/**
+ * @file hashes.h
+ * @brief Public interface of hash functions
+ *
+ * Seeded 64-bit hash functions for use with the hash tables of this library. The
+ * byte string hash <tt>hashes_bytes</tt> is of the wyhash family: it consumes 48
+ * bytes per round in three independent multiply lanes and needs only a couple of
+ * 64-bit multiplications for strings of at most 16 bytes. The fixed width
+ * functions <tt>hashes_u32</tt>, <tt>hashes_u64</tt> and <tt>hashes_u128</tt>
+ * return the same value as <tt>hashes_bytes</tt> on the bytes of their argument,
+ * but skip its branching on length.
+ *
+ * The functions with suffix <tt>_r</tt> have the signature of
+ * <tt>hashtabs_hash_r</tt>, <tt>dhashtabs_hash_r</tt> and
+ * <tt>flathashtabs_hash_r</tt>, and may be passed directly to those hash
+ * tables.
+ *
+ * @warning The hashes are not cryptographic. They must not be relied upon to
+ * resist collisions chosen by an adversary who knows the seed.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_HASHES_H
+# define INCLUDED_HASHES_H
+
+# include <stdint.h>
+# include <stddef.h>
+
+/**
+ * @brief Argument of <tt>hashes_bytes_r</tt>.
+ */
+typedef struct {
+  size_t n;      ///< number of bytes hashed
+  uint64_t seed; ///< seed of the hash function
+} hashes_key_t;
+
+/**
+ * @brief Hash function for byte strings.
+ *
+ * Hash function for byte strings. Distinct seeds give independent looking hash
+ * functions.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>If the size parameter is larger than the number of bytes of <tt>x</tt>,
+ * the function reads past the end of <tt>x</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] x Pointer to bytes being hashed.
+ * @param[in] n Number of bytes being hashed.
+ * @param[in] seed Seed of the hash function.
+ *
+ * @return Hash value of the <tt>n</tt> bytes at <tt>x</tt>.
+ */
+extern uint64_t hashes_bytes(const void *x, size_t n, uint64_t seed);
+
+/**
+ * @brief Hash function for 32-bit unsigned integers.
+ *
+ * Equal to <tt>hashes_bytes(&x, 4, seed)</tt>.
+ *
+ * @param[in] x Integer being hashed.
+ * @param[in] seed Seed of the hash function.
+ *
+ * @return Hash value of <tt>x</tt>.
+ */
+extern uint64_t hashes_u32(uint32_t x, uint64_t seed);
+
+/**
+ * @brief Hash function for 64-bit unsigned integers.
+ *
+ * Equal to <tt>hashes_bytes(&x, 8, seed)</tt>.
+ *
+ * @param[in] x Integer being hashed.
+ * @param[in] seed Seed of the hash function.
+ *
+ * @return Hash value of <tt>x</tt>.
+ */
+extern uint64_t hashes_u64(uint64_t x, uint64_t seed);
+
+/**
+ * @brief Hash function for 16-byte keys.
+ *
+ * Equal to <tt>hashes_bytes(x, 16, seed)</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>x</tt> points to fewer than 16 bytes.</dd>
+ * </dl>
+ *
+ * @param[in] x Pointer to the 16 bytes being hashed.
+ * @param[in] seed Seed of the hash function.
+ *
+ * @return Hash value of the 16 bytes at <tt>x</tt>.
+ */
+extern uint64_t hashes_u128(const void *x, uint64_t seed);
+
+/**
+ * @brief Reentrant hash function for byte strings.
+ *
+ * Calls <tt>hashes_bytes</tt> with the length and seed held by <tt>key</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>key</tt> does not point to a <tt>hashes_key_t</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] x Pointer to bytes being hashed.
+ * @param[in] key Pointer to <tt>hashes_key_t</tt> holding length and seed.
+ *
+ * @return Hash value of <tt>x</tt>.
+ */
+extern uint64_t hashes_bytes_r(const void *x, const void *key);
+
+/**
+ * @brief Reentrant hash function for 32-bit unsigned integers.
+ *
+ * Calls <tt>hashes_u32</tt> on the integer pointed to by <tt>x</tt>.
+ *
+ * @param[in] x Pointer to <tt>uint32_t</tt> being hashed.
+ * @param[in] seed Pointer to <tt>uint64_t</tt> seed, or <tt>NULL</tt> for seed 0.
+ *
+ * @return Hash value of <tt>*x</tt>.
+ */
+extern uint64_t hashes_u32_r(const void *x, const void *seed);
+
+/**
+ * @brief Reentrant hash function for 64-bit unsigned integers.
+ *
+ * Calls <tt>hashes_u64</tt> on the integer pointed to by <tt>x</tt>.
+ *
+ * @param[in] x Pointer to <tt>uint64_t</tt> being hashed.
+ * @param[in] seed Pointer to <tt>uint64_t</tt> seed, or <tt>NULL</tt> for seed 0.
+ *
+ * @return Hash value of <tt>*x</tt>.
+ */
+extern uint64_t hashes_u64_r(const void *x, const void *seed);
+
+/**
+ * @brief Reentrant hash function for 16-byte keys.
+ *
+ * Calls <tt>hashes_u128</tt> on <tt>x</tt>.
+ *
+ * @param[in] x Pointer to the 16 bytes being hashed.
+ * @param[in] seed Pointer to <tt>uint64_t</tt> seed, or <tt>NULL</tt> for seed 0.
+ *
+ * @return Hash value of the 16 bytes at <tt>x</tt>.
+ */
+extern uint64_t hashes_u128_r(const void *x, const void *seed);
+
+# endif
@@ -9,12 +9,23 @@
  * <tt>hashtabs_free</tt> only deallocates the links between data created by
  * envoking <tt>hashtabs_new</tt> and <tt>hashtabs_instert</tt>.
  *
- * The <tt>queues_t</tt> data structure of this same library is used for the
- * hash tables' buckets.
+ * Each bucket is a chain of links which also store the hash value of their data.
+ * Growing and rehashing the table move the links by their stored hash values
+ * without calling the user hashing function again, and a search only calls the
+ * user compare function on links whose stored hash value is equal to that of the
+ * data being looked for.
  *
  * Repetitions are not allowed, and data must be linearly ordered.
  *
- * The <tt>hashtabs_t</tt> class is implemented as an opaque pointer.
+ * The hash table grows on its own. Once the number of elements exceeds
+ * <tt>hashtabs_setmaxload</tt> elements per bucket, a bucket array of the next
+ * prime length is allocated and the old buckets are moved over a few at a time by
+ * each subsequent insert, find and remove. No single operation pays for moving
+ * the whole table.
+ *
+ * The <tt>hashtabs_t</tt> class is implemented as an opaque pointer. With
+ * <tt>CONTAINERS_INLINE</tt> defined, <tt>hashtabs_size</tt> is
+ * <tt>static inline</tt>.
  *
  * @warning This class is meant to be used in time restricted settings. As such,
  * some runtime errors, such as out-of-bounds-type errors, are note explicitly
@@ -30,8 +41,43 @@
 # include <stdlib.h>
 # include <stddef.h>
 
+# include "allocators.h"
+# include "configs.h"
+# include "arrays.h"
+# include "blooms.h"
+# include "frozenhashtabs.h"
+# include "workers.h"
+
+/**
+ * @brief Default maximum average number of elements per bucket before a hash
+ * table starts growing.
+ */
+# define HASHTABS_MAXLOAD 2
+
 typedef struct hashtabs_t* hashtabs_t;
 
+/**
+ * @brief Number of entries of the bucket occupancy histogram of
+ * <tt>hashtabs_stats_t</tt>.
+ */
+# define HASHTABS_HISTOGRAM 8
+
+/**
+ * @brief Statistics of a hash table, filled in by <tt>hashtabs_stats</tt>.
+ */
+typedef struct {
+  size_t buckets;                       ///< number of buckets
+  size_t empty;                         ///< number of empty buckets
+  size_t max_chain;                     ///< length of the longest bucket
+  double mean_chain;                    ///< mean length of nonempty buckets
+  size_t histogram[HASHTABS_HISTOGRAM]; ///< buckets by number of elements
+  size_t bytes;                         ///< bytes allocated by the hash table
+  size_t inserts;                       ///< number of inserts
+  size_t insert_cmps;                   ///< compare calls made by inserts
+  size_t finds;                         ///< number of finds and removes
+  size_t find_cmps;                     ///< compare calls made by finds
+} hashtabs_stats_t;
+
 /**
  * @brief User provided compare function. Must provide a linear ordering of the
  * data.
@@ -59,7 +105,9 @@ typedef uint64_t (*hashtabs_hash_r)(const void*, const void*);
  * integer type.
  *
  * Standard hash function for dynamic arrays of <tt>uint32_t</tt> unsigned
- * integer type. Implements a version from the Boost library.
+ * integer type. Implements a version from the Boost library. The length and the
+ * seed are both read from <tt>_n</tt>; see <tt>hashes_bytes_r</tt> of
+ * <tt>hashes.h</tt> for a faster hash with a separate seed.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -100,6 +148,140 @@ extern hashtabs_t hashtabs_new(hashtabs_data_cmp cmp, hashtabs_data_cmp_r cmp_r,
                                hashtabs_hash hash, hashtabs_hash_r hash_r,
                                size_t n);
 
+/**
+ * @brief Instantiates a <tt>hashtabs_t</tt> instance with a user allocator.
+ *
+ * As <tt>hashtabs_new</tt>, but the hash table object, its bucket arrays and its
+ * links are allocated and freed through <tt>al</tt>. Copies made by
+ * <tt>hashtabs_rehash</tt> use the same allocator.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>hashtabs_data_cmp</tt> and <tt>hashtabs_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>hashtabs_hash</tt> and <tt>hashtabs_hash_r_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] al Allocator of the hash table.
+ *
+ * @return Instance of hash table object.
+ */
+extern hashtabs_t hashtabs_new_alloc(hashtabs_data_cmp cmp,
+                                     hashtabs_data_cmp_r cmp_r,
+                                     hashtabs_hash hash, hashtabs_hash_r hash_r,
+                                     size_t n, const allocators_t *al);
+
+/**
+ * @brief Instantiates a <tt>hashtabs_t</tt> instance whose links are pooled.
+ *
+ * As <tt>hashtabs_new</tt>, but the links of the hash table are allocated from a
+ * private <tt>pools_t</tt> slab allocator. <tt>hashtabs_free</tt> then frees the
+ * links one slab at a time instead of one link at a time, and links of removed
+ * data are reused by later inserts. Copies made by <tt>hashtabs_rehash</tt> are
+ * pooled as well.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>hashtabs_data_cmp</tt> and <tt>hashtabs_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>hashtabs_hash</tt> and <tt>hashtabs_hash_r_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ *
+ * @return Instance of hash table object.
+ */
+extern hashtabs_t hashtabs_new_pooled(hashtabs_data_cmp cmp,
+                                      hashtabs_data_cmp_r cmp_r,
+                                      hashtabs_hash hash, hashtabs_hash_r hash_r,
+                                      size_t n);
+
+# if CONTAINERS_THREADS
+/**
+ * @brief Instantiates a <tt>hashtabs_t</tt> instance holding the elements of an
+ * array.
+ *
+ * Builds, on the threads of the worker pool <tt>w</tt>, the table holding
+ * pointers to each element of <tt>a</tt>, as if they were inserted in order
+ * with <tt>hashtabs_insert</tt>. The table is sized for the elements up front,
+ * so that it does not grow while being built. The elements are hashed, and
+ * partitioned by bucket, by a few chunks of the array per thread; the buckets
+ * of each partition, a range of buckets no other partition shares, are then
+ * linked by one thread, without locking. Elements equal to an earlier one are
+ * left out of the table. Available only if the library is configured with
+ * threads.
+ *
+ * The table points into the array, which must not be resized or freed while
+ * the table is in use.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>hashtabs_data_cmp</tt> and <tt>hashtabs_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>hashtabs_hash</tt> and <tt>hashtabs_hash_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * <dd>User provided functions are not thread safe.</dd>
+ * <dd>Calling <tt>hashtabs_new_bulk</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] a Array object of the elements.
+ * @param[in] w Worker pool building the table.
+ *
+ * @return Instance of hash table object.
+ */
+extern hashtabs_t hashtabs_new_bulk(hashtabs_data_cmp cmp,
+                                    hashtabs_data_cmp_r cmp_r,
+                                    hashtabs_hash hash, hashtabs_hash_r hash_r,
+                                    arrays_t a, workers_t w);
+
+/**
+ * @brief Instantiates a <tt>hashtabs_t</tt> instance holding the elements of an
+ * array.
+ *
+ * Reentrant version of <tt>hashtabs_new_bulk</tt>, calling <tt>hash_r</tt> and
+ * <tt>cmp_r</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Either <tt>hashtabs_data_cmp_r</tt> or <tt>hashtabs_hash_r</tt> argument
+ * is <tt>NULL</tt>.</dd>
+ * <dd>User provided functions are not thread safe.</dd>
+ * <dd>Calling <tt>hashtabs_new_bulk_r</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] a Array object of the elements.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ * @param[in] w Worker pool building the table.
+ *
+ * @return Instance of hash table object.
+ */
+extern hashtabs_t hashtabs_new_bulk_r(hashtabs_data_cmp cmp,
+                                      hashtabs_data_cmp_r cmp_r,
+                                      hashtabs_hash hash, hashtabs_hash_r hash_r,
+                                      arrays_t a, const void *hash_arg,
+                                      void *queue_arg, workers_t w);
+# endif
+
 /**
  * @brief Inserts pointer to data object into hash table object.
  *
@@ -140,13 +322,60 @@ extern void hashtabs_insert(hashtabs_t t, const void *x);
 extern void hashtabs_insert_r(hashtabs_t t, const void *x,
                               const void *hash_arg, void *queue_arg);
 
+/**
+ * @brief Finds data object in hash table object, inserting it if absent.
+ *
+ * A single probe of the hash table either finds data equal to <tt>x</tt> or
+ * inserts <tt>x</tt>, so that a find followed by an insert costs one traversal.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_find_or_insert</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched and added to.
+ * @param[in] x Pointer to data being searched for and added.
+ * @param[out] inserted Set to 1 if <tt>x</tt> was inserted and 0 if it was
+ * found, unless <tt>NULL</tt>.
+ *
+ * @return Pointer to the data in the hash table, <tt>x</tt> itself if inserted.
+ */
+extern void *hashtabs_find_or_insert(hashtabs_t t, const void *x,
+                                     int *inserted);
+
+/**
+ * @brief Finds data object in hash table object, inserting it if absent.
+ *
+ * Reentrant version of <tt>hashtabs_find_or_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_find_or_insert_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched and added to.
+ * @param[in] x Pointer to data being searched for and added.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ * @param[out] inserted Set to 1 if <tt>x</tt> was inserted and 0 if it was
+ * found, unless <tt>NULL</tt>.
+ *
+ * @return Pointer to the data in the hash table, <tt>x</tt> itself if inserted.
+ */
+extern void *hashtabs_find_or_insert_r(hashtabs_t t, const void *x,
+                                       const void *hash_arg, void *queue_arg,
+                                       int *inserted);
+
 /**
  * @brief Remove pointer to data object in hash table object (if present) equal in
  * value to the data object parameter provided by the user.
  *
- * The hash table object is searched for data equal in value to the user provided
- * data object. If found, the pointer is removed from the hash table and returned
- * to the user. If not found, <tt>NULL</tt> is returned.
+ * The data object is hashed and only the corresponding bucket of the hash table
+ * object is searched for data equal in value to the user provided data object. If
+ * found, the pointer is removed from the hash table and returned to the user. If
+ * not found, <tt>NULL</tt> is returned.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -173,18 +402,65 @@ extern void *hashtabs_remove(hashtabs_t t, const void *x);
  *
  * @param[in] t Hash table object being altered.
  * @param[in] x Pointer to data object being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
  * @param[in] queue_arg Argument to user provided reentrant compare function.
  *
  * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
  */
-extern void *hashtabs_remove_r(hashtabs_t t, const void *x, void *queue_arg);
+extern void *hashtabs_remove_r(hashtabs_t t, const void *x,
+                               const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Remove every pointer to data object of hash table object passing a
+ * predicate.
+ *
+ * The nonnull buckets are walked once, by the occupancy sets, and every link
+ * whose data object <tt>pred</tt> returns a positive <tt>int</tt> for is
+ * unlinked and released, the pointer first being handed to <tt>dispose</tt>
+ * unless it is <tt>NULL</tt>. Nothing is hashed or compared, so removing any
+ * number of elements costs one pass over the table. An attached filter keeps
+ * the hash values of removed data, as for <tt>hashtabs_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>pred</tt> or <tt>dispose</tt> alter the hash table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t hashtabs_remove_if(hashtabs_t t, int pred(const void *x),
+                                 void dispose(void *x));
+
+/**
+ * @brief Remove every pointer to data object of hash table object passing a
+ * predicate.
+ *
+ * Reentrant version of <tt>hashtabs_remove_if</tt>.
+ *
+ * @param[in] t Hash table object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ * @param[in] y Argument to <tt>pred</tt> and <tt>dispose</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t hashtabs_remove_if_r(hashtabs_t t,
+                                   int pred(const void *x, void *y),
+                                   void dispose(void *x, void *y), void *y);
 
 /**
  * @brief Check if data equal to user provided data object is contained in hash
  * table object.
  *
  * Check if data equal to user provided data object is contained in hash table
- * object. Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
+ * object. The data object is hashed and only the corresponding bucket is
+ * searched. Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -215,11 +491,165 @@ extern void *hashtabs_find(hashtabs_t t, const void *x);
  *
  * @param[in] t Hash table object being searched.
  * @param[in] x Data whose membership is being checked.
- * @param[in] y Argument to user provided reentrant compare function.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
  *
  * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
  */
-extern void *hashtabs_find_r(hashtabs_t t, const void *x, void *y);
+extern void *hashtabs_find_r(hashtabs_t t, const void *x,
+                             const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Inserts pointers to an array of data objects into hash table object.
+ *
+ * Same as calling <tt>hashtabs_insert</tt> on <tt>x[0]</tt>, ...,
+ * <tt>x[n-1]</tt> in order. The data objects are handled in small blocks: every
+ * data object of a block is hashed and its bucket prefetched before any of them is
+ * inserted, so that the cache misses of independent data objects overlap.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_insert_batch</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The array <tt>x</tt> has fewer than <tt>n</tt> elements.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Array of pointers to data being added to hash table object.
+ * @param[in] n Number of elements of <tt>x</tt>.
+ */
+extern void hashtabs_insert_batch(hashtabs_t t, const void *const *x, size_t n);
+
+/**
+ * @brief Inserts pointers to an array of data objects into hash table object.
+ *
+ * Reentrant version of <tt>hashtabs_insert_batch</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_insert_batch_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The array <tt>x</tt> has fewer than <tt>n</tt> elements.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Array of pointers to data being added to hash table object.
+ * @param[in] n Number of elements of <tt>x</tt>.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ */
+extern void hashtabs_insert_batch_r(hashtabs_t t, const void *const *x, size_t n,
+                                    const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Look up an array of data objects in hash table object.
+ *
+ * Same as setting <tt>out[i]</tt> to <tt>hashtabs_find(t, x[i])</tt> for every
+ * <tt>i</tt> less than <tt>n</tt>. As in <tt>hashtabs_insert_batch</tt>, the
+ * buckets of a block of data objects are prefetched before any of them is
+ * searched.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_find_batch</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The arrays <tt>x</tt> or <tt>out</tt> have fewer than <tt>n</tt>
+ * elements.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Array of data whose membership is being checked.
+ * @param[out] out Array receiving the pointer found for each data object.
+ * @param[in] n Number of elements of <tt>x</tt>.
+ *
+ * @return Number of data objects found.
+ */
+extern size_t hashtabs_find_batch(hashtabs_t t, const void *const *x, void **out,
+                                  size_t n);
+
+/**
+ * @brief Look up an array of data objects in hash table object.
+ *
+ * Reentrant version of <tt>hashtabs_find_batch</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_find_batch_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The arrays <tt>x</tt> or <tt>out</tt> have fewer than <tt>n</tt>
+ * elements.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Array of data whose membership is being checked.
+ * @param[out] out Array receiving the pointer found for each data object.
+ * @param[in] n Number of elements of <tt>x</tt>.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Number of data objects found.
+ */
+extern size_t hashtabs_find_batch_r(hashtabs_t t, const void *const *x,
+                                    void **out, size_t n, const void *hash_arg,
+                                    void *queue_arg);
+
+/**
+ * @brief Look up an array of keys in hash table object, interleaving the
+ * lookups.
+ *
+ * Sets <tt>out[i]</tt> to the data equal to element <tt>i</tt> of <tt>a</tt>,
+ * or <tt>NULL</tt> if there is none. Up to <tt>width</tt> lookups are kept in
+ * flight, each a small state machine: a step reads the bucket or link
+ * prefetched by the previous step of that lookup, prefetches the next one, and
+ * passes on to the next lookup, so that the memory latencies of the lookups
+ * overlap instead of adding up. A lookup which ends is replaced by the next
+ * key. A <tt>width</tt> of 0 keeps a default number of lookups in flight.
+ *
+ * Unlike the other finds, these lookups do not move buckets of a growing hash
+ * table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_find_interleaved</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>The array <tt>out</tt> has fewer elements than <tt>a</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] a Array of keys whose membership is being checked.
+ * @param[out] out Array receiving the pointer found for each key.
+ * @param[in] width Number of lookups in flight, or 0.
+ *
+ * @return Number of keys found.
+ */
+extern size_t hashtabs_find_interleaved(hashtabs_t t, arrays_t a, void **out,
+                                        size_t width);
+
+/**
+ * @brief Look up an array of keys in hash table object, interleaving the
+ * lookups.
+ *
+ * Reentrant version of <tt>hashtabs_find_interleaved</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_find_interleaved_r</tt> on a <tt>NULL</tt> hash
+ * table object.</dd>
+ * <dd>The array <tt>out</tt> has fewer elements than <tt>a</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] a Array of keys whose membership is being checked.
+ * @param[out] out Array receiving the pointer found for each key.
+ * @param[in] width Number of lookups in flight, or 0.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Number of keys found.
+ */
+extern size_t hashtabs_find_interleaved_r(hashtabs_t t, arrays_t a, void **out,
+                                          size_t width, const void *hash_arg,
+                                          void *queue_arg);
 
 /**
  * @brief Apply function to every member of hash table object.
@@ -260,6 +690,227 @@ extern int hashtabs_map(hashtabs_t t, int apply(void **x));
 extern int hashtabs_map_r(hashtabs_t t,
                           int apply(void **x, void *queue_arg), void *queue_arg);
 
+# if CONTAINERS_THREADS
+/**
+ * @brief Apply function to every member of hash table object in parallel.
+ *
+ * The buckets of the table are split into ranges, which are visited by the
+ * threads of the worker pool <tt>w</tt> with cursors of
+ * <tt>hashtabs_iterrange</tt>, so that members are visited in no particular
+ * order and <tt>apply</tt> runs concurrently on distinct members. If an
+ * application returns negative, the pool is stopped as by
+ * <tt>arrays_map_parallel</tt>, and <tt>w</tt> must be freed and not reused.
+ * Available only if the library is configured with threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_map_parallel</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>hashtabs_map_parallel</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] w Worker pool running the applications.
+ *
+ * @return 1 upon success, -1 if some application returned negative.
+ */
+extern int hashtabs_map_parallel(hashtabs_t t, int apply(void **x),
+                                 workers_t w);
+
+/**
+ * @brief Apply function to every member of hash table object in parallel.
+ *
+ * Reentrant version of <tt>hashtabs_map_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_map_parallel_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined function is <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>hashtabs_map_parallel_r</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] y Argument to reentrant user defined function.
+ * @param[in] w Worker pool running the applications.
+ *
+ * @return 1 upon success, -1 if some application returned negative.
+ */
+extern int hashtabs_map_parallel_r(hashtabs_t t,
+                                   int apply(void **x, void *y), void *y,
+                                   workers_t w);
+
+/**
+ * @brief Reduce hash table in parallel.
+ *
+ * The buckets of the table are split between the threads of the worker pool
+ * <tt>w</tt> as by <tt>hashtabs_map_parallel</tt>, each thread folding the
+ * members of its buckets into an accumulator of its own, merged into
+ * <tt>*acc</tt> at the end, as by <tt>arrays_reduce_parallel</tt>. Available
+ * only if the library is configured with threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_reduce_parallel</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined functions are <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>hashtabs_reduce_parallel</tt> from a task of <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being reduced.
+ * @param[in] fold User defined function folding member <tt>x</tt> into
+ * accumulator <tt>acc</tt>.
+ * @param[in] merge User defined function merging accumulator <tt>part</tt>
+ * into accumulator <tt>acc</tt>.
+ * @param[in,out] acc Accumulator, holding the identity of <tt>merge</tt>.
+ * @param[in] size Size of accumulator.
+ * @param[in] w Worker pool running the folds.
+ *
+ * @return 1 upon success, -1 if some fold returned negative.
+ */
+extern int hashtabs_reduce_parallel(hashtabs_t t,
+                                    int fold(void *acc, const void *x),
+                                    void merge(void *acc, const void *part),
+                                    void *acc, size_t size, workers_t w);
+
+/**
+ * @brief Reduce hash table in parallel.
+ *
+ * Reentrant version of <tt>hashtabs_reduce_parallel</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_reduce_parallel_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd>User defined functions are <tt>NULL</tt> or not thread safe.</dd>
+ * <dd>Calling <tt>hashtabs_reduce_parallel_r</tt> from a task of
+ * <tt>w</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being reduced.
+ * @param[in] fold User defined function folding member <tt>x</tt> into
+ * accumulator <tt>acc</tt>.
+ * @param[in] merge User defined function merging accumulator <tt>part</tt>
+ * into accumulator <tt>acc</tt>.
+ * @param[in,out] acc Accumulator, holding the identity of <tt>merge</tt>.
+ * @param[in] size Size of accumulator.
+ * @param[in] y Argument to reentrant user defined functions.
+ * @param[in] w Worker pool running the folds.
+ *
+ * @return 1 upon success, -1 if some fold returned negative.
+ */
+extern int hashtabs_reduce_parallel_r(hashtabs_t t,
+                                      int fold(void *acc, const void *x,
+                                               void *y),
+                                      void merge(void *acc, const void *part,
+                                                 void *y),
+                                      void *acc, size_t size, void *y,
+                                      workers_t w);
+# endif
+
+/**
+ * @brief Cursor over the elements of a hash table, in bucket order.
+ *
+ * A cursor is started by <tt>hashtabs_iterinit</tt> and advanced by
+ * <tt>hashtabs_iternext</tt>; unlike <tt>hashtabs_map</tt>, the loop body is the
+ * user's own code, and two tables may be walked together, as in a join probing
+ * one table with the elements of another, without copying either out.
+ *
+ * <tt>hashtabs_iterinit</tt> ends any migration of buckets in progress, so that
+ * finds no longer move elements. A cursor then stays valid across finds and
+ * across <tt>hashtabs_find_batch</tt>; inserts, removes, resizes and clears
+ * invalidate it.
+ */
+typedef struct {
+  void *x;       ///< element at cursor
+  void *node;    ///< link of element at cursor, led by the pointer to it
+  hashtabs_t t;  ///< hash table visited
+  size_t bucket; ///< bucket of element at cursor
+  size_t end;    ///< one past the last bucket visited
+} hashtabs_iter_t;
+
+/**
+ * @brief Starts cursor at first element of hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_iterinit</tt> on a <tt>NULL</tt> hash table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being visited.
+ * @param[out] it Cursor being started.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the hash
+ * table is empty.
+ */
+extern int hashtabs_iterinit(hashtabs_t t, hashtabs_iter_t *it);
+
+/**
+ * @brief Starts cursor at first element of a range of buckets of hash table.
+ *
+ * The cursor visits the elements of buckets <tt>lo</tt> to <tt>hi - 1</tt>
+ * only, so that the buckets of a table, from 0 to <tt>hashtabs_capacity</tt>,
+ * may be split between threads. Like <tt>hashtabs_iterinit</tt>, ends any
+ * migration of buckets in progress; several threads may start cursors on the
+ * same table at once when no migration is in progress, as after a call to
+ * <tt>hashtabs_iterinit</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_iterrange</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd><tt>hi</tt> is greater than <tt>hashtabs_capacity(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being visited.
+ * @param[out] it Cursor being started.
+ * @param[in] lo First bucket visited.
+ * @param[in] hi One past the last bucket visited.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the
+ * buckets are empty.
+ */
+extern int hashtabs_iterrange(hashtabs_t t, hashtabs_iter_t *it, size_t lo,
+                              size_t hi);
+
+/**
+ * @brief Advances cursor to the next element of hash table.
+ *
+ * Empty buckets are skipped a setword of the occupancy set at a time.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the last element of the hash table.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor being advanced.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 once every
+ * element has been visited.
+ */
+extern int hashtabs_iternext(hashtabs_iter_t *it);
+
+/**
+ * @brief Element at cursor.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the last element of the hash table.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor of hash table.
+ *
+ * @return Pointer to the data object at the cursor.
+ */
+static inline
+void *hashtabs_iterget(const hashtabs_iter_t *it)
+{
+  return it->x;
+}
+
 /**
  * @brief Free data allocated for the shallow hash-table-type associations.
  *
@@ -271,10 +922,30 @@ extern int hashtabs_map_r(hashtabs_t t,
  */
 extern void hashtabs_free(hashtabs_t *t);
 
+/**
+ * @brief Remove every element of hash table.
+ *
+ * The links of the hash table are freed, and the bucket array is kept, so that
+ * the table can be filled again to its current capacity without allocating
+ * buckets. A table of <tt>hashtabs_new_pooled</tt> keeps its pool as well and
+ * releases every link in one step, so that no link is allocated or freed
+ * by refilling it. A growth in progress is finished by dropping the old
+ * buckets. The data pointed to by the table is not freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_clear</tt> on a <tt>NULL</tt> hash table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being cleared.
+ */
+extern void hashtabs_clear(hashtabs_t t);
+
 /**
  * @brief Number of spaces allocated for hash table buckets.
  *
- * Number of spaces allocated for hash table buckets.
+ * Number of spaces allocated for hash table buckets. While the table is growing,
+ * this is the length of the new bucket array.
  *
  * <dl>
  * <dt><strong>Unchecked Runtime Errors</strong></dt>
@@ -293,12 +964,9 @@ extern size_t hashtabs_capacity(hashtabs_t t);
  *
  * Resize the buckets array to the next prime length which is at least 1.5 times
  * larger than the current prime length. If the next such prime is too large, then
- * the array is resized simply to <tt>SIZE_MAX</tt>.
- *
- * <dl>
- * <dt><strong>Unchecked Runtime Errors</strong></dt>
- * <dd>The <tt>hash_data_cmp_r</tt> field is <tt>NULL</tt>.</dd>
- * </dl>
+ * the array is resized simply to <tt>SIZE_MAX</tt>. The stored hash values are
+ * reused, so neither the user hashing function nor the user compare function is
+ * called.
  *
  * @param[in] t Hash table being rehashed.
  *
@@ -310,12 +978,8 @@ extern hashtabs_t hashtabs_rehash(hashtabs_t t);
 /**
  * @brief Rehash array to the next prime length.
  *
- * Reentrant version of <tt>hashtabs_rehash</tt>.
- *
- * <dl>
- * <dt><strong>Unchecked Runtime Errors</strong></dt>
- * <dd>The <tt>hash_data_cmp_r</tt> field is <tt>NULL</tt>.</dd>
- * </dl>
+ * Reentrant version of <tt>hashtabs_rehash</tt>. Since no user function is
+ * called, the arguments <tt>hash_arg</tt> and <tt>queue_arg</tt> are unused.
  *
  * @param[in] t Hash table being rehashed.
  * @param[in] hash_arg Argument to user defined reentrant hash function.
@@ -326,6 +990,26 @@ extern hashtabs_t hashtabs_rehash(hashtabs_t t);
  */
 extern hashtabs_t hashtabs_rehash_r(hashtabs_t t, void *hash_arg, void *queue_arg);
 
+/**
+ * @brief Resize bucket array in place.
+ *
+ * The links of the hash table are moved into a new bucket array of the first
+ * prime length larger than <tt>n</tt>, which replaces the old bucket array. No
+ * links are allocated and the stored hash values are reused, so unlike
+ * <tt>hashtabs_rehash</tt> the memory required is only that of the two bucket
+ * arrays. Any migration in progress is completed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_resize</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table being resized.
+ * @param[in] n Hint for the number of elements.
+ */
+extern void hashtabs_resize(hashtabs_t t, size_t n);
+
 /**
  * @brief Number of elements in hash table.
  *
@@ -340,7 +1024,36 @@ extern hashtabs_t hashtabs_rehash_r(hashtabs_t t, void *hash_arg, void *queue_ar
  *
  * @return Number of members of the hash table.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+size_t hashtabs_size(hashtabs_t t)
+{
+  return *(const size_t*)(void*)t;
+}
+# else
 extern size_t hashtabs_size(hashtabs_t t);
+# endif
+
+/**
+ * @brief Number of bytes allocated for hash table.
+ *
+ * Number of bytes allocated for the hash table object, its bucket arrays, their
+ * occupancy sets and its links, or the slabs of its pool of links. If
+ * <tt>payload</tt> is not <tt>NULL</tt>, it is set to the number of those bytes
+ * holding the pointers to data; the rest is overhead.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_memory_usage</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ * @param[out] payload Bytes of payload, if not <tt>NULL</tt>.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t hashtabs_memory_usage(hashtabs_t t, size_t *payload);
 
 /**
  * @brief Load factor of hash table.
@@ -362,6 +1075,112 @@ extern size_t hashtabs_size(hashtabs_t t);
  */
 extern size_t hashtabs_loadfactor(hashtabs_t t);
 
+/**
+ * @brief Set the load at which the hash table grows.
+ *
+ * When an insert leaves more than <tt>maxload</tt> elements per bucket on
+ * average, the hash table begins migrating to the next prime length. The
+ * migration is spread over the following inserts, finds and removes. Tables
+ * start with a maximum load of <tt>HASHTABS_MAXLOAD</tt>. A value of 0 disables
+ * automatic growth.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_setmaxload</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being configured.
+ * @param[in] maxload Average number of elements per bucket triggering growth.
+ */
+extern void hashtabs_setmaxload(hashtabs_t t, size_t maxload);
+
+/**
+ * @brief Attach filter to hash table.
+ *
+ * The hash values of the elements of the hash table are added to <tt>f</tt>,
+ * as are those of every element inserted afterwards. Finds and removes of data
+ * whose hash value is surely not in <tt>f</tt> then return <tt>NULL</tt>
+ * without touching the buckets. Removed elements stay in <tt>f</tt>, so that
+ * after many removes the filter may be cleared and attached again. A
+ * <tt>NULL</tt> <tt>f</tt> detaches the filter. The filter is not freed by the
+ * hash table, and is shared by the tables made by <tt>hashtabs_rehash</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_setfilter</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being configured.
+ * @param[in] f Filter object, or <tt>NULL</tt>.
+ */
+extern void hashtabs_setfilter(hashtabs_t t, blooms_t f);
+
+/**
+ * @brief Freeze hash table into an immutable table.
+ *
+ * The <tt>size</tt> bytes of each data object pointed to by the hash table are
+ * copied into a new <tt>fhashtabs_t</tt> of the functions and allocator of
+ * <tt>t</tt>, by their stored hash values, so that no data is hashed again.
+ * Finds of the frozen table hand back the copies. The hash table is left as
+ * is, and the frozen table needs to be freed by a call to
+ * <tt>fhashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_freeze</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * <dd><tt>size</tt> is not the size of the data objects.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being frozen.
+ * @param[in] size Size of data objects.
+ *
+ * @return Instance of frozen table object. <tt>NULL</tt>, with <tt>errno</tt>
+ * set to <tt>EINVAL</tt>, if data objects have equal hash values.
+ */
+extern fhashtabs_t hashtabs_freeze(hashtabs_t t, size_t size);
+
+/**
+ * @brief Check whether a hash table is migrating to a larger bucket array.
+ *
+ * Check whether a hash table is migrating to a larger bucket array.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_growing</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return True if old buckets remain to be migrated. False otherwise.
+ */
+extern int hashtabs_growing(hashtabs_t t);
+
+/**
+ * @brief Statistics of hash table.
+ *
+ * Fill in <tt>s</tt> with the occupancy of the buckets of the hash table:
+ * <tt>histogram[i]</tt> is the number of buckets holding <tt>i</tt> elements,
+ * its last entry counting every bucket holding more. A long longest bucket next
+ * to a small mean suggests a poor hash function, while a large mean with few
+ * empty buckets suggests an undersized table.
+ *
+ * The operation counters are only maintained if the library is configured with
+ * <tt>--enable-counters</tt>, and are 0 otherwise.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hashtabs_stats</tt> on a <tt>NULL</tt> hash table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ * @param[out] s Statistics of <tt>t</tt>.
+ */
+extern void hashtabs_stats(hashtabs_t t, hashtabs_stats_t *s);
+
 /**
  * @brief Swap opaque pointers for hash tables.
  *
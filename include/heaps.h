@@ -0,0 +1,425 @@
+/**
+ * @file heaps.h
+ * @brief Public interface of <tt>heaps_t</tt> class
+ *
+ * The <tt>heaps_t</tt> object instantiates a priority queue of pointers to
+ * already existing data, held in a <tt>HEAPS_ARITY</tt>-ary min-heap stored in
+ * one contiguous array. A push and a pop cost O(log n) compares, against the
+ * O(n) sorted insert of <tt>queues_t</tt>. The four children of a node are
+ * adjacent in memory, so that a pop touches about half the cache lines of a
+ * binary heap.
+ *
+ * Each push returns a <tt>heaps_handle_t</tt> naming the pushed data until it
+ * leaves the heap. After the key of the data is decreased in place, a call to
+ * <tt>heaps_decrease</tt> with the handle restores the heap order, as needed
+ * by Dijkstra and Prim. The handle of data that has left the heap may be
+ * reissued by a later push.
+ *
+ * The user is responsible for allocating and deallocating the data. The routine
+ * <tt>heaps_free</tt> only deallocates the heap. Repetitions are allowed; ties
+ * are popped in no particular order.
+ *
+ * The <tt>heaps_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_HEAPS_H
+# define INCLUDED_HEAPS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Number of children of each node of the heap.
+ */
+# define HEAPS_ARITY 4
+
+typedef struct heaps_t* heaps_t;
+
+/**
+ * @brief Name of data pushed onto a heap, valid until the data leaves the heap.
+ */
+typedef size_t heaps_handle_t;
+
+/**
+ * @brief User provided compare function. Must provide a linear ordering of the
+ * data.
+ */
+typedef int (*heaps_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must provide a linear ordering
+ * of the data.
+ */
+typedef int (*heaps_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief Instantiates a <tt>heaps_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>heaps_t</tt> instance. This memory needs to
+ * be freed by a call to <tt>heaps_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>heaps_data_cmp</tt> and <tt>heaps_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ *
+ * @return Instance of heap object.
+ */
+extern heaps_t heaps_new(heaps_data_cmp cmp, heaps_data_cmp_r cmp_r);
+
+/**
+ * @brief Instantiates a <tt>heaps_t</tt> instance with a user allocator.
+ *
+ * As <tt>heaps_new</tt>, but the heap object and its arrays are allocated,
+ * resized and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>heaps_data_cmp</tt> and <tt>heaps_data_cmp_r</tt> arguments
+ * are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ * @param[in] al Allocator of the heap.
+ *
+ * @return Instance of heap object.
+ */
+extern heaps_t heaps_new_alloc(heaps_data_cmp cmp, heaps_data_cmp_r cmp_r,
+                               const allocators_t *al);
+
+/**
+ * @brief Push pointer to data object onto heap object.
+ *
+ * Push pointer to data object onto heap object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_push</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being added to.
+ * @param[in] x Pointer to data being added to heap object.
+ *
+ * @return Handle of the data in the heap.
+ */
+extern heaps_handle_t heaps_push(heaps_t h, const void *x);
+
+/**
+ * @brief Push pointer to data object onto heap object.
+ *
+ * Reentrant version of <tt>heaps_push</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_push_r</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being added to.
+ * @param[in] x Pointer to data being added to heap object.
+ * @param[in] y Argument to user provided reentrant compare function.
+ *
+ * @return Handle of the data in the heap.
+ */
+extern heaps_handle_t heaps_push_r(heaps_t h, const void *x, void *y);
+
+/**
+ * @brief Remove least data object of heap object.
+ *
+ * The pointer to the least data object is removed from the heap and returned to
+ * the user. Its handle is released.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_pop</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being popped.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *heaps_pop(heaps_t h);
+
+/**
+ * @brief Remove least data object of heap object.
+ *
+ * Reentrant version of <tt>heaps_pop</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_pop_r</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being popped.
+ * @param[in] y Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *heaps_pop_r(heaps_t h, void *y);
+
+/**
+ * @brief Least data object of heap object.
+ *
+ * Least data object of heap object, which is left in the heap.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_peek</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being checked.
+ *
+ * @return Pointer to data object if any. <tt>NULL</tt> otherwise.
+ */
+extern void *heaps_peek(heaps_t h);
+
+/**
+ * @brief Data object named by a handle.
+ *
+ * Data object named by a handle.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being checked.
+ * @param[in] k Handle returned by a push.
+ *
+ * @return Pointer to data object.
+ */
+extern void *heaps_get(heaps_t h, heaps_handle_t k);
+
+/**
+ * @brief Restore heap order after the key of data has been decreased.
+ *
+ * The data named by <tt>k</tt> is moved towards the top of the heap. The user
+ * calls <tt>heaps_decrease</tt> after lowering the key of the data in place.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * <dd>The key of the data has been increased.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being altered.
+ * @param[in] k Handle returned by a push.
+ */
+extern void heaps_decrease(heaps_t h, heaps_handle_t k);
+
+/**
+ * @brief Restore heap order after the key of data has been decreased.
+ *
+ * Reentrant version of <tt>heaps_decrease</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * <dd>The key of the data has been increased.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being altered.
+ * @param[in] k Handle returned by a push.
+ * @param[in] y Argument to user provided reentrant compare function.
+ */
+extern void heaps_decrease_r(heaps_t h, heaps_handle_t k, void *y);
+
+/**
+ * @brief Restore heap order after the key of data has been changed.
+ *
+ * As <tt>heaps_decrease</tt>, but the key may have been increased as well.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being altered.
+ * @param[in] k Handle returned by a push.
+ */
+extern void heaps_update(heaps_t h, heaps_handle_t k);
+
+/**
+ * @brief Restore heap order after the key of data has been changed.
+ *
+ * Reentrant version of <tt>heaps_update</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being altered.
+ * @param[in] k Handle returned by a push.
+ * @param[in] y Argument to user provided reentrant compare function.
+ */
+extern void heaps_update_r(heaps_t h, heaps_handle_t k, void *y);
+
+/**
+ * @brief Remove data named by a handle from heap object.
+ *
+ * The pointer to the data named by <tt>k</tt> is removed from the heap and
+ * returned to the user. Its handle is released.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being altered.
+ * @param[in] k Handle returned by a push.
+ *
+ * @return Pointer to data object.
+ */
+extern void *heaps_remove(heaps_t h, heaps_handle_t k);
+
+/**
+ * @brief Remove data named by a handle from heap object.
+ *
+ * Reentrant version of <tt>heaps_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The data named by the handle has left the heap.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being altered.
+ * @param[in] k Handle returned by a push.
+ * @param[in] y Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to data object.
+ */
+extern void *heaps_remove_r(heaps_t h, heaps_handle_t k, void *y);
+
+/**
+ * @brief Push an array of pointers to data objects onto heap object.
+ *
+ * The <tt>n</tt> pointers of <tt>x</tt> are added to the heap, which is then
+ * rebuilt bottom up in O(size of heap) compares, rather than the O(n log n) of
+ * <tt>n</tt> pushes. The handles of the data are <tt>heaps_handle_t</tt>
+ * values <tt>0</tt> to <tt>n - 1</tt> when called on a new heap.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_heapify</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being added to.
+ * @param[in] x Array of pointers to data objects.
+ * @param[in] n Number of pointers of <tt>x</tt>.
+ */
+extern void heaps_heapify(heaps_t h, void **x, size_t n);
+
+/**
+ * @brief Push an array of pointers to data objects onto heap object.
+ *
+ * Reentrant version of <tt>heaps_heapify</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_heapify_r</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being added to.
+ * @param[in] x Array of pointers to data objects.
+ * @param[in] n Number of pointers of <tt>x</tt>.
+ * @param[in] y Argument to user provided reentrant compare function.
+ */
+extern void heaps_heapify_r(heaps_t h, void **x, size_t n, void *y);
+
+/**
+ * @brief Apply function to every member of heap object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the heap, in heap
+ * order rather than sorted order. Early termination is possible if
+ * <tt>apply</tt> returns a negative <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being acted upon.
+ * @param[in] apply Function being applied to members of the heap.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int heaps_map(heaps_t h, int apply(void *x));
+
+/**
+ * @brief Apply function to every member of heap object.
+ *
+ * Reentrant version of <tt>heaps_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being acted upon.
+ * @param[in] apply Function being applied to members of the heap.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int heaps_map_r(heaps_t h, int apply(void *x, void *y), void *y);
+
+/**
+ * @brief Free memory allocated for heap.
+ *
+ * Only the heap is freed, not the data.
+ *
+ * @param[in] *h Pointer to <tt>heaps_t</tt> object.
+ */
+extern void heaps_free(heaps_t *h);
+
+/**
+ * @brief Number of elements in heap.
+ *
+ * Number of elements in heap.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>heaps_size</tt> on a <tt>NULL</tt> heap object.</dd>
+ * </dl>
+ *
+ * @param[in] h Heap object being checked.
+ *
+ * @return Number of members of the heap.
+ */
+extern size_t heaps_size(heaps_t h);
+
+/**
+ * @brief Swap opaque pointers for heaps.
+ *
+ * Swap opaque pointers for heaps.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Heap objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] h1 First heap.
+ * @param[in] h2 Second heap.
+ */
+static inline
+void heaps_swap(heaps_t *restrict h1, heaps_t *restrict h2)
+{
+  volatile heaps_t tmp = *h1;
+  *h1 = *h2;
+  *h2 = tmp;
+}
+
+# endif
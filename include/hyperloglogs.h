@@ -0,0 +1,174 @@
+/**
+ * @file hyperloglogs.h
+ * @brief Public interface of <tt>hyperloglogs_t</tt> class
+ *
+ * The <tt>hyperloglogs_t</tt> object instantiates a HyperLogLog sketch of
+ * 64-bit hash values, estimating the number of distinct values added in one
+ * pass and a fixed amount of memory. The low <tt>p</tt> bits of a hash value
+ * pick one of <tt>2^p</tt> one-byte registers, which keeps the largest rank of
+ * the first set bit of the remaining bits seen. The standard error of the
+ * estimate is about <tt>1.04 / sqrt(2^p)</tt>.
+ *
+ * Sketches of equal <tt>p</tt> merge into the sketch of the union of their
+ * inputs, so that the parts of an input may be sketched apart.
+ *
+ * <tt>hyperloglogs_hint</tt> turns the estimate into the element count hint
+ * taken by <tt>hashtabs_new</tt>, <tt>dhashtabs_new</tt> and
+ * <tt>flathashtabs_new</tt>, so that the table built from the input need not
+ * grow.
+ *
+ * The <tt>hyperloglogs_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_HYPERLOGLOGS_H
+# define INCLUDED_HYPERLOGLOGS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Fewest register index bits of a sketch.
+ */
+# define HYPERLOGLOGS_MINP 4
+
+/**
+ * @brief Most register index bits of a sketch.
+ */
+# define HYPERLOGLOGS_MAXP 18
+
+typedef struct hyperloglogs_t* hyperloglogs_t;
+
+/**
+ * @brief Instantiates a <tt>hyperloglogs_t</tt> instance.
+ *
+ * Memory is allocated for a sketch of <tt>2^p</tt> registers. This memory needs
+ * to be freed by a call to <tt>hyperloglogs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>p</tt> is outside of <tt>HYPERLOGLOGS_MINP</tt> to
+ * <tt>HYPERLOGLOGS_MAXP</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] p Register index bits.
+ *
+ * @return New sketch object.
+ */
+extern hyperloglogs_t hyperloglogs_new(unsigned p);
+
+/**
+ * @brief Instantiates a <tt>hyperloglogs_t</tt> instance through an allocator.
+ *
+ * As <tt>hyperloglogs_new</tt>, but the sketch object and its registers are
+ * allocated through <tt>al</tt>, which is copied.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>p</tt> is outside of <tt>HYPERLOGLOGS_MINP</tt> to
+ * <tt>HYPERLOGLOGS_MAXP</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] p Register index bits.
+ * @param[in] al Allocator of sketch object.
+ *
+ * @return New sketch object.
+ */
+extern hyperloglogs_t hyperloglogs_new_alloc(unsigned p,
+                                             const allocators_t *al);
+
+/**
+ * @brief Frees memory of sketch object.
+ *
+ * @param[in] s Pointer to sketch object being freed.
+ */
+extern void hyperloglogs_free(hyperloglogs_t *s);
+
+/**
+ * @brief Adds hash value to sketch object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hyperloglogs_add</tt> on a <tt>NULL</tt> sketch
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Sketch object being added to.
+ * @param[in] h Hash value being added.
+ */
+extern void hyperloglogs_add(hyperloglogs_t s, uint64_t h);
+
+/**
+ * @brief Merges sketch object into another.
+ *
+ * <tt>d</tt> becomes the sketch of the hash values added to either of
+ * <tt>d</tt> and <tt>s</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hyperloglogs_merge</tt> on a <tt>NULL</tt> sketch
+ * object.</dd>
+ * <dd><tt>d</tt> and <tt>s</tt> have unequal register index bits.</dd>
+ * </dl>
+ *
+ * @param[in] d Sketch object being merged into.
+ * @param[in] s Sketch object being merged.
+ */
+extern void hyperloglogs_merge(hyperloglogs_t d, hyperloglogs_t s);
+
+/**
+ * @brief Estimate of number of distinct hash values added to sketch object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hyperloglogs_estimate</tt> on a <tt>NULL</tt> sketch
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Sketch object.
+ *
+ * @return Estimate of number of distinct hash values.
+ */
+extern size_t hyperloglogs_estimate(hyperloglogs_t s);
+
+/**
+ * @brief Element count hint of a hash table built from the input of sketch
+ * object.
+ *
+ * The estimate raised by three standard errors, so that a table made with it
+ * by <tt>hashtabs_new</tt>, <tt>dhashtabs_new</tt> or <tt>flathashtabs_new</tt>
+ * almost never grows while the input is inserted.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hyperloglogs_hint</tt> on a <tt>NULL</tt> sketch
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Sketch object.
+ *
+ * @return Element count hint.
+ */
+extern size_t hyperloglogs_hint(hyperloglogs_t s);
+
+/**
+ * @brief Removes every hash value from sketch object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>hyperloglogs_clear</tt> on a <tt>NULL</tt> sketch
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Sketch object being cleared.
+ */
+extern void hyperloglogs_clear(hyperloglogs_t s);
+
+# endif
@@ -0,0 +1,178 @@
+/**
+ * @file interns.h
+ * @brief Public interface of <tt>interns_t</tt> class
+ *
+ * The <tt>interns_t</tt> object instantiates a table of distinct byte strings
+ * of any length, each named by a 32-bit identifier. Interning a string copies
+ * it once, with a terminating null byte, to the end of one growable arena, and
+ * adds its hash, length and offset in the arena to a flat array of entries
+ * indexed by identifier, the identifiers being handed out from 0 in order.
+ * Strings are found through an open addressing table of 64-bit slots, each
+ * holding the identifier of a string next to 32 bits of its hash, so that a
+ * probe reads an entry and its string only when the hashes agree.
+ *
+ * A string costs its bytes plus one, and about 30 bytes of entry and slots,
+ * against a separate allocation and a node of a table of pointers. Once
+ * interned, strings are equal exactly if their identifiers are, and are
+ * stored, compared and hashed as <tt>uint32_t</tt> by the other containers.
+ * Identifiers stay valid for the life of the table, while pointers to the
+ * strings, the arena moving as it grows, last only up to the next call of
+ * <tt>interns_intern</tt>.
+ *
+ * The <tt>interns_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_INTERNS_H
+# define INCLUDED_INTERNS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Identifier returned by <tt>interns_find</tt> for a string not in the
+ * table.
+ */
+# define INTERNS_NONE UINT32_MAX
+
+typedef struct interns_t* interns_t;
+
+/**
+ * @brief Instantiates an <tt>interns_t</tt> instance.
+ *
+ * Memory is allocated for an empty table. This memory needs to be freed by a
+ * call to <tt>interns_free</tt>.
+ *
+ * @return New table object.
+ */
+extern interns_t interns_new(void);
+
+/**
+ * @brief Instantiates an <tt>interns_t</tt> instance through an allocator.
+ *
+ * As <tt>interns_new</tt>, but the table object, its arena, entries and slots
+ * are allocated through <tt>al</tt>, which is copied. With
+ * <tt>allocators_huge</tt> a large arena grows without being copied.
+ *
+ * @param[in] al Allocator of table object.
+ *
+ * @return New table object.
+ */
+extern interns_t interns_new_alloc(const allocators_t *al);
+
+/**
+ * @brief Frees memory of table object.
+ *
+ * @param[in] t Pointer to table object being freed.
+ */
+extern void interns_free(interns_t *t);
+
+/**
+ * @brief Interns string into table object.
+ *
+ * If the <tt>n</tt> bytes at <tt>s</tt> are not in the table, they are copied
+ * into it under the next identifier.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>interns_intern</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd><tt>s</tt> points into the arena of the table.</dd>
+ * <dd>The table holds <tt>INTERNS_NONE</tt> strings, or <tt>n</tt> is larger
+ * than <tt>UINT32_MAX</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object.
+ * @param[in] s String being interned, not necessarily null terminated.
+ * @param[in] n Number of bytes of <tt>s</tt>.
+ *
+ * @return Identifier of string.
+ */
+extern uint32_t interns_intern(interns_t t, const void *s, size_t n);
+
+/**
+ * @brief Identifier of string of table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>interns_find</tt> on a <tt>NULL</tt> table object.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object.
+ * @param[in] s String being searched for, not necessarily null terminated.
+ * @param[in] n Number of bytes of <tt>s</tt>.
+ *
+ * @return Identifier of string if interned. <tt>INTERNS_NONE</tt> otherwise.
+ */
+extern uint32_t interns_find(interns_t t, const void *s, size_t n);
+
+/**
+ * @brief String of identifier of table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>interns_str</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd><tt>id</tt> is not less than <tt>interns_nmem(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object.
+ * @param[in] id Identifier of string.
+ *
+ * @return Pointer to the null terminated string in the arena, valid up to the
+ * next call of <tt>interns_intern</tt>.
+ */
+extern const char *interns_str(interns_t t, uint32_t id);
+
+/**
+ * @brief Length of string of identifier of table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>interns_len</tt> on a <tt>NULL</tt> table object.</dd>
+ * <dd><tt>id</tt> is not less than <tt>interns_nmem(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object.
+ * @param[in] id Identifier of string.
+ *
+ * @return Number of bytes of string, its null byte excluded.
+ */
+extern size_t interns_len(interns_t t, uint32_t id);
+
+/**
+ * @brief Number of strings of table object.
+ *
+ * @param[in] t Table object.
+ *
+ * @return Number of strings, one more than the last identifier.
+ */
+extern size_t interns_nmem(interns_t t);
+
+/**
+ * @brief Number of bytes allocated for table.
+ *
+ * Number of bytes allocated for the table object, its arena, entries and
+ * slots. If <tt>payload</tt> is not <tt>NULL</tt>, it is set to the number of
+ * those bytes holding the strings, their null bytes excluded; the rest is
+ * overhead.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>interns_memory_usage</tt> on a <tt>NULL</tt> table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Table object being checked.
+ * @param[out] payload Bytes of payload, if not <tt>NULL</tt>.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t interns_memory_usage(interns_t t, size_t *payload);
+
+# endif
@@ -0,0 +1,301 @@
+/**
+ * @file pipes.h
+ * @brief Public interface of <tt>pipes_t</tt> class
+ *
+ * The <tt>pipes_t</tt> object is a lazy pipeline over the elements of a
+ * container: a source, followed by map and filter stages added in order, run by
+ * a reducing or collecting routine. Nothing is done until the pipeline is run,
+ * and a run takes each element of the source through every stage before taking
+ * the next, so that the elements are swept over once, however many stages
+ * there are, and no intermediate container is built.
+ *
+ * A source is an array, a queue, a stack, a hash table, a deep hash table, or a
+ * pair of user provided functions. Elements are passed between stages as
+ * pointers; for an array source they point into the array. A map stage writes
+ * its result to a buffer of the pipeline of the size given to
+ * <tt>pipes_map</tt>, overwritten by each element, or returns a pointer to data
+ * of its own choosing.
+ *
+ * A pipeline may be run any number of times, each run starting the source
+ * again. The source container must not be changed while the pipeline runs.
+ *
+ * The <tt>pipes_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_PIPES_H
+# define INCLUDED_PIPES_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "arrays.h"
+# include "queues.h"
+# include "stacks.h"
+# include "hashtabs.h"
+# include "deephashtabs.h"
+
+typedef struct pipes_t* pipes_t;
+
+/**
+ * @brief User provided source function.
+ *
+ * Sets <tt>*x</tt> to the first, or next, element of <tt>src</tt> and returns
+ * 1, or returns -1 once every element has been given.
+ */
+typedef int (*pipes_source)(void *src, void **x);
+
+/**
+ * @brief Instantiates a pipeline over a user provided source.
+ *
+ * Each run of the pipeline calls <tt>first</tt> once and then <tt>next</tt>
+ * until either returns -1. This memory needs to be freed by a call to
+ * <tt>pipes_free</tt>.
+ *
+ * @param[in] first Function giving the first element of the source.
+ * @param[in] next Function giving the next element of the source.
+ * @param[in] src Argument to <tt>first</tt> and <tt>next</tt>.
+ *
+ * @return Instance of pipeline object.
+ */
+extern pipes_t pipes_new(pipes_source first, pipes_source next, void *src);
+
+/**
+ * @brief Instantiates a pipeline over the elements of an array.
+ *
+ * The elements are passed on as pointers into the array, in order.
+ *
+ * @param[in] a Array object being read.
+ *
+ * @return Instance of pipeline object.
+ */
+extern pipes_t pipes_new_arrays(arrays_t a);
+
+/**
+ * @brief Instantiates a pipeline over the elements of a queue, from front to
+ * back.
+ *
+ * @param[in] q Queue object being read.
+ *
+ * @return Instance of pipeline object.
+ */
+extern pipes_t pipes_new_queues(queues_t q);
+
+/**
+ * @brief Instantiates a pipeline over the elements of a stack, from top to
+ * bottom.
+ *
+ * @param[in] s Stack object being read.
+ *
+ * @return Instance of pipeline object.
+ */
+extern pipes_t pipes_new_stacks(stacks_t s);
+
+/**
+ * @brief Instantiates a pipeline over the elements of a hash table.
+ *
+ * @param[in] t Hash table object being read.
+ *
+ * @return Instance of pipeline object.
+ */
+extern pipes_t pipes_new_hashtabs(hashtabs_t t);
+
+/**
+ * @brief Instantiates a pipeline over the elements of a deep hash table.
+ *
+ * The elements are passed on as pointers to the copies held by the table.
+ *
+ * @param[in] t Hash table object being read.
+ *
+ * @return Instance of pipeline object.
+ */
+extern pipes_t pipes_new_dhashtabs(dhashtabs_t t);
+
+/**
+ * @brief Free pipeline object.
+ *
+ * The source of the pipeline is not freed.
+ *
+ * @param[in] *p Pointer to pipeline object.
+ */
+extern void pipes_free(pipes_t *p);
+
+/**
+ * @brief Adds map stage to pipeline.
+ *
+ * Each element reaching the stage is replaced by the pointer returned by
+ * <tt>f</tt>, called with the element and a buffer of <tt>size</tt> bytes of
+ * the stage, or <tt>NULL</tt> if <tt>size</tt> is 0.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_map</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object.
+ * @param[in] f User defined function mapping element <tt>x</tt>.
+ * @param[in] size Size of buffer of the stage.
+ */
+extern void pipes_map(pipes_t p, void *f(const void *x, void *out), size_t size);
+
+/**
+ * @brief Adds map stage to pipeline.
+ *
+ * Reentrant version of <tt>pipes_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_map_r</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object.
+ * @param[in] f User defined function mapping element <tt>x</tt>.
+ * @param[in] size Size of buffer of the stage.
+ * @param[in] y Argument to user defined function.
+ */
+extern void pipes_map_r(pipes_t p, void *f(const void *x, void *out, void *y),
+                        size_t size, void *y);
+
+/**
+ * @brief Adds filter stage to pipeline.
+ *
+ * Elements for which <tt>pred</tt> does not return a positive <tt>int</tt>
+ * are dropped by the stage.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_filter</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object.
+ * @param[in] pred User defined predicate.
+ */
+extern void pipes_filter(pipes_t p, int pred(const void *x));
+
+/**
+ * @brief Adds filter stage to pipeline.
+ *
+ * Reentrant version of <tt>pipes_filter</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_filter_r</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object.
+ * @param[in] pred User defined predicate.
+ * @param[in] y Argument to user defined predicate.
+ */
+extern void pipes_filter_r(pipes_t p, int pred(const void *x, void *y),
+                           void *y);
+
+/**
+ * @brief Runs pipeline, folding its output into an accumulator.
+ *
+ * Calls <tt>f</tt> with <tt>acc</tt> and each element leaving the last stage.
+ * Early termination is possible if <tt>f</tt> returns a negative
+ * <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_reduce</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object being run.
+ * @param[in] f User defined function folding element <tt>x</tt>.
+ * @param[in] acc Accumulator.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int pipes_reduce(pipes_t p, int f(void *acc, const void *x), void *acc);
+
+/**
+ * @brief Runs pipeline, folding its output into an accumulator.
+ *
+ * Reentrant version of <tt>pipes_reduce</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_reduce_r</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object being run.
+ * @param[in] f User defined function folding element <tt>x</tt>.
+ * @param[in] acc Accumulator.
+ * @param[in] y Argument to user defined function.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int pipes_reduce_r(pipes_t p, int f(void *acc, const void *x, void *y),
+                          void *acc, void *y);
+
+/**
+ * @brief Runs pipeline, counting its output.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_count</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object being run.
+ *
+ * @return Number of elements leaving the last stage.
+ */
+extern size_t pipes_count(pipes_t p);
+
+/**
+ * @brief Runs pipeline, appending its output to an array.
+ *
+ * Each element leaving the last stage is copied to the back of <tt>a</tt> by
+ * <tt>arrays_dynpush</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_collect</tt> on a <tt>NULL</tt> pipeline object.</dd>
+ * <dd>Array is the source of the pipeline.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object being run.
+ * @param[in] a Array object appended to.
+ */
+extern void pipes_collect(pipes_t p, arrays_t a);
+
+/**
+ * @brief Runs pipeline, inserting its output into a hash table.
+ *
+ * The pointers leaving the last stage are inserted, and so must stay valid for
+ * as long as the table holds them; those to a buffer of a map stage do not.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_collect_hashtabs</tt> on a <tt>NULL</tt> pipeline
+ * object.</dd>
+ * <dd>Hash table is the source of the pipeline.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object being run.
+ * @param[in] t Hash table object inserted into.
+ */
+extern void pipes_collect_hashtabs(pipes_t p, hashtabs_t t);
+
+/**
+ * @brief Runs pipeline, inserting copies of its output into a deep hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pipes_collect_dhashtabs</tt> on a <tt>NULL</tt> pipeline
+ * object.</dd>
+ * <dd>Hash table is the source of the pipeline.</dd>
+ * </dl>
+ *
+ * @param[in] p Pipeline object being run.
+ * @param[in] t Hash table object inserted into.
+ */
+extern void pipes_collect_dhashtabs(pipes_t p, dhashtabs_t t);
+
+# endif
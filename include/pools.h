@@ -0,0 +1,198 @@
+/**
+ * @file pools.h
+ * @brief Public interface of <tt>pools_t</tt> class
+ *
+ * The <tt>pools_t</tt> object is a slab allocator for objects of one fixed size.
+ * Objects are carved out of slabs holding many objects each, and released objects
+ * are kept on a free list for reuse by later allocations. Slabs are only returned
+ * to the system by <tt>pools_free</tt>, which releases every object of the pool
+ * at once without visiting them.
+ *
+ * The containers of this library whose constructors have suffix
+ * <tt>_new_pooled</tt> allocate their links from a private pool, so that freeing
+ * such a container costs one call to <tt>free</tt> per slab rather than one per
+ * element.
+ *
+ * The <tt>pools_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_POOLS_H
+# define INCLUDED_POOLS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Default number of bytes of objects per slab.
+ */
+# define POOLS_SLAB 65536
+
+typedef struct pools_t* pools_t;
+
+/**
+ * @brief Instantiates a <tt>pools_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>pools_t</tt> instance handing out objects of
+ * <tt>size</tt> bytes, aligned for pointers. No slab is allocated until the
+ * first call to <tt>pools_alloc</tt>. This memory needs to be freed by a call to
+ * <tt>pools_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Objects of the pool need stricter alignment than pointers do.</dd>
+ * </dl>
+ *
+ * @param[in] size Size of objects.
+ * @param[in] n Number of objects per slab, or 0 for as many as fit in
+ * <tt>POOLS_SLAB</tt> bytes.
+ *
+ * @return Instance of pool object.
+ */
+extern pools_t pools_new(size_t size, size_t n);
+
+/**
+ * @brief Instantiates a <tt>pools_t</tt> instance with a user allocator.
+ *
+ * As <tt>pools_new</tt>, but the pool object and its slabs are allocated and
+ * freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Objects of the pool need stricter alignment than pointers do, or than
+ * <tt>al</tt> provides.</dd>
+ * </dl>
+ *
+ * @param[in] size Size of objects.
+ * @param[in] n Number of objects per slab, or 0 for as many as fit in
+ * <tt>POOLS_SLAB</tt> bytes.
+ * @param[in] al Allocator of the slabs.
+ *
+ * @return Instance of pool object.
+ */
+extern pools_t pools_new_alloc(size_t size, size_t n, const allocators_t *al);
+
+/**
+ * @brief Allocate object from pool.
+ *
+ * The most recently released object is reused if there is one. Otherwise the
+ * object is taken from the current slab, a new slab being allocated if it is
+ * exhausted. The contents of the object are unspecified.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pools_alloc</tt> on a <tt>NULL</tt> pool object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pool object being allocated from.
+ *
+ * @return Pointer to object.
+ */
+extern void *pools_alloc(pools_t p);
+
+/**
+ * @brief Return object to pool.
+ *
+ * The object is placed on the free list of the pool. Its memory is not returned
+ * to the system before <tt>pools_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pools_release</tt> on a <tt>NULL</tt> pool object.</dd>
+ * <dd><tt>x</tt> was not allocated from <tt>p</tt>, or was already
+ * released.</dd>
+ * </dl>
+ *
+ * @param[in] p Pool object being released to.
+ * @param[in] x Pointer to object being released.
+ */
+extern void pools_release(pools_t p, void *x);
+
+/**
+ * @brief Return every object to pool.
+ *
+ * Every object allocated from the pool is released at once, whatever the number
+ * of objects. The slabs are kept, and later allocations reuse them before
+ * allocating more.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pools_clear</tt> on a <tt>NULL</tt> pool object.</dd>
+ * <dd>Objects of the pool are used after the call.</dd>
+ * </dl>
+ *
+ * @param[in] p Pool object being cleared.
+ */
+extern void pools_clear(pools_t p);
+
+/**
+ * @brief Free pool and every object allocated from it.
+ *
+ * The slabs of the pool are freed, which frees every object allocated from the
+ * pool whether released or not.
+ *
+ * @param[in] *p Pointer to <tt>pools_t</tt> object.
+ */
+extern void pools_free(pools_t *p);
+
+/**
+ * @brief Number of objects in use.
+ *
+ * Number of objects allocated from the pool and not released.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pools_size</tt> on a <tt>NULL</tt> pool object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pool object being checked.
+ *
+ * @return Number of objects in use.
+ */
+extern size_t pools_size(pools_t p);
+
+/**
+ * @brief Number of bytes allocated for pool.
+ *
+ * Number of bytes allocated for the pool object and its slabs.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>pools_bytes</tt> on a <tt>NULL</tt> pool object.</dd>
+ * </dl>
+ *
+ * @param[in] p Pool object being checked.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t pools_bytes(pools_t p);
+
+/**
+ * @brief Swap opaque pointers for pools.
+ *
+ * Swap opaque pointers for pools.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Pool objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] p1 First pool.
+ * @param[in] p2 Second pool.
+ */
+static inline
+void pools_swap(pools_t *restrict p1, pools_t *restrict p2)
+{
+  volatile pools_t tmp = *p1;
+  *p1 = *p2;
+  *p2 = tmp;
+}
+
+# endif
@@ -11,7 +11,9 @@
  *
  * Repetitions are not allowed, and data must be linearly ordered.
  *
- * The <tt>queues_t</tt> class is implemented as an opaque pointer.
+ * The <tt>queues_t</tt> class is implemented as an opaque pointer. With
+ * <tt>CONTAINERS_INLINE</tt> defined, <tt>queues_size</tt> is
+ * <tt>static inline</tt>.
  *
  * @warning This class is meant to be used in time restricted settings. As such,
  * some runtime errors, such as out-of-bounds-type errors, are note explicitly
@@ -28,6 +30,8 @@
 # include <errno.h>
 # include <error.h>
 
+# include "allocators.h"
+
 typedef struct queues_t* queues_t;
 
 /**
@@ -61,6 +65,71 @@ typedef int (*queues_data_cmp_r)(const void*, const void*, void*);
  */
 extern queues_t queues_new(queues_data_cmp cmp, queues_data_cmp_r cmp_r);
 
+/**
+ * @brief Instantiates a <tt>queues_t</tt> instance with a user allocator.
+ *
+ * As <tt>queues_new</tt>, but the queue object and its links are allocated and
+ * freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>One of the <tt>queues_data_cmp</tt> or <tt>queues_data_cmp_r</tt>
+ * arguments must be non<tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ * @param[in] al Allocator of the queue.
+ *
+ * @return Instance of queue object.
+ */
+extern queues_t queues_new_alloc(queues_data_cmp cmp, queues_data_cmp_r cmp_r,
+                                 const allocators_t *al);
+
+/**
+ * @brief Instantiates a <tt>queues_t</tt> instance whose links are pooled.
+ *
+ * As <tt>queues_new</tt>, but the links of the queue are allocated from a private
+ * <tt>pools_t</tt> slab allocator. <tt>queues_free</tt> then frees the links one
+ * slab at a time instead of one link at a time.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>One of the <tt>queues_data_cmp</tt> or <tt>queues_data_cmp_r</tt>
+ * arguments must be non<tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ *
+ * @return Instance of queue object.
+ */
+extern queues_t queues_new_pooled(queues_data_cmp cmp, queues_data_cmp_r cmp_r);
+
+/**
+ * @brief Instantiates a <tt>queues_t</tt> instance whose links are compact.
+ *
+ * As <tt>queues_new</tt>, but the links of the queue are taken from chunks of
+ * twice the size of the one before, and name each other by 32-bit index instead
+ * of by pointer. A link is then 16 bytes rather than 24, without the header of
+ * an allocation, and freed links are reused before fresh ones. The chunks are
+ * kept by <tt>queues_clear</tt> and freed by <tt>queues_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>One of the <tt>queues_data_cmp</tt> or <tt>queues_data_cmp_r</tt>
+ * arguments must be non<tt>NULL</tt>.</dd>
+ * <dd>The queue holds more than <tt>UINT32_MAX</tt> elements.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ *
+ * @return Instance of queue object.
+ */
+extern queues_t queues_new_compact(queues_data_cmp cmp,
+                                   queues_data_cmp_r cmp_r);
+
 /**
  * @brief Inserts pointer to data object into queue object.
  *
@@ -95,6 +164,45 @@ extern void queues_enqueu(queues_t q, const void *x);
  */
 extern void queues_enqueu_r(queues_t q, const void *x, void *y);
 
+/**
+ * @brief Inserts pointers to a sorted run of data objects into queue object.
+ *
+ * As <tt>queues_enqueu</tt> applied to each of <tt>x[0]</tt>, ...,
+ * <tt>x[n - 1]</tt>, but the run and the queue are merged in one linear pass
+ * rather than the queue being scanned from its head for every data object.
+ * Data objects equal to one already in the queue, or to the one before them in
+ * the run, are not added.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_merge</tt> on a <tt>NULL</tt> queue object.</dd>
+ * <dd>The run is not sorted by the compare function of the queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Pointers to data being added to queue object, in order.
+ * @param[in] n Number of pointers.
+ */
+extern void queues_merge(queues_t q, void *const *x, size_t n);
+
+/**
+ * @brief Inserts pointers to a sorted run of data objects into queue object.
+ *
+ * Reentrant version of <tt>queues_merge</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_merge_r</tt> on a <tt>NULL</tt> queue object.</dd>
+ * <dd>The run is not sorted by the compare function of the queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Pointers to data being added to queue object, in order.
+ * @param[in] n Number of pointers.
+ * @param[in] y Argument to user provided reentrant compare function.
+ */
+extern void queues_merge_r(queues_t q, void *const *x, size_t n, void *y);
+
 /**
  * @brief Remove object from front of queue object.
  *
@@ -210,6 +318,47 @@ extern void *queues_remove(queues_t q, const void *x);
  */
 extern void *queues_remove_r(queues_t q, const void *x, void *y);
 
+/**
+ * @brief Remove every pointer to data object of queue object passing a
+ * predicate.
+ *
+ * The queue is walked once from front to back, and every link whose data
+ * object <tt>pred</tt> returns a positive <tt>int</tt> for is unlinked and
+ * released, the pointer first being handed to <tt>dispose</tt> unless it is
+ * <tt>NULL</tt>. The order of the remaining data is kept.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>pred</tt> or <tt>dispose</tt> alter the queue object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queues object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t queues_remove_if(queues_t q, int pred(const void *x),
+                               void dispose(void *x));
+
+/**
+ * @brief Remove every pointer to data object of queue object passing a
+ * predicate.
+ *
+ * Reentrant version of <tt>queues_remove_if</tt>.
+ *
+ * @param[in] q Queues object being altered.
+ * @param[in] pred Predicate of the data objects being removed.
+ * @param[in] dispose Function disposing of removed data objects, or
+ * <tt>NULL</tt>.
+ * @param[in] y Argument to <tt>pred</tt> and <tt>dispose</tt>.
+ *
+ * @return Number of data objects removed.
+ */
+extern size_t queues_remove_if_r(queues_t q, int pred(const void *x, void *y),
+                                 void dispose(void *x, void *y), void *y);
+
 /**
  * @brief Apply function to every member of queue object.
  *
@@ -248,6 +397,168 @@ extern int queues_map(queues_t q, int apply(void **x));
  */
 extern int queues_map_r(queues_t q, int apply(void **x, void *y), void *y);
 
+/**
+ * @brief Cursor over the elements of a queue, from front to back.
+ *
+ * A cursor is started by <tt>queues_iterinit</tt> and advanced by
+ * <tt>queues_iternext</tt>; unlike <tt>queues_map</tt>, the loop body is the
+ * user's own code. A cursor stays valid while the queue is not changed, and
+ * across finds; enqueues and removes invalidate it.
+ */
+typedef struct {
+  void *x;    ///< element at cursor
+  void *node; ///< link of element at cursor, <tt>NULL</tt> past the back
+  queues_t q; ///< queue of cursor
+} queues_iter_t;
+
+/**
+ * @brief Starts cursor at front of queue.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_iterinit</tt> on a <tt>NULL</tt> queue object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being visited.
+ * @param[out] it Cursor being started.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the queue
+ * is empty.
+ */
+extern int queues_iterinit(queues_t q, queues_iter_t *it);
+
+/**
+ * @brief Advances cursor to the next element of queue.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the back of the queue.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor being advanced.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 once it is
+ * past the back of the queue.
+ */
+extern int queues_iternext(queues_iter_t *it);
+
+/**
+ * @brief Element at cursor.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the back of the queue.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor of queue.
+ *
+ * @return Pointer to the data object at the cursor.
+ */
+static inline
+void *queues_iterget(const queues_iter_t *it)
+{
+  return it->x;
+}
+
+/**
+ * @brief Inserts pointer to data object into queue object, searching from a
+ * finger.
+ *
+ * As <tt>queues_enqueu</tt>, but the search for the place of <tt>x</tt> walks
+ * forward or backward from the element at cursor <tt>it</tt> if it is not
+ * <tt>NULL</tt> and at an element, and otherwise from the element last touched
+ * by a hinted call, or from the tail if there is none. The walk costs a compare
+ * call for each element between its start and the place of <tt>x</tt>, so
+ * nearly sorted runs are inserted in nearly linear time.
+ *
+ * Afterwards, the finger, and <tt>it</tt> if not <tt>NULL</tt>, are at the
+ * element equal to <tt>x</tt>. A cursor so set may be handed to later hinted
+ * calls while its element is not removed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_enqueu_hint</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * <dd><tt>it</tt> is at an element removed since it was set, or of another
+ * queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Pointer to data being added to queue object.
+ * @param[in,out] it Cursor at which the search starts, or <tt>NULL</tt>.
+ */
+extern void queues_enqueu_hint(queues_t q, const void *x, queues_iter_t *it);
+
+/**
+ * @brief Inserts pointer to data object into queue object, searching from a
+ * finger.
+ *
+ * Reentrant version of <tt>queues_enqueu_hint</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_enqueu_hint_r</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * <dd><tt>it</tt> is at an element removed since it was set, or of another
+ * queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being added to.
+ * @param[in] x Pointer to data being added to queue object.
+ * @param[in] y Argument to user provided reentrant compare function.
+ * @param[in,out] it Cursor at which the search starts, or <tt>NULL</tt>.
+ */
+extern void queues_enqueu_hint_r(queues_t q, const void *x, void *y,
+                                 queues_iter_t *it);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in queue
+ * object, searching from a finger.
+ *
+ * As <tt>queues_find</tt>, but the search starts as in
+ * <tt>queues_enqueu_hint</tt>. Afterwards, the finger, and <tt>it</tt> if not
+ * <tt>NULL</tt>, are at the element found, or, if none is, at an element next
+ * to where <tt>x</tt> would be.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_find_hint</tt> on a <tt>NULL</tt> queue object.</dd>
+ * <dd><tt>it</tt> is at an element removed since it was set, or of another
+ * queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being searched.
+ * @param[in] x Data whose membership is being checked.
+ * @param[in,out] it Cursor at which the search starts, or <tt>NULL</tt>.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *queues_find_hint(queues_t q, const void *x, queues_iter_t *it);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in queue
+ * object, searching from a finger.
+ *
+ * Reentrant version of <tt>queues_find_hint</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_find_hint_r</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * <dd><tt>it</tt> is at an element removed since it was set, or of another
+ * queue.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being searched.
+ * @param[in] x Data whose membership is being checked.
+ * @param[in] y Argument to user provided compare function.
+ * @param[in,out] it Cursor at which the search starts, or <tt>NULL</tt>.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *queues_find_hint_r(queues_t q, const void *x, void *y,
+                                queues_iter_t *it);
+
 /**
  * @brief Free data allocated for the shallow queues-type associations.
  *
@@ -259,6 +570,23 @@ extern int queues_map_r(queues_t q, int apply(void **x, void *y), void *y);
  */
 extern void queues_free(queues_t *q);
 
+/**
+ * @brief Remove every element of queue.
+ *
+ * The links of the queue are freed, or, for a queue of
+ * <tt>queues_new_pooled</tt> or <tt>queues_new_compact</tt>, all returned to
+ * its pool or chunks at once for reuse by later enqueues. The data pointed to
+ * by the queue is not freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_clear</tt> on a <tt>NULL</tt> queue object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being cleared.
+ */
+extern void queues_clear(queues_t q);
+
 /**
  * @brief Number of elements in queue.
  *
@@ -273,7 +601,36 @@ extern void queues_free(queues_t *q);
  *
  * @return Number of members of the queue.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+size_t queues_size(queues_t q)
+{
+  return *(const size_t*)(void*)q;
+}
+# else
 extern size_t queues_size(queues_t q);
+# endif
+
+/**
+ * @brief Number of bytes allocated for queue.
+ *
+ * Number of bytes allocated for the queue object and its links, or the slabs of
+ * its pool of links, or the chunks of its compact links. If <tt>payload</tt> is
+ * not <tt>NULL</tt>, it is set to the number of those bytes holding the
+ * pointers to data; the rest is overhead.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>queues_memory_usage</tt> on a <tt>NULL</tt> queue
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being checked.
+ * @param[out] payload Bytes of payload, if not <tt>NULL</tt>.
+ *
+ * @return Number of bytes allocated.
+ */
+extern size_t queues_memory_usage(queues_t q, size_t *payload);
 
 /**
  * @brief Swap opaque pointers for queues.
@@ -0,0 +1,215 @@
+/**
+ * @file roarings.h
+ * @brief Public interface of <tt>roarings_t</tt> class
+ *
+ * The <tt>roarings_t</tt> object instantiates a compressed set of unsigned
+ * 32-bit integers, for sets that are sparse in a large universe. A
+ * <tt>sets_t</tt> of <tt>bit_sets.h</tt> costs a bit for every element of the
+ * universe; a <tt>roarings_t</tt> costs memory in proportion to its members.
+ *
+ * Elements sharing their 16 high bits are kept in one chunk, and the chunks are
+ * kept sorted by those bits. Each chunk is stored as whichever is smaller of
+ *    - a sorted array of the 16 low bits, for up to 4096 elements;
+ *    - a bitmap of 1024 setwords, for more than 4096 elements;
+ *    - a sorted array of runs of consecutive elements.
+ *
+ * Array and bitmap chunks convert into each other as elements are added and
+ * removed. Run chunks are only made by <tt>roarings_optimize</tt>, and turn
+ * back into array or bitmap chunks when changed.
+ *
+ * Elements are visited in increasing order by <tt>roarings_nextelement</tt>,
+ * in the manner of <tt>bit_nextelement</tt>.
+ *
+ * The <tt>roarings_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_ROARINGS_H
+# define INCLUDED_ROARINGS_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "allocators.h"
+
+typedef struct roarings_t* roarings_t;
+
+/**
+ * @brief Instantiates a <tt>roarings_t</tt> instance.
+ *
+ * Memory is allocated for a new, empty <tt>roarings_t</tt> instance. This
+ * memory needs to be freed by a call to <tt>roarings_free</tt>.
+ *
+ * @return New set object.
+ */
+extern roarings_t roarings_new(void);
+
+/**
+ * @brief Instantiates a <tt>roarings_t</tt> instance through an allocator.
+ *
+ * As <tt>roarings_new</tt>, but the set object and its chunks are allocated
+ * through <tt>al</tt>, which is copied.
+ *
+ * @param[in] al Allocator of set object.
+ *
+ * @return New set object.
+ */
+extern roarings_t roarings_new_alloc(const allocators_t *al);
+
+/**
+ * @brief Frees memory of set object.
+ *
+ * @param[in] r Pointer to set object being freed.
+ */
+extern void roarings_free(roarings_t *r);
+
+/**
+ * @brief Adds element to set object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_add</tt> on a <tt>NULL</tt> set object.</dd>
+ * </dl>
+ *
+ * @param[in] r Set object being added to.
+ * @param[in] x Element being added.
+ *
+ * @retval int Returns 1 if <tt>x</tt> was added. Returns -1 if <tt>x</tt> was
+ * already an element.
+ */
+extern int roarings_add(roarings_t r, uint32_t x);
+
+/**
+ * @brief Removes element from set object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_remove</tt> on a <tt>NULL</tt> set object.</dd>
+ * </dl>
+ *
+ * @param[in] r Set object being removed from.
+ * @param[in] x Element being removed.
+ *
+ * @retval int Returns 1 if <tt>x</tt> was removed. Returns -1 if <tt>x</tt>
+ * was not an element.
+ */
+extern int roarings_remove(roarings_t r, uint32_t x);
+
+/**
+ * @brief Test membership in set object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_contains</tt> on a <tt>NULL</tt> set object.</dd>
+ * </dl>
+ *
+ * @param[in] r Set object being searched.
+ * @param[in] x Element being searched for.
+ *
+ * @retval int Returns 1 if <tt>x</tt> is an element. Returns -1 otherwise.
+ */
+extern int roarings_contains(roarings_t r, uint32_t x);
+
+/**
+ * @brief Number of elements of set object.
+ *
+ * @param[in] r Set object.
+ *
+ * @return Number of elements.
+ */
+extern size_t roarings_cardinality(roarings_t r);
+
+/**
+ * @brief Return element of set.
+ *
+ * Returns the least element of the set greater than <tt>pos</tt>, so that
+ *
+ *    for ( int64_t i = -1; (i = roarings_nextelement(r, i)) >= 0; ) ...
+ *
+ * visits the elements in increasing order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_nextelement</tt> on a <tt>NULL</tt> set object.</dd>
+ * </dl>
+ *
+ * @param[in] r Set object being looped over.
+ * @param[in] pos Element of set or -1.
+ *
+ * @retval int64_t Next element of set after <tt>pos</tt> or first element if
+ * <tt>pos</tt> is -1. Returns -1 if there is none.
+ */
+extern int64_t roarings_nextelement(roarings_t r, int64_t pos);
+
+/**
+ * @brief Union of two set objects.
+ *
+ * Replaces the elements of <tt>d</tt> by those of <tt>a</tt> or <tt>b</tt>.
+ * <tt>d</tt> may be either operand.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_union</tt> on <tt>NULL</tt> set objects.</dd>
+ * </dl>
+ *
+ * @param[in] d Destination of union.
+ * @param[in] a First operand.
+ * @param[in] b Second operand.
+ */
+extern void roarings_union(roarings_t d, roarings_t a, roarings_t b);
+
+/**
+ * @brief Intersection of two set objects.
+ *
+ * Replaces the elements of <tt>d</tt> by those of both <tt>a</tt> and
+ * <tt>b</tt>. Only chunks present in both operands are visited, and an array
+ * chunk is intersected by probing the other chunk with its elements. <tt>d</tt>
+ * may be either operand.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_intersect</tt> on <tt>NULL</tt> set objects.</dd>
+ * </dl>
+ *
+ * @param[in] d Destination of intersection.
+ * @param[in] a First conjunct.
+ * @param[in] b Second conjunct.
+ */
+extern void roarings_intersect(roarings_t d, roarings_t a, roarings_t b);
+
+/**
+ * @brief Store chunks as runs where smaller.
+ *
+ * Converts each chunk to a run chunk if its runs of consecutive elements take
+ * less memory than its array or bitmap, and each run chunk that no longer does
+ * back. Meant to be called once a set is built.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>roarings_optimize</tt> on a <tt>NULL</tt> set object.</dd>
+ * </dl>
+ *
+ * @param[in] r Set object being compressed.
+ */
+extern void roarings_optimize(roarings_t r);
+
+/**
+ * @brief Swaps two set objects.
+ *
+ * @param[in] r1 First set.
+ * @param[in] r2 Second set.
+ */
+static inline
+void roarings_swap(roarings_t *restrict r1, roarings_t *restrict r2)
+{
+  volatile roarings_t tmp = *r1;
+  *r1 = *r2;
+  *r2 = tmp;
+}
+
+# endif
@@ -0,0 +1,170 @@
+/**
+ * @file segtrees.h
+ * @brief Public interface of <tt>segtrees_t</tt> class
+ *
+ * The <tt>segtrees_t</tt> object instantiates a segment tree over the
+ * elements of an <tt>arrays_t</tt>, answering the aggregate of any range of
+ * elements and updating one element in <tt>O(log n)</tt> steps each. The
+ * aggregate is given by a user combine function, such as the minimum or the
+ * maximum, which need be associative but not commutative, together with its
+ * identity element.
+ *
+ * The tree is held in one array of <tt>2n</tt> elements: the elements
+ * themselves at positions <tt>n</tt> to <tt>2n - 1</tt>, and the aggregate of
+ * the children <tt>2k</tt> and <tt>2k + 1</tt> at position <tt>k</tt>. A query
+ * climbs from both ends of its range at once. The tree is built in
+ * <tt>O(n)</tt> calls of the combine function, and does not follow later
+ * changes to the array it was built from. Sums of <tt>uint64_t</tt> counts are
+ * kept faster by <tt>fenwicks_t</tt> of <tt>fenwicks.h</tt>.
+ *
+ * The <tt>segtrees_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_SEGTREES_H
+# define INCLUDED_SEGTREES_H
+
+# include <stddef.h>
+
+# include "arrays.h"
+
+typedef struct segtrees_t* segtrees_t;
+
+/**
+ * @brief User provided combine function. Combines the second argument into
+ * the first, which is to the left of it.
+ */
+typedef void (*segtrees_data_combine)(void*, const void*);
+
+/**
+ * @brief User provided reentrant combine function. Combines the second
+ * argument into the first, which is to the left of it.
+ */
+typedef void (*segtrees_data_combine_r)(void*, const void*, void*);
+
+/**
+ * @brief Instantiates a <tt>segtrees_t</tt> instance.
+ *
+ * Memory is allocated for a tree of the elements of <tt>a</tt>. This memory
+ * needs to be freed by a call to <tt>segtrees_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>segtrees_new</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd><tt>id</tt> is not the identity of <tt>combine</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object of elements.
+ * @param[in] id Identity element of <tt>combine</tt>, copied.
+ * @param[in] combine User function combining two elements.
+ *
+ * @return New tree object.
+ */
+extern segtrees_t segtrees_new(arrays_t a, const void *id,
+                               segtrees_data_combine combine);
+
+/**
+ * @brief Instantiates a <tt>segtrees_t</tt> instance with a reentrant combine
+ * function.
+ *
+ * As <tt>segtrees_new</tt>, but every combination of the tree is made by
+ * <tt>combine_r</tt> with <tt>y</tt> as its last argument.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>segtrees_new_r</tt> on a <tt>NULL</tt> array object.</dd>
+ * <dd><tt>id</tt> is not the identity of <tt>combine_r</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] a Array object of elements.
+ * @param[in] id Identity element of <tt>combine_r</tt>, copied.
+ * @param[in] combine_r User function combining two elements.
+ * @param[in] y Argument to <tt>combine_r</tt>.
+ *
+ * @return New tree object.
+ */
+extern segtrees_t segtrees_new_r(arrays_t a, const void *id,
+                                 segtrees_data_combine_r combine_r, void *y);
+
+/**
+ * @brief Frees memory of tree object.
+ *
+ * @param[in] t Pointer to tree object being freed.
+ */
+extern void segtrees_free(segtrees_t *t);
+
+/**
+ * @brief Sets an element of tree object.
+ *
+ * Takes <tt>O(log n)</tt> calls of the combine function.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than <tt>segtrees_nmem(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object.
+ * @param[in] i Index of element.
+ * @param[in] x New value of element, copied.
+ */
+extern void segtrees_set(segtrees_t t, size_t i, const void *x);
+
+/**
+ * @brief Element of tree object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than <tt>segtrees_nmem(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object.
+ * @param[in] i Index of element.
+ *
+ * @return Pointer to element, not to be written.
+ */
+extern const void *segtrees_at(segtrees_t t, size_t i);
+
+/**
+ * @brief Aggregate of a range of elements of tree object.
+ *
+ * The elements <tt>lo</tt> to <tt>hi - 1</tt> are combined in order into
+ * <tt>r</tt>, in <tt>O(log n)</tt> calls of the combine function. An empty
+ * range gives the identity element.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>lo</tt> is larger than <tt>hi</tt>.</dd>
+ * <dd><tt>hi</tt> is larger than <tt>segtrees_nmem(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Tree object.
+ * @param[in] lo Index of first element combined.
+ * @param[in] hi Index one past the last element combined.
+ * @param[out] r Aggregate of the range.
+ */
+extern void segtrees_query(segtrees_t t, size_t lo, size_t hi, void *r);
+
+/**
+ * @brief Number of elements of tree object.
+ *
+ * @param[in] t Tree object.
+ *
+ * @return Number of elements.
+ */
+extern size_t segtrees_nmem(segtrees_t t);
+
+/**
+ * @brief Size of elements of tree object.
+ *
+ * @param[in] t Tree object.
+ *
+ * @return Size of elements.
+ */
+extern size_t segtrees_size(segtrees_t t);
+
+# endif
@@ -0,0 +1,359 @@
+/**
+ * @file shardedhashtabs.h
+ * @brief Public interface of <tt>shashtabs_t</tt> class
+ *
+ * The <tt>shashtabs_t</tt> object instantiates shallow hash-table-type
+ * associations between already existing data, split into a power of two number
+ * of independent <tt>hashtabs_t</tt> shards. Each element lives in the shard
+ * given by the high bits of its hash value, and each operation is routed to that
+ * shard, hashing the element once. As with <tt>hashtabs_t</tt>, the user is
+ * responsible for allocating and deallocating the data.
+ *
+ * Every shard has its own bucket array, links and allocator, and grows on its
+ * own. A shard may thus be given an allocator binding its memory to a NUMA
+ * node, by <tt>shashtabs_new_alloc</tt>, so that the threads of a node work on
+ * the shards of that node. The shards are not locked; threads sharing the table
+ * may instead lock one shard at a time, the shard of an element being given by
+ * <tt>shashtabs_shardof</tt>.
+ *
+ * Repetitions are not allowed, and data must be linearly ordered.
+ *
+ * The <tt>shashtabs_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_SHARDEDHASHTABS_H
+# define INCLUDED_SHARDEDHASHTABS_H
+
+# include <stdint.h>
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+# include "hashtabs.h"
+
+typedef struct shashtabs_t* shashtabs_t;
+
+/**
+ * @brief User provided compare function. Must return -1, 0, or 1.
+ */
+typedef int (*shashtabs_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must return -1, 0, or 1.
+ */
+typedef int (*shashtabs_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief User provided hashing function.
+ */
+typedef uint64_t (*shashtabs_hash)(const void*);
+
+/**
+ * @brief User provided reentrant hashing function.
+ */
+typedef uint64_t (*shashtabs_hash_r)(const void*, const void*);
+
+/**
+ * @brief Instantiates a <tt>shashtabs_t</tt> instance.
+ *
+ * Memory is allocated for <tt>shards</tt> shards, rounded up to a power of two,
+ * each with a bucket array sized for its share of <tt>n</tt> elements. The
+ * shards allocate through <tt>allocators_std</tt>. This memory needs to be
+ * freed by a call to <tt>shashtabs_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>shashtabs_data_cmp</tt> and <tt>shashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>shashtabs_hash</tt> and <tt>shashtabs_hash_r</tt> arguments are
+ * <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] shards Number of shards, at least 1.
+ *
+ * @return Instance of sharded hash table object.
+ */
+extern shashtabs_t shashtabs_new(shashtabs_data_cmp cmp,
+                                 shashtabs_data_cmp_r cmp_r,
+                                 shashtabs_hash hash, shashtabs_hash_r hash_r,
+                                 size_t n, size_t shards);
+
+/**
+ * @brief Instantiates a <tt>shashtabs_t</tt> instance with an allocator for
+ * each shard.
+ *
+ * As <tt>shashtabs_new</tt>, but shard <tt>i</tt> makes every allocation of its
+ * own through <tt>al[i]</tt>, and the sharded table object itself is allocated
+ * through <tt>al[0]</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>shashtabs_data_cmp</tt> and <tt>shashtabs_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * <dd>Both <tt>shashtabs_hash</tt> and <tt>shashtabs_hash_r</tt> arguments are
+ * <tt>NULL</tt>.</dd>
+ * <dd><tt>al</tt> holds fewer allocators than there are shards, once rounded
+ * up to a power of two.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User provided compare function.
+ * @param[in] cmp_r User provided reentrant compare function.
+ * @param[in] hash User provided hashing function.
+ * @param[in] hash_r User provided reentrant hashing function.
+ * @param[in] n Hint for the number of elements.
+ * @param[in] shards Number of shards, at least 1.
+ * @param[in] al Allocators of the shards.
+ *
+ * @return Instance of sharded hash table object.
+ */
+extern shashtabs_t shashtabs_new_alloc(shashtabs_data_cmp cmp,
+                                       shashtabs_data_cmp_r cmp_r,
+                                       shashtabs_hash hash,
+                                       shashtabs_hash_r hash_r, size_t n,
+                                       size_t shards, const allocators_t *al);
+
+/**
+ * @brief Inserts pointer to data object into sharded hash table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_insert</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being added to hash table object.
+ */
+extern void shashtabs_insert(shashtabs_t t, const void *x);
+
+/**
+ * @brief Inserts pointer to data object into sharded hash table object.
+ *
+ * Reentrant version of <tt>shashtabs_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_insert_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being added to.
+ * @param[in] x Pointer to data being added to hash table object.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ */
+extern void shashtabs_insert_r(shashtabs_t t, const void *x,
+                               const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Removes pointer to data object from sharded hash table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_remove</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being removed from.
+ * @param[in] x Pointer to data equal to the data being removed.
+ *
+ * @return Pointer to the removed data, or <tt>NULL</tt> if not present.
+ */
+extern void *shashtabs_remove(shashtabs_t t, const void *x);
+
+/**
+ * @brief Removes pointer to data object from sharded hash table object.
+ *
+ * Reentrant version of <tt>shashtabs_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_remove_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being removed from.
+ * @param[in] x Pointer to data equal to the data being removed.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the removed data, or <tt>NULL</tt> if not present.
+ */
+extern void *shashtabs_remove_r(shashtabs_t t, const void *x,
+                                const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Finds data object in sharded hash table object.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_find</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *shashtabs_find(shashtabs_t t, const void *x);
+
+/**
+ * @brief Finds data object in sharded hash table object.
+ *
+ * Reentrant version of <tt>shashtabs_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_find_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being searched.
+ * @param[in] x Pointer to data equal to the data being searched for.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ * @param[in] queue_arg Argument to user provided reentrant compare function.
+ *
+ * @return Pointer to the data found, or <tt>NULL</tt> if not present.
+ */
+extern void *shashtabs_find_r(shashtabs_t t, const void *x,
+                              const void *hash_arg, void *queue_arg);
+
+/**
+ * @brief Apply function to every member of sharded hash table object.
+ *
+ * Shards are visited in order. Early termination is possible if
+ * <tt>apply</tt> returns a negative <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_map</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int shashtabs_map(shashtabs_t t, int apply(void **x));
+
+/**
+ * @brief Apply function to every member of sharded hash table object.
+ *
+ * Reentrant version of <tt>shashtabs_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_map_r</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being acted upon.
+ * @param[in] apply Function being applied to members of the hash table.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int shashtabs_map_r(shashtabs_t t, int apply(void **x, void *y),
+                           void *y);
+
+/**
+ * @brief Free data allocated for the sharded hash table.
+ *
+ * Frees every shard. The data pointed to by the structure is not freed.
+ *
+ * @param[in] *t Pointer to hash table object.
+ */
+extern void shashtabs_free(shashtabs_t *t);
+
+/**
+ * @brief Number of elements in sharded hash table.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_size</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of elements in every shard.
+ */
+extern size_t shashtabs_size(shashtabs_t t);
+
+/**
+ * @brief Number of shards of sharded hash table.
+ *
+ * @param[in] t Hash table object being checked.
+ *
+ * @return Number of shards, a power of two.
+ */
+extern size_t shashtabs_shards(shashtabs_t t);
+
+/**
+ * @brief Shard of data object.
+ *
+ * Index of the shard in which data equal to <tt>x</tt> is or would be held,
+ * for a thread to lock before operating on it.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>shashtabs_shardof</tt> on a <tt>NULL</tt> hash table
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object.
+ * @param[in] x Pointer to data.
+ *
+ * @return Index of shard, less than <tt>shashtabs_shards(t)</tt>.
+ */
+extern size_t shashtabs_shardof(shashtabs_t t, const void *x);
+
+/**
+ * @brief Shard of data object.
+ *
+ * Reentrant version of <tt>shashtabs_shardof</tt>.
+ *
+ * @param[in] t Hash table object.
+ * @param[in] x Pointer to data.
+ * @param[in] hash_arg Argument to user provided reentrant hashing function.
+ *
+ * @return Index of shard, less than <tt>shashtabs_shards(t)</tt>.
+ */
+extern size_t shashtabs_shardof_r(shashtabs_t t, const void *x,
+                                  const void *hash_arg);
+
+/**
+ * @brief Shard of sharded hash table.
+ *
+ * The shard is owned by the sharded table. It may be passed to those functions
+ * of <tt>hashtabs_t</tt> neither hashing nor comparing data, such as
+ * <tt>hashtabs_size</tt>, <tt>hashtabs_stats</tt>, <tt>hashtabs_resize</tt>,
+ * <tt>hashtabs_map</tt> and the cursors, to inspect or resize one shard on its
+ * own.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>i</tt> is not less than <tt>shashtabs_shards(t)</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] t Hash table object.
+ * @param[in] i Index of shard.
+ *
+ * @return Shard <tt>i</tt>.
+ */
+extern hashtabs_t shashtabs_shard(shashtabs_t t, size_t i);
+
+# endif
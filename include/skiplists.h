@@ -0,0 +1,329 @@
+/**
+ * @file skiplists.h
+ * @brief Public interface of <tt>skiplists_t</tt> class
+ *
+ * The <tt>skiplists_t</tt> object instantiates shallow ordered-set associations
+ * between already existing data, with the interface of <tt>queues_t</tt>: data
+ * is kept sorted, may be dequeued from the front or the back, searched for and
+ * removed. Where <tt>queues_t</tt> walks its list, <tt>skiplists_t</tt> is a skip
+ * list (W. Pugh, "Skip lists: a probabilistic alternative to balanced trees",
+ * 1990), so that inserts, finds and removes take expected O(log n) compares.
+ * Dequeueing takes no compares.
+ *
+ * The user is responsible for allocating and deallocating the data. The routine
+ * <tt>skiplists_free</tt> only deallocates the links between data.
+ *
+ * Repetitions are not allowed, and data must be linearly ordered.
+ *
+ * The <tt>skiplists_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_SKIPLISTS_H
+# define INCLUDED_SKIPLISTS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Maximum number of levels of a skip list. With one node in four
+ * promoted per level, this suffices for 2^64 elements.
+ */
+# define SKIPLISTS_MAXLEVEL 32
+
+typedef struct skiplists_t* skiplists_t;
+
+/**
+ * @brief User provided compare function. Must provide a linear ordering of the
+ * data.
+ */
+typedef int (*skiplists_data_cmp)(const void*, const void*);
+
+/**
+ * @brief User provided reentrant compare function. Must provide a linear ordering
+ * of the data.
+ */
+typedef int (*skiplists_data_cmp_r)(const void*, const void*, void*);
+
+/**
+ * @brief Instantiates a <tt>skiplists_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>skiplists_t</tt> instance. This memory needs
+ * to be freed by a call to <tt>skiplists_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>skiplists_data_cmp</tt> and <tt>skiplists_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ *
+ * @return Instance of skip list object.
+ */
+extern skiplists_t skiplists_new(skiplists_data_cmp cmp,
+                                 skiplists_data_cmp_r cmp_r);
+
+/**
+ * @brief Instantiates a <tt>skiplists_t</tt> instance with a user allocator.
+ *
+ * As <tt>skiplists_new</tt>, but the skip list object and its links are allocated
+ * and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Both <tt>skiplists_data_cmp</tt> and <tt>skiplists_data_cmp_r</tt>
+ * arguments are <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] cmp User function to compare relative ordering of two data objects.
+ * @param[in] cmp_r Reentrant version of <tt>cmp</tt>.
+ * @param[in] al Allocator of the skip list.
+ *
+ * @return Instance of skip list object.
+ */
+extern skiplists_t skiplists_new_alloc(skiplists_data_cmp cmp,
+                                       skiplists_data_cmp_r cmp_r,
+                                       const allocators_t *al);
+
+/**
+ * @brief Inserts pointer to data object into skip list object.
+ *
+ * If a data object equal to the user provided data parameter is not present in
+ * the skip list, then a pointer to the data is added in its place in the order.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_insert</tt> on a <tt>NULL</tt> skip list
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being added to.
+ * @param[in] x Pointer to data being added to skip list object.
+ */
+extern void skiplists_insert(skiplists_t s, const void *x);
+
+/**
+ * @brief Inserts pointer to data object into skip list object.
+ *
+ * Reentrant version of <tt>skiplists_insert</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_insert_r</tt> on a <tt>NULL</tt> skip list
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being added to.
+ * @param[in] x Pointer to data being added to skip list object.
+ * @param[in] y Argument to user provided reentrant compare function.
+ */
+extern void skiplists_insert_r(skiplists_t s, const void *x, void *y);
+
+/**
+ * @brief Remove least object of skip list object.
+ *
+ * A pointer to the least data object of the skip list is returned and its link
+ * removed. If the skip list is empty, <tt>NULL</tt> is returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_dequeue_front</tt> on a <tt>NULL</tt> skip list
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being popped.
+ *
+ * @return Pointer to least data object.
+ */
+extern void *skiplists_dequeue_front(skiplists_t s);
+
+/**
+ * @brief Remove greatest object of skip list object.
+ *
+ * A pointer to the greatest data object of the skip list is returned and its
+ * link removed. If the skip list is empty, <tt>NULL</tt> is returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_dequeue_back</tt> on a <tt>NULL</tt> skip list
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being popped.
+ *
+ * @return Pointer to greatest data object.
+ */
+extern void *skiplists_dequeue_back(skiplists_t s);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in skip
+ * list object.
+ *
+ * Check if data equal to user provided data object is contained in skip list
+ * object. Return pointer to data if found; otherwise, <tt>NULL</tt> is returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_find</tt> on <tt>NULL</tt> skip list object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being searched.
+ * @param[in] x Data whose membership is being checked.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *skiplists_find(skiplists_t s, const void *x);
+
+/**
+ * @brief Check if data equal to user provided data object is contained in skip
+ * list object.
+ *
+ * Reentrant version of <tt>skiplists_find</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_find_r</tt> on <tt>NULL</tt> skip list object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being searched.
+ * @param[in] x Data whose membership is being checked.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *skiplists_find_r(skiplists_t s, const void *x, void *y);
+
+/**
+ * @brief Remove pointer to data object in skip list object (if present) equal in
+ * value to the data object parameter provided by the user.
+ *
+ * If found, the link to the data object is removed from the skip list and a
+ * pointer to the data returned to the user. If not found, <tt>NULL</tt> is
+ * returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_remove</tt> on <tt>NULL</tt> skip list object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *skiplists_remove(skiplists_t s, const void *x);
+
+/**
+ * @brief Remove pointer to data object in skip list object (if present) equal in
+ * value to the data object parameter provided by the user.
+ *
+ * Reentrant version of <tt>skiplists_remove</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_remove_r</tt> on <tt>NULL</tt> skip list
+ * object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being altered.
+ * @param[in] x Pointer to data object being searched for.
+ * @param[in] y Argument to user provided compare function.
+ *
+ * @return Pointer to data object if found. <tt>NULL</tt> otherwise.
+ */
+extern void *skiplists_remove_r(skiplists_t s, const void *x, void *y);
+
+/**
+ * @brief Apply function to every member of skip list object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the skip list, in
+ * order. Early termination is possible if <tt>apply</tt> returns a negative
+ * <tt>int</tt>. In all other cases, we continue to apply <tt>apply</tt> to the
+ * succeeding data object (if any) of the skip list.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being acted upon.
+ * @param[in] apply Function being applied to members of the skip list.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int skiplists_map(skiplists_t s, int apply(void **x));
+
+/**
+ * @brief Apply function to every member of skip list object.
+ *
+ * Reentrant version of <tt>skiplists_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>apply</tt> changes the ordering of the data.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being acted upon.
+ * @param[in] apply Function being applied to members of the skip list.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int skiplists_map_r(skiplists_t s, int apply(void **x, void *y), void *y);
+
+/**
+ * @brief Free data allocated for the skip list associations.
+ *
+ * Only the links between data are freed.
+ *
+ * @param[in] *s Pointer to <tt>skiplists_t</tt> object.
+ */
+extern void skiplists_free(skiplists_t *s);
+
+/**
+ * @brief Number of elements in skip list.
+ *
+ * Number of elements in skip list.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>skiplists_size</tt> on a <tt>NULL</tt> skip list object.</dd>
+ * </dl>
+ *
+ * @param[in] s Skip list object being checked.
+ *
+ * @return Number of members of the skip list.
+ */
+extern size_t skiplists_size(skiplists_t s);
+
+/**
+ * @brief Swap opaque pointers for skip lists.
+ *
+ * Swap opaque pointers for skip lists.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Skip list objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] s1 First skip list.
+ * @param[in] s2 Second skip list.
+ */
+static inline
+void skiplists_swap(skiplists_t *restrict s1, skiplists_t *restrict s2)
+{
+  volatile skiplists_t tmp = *s1;
+  *s1 = *s2;
+  *s2 = tmp;
+}
+
+# endif
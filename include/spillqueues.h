@@ -0,0 +1,132 @@
+/**
+ * @file spillqueues.h
+ * @brief Public interface of <tt>spillqueues_t</tt> class
+ *
+ * The <tt>spillqueues_t</tt> object instantiates a first in, first out queue
+ * that may hold more elements than fit in memory. Only two buffers of one
+ * segment each are kept in memory: the head, from which elements are popped,
+ * and the tail, to which they are pushed. A full tail is written as one
+ * segment to the end of a temporary file, and an empty head is refilled by
+ * reading the oldest segment back, so that the file is only ever written and
+ * read sequentially. Once a segment is read, the kernel is told to read the
+ * next one ahead, and the space of the segment read is given back to the file
+ * system where it allows.
+ *
+ * A queue that stays within its head never touches its file, which is made,
+ * and at once unlinked, on the first spill.
+ *
+ * As for <tt>dqueues_t</tt> and <tt>deques_t</tt>, elements are <tt>size</tt>
+ * bytes copied into and out of the queue. Elements hold no pointers, which do
+ * not survive the trip through the file unless the data they point to does.
+ * Errors of the file, such as a full disk, are fatal, as are failures of
+ * <tt>malloc</tt>.
+ *
+ * The <tt>spillqueues_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_SPILLQUEUES_H
+# define INCLUDED_SPILLQUEUES_H
+
+# include <stddef.h>
+
+typedef struct spillqueues_t* spillqueues_t;
+
+/**
+ * @brief Instantiates a <tt>spillqueues_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>spillqueues_t</tt> instance and its two
+ * buffers. This memory needs to be freed by a call to
+ * <tt>spillqueues_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Size parameter is not equal to total size of data.</dd>
+ * </dl>
+ *
+ * @param[in] size Total size of data objects.
+ * @param[in] segment Bytes of a segment, rounded down to a multiple of
+ * <tt>size</tt>, at least one element. 0 takes a megabyte.
+ * @param[in] dir Directory of the temporary file. <tt>NULL</tt> takes the
+ * environment variable <tt>TMPDIR</tt>, or <tt>/tmp</tt>.
+ *
+ * @return Instance of queue object.
+ */
+extern spillqueues_t spillqueues_new(size_t size, size_t segment,
+                                     const char *dir);
+
+/**
+ * @brief Push element to the back of queue.
+ *
+ * The element is copied. Takes constant time, and a sequential write of one
+ * segment every segment of elements once the queue outgrows its head.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>spillqueues_push</tt> on a <tt>NULL</tt> queue object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being pushed to.
+ * @param[in] x Pointer to data being copied into queue object.
+ */
+extern void spillqueues_push(spillqueues_t q, const void *x);
+
+/**
+ * @brief Pop the front element of queue.
+ *
+ * The front element is removed from the queue and, if <tt>x</tt> is not
+ * <tt>NULL</tt>, copied to <tt>x</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>spillqueues_pop</tt> on a <tt>NULL</tt> queue object.</dd>
+ * </dl>
+ *
+ * @param[in] q Queue object being popped.
+ * @param[out] x Buffer of <tt>size</tt> bytes receiving the element, or
+ * <tt>NULL</tt>.
+ *
+ * @return 1 if an element was popped. -1 if the queue is empty.
+ */
+extern int spillqueues_pop(spillqueues_t q, void *x);
+
+/**
+ * @brief Frees memory of queue object and its temporary file.
+ *
+ * @param[in] q Pointer to queue object being freed.
+ */
+extern void spillqueues_free(spillqueues_t *q);
+
+/**
+ * @brief Number of elements in queue.
+ *
+ * @param[in] q Queue object.
+ *
+ * @return Number of elements.
+ */
+extern size_t spillqueues_nmem(spillqueues_t q);
+
+/**
+ * @brief Number of elements of queue held in its file.
+ *
+ * @param[in] q Queue object.
+ *
+ * @return Number of elements on disk.
+ */
+extern size_t spillqueues_spilled(spillqueues_t q);
+
+/**
+ * @brief Size of elements of queue.
+ *
+ * @param[in] q Queue object.
+ *
+ * @return Size of elements.
+ */
+extern size_t spillqueues_size(spillqueues_t q);
+
+# endif
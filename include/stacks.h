@@ -9,7 +9,10 @@
  * <tt>stacks_free</tt> only deallocates the links between data created by envoking
  * <tt>stacks_new</tt> and <tt>stacks_push</tt>.
  *
- * The <tt>stacks_t</tt> class is implemented as an opaque pointer.
+ * The <tt>stacks_t</tt> class is implemented as an opaque pointer. With
+ * <tt>CONTAINERS_INLINE</tt> defined, <tt>stacks_empty</tt> and
+ * <tt>stacks_size</tt> are <tt>static inline</tt>, reading the number of
+ * elements that leads the stack object.
  *
  * @warning This class is meant to be used in time restricted settings. As such,
  * some runtime errors, such as out-of-bounds-type errors, are note explicitly
@@ -24,6 +27,8 @@
 # include <stdlib.h>
 # include <stddef.h>
 
+# include "allocators.h"
+
 typedef struct stacks_t* stacks_t;
 
 /**
@@ -36,6 +41,47 @@ typedef struct stacks_t* stacks_t;
  */
 extern stacks_t stacks_new(void);
 
+/**
+ * @brief Instantiate a <tt>stacks_t</tt> instance with a user allocator.
+ *
+ * As <tt>stacks_new</tt>, but the stack object and its links are allocated and
+ * freed through <tt>al</tt>.
+ *
+ * @param[in] al Allocator of the stack.
+ *
+ * @return Opaque pointer to stack object.
+ */
+extern stacks_t stacks_new_alloc(const allocators_t *al);
+
+/**
+ * @brief Instantiate a <tt>stacks_t</tt> instance whose links are pooled.
+ *
+ * As <tt>stacks_new</tt>, but the links of the stack are allocated from a private
+ * <tt>pools_t</tt> slab allocator. <tt>stacks_free</tt> then frees the links one
+ * slab at a time instead of one link at a time.
+ *
+ * @return Opaque pointer to stack object.
+ */
+extern stacks_t stacks_new_pooled(void);
+
+/**
+ * @brief Instantiate a <tt>stacks_t</tt> instance whose links are compact.
+ *
+ * As <tt>stacks_new</tt>, but the links of the stack are taken from chunks of
+ * twice the size of the one before, and name each other by 32-bit index instead
+ * of by pointer. A link is then 12 bytes rather than 16, without the header of
+ * an allocation, and freed links are reused before fresh ones. The chunks are
+ * kept by <tt>stacks_clear</tt> and freed by <tt>stacks_free</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The stack holds more than <tt>UINT32_MAX</tt> elements.</dd>
+ * </dl>
+ *
+ * @return Opaque pointer to stack object.
+ */
+extern stacks_t stacks_new_compact(void);
+
 /**
  * @brief Push existing data onto stack.
  *
@@ -86,6 +132,23 @@ extern void *stacks_pop(stacks_t s);
  */
 extern void stacks_free(stacks_t *s);
 
+/**
+ * @brief Remove every element of stack.
+ *
+ * The links of the stack are freed, or, for a stack of
+ * <tt>stacks_new_pooled</tt> or <tt>stacks_new_compact</tt>, all returned to
+ * its pool or chunks at once for reuse by later pushes. The data pointed to by
+ * the stack is not freed.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>stacks_clear</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being cleared.
+ */
+extern void stacks_clear(stacks_t s);
+
 /**
  * @brief Check if <tt>stacks_t</tt> object is empty.
  *
@@ -100,7 +163,15 @@ extern void stacks_free(stacks_t *s);
  *
  * @return True if empty. False otherwise.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+int stacks_empty(stacks_t s)
+{
+  return *(const size_t*)(void*)s == 0;
+}
+# else
 extern int stacks_empty(stacks_t s);
+# endif
 
 /**
  * @brief Number of elements in stack.
@@ -116,7 +187,15 @@ extern int stacks_empty(stacks_t s);
  *
  * @return Number of members of the stack.
  */
+# ifdef CONTAINERS_INLINE
+static inline
+size_t stacks_size(stacks_t s)
+{
+  return *(const size_t*)(void*)s;
+}
+# else
 extern size_t stacks_size(stacks_t s);
+# endif
 
 /**
  * @brief Apply function to every member of stack object.
@@ -156,6 +235,69 @@ extern int stacks_map(stacks_t s, int apply(void **x));
  */
 extern int stacks_map_r(stacks_t s, int apply(void **x, void *y), void *y);
 
+/**
+ * @brief Cursor over the elements of a stack, from top to bottom.
+ *
+ * A cursor is started by <tt>stacks_iterinit</tt> and advanced by
+ * <tt>stacks_iternext</tt>; unlike <tt>stacks_map</tt>, the loop body is the
+ * user's own code. A cursor stays valid while the stack is not changed; pushes
+ * and pops invalidate it.
+ */
+typedef struct {
+  void *x;    ///< element at cursor
+  void *node; ///< link of element at cursor, <tt>NULL</tt> past the bottom
+  stacks_t s; ///< stack of cursor
+} stacks_iter_t;
+
+/**
+ * @brief Starts cursor at top of stack.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>stacks_iterinit</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being visited.
+ * @param[out] it Cursor being started.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 if the stack
+ * is empty.
+ */
+extern int stacks_iterinit(stacks_t s, stacks_iter_t *it);
+
+/**
+ * @brief Advances cursor to the next element of stack.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the bottom of the stack.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor being advanced.
+ *
+ * @retval int Returns 1 if the cursor is at an element. Returns -1 once it is
+ * past the bottom of the stack.
+ */
+extern int stacks_iternext(stacks_iter_t *it);
+
+/**
+ * @brief Element at cursor.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Cursor is past the bottom of the stack.</dd>
+ * </dl>
+ *
+ * @param[in] it Cursor of stack.
+ *
+ * @return Pointer to the data object at the cursor.
+ */
+static inline
+void *stacks_iterget(const stacks_iter_t *it)
+{
+  return it->x;
+}
+
 /**
  * @brief Swap opaque pointers for stacks.
  *
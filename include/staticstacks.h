@@ -4,6 +4,21 @@
  *
  * Public interface for a generic stack of fixed capacity.
  *
+ * A stack may instead grow: <tt>sstacks_dynpush</tt> reallocates the data array
+ * geometrically when it is full, so the stack need not be sized for the worst
+ * case. <tt>sstacks_push</tt> stays the unchecked fast path; defining
+ * <tt>SSTACKS_DEBUG</tt> before including this header makes it assert that the
+ * stack is not full.
+ *
+ * Backtracking searches save a mark of the stack with <tt>sstacks_mark</tt>
+ * and return to it with <tt>sstacks_rollback</tt>, in constant time whatever
+ * the number of elements pushed since. An <tt>sstrails_t</tt> trail
+ * checkpoints several stacks together, as the trail of a SAT solver.
+ *
+ * <tt>DEFINE_SSTACKS(name, T)</tt> emits a stack <tt>name_t</tt> of elements of
+ * type <tt>T</tt>. Its element size is a compile time constant, so pushes and
+ * pops are plain loads and stores rather than calls to <tt>memcpy</tt>.
+ *
  * @warning This is meant to be a lightweight and fast implementation of a fixed
  * capacity stack object. As such, various checks for out-of-bounds-type errors
  * are not implemented. It is left to the user for responsible use of the data
@@ -18,6 +33,11 @@
 # include <stdlib.h>
 # include <stddef.h>
 # include <string.h>
+# include <errno.h>
+# include <error.h>
+# ifdef SSTACKS_DEBUG
+# include <assert.h>
+# endif
 
 /**
  * @brief Static struct object.
@@ -25,10 +45,11 @@
  * Static struct object.
  */
 typedef struct {
-  size_t size; ///< size in bytes of data objects
-  size_t nmem; ///< number of elements currently in stack
-  char *x;     ///< data array
-  char *top;   ///< one past head of data array
+  size_t size;     ///< size in bytes of data objects
+  size_t nmem;     ///< number of elements currently in stack
+  size_t capacity; ///< number of elements the data array holds
+  char *x;         ///< data array
+  char *top;       ///< one past head of data array
 } sstacks_t;
 
 /**
@@ -38,13 +59,15 @@ typedef struct {
  *
  * @param[in,out] s Static stack instance. Should be <tt>NULL</tt>.
  * @param[in] size Size in bytes of data objects.
- * @param[in] capacity Maximum number of objects the stack will hold.
+ * @param[in] cap Maximum number of objects the stack will hold, or initial
+ * number for a stack grown by <tt>sstacks_dynpush</tt>.
  */
-# define sstacks_new(s, n, capacity) do {                           \
+# define sstacks_new(s, n, cap) do {                                \
     (s) = (sstacks_t*)malloc(sizeof(sstacks_t));                    \
     (s)->size = (n);                                                \
     (s)->nmem = 0;                                                  \
-    (s)->x = (char*)malloc(((capacity) + 1) * (n) * sizeof(char));  \
+    (s)->capacity = (cap);                                          \
+    (s)->x = (char*)malloc(((cap) + 1) * (n) * sizeof(char));       \
     (s)->top = (s)->x;                                              \
   } while (0)
 
@@ -62,7 +85,46 @@ typedef struct {
  * @param[in] s Static stack instance.
  * @param[in] x Data object being copied onto top of stack.
  */
+# ifdef SSTACKS_DEBUG
+# define sstacks_push(s, x) ((void) (assert((s)->nmem < (s)->capacity), memcpy((s)->top, x, (s)->size), (s)->top += (s)->size, (s)->nmem++))
+# else
 # define sstacks_push(s, x) ((void) (memcpy((s)->top, x, (s)->size), (s)->top += (s)->size, (s)->nmem++))
+# endif
+
+/**
+ * @brief Grow data array of static stack by half.
+ *
+ * Grow data array of static stack by half, and re-derive <tt>top</tt> from the
+ * reallocated array. Called by <tt>sstacks_dynpush</tt>.
+ *
+ * @param[in] s Static stack.
+ */
+static inline
+void sstacks_grow(sstacks_t *s)
+{
+  size_t c = s->capacity < 2 ? s->capacity + 1 : (3 * s->capacity) >> 1;
+  if ( (s->x = (char*)realloc(s->x, (c + 1) * s->size)) == NULL )
+    error(1, errno, "realloc failure");
+  s->capacity = c;
+  s->top = s->x + s->nmem * s->size;
+}
+
+/**
+ * @brief Push data object onto static stack, growing it if full.
+ *
+ * As <tt>sstacks_push</tt>, but a full stack is first grown by
+ * <tt>sstacks_grow</tt>. Pointers previously returned by <tt>sstacks_pop</tt>
+ * are invalidated by growth.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>sstacks_dynpush</tt> on a <tt>NULL</tt> stack.</dd>
+ * </dl>
+ *
+ * @param[in] s Static stack instance.
+ * @param[in] x Data object being copied onto top of stack.
+ */
+# define sstacks_dynpush(s, x) ((void) ((s)->nmem == (s)->capacity ? sstacks_grow(s) : (void) 0), sstacks_push(s, x))
 
 /**
  * @brief Pop and return top of static stack.
@@ -81,6 +143,23 @@ typedef struct {
  */
 # define sstacks_pop(s) ((s)->nmem--, (s)->top -= (s)->size, (s)->top)
 
+/**
+ * @brief Return top of static stack without popping it.
+ *
+ * Return top of static stack without popping it.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>sstacks_top</tt> on a <tt>NULL</tt> stack.</dd>
+ * <dd>Calling <tt>sstacks_top</tt> on an empty stack.</dd>
+ * </dl>
+ *
+ * @param[in] s Static stack.
+ *
+ * @return <tt>char*</tt> pointer to top element of array.
+ */
+# define sstacks_top(s) ((s)->top - (s)->size)
+
 /**
  * @brief Check if static stack is empty.
  *
@@ -125,4 +204,290 @@ typedef struct {
  */
 # define sstacks_size(s) ((s)->nmem)
 
+/**
+ * @brief Number of elements a static stack holds before growing.
+ *
+ * Number of elements a static stack holds before growing.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>sstacks_capacity</tt> on a <tt>NULL</tt> stack.</dd>
+ * </dl>
+ *
+ * @param[in] s Static stack.
+ */
+# define sstacks_capacity(s) ((s)->capacity)
+
+/**
+ * @brief Mark of static stack.
+ *
+ * Mark of static stack, to be returned to by <tt>sstacks_rollback</tt>. The
+ * mark is the number of elements, so it survives growth by
+ * <tt>sstacks_dynpush</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>sstacks_mark</tt> on a <tt>NULL</tt> stack.</dd>
+ * </dl>
+ *
+ * @param[in] s Static stack.
+ */
+# define sstacks_mark(s) ((s)->nmem)
+
+/**
+ * @brief Return static stack to a mark.
+ *
+ * Drops every element pushed since <tt>sstacks_mark</tt> returned
+ * <tt>mk</tt>, in constant time.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>sstacks_rollback</tt> on a <tt>NULL</tt> stack.</dd>
+ * <dd>Rolling back to a mark above the current number of elements.</dd>
+ * </dl>
+ *
+ * @param[in] s Static stack.
+ * @param[in] mk Mark of stack.
+ */
+# ifdef SSTACKS_DEBUG
+# define sstacks_rollback(s, mk) ((void) (assert((mk) <= (s)->nmem), (s)->nmem = (mk), (s)->top = (s)->x + (s)->nmem * (s)->size))
+# else
+# define sstacks_rollback(s, mk) ((void) ((s)->nmem = (mk), (s)->top = (s)->x + (s)->nmem * (s)->size))
+# endif
+
+/**
+ * @brief Trail of static stacks.
+ *
+ * Checkpoints a fixed set of static stacks together. Each checkpoint pushes the
+ * marks of all of the stacks onto <tt>marks</tt>, one element of
+ * <tt>k</tt> marks per level.
+ */
+typedef struct {
+  size_t k;          ///< number of stacks
+  sstacks_t **s;     ///< stacks of the trail
+  sstacks_t *marks;  ///< marks of the stacks at each level
+} sstrails_t;
+
+/**
+ * @brief Instantiates a trail over static stacks.
+ *
+ * The trail holds pointers to the stacks, which must outlive it, and starts
+ * at level 0. Memory is freed by <tt>sstrails_free</tt>, which leaves the
+ * stacks alone.
+ *
+ * @param[in] s Stacks of the trail.
+ * @param[in] k Number of stacks.
+ * @param[in] cap Initial number of levels.
+ *
+ * @return New trail.
+ */
+static inline
+sstrails_t *sstrails_new(sstacks_t *const s[], size_t k, size_t cap)
+{
+  sstrails_t *t;
+  if ( (t = (sstrails_t*)malloc(sizeof(*t))) == NULL
+       || (t->s = (sstacks_t**)malloc((k + 1) * sizeof(*t->s))) == NULL )
+    error(1, errno, "malloc failure");
+  memcpy(t->s, s, k * sizeof(*t->s));
+  t->k = k;
+  sstacks_new(t->marks, k * sizeof(size_t), cap);
+  return t;
+}
+
+/**
+ * @brief Checkpoint the stacks of a trail.
+ *
+ * Marks every stack and opens a new level, growing the trail as needed.
+ *
+ * @param[in] t Trail.
+ *
+ * @return Level of the checkpoint, from 1.
+ */
+static inline
+size_t sstrails_checkpoint(sstrails_t *t)
+{
+  if ( t->marks->nmem == t->marks->capacity ) sstacks_grow(t->marks);
+  size_t *mk = (size_t*)t->marks->top;
+  for ( size_t i = 0; i < t->k; i++ ) mk[i] = sstacks_mark(t->s[i]);
+  t->marks->top += t->marks->size;
+  return ++t->marks->nmem;
+}
+
+/**
+ * @brief Current level of a trail.
+ *
+ * @param[in] t Trail.
+ *
+ * @return Number of checkpoints not rolled back.
+ */
+static inline
+size_t sstrails_level(const sstrails_t *t)
+{
+  return t->marks->nmem;
+}
+
+/**
+ * @brief Return the stacks of a trail to a level.
+ *
+ * Rolls every stack back to its mark at checkpoint <tt>level</tt>, and
+ * discards that checkpoint and the later ones, so that the trail is left at
+ * level <tt>level - 1</tt>. Costs one <tt>sstacks_rollback</tt> per stack,
+ * whatever the number of levels or elements dropped.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd><tt>level</tt> is 0 or above the current level.</dd>
+ * <dd>A stack was popped below its mark after the checkpoint.</dd>
+ * </dl>
+ *
+ * @param[in] t Trail.
+ * @param[in] level Level being returned to.
+ */
+static inline
+void sstrails_backjump(sstrails_t *t, size_t level)
+{
+  const size_t *mk;
+  mk = (const size_t*)(t->marks->x + (level - 1) * t->marks->size);
+  for ( size_t i = 0; i < t->k; i++ ) sstacks_rollback(t->s[i], mk[i]);
+  sstacks_rollback(t->marks, level - 1);
+}
+
+/**
+ * @brief Return the stacks of a trail to the last checkpoint.
+ *
+ * As <tt>sstrails_backjump</tt> to the current level.
+ *
+ * @param[in] t Trail.
+ */
+static inline
+void sstrails_backtrack(sstrails_t *t)
+{
+  sstrails_backjump(t, t->marks->nmem);
+}
+
+/**
+ * @brief Free memory allocated for trail.
+ *
+ * The stacks of the trail are not freed.
+ *
+ * @param[in] t Trail.
+ */
+static inline
+void sstrails_free(sstrails_t *t)
+{
+  sstacks_free(t->marks);
+  free(t->s);
+  free(t);
+}
+
+/* capacity check of the typed stacks, as for sstacks_push */
+# ifdef SSTACKS_DEBUG
+# define SSTACKS_CHECK_(s) assert((s)->nmem < (s)->capacity)
+# else
+# define SSTACKS_CHECK_(s) ((void) 0)
+# endif
+
+/**
+ * @brief Emit a static stack <tt>name_t</tt> of elements of type <tt>T</tt>.
+ *
+ * Emits <tt>name_new(capacity)</tt>, <tt>name_push(s, x)</tt>,
+ * <tt>name_dynpush(s, x)</tt>, <tt>name_pop(s)</tt>, <tt>name_top(s)</tt>,
+ * <tt>name_empty(s)</tt>, <tt>name_size(s)</tt>, <tt>name_mark(s)</tt>,
+ * <tt>name_rollback(s, mk)</tt> and <tt>name_free(s)</tt>,
+ * which behave as the <tt>sstacks_</tt> macros of the same name, except that
+ * elements are passed and returned by value. As for <tt>sstacks_push</tt>,
+ * <tt>name_push</tt> checks the capacity only if <tt>SSTACKS_DEBUG</tt> is
+ * defined.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Pushing with <tt>name_push</tt> onto a stack already at capacity.</dd>
+ * <dd>Popping from an empty stack.</dd>
+ * </dl>
+ *
+ * @param[in] name Prefix of the emitted type and functions.
+ * @param[in] T Element type.
+ */
+# define DEFINE_SSTACKS(name, T)                                            \
+  typedef struct {                                                          \
+    size_t nmem;                                                            \
+    size_t capacity;                                                        \
+    T *x;                                                                   \
+  } name##_t;                                                               \
+                                                                            \
+  static inline                                                             \
+  name##_t *name##_new(size_t capacity)                                     \
+  {                                                                         \
+    name##_t *s;                                                            \
+    if ( (s = (name##_t*)malloc(sizeof(*s))) == NULL                        \
+         || (s->x = (T*)malloc((capacity + 1) * sizeof(T))) == NULL )       \
+      error(1, errno, "malloc failure");                                    \
+    s->nmem = 0;                                                            \
+    s->capacity = capacity;                                                 \
+    return s;                                                               \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_push(name##_t *s, T x)                                        \
+  {                                                                         \
+    SSTACKS_CHECK_(s);                                                      \
+    s->x[s->nmem++] = x;                                                    \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_dynpush(name##_t *s, T x)                                     \
+  {                                                                         \
+    if ( s->nmem == s->capacity ) {                                         \
+      size_t c = s->capacity < 2                                            \
+        ? s->capacity + 1 : (3 * s->capacity) >> 1;                         \
+      if ( (s->x = (T*)realloc(s->x, (c + 1) * sizeof(T))) == NULL )        \
+        error(1, errno, "realloc failure");                                 \
+      s->capacity = c;                                                      \
+    }                                                                       \
+    s->x[s->nmem++] = x;                                                    \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  T name##_pop(name##_t *s)                                                 \
+  {                                                                         \
+    return s->x[--s->nmem];                                                 \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  T *name##_top(name##_t *s)                                                \
+  {                                                                         \
+    return s->x + s->nmem - 1;                                              \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  int name##_empty(const name##_t *s)                                       \
+  {                                                                         \
+    return s->nmem == 0;                                                    \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  size_t name##_size(const name##_t *s)                                     \
+  {                                                                         \
+    return s->nmem;                                                         \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  size_t name##_mark(const name##_t *s)                                     \
+  {                                                                         \
+    return s->nmem;                                                         \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_rollback(name##_t *s, size_t mk)                              \
+  {                                                                         \
+    s->nmem = mk;                                                           \
+  }                                                                         \
+                                                                            \
+  static inline                                                             \
+  void name##_free(name##_t *s)                                             \
+  {                                                                         \
+    free(s->x);                                                             \
+    free(s);                                                                \
+  }
+
 # endif
@@ -0,0 +1,230 @@
+/**
+ * @file unrolledstacks.h
+ * @brief Public interface of <tt>ustacks_t</tt> class.
+ *
+ * The <tt>ustacks_t</tt> object instantiates an unbounded stack whose elements
+ * are stored in linked chunks of about <tt>USTACKS_CHUNK</tt> bytes, one
+ * allocation per chunk rather than one per push as with <tt>stacks_t</tt> and
+ * <tt>dstacks_t</tt>. Chunks emptied by pops are kept until the next push, which
+ * frees all but one of them and keeps that one as a spare, so that a stack
+ * whose size hovers around a chunk boundary does not allocate and free a chunk
+ * on every push and pop.
+ *
+ * As for <tt>sstacks_t</tt>, elements are <tt>size</tt> bytes copied onto the
+ * stack. To store pointers, take <tt>size</tt> to be <tt>sizeof(void*)</tt> and
+ * pass the address of the pointer.
+ *
+ * The <tt>ustacks_t</tt> class is implemented as an opaque pointer.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_UNROLLEDSTACKS_H
+# define INCLUDED_UNROLLEDSTACKS_H
+
+# include <stdlib.h>
+# include <stddef.h>
+# include <string.h>
+
+# include "allocators.h"
+
+/**
+ * @brief Bytes per chunk of elements, header included. Elements larger than a
+ * chunk get a chunk each.
+ */
+# define USTACKS_CHUNK 4096
+
+typedef struct ustacks_t* ustacks_t;
+
+/**
+ * @brief Instantiate a <tt>ustacks_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>ustacks_t</tt> instance. This memory needs to
+ * be freed by a call to <tt>ustacks_free</tt>. No chunk is allocated before the
+ * first push.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The size parameter is unequal to the total size of the data.</dd>
+ * </dl>
+ *
+ * @param[in] size The total size of the data objects.
+ *
+ * @return Opaque pointer to stack object.
+ */
+extern ustacks_t ustacks_new(size_t size);
+
+/**
+ * @brief Instantiate a <tt>ustacks_t</tt> instance with a user allocator.
+ *
+ * As <tt>ustacks_new</tt>, but the stack object and its chunks are allocated and
+ * freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The size parameter is unequal to the total size of the data.</dd>
+ * </dl>
+ *
+ * @param[in] size The total size of the data objects.
+ * @param[in] al Allocator of the stack.
+ *
+ * @return Opaque pointer to stack object.
+ */
+extern ustacks_t ustacks_new_alloc(size_t size, const allocators_t *al);
+
+/**
+ * @brief Push a copy of data onto stack.
+ *
+ * The <tt>size</tt> bytes at <tt>x</tt> are copied onto the top of the stack. A
+ * chunk is allocated only when the top chunk is full and no spare is kept.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_push</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being pushed upon.
+ * @param[in] x Pointer to data being copied onto stack.
+ */
+extern void ustacks_push(ustacks_t s, const void *x);
+
+/**
+ * @brief Pop data object on top of stack and return to user.
+ *
+ * The top element is removed from the stack and a pointer to it is returned.
+ * The element is left in place: the pointer stays valid until the next push
+ * onto the stack, and must not be freed by the user.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_pop</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being popped.
+ *
+ * @return Pointer to top data. <tt>NULL</tt> if the stack is empty.
+ */
+extern void *ustacks_pop(ustacks_t s);
+
+/**
+ * @brief Pointer to data object on top of stack.
+ *
+ * Pointer to data object on top of stack, which is left on the stack.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_top</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being checked.
+ *
+ * @return Pointer to top data. <tt>NULL</tt> if the stack is empty.
+ */
+extern void *ustacks_top(ustacks_t s);
+
+/**
+ * @brief Free memory allocated for stack.
+ *
+ * The stack and its chunks are freed.
+ *
+ * @param[in] *s Pointer to <tt>ustacks_t</tt> object.
+ */
+extern void ustacks_free(ustacks_t *s);
+
+/**
+ * @brief Check if stack is empty.
+ *
+ * Check if stack is empty.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_empty</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being checked.
+ *
+ * @return True if empty. False otherwise.
+ */
+extern int ustacks_empty(ustacks_t s);
+
+/**
+ * @brief Number of elements in stack.
+ *
+ * Number of elements in stack.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_size</tt> on a <tt>NULL</tt> stack object.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being checked.
+ *
+ * @return Number of members of the stack.
+ */
+extern size_t ustacks_size(ustacks_t s);
+
+/**
+ * @brief Apply function to every member of stack object.
+ *
+ * The function <tt>apply</tt> is applied to every member of the stack, from top
+ * to bottom. Early termination is possible if <tt>apply</tt> returns a negative
+ * <tt>int</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_map</tt> on a <tt>NULL</tt> stack object.</dd>
+ * <dd><tt>apply</tt> pushes onto or pops from the stack.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being acted upon.
+ * @param[in] apply Function being applied to members of the stack.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int ustacks_map(ustacks_t s, int apply(void *x));
+
+/**
+ * @brief Apply function to every member of stack object.
+ *
+ * Reentrant version of <tt>ustacks_map</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>ustacks_map_r</tt> on a <tt>NULL</tt> stack object.</dd>
+ * <dd><tt>apply</tt> pushes onto or pops from the stack.</dd>
+ * </dl>
+ *
+ * @param[in] s Stack object being acted upon.
+ * @param[in] apply Function being applied to members of the stack.
+ * @param[in] y Parameter to <tt>apply</tt> function.
+ *
+ * @return -1 if early termination. 1 if no early termination.
+ */
+extern int ustacks_map_r(ustacks_t s, int apply(void *x, void *y), void *y);
+
+/**
+ * @brief Swap opaque pointers for unrolled stacks.
+ *
+ * Swap opaque pointers for unrolled stacks.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Stack objects are aliases.</dd>
+ * </dl>
+ *
+ * @param[in] s1 First stack.
+ * @param[in] s2 Second stack.
+ */
+static inline
+void ustacks_swap(ustacks_t *restrict s1, ustacks_t *restrict s2)
+{
+  volatile ustacks_t tmp = *s1;
+  *s1 = *s2;
+  *s2 = tmp;
+}
+
+# endif
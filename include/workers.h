@@ -0,0 +1,171 @@
+/**
+ * @file workers.h
+ * @brief Public interface of <tt>workers_t</tt> class
+ *
+ * The <tt>workers_t</tt> object instantiates a pool of threads which run tree
+ * shaped workloads, such as depth first searches and backtracking, in parallel.
+ * A task is a pointer to user data. The function given to
+ * <tt>workers_run</tt> is applied to the root task, and may spawn further
+ * tasks, typically the children of a node of the search, with
+ * <tt>workers_spawn</tt>. The run returns once every spawned task has been
+ * applied.
+ *
+ * Each worker keeps its tasks in a <tt>wsdeques_t</tt>, and works on the task it
+ * spawned last, so a single worker visits the tree depth first as it would with
+ * a <tt>stacks_t</tt>. An idle worker steals the oldest task of another worker,
+ * which near the root of the tree is a large share of the remaining work.
+ *
+ * Per thread scratch space, such as the bit sets of a permutation search, may be
+ * indexed by <tt>workers_self</tt>. A search may end early with
+ * <tt>workers_stop</tt>.
+ *
+ * The user is responsible for allocating and deallocating the tasks.
+ *
+ * The <tt>workers_t</tt> class is implemented as an opaque pointer. The library
+ * must be configured with threads enabled (the default) for this class to be
+ * available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_WORKERS_H
+# define INCLUDED_WORKERS_H
+
+# include <stddef.h>
+# include <stdlib.h>
+
+# include "configs.h"
+
+typedef struct workers_t* workers_t;
+
+/**
+ * @brief User provided task function. Applied to one task <tt>x</tt>, with the
+ * argument <tt>y</tt> given to <tt>workers_run</tt>.
+ */
+typedef void (*workers_task)(workers_t w, void *x, void *y);
+
+# if CONTAINERS_THREADS
+/**
+ * @brief Instantiates a <tt>workers_t</tt> instance.
+ *
+ * A pool of <tt>n</tt> workers is created: the thread calling
+ * <tt>workers_run</tt> and <tt>n - 1</tt> threads started here, which sleep
+ * between runs. The memory and threads need to be released by a call to
+ * <tt>workers_free</tt>.
+ *
+ * @param[in] n Number of workers. If 0, the number of online processors.
+ *
+ * @return Instance of pool object.
+ */
+extern workers_t workers_new(size_t n);
+
+/**
+ * @brief Apply task function to a root task and every task it spawns.
+ *
+ * The function <tt>apply</tt> is applied, by the workers of the pool, to
+ * <tt>x</tt> and to every task spawned in the meantime. Returns once no task is
+ * left.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>workers_run</tt> from inside <tt>apply</tt>.</dd>
+ * <dd>Calling <tt>workers_run</tt> on the same pool from two threads.</dd>
+ * <dd>Root task is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] w Pool object running the tasks.
+ * @param[in] apply Function being applied to tasks.
+ * @param[in] x Root task.
+ * @param[in] y Argument to user provided function apply.
+ *
+ * @return -1 if stopped by <tt>workers_stop</tt>. 1 otherwise.
+ */
+extern int workers_run(workers_t w, workers_task apply, void *x, void *y);
+
+/**
+ * @brief Add a task to the current run.
+ *
+ * The task is pushed onto the deque of the calling worker, to be applied by it
+ * or stolen by another worker.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>workers_spawn</tt> from outside the task function.</dd>
+ * <dd>Task is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] w Pool object running the tasks.
+ * @param[in] x Task being added.
+ */
+extern void workers_spawn(workers_t w, void *x);
+
+/**
+ * @brief End the current run early.
+ *
+ * Tasks not yet begun are dropped without the task function being applied to
+ * them. Tasks being applied run to completion. May be called from inside the
+ * task function or from any other thread.
+ *
+ * @param[in] w Pool object running the tasks.
+ */
+extern void workers_stop(workers_t w);
+
+/**
+ * @brief Check if the current run has been stopped.
+ *
+ * Lets a long task leave early once the run is stopped.
+ *
+ * @param[in] w Pool object running the tasks.
+ *
+ * @return 1 if stopped. -1 otherwise.
+ */
+extern int workers_stopped(workers_t w);
+
+/**
+ * @brief Index of the calling worker.
+ *
+ * Index, from 0 to <tt>workers_count(w) - 1</tt>, of the worker applying the
+ * current task. The thread calling <tt>workers_run</tt> is worker 0.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Calling <tt>workers_self</tt> from outside the task function.</dd>
+ * </dl>
+ *
+ * @param[in] w Pool object running the tasks.
+ *
+ * @return Index of calling worker.
+ */
+extern size_t workers_self(workers_t w);
+
+/**
+ * @brief Number of workers of pool.
+ *
+ * Number of workers of pool.
+ *
+ * @param[in] w Pool object being checked.
+ *
+ * @return Number of workers.
+ */
+extern size_t workers_count(workers_t w);
+
+/**
+ * @brief Free memory allocated for pool and join its threads.
+ *
+ * Free memory allocated for pool and join its threads.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>A run of the pool is in progress.</dd>
+ * </dl>
+ *
+ * @param[in] *w Pointer to <tt>workers_t</tt> object.
+ */
+extern void workers_free(workers_t *w);
+# endif
+
+# endif
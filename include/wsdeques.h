@@ -0,0 +1,142 @@
+/**
+ * @file wsdeques.h
+ * @brief Public interface of <tt>wsdeques_t</tt> class
+ *
+ * The <tt>wsdeques_t</tt> object instantiates the work-stealing deque of D.
+ * Chase and Y. Lev, in the C11 formulation of N. M. Lê et al. Its owner
+ * thread pushes and pops pointers at the bottom, last in first out, without
+ * locks and, unless the deque is nearly empty, without a read-modify-write.
+ * Any other thread may steal the pointer at the top, the oldest one, with one
+ * compare-and-swap. The deque grows when full; arrays replaced by growth are
+ * freed once no thief can still be reading them.
+ *
+ * The deque is the building block of <tt>workers_t</tt>. It stores pointers to
+ * already existing data, and the user remains responsible for that data.
+ * <tt>NULL</tt> pointers cannot be stored, since <tt>NULL</tt> reports an
+ * empty deque.
+ *
+ * The <tt>wsdeques_t</tt> class is implemented as an opaque pointer. The
+ * library must be configured with threads enabled (the default) for this class
+ * to be available.
+ *
+ * @warning This class is meant to be used in time restricted settings. As such,
+ * some runtime errors, such as out-of-bounds-type errors, are note explicitly
+ * checked for. It is left to the user to use the interface responsibly.
+ * @author Thomas Pender
+ * @date 2026-10
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_WSDEQUES_H
+# define INCLUDED_WSDEQUES_H
+
+# include <stddef.h>
+# include <stdlib.h>
+
+# include "allocators.h"
+
+typedef struct wsdeques_t* wsdeques_t;
+
+/**
+ * @brief Instantiates a <tt>wsdeques_t</tt> instance.
+ *
+ * Memory is allocated for a new <tt>wsdeques_t</tt> instance. This memory needs
+ * to be freed by a call to <tt>wsdeques_free</tt>.
+ *
+ * @param[in] capacity Initial number of pointers the deque holds.
+ *
+ * @return Instance of deque object.
+ */
+extern wsdeques_t wsdeques_new(size_t capacity);
+
+/**
+ * @brief Instantiates a <tt>wsdeques_t</tt> instance with a user allocator.
+ *
+ * As <tt>wsdeques_new</tt>, but the deque object and its arrays are allocated
+ * and freed through <tt>al</tt>.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>The functions of <tt>al</tt> are not safe to call from several
+ * threads.</dd>
+ * </dl>
+ *
+ * @param[in] capacity Initial number of pointers the deque holds.
+ * @param[in] al Allocator of the deque.
+ *
+ * @return Instance of deque object.
+ */
+extern wsdeques_t wsdeques_new_alloc(size_t capacity, const allocators_t *al);
+
+/**
+ * @brief Push pointer to data onto the bottom of deque.
+ *
+ * Push pointer to data onto the bottom of deque.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Called by a thread other than the owner of the deque.</dd>
+ * <dd>Pointer to data is <tt>NULL</tt>.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being added to.
+ * @param[in] x Pointer to data.
+ */
+extern void wsdeques_push(wsdeques_t d, void *x);
+
+/**
+ * @brief Pop pointer to data from the bottom of deque.
+ *
+ * The pointer pushed last, and not yet popped or stolen, is removed from the
+ * deque and returned.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Called by a thread other than the owner of the deque.</dd>
+ * </dl>
+ *
+ * @param[in] d Deque object being popped.
+ *
+ * @return Pointer to data. <tt>NULL</tt> if the deque is empty.
+ */
+extern void *wsdeques_pop(wsdeques_t d);
+
+/**
+ * @brief Steal pointer to data from the top of deque.
+ *
+ * The pointer pushed first, and not yet popped or stolen, is removed from the
+ * deque and returned. Safe to call from any thread.
+ *
+ * @param[in] d Deque object being stolen from.
+ *
+ * @return Pointer to data. <tt>NULL</tt> if the deque is empty, or if another
+ * thread took the pointer first.
+ */
+extern void *wsdeques_steal(wsdeques_t d);
+
+/**
+ * @brief Number of pointers in deque.
+ *
+ * Number of pointers in deque. The count may be stale by the time it is
+ * returned if other threads are using the deque.
+ *
+ * @param[in] d Deque object being checked.
+ *
+ * @return Number of pointers in deque.
+ */
+extern size_t wsdeques_size(wsdeques_t d);
+
+/**
+ * @brief Free memory allocated for deque.
+ *
+ * Only the deque is freed, not the data.
+ *
+ * <dl>
+ * <dt><strong>Unchecked Runtime Errors</strong></dt>
+ * <dd>Another thread is still using the deque.</dd>
+ * </dl>
+ *
+ * @param[in] *d Pointer to <tt>wsdeques_t</tt> object.
+ */
+extern void wsdeques_free(wsdeques_t *d);
+
+# endif
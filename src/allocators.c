@@ -0,0 +1,219 @@
+/**
+ * @file allocators.c
+ * @brief Implementation of the standard, aligned and huge page allocators.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <allocators.h>
+# include <stdint.h>
+# include <string.h>
+
+# ifdef HAVE_MMAP
+#  include <sys/mman.h>
+# endif
+
+/**
+ * @brief Alignment of the aligned and huge page allocators.
+ */
+# define ALIGN 64
+
+/**
+ * @brief Size and alignment of a huge page.
+ */
+# define HUGE ((size_t)2 << 20)
+
+/**
+ * @brief Smallest allocation of the huge page allocator given pages of its own.
+ */
+# define HUGE_MIN (HUGE / 2)
+
+/**
+ * @brief Header of a block of the huge page allocator, <tt>ALIGN</tt> bytes
+ * before the pointer returned.
+ */
+typedef struct {
+  size_t n;   ///< bytes requested
+  size_t len; ///< length of the mapping, 0 if from the aligned allocator
+} block_t;
+
+static
+void *_std_alloc(size_t n, void *ctx)
+{
+  (void)ctx;
+  return malloc(n);
+}
+
+static
+void *_std_realloc(void *p, size_t n, void *ctx)
+{
+  (void)ctx;
+  return realloc(p, n);
+}
+
+static
+void _std_free(void *p, void *ctx)
+{
+  (void)ctx;
+  free(p);
+}
+
+const allocators_t allocators_std = {
+  .alloc = _std_alloc, .realloc = _std_realloc, .free = _std_free, .ctx = NULL,
+};
+
+static inline
+size_t _round(size_t n, size_t m)
+{
+  return (n + m - 1) & ~(m - 1);
+}
+
+static
+void *_aligned_alloc(size_t n, void *ctx)
+{
+  (void)ctx;
+  return aligned_alloc(ALIGN, _round(n == 0 ? 1 : n, ALIGN));
+}
+
+/* realloc keeps the alignment of malloc only, so a misaligned result is moved */
+static
+void *_aligned_realloc(void *p, size_t n, void *ctx)
+{
+  (void)ctx;
+  void *q = realloc(p, n), *r;
+  if ( q == NULL || ((uintptr_t)q & (ALIGN - 1)) == 0 ) return q;
+  if ( (r = aligned_alloc(ALIGN, _round(n, ALIGN))) != NULL ) memcpy(r, q, n);
+  free(q);
+  return r;
+}
+
+const allocators_t allocators_aligned = {
+  .alloc = _aligned_alloc, .realloc = _aligned_realloc, .free = _std_free,
+  .ctx = NULL,
+};
+
+static inline
+block_t *_block(void *p)
+{
+  return (block_t*)((char*)p - ALIGN);
+}
+
+static inline
+int _is_huge(size_t n)
+{
+# ifdef HAVE_MMAP
+  return n + ALIGN >= HUGE_MIN;
+# else
+  (void)n;
+  return 0;
+# endif
+}
+
+# ifdef HAVE_MMAP
+/* mapping of len bytes, a multiple of HUGE, aligned to HUGE */
+static
+char *_map(size_t len)
+{
+  char *p = (char*)mmap(NULL, len + HUGE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if ( p == MAP_FAILED ) return NULL;
+  size_t head = (HUGE - ((uintptr_t)p & (HUGE - 1))) & (HUGE - 1);
+  if ( head != 0 ) munmap(p, head);
+  munmap(p + head + len, HUGE - head);
+  p += head;
+#  if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+  madvise(p, len, MADV_HUGEPAGE);
+#  endif
+  return p;
+}
+# endif
+
+static
+void *_huge_alloc(size_t n, void *ctx)
+{
+  (void)ctx;
+  block_t *b;
+# ifdef HAVE_MMAP
+  if ( _is_huge(n) ) {
+    size_t len = _round(n + ALIGN, HUGE);
+    if ( (b = (block_t*)_map(len)) == NULL ) return NULL;
+    b->n = n;
+    b->len = len;
+    return (char*)b + ALIGN;
+  }
+# endif
+  if ( (b = (block_t*)_aligned_alloc(n + ALIGN, NULL)) == NULL ) return NULL;
+  b->n = n;
+  b->len = 0;
+  return (char*)b + ALIGN;
+}
+
+static
+void _huge_free(void *p, void *ctx)
+{
+  (void)ctx;
+  if ( p == NULL ) return;
+  block_t *b = _block(p);
+# ifdef HAVE_MMAP
+  if ( b->len != 0 ) {
+    munmap(b, b->len);
+    return;
+  }
+# endif
+  free(b);
+}
+
+/*
+ * mappings shrink by unmapping their tail, and grow in place or by moving their
+ * pages to an aligned mapping with mremap, so that no byte is copied
+ */
+static
+void *_huge_realloc(void *p, size_t n, void *ctx)
+{
+  if ( p == NULL ) return _huge_alloc(n, ctx);
+  block_t *b = _block(p), *c;
+  if ( b->len == 0 && !_is_huge(n) ) {
+    if ( (c = (block_t*)_aligned_realloc(b, n + ALIGN, NULL)) == NULL ) return NULL;
+    c->n = n;
+    return (char*)c + ALIGN;
+  }
+# ifdef HAVE_MMAP
+  if ( b->len != 0 ) {
+    size_t len = _round(n + ALIGN, HUGE);
+    if ( len <= b->len ) {
+      if ( len < b->len ) munmap((char*)b + len, b->len - len);
+      b->len = len;
+      b->n = n;
+      return p;
+    }
+#  if defined(HAVE_MREMAP) && defined(MREMAP_MAYMOVE)
+    void *q = mremap(b, b->len, len, 0);
+    if ( q == MAP_FAILED ) {
+      char *t;
+      if ( (t = _map(len)) == NULL ) return NULL;
+      q = mremap(b, b->len, len, MREMAP_MAYMOVE | MREMAP_FIXED, t);
+      if ( q == MAP_FAILED ) {
+        munmap(t, len);
+        return NULL;
+      }
+    }
+#   if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+    madvise(q, len, MADV_HUGEPAGE);
+#   endif
+    c = (block_t*)q;
+    c->n = n;
+    c->len = len;
+    return (char*)c + ALIGN;
+#  endif
+  }
+# endif
+  void *q;
+  if ( (q = _huge_alloc(n, ctx)) == NULL ) return NULL;
+  memcpy(q, p, n < b->n ? n : b->n);
+  _huge_free(p, ctx);
+  return q;
+}
+
+const allocators_t allocators_huge = {
+  .alloc = _huge_alloc, .realloc = _huge_realloc, .free = _huge_free,
+  .ctx = NULL,
+};
@@ -0,0 +1,63 @@
+/**
+ * @file allocs.h
+ * @brief Checked allocation through an <tt>allocators_t</tt>.
+ *
+ * Failures are fatal, as for <tt>malloc</tt> everywhere else in the library.
+ * Allocations and frees are counted under <tt>COUNTS_KIND</tt> if operation
+ * counters are enabled.
+ *
+ * This header is private to the library.
+ * @author Thomas Pender
+ */
+# ifndef INCLUDED_ALLOCS_H
+# define INCLUDED_ALLOCS_H
+
+# include <allocators.h>
+# include <errno.h>
+# include <error.h>
+# include <string.h>
+# include "counts.h"
+
+/**
+ * @brief Bytes of a record of a deep container: a copy of <tt>size</tt> bytes,
+ * rounded up to pointer alignment, followed by room for two links.
+ *
+ * Every deep container allocates its records at this size, so that a record
+ * handed back by one may be adopted by another.
+ */
+# define RECORD(size) \
+  ((((size) + sizeof(void*) - 1) & ~(sizeof(void*) - 1)) + 2 * sizeof(void*))
+
+static inline
+void *_amalloc(const allocators_t *a, size_t n)
+{
+  void *p;
+  COUNTS_ADD(mallocs, 1);
+  if ( (p = a->alloc(n, a->ctx)) == NULL ) error(1, errno, "malloc failure");
+  return p;
+}
+
+static inline
+void *_acalloc(const allocators_t *a, size_t n, size_t size)
+{
+  return memset(_amalloc(a, n * size), 0, n * size);
+}
+
+static inline
+void *_arealloc(const allocators_t *a, void *p, size_t n)
+{
+  COUNTS_ADD(mallocs, 1);
+  if ( (p = a->realloc(p, n, a->ctx)) == NULL )
+    error(1, errno, "realloc failure");
+  return p;
+}
+
+static inline
+void _afree(const allocators_t *a, void *p)
+{
+  if ( p == NULL ) return;
+  COUNTS_ADD(frees, 1);
+  a->free(p, a->ctx);
+}
+
+# endif
@@ -4,9 +4,63 @@
  * @author Thomas Pender
  */
 # include <config.h>
+# undef CONTAINERS_INLINE
 # include <arrays.h>
 
 # include <stdio.h>
+# include <stdint.h>
+# define COUNTS_KIND COUNTERS_ARRAYS
+# include "allocs.h"
+
+# if HAVE_AVX2
+#  include <immintrin.h>
+# elif HAVE_SSE2
+#  include <emmintrin.h>
+# endif
+
+# if defined(HAVE_MMAP) && defined(HAVE_FTRUNCATE)
+#  define MAPPED 1
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+# endif
+
+# include <unistd.h>
+# ifdef HAVE_POSIX_FADVISE
+#  include <fcntl.h>
+# endif
+
+/**
+ * @brief Buckets of a radix sort digit.
+ */
+# define RADIX 256
+
+/**
+ * @brief Radix sort buckets below this many elements are insertion sorted.
+ */
+# define RADIX_SMALL 64
+
+/**
+ * @brief Bytes to which <tt>ARRAYS_GROW_PAGE</tt> rounds the data array.
+ */
+# define PAGE 4096
+
+/**
+ * @brief Bytes before the data of a file backed array, so that the data starts
+ * on a cache line.
+ */
+# define HEADER 64
+
+/**
+ * @brief First bytes of the file of a file backed array.
+ */
+# define MAGIC "CARRAYS"
+
+/**
+ * @brief Bytes read at a time by <tt>arrays_ingest</tt> if none are given.
+ */
+# define INGEST (1UL << 20)
 
 /**
  * @brief <tt>arrays_t</tt> class object.
@@ -16,23 +70,167 @@ struct arrays_t {
   size_t capacity; ///< number of possible elements of the array
   size_t nmem;     ///< number of elements currently in array
   char *x;         ///< data array
+  allocators_t al; ///< allocator of the array
+  int fd;          ///< file of a file backed array, -1 if on the heap
+  int writable;    ///< file of array is mapped for writing
+  arrays_growth_t growth; ///< growth policy of <tt>arrays_dynpush</tt>
 };
 
+_Static_assert(offsetof(struct arrays_t, size)
+               == offsetof(struct arrays_head_t, size)
+               && offsetof(struct arrays_t, capacity)
+               == offsetof(struct arrays_head_t, capacity)
+               && offsetof(struct arrays_t, nmem)
+               == offsetof(struct arrays_head_t, nmem)
+               && offsetof(struct arrays_t, x)
+               == offsetof(struct arrays_head_t, x),
+               "struct arrays_head_t does not lead struct arrays_t");
+
+/**
+ * @brief Header of the file of a file backed array.
+ */
+typedef struct {
+  char magic[8];   ///< <tt>MAGIC</tt>
+  uint64_t size;   ///< size of elements of array
+  uint64_t nmem;   ///< number of elements of array
+} header_t;
+
 arrays_t arrays_new(size_t size, size_t capacity)
+{
+  return arrays_new_alloc(size, capacity, &allocators_std);
+}
+
+arrays_t arrays_new_alloc(size_t size, size_t capacity, const allocators_t *al)
 {
   arrays_t a;
-  a = (arrays_t)malloc(sizeof(*a));
+  a = (arrays_t)_amalloc(al, sizeof(*a));
+  a->al = *al;
   a->size = size;
   a->nmem = 0;
   a->capacity = capacity;
+  a->fd = -1;
+  a->writable = 1;
+  a->growth = ARRAYS_GROW_3_2;
   if ( capacity == 0 ) a->x = NULL;
-  else {
-    if ( (a->x = (char*)malloc(a->size * a->capacity)) == NULL )
-      error(1, errno, "malloc failure");
+  else a->x = (char*)_amalloc(al, a->size * a->capacity);
+  return a;
+}
+
+# ifdef MAPPED
+static inline
+header_t *_header(arrays_t a)
+{
+  return (header_t*)(a->x - HEADER);
+}
+
+static
+char *_map(int fd, size_t len, int writable)
+{
+  void *p = mmap(NULL, len, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                 MAP_SHARED, fd, 0);
+  return p == MAP_FAILED ? NULL : (char*)p + HEADER;
+}
+
+static
+void _unmap(arrays_t a)
+{
+  if ( a->writable ) _header(a)->nmem = a->nmem;
+  munmap(_header(a), HEADER + a->size * a->capacity);
+}
+
+arrays_t arrays_create(const char *path, size_t size, size_t capacity)
+{
+  int fd;
+  size_t len = HEADER + size * capacity;
+  if ( (fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666)) < 0 ) return NULL;
+  char *x;
+  if ( ftruncate(fd, (off_t)len) < 0 || (x = _map(fd, len, 1)) == NULL ) {
+    int e = errno;
+    close(fd);
+    errno = e;
+    return NULL;
   }
+  arrays_t a;
+  a = (arrays_t)_amalloc(&allocators_std, sizeof(*a));
+  a->al = allocators_std;
+  a->size = size;
+  a->nmem = 0;
+  a->capacity = capacity;
+  a->x = x;
+  a->fd = fd;
+  a->writable = 1;
+  a->growth = ARRAYS_GROW_3_2;
+  header_t *h = _header(a);
+  memcpy(h->magic, MAGIC, sizeof(h->magic));
+  h->size = size;
+  h->nmem = 0;
   return a;
 }
 
+arrays_t arrays_open(const char *path, int writable)
+{
+  int fd;
+  struct stat st;
+  header_t h;
+  if ( (fd = open(path, writable ? O_RDWR : O_RDONLY)) < 0 ) return NULL;
+  if ( fstat(fd, &st) < 0 ) goto fail;
+  if ( (size_t)st.st_size < HEADER
+       || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h)
+       || memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.size == 0
+       || ((size_t)st.st_size - HEADER) / h.size < h.nmem ) {
+    errno = EINVAL;
+    goto fail;
+  }
+  arrays_t a;
+  char *x;
+  if ( (x = _map(fd, st.st_size, writable)) == NULL ) goto fail;
+  a = (arrays_t)_amalloc(&allocators_std, sizeof(*a));
+  a->al = allocators_std;
+  a->size = h.size;
+  a->nmem = h.nmem;
+  a->capacity = ((size_t)st.st_size - HEADER) / h.size;
+  a->x = x;
+  a->fd = fd;
+  a->writable = writable;
+  a->growth = ARRAYS_GROW_3_2;
+  return a;
+fail:
+  {
+    int e = errno;
+    close(fd);
+    errno = e;
+  }
+  return NULL;
+}
+
+int arrays_sync(arrays_t a)
+{
+  if ( a->fd < 0 || !a->writable ) return 1;
+  _header(a)->nmem = a->nmem;
+  return msync(_header(a), HEADER + a->size * a->capacity, MS_SYNC) < 0 ? -1 : 1;
+}
+# else
+arrays_t arrays_create(const char *path, size_t size, size_t capacity)
+{
+  (void)path, (void)size, (void)capacity;
+  errno = ENOSYS;
+  return NULL;
+}
+
+arrays_t arrays_open(const char *path, int writable)
+{
+  (void)path, (void)writable;
+  errno = ENOSYS;
+  return NULL;
+}
+
+int arrays_sync(arrays_t a)
+{
+  (void)a;
+  return 1;
+}
+# endif
+
 int arrays_push(arrays_t a, const void *x)
 {
   if ( a->nmem == a->capacity ) return -1;
@@ -41,16 +239,54 @@ int arrays_push(arrays_t a, const void *x)
   return 1;
 }
 
-void arrays_dynpush(arrays_t a, const void *x)
+/* capacity of the growth policy holding at least n elements */
+static
+size_t _grow(arrays_t a, size_t n)
 {
-  if ( a->nmem == a->capacity ) {
-    size_t nmem = ((a->nmem==0) ? 1 : ((a->nmem==1) ? 2 : ((3*a->nmem)>>1UL)));
-    arrays_resize(a, nmem);
+  size_t c = a->capacity;
+  switch ( a->growth ) {
+  case ARRAYS_GROW_2:
+    do c = (c == 0) ? 1 : 2 * c; while ( c < n );
+    return c;
+  case ARRAYS_GROW_PAGE:
+    c = (3 * c) >> 1UL;
+    if ( c < n ) c = n;
+    return ((c * a->size + PAGE - 1) & ~(size_t)(PAGE - 1)) / a->size;
+  default:
+    do c = ((c==0) ? 1 : ((c==1) ? 2 : ((3*c)>>1UL))); while ( c < n );
+    return c;
   }
+}
+
+void arrays_dynpush(arrays_t a, const void *x)
+{
+  if ( a->nmem == a->capacity ) arrays_resize(a, _grow(a, a->nmem + 1));
   memcpy(a->x + (a->nmem * a->size), x, a->size);
   a->nmem++;
 }
 
+void arrays_append(arrays_t a, const void *x, size_t n)
+{
+  if ( a->nmem + n > a->capacity ) arrays_resize(a, _grow(a, a->nmem + n));
+  if ( n != 0 ) memcpy(a->x + (a->nmem * a->size), x, n * a->size);
+  a->nmem += n;
+}
+
+void arrays_reserve(arrays_t a, size_t n)
+{
+  if ( n > a->capacity ) arrays_resize(a, n);
+}
+
+void arrays_shrink_to_fit(arrays_t a)
+{
+  if ( a->nmem < a->capacity ) arrays_resize(a, a->nmem);
+}
+
+void arrays_set_growth(arrays_t a, arrays_growth_t growth)
+{
+  a->growth = growth;
+}
+
 int arrays_map(arrays_t a, int apply(void *x))
 {
   for ( size_t i = 0; i < a->nmem; i++ )
@@ -87,23 +323,268 @@ void arrays_sort_r(arrays_t a, int cmp(const void *x, const void *y, void *z),
   qsort_r(a->x, a->nmem, a->size, cmp, z);
 }
 
+static inline
+uint64_t _key(const char *p, size_t width)
+{
+  if ( width == 4 ) {
+    uint32_t k;
+    memcpy(&k, p, 4);
+    return k;
+  }
+  uint64_t k;
+  memcpy(&k, p, 8);
+  return k;
+}
+
+/* move one element; constant sizes let memcpy become a load and a store */
+static inline
+void _move(char *d, const char *s, size_t size)
+{
+  switch ( size ) {
+  case 4: memcpy(d, s, 4); break;
+  case 8: memcpy(d, s, 8); break;
+  case 16: memcpy(d, s, 16); break;
+  default: memcpy(d, s, size);
+  }
+}
+
+/* histograms of every digit of the n elements at x */
+static
+void _histograms(const char *x, size_t n, size_t size, size_t width,
+                 size_t cnt[][RADIX])
+{
+  memset(cnt, 0, width * sizeof(cnt[0]));
+  for ( size_t i = 0; i < n; i++, x += size ) {
+    uint64_t k = _key(x, width);
+    for ( size_t d = 0; d < width; d++, k >>= 8 ) cnt[d][k & 0xff]++;
+  }
+}
+
+/* stable scatter of src into dst by digit d, with cnt the digit histogram */
+static
+void _scatter(const char *src, char *dst, size_t n, size_t size,
+              size_t width, size_t d, const size_t cnt[RADIX])
+{
+  size_t off[RADIX], sum = 0;
+  for ( size_t b = 0; b < RADIX; b++ ) {
+    off[b] = sum;
+    sum += cnt[b];
+  }
+  for ( size_t i = 0; i < n; i++, src += size ) {
+    size_t b = (_key(src, width) >> (8 * d)) & 0xff;
+    _move(dst + off[b]++ * size, src, size);
+  }
+}
+
+static
+void _insertion(char *x, size_t n, size_t size, size_t width, char *tmp)
+{
+  for ( size_t i = 1; i < n; i++ ) {
+    uint64_t k = _key(x + i * size, width);
+    size_t j = i;
+    if ( _key(x + (j - 1) * size, width) <= k ) continue;
+    memcpy(tmp, x + i * size, size);
+    for ( ; j > 0 && _key(x + (j - 1) * size, width) > k; j-- )
+      _move(x + j * size, x + (j - 1) * size, size);
+    memcpy(x + j * size, tmp, size);
+  }
+}
+
+/*
+ * sort the n elements at x on their digits below top, using buf of n elements;
+ * digits on which every element agrees are skipped
+ */
+static
+void _lsd(char *x, char *buf, size_t n, size_t size, size_t width, size_t top)
+{
+  size_t cnt[8][RADIX];
+  char *src = x, *dst = buf, *t;
+  if ( n < RADIX_SMALL ) {
+    _insertion(x, n, size, width, buf);
+    return;
+  }
+  _histograms(x, n, size, width, cnt);
+  for ( size_t d = 0; d < top; d++ ) {
+    if ( cnt[d][(_key(x, width) >> (8 * d)) & 0xff] == n ) continue;
+    _scatter(src, dst, n, size, width, d, cnt[d]);
+    t = src, src = dst, dst = t;
+  }
+  if ( src != x ) memcpy(x, src, n * size);
+}
+
+void arrays_radix_sort(arrays_t a, size_t width)
+{
+  size_t n = a->nmem, size = a->size, cnt[8][RADIX], live = 0, top = 0;
+  if ( n < 2 ) return;
+  char *buf = (char*)_amalloc(&a->al, n * size);
+  _histograms(a->x, n, size, width, cnt);
+  for ( size_t d = 0; d < width; d++ )
+    if ( cnt[d][(_key(a->x, width) >> (8 * d)) & 0xff] != n ) live++, top = d;
+
+  if ( live <= 4 ) _lsd(a->x, buf, n, size, width, top + 1);
+  else {
+    /*
+     * wide keys: split on the top digit, then sort each bucket on the digits
+     * below while it is small enough to stay in cache
+     */
+    size_t off = 0;
+    _scatter(a->x, buf, n, size, width, top, cnt[top]);
+    for ( size_t b = 0; b < RADIX; off += cnt[top][b++] ) {
+      if ( cnt[top][b] == 0 ) continue;
+      _lsd(buf + off * size, a->x + off * size, cnt[top][b], size, width, top);
+    }
+    memcpy(a->x, buf, n * size);
+  }
+  _afree(&a->al, buf);
+}
+
+int arrays_write(arrays_t a, FILE *f)
+{
+  char buf[HEADER] = { 0 };
+  header_t h = { MAGIC, a->size, a->nmem };
+  memcpy(buf, &h, sizeof(h));
+  if ( fwrite(buf, HEADER, 1, f) != 1 ) return -1;
+  if ( a->nmem != 0 && fwrite(a->x, a->size, a->nmem, f) != a->nmem ) return -1;
+  return 1;
+}
+
+int arrays_read(arrays_t a, FILE *f)
+{
+  char buf[HEADER];
+  header_t h;
+  if ( fread(buf, HEADER, 1, f) != 1 ) return -1;
+  memcpy(&h, buf, sizeof(h));
+  if ( memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.size != a->size ) {
+    errno = EINVAL;
+    return -1;
+  }
+  a->nmem = 0;
+  if ( h.nmem > a->capacity ) arrays_resize(a, h.nmem);
+  if ( h.nmem != 0 && fread(a->x, a->size, h.nmem, f) != h.nmem ) return -1;
+  a->nmem = h.nmem;
+  return 1;
+}
+
+/* hint that len bytes of fd from off are to be read soon, or all in order */
+static inline
+void _advise(int fd, off_t off, size_t len, int soon)
+{
+# ifdef HAVE_POSIX_FADVISE
+  if ( off >= 0 )
+    (void)posix_fadvise(fd, off, (off_t)len,
+                        soon ? POSIX_FADV_WILLNEED : POSIX_FADV_SEQUENTIAL);
+# else
+  (void)fd, (void)off, (void)len, (void)soon;
+# endif
+}
+
+/* reads up to len bytes, short only at the end of the file */
+static
+ssize_t _fill(int fd, char *x, size_t len)
+{
+  size_t got = 0;
+  while ( got < len ) {
+    ssize_t r = read(fd, x + got, len - got);
+    if ( r < 0 && errno == EINTR ) continue;
+    if ( r < 0 ) return -1;
+    if ( r == 0 ) break;
+    got += (size_t)r;
+  }
+  return (ssize_t)got;
+}
+
+/*
+ * Blocks are read straight past the last element, a record cut by the end of
+ * a block staying there to be completed by the next. The next block is hinted
+ * before the records of the current one are handed over, so that the kernel
+ * reads it while they are processed.
+ */
+static
+int _ingest(arrays_t a, int fd, size_t block, int apply(void*, size_t),
+            int apply_r(void*, size_t, void*), void *y)
+{
+  size_t part = 0;
+  ssize_t got;
+  off_t off = lseek(fd, 0, SEEK_CUR);
+  if ( block == 0 ) block = INGEST;
+  if ( block < a->size ) block = a->size;
+  _advise(fd, off, 0, 0);
+  do {
+    size_t need = a->nmem + (part + block + a->size - 1) / a->size;
+    if ( need > a->capacity ) arrays_resize(a, _grow(a, need));
+    char *x = a->x + a->nmem * a->size;
+    if ( (got = _fill(fd, x + part, block)) < 0 ) return -1;
+    if ( off >= 0 ) _advise(fd, off += got, block, 1);
+    size_t n = (part + (size_t)got) / a->size;
+    part = (part + (size_t)got) % a->size;
+    if ( n != 0 && (apply != NULL || apply_r != NULL)
+         && (apply != NULL ? apply(x, n) : apply_r(x, n, y)) < 0 )
+      return -1;
+    a->nmem += n;
+  } while ( (size_t)got == block );
+  if ( part != 0 ) {
+    errno = EINVAL;
+    return -1;
+  }
+  return 1;
+}
+
+int arrays_ingest(arrays_t a, int fd, size_t block,
+                  int apply(void *x, size_t n))
+{
+  return _ingest(a, fd, block, apply, NULL, NULL);
+}
+
+int arrays_ingest_r(arrays_t a, int fd, size_t block,
+                    int apply(void *x, size_t n, void *y), void *y)
+{
+  return _ingest(a, fd, block, NULL, apply, y);
+}
+
 void arrays_resize(arrays_t a, size_t nmem)
 {
+  COUNTS_EVENT(COUNTERS_RESIZE, a->capacity, nmem);
+  if ( a->nmem > nmem ) a->nmem = nmem;
+# ifdef MAPPED
+  if ( a->fd >= 0 ) {
+    size_t len = HEADER + a->size * nmem;
+    _unmap(a);
+    if ( ftruncate(a->fd, (off_t)len) < 0
+         || (a->x = _map(a->fd, len, 1)) == NULL )
+      error(1, errno, "mmap failure");
+    a->capacity = nmem;
+    return;
+  }
+# endif
   a->capacity = nmem;
-  char *tmp;
-  if ( (tmp = (char*)realloc(a->x, a->size * a->capacity)) == NULL )
-    error(1, errno, "realloc failure");
-  a->x = tmp;
+  if ( nmem == 0 ) {
+    _afree(&a->al, a->x);
+    a->x = NULL;
+  }
+  else a->x = (char*)_arealloc(&a->al, a->x, a->size * a->capacity);
 }
 
 void arrays_free(arrays_t *a)
 {
   if ( a == NULL || *a == NULL ) return;
-  if ( (*a)->x != NULL ) free((*a)->x);
-  free(*a);
+  allocators_t al = (*a)->al;
+# ifdef MAPPED
+  if ( (*a)->fd >= 0 ) {
+    _unmap(*a);
+    close((*a)->fd);
+    (*a)->x = NULL;
+  }
+# endif
+  _afree(&al, (*a)->x);
+  _afree(&al, *a);
   *a = NULL;
 }
 
+void arrays_clear(arrays_t a)
+{
+  a->nmem = 0;
+}
+
 size_t arrays_nmem(arrays_t a)
 {
   return a->nmem;
@@ -119,16 +600,697 @@ size_t arrays_size(arrays_t a)
   return a->size;
 }
 
+size_t arrays_memory_usage(arrays_t a, size_t *payload)
+{
+  if ( payload != NULL ) *payload = a->nmem * a->size;
+  return sizeof(*a) + (a->x != NULL ? a->capacity * a->size : 0);
+}
+
 int arrays_equal(arrays_t a1, arrays_t a2)
 {
   if ( a1->nmem != a2->nmem || a1->size != a2->size ) return -1;
+  if ( a1->nmem == 0 ) return 1;
+  return memcmp(a1->x, a2->x, a1->nmem * a1->size) == 0 ? 1 : -1;
+}
 
-  size_t i, len = a1->nmem * a1->size;
-  for ( i = 0; i < len; i++ ) if ( a1->x[i] != a2->x[i] ) return -1;
+/* first differing byte of the n bytes at x and y, n if none */
+static
+size_t _mismatch(const char *x, const char *y, size_t n)
+{
+  size_t i = 0;
+# if HAVE_AVX2
+  for ( ; i + 32 <= n; i += 32 ) {
+    __m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + i)),
+                                  _mm256_loadu_si256((const __m256i*)(y + i)));
+    uint32_t m = ~(uint32_t)_mm256_movemask_epi8(c);
+    if ( m != 0 ) return i + (size_t)__builtin_ctz(m);
+  }
+# elif HAVE_SSE2
+  for ( ; i + 16 <= n; i += 16 ) {
+    __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + i)),
+                               _mm_loadu_si128((const __m128i*)(y + i)));
+    uint32_t m = ~(uint32_t)_mm_movemask_epi8(c) & 0xFFFF;
+    if ( m != 0 ) return i + (size_t)__builtin_ctz(m);
+  }
+# endif
+  for ( ; i + 8 <= n; i += 8 ) {
+    uint64_t u, v;
+    memcpy(&u, x + i, 8);
+    memcpy(&v, y + i, 8);
+    if ( u != v ) break;
+  }
+  for ( ; i < n; i++ ) if ( x[i] != y[i] ) return i;
+  return n;
+}
 
+size_t arrays_find_first_mismatch(arrays_t a1, arrays_t a2)
+{
+  size_t n = a1->nmem < a2->nmem ? a1->nmem : a2->nmem;
+  if ( n == 0 ) return 0;
+  return _mismatch(a1->x, a2->x, n * a1->size) / a1->size;
+}
+
+/* elements of width 1, 2, 4 or 8 among the first n at x equal to *v */
+static
+size_t _count(const char *x, size_t n, const char *v, size_t size)
+{
+  size_t i = 0, c = 0, len = n * size;
+# if HAVE_AVX2
+  __m256i k;
+  uint64_t w = 0;
+  memcpy(&w, v, size);
+  switch ( size ) {
+  case 1: k = _mm256_set1_epi8((char)w); break;
+  case 2: k = _mm256_set1_epi16((short)w); break;
+  case 4: k = _mm256_set1_epi32((int)w); break;
+  default: k = _mm256_set1_epi64x((long long)w); break;
+  }
+  for ( ; i + 32 <= len; i += 32 ) {
+    __m256i y = _mm256_loadu_si256((const __m256i*)(x + i)), e;
+    switch ( size ) {
+    case 1: e = _mm256_cmpeq_epi8(y, k); break;
+    case 2: e = _mm256_cmpeq_epi16(y, k); break;
+    case 4: e = _mm256_cmpeq_epi32(y, k); break;
+    default: e = _mm256_cmpeq_epi64(y, k); break;
+    }
+    c += (size_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(e));
+  }
+# elif HAVE_SSE2
+  __m128i k;
+  uint64_t w = 0;
+  memcpy(&w, v, size);
+  switch ( size ) {
+  case 1: k = _mm_set1_epi8((char)w); break;
+  case 2: k = _mm_set1_epi16((short)w); break;
+  case 4: k = _mm_set1_epi32((int)w); break;
+  default: k = _mm_set1_epi64x((long long)w); break;
+  }
+  for ( ; i + 16 <= len; i += 16 ) {
+    __m128i y = _mm_loadu_si128((const __m128i*)(x + i)), e;
+    switch ( size ) {
+    case 1: e = _mm_cmpeq_epi8(y, k); break;
+    case 2: e = _mm_cmpeq_epi16(y, k); break;
+    case 4: e = _mm_cmpeq_epi32(y, k); break;
+    default:
+      /* both halves of a 64-bit lane equal */
+      e = _mm_cmpeq_epi32(y, k);
+      e = _mm_and_si128(e, _mm_shuffle_epi32(e, 0xB1));
+      break;
+    }
+    c += (size_t)__builtin_popcount((uint32_t)_mm_movemask_epi8(e));
+  }
+# endif
+  /* each equal element set size bits of the masks */
+  c /= size;
+  for ( ; i < len; i += size ) c += memcmp(x + i, v, size) == 0;
+  return c;
+}
+
+size_t arrays_count(arrays_t a, const void *x)
+{
+  size_t c = 0;
+  switch ( a->size ) {
+  case 1: case 2: case 4: case 8:
+    return _count(a->x, a->nmem, (const char*)x, a->size);
+  default:
+    for ( size_t i = 0; i < a->nmem; i++ )
+      c += memcmp(a->x + i * a->size, x, a->size) == 0;
+    return c;
+  }
+}
+
+/* whether x passes the predicate, that is, it returns a positive int */
+static inline
+int _pred(int pred(const void*), int pred_r(const void*, void*),
+          const void *x, void *y)
+{
+  return (pred != NULL ? pred(x) : pred_r(x, y)) > 0;
+}
+
+static
+void _filter(arrays_t a, int pred(const void*), int pred_r(const void*, void*),
+             void *y)
+{
+  size_t w = 0;
+  for ( size_t i = 0; i < a->nmem; i++ ) {
+    char *x = a->x + i * a->size;
+    if ( !_pred(pred, pred_r, x, y) ) continue;
+    if ( w != i ) memcpy(a->x + w * a->size, x, a->size);
+    w++;
+  }
+  a->nmem = w;
+}
+
+void arrays_filter(arrays_t a, int pred(const void *x))
+{
+  _filter(a, pred, NULL, NULL);
+}
+
+void arrays_filter_r(arrays_t a, int pred(const void *x, void *y), void *y)
+{
+  _filter(a, NULL, pred, y);
+}
+
+/* exchange n bytes, a stack buffer at a time */
+static
+void _exchange(char *x, char *y, size_t n)
+{
+  char tmp[64];
+  while ( n != 0 ) {
+    size_t k = n < sizeof(tmp) ? n : sizeof(tmp);
+    memcpy(tmp, x, k);
+    memcpy(x, y, k);
+    memcpy(y, tmp, k);
+    x += k;
+    y += k;
+    n -= k;
+  }
+}
+
+static
+size_t _partition(arrays_t a, int pred(const void*),
+                  int pred_r(const void*, void*), void *y)
+{
+  size_t i = 0, j = a->nmem;
+  while ( 1 ) {
+    while ( i < j && _pred(pred, pred_r, a->x + i * a->size, y) ) i++;
+    while ( i < j && !_pred(pred, pred_r, a->x + (j - 1) * a->size, y) ) j--;
+    if ( i == j ) return i;
+    _exchange(a->x + i * a->size, a->x + (j - 1) * a->size, a->size);
+    i++;
+    j--;
+  }
+}
+
+size_t arrays_partition(arrays_t a, int pred(const void *x))
+{
+  return _partition(a, pred, NULL, NULL);
+}
+
+size_t arrays_partition_r(arrays_t a, int pred(const void *x, void *y), void *y)
+{
+  return _partition(a, NULL, pred, y);
+}
+
+static
+void _unique(arrays_t a, int cmp(const void*, const void*),
+             int cmp_r(const void*, const void*, void*), void *z)
+{
+  if ( a->nmem < 2 ) return;
+  size_t w = 1;
+  for ( size_t i = 1; i < a->nmem; i++ ) {
+    char *x = a->x + i * a->size, *last = a->x + (w - 1) * a->size;
+    COUNTS_ADD(cmps, 1);
+    if ( (cmp != NULL ? cmp(last, x) : cmp_r(last, x, z)) == 0 ) continue;
+    if ( w != i ) memcpy(a->x + w * a->size, x, a->size);
+    w++;
+  }
+  a->nmem = w;
+}
+
+void arrays_unique(arrays_t a, int cmp(const void *x, const void *y))
+{
+  _unique(a, cmp, NULL, NULL);
+}
+
+void arrays_unique_r(arrays_t a, int cmp(const void *x, const void *y, void *z),
+                     void *z)
+{
+  _unique(a, NULL, cmp, z);
+}
+
+/**
+ * @brief Inputs of a k-way merge.
+ */
+typedef struct {
+  arrays_t *in;                                  ///< input arrays
+  size_t *pos;                                   ///< next element of each input
+  int (*cmp)(const void*, const void*);          ///< user compare function
+  int (*cmp_r)(const void*, const void*, void*); ///< reentrant compare function
+  void *z;                                       ///< argument to cmp_r
+} merge_t;
+
+/* next element of input i precedes that of input j, exhausted inputs last */
+static inline
+int _before(const merge_t *m, size_t i, size_t j)
+{
+  arrays_t a = m->in[i], b = m->in[j];
+  if ( m->pos[i] == a->nmem ) return 0;
+  if ( m->pos[j] == b->nmem ) return 1;
+  const char *x = a->x + m->pos[i] * a->size, *y = b->x + m->pos[j] * b->size;
+  COUNTS_ADD(cmps, 1);
+  int r = m->cmp != NULL ? m->cmp(x, y) : m->cmp_r(x, y, m->z);
+  return r < 0 || (r == 0 && i < j);
+}
+
+/*
+ * loser tree: node t < k holds the loser of the match at t, leaf k + i stands
+ * for input i, and tree[0] holds the overall winner
+ */
+static
+void _merge_k(arrays_t out, merge_t *m, size_t k)
+{
+  size_t total = 0, *tree, *win;
+  for ( size_t i = 0; i < k; i++ ) total += m->in[i]->nmem;
+  arrays_reserve(out, out->nmem + total);
+  tree = (size_t*)_amalloc(&out->al, 4 * k * sizeof(size_t));
+  win = tree + k;
+  m->pos = win + 2 * k;
+  for ( size_t i = 0; i < k; i++ ) {
+    win[k + i] = i;
+    m->pos[i] = 0;
+  }
+  for ( size_t t = k - 1; t > 0; t-- ) {
+    size_t l = win[2 * t], r = win[2 * t + 1];
+    int c = _before(m, r, l);
+    tree[t] = c ? l : r;
+    win[t] = c ? r : l;
+  }
+  tree[0] = win[1];
+  for ( size_t n = 0; n < total; n++ ) {
+    size_t s = tree[0];
+    arrays_t a = m->in[s];
+    memcpy(out->x + out->nmem * out->size, a->x + m->pos[s] * a->size,
+           out->size);
+    out->nmem++;
+    m->pos[s]++;
+    for ( size_t t = (s + k) / 2; t > 0; t /= 2 )
+      if ( _before(m, tree[t], s) ) {
+        size_t tmp = tree[t];
+        tree[t] = s;
+        s = tmp;
+      }
+    tree[0] = s;
+  }
+  _afree(&out->al, tree);
+}
+
+void arrays_merge_k(arrays_t out, arrays_t *in, size_t k,
+                    int cmp(const void *x, const void *y))
+{
+  if ( k == 0 ) return;
+  merge_t m = { in, NULL, cmp, NULL, NULL };
+  _merge_k(out, &m, k);
+}
+
+void arrays_merge_k_r(arrays_t out, arrays_t *in, size_t k,
+                      int cmp(const void *x, const void *y, void *z), void *z)
+{
+  if ( k == 0 ) return;
+  merge_t m = { in, NULL, NULL, cmp, z };
+  _merge_k(out, &m, k);
+}
+
+/**
+ * @brief Selection ranges at most this long are insertion sorted.
+ */
+# define SELECT_SMALL 16
+
+/**
+ * @brief Order of a selection.
+ */
+typedef struct {
+  size_t size;                                   ///< size of elements
+  int (*cmp)(const void*, const void*);          ///< user compare function
+  int (*cmp_r)(const void*, const void*, void*); ///< reentrant compare function
+  void *z;                                       ///< argument to cmp_r
+} order_t;
+
+static inline
+int _order(const order_t *o, const char *x, const char *y)
+{
+  COUNTS_ADD(cmps, 1);
+  return o->cmp != NULL ? o->cmp(x, y) : o->cmp_r(x, y, o->z);
+}
+
+static inline
+char *_elem(const order_t *o, char *x, size_t i)
+{
+  return x + i * o->size;
+}
+
+static
+void _sort_range(const order_t *o, char *x, size_t n)
+{
+  if ( o->cmp != NULL ) qsort(x, n, o->size, o->cmp);
+  else qsort_r(x, n, o->size, o->cmp_r, o->z);
+}
+
+static
+void _insertion_sort(const order_t *o, char *x, size_t n)
+{
+  for ( size_t i = 1; i < n; i++ )
+    for ( size_t j = i; j > 0
+            && _order(o, _elem(o, x, j - 1), _elem(o, x, j)) > 0; j-- )
+      _exchange(_elem(o, x, j - 1), _elem(o, x, j), o->size);
+}
+
+/* moves the median of elements i, j and k to position i */
+static
+void _median3(const order_t *o, char *x, size_t i, size_t j, size_t k)
+{
+  if ( _order(o, _elem(o, x, j), _elem(o, x, k)) > 0 )
+    _exchange(_elem(o, x, j), _elem(o, x, k), o->size);
+  if ( _order(o, _elem(o, x, i), _elem(o, x, j)) < 0 )
+    _exchange(_elem(o, x, i), _elem(o, x, j), o->size);
+  else if ( _order(o, _elem(o, x, i), _elem(o, x, k)) > 0 )
+    _exchange(_elem(o, x, i), _elem(o, x, k), o->size);
+}
+
+/*
+ * introselect: quickselect on the median of three, partitioning from both ends
+ * so that runs of equal elements split evenly, and sorting the range left once
+ * 2 log2(n) partitions have not narrowed it to a few elements
+ */
+static
+void _select(const order_t *o, char *x, size_t n, size_t k)
+{
+  size_t lo = 0, hi = n, depth = 0;
+  for ( size_t m = n; m > 1; m >>= 1 ) depth += 2;
+  while ( hi - lo > SELECT_SMALL ) {
+    if ( depth-- == 0 ) {
+      _sort_range(o, _elem(o, x, lo), hi - lo);
+      return;
+    }
+    _median3(o, x, lo, lo + (hi - lo) / 2, hi - 1);
+    char *p = _elem(o, x, lo);
+    size_t i = lo + 1, j = hi - 1;
+    while ( 1 ) {
+      while ( i <= j && _order(o, _elem(o, x, i), p) < 0 ) i++;
+      while ( i <= j && _order(o, _elem(o, x, j), p) > 0 ) j--;
+      if ( i >= j ) break;
+      _exchange(_elem(o, x, i++), _elem(o, x, j--), o->size);
+    }
+    _exchange(p, _elem(o, x, j), o->size);
+    if ( k == j ) return;
+    if ( k < j ) hi = j;
+    else lo = j + 1;
+  }
+  _insertion_sort(o, _elem(o, x, lo), hi - lo);
+}
+
+static
+void _nth_element(arrays_t a, size_t k, const order_t *o)
+{
+  if ( k < a->nmem ) _select(o, a->x, a->nmem, k);
+}
+
+void arrays_nth_element(arrays_t a, size_t k,
+                        int cmp(const void *x, const void *y))
+{
+  order_t o = { a->size, cmp, NULL, NULL };
+  _nth_element(a, k, &o);
+}
+
+void arrays_nth_element_r(arrays_t a, size_t k,
+                          int cmp(const void *x, const void *y, void *z),
+                          void *z)
+{
+  order_t o = { a->size, NULL, cmp, z };
+  _nth_element(a, k, &o);
+}
+
+static
+void _partial_sort(arrays_t a, size_t k, const order_t *o)
+{
+  if ( k >= a->nmem ) {
+    _sort_range(o, a->x, a->nmem);
+    return;
+  }
+  if ( k == 0 ) return;
+  _select(o, a->x, a->nmem, k - 1);
+  _sort_range(o, a->x, k - 1);
+}
+
+void arrays_partial_sort(arrays_t a, size_t k,
+                         int cmp(const void *x, const void *y))
+{
+  order_t o = { a->size, cmp, NULL, NULL };
+  _partial_sort(a, k, &o);
+}
+
+void arrays_partial_sort_r(arrays_t a, size_t k,
+                           int cmp(const void *x, const void *y, void *z),
+                           void *z)
+{
+  order_t o = { a->size, NULL, cmp, z };
+  _partial_sort(a, k, &o);
+}
+
+/* restores the min-heap h of n elements below position i */
+static
+void _sift(const order_t *o, char *h, size_t n, size_t i)
+{
+  for ( size_t c; (c = 2 * i + 1) < n; i = c ) {
+    if ( c + 1 < n && _order(o, _elem(o, h, c + 1), _elem(o, h, c)) < 0 ) c++;
+    if ( _order(o, _elem(o, h, c), _elem(o, h, i)) >= 0 ) return;
+    _exchange(_elem(o, h, c), _elem(o, h, i), o->size);
+  }
+}
+
+/*
+ * min-heap of the k greatest elements seen, built in the spare capacity of
+ * out; an element not above its root costs one comparison. Taking the root
+ * to the end in turn leaves the heap in descending order.
+ */
+static
+void _top_k(arrays_t a, arrays_t out, size_t k, const order_t *o)
+{
+  if ( k > a->nmem ) k = a->nmem;
+  if ( k == 0 ) return;
+  arrays_reserve(out, out->nmem + k);
+  char *h = out->x + out->nmem * out->size;
+  memcpy(h, a->x, k * a->size);
+  for ( size_t i = k / 2; i-- > 0; ) _sift(o, h, k, i);
+  for ( size_t i = k; i < a->nmem; i++ ) {
+    char *x = _elem(o, a->x, i);
+    if ( _order(o, x, h) <= 0 ) continue;
+    memcpy(h, x, a->size);
+    _sift(o, h, k, 0);
+  }
+  for ( size_t m = k; m-- > 1; ) {
+    _exchange(h, _elem(o, h, m), o->size);
+    _sift(o, h, m, 0);
+  }
+  out->nmem += k;
+}
+
+void arrays_top_k(arrays_t a, arrays_t out, size_t k,
+                  int cmp(const void *x, const void *y))
+{
+  order_t o = { a->size, cmp, NULL, NULL };
+  _top_k(a, out, k, &o);
+}
+
+void arrays_top_k_r(arrays_t a, arrays_t out, size_t k,
+                    int cmp(const void *x, const void *y, void *z), void *z)
+{
+  order_t o = { a->size, NULL, cmp, z };
+  _top_k(a, out, k, &o);
+}
+
+/**
+ * @brief Sorted run of an external sort, and the buffer it is merged from.
+ */
+typedef struct {
+  off_t off;  ///< offset in the file of the runs of the next unread record
+  off_t end;  ///< offset in the file of the runs of the end of the run
+  char *x;    ///< buffer of records read from the run
+  size_t pos; ///< next record of buffer
+  size_t n;   ///< number of records of buffer
+} run_t;
+
+static
+void _sort_run(arrays_t a, const order_t *o, workers_t w)
+{
+# if CONTAINERS_THREADS
+  if ( w != NULL ) {
+    if ( o->cmp != NULL ) arrays_sort_parallel(a, o->cmp, w);
+    else arrays_sort_parallel_r(a, o->cmp_r, o->z, w);
+    return;
+  }
+# else
+  (void)w;
+# endif
+  _sort_range(o, a->x, a->nmem);
+}
+
+static
+int _pwrite_all(int fd, const char *x, size_t len, off_t off)
+{
+  while ( len != 0 ) {
+    ssize_t r = pwrite(fd, x, len, off);
+    if ( r < 0 && errno == EINTR ) continue;
+    if ( r < 0 ) return -1;
+    x += r;
+    off += r;
+    len -= (size_t)r;
+  }
+  return 1;
+}
+
+/* next buffer of run, the one after it read ahead; 0 once the run is done */
+static
+int _refill(int fd, run_t *r, size_t size, size_t cap)
+{
+  size_t len = cap * size;
+  if ( r->off == r->end ) return 0;
+  if ( (off_t)len > r->end - r->off ) len = (size_t)(r->end - r->off);
+  for ( size_t done = 0; done < len; ) {
+    ssize_t k = pread(fd, r->x + done, len - done, r->off + (off_t)done);
+    if ( k < 0 && errno == EINTR ) continue;
+    if ( k <= 0 ) {
+      if ( k == 0 ) errno = EIO;
+      return -1;
+    }
+    done += (size_t)k;
+  }
+  r->off += (off_t)len;
+  r->pos = 0;
+  r->n = len / size;
+  _advise(fd, r->off, len, 1);
   return 1;
 }
 
+/* heap of runs with a record left, least next record at its root */
+static
+void _sift_runs(const order_t *o, run_t *r, size_t *h, size_t n, size_t i)
+{
+  for ( size_t c; (c = 2 * i + 1) < n; i = c ) {
+    if ( c + 1 < n
+         && _order(o, _elem(o, r[h[c + 1]].x, r[h[c + 1]].pos),
+                   _elem(o, r[h[c]].x, r[h[c]].pos)) < 0 ) c++;
+    if ( _order(o, _elem(o, r[h[c]].x, r[h[c]].pos),
+                _elem(o, r[h[i]].x, r[h[i]].pos)) >= 0 ) return;
+    size_t t = h[c];
+    h[c] = h[i];
+    h[i] = t;
+  }
+}
+
+/*
+ * each run gets an equal share of the memory as its buffer, and the output is
+ * grown once to the total
+ */
+static
+int _merge_runs(arrays_t out, int fd, off_t *bounds, size_t k, size_t mem,
+                const order_t *o)
+{
+  size_t cap = mem / out->size / k, n = 0, total = 0;
+  int rc = 1;
+  if ( cap == 0 ) cap = 1;
+  run_t *r = (run_t*)_amalloc(&out->al, k * sizeof(run_t));
+  size_t *h = (size_t*)_amalloc(&out->al, k * sizeof(size_t));
+  char *buf = (char*)_amalloc(&out->al, k * cap * out->size);
+  for ( size_t i = 0; i < k; i++ ) {
+    r[i].off = bounds[i];
+    r[i].end = bounds[i + 1];
+    r[i].x = buf + i * cap * out->size;
+    total += (size_t)(r[i].end - r[i].off) / out->size;
+    if ( (rc = _refill(fd, &r[i], out->size, cap)) < 0 ) goto done;
+    h[n++] = i;
+  }
+  arrays_reserve(out, out->nmem + total);
+  for ( size_t i = n / 2; i-- > 0; ) _sift_runs(o, r, h, n, i);
+  while ( n != 0 ) {
+    run_t *s = &r[h[0]];
+    memcpy(out->x + out->nmem++ * out->size, _elem(o, s->x, s->pos++),
+           out->size);
+    if ( s->pos == s->n && (rc = _refill(fd, s, out->size, cap)) <= 0 ) {
+      if ( rc < 0 ) goto done;
+      h[0] = h[--n];
+    }
+    _sift_runs(o, r, h, n, 0);
+  }
+  rc = 1;
+done:
+  _afree(&out->al, buf);
+  _afree(&out->al, h);
+  _afree(&out->al, r);
+  return rc;
+}
+
+/* file of the runs, unlinked at once so that it goes with its descriptor */
+static
+int _runs_file(void)
+{
+  static const char name[] = "/arrays-XXXXXX";
+  const char *dir = getenv("TMPDIR");
+  if ( dir == NULL ) dir = "/tmp";
+  size_t n = strlen(dir);
+  char *path = (char*)_amalloc(&allocators_std, n + sizeof(name));
+  memcpy(path, dir, n);
+  memcpy(path + n, name, sizeof(name));
+  int fd = mkstemp(path);
+  if ( fd >= 0 ) unlink(path);
+  _afree(&allocators_std, path);
+  return fd;
+}
+
+/*
+ * Runs of mem bytes are read, sorted and written one after the other to one
+ * file, then merged in one pass. Input fitting in a run is sorted in memory.
+ */
+static
+int _sort_external(arrays_t out, int in, size_t mem, const order_t *o,
+                   workers_t w)
+{
+  size_t run = mem / out->size, nb = 0, cb = 2;
+  int fd = -1, rc = -1;
+  ssize_t got;
+  off_t *bounds = NULL;
+  if ( run == 0 ) run = 1;
+  arrays_t a = arrays_new(out->size, run);
+  _advise(in, lseek(in, 0, SEEK_CUR), 0, 0);
+  while ( (got = _fill(in, a->x, run * a->size)) > 0 ) {
+    if ( (size_t)got % a->size != 0 ) {
+      errno = EINVAL;
+      goto done;
+    }
+    a->nmem = (size_t)got / a->size;
+    _sort_run(a, o, w);
+    if ( fd < 0 && a->nmem < run ) {
+      arrays_append(out, a->x, a->nmem);
+      rc = 1;
+      goto done;
+    }
+    if ( fd < 0 ) {
+      if ( (fd = _runs_file()) < 0 ) goto done;
+      bounds = (off_t*)_amalloc(&allocators_std, cb * sizeof(off_t));
+      bounds[0] = 0;
+    }
+    if ( nb + 2 > cb )
+      bounds = (off_t*)_arealloc(&allocators_std, bounds,
+                                 (cb *= 2) * sizeof(off_t));
+    if ( _pwrite_all(fd, a->x, (size_t)got, bounds[nb]) < 0 ) goto done;
+    bounds[nb + 1] = bounds[nb] + got;
+    nb++;
+  }
+  if ( got < 0 ) goto done;
+  arrays_free(&a);
+  rc = nb == 0 ? 1 : _merge_runs(out, fd, bounds, nb, mem, o);
+done:
+  arrays_free(&a);
+  _afree(&allocators_std, bounds);
+  if ( fd >= 0 ) close(fd);
+  return rc;
+}
+
+int arrays_sort_external(arrays_t out, int fd, size_t mem,
+                         int cmp(const void *x, const void *y), workers_t w)
+{
+  order_t o = { out->size, cmp, NULL, NULL };
+  return _sort_external(out, fd, mem, &o, w);
+}
+
+int arrays_sort_external_r(arrays_t out, int fd, size_t mem,
+                           int cmp(const void *x, const void *y, void *z),
+                           void *z, workers_t w)
+{
+  order_t o = { out->size, NULL, cmp, z };
+  return _sort_external(out, fd, mem, &o, w);
+}
+
 void arrays_reindex(arrays_t a, size_t nmem)
 {
   if ( a == NULL || nmem >= a->nmem ) return;
@@ -1,6 +1,71 @@
+# include <config.h>
 # include <bit_sets.h>
+# include <hashes.h>
+# include <errno.h>
+# include <string.h>
 
-int bit_nextelement(const sets_t set1[static 1], size_t m, int pos)
+/**
+ * @brief Set when the target has the AVX-512 VPOPCNTDQ instructions.
+ */
+# if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#  define VPOPCNT 1
+# else
+#  define VPOPCNT 0
+# endif
+
+# if HAVE_AVX2 || defined(__BMI2__) || VPOPCNT
+#  include <immintrin.h>
+# elif HAVE_SSE2
+#  include <emmintrin.h>
+# endif
+
+/**
+ * @brief First bytes written by <tt>bit_write</tt>.
+ */
+# define MAGIC "CBITSET"
+
+/**
+ * @brief Header written by <tt>bit_write</tt>.
+ */
+typedef struct {
+  char magic[8]; ///< <tt>MAGIC</tt>
+  uint64_t m;    ///< number of setwords
+} header_t;
+
+const uint64_t _BITT[64] = {
+  1,2,4,8,16,32,64,128,256,512,1024,2048,4096,8192,16384,32768,65536,131072,262144,
+  524288,1048576,2097152,4194304,8388608,16777216,33554432,67108864,134217728,
+  268435456,536870912,1073741824,2147483648,4294967296,8589934592,17179869184,
+  34359738368,68719476736,137438953472,274877906944,549755813888,1099511627776,
+  2199023255552,4398046511104,8796093022208,17592186044416,35184372088832,
+  70368744177664,140737488355328,281474976710656,562949953421312,1125899906842624,
+  2251799813685248,4503599627370496,9007199254740992,18014398509481984,
+  36028797018963968,72057594037927936,144115188075855872,288230376151711744,
+  576460752303423488,1152921504606846976,2305843009213693952,4611686018427387904,
+  9223372036854775808ULL,
+};
+
+const uint64_t _BITTCOUNT[256] = {
+  0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,1,2,2,3,2,3,3,4,
+  2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
+  2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,
+  4,5,5,6,5,6,6,7,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
+  2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,2,3,3,4,3,4,4,5,
+  3,4,4,5,4,5,5,6,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
+  4,5,5,6,5,6,6,7,5,6,6,7,6,7,7,8,
+};
+
+const uint64_t _RIGHTBITT[256] = {
+  _WORDSIZE,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,0,1,0,
+  2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,6,0,1,0,2,0,1,0,3,0,1,0,
+  2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,
+  2,0,1,0,3,0,1,0,2,0,1,0,7,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,
+  2,0,1,0,5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,6,0,1,0,
+  2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,0,1,0,2,0,1,0,3,0,1,0,
+  2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+};
+
+int bit_nextelement(const sets_t *set1, size_t m, int pos)
 {
   setwords_t setwd;
   int w;
@@ -22,11 +87,11 @@ int bit_nextelement(const sets_t set1[static 1], size_t m, int pos)
     setwd = set1[w] & _BITMASK(_SETBT(pos));
   }
 
-  while ( 1 ) {
-    if (setwd != 0) return _TIMESWORDSIZE(w) + _FIRSTBITNZ(setwd);
-    if ((size_t)++w == m) return -1;
+  while ( setwd == 0 ) {
+    if ( (size_t)++w >= m ) return -1;
     setwd = set1[w];
   }
+  return _TIMESWORDSIZE(w) + _FIRSTBITNZ(setwd);
 }
 
 void bit_permset(sets_t s1[restrict static 1],
@@ -40,7 +105,7 @@ void bit_permset(sets_t s1[restrict static 1],
     setw = s2[0];
     while ( setw != 0 ) {
       _TAKEBIT(b, setw);
-      *s1 |= _BITT[p[b]];
+      *s1 |= _BIT(p[b]);
     }
   }
   else {
@@ -80,3 +145,577 @@ int bit_permaut(const sets_t s[static 1], const uint32_t p[static 1], size_t m)
   }
   return 1;
 }
+
+/**
+ * @brief Elements decoded at a time by the many-permutation functions.
+ */
+# define BUFFER 1024
+
+/* next elements of iterator, up to BUFFER of them */
+static inline
+size_t _decode(setiters_t *it, uint32_t e[static BUFFER])
+{
+  size_t n = 0;
+  for ( int x; n < BUFFER && (x = bit_iternext(it)) >= 0; ) e[n++] = (uint32_t)x;
+  return n;
+}
+
+void bit_permset_many(sets_t d[restrict static 1],
+                      const sets_t s[restrict static 1],
+                      const uint32_t *const p[static 1], size_t n, size_t m)
+{
+  uint32_t e[BUFFER];
+  setiters_t it;
+  memset(d, 0, n * m * sizeof(sets_t));
+  bit_iterinit(&it, s, m);
+  for ( size_t k; (k = _decode(&it, e)) != 0; )
+    for ( size_t i = 0; i < n; i++ ) {
+      sets_t *di = d + i * m;
+      const uint32_t *pi = p[i];
+      for ( size_t j = 0; j < k; j++ ) _ADDELEMENT(di, pi[e[j]]);
+    }
+}
+
+int bit_permaut_many(const sets_t s[static 1], const uint32_t *const p[static 1],
+                     size_t n, size_t m)
+{
+  uint32_t e[BUFFER];
+  setiters_t it;
+  bit_iterinit(&it, s, m);
+  for ( size_t k; (k = _decode(&it, e)) != 0; )
+    for ( size_t i = 0; i < n; i++ ) {
+      const uint32_t *pi = p[i];
+      for ( size_t j = 0; j < k; j++ )
+        if ( !_ISELEMENT(s, pi[e[j]]) ) return -1;
+    }
+  return 1;
+}
+
+void bit_permtable(uint64_t t[restrict static 1], const uint32_t p[static 1],
+                   size_t m)
+{
+  for ( size_t j = 0; j < 8 * m; j++ ) {
+    sets_t *row = t + j * 256 * m;
+    memset(row, 0, m * sizeof(sets_t));
+    for ( uint32_t v = 1; v < 256; v++ ) {
+      memcpy(row + v * m, row + (v & (v - 1)) * m, m * sizeof(sets_t));
+      _ADDELEMENT(row + v * m, p[8 * j + _FIRSTBITNZ((uint64_t)v)]);
+    }
+  }
+}
+
+void bit_permset_table(sets_t d[restrict static 1],
+                       const sets_t s[restrict static 1],
+                       const uint64_t t[restrict static 1], size_t m)
+{
+  _EMPTYSET(d, m);
+  for ( size_t w = 0; w < m; w++ )
+    for ( size_t b = 0; b < 8; b++ ) {
+      uint32_t v = (s[w] >> (8 * b)) & 0xFF;
+      if ( v == 0 ) continue;
+      const uint64_t *row = t + ((8 * w + b) * 256 + v) * m;
+      for ( size_t k = 0; k < m; k++ ) d[k] |= row[k];
+    }
+}
+
+void bit_permset_batch(sets_t d[restrict static 1],
+                       const sets_t s[restrict static 1], size_t n,
+                       const uint64_t t[restrict static 1], size_t m)
+{
+  for ( size_t i = 0; i < n; i++ ) bit_permset_table(d + i * m, s + i * m, t, m);
+}
+
+int bit_permaut_table(const sets_t s[static 1], const uint64_t t[static 1],
+                      size_t m)
+{
+  for ( size_t w = 0; w < m; w++ )
+    for ( size_t b = 0; b < 8; b++ ) {
+      uint32_t v = (s[w] >> (8 * b)) & 0xFF;
+      if ( v == 0 ) continue;
+      const uint64_t *row = t + ((8 * w + b) * 256 + v) * m;
+      for ( size_t k = 0; k < m; k++ ) if ( row[k] & ~s[k] ) return -1;
+    }
+  return 1;
+}
+
+int bit_write(const sets_t s[static 1], size_t m, FILE *f)
+{
+  header_t h = { MAGIC, m };
+  if ( fwrite(&h, sizeof(h), 1, f) != 1 || fwrite(s, sizeof(sets_t), m, f) != m )
+    return -1;
+  return 1;
+}
+
+int bit_read(sets_t s[static 1], size_t m, FILE *f)
+{
+  header_t h;
+  if ( fread(&h, sizeof(h), 1, f) != 1 ) return -1;
+  if ( memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.m != m ) {
+    errno = EINVAL;
+    return -1;
+  }
+  return fread(s, sizeof(sets_t), m, f) == m ? 1 : -1;
+}
+
+/* vector part of d = a op b, with v the AVX2 op and u the SSE2 op */
+# if HAVE_AVX2
+#  define VLOOP(v, u)                                                     \
+  for ( ; i + 4 <= m; i += 4 )                                            \
+    _mm256_storeu_si256((__m256i*)(d + i),                                \
+                        v(_mm256_loadu_si256((const __m256i*)(a + i)),    \
+                          _mm256_loadu_si256((const __m256i*)(b + i))));
+# elif HAVE_SSE2
+#  define VLOOP(v, u)                                                     \
+  for ( ; i + 2 <= m; i += 2 )                                            \
+    _mm_storeu_si128((__m128i*)(d + i),                                   \
+                     u(_mm_loadu_si128((const __m128i*)(a + i)),          \
+                       _mm_loadu_si128((const __m128i*)(b + i))));
+# else
+#  define VLOOP(v, u)
+# endif
+
+/* swaps the operands as andnot complements its first */
+# define _ANDNOT256(x, y) _mm256_andnot_si256(y, x)
+# define _ANDNOT128(x, y) _mm_andnot_si128(y, x)
+# define _OR(x, y) ((x) | (y))
+# define _AND(x, y) ((x) & (y))
+# define _ANDNOT(x, y) ((x) & ~(y))
+
+/* defines set operation d = a op b, for vector ops v and u and word op w */
+# define BINARY(name, v, u, w)                                            \
+  void name(sets_t *d, const sets_t *a, const sets_t *b, size_t m)       \
+  {                                                                       \
+    size_t i = 0;                                                         \
+    VLOOP(v, u)                                                           \
+    for ( ; i < m; i++ ) d[i] = w(a[i], b[i]);                            \
+  }
+
+BINARY(bit_union, _mm256_or_si256, _mm_or_si128, _OR)
+BINARY(bit_intersection, _mm256_and_si256, _mm_and_si128, _AND)
+BINARY(bit_difference, _ANDNOT256, _ANDNOT128, _ANDNOT)
+
+# if HAVE_AVX2
+/* bit counts of the four words of v, by nibble lookup */
+static inline
+__m256i _popcount256(__m256i v)
+{
+  const __m256i t = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                     0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  __m256i lo = _mm256_and_si256(v, nibble);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+  __m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(t, lo),
+                              _mm256_shuffle_epi8(t, hi));
+  return _mm256_sad_epu8(c, _mm256_setzero_si256());
+}
+
+static inline
+size_t _sum256(__m256i v)
+{
+  __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  return (size_t)(_mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1));
+}
+# endif
+
+size_t bit_intersectioncount(sets_t *d, const sets_t *a, const sets_t *b,
+                             size_t m)
+{
+  size_t i = 0, count = 0;
+# if HAVE_AVX2
+  __m256i c = _mm256_setzero_si256();
+  for ( ; i + 4 <= m; i += 4 ) {
+    __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                 _mm256_loadu_si256((const __m256i*)(b + i)));
+    _mm256_storeu_si256((__m256i*)(d + i), x);
+    c = _mm256_add_epi64(c, _popcount256(x));
+  }
+  count = _sum256(c);
+# endif
+  for ( ; i < m; i++ ) {
+    d[i] = a[i] & b[i];
+    count += _POPCOUNT(d[i]);
+  }
+  return count;
+}
+
+size_t bit_intersectsize(const sets_t *a, const sets_t *b, size_t m)
+{
+  size_t i = 0, count = 0;
+# if HAVE_AVX2
+  __m256i c = _mm256_setzero_si256();
+  for ( ; i + 4 <= m; i += 4 )
+    c = _mm256_add_epi64(c, _popcount256(
+      _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                       _mm256_loadu_si256((const __m256i*)(b + i)))));
+  count = _sum256(c);
+# endif
+  for ( ; i < m; i++ ) count += _WINTERSECTSIZE(a[i], b[i]);
+  return count;
+}
+
+# if VPOPCNT
+/* setwords j to j + 7 of a row, the words past m read as zero */
+#  define _ROW512(t, j, m)                                                \
+  _mm512_maskz_loadu_epi64(                                               \
+    (__mmask8)(0xFF >> ((j) + 8 > (m) ? (j) + 8 - (m) : 0)), (t) + (j))
+
+/* intersection sizes of s with n rows, the query held in zmm registers */
+static
+void _intersectsizes(uint32_t *restrict c, const sets_t *restrict s,
+                     const sets_t *restrict t, size_t n, size_t stride,
+                     size_t m)
+{
+  if ( m <= 32 ) {
+    __m512i q[4];
+    size_t v = (m + 7) / 8;
+    for ( size_t j = 0; j < v; j++ ) q[j] = _ROW512(s, 8 * j, m);
+    for ( size_t i = 0; i < n; i++, t += stride ) {
+      __m512i a = _mm512_setzero_si512();
+      for ( size_t j = 0; j < v; j++ )
+        a = _mm512_add_epi64(a, _mm512_popcnt_epi64(
+                               _mm512_and_si512(q[j], _ROW512(t, 8 * j, m))));
+      c[i] = (uint32_t)_mm512_reduce_add_epi64(a);
+    }
+    return;
+  }
+  for ( size_t i = 0; i < n; i++, t += stride ) {
+    __m512i a = _mm512_setzero_si512();
+    for ( size_t j = 0; j < m; j += 8 )
+      a = _mm512_add_epi64(a, _mm512_popcnt_epi64(
+                             _mm512_and_si512(_ROW512(s, j, m),
+                                              _ROW512(t, j, m))));
+    c[i] = (uint32_t)_mm512_reduce_add_epi64(a);
+  }
+}
+# elif HAVE_AVX2
+/* carry-save adder: h:l is the sum of the bits of a, b and c */
+#  define CSA(h, l, a, b, c) {                                            \
+    __m256i _u = _mm256_xor_si256(a, b);                                  \
+    h = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(_u, c)); \
+    l = _mm256_xor_si256(_u, c);                                          \
+  }
+
+/* s & t for words j to j + 3 */
+#  define AND256(s, t, j)                                                 \
+  _mm256_and_si256(_mm256_loadu_si256((const __m256i*)((s) + (j))),       \
+                   _mm256_loadu_si256((const __m256i*)((t) + (j))))
+
+/* size of s & t, 16 words at a time by Harley-Seal, so that one popcount
+   serves four vectors */
+static inline
+size_t _harleyseal(const sets_t *s, const sets_t *t, size_t m)
+{
+  __m256i total = _mm256_setzero_si256(), ones = total, twos = total;
+  __m256i twosa, twosb, fours;
+  size_t i = 0, count;
+  for ( ; i + 16 <= m; i += 16 ) {
+    CSA(twosa, ones, ones, AND256(s, t, i), AND256(s, t, i + 4));
+    CSA(twosb, ones, ones, AND256(s, t, i + 8), AND256(s, t, i + 12));
+    CSA(fours, twos, twos, twosa, twosb);
+    total = _mm256_add_epi64(total, _popcount256(fours));
+  }
+  total = _mm256_slli_epi64(total, 2);
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(_popcount256(twos), 1));
+  total = _mm256_add_epi64(total, _popcount256(ones));
+  for ( ; i + 4 <= m; i += 4 )
+    total = _mm256_add_epi64(total, _popcount256(AND256(s, t, i)));
+  count = _sum256(total);
+  for ( ; i < m; i++ ) count += _WINTERSECTSIZE(s[i], t[i]);
+  return count;
+}
+
+/* intersection sizes of s with n rows, the query held in ymm registers */
+static
+void _intersectsizes(uint32_t *restrict c, const sets_t *restrict s,
+                     const sets_t *restrict t, size_t n, size_t stride,
+                     size_t m)
+{
+  if ( m < 16 ) {
+    __m256i q[3];
+    size_t v = m / 4;
+    for ( size_t j = 0; j < v; j++ )
+      q[j] = _mm256_loadu_si256((const __m256i*)(s + 4 * j));
+    for ( size_t i = 0; i < n; i++, t += stride ) {
+      __m256i a = _mm256_setzero_si256();
+      for ( size_t j = 0; j < v; j++ )
+        a = _mm256_add_epi64(a, _popcount256(
+                               _mm256_and_si256(q[j], _mm256_loadu_si256(
+                                                  (const __m256i*)(t + 4 * j)))));
+      size_t count = _sum256(a);
+      for ( size_t j = 4 * v; j < m; j++ ) count += _WINTERSECTSIZE(s[j], t[j]);
+      c[i] = (uint32_t)count;
+    }
+    return;
+  }
+  for ( size_t i = 0; i < n; i++, t += stride )
+    c[i] = (uint32_t)_harleyseal(s, t, m);
+}
+# else
+/* intersection sizes of s with n rows */
+static
+void _intersectsizes(uint32_t *restrict c, const sets_t *restrict s,
+                     const sets_t *restrict t, size_t n, size_t stride,
+                     size_t m)
+{
+  if ( m == 1 ) {
+    setwords_t q = *s;
+    for ( size_t i = 0; i < n; i++, t += stride )
+      c[i] = (uint32_t)_WINTERSECTSIZE(q, *t);
+    return;
+  }
+  for ( size_t i = 0; i < n; i++, t += stride ) {
+    size_t count = 0;
+    for ( size_t j = 0; j < m; j++ ) count += _WINTERSECTSIZE(s[j], t[j]);
+    c[i] = (uint32_t)count;
+  }
+}
+# endif
+
+void bit_intersectsizes(uint32_t c[restrict static 1],
+                        const sets_t s[restrict static 1],
+                        const sets_t t[restrict static 1], size_t n,
+                        size_t stride, size_t m)
+{
+  if ( m == 0 ) memset(c, 0, n * sizeof(uint32_t));
+  else _intersectsizes(c, s, t, n, stride, m);
+}
+
+size_t bit_intersectfilter(sets_t r[restrict static 1],
+                           const sets_t s[restrict static 1],
+                           const sets_t t[restrict static 1], size_t n,
+                           size_t stride, size_t m, size_t num)
+{
+  uint32_t c[_WORDSIZE];
+  size_t count = 0, words = n ? _SETWORDSNEEDED(n) : 0;
+  /* rows are counted a setword of r at a time */
+  for ( size_t w = 0; w < words; w++ ) {
+    size_t k = n - _TIMESWORDSIZE(w) < _WORDSIZE ? n - _TIMESWORDSIZE(w)
+      : _WORDSIZE;
+    setwords_t word = 0;
+    bit_intersectsizes(c, s, t + _TIMESWORDSIZE(w) * stride, k, stride, m);
+    for ( size_t i = 0; i < k; i++ ) word |= (setwords_t)(c[i] >= num) << i;
+    r[w] = word;
+    count += _POPCOUNT(word);
+  }
+  return count;
+}
+
+int bit_subset(const sets_t *a, const sets_t *b, size_t m)
+{
+  size_t i = 0;
+# if HAVE_AVX2
+  for ( ; i + 4 <= m; i += 4 )
+    if ( !_mm256_testc_si256(_mm256_loadu_si256((const __m256i*)(b + i)),
+                             _mm256_loadu_si256((const __m256i*)(a + i))) )
+      return -1;
+# elif HAVE_SSE2
+  for ( ; i + 2 <= m; i += 2 ) {
+    __m128i x = _mm_andnot_si128(_mm_loadu_si128((const __m128i*)(b + i)),
+                                 _mm_loadu_si128((const __m128i*)(a + i)));
+    if ( _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xFFFF )
+      return -1;
+  }
+# endif
+  for ( ; i < m; i++ ) if ( a[i] & ~b[i] ) return -1;
+  return 1;
+}
+
+int bit_disjoint(const sets_t *a, const sets_t *b, size_t m)
+{
+  size_t i = 0;
+# if HAVE_AVX2
+  for ( ; i + 4 <= m; i += 4 )
+    if ( !_mm256_testz_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                             _mm256_loadu_si256((const __m256i*)(b + i))) )
+      return -1;
+# elif HAVE_SSE2
+  for ( ; i + 2 <= m; i += 2 ) {
+    __m128i x = _mm_and_si128(_mm_loadu_si128((const __m128i*)(a + i)),
+                              _mm_loadu_si128((const __m128i*)(b + i)));
+    if ( _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xFFFF )
+      return -1;
+  }
+# endif
+  for ( ; i < m; i++ ) if ( a[i] & b[i] ) return -1;
+  return 1;
+}
+
+void bit_rankindex(uint64_t r[restrict static 1],
+                   const sets_t s[restrict static 1], size_t m)
+{
+  uint64_t total = 0;
+  for ( size_t j = 0; j <= m >> 3; j++ ) {
+    uint64_t count = 0, sub = 0;
+    for ( size_t k = 0, w = 8 * j; k < 8; k++, w++ ) {
+      if ( k != 0 ) sub |= count << (9 * (k - 1));
+      if ( w < m ) count += _POPCOUNT(s[w]);
+    }
+    r[2 * j] = total;
+    r[2 * j + 1] = sub;
+    total += count;
+  }
+}
+
+/* position of the element of rank k of word w */
+static inline
+int _select64(setwords_t w, uint32_t k)
+{
+# ifdef __BMI2__
+  return _FIRSTBITNZ(_pdep_u64((uint64_t)1 << k, w));
+# else
+  while ( k-- != 0 ) w &= w - 1;
+  return _FIRSTBITNZ(w);
+# endif
+}
+
+int bit_select(const uint64_t r[static 1], const sets_t s[static 1],
+               size_t m, size_t k)
+{
+  /* last superblock with fewer than k + 1 elements before it */
+  size_t lo = 0, hi = m >> 3;
+  while ( lo < hi ) {
+    size_t mid = hi - (hi - lo) / 2;
+    if ( r[2 * mid] <= k ) lo = mid;
+    else hi = mid - 1;
+  }
+  uint64_t rem = k - r[2 * lo], sub = r[2 * lo + 1];
+
+  /* last setword of the superblock with at most rem elements before it */
+  size_t t = 0;
+  for ( size_t i = 1; i < 8; i++ )
+    if ( ((sub >> (9 * (i - 1))) & 0x1FF) <= rem ) t = i;
+  if ( t != 0 ) rem -= (sub >> (9 * (t - 1))) & 0x1FF;
+
+  size_t w = 8 * lo + t;
+  if ( w >= m || rem >= _POPCOUNT(s[w]) ) return -1;
+  return (int)_TIMESWORDSIZE(w) + _select64(s[w], (uint32_t)rem);
+}
+
+# if HAVE_AVX2
+/**
+ * @brief Positions of the elements of each of the 256 bytes, packed one per
+ * byte from the low byte up, with zeros after the last.
+ */
+static const uint64_t _BYTEELEMENTS[256] = {
+  0x0000000000000000ULL,0x0000000000000000ULL,0x0000000000000001ULL,
+  0x0000000000000100ULL,0x0000000000000002ULL,0x0000000000000200ULL,
+  0x0000000000000201ULL,0x0000000000020100ULL,0x0000000000000003ULL,
+  0x0000000000000300ULL,0x0000000000000301ULL,0x0000000000030100ULL,
+  0x0000000000000302ULL,0x0000000000030200ULL,0x0000000000030201ULL,
+  0x0000000003020100ULL,0x0000000000000004ULL,0x0000000000000400ULL,
+  0x0000000000000401ULL,0x0000000000040100ULL,0x0000000000000402ULL,
+  0x0000000000040200ULL,0x0000000000040201ULL,0x0000000004020100ULL,
+  0x0000000000000403ULL,0x0000000000040300ULL,0x0000000000040301ULL,
+  0x0000000004030100ULL,0x0000000000040302ULL,0x0000000004030200ULL,
+  0x0000000004030201ULL,0x0000000403020100ULL,0x0000000000000005ULL,
+  0x0000000000000500ULL,0x0000000000000501ULL,0x0000000000050100ULL,
+  0x0000000000000502ULL,0x0000000000050200ULL,0x0000000000050201ULL,
+  0x0000000005020100ULL,0x0000000000000503ULL,0x0000000000050300ULL,
+  0x0000000000050301ULL,0x0000000005030100ULL,0x0000000000050302ULL,
+  0x0000000005030200ULL,0x0000000005030201ULL,0x0000000503020100ULL,
+  0x0000000000000504ULL,0x0000000000050400ULL,0x0000000000050401ULL,
+  0x0000000005040100ULL,0x0000000000050402ULL,0x0000000005040200ULL,
+  0x0000000005040201ULL,0x0000000504020100ULL,0x0000000000050403ULL,
+  0x0000000005040300ULL,0x0000000005040301ULL,0x0000000504030100ULL,
+  0x0000000005040302ULL,0x0000000504030200ULL,0x0000000504030201ULL,
+  0x0000050403020100ULL,0x0000000000000006ULL,0x0000000000000600ULL,
+  0x0000000000000601ULL,0x0000000000060100ULL,0x0000000000000602ULL,
+  0x0000000000060200ULL,0x0000000000060201ULL,0x0000000006020100ULL,
+  0x0000000000000603ULL,0x0000000000060300ULL,0x0000000000060301ULL,
+  0x0000000006030100ULL,0x0000000000060302ULL,0x0000000006030200ULL,
+  0x0000000006030201ULL,0x0000000603020100ULL,0x0000000000000604ULL,
+  0x0000000000060400ULL,0x0000000000060401ULL,0x0000000006040100ULL,
+  0x0000000000060402ULL,0x0000000006040200ULL,0x0000000006040201ULL,
+  0x0000000604020100ULL,0x0000000000060403ULL,0x0000000006040300ULL,
+  0x0000000006040301ULL,0x0000000604030100ULL,0x0000000006040302ULL,
+  0x0000000604030200ULL,0x0000000604030201ULL,0x0000060403020100ULL,
+  0x0000000000000605ULL,0x0000000000060500ULL,0x0000000000060501ULL,
+  0x0000000006050100ULL,0x0000000000060502ULL,0x0000000006050200ULL,
+  0x0000000006050201ULL,0x0000000605020100ULL,0x0000000000060503ULL,
+  0x0000000006050300ULL,0x0000000006050301ULL,0x0000000605030100ULL,
+  0x0000000006050302ULL,0x0000000605030200ULL,0x0000000605030201ULL,
+  0x0000060503020100ULL,0x0000000000060504ULL,0x0000000006050400ULL,
+  0x0000000006050401ULL,0x0000000605040100ULL,0x0000000006050402ULL,
+  0x0000000605040200ULL,0x0000000605040201ULL,0x0000060504020100ULL,
+  0x0000000006050403ULL,0x0000000605040300ULL,0x0000000605040301ULL,
+  0x0000060504030100ULL,0x0000000605040302ULL,0x0000060504030200ULL,
+  0x0000060504030201ULL,0x0006050403020100ULL,0x0000000000000007ULL,
+  0x0000000000000700ULL,0x0000000000000701ULL,0x0000000000070100ULL,
+  0x0000000000000702ULL,0x0000000000070200ULL,0x0000000000070201ULL,
+  0x0000000007020100ULL,0x0000000000000703ULL,0x0000000000070300ULL,
+  0x0000000000070301ULL,0x0000000007030100ULL,0x0000000000070302ULL,
+  0x0000000007030200ULL,0x0000000007030201ULL,0x0000000703020100ULL,
+  0x0000000000000704ULL,0x0000000000070400ULL,0x0000000000070401ULL,
+  0x0000000007040100ULL,0x0000000000070402ULL,0x0000000007040200ULL,
+  0x0000000007040201ULL,0x0000000704020100ULL,0x0000000000070403ULL,
+  0x0000000007040300ULL,0x0000000007040301ULL,0x0000000704030100ULL,
+  0x0000000007040302ULL,0x0000000704030200ULL,0x0000000704030201ULL,
+  0x0000070403020100ULL,0x0000000000000705ULL,0x0000000000070500ULL,
+  0x0000000000070501ULL,0x0000000007050100ULL,0x0000000000070502ULL,
+  0x0000000007050200ULL,0x0000000007050201ULL,0x0000000705020100ULL,
+  0x0000000000070503ULL,0x0000000007050300ULL,0x0000000007050301ULL,
+  0x0000000705030100ULL,0x0000000007050302ULL,0x0000000705030200ULL,
+  0x0000000705030201ULL,0x0000070503020100ULL,0x0000000000070504ULL,
+  0x0000000007050400ULL,0x0000000007050401ULL,0x0000000705040100ULL,
+  0x0000000007050402ULL,0x0000000705040200ULL,0x0000000705040201ULL,
+  0x0000070504020100ULL,0x0000000007050403ULL,0x0000000705040300ULL,
+  0x0000000705040301ULL,0x0000070504030100ULL,0x0000000705040302ULL,
+  0x0000070504030200ULL,0x0000070504030201ULL,0x0007050403020100ULL,
+  0x0000000000000706ULL,0x0000000000070600ULL,0x0000000000070601ULL,
+  0x0000000007060100ULL,0x0000000000070602ULL,0x0000000007060200ULL,
+  0x0000000007060201ULL,0x0000000706020100ULL,0x0000000000070603ULL,
+  0x0000000007060300ULL,0x0000000007060301ULL,0x0000000706030100ULL,
+  0x0000000007060302ULL,0x0000000706030200ULL,0x0000000706030201ULL,
+  0x0000070603020100ULL,0x0000000000070604ULL,0x0000000007060400ULL,
+  0x0000000007060401ULL,0x0000000706040100ULL,0x0000000007060402ULL,
+  0x0000000706040200ULL,0x0000000706040201ULL,0x0000070604020100ULL,
+  0x0000000007060403ULL,0x0000000706040300ULL,0x0000000706040301ULL,
+  0x0000070604030100ULL,0x0000000706040302ULL,0x0000070604030200ULL,
+  0x0000070604030201ULL,0x0007060403020100ULL,0x0000000000070605ULL,
+  0x0000000007060500ULL,0x0000000007060501ULL,0x0000000706050100ULL,
+  0x0000000007060502ULL,0x0000000706050200ULL,0x0000000706050201ULL,
+  0x0000070605020100ULL,0x0000000007060503ULL,0x0000000706050300ULL,
+  0x0000000706050301ULL,0x0000070605030100ULL,0x0000000706050302ULL,
+  0x0000070605030200ULL,0x0000070605030201ULL,0x0007060503020100ULL,
+  0x0000000007060504ULL,0x0000000706050400ULL,0x0000000706050401ULL,
+  0x0000070605040100ULL,0x0000000706050402ULL,0x0000070605040200ULL,
+  0x0000070605040201ULL,0x0007060504020100ULL,0x0000000706050403ULL,
+  0x0000070605040300ULL,0x0000070605040301ULL,0x0007060504030100ULL,
+  0x0000070605040302ULL,0x0007060504030200ULL,0x0007060504030201ULL,
+  0x0706050403020100ULL,
+};
+# endif
+
+size_t bit_to_indices(const sets_t s[restrict static 1], size_t m,
+                      uint32_t *restrict out)
+{
+  size_t n = 0, w = 0;
+# if HAVE_AVX2
+  /* each byte stores 8 indices, so whole setwords take vector stores only while
+     64 elements remain */
+  size_t total = bit_setsize((sets_t*)s, m);
+  for ( ; w < m && n + 64 <= total; w++ ) {
+    setwords_t word = s[w];
+    for ( uint32_t b = 0; word != 0; b += 8, word >>= 8 ) {
+      uint32_t byte = word & 0xFF;
+      __m256i x = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(
+                                         (long long)_BYTEELEMENTS[byte]));
+      x = _mm256_add_epi32(x, _mm256_set1_epi32((int)(_TIMESWORDSIZE(w) + b)));
+      _mm256_storeu_si256((__m256i*)(out + n), x);
+      n += _POPCOUNT((uint64_t)byte);
+    }
+  }
+# endif
+  for ( uint32_t b; w < m; w++ )
+    for ( setwords_t word = s[w]; word != 0; ) {
+      _TAKEBIT(b, word);
+      out[n++] = (uint32_t)_TIMESWORDSIZE(w) + b;
+    }
+  return n;
+}
+
+uint64_t bit_hash(const sets_t s[static 1], size_t m, uint64_t seed)
+{
+  return hashes_bytes(s, m * sizeof(sets_t), seed);
+}
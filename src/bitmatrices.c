@@ -0,0 +1,178 @@
+/**
+ * @file bitmatrices.c
+ * @brief Implementation of <tt>bitmatrices_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <bitmatrices.h>
+# include <string.h>
+# define COUNTS_KIND COUNTERS_BITMATRICES
+# include "allocs.h"
+
+/**
+ * @brief Alignment of rows, in bytes.
+ */
+# define LINE 64
+
+/**
+ * @brief Setwords per cache line; rows are padded to a multiple of it.
+ */
+# define LINEWORDS (LINE / sizeof(sets_t))
+
+/**
+ * @brief <tt>bitmatrices_t</tt> class object.
+ */
+struct bitmatrices_t {
+  size_t rows;     ///< number of rows
+  size_t cols;     ///< number of columns
+  size_t m;        ///< setwords of a row
+  size_t stride;   ///< setwords between the starts of rows
+  allocators_t al; ///< allocator of the matrix
+  void *block;     ///< allocation holding the rows
+  sets_t *x;       ///< first row, aligned to <tt>LINE</tt>
+};
+
+bitmatrices_t bitmatrices_new(size_t rows, size_t cols)
+{
+  return bitmatrices_new_alloc(rows, cols, &allocators_std);
+}
+
+bitmatrices_t bitmatrices_new_alloc(size_t rows, size_t cols,
+                                    const allocators_t *al)
+{
+  bitmatrices_t b;
+  b = (bitmatrices_t)_amalloc(al, sizeof(*b));
+  b->al = *al;
+  b->rows = rows;
+  b->cols = cols;
+  b->m = cols ? _SETWORDSNEEDED(cols) : 0;
+  b->stride = (b->m + LINEWORDS - 1) / LINEWORDS * LINEWORDS;
+  size_t n = rows * b->stride * sizeof(sets_t);
+  b->block = _acalloc(al, n + LINE, 1);
+  b->x = (sets_t*)(((uintptr_t)b->block + LINE - 1) & ~(uintptr_t)(LINE - 1));
+  return b;
+}
+
+void bitmatrices_free(bitmatrices_t *b)
+{
+  if ( *b == NULL ) return;
+  allocators_t al = (*b)->al;
+  _afree(&al, (*b)->block);
+  _afree(&al, *b);
+  *b = NULL;
+}
+
+size_t bitmatrices_rows(bitmatrices_t b)
+{
+  return b->rows;
+}
+
+size_t bitmatrices_cols(bitmatrices_t b)
+{
+  return b->cols;
+}
+
+size_t bitmatrices_setwords(bitmatrices_t b)
+{
+  return b->m;
+}
+
+sets_t *bitmatrices_row(bitmatrices_t b, size_t i)
+{
+  return b->x + i * b->stride;
+}
+
+void bitmatrices_add(bitmatrices_t b, size_t i, size_t j)
+{
+  _ADDELEMENT(bitmatrices_row(b, i), j);
+}
+
+void bitmatrices_del(bitmatrices_t b, size_t i, size_t j)
+{
+  _DELELEMENT(bitmatrices_row(b, i), j);
+}
+
+int bitmatrices_iselement(bitmatrices_t b, size_t i, size_t j)
+{
+  return _ISELEMENT(bitmatrices_row(b, i), j) ? 1 : -1;
+}
+
+void bitmatrices_column(bitmatrices_t b, size_t j, sets_t s[static 1])
+{
+  size_t w = _SETWD(j), bit = _SETBT(j);
+  const sets_t *row = b->x + w;
+  for ( size_t k = 0; k * _WORDSIZE < b->rows; k++ ) {
+    setwords_t word = 0;
+    size_t n = b->rows - k * _WORDSIZE;
+    if ( n > _WORDSIZE ) n = _WORDSIZE;
+    for ( size_t i = 0; i < n; i++, row += b->stride )
+      word |= ((*row >> bit) & 1) << i;
+    s[k] = word;
+  }
+}
+
+/* transposes 64 by 64 bits, bit j of a[i] becoming bit i of a[j] */
+static
+void _transpose64(uint64_t a[static 64])
+{
+  uint64_t mask = 0x00000000FFFFFFFFULL;
+  for ( unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j )
+    for ( unsigned k = 0; k < 64; k = (k + j + 1) & ~j ) {
+      uint64_t t = ((a[k] >> j) ^ a[k + j]) & mask;
+      a[k] ^= t << j;
+      a[k + j] ^= t;
+    }
+}
+
+bitmatrices_t bitmatrices_transpose(bitmatrices_t b)
+{
+  bitmatrices_t t = bitmatrices_new_alloc(b->cols, b->rows, &b->al);
+  uint64_t a[64];
+  for ( size_t bi = 0; bi * _WORDSIZE < b->rows; bi++ ) {
+    size_t nr = b->rows - bi * _WORDSIZE;
+    if ( nr > _WORDSIZE ) nr = _WORDSIZE;
+    for ( size_t bj = 0; bj < b->m; bj++ ) {
+      size_t nc = b->cols - bj * _WORDSIZE;
+      if ( nc > _WORDSIZE ) nc = _WORDSIZE;
+      const sets_t *src = bitmatrices_row(b, bi * _WORDSIZE) + bj;
+      for ( size_t r = 0; r < nr; r++, src += b->stride ) a[r] = *src;
+      memset(a + nr, 0, (_WORDSIZE - nr) * sizeof(uint64_t));
+      _transpose64(a);
+      sets_t *dst = bitmatrices_row(t, bj * _WORDSIZE) + bi;
+      for ( size_t c = 0; c < nc; c++, dst += t->stride ) *dst = a[c];
+    }
+  }
+  return t;
+}
+
+void bitmatrices_orrows(bitmatrices_t b, const sets_t v[static 1],
+                        sets_t s[static 1])
+{
+  int i;
+  _EMPTYSET(s, b->m);
+  if ( b->rows == 0 ) return;
+  _FOREACHELEMENT(i, v, _SETWORDSNEEDED(b->rows))
+    bit_union(s, s, bitmatrices_row(b, i), b->m);
+}
+
+void bitmatrices_intersectsizes(bitmatrices_t b, const sets_t s[static 1],
+                                uint32_t c[static 1])
+{
+  bit_intersectsizes(c, s, b->x, b->rows, b->stride, b->m);
+}
+
+size_t bitmatrices_intersectfilter(bitmatrices_t b, const sets_t s[static 1],
+                                   size_t num, sets_t r[static 1])
+{
+  return bit_intersectfilter(r, s, b->x, b->rows, b->stride, b->m, num);
+}
+
+void bitmatrices_closure(bitmatrices_t b)
+{
+  for ( size_t k = 0; k < b->rows; k++ ) {
+    const sets_t *rk = bitmatrices_row(b, k);
+    sets_t *ri = b->x;
+    for ( size_t i = 0; i < b->rows; i++, ri += b->stride )
+      if ( i != k && _ISELEMENT(ri, k) ) bit_union(ri, ri, rk, b->m);
+  }
+}
@@ -0,0 +1,182 @@
+/**
+ * @file bitvecs.c
+ * @brief Implementation of <tt>bitvecs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <bitvecs.h>
+# include <string.h>
+# include "allocs.h"
+
+/**
+ * @brief Alignment of setwords, in bytes.
+ */
+# define LINE 64
+
+/**
+ * @brief Setwords per cache line; storage is a multiple of it.
+ */
+# define LINEWORDS (LINE / sizeof(sets_t))
+
+/**
+ * @brief <tt>bitvecs_t</tt> class object.
+ *
+ * Setwords from <tt>m</tt> up to <tt>cap</tt>, and the bits of the last
+ * setword past the universe, are zero.
+ */
+struct bitvecs_t {
+  size_t n;        ///< universe
+  size_t m;        ///< setwords holding the universe
+  size_t cap;      ///< setwords allocated
+  allocators_t al; ///< allocator of the set
+  void *block;     ///< allocation holding the setwords
+  sets_t *x;       ///< first setword, aligned to <tt>LINE</tt>
+};
+
+static inline
+size_t _words(size_t n)
+{
+  return n ? _SETWORDSNEEDED(n) : 0;
+}
+
+/* zeroed storage for cap setwords, rounded up to whole cache lines */
+static
+void _alloc(bitvecs_t v, size_t cap)
+{
+  v->cap = (cap + LINEWORDS - 1) / LINEWORDS * LINEWORDS;
+  v->block = _acalloc(&v->al, v->cap * sizeof(sets_t) + LINE, 1);
+  v->x = (sets_t*)(((uintptr_t)v->block + LINE - 1) & ~(uintptr_t)(LINE - 1));
+}
+
+/* room for m setwords, growing storage geometrically */
+static
+void _reserve(bitvecs_t v, size_t m)
+{
+  void *block = v->block;
+  sets_t *x = v->x;
+  if ( m <= v->cap ) return;
+  _alloc(v, m > 2 * v->cap ? m : 2 * v->cap);
+  memcpy(v->x, x, v->m * sizeof(sets_t));
+  _afree(&v->al, block);
+}
+
+bitvecs_t bitvecs_new(size_t n)
+{
+  return bitvecs_new_alloc(n, &allocators_std);
+}
+
+bitvecs_t bitvecs_new_alloc(size_t n, const allocators_t *al)
+{
+  bitvecs_t v;
+  v = (bitvecs_t)_amalloc(al, sizeof(*v));
+  v->al = *al;
+  v->n = n;
+  v->m = _words(n);
+  _alloc(v, v->m);
+  return v;
+}
+
+void bitvecs_free(bitvecs_t *v)
+{
+  if ( *v == NULL ) return;
+  allocators_t al = (*v)->al;
+  _afree(&al, (*v)->block);
+  _afree(&al, *v);
+  *v = NULL;
+}
+
+bitvecs_t bitvecs_copy(bitvecs_t v)
+{
+  bitvecs_t c = bitvecs_new_alloc(v->n, &v->al);
+  memcpy(c->x, v->x, v->m * sizeof(sets_t));
+  return c;
+}
+
+size_t bitvecs_universe(bitvecs_t v)
+{
+  return v->n;
+}
+
+size_t bitvecs_setwords(bitvecs_t v)
+{
+  return v->m;
+}
+
+sets_t *bitvecs_words(bitvecs_t v)
+{
+  return v->x;
+}
+
+void bitvecs_resize(bitvecs_t v, size_t n)
+{
+  size_t m = _words(n);
+  if ( n < v->n ) {
+    memset(v->x + m, 0, (v->m - m) * sizeof(sets_t));
+    if ( _SETBT(n) != 0 ) v->x[m - 1] &= _BIT(_SETBT(n)) - 1;
+  }
+  else _reserve(v, m);
+  v->n = n;
+  v->m = m;
+}
+
+void bitvecs_add(bitvecs_t v, size_t i)
+{
+  if ( i >= v->n ) bitvecs_resize(v, i + 1);
+  _ADDELEMENT(v->x, i);
+}
+
+void bitvecs_del(bitvecs_t v, size_t i)
+{
+  if ( i < v->n ) _DELELEMENT(v->x, i);
+}
+
+int bitvecs_iselement(bitvecs_t v, size_t i)
+{
+  return i < v->n && _ISELEMENT(v->x, i) ? 1 : -1;
+}
+
+void bitvecs_clear(bitvecs_t v)
+{
+  memset(v->x, 0, v->m * sizeof(sets_t));
+}
+
+size_t bitvecs_size(bitvecs_t v)
+{
+  return bit_setsize(v->x, v->m);
+}
+
+void bitvecs_union(bitvecs_t d, bitvecs_t s)
+{
+  if ( s->n > d->n ) bitvecs_resize(d, s->n);
+  bit_union(d->x, d->x, s->x, s->m);
+}
+
+void bitvecs_intersection(bitvecs_t d, bitvecs_t s)
+{
+  size_t k = d->m < s->m ? d->m : s->m;
+  bit_intersection(d->x, d->x, s->x, k);
+  memset(d->x + k, 0, (d->m - k) * sizeof(sets_t));
+}
+
+void bitvecs_difference(bitvecs_t d, bitvecs_t s)
+{
+  bit_difference(d->x, d->x, s->x, d->m < s->m ? d->m : s->m);
+}
+
+int bitvecs_equal(bitvecs_t v1, bitvecs_t v2)
+{
+  bitvecs_t l;
+  size_t k;
+  if ( v1->m < v2->m ) {
+    l = v2;
+    k = v1->m;
+  }
+  else {
+    l = v1;
+    k = v2->m;
+  }
+  if ( bit_equal(v1->x, v2->x, k) < 0 ) return -1;
+  /* setwords of the larger universe past the smaller one */
+  for ( size_t i = k; i < l->m; i++ ) if ( l->x[i] != 0 ) return -1;
+  return 1;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file blooms.c
+ * @brief Implementation of <tt>blooms_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <blooms.h>
+# include <bit_sets.h>
+# include <hashes.h>
+# include <string.h>
+# include "allocs.h"
+
+/**
+ * @brief Setwords of a block, one cache line.
+ */
+# define WORDS 8
+
+/**
+ * @brief Bits of a block.
+ */
+# define BLOCKBITS _TIMESWORDSIZE(WORDS)
+
+/**
+ * @brief Bits of the remixed hash value picking one bit of a block.
+ */
+# define PICKBITS 9
+
+/**
+ * @brief Most bits set in a block per hash value, so that each bit is picked
+ * by its own <tt>PICKBITS</tt> bits of the remix.
+ */
+# define MAXK 7
+
+/**
+ * @brief Seed of the remix picking the bits of a block.
+ */
+# define SEED 0x9E3779B97F4A7C15ULL
+
+/**
+ * @brief <tt>blooms_t</tt> class object.
+ */
+struct blooms_t {
+  size_t nblocks;  ///< number of blocks, a power of two
+  unsigned lg;     ///< high hash bits picking a block
+  unsigned k;      ///< bits set in a block per hash value
+  sets_t *blocks;  ///< blocks, aligned to a cache line
+  void *base;      ///< allocation of the blocks
+  allocators_t al; ///< allocator of the filter
+};
+
+blooms_t blooms_new(size_t n, size_t bits)
+{
+  return blooms_new_alloc(n, bits, &allocators_std);
+}
+
+blooms_t blooms_new_alloc(size_t n, size_t bits, const allocators_t *al)
+{
+  blooms_t b;
+  size_t need = (n * bits + BLOCKBITS - 1) / BLOCKBITS;
+  b = (blooms_t)_amalloc(al, sizeof(*b));
+  b->al = *al;
+  b->nblocks = 1;
+  b->lg = 0;
+  while ( b->nblocks < need ) b->nblocks <<= 1, b->lg++;
+  /* bits * ln 2 bits per hash value minimize false positives */
+  b->k = (unsigned)((bits * 69 + 50) / 100);
+  if ( b->k < 1 ) b->k = 1;
+  if ( b->k > MAXK ) b->k = MAXK;
+  b->base = _amalloc(al, (b->nblocks + 1) * WORDS * sizeof(sets_t));
+  b->blocks = (sets_t*)(((uintptr_t)b->base + WORDS * sizeof(sets_t) - 1)
+                        & ~(uintptr_t)(WORDS * sizeof(sets_t) - 1));
+  memset(b->blocks, 0, b->nblocks * WORDS * sizeof(sets_t));
+  return b;
+}
+
+void blooms_free(blooms_t *b)
+{
+  if ( *b == NULL ) return;
+  allocators_t al = (*b)->al;
+  _afree(&al, (*b)->base);
+  _afree(&al, *b);
+  *b = NULL;
+}
+
+static inline
+sets_t *_block(blooms_t b, uint64_t h)
+{
+  return b->blocks + (b->lg ? (size_t)(h >> (64 - b->lg)) : 0) * WORDS;
+}
+
+void blooms_add(blooms_t b, uint64_t h)
+{
+  sets_t *s = _block(b, h);
+  uint64_t g = hashes_u64(h, SEED);
+  for ( unsigned i = 0; i < b->k; i++, g >>= PICKBITS )
+    _ADDELEMENT(s, g & (BLOCKBITS - 1));
+}
+
+int blooms_contains(blooms_t b, uint64_t h)
+{
+  const sets_t *s = _block(b, h);
+  uint64_t g = hashes_u64(h, SEED);
+  for ( unsigned i = 0; i < b->k; i++, g >>= PICKBITS )
+    if ( !_ISELEMENT(s, g & (BLOCKBITS - 1)) ) return -1;
+  return 1;
+}
+
+void blooms_clear(blooms_t b)
+{
+  memset(b->blocks, 0, b->nblocks * WORDS * sizeof(sets_t));
+}
+
+size_t blooms_bits(blooms_t b)
+{
+  return b->nblocks * BLOCKBITS;
+}
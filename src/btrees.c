@@ -0,0 +1,444 @@
+/**
+ * @file btrees.c
+ * @brief Implementation of <tt>btrees_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <btrees.h>
+# include <stdint.h>
+# define COUNTS_KIND COUNTERS_BTREES
+# include "allocs.h"
+
+/**
+ * @brief Maximum number of data objects of a node.
+ */
+# define MAXKEYS (2 * BTREES_ORDER - 1)
+
+/**
+ * @brief Internal structure for <tt>btrees_t</tt> object.
+ */
+struct btrees_node_t {
+  unsigned n;                    ///< number of data objects of node
+  unsigned leaf;                 ///< node has no children
+  void *x[MAXKEYS];              ///< data objects, in order
+  struct btrees_node_t *child[]; ///< children of internal nodes
+};
+typedef struct btrees_node_t btrees_node_t;
+
+/**
+ * @brief <tt>btrees_t</tt> class object.
+ */
+struct btrees_t {
+  size_t size;             ///< number of elements in tree
+  btrees_data_cmp cmp;     ///< user provided compare function
+  btrees_data_cmp_r cmp_r; ///< user provided reentrant compare function
+  btrees_node_t *root;     ///< root node
+  allocators_t al;         ///< allocator of the tree
+};
+
+/**
+ * @brief Element removed by <tt>_delete</tt>.
+ */
+typedef enum { KEY, MIN, MAX } which_t;
+
+static
+btrees_node_t *_node(btrees_t t, int leaf)
+{
+  btrees_node_t *n;
+  n = (btrees_node_t*)_amalloc(&t->al, sizeof(btrees_node_t)
+                               + (leaf ? 0 : (MAXKEYS + 1)
+                                  * sizeof(btrees_node_t*)));
+  n->n = 0;
+  n->leaf = leaf;
+  return n;
+}
+
+btrees_t btrees_new(btrees_data_cmp cmp, btrees_data_cmp_r cmp_r)
+{
+  return btrees_new_alloc(cmp, cmp_r, &allocators_std);
+}
+
+btrees_t btrees_new_alloc(btrees_data_cmp cmp, btrees_data_cmp_r cmp_r,
+                          const allocators_t *al)
+{
+  if ( cmp == NULL && cmp_r == NULL ) error(1, errno, "cmp pointers null");
+  btrees_t t;
+  t = (btrees_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
+  t->size = 0;
+  t->cmp = cmp;
+  t->cmp_r = cmp_r;
+  t->root = _node(t, 1);
+  return t;
+}
+
+static inline
+int _cmp(btrees_t t, const void *x, const void *y, void *arg, int r)
+{
+  return r ? t->cmp_r(x, y, arg) : t->cmp(x, y);
+}
+
+/*
+ * index of the first data object of n not less than x, or greater than x if
+ * strict; *found is set if the object at the index is equal to x
+ */
+static
+unsigned _search(btrees_t t, btrees_node_t *n, const void *x, void *arg, int r,
+                 int strict, int *found)
+{
+  unsigned lo = 0, hi = n->n, mid;
+  int c;
+  *found = 0;
+  while ( lo < hi ) {
+    mid = (lo + hi) >> 1;
+    c = _cmp(t, x, n->x[mid], arg, r);
+    if ( c > 0 || (strict && c == 0) ) lo = mid + 1;
+    else {
+      if ( c == 0 ) *found = 1;
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/* split the full child i of p about its median */
+static
+void _split(btrees_t t, btrees_node_t *p, unsigned i)
+{
+  btrees_node_t *y = p->child[i], *z = _node(t, y->leaf);
+  z->n = BTREES_ORDER - 1;
+  memcpy(z->x, y->x + BTREES_ORDER, z->n * sizeof(void*));
+  if ( !y->leaf )
+    memcpy(z->child, y->child + BTREES_ORDER, BTREES_ORDER * sizeof(void*));
+  y->n = BTREES_ORDER - 1;
+  memmove(p->child + i + 2, p->child + i + 1, (p->n - i) * sizeof(void*));
+  memmove(p->x + i + 1, p->x + i, (p->n - i) * sizeof(void*));
+  p->child[i + 1] = z;
+  p->x[i] = y->x[BTREES_ORDER - 1];
+  p->n++;
+}
+
+static
+void _insert(btrees_t t, const void *x, void *arg, int r)
+{
+  btrees_node_t *n = t->root;
+  unsigned i;
+  int found;
+  if ( n->n == MAXKEYS ) {
+    t->root = _node(t, 0);
+    t->root->child[0] = n;
+    _split(t, t->root, 0);
+    n = t->root;
+  }
+  for ( ;; ) {
+    i = _search(t, n, x, arg, r, 0, &found);
+    if ( found ) return;
+    if ( n->leaf ) break;
+    if ( n->child[i]->n == MAXKEYS ) {
+      _split(t, n, i);
+      int c = _cmp(t, x, n->x[i], arg, r);
+      if ( c == 0 ) return;
+      if ( c > 0 ) i++;
+    }
+    n = n->child[i];
+  }
+  memmove(n->x + i + 1, n->x + i, (n->n - i) * sizeof(void*));
+  n->x[i] = (void*)x;
+  n->n++;
+  t->size++;
+}
+
+void btrees_insert(btrees_t t, const void *x)
+{
+  _insert(t, x, NULL, 0);
+}
+
+void btrees_insert_r(btrees_t t, const void *x, void *y)
+{
+  _insert(t, x, y, 1);
+}
+
+/* merge child i + 1 of p and data object i of p into child i */
+static
+void _merge(btrees_t t, btrees_node_t *p, unsigned i)
+{
+  btrees_node_t *y = p->child[i], *z = p->child[i + 1];
+  y->x[y->n] = p->x[i];
+  memcpy(y->x + y->n + 1, z->x, z->n * sizeof(void*));
+  if ( !y->leaf )
+    memcpy(y->child + y->n + 1, z->child, (z->n + 1) * sizeof(void*));
+  y->n += z->n + 1;
+  memmove(p->x + i, p->x + i + 1, (p->n - i - 1) * sizeof(void*));
+  memmove(p->child + i + 1, p->child + i + 2, (p->n - i - 1) * sizeof(void*));
+  p->n--;
+  _afree(&t->al, z);
+}
+
+/* give child i of p at least BTREES_ORDER data objects; return its index */
+static
+unsigned _fill(btrees_t t, btrees_node_t *p, unsigned i)
+{
+  btrees_node_t *y = p->child[i], *s;
+  if ( y->n >= BTREES_ORDER ) return i;
+  if ( i > 0 && (s = p->child[i - 1])->n >= BTREES_ORDER ) {
+    /* rotate through p from the left sibling */
+    memmove(y->x + 1, y->x, y->n * sizeof(void*));
+    if ( !y->leaf )
+      memmove(y->child + 1, y->child, (y->n + 1) * sizeof(void*));
+    y->x[0] = p->x[i - 1];
+    if ( !y->leaf ) y->child[0] = s->child[s->n];
+    p->x[i - 1] = s->x[s->n - 1];
+    s->n--;
+    y->n++;
+    return i;
+  }
+  if ( i < p->n && (s = p->child[i + 1])->n >= BTREES_ORDER ) {
+    /* rotate through p from the right sibling */
+    y->x[y->n] = p->x[i];
+    if ( !y->leaf ) y->child[y->n + 1] = s->child[0];
+    p->x[i] = s->x[0];
+    memmove(s->x, s->x + 1, (s->n - 1) * sizeof(void*));
+    if ( !s->leaf ) memmove(s->child, s->child + 1, s->n * sizeof(void*));
+    s->n--;
+    y->n++;
+    return i;
+  }
+  if ( i == p->n ) i--;
+  _merge(t, p, i);
+  return i;
+}
+
+/*
+ * remove x, the least or the greatest data object of the subtree at n, keeping
+ * every node visited above the minimum occupancy before descending into it
+ */
+static
+void *_delete(btrees_t t, btrees_node_t *n, const void *x, void *arg, int r,
+              which_t which)
+{
+  unsigned i;
+  int found;
+  void *y;
+  for ( ;; ) {
+    if ( which == KEY ) i = _search(t, n, x, arg, r, 0, &found);
+    else {
+      found = n->leaf;
+      i = which == MIN ? 0 : n->n - n->leaf;
+    }
+    if ( n->leaf ) {
+      if ( !found ) return NULL;
+      y = n->x[i];
+      memmove(n->x + i, n->x + i + 1, (n->n - i - 1) * sizeof(void*));
+      n->n--;
+      return y;
+    }
+    if ( found ) {
+      y = n->x[i];
+      if ( n->child[i]->n >= BTREES_ORDER )
+        n->x[i] = _delete(t, n->child[i], NULL, NULL, 0, MAX);
+      else if ( n->child[i + 1]->n >= BTREES_ORDER )
+        n->x[i] = _delete(t, n->child[i + 1], NULL, NULL, 0, MIN);
+      else {
+        _merge(t, n, i);
+        n = n->child[i];
+        continue;
+      }
+      return y;
+    }
+    n = n->child[_fill(t, n, i)];
+  }
+}
+
+/* remove and return the selected data object, shrinking the root if emptied */
+static
+void *_remove(btrees_t t, const void *x, void *arg, int r, which_t which)
+{
+  void *y;
+  if ( t->size == 0 ) return NULL;
+  y = _delete(t, t->root, x, arg, r, which);
+  if ( t->root->n == 0 && !t->root->leaf ) {
+    btrees_node_t *n = t->root;
+    t->root = n->child[0];
+    _afree(&t->al, n);
+  }
+  if ( y != NULL ) t->size--;
+  return y;
+}
+
+void *btrees_remove(btrees_t t, const void *x)
+{
+  return _remove(t, x, NULL, 0, KEY);
+}
+
+void *btrees_remove_r(btrees_t t, const void *x, void *y)
+{
+  return _remove(t, x, y, 1, KEY);
+}
+
+void *btrees_pop_min(btrees_t t)
+{
+  return _remove(t, NULL, NULL, 0, MIN);
+}
+
+void *btrees_pop_max(btrees_t t)
+{
+  return _remove(t, NULL, NULL, 0, MAX);
+}
+
+void *btrees_min(btrees_t t)
+{
+  btrees_node_t *n = t->root;
+  if ( t->size == 0 ) return NULL;
+  for ( ; !n->leaf; n = n->child[0] );
+  return n->x[0];
+}
+
+void *btrees_max(btrees_t t)
+{
+  btrees_node_t *n = t->root;
+  if ( t->size == 0 ) return NULL;
+  for ( ; !n->leaf; n = n->child[n->n] );
+  return n->x[n->n - 1];
+}
+
+/* least data object not less than x, or greater than x if strict */
+static
+void *_bound(btrees_t t, const void *x, void *arg, int r, int strict)
+{
+  btrees_node_t *n = t->root;
+  void *y = NULL;
+  unsigned i;
+  int found;
+  for ( ;; ) {
+    i = _search(t, n, x, arg, r, strict, &found);
+    if ( found ) return n->x[i];
+    if ( i < n->n ) y = n->x[i];
+    if ( n->leaf ) return y;
+    n = n->child[i];
+  }
+}
+
+void *btrees_find(btrees_t t, const void *x)
+{
+  void *y = _bound(t, x, NULL, 0, 0);
+  return y != NULL && t->cmp(x, y) == 0 ? y : NULL;
+}
+
+void *btrees_find_r(btrees_t t, const void *x, void *z)
+{
+  void *y = _bound(t, x, z, 1, 0);
+  return y != NULL && t->cmp_r(x, y, z) == 0 ? y : NULL;
+}
+
+void *btrees_lower_bound(btrees_t t, const void *x)
+{
+  return _bound(t, x, NULL, 0, 0);
+}
+
+void *btrees_lower_bound_r(btrees_t t, const void *x, void *y)
+{
+  return _bound(t, x, y, 1, 0);
+}
+
+void *btrees_upper_bound(btrees_t t, const void *x)
+{
+  return _bound(t, x, NULL, 0, 1);
+}
+
+void *btrees_upper_bound_r(btrees_t t, const void *x, void *y)
+{
+  return _bound(t, x, y, 1, 1);
+}
+
+/**
+ * @brief Arguments of a range traversal.
+ */
+typedef struct {
+  btrees_t t;                        ///< tree being traversed
+  const void *hi;                    ///< end of range, if any
+  int (*apply)(void **x);            ///< function applied to members
+  int (*apply_r)(void **x, void *y); ///< reentrant function applied to members
+  void *y;                           ///< argument to apply_r
+  void *cmp_arg;                     ///< argument to reentrant compare function
+  int r;                             ///< use reentrant functions
+} range_t;
+
+/*
+ * apply to the data objects of the subtree at n from lo, if any, on; return -1
+ * on early termination, 0 on passing hi and 1 otherwise
+ */
+static
+int _range(range_t *a, btrees_node_t *n, const void *lo)
+{
+  unsigned i = 0;
+  int found = 0, c;
+  if ( lo != NULL ) i = _search(a->t, n, lo, a->cmp_arg, a->r, 0, &found);
+  for ( ; i <= n->n; i++, lo = NULL ) {
+    if ( !n->leaf && !(lo != NULL && found) )
+      if ( (c = _range(a, n->child[i], lo)) <= 0 ) return c;
+    if ( i == n->n ) break;
+    if ( a->hi != NULL && _cmp(a->t, n->x[i], a->hi, a->cmp_arg, a->r) >= 0 )
+      return 0;
+    if ( (a->r ? a->apply_r(&n->x[i], a->y) : a->apply(&n->x[i])) < 0 )
+      return -1;
+  }
+  return 1;
+}
+
+int btrees_range(btrees_t t, const void *lo, const void *hi,
+                 int apply(void **x))
+{
+  range_t a = {
+    .t = t, .hi = hi, .apply = apply, .apply_r = NULL, .y = NULL,
+    .cmp_arg = NULL, .r = 0,
+  };
+  return _range(&a, t->root, lo) < 0 ? -1 : 1;
+}
+
+int btrees_range_r(btrees_t t, const void *lo, const void *hi,
+                   int apply(void **x, void *y), void *y, void *cmp_arg)
+{
+  range_t a = {
+    .t = t, .hi = hi, .apply = NULL, .apply_r = apply, .y = y,
+    .cmp_arg = cmp_arg, .r = 1,
+  };
+  return _range(&a, t->root, lo) < 0 ? -1 : 1;
+}
+
+int btrees_map(btrees_t t, int apply(void **x))
+{
+  if ( t == NULL ) return 1;
+  return btrees_range(t, NULL, NULL, apply);
+}
+
+int btrees_map_r(btrees_t t, int apply(void **x, void *y), void *y)
+{
+  if ( t == NULL ) return 1;
+  range_t a = {
+    .t = t, .hi = NULL, .apply = NULL, .apply_r = apply, .y = y,
+    .cmp_arg = NULL, .r = 1,
+  };
+  return _range(&a, t->root, NULL) < 0 ? -1 : 1;
+}
+
+static
+void _free_nodes(allocators_t *al, btrees_node_t *n)
+{
+  if ( !n->leaf )
+    for ( unsigned i = 0; i <= n->n; i++ ) _free_nodes(al, n->child[i]);
+  _afree(al, n);
+}
+
+void btrees_free(btrees_t *t)
+{
+  if ( *t == NULL ) return;
+  allocators_t al = (*t)->al;
+  _free_nodes(&al, (*t)->root);
+  _afree(&al, *t);
+  *t = NULL;
+}
+
+size_t btrees_size(btrees_t t)
+{
+  return t->size;
+}
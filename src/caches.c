@@ -0,0 +1,288 @@
+/**
+ * @file caches.c
+ * @brief Implementation of <tt>caches_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <caches.h>
+# include "allocs.h"
+
+/**
+ * @brief Element of a cache, as held by its hash table.
+ */
+typedef struct entry_t {
+  void *x;               ///< pointer to data
+  uint64_t hash;         ///< hash value of data
+  struct entry_t *prev;  ///< more recently used element
+  struct entry_t *next;  ///< less recently used element, or next free entry
+} entry_t;
+
+/**
+ * @brief <tt>caches_t</tt> class object.
+ *
+ * The hash table holds pointers to entries, all of them allocated with the
+ * cache, and is searched through its reentrant functions with an
+ * <tt>op_t</tt>, so that data is hashed once, by the cache.
+ */
+struct caches_t {
+  size_t capacity;              ///< most elements held
+  caches_data_cmp cmp;          ///< user defined compare function
+  caches_data_cmp_r cmp_r;      ///< user defined reentrant compare function
+  caches_hash hash;             ///< user defined hashing function
+  caches_hash_r hash_r;         ///< user defined reentrant hashing function
+  void (*evict)(void*, void*);  ///< user defined eviction function
+  void *evict_arg;              ///< argument to <tt>evict</tt>
+  hashtabs_t t;                 ///< entries by data
+  entry_t *entries;             ///< every entry
+  entry_t *head;                ///< most recently used element
+  entry_t *tail;                ///< least recently used element
+  entry_t *free;                ///< list of unused entries
+  size_t hits;                  ///< finds of data in the cache
+  size_t misses;                ///< finds of data not in the cache
+  size_t evictions;             ///< elements evicted by inserts
+  allocators_t al;              ///< allocator of the cache
+};
+
+/**
+ * @brief State of one operation, handed to the hash table as both of its
+ * reentrant arguments.
+ */
+typedef struct {
+  caches_t c;      ///< cache
+  void *queue_arg; ///< argument to user defined reentrant compare function
+  uint64_t h;      ///< hash value of data of the operation
+  int r;           ///< the operation is reentrant
+} op_t;
+
+static
+uint64_t _op_hash(const void *x, const void *_o)
+{
+  (void)x;
+  return ((const op_t*)_o)->h;
+}
+
+static
+int _op_cmp(const void *_a, const void *_b, void *_o)
+{
+  op_t *o = (op_t*)_o;
+  const void *a = ((const entry_t*)_a)->x, *b = ((const entry_t*)_b)->x;
+  return o->r ? o->c->cmp_r(a, b, o->queue_arg) : o->c->cmp(a, b);
+}
+
+static inline
+uint64_t _hash(caches_t c, const void *x, const void *hash_arg, int r)
+{
+  return r ? c->hash_r(x, hash_arg) : c->hash(x);
+}
+
+caches_t caches_new(caches_data_cmp cmp, caches_data_cmp_r cmp_r,
+                    caches_hash hash, caches_hash_r hash_r, size_t capacity)
+{
+  return caches_new_alloc(cmp, cmp_r, hash, hash_r, capacity, &allocators_std);
+}
+
+caches_t caches_new_alloc(caches_data_cmp cmp, caches_data_cmp_r cmp_r,
+                          caches_hash hash, caches_hash_r hash_r,
+                          size_t capacity, const allocators_t *al)
+{
+  caches_t c;
+  c = (caches_t)_amalloc(al, sizeof(*c));
+  c->al = *al;
+  c->capacity = capacity;
+  c->cmp = cmp;
+  c->cmp_r = cmp_r;
+  c->hash = hash;
+  c->hash_r = hash_r;
+  c->evict = NULL;
+  c->evict_arg = NULL;
+  c->t = hashtabs_new_alloc(NULL, _op_cmp, NULL, _op_hash, capacity, al);
+  c->entries = (entry_t*)_amalloc(al, capacity * sizeof(entry_t));
+  for ( size_t i = 0; i < capacity; i++ )
+    c->entries[i].next = i + 1 < capacity ? &c->entries[i + 1] : NULL;
+  c->free = c->entries;
+  c->head = c->tail = NULL;
+  c->hits = c->misses = c->evictions = 0;
+  return c;
+}
+
+void caches_onevict(caches_t c, void evict(void *x, void *y), void *y)
+{
+  c->evict = evict;
+  c->evict_arg = y;
+}
+
+static inline
+void _unlink(caches_t c, entry_t *e)
+{
+  if ( e->prev != NULL ) e->prev->next = e->next;
+  else c->head = e->next;
+  if ( e->next != NULL ) e->next->prev = e->prev;
+  else c->tail = e->prev;
+}
+
+static inline
+void _push_front(caches_t c, entry_t *e)
+{
+  e->prev = NULL;
+  e->next = c->head;
+  if ( c->head != NULL ) c->head->prev = e;
+  else c->tail = e;
+  c->head = e;
+}
+
+static
+void *_get(caches_t c, const void *x, const void *hash_arg, void *queue_arg,
+           int r)
+{
+  op_t o = { c, queue_arg, _hash(c, x, hash_arg, r), r };
+  entry_t key = { .x = (void*)x }, *e;
+  if ( (e = (entry_t*)hashtabs_find_r(c->t, &key, &o, &o)) == NULL ) {
+    c->misses++;
+    return NULL;
+  }
+  c->hits++;
+  if ( e != c->head ) {
+    _unlink(c, e);
+    _push_front(c, e);
+  }
+  return e->x;
+}
+
+void *caches_get(caches_t c, const void *x)
+{
+  return _get(c, x, NULL, NULL, 0);
+}
+
+void *caches_get_r(caches_t c, const void *x, const void *hash_arg,
+                   void *queue_arg)
+{
+  return _get(c, x, hash_arg, queue_arg, 1);
+}
+
+/* evicts the least recently used element */
+static
+void _evict(caches_t c, int r, void *queue_arg)
+{
+  entry_t *e = c->tail;
+  op_t o = { c, queue_arg, e->hash, r };
+  (void)hashtabs_remove_r(c->t, e, &o, &o);
+  _unlink(c, e);
+  e->next = c->free;
+  c->free = e;
+  c->evictions++;
+  if ( c->evict != NULL ) c->evict(e->x, c->evict_arg);
+}
+
+static
+void *_put(caches_t c, const void *x, const void *hash_arg, void *queue_arg,
+           int r)
+{
+  op_t o = { c, queue_arg, _hash(c, x, hash_arg, r), r };
+  entry_t *e, *f;
+  int inserted;
+  void *y;
+  if ( c->free == NULL ) {
+    entry_t key = { .x = (void*)x };
+    /* a replacement evicts nothing */
+    if ( (e = (entry_t*)hashtabs_find_r(c->t, &key, &o, &o)) != NULL ) {
+      y = e->x;
+      e->x = (void*)x;
+      if ( e != c->head ) {
+        _unlink(c, e);
+        _push_front(c, e);
+      }
+      return y;
+    }
+    _evict(c, r, queue_arg);
+  }
+  e = c->free;
+  e->x = (void*)x;
+  e->hash = o.h;
+  f = (entry_t*)hashtabs_find_or_insert_r(c->t, e, &o, &o, &inserted);
+  if ( inserted ) {
+    c->free = e->next;
+    _push_front(c, e);
+    return NULL;
+  }
+  y = f->x;
+  f->x = (void*)x;
+  if ( f != c->head ) {
+    _unlink(c, f);
+    _push_front(c, f);
+  }
+  return y;
+}
+
+void *caches_put(caches_t c, const void *x)
+{
+  return _put(c, x, NULL, NULL, 0);
+}
+
+void *caches_put_r(caches_t c, const void *x, const void *hash_arg,
+                   void *queue_arg)
+{
+  return _put(c, x, hash_arg, queue_arg, 1);
+}
+
+static
+void *_remove(caches_t c, const void *x, const void *hash_arg, void *queue_arg,
+              int r)
+{
+  op_t o = { c, queue_arg, _hash(c, x, hash_arg, r), r };
+  entry_t key = { .x = (void*)x }, *e;
+  if ( (e = (entry_t*)hashtabs_remove_r(c->t, &key, &o, &o)) == NULL )
+    return NULL;
+  _unlink(c, e);
+  e->next = c->free;
+  c->free = e;
+  return e->x;
+}
+
+void *caches_remove(caches_t c, const void *x)
+{
+  return _remove(c, x, NULL, NULL, 0);
+}
+
+void *caches_remove_r(caches_t c, const void *x, const void *hash_arg,
+                      void *queue_arg)
+{
+  return _remove(c, x, hash_arg, queue_arg, 1);
+}
+
+int caches_map(caches_t c, int apply(void **x))
+{
+  for ( entry_t *e = c->head; e != NULL; e = e->next )
+    if ( apply(&e->x) < 0 ) return -1;
+  return 1;
+}
+
+int caches_map_r(caches_t c, int apply(void **x, void *y), void *y)
+{
+  for ( entry_t *e = c->head; e != NULL; e = e->next )
+    if ( apply(&e->x, y) < 0 ) return -1;
+  return 1;
+}
+
+void caches_free(caches_t *c)
+{
+  if ( *c == NULL ) return;
+  allocators_t al = (*c)->al;
+  hashtabs_free(&(*c)->t);
+  _afree(&al, (*c)->entries);
+  _afree(&al, *c);
+  *c = NULL;
+}
+
+size_t caches_size(caches_t c)
+{
+  return hashtabs_size(c->t);
+}
+
+void caches_stats(caches_t c, caches_stats_t *s)
+{
+  s->size = hashtabs_size(c->t);
+  s->capacity = c->capacity;
+  s->hits = c->hits;
+  s->misses = c->misses;
+  s->evictions = c->evictions;
+}
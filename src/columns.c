@@ -0,0 +1,182 @@
+/**
+ * @file columns.c
+ * @brief Implementation of <tt>columns_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <columns.h>
+# include <string.h>
+# define COUNTS_KIND COUNTERS_COLUMNS
+# include "allocs.h"
+
+/**
+ * @brief <tt>columns_t</tt> class object.
+ */
+struct columns_t {
+  size_t nfields;  ///< number of fields of records
+  size_t capacity; ///< number of possible records
+  size_t nmem;     ///< number of records
+  size_t *size;    ///< size of each field
+  char **x;        ///< columns, one per field
+  allocators_t al; ///< allocator of the columns
+};
+
+/**
+ * @brief Column being sorted by <tt>_sort</tt>.
+ */
+typedef struct {
+  const char *x;                                 ///< column sorted by
+  size_t size;                                   ///< size of its fields
+  int (*cmp)(const void*, const void*);          ///< user compare function
+  int (*cmp_r)(const void*, const void*, void*); ///< reentrant compare function
+  void *z;                                       ///< argument to cmp_r
+} order_t;
+
+columns_t columns_new(size_t nfields, const size_t *sizes, size_t capacity)
+{
+  return columns_new_alloc(nfields, sizes, capacity, &allocators_std);
+}
+
+columns_t columns_new_alloc(size_t nfields, const size_t *sizes,
+                            size_t capacity, const allocators_t *al)
+{
+  columns_t c;
+  c = (columns_t)_amalloc(al, sizeof(*c));
+  c->al = *al;
+  c->nfields = nfields;
+  c->capacity = capacity;
+  c->nmem = 0;
+  c->size = (size_t*)_amalloc(al, nfields * sizeof(size_t));
+  c->x = (char**)_amalloc(al, nfields * sizeof(char*));
+  for ( size_t j = 0; j < nfields; j++ ) {
+    c->size[j] = sizes[j];
+    c->x[j] = capacity == 0 ? NULL : (char*)_amalloc(al, capacity * sizes[j]);
+  }
+  return c;
+}
+
+void columns_push(columns_t c, const void *const *x)
+{
+  if ( c->nmem == c->capacity )
+    columns_resize(c, (c->nmem==0) ? 1 : ((c->nmem==1) ? 2 : ((3*c->nmem)>>1UL)));
+  for ( size_t j = 0; j < c->nfields; j++ )
+    memcpy(c->x[j] + c->nmem * c->size[j], x[j], c->size[j]);
+  c->nmem++;
+}
+
+void columns_get(columns_t c, size_t i, void *const *x)
+{
+  for ( size_t j = 0; j < c->nfields; j++ )
+    memcpy(x[j], c->x[j] + i * c->size[j], c->size[j]);
+}
+
+void *columns_at(columns_t c, size_t j, size_t i)
+{
+  return c->x[j] + i * c->size[j];
+}
+
+void *columns_column(columns_t c, size_t j)
+{
+  return c->x[j];
+}
+
+int columns_map(columns_t c, size_t j, int apply(void *x))
+{
+  for ( size_t i = 0; i < c->nmem; i++ )
+    if ( apply(c->x[j] + i * c->size[j]) < 0 ) return -1;
+  return 1;
+}
+
+int columns_map_r(columns_t c, size_t j, int apply(void *x, void *y), void *y)
+{
+  for ( size_t i = 0; i < c->nmem; i++ )
+    if ( apply(c->x[j] + i * c->size[j], y) < 0 ) return -1;
+  return 1;
+}
+
+/* order of two indices by their fields, ties broken by index for stability */
+static
+int _cmp_index(const void *x, const void *y, void *_k)
+{
+  const order_t *k = (const order_t*)_k;
+  size_t i = *(const size_t*)x, l = *(const size_t*)y;
+  const char *p = k->x + i * k->size, *q = k->x + l * k->size;
+  int r = k->cmp != NULL ? k->cmp(p, q) : k->cmp_r(p, q, k->z);
+  if ( r != 0 ) return r;
+  return (i > l) - (i < l);
+}
+
+static
+void _sort(columns_t c, order_t *k)
+{
+  if ( c->nmem < 2 ) return;
+  size_t *perm = (size_t*)_amalloc(&c->al, c->nmem * sizeof(size_t));
+  for ( size_t i = 0; i < c->nmem; i++ ) perm[i] = i;
+  qsort_r(perm, c->nmem, sizeof(size_t), _cmp_index, k);
+  for ( size_t j = 0; j < c->nfields; j++ ) {
+    size_t s = c->size[j];
+    char *y = (char*)_amalloc(&c->al, c->capacity * s);
+    for ( size_t i = 0; i < c->nmem; i++ )
+      memcpy(y + i * s, c->x[j] + perm[i] * s, s);
+    _afree(&c->al, c->x[j]);
+    c->x[j] = y;
+  }
+  _afree(&c->al, perm);
+}
+
+void columns_sort(columns_t c, size_t j, int cmp(const void *x, const void *y))
+{
+  order_t k = { c->x[j], c->size[j], cmp, NULL, NULL };
+  _sort(c, &k);
+}
+
+void columns_sort_r(columns_t c, size_t j,
+                    int cmp(const void *x, const void *y, void *z), void *z)
+{
+  order_t k = { c->x[j], c->size[j], NULL, cmp, z };
+  _sort(c, &k);
+}
+
+void columns_resize(columns_t c, size_t capacity)
+{
+  for ( size_t j = 0; j < c->nfields; j++ ) {
+    if ( capacity == 0 ) {
+      _afree(&c->al, c->x[j]);
+      c->x[j] = NULL;
+    }
+    else c->x[j] = (char*)_arealloc(&c->al, c->x[j], capacity * c->size[j]);
+  }
+  c->capacity = capacity;
+  if ( c->nmem > capacity ) c->nmem = capacity;
+}
+
+void columns_free(columns_t *c)
+{
+  if ( c == NULL || *c == NULL ) return;
+  allocators_t al = (*c)->al;
+  for ( size_t j = 0; j < (*c)->nfields; j++ ) _afree(&al, (*c)->x[j]);
+  _afree(&al, (*c)->x);
+  _afree(&al, (*c)->size);
+  _afree(&al, *c);
+  *c = NULL;
+}
+
+size_t columns_nmem(columns_t c)
+{
+  return c->nmem;
+}
+
+size_t columns_capacity(columns_t c)
+{
+  return c->capacity;
+}
+
+size_t columns_nfields(columns_t c)
+{
+  return c->nfields;
+}
+
+size_t columns_size(columns_t c, size_t j)
+{
+  return c->size[j];
+}
@@ -0,0 +1,176 @@
+/**
+ * @file concurrentdisjointsets.c
+ * @brief Implementation of <tt>cdisjointsets_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <concurrentdisjointsets.h>
+# include <stdatomic.h>
+# include "ranges.h"
+
+/**
+ * @brief <tt>cdisjointsets_t</tt> class object.
+ */
+struct cdisjointsets_t {
+  size_t n;              ///< number of elements
+  atomic_size_t count;   ///< number of sets
+  _Atomic uint32_t *p;   ///< parent of every element, roots being their own
+  allocators_t al;       ///< allocator of the partition
+};
+
+cdisjointsets_t cdisjointsets_new(size_t n)
+{
+  return cdisjointsets_new_alloc(n, &allocators_std);
+}
+
+cdisjointsets_t cdisjointsets_new_alloc(size_t n, const allocators_t *al)
+{
+  cdisjointsets_t d;
+  d = (cdisjointsets_t)_amalloc(al, sizeof(*d));
+  d->al = *al;
+  d->n = n;
+  atomic_init(&d->count, n);
+  d->p = (_Atomic uint32_t*)_amalloc(al, (n ? n : 1) * sizeof(*d->p));
+  for ( size_t i = 0; i < n; i++ ) atomic_init(&d->p[i], (uint32_t)i);
+  return d;
+}
+
+void cdisjointsets_free(cdisjointsets_t *d)
+{
+  if ( *d == NULL ) return;
+  allocators_t al = (*d)->al;
+  _afree(&al, (void*)(*d)->p);
+  _afree(&al, *d);
+  *d = NULL;
+}
+
+static inline
+uint32_t _parent(cdisjointsets_t d, uint32_t x)
+{
+  return atomic_load_explicit(&d->p[x], memory_order_acquire);
+}
+
+/* root of x, halving the path; a failed halving leaves a valid ancestor */
+static inline
+uint32_t _find(cdisjointsets_t d, uint32_t x)
+{
+  uint32_t q, g;
+  while ( (q = _parent(d, x)) != x ) {
+    if ( (g = _parent(d, q)) != q )
+      atomic_compare_exchange_weak_explicit(&d->p[x], &q, g,
+                                            memory_order_release,
+                                            memory_order_relaxed);
+    x = g;
+  }
+  return x;
+}
+
+uint32_t cdisjointsets_find(cdisjointsets_t d, uint32_t x)
+{
+  return _find(d, x);
+}
+
+static inline
+int _union(cdisjointsets_t d, uint32_t x, uint32_t y)
+{
+  uint32_t t;
+  for ( ;; ) {
+    if ( (x = _find(d, x)) == (y = _find(d, y)) ) return -1;
+    /* roots only gain parents of smaller index: no cycle can form */
+    if ( x < y ) {
+      t = x;
+      x = y;
+      y = t;
+    }
+    t = x;
+    if ( atomic_compare_exchange_strong_explicit(&d->p[x], &t, y,
+                                                 memory_order_acq_rel,
+                                                 memory_order_relaxed) ) {
+      atomic_fetch_sub_explicit(&d->count, 1, memory_order_relaxed);
+      return 1;
+    }
+  }
+}
+
+int cdisjointsets_union(cdisjointsets_t d, uint32_t x, uint32_t y)
+{
+  return _union(d, x, y);
+}
+
+int cdisjointsets_same(cdisjointsets_t d, uint32_t x, uint32_t y)
+{
+  for ( ;; ) {
+    if ( (x = _find(d, x)) == (y = _find(d, y)) ) return 1;
+    /* x still a root once y was found: the sets were apart in between */
+    if ( _parent(d, x) == x ) return -1;
+  }
+}
+
+/**
+ * @brief Shared state of a parallel union.
+ */
+typedef struct {
+  cdisjointsets_t d;  ///< partition
+  const uint32_t *e;  ///< edges
+  atomic_size_t k;    ///< edges which joined two sets
+} edges_t;
+
+static
+int _union_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  edges_t *s = (edges_t*)y;
+  size_t k = 0;
+  (void)w;
+  for ( size_t i = lo; i < hi; i++ )
+    k += _union(s->d, s->e[2 * i], s->e[2 * i + 1]) > 0;
+  atomic_fetch_add_explicit(&s->k, k, memory_order_relaxed);
+  return 1;
+}
+
+size_t cdisjointsets_union_parallel(cdisjointsets_t d, const uint32_t *e,
+                                    size_t m, workers_t w)
+{
+  edges_t s = { .d = d, .e = e };
+  atomic_init(&s.k, 0);
+  (void)_ranges(w, m, _union_range, &s);
+  return atomic_load(&s.k);
+}
+
+/**
+ * @brief Shared state of a parallel labeling.
+ */
+typedef struct {
+  cdisjointsets_t d;  ///< partition
+  uint32_t *out;      ///< labels
+} labels_t;
+
+static
+int _labels_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  labels_t *s = (labels_t*)y;
+  (void)w;
+  for ( size_t i = lo; i < hi; i++ ) s->out[i] = _find(s->d, (uint32_t)i);
+  return 1;
+}
+
+void cdisjointsets_labels(cdisjointsets_t d, uint32_t *out)
+{
+  for ( size_t i = 0; i < d->n; i++ ) out[i] = _find(d, (uint32_t)i);
+}
+
+void cdisjointsets_labels_parallel(cdisjointsets_t d, uint32_t *out,
+                                   workers_t w)
+{
+  labels_t s = { d, out };
+  (void)_ranges(w, d->n, _labels_range, &s);
+}
+
+size_t cdisjointsets_count(cdisjointsets_t d)
+{
+  return atomic_load(&d->count);
+}
+
+size_t cdisjointsets_size(cdisjointsets_t d)
+{
+  return d->n;
+}
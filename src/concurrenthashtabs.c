@@ -0,0 +1,409 @@
+/**
+ * @file concurrenthashtabs.c
+ * @brief Implementation of <tt>chashtabs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <concurrenthashtabs.h>
+# include <stdatomic.h>
+# include <pthread.h>
+# include <sched.h>
+# include <errno.h>
+# include <error.h>
+# include "primes.h"
+# include "epochs.h"
+
+/**
+ * @brief Number of bucket stripes, each guarded by its own lock.
+ */
+# define NSTRIPES 64
+
+/**
+ * @brief Number of old buckets copied at a time while the table grows.
+ */
+# define CHUNK 256
+
+/**
+ * @brief Link of a hash table bucket.
+ */
+typedef struct node_t {
+  void *x;                      ///< pointer to data
+  uint64_t hash;                ///< hash value of data
+  _Atomic(struct node_t*) next; ///< next link of bucket
+} node_t;
+
+/**
+ * @brief Bucket array.
+ */
+typedef struct {
+  size_t cap_index;    ///< index to prime array corr. to prime length
+  _Atomic(node_t*) *A; ///< buckets
+} table_t;
+
+/**
+ * @brief State of a growth shared by the threads copying buckets.
+ */
+typedef struct {
+  table_t *from;        ///< bucket array being copied
+  table_t *to;          ///< bucket array being filled
+  size_t nchunks;       ///< number of chunks of <tt>from</tt>
+  atomic_size_t chunk;  ///< next chunk to be claimed
+  atomic_size_t copied; ///< number of chunks copied
+} resize_t;
+
+/**
+ * @brief <tt>chashtabs_t</tt> class object.
+ */
+struct chashtabs_t {
+  atomic_size_t size;              ///< number of elements in hash table
+  atomic_size_t maxload;           ///< elements per bucket triggering growth
+  atomic_int growing;              ///< a thread is growing the table
+  _Atomic(table_t*) tab;           ///< current bucket array
+  _Atomic(resize_t*) rs;           ///< growth in progress, if any
+  chashtabs_data_cmp cmp;          ///< user defined compare function
+  chashtabs_data_cmp_r cmp_r;      ///< user defined reentrant compare function
+  chashtabs_hash hash;             ///< user defined hashing function
+  chashtabs_hash_r hash_r;         ///< user defined reentrant hashing function
+  pthread_mutex_t locks[NSTRIPES]; ///< stripe locks of writers
+};
+
+static
+table_t *_table_new(size_t cap_index)
+{
+  table_t *tab;
+  if ( (tab = (table_t*)malloc(sizeof(*tab))) == NULL )
+    error(1, errno, "malloc failure");
+  tab->cap_index = cap_index;
+  if ( (tab->A = (_Atomic(node_t*)*)calloc(_primes[cap_index],
+                                           sizeof(*tab->A))) == NULL )
+    error(1, errno, "malloc failure");
+  return tab;
+}
+
+static
+void _table_free(void *_tab)
+{
+  table_t *tab = (table_t*)_tab;
+  node_t *n, *next;
+  for ( size_t i = 0; i < _primes[tab->cap_index]; i++ )
+    for ( n = atomic_load_explicit(&tab->A[i], memory_order_relaxed); n != NULL;
+          n = next ) {
+      next = atomic_load_explicit(&n->next, memory_order_relaxed);
+      free(n);
+    }
+  free(tab->A);
+  free(tab);
+}
+
+chashtabs_t chashtabs_new(chashtabs_data_cmp cmp, chashtabs_data_cmp_r cmp_r,
+                          chashtabs_hash hash, chashtabs_hash_r hash_r, size_t n)
+{
+  chashtabs_t t;
+  if ( (t = (chashtabs_t)malloc(sizeof(*t))) == NULL )
+    error(1, errno, "malloc failure");
+  atomic_init(&t->size, 0);
+  atomic_init(&t->maxload, CHASHTABS_MAXLOAD);
+  atomic_init(&t->growing, 0);
+  atomic_init(&t->tab, _table_new(_get_cap_index(n)));
+  atomic_init(&t->rs, NULL);
+  t->cmp = cmp;
+  t->cmp_r = cmp_r;
+  t->hash = hash;
+  t->hash_r = hash_r;
+  for ( int i = 0; i < NSTRIPES; i++ ) pthread_mutex_init(&t->locks[i], NULL);
+  return t;
+}
+
+static inline
+int _eq(chashtabs_t t, const void *x, const void *y, void *cmp_arg, int r)
+{
+  return (r ? t->cmp_r(x, y, cmp_arg) : t->cmp(x, y)) == 0;
+}
+
+/*
+ * node of bucket p holding data equal to x of hash h, or NULL; *link is set to
+ * the link pointing to it
+ */
+static
+node_t *_search(chashtabs_t t, _Atomic(node_t*) *p, const void *x, uint64_t h,
+                void *cmp_arg, int r, _Atomic(node_t*) **link)
+{
+  node_t *n;
+  for ( ; (n = atomic_load_explicit(p, memory_order_acquire)) != NULL;
+        p = &n->next )
+    if ( n->hash == h && _eq(t, x, n->x, cmp_arg, r) ) break;
+  *link = p;
+  return n;
+}
+
+/*
+ * copy the chunks of the growth rs not yet claimed by another thread; returns
+ * the number copied
+ */
+static
+size_t _copy(resize_t *rs)
+{
+  size_t c, i, n, m = _primes[rs->from->cap_index], k = 0;
+  node_t *tmp, *nn;
+  _Atomic(node_t*) *p;
+  while ( (c = atomic_fetch_add(&rs->chunk, 1)) < rs->nchunks ) {
+    n = (c + 1) * CHUNK < m ? (c + 1) * CHUNK : m;
+    for ( i = c * CHUNK; i < n; i++ )
+      for ( tmp = atomic_load_explicit(&rs->from->A[i], memory_order_acquire);
+            tmp != NULL;
+            tmp = atomic_load_explicit(&tmp->next, memory_order_acquire) ) {
+        if ( (nn = (node_t*)malloc(sizeof(*nn))) == NULL )
+          error(1, errno, "malloc failure");
+        nn->x = tmp->x;
+        nn->hash = tmp->hash;
+        p = &rs->to->A[_reduce(tmp->hash, rs->to->cap_index)];
+        node_t *head = atomic_load_explicit(p, memory_order_relaxed);
+        do atomic_store_explicit(&nn->next, head, memory_order_relaxed);
+        while ( !atomic_compare_exchange_weak_explicit(p, &head, nn,
+                                                       memory_order_release,
+                                                       memory_order_relaxed) );
+      }
+    atomic_fetch_add_explicit(&rs->copied, 1, memory_order_release);
+    k++;
+  }
+  return k;
+}
+
+/* help the growth in progress, if any is left to do; caller is inside an epoch */
+static
+int _help(chashtabs_t t)
+{
+  resize_t *rs = atomic_load_explicit(&t->rs, memory_order_acquire);
+  return rs != NULL && _copy(rs) > 0;
+}
+
+static
+void _lock_all(chashtabs_t t)
+{
+  for ( int i = 0; i < NSTRIPES; i++ ) pthread_mutex_lock(&t->locks[i]);
+}
+
+static
+void _unlock_all(chashtabs_t t)
+{
+  for ( int i = NSTRIPES - 1; i >= 0; i-- ) pthread_mutex_unlock(&t->locks[i]);
+}
+
+/* move to the next prime length; writers are blocked for the duration */
+static
+void _grow(chashtabs_t t)
+{
+  int z = 0;
+  table_t *tab;
+  size_t cap_index, maxload = atomic_load_explicit(&t->maxload,
+                                                   memory_order_relaxed);
+  epochs_enter();
+  cap_index = atomic_load(&t->tab)->cap_index;
+  epochs_exit();
+  if ( maxload == 0 || cap_index + 1 >= NPRIMES ) return;
+  if ( atomic_load_explicit(&t->size, memory_order_relaxed)
+       <= maxload * _primes[cap_index] ) return;
+  if ( !atomic_compare_exchange_strong(&t->growing, &z, 1) ) return;
+  _lock_all(t);
+  /* another thread may have grown the table in the meantime */
+  tab = atomic_load(&t->tab);
+  if ( tab->cap_index + 1 >= NPRIMES
+       || atomic_load_explicit(&t->size, memory_order_relaxed)
+          <= maxload * _primes[tab->cap_index] ) {
+    _unlock_all(t);
+    atomic_store(&t->growing, 0);
+    return;
+  }
+  resize_t *rs;
+  if ( (rs = (resize_t*)malloc(sizeof(*rs))) == NULL )
+    error(1, errno, "malloc failure");
+  rs->from = tab;
+  rs->to = _table_new(tab->cap_index + 1);
+  rs->nchunks = (_primes[tab->cap_index] + CHUNK - 1) / CHUNK;
+  atomic_init(&rs->chunk, 0);
+  atomic_init(&rs->copied, 0);
+  atomic_store_explicit(&t->rs, rs, memory_order_release);
+  _copy(rs);
+  while ( atomic_load_explicit(&rs->copied, memory_order_acquire) < rs->nchunks )
+    sched_yield();
+  atomic_store_explicit(&t->tab, rs->to, memory_order_release);
+  atomic_store_explicit(&t->rs, NULL, memory_order_release);
+  _unlock_all(t);
+  atomic_store(&t->growing, 0);
+  epochs_retire(tab, _table_free);
+  epochs_retire(rs, free);
+}
+
+/* lock the stripe of hash h in the current table and return that table */
+static
+table_t *_lock(chashtabs_t t, uint64_t h, pthread_mutex_t **m)
+{
+  table_t *tab;
+  for ( ;; ) {
+    tab = atomic_load_explicit(&t->tab, memory_order_acquire);
+    *m = &t->locks[_reduce(h, tab->cap_index) % NSTRIPES];
+    while ( pthread_mutex_trylock(*m) != 0 )
+      if ( !_help(t) ) {
+        pthread_mutex_lock(*m);
+        break;
+      }
+    if ( atomic_load_explicit(&t->tab, memory_order_relaxed) == tab ) return tab;
+    pthread_mutex_unlock(*m);
+  }
+}
+
+static
+int _insert(chashtabs_t t, const void *x, uint64_t h, void *cmp_arg, int r)
+{
+  pthread_mutex_t *m;
+  _Atomic(node_t*) *p, *link;
+  node_t *n;
+  epochs_enter();
+  table_t *tab = _lock(t, h, &m);
+  p = &tab->A[_reduce(h, tab->cap_index)];
+  if ( _search(t, p, x, h, cmp_arg, r, &link) != NULL ) {
+    pthread_mutex_unlock(m);
+    epochs_exit();
+    return -1;
+  }
+  if ( (n = (node_t*)malloc(sizeof(*n))) == NULL )
+    error(1, errno, "malloc failure");
+  n->x = (void*)x;
+  n->hash = h;
+  atomic_init(&n->next, atomic_load_explicit(p, memory_order_relaxed));
+  atomic_store_explicit(p, n, memory_order_release);
+  atomic_fetch_add_explicit(&t->size, 1, memory_order_relaxed);
+  pthread_mutex_unlock(m);
+  epochs_exit();
+  _grow(t);
+  return 1;
+}
+
+int chashtabs_insert(chashtabs_t t, const void *x)
+{
+  return _insert(t, x, t->hash(x), NULL, 0);
+}
+
+int chashtabs_insert_r(chashtabs_t t, const void *x,
+                       const void *hash_arg, void *cmp_arg)
+{
+  return _insert(t, x, t->hash_r(x, hash_arg), cmp_arg, 1);
+}
+
+static
+void *_remove(chashtabs_t t, const void *_x, uint64_t h, void *cmp_arg, int r)
+{
+  pthread_mutex_t *m;
+  _Atomic(node_t*) *link;
+  node_t *n;
+  void *x = NULL;
+  epochs_enter();
+  table_t *tab = _lock(t, h, &m);
+  n = _search(t, &tab->A[_reduce(h, tab->cap_index)], _x, h, cmp_arg, r, &link);
+  if ( n != NULL ) {
+    x = n->x;
+    atomic_store_explicit(link,
+                          atomic_load_explicit(&n->next, memory_order_relaxed),
+                          memory_order_release);
+    atomic_fetch_sub_explicit(&t->size, 1, memory_order_relaxed);
+  }
+  pthread_mutex_unlock(m);
+  epochs_exit();
+  if ( n != NULL ) epochs_retire(n, free);
+  return x;
+}
+
+void *chashtabs_remove(chashtabs_t t, const void *x)
+{
+  return _remove(t, x, t->hash(x), NULL, 0);
+}
+
+void *chashtabs_remove_r(chashtabs_t t, const void *x,
+                         const void *hash_arg, void *cmp_arg)
+{
+  return _remove(t, x, t->hash_r(x, hash_arg), cmp_arg, 1);
+}
+
+static
+void *_find(chashtabs_t t, const void *x, uint64_t h, void *cmp_arg, int r)
+{
+  _Atomic(node_t*) *link;
+  node_t *n;
+  void *y;
+  epochs_enter();
+  table_t *tab = atomic_load_explicit(&t->tab, memory_order_acquire);
+  n = _search(t, &tab->A[_reduce(h, tab->cap_index)], x, h, cmp_arg, r, &link);
+  y = n == NULL ? NULL : n->x;
+  epochs_exit();
+  return y;
+}
+
+void *chashtabs_find(chashtabs_t t, const void *x)
+{
+  return _find(t, x, t->hash(x), NULL, 0);
+}
+
+void *chashtabs_find_r(chashtabs_t t, const void *x,
+                       const void *hash_arg, void *cmp_arg)
+{
+  return _find(t, x, t->hash_r(x, hash_arg), cmp_arg, 1);
+}
+
+static
+int _map(chashtabs_t t, int apply(void **x), int apply_r(void **x, void *y),
+         void *y)
+{
+  int ret = 1;
+  node_t *n;
+  if ( t == NULL ) return 1;
+  _lock_all(t);
+  table_t *tab = atomic_load_explicit(&t->tab, memory_order_relaxed);
+  for ( size_t i = 0; i < _primes[tab->cap_index] && ret > 0; i++ )
+    for ( n = atomic_load_explicit(&tab->A[i], memory_order_relaxed); n != NULL;
+          n = atomic_load_explicit(&n->next, memory_order_relaxed) )
+      if ( (apply != NULL ? apply(&n->x) : apply_r(&n->x, y)) < 0 ) {
+        ret = -1;
+        break;
+      }
+  _unlock_all(t);
+  return ret;
+}
+
+int chashtabs_map(chashtabs_t t, int apply(void **x))
+{
+  return _map(t, apply, NULL, NULL);
+}
+
+int chashtabs_map_r(chashtabs_t t, int apply(void **x, void *y), void *y)
+{
+  return _map(t, NULL, apply, y);
+}
+
+void chashtabs_free(chashtabs_t *t)
+{
+  if ( *t == NULL ) return;
+  _table_free(atomic_load(&(*t)->tab));
+  for ( int i = 0; i < NSTRIPES; i++ ) pthread_mutex_destroy(&(*t)->locks[i]);
+  free(*t);
+  *t = NULL;
+  epochs_synchronize();
+}
+
+size_t chashtabs_capacity(chashtabs_t t)
+{
+  size_t c;
+  epochs_enter();
+  c = _primes[atomic_load_explicit(&t->tab, memory_order_acquire)->cap_index];
+  epochs_exit();
+  return c;
+}
+
+size_t chashtabs_size(chashtabs_t t)
+{
+  return atomic_load_explicit(&t->size, memory_order_relaxed);
+}
+
+void chashtabs_setmaxload(chashtabs_t t, size_t maxload)
+{
+  atomic_store_explicit(&t->maxload, maxload, memory_order_relaxed);
+}
@@ -0,0 +1,246 @@
+/**
+ * @file concurrentqueues.c
+ * @brief Implementation of <tt>spscqueues_t</tt> and <tt>mpmcqueues_t</tt>
+ * classes.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <concurrentqueues.h>
+# include <stdatomic.h>
+# include <stdalign.h>
+# include <stdint.h>
+# define COUNTS_KIND COUNTERS_CONCURRENTQUEUES
+# include "allocs.h"
+
+/**
+ * @brief Bytes assumed per cache line when separating indices.
+ */
+# define CACHELINE 64
+
+static inline
+size_t _pow2(size_t n)
+{
+  size_t c = 2;
+  while ( c < n ) c <<= 1;
+  return c;
+}
+
+/*
+ * spscqueues_t
+ */
+
+/**
+ * @brief <tt>spscqueues_t</tt> class object.
+ *
+ * The producer owns <tt>tail</tt> and its copy of <tt>head</tt>, the consumer
+ * owns <tt>head</tt> and its copy of <tt>tail</tt>; each pair has a cache line
+ * of its own. The copies are refreshed from the shared indices only when the
+ * ring looks full, or empty, so most pushes and pops touch no line written by
+ * the other thread.
+ */
+struct spscqueues_t {
+  size_t size;                                ///< size of elements of queue
+  size_t mask;                                ///< capacity - 1
+  char *x;                                    ///< ring buffer
+  allocators_t al;                            ///< allocator of the queue
+  alignas(CACHELINE) atomic_size_t head; ///< next slot to be popped
+  size_t tail_cache;                     ///< consumer's copy of tail
+  alignas(CACHELINE) atomic_size_t tail; ///< next slot to be pushed
+  size_t head_cache;                     ///< producer's copy of head
+};
+
+/*
+ * the objects are over aligned: start them on a cache line, with the pointer
+ * returned by the allocator stored just before
+ */
+static
+void *_aligned(const allocators_t *al, size_t n)
+{
+  char *base = (char*)_amalloc(al, n + CACHELINE + sizeof(void*));
+  uintptr_t p = (uintptr_t)(base + sizeof(void*));
+  p = (p + CACHELINE - 1) & ~(uintptr_t)(CACHELINE - 1);
+  ((void**)p)[-1] = base;
+  return (void*)p;
+}
+
+static inline
+void _unaligned(const allocators_t *al, void *p)
+{
+  _afree(al, ((void**)p)[-1]);
+}
+
+spscqueues_t spscqueues_new(size_t size, size_t capacity)
+{
+  return spscqueues_new_alloc(size, capacity, &allocators_std);
+}
+
+spscqueues_t spscqueues_new_alloc(size_t size, size_t capacity,
+                                  const allocators_t *al)
+{
+  spscqueues_t q = (spscqueues_t)_aligned(al, sizeof(*q));
+  size_t c = _pow2(capacity);
+  q->al = *al;
+  q->size = size;
+  q->mask = c - 1;
+  q->x = (char*)_amalloc(al, c * size);
+  atomic_init(&q->head, 0);
+  atomic_init(&q->tail, 0);
+  q->head_cache = q->tail_cache = 0;
+  return q;
+}
+
+int spscqueues_push(spscqueues_t q, const void *x)
+{
+  size_t t = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  if ( t - q->head_cache > q->mask ) {
+    q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+    if ( t - q->head_cache > q->mask ) return -1;
+  }
+  memcpy(q->x + (t & q->mask) * q->size, x, q->size);
+  atomic_store_explicit(&q->tail, t + 1, memory_order_release);
+  return 1;
+}
+
+int spscqueues_pop(spscqueues_t q, void *x)
+{
+  size_t h = atomic_load_explicit(&q->head, memory_order_relaxed);
+  if ( h == q->tail_cache ) {
+    q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if ( h == q->tail_cache ) return -1;
+  }
+  memcpy(x, q->x + (h & q->mask) * q->size, q->size);
+  atomic_store_explicit(&q->head, h + 1, memory_order_release);
+  return 1;
+}
+
+size_t spscqueues_nmem(spscqueues_t q)
+{
+  size_t h = atomic_load_explicit(&q->head, memory_order_acquire);
+  return atomic_load_explicit(&q->tail, memory_order_acquire) - h;
+}
+
+size_t spscqueues_capacity(spscqueues_t q)
+{
+  return q->mask + 1;
+}
+
+void spscqueues_free(spscqueues_t *q)
+{
+  if ( q == NULL || *q == NULL ) return;
+  allocators_t al = (*q)->al;
+  _afree(&al, (*q)->x);
+  _unaligned(&al, *q);
+  *q = NULL;
+}
+
+/*
+ * mpmcqueues_t
+ */
+
+/**
+ * @brief <tt>mpmcqueues_t</tt> class object.
+ *
+ * Bounded queue of D. Vyukov. Each cell carries a sequence number telling
+ * whether it is free for the push of a given turn or full for its pop, so a
+ * thread claims a slot with one compare-and-swap of <tt>tail</tt>, or of
+ * <tt>head</tt>, and then copies its element without further synchronization.
+ */
+struct mpmcqueues_t {
+  size_t size;                           ///< size of elements of queue
+  size_t stride;                         ///< bytes per cell
+  size_t mask;                           ///< capacity - 1
+  char *x;                               ///< cells, sequence number first
+  allocators_t al;                       ///< allocator of the queue
+  alignas(CACHELINE) atomic_size_t head; ///< next turn to be popped
+  alignas(CACHELINE) atomic_size_t tail; ///< next turn to be pushed
+};
+
+static inline
+atomic_size_t *_seq(mpmcqueues_t q, size_t i)
+{
+  return (atomic_size_t*)(q->x + (i & q->mask) * q->stride);
+}
+
+mpmcqueues_t mpmcqueues_new(size_t size, size_t capacity)
+{
+  return mpmcqueues_new_alloc(size, capacity, &allocators_std);
+}
+
+mpmcqueues_t mpmcqueues_new_alloc(size_t size, size_t capacity,
+                                  const allocators_t *al)
+{
+  mpmcqueues_t q = (mpmcqueues_t)_aligned(al, sizeof(*q));
+  size_t c = _pow2(capacity), a = alignof(max_align_t);
+  q->al = *al;
+  q->size = size;
+  q->stride = (sizeof(atomic_size_t) + size + a - 1) / a * a;
+  q->mask = c - 1;
+  q->x = (char*)_amalloc(al, c * q->stride);
+  for ( size_t i = 0; i < c; i++ ) atomic_init(_seq(q, i), i);
+  atomic_init(&q->head, 0);
+  atomic_init(&q->tail, 0);
+  return q;
+}
+
+int mpmcqueues_push(mpmcqueues_t q, const void *x)
+{
+  atomic_size_t *s;
+  size_t t = atomic_load_explicit(&q->tail, memory_order_relaxed), seq;
+  for ( ;; ) {
+    s = _seq(q, t);
+    seq = atomic_load_explicit(s, memory_order_acquire);
+    if ( seq == t ) {
+      if ( atomic_compare_exchange_weak_explicit(&q->tail, &t, t + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed) )
+        break;
+    }
+    else if ( (ptrdiff_t)(seq - t) < 0 ) return -1;
+    else t = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  }
+  memcpy((char*)s + sizeof(atomic_size_t), x, q->size);
+  atomic_store_explicit(s, t + 1, memory_order_release);
+  return 1;
+}
+
+int mpmcqueues_pop(mpmcqueues_t q, void *x)
+{
+  atomic_size_t *s;
+  size_t h = atomic_load_explicit(&q->head, memory_order_relaxed), seq;
+  for ( ;; ) {
+    s = _seq(q, h);
+    seq = atomic_load_explicit(s, memory_order_acquire);
+    if ( seq == h + 1 ) {
+      if ( atomic_compare_exchange_weak_explicit(&q->head, &h, h + 1,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed) )
+        break;
+    }
+    else if ( (ptrdiff_t)(seq - (h + 1)) < 0 ) return -1;
+    else h = atomic_load_explicit(&q->head, memory_order_relaxed);
+  }
+  memcpy(x, (char*)s + sizeof(atomic_size_t), q->size);
+  atomic_store_explicit(s, h + q->mask + 1, memory_order_release);
+  return 1;
+}
+
+size_t mpmcqueues_nmem(mpmcqueues_t q)
+{
+  size_t h = atomic_load_explicit(&q->head, memory_order_acquire);
+  size_t t = atomic_load_explicit(&q->tail, memory_order_acquire);
+  return (ptrdiff_t)(t - h) < 0 ? 0 : t - h;
+}
+
+size_t mpmcqueues_capacity(mpmcqueues_t q)
+{
+  return q->mask + 1;
+}
+
+void mpmcqueues_free(mpmcqueues_t *q)
+{
+  if ( q == NULL || *q == NULL ) return;
+  allocators_t al = (*q)->al;
+  _afree(&al, (*q)->x);
+  _unaligned(&al, *q);
+  *q = NULL;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file concurrentstacks.c
+ * @brief Implementation of <tt>cstacks_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <concurrentstacks.h>
+# include <stdint.h>
+# include <stdatomic.h>
+# include <pthread.h>
+# include <errno.h>
+# include <error.h>
+# define COUNTS_KIND COUNTERS_CONCURRENTSTACKS
+# include "allocs.h"
+
+/**
+ * @brief Number of links of the first chunk, as a power of two.
+ */
+# define SHIFT 6
+
+/**
+ * @brief Number of chunks; chunk k holds <tt>2^(k + SHIFT)</tt> links.
+ */
+# define NCHUNKS (33 - SHIFT)
+
+/**
+ * @brief Link of a stack.
+ */
+typedef struct {
+  void *x;               ///< pointer to data object
+  _Atomic uint32_t next; ///< index of next link, 0 if last
+} node_t;
+
+/**
+ * @brief <tt>cstacks_t</tt> class object.
+ *
+ * Links are named by 32-bit indices into chunks which are only freed with the
+ * stack, so a link read by a thread can never have been returned to the
+ * allocator. Each list head packs a link index with a counter bumped by every
+ * successful compare-and-swap, so a head popped and pushed back in between
+ * does not compare equal to the one read (ABA).
+ */
+struct cstacks_t {
+  _Atomic uint64_t head;            ///< counter and index of top link
+  _Atomic uint64_t unused;          ///< counter and index of top free link
+  atomic_size_t size;               ///< number of elements in stack
+  _Atomic uint32_t fresh;           ///< links ever taken from the chunks
+  _Atomic(node_t*) chunks[NCHUNKS]; ///< link storage
+  pthread_mutex_t lock;             ///< guards allocation of chunks
+  allocators_t al;                  ///< allocator of the stack
+};
+
+static inline
+uint32_t _index(uint64_t h)
+{
+  return (uint32_t)h;
+}
+
+static inline
+uint64_t _tag(uint64_t h, uint32_t i)
+{
+  return ((h >> 32) + 1) << 32 | i;
+}
+
+/* chunk of link i > 0, and its offset in the chunk */
+static inline
+unsigned _chunk(uint32_t i, uint64_t *off)
+{
+  uint64_t j = (uint64_t)i + (1u << SHIFT) - 1;
+  unsigned k = 63 - __builtin_clzll(j) - SHIFT;
+  *off = j - ((uint64_t)1 << (k + SHIFT));
+  return k;
+}
+
+static inline
+node_t *_node(cstacks_t s, uint32_t i)
+{
+  uint64_t off;
+  unsigned k = _chunk(i, &off);
+  return atomic_load_explicit(&s->chunks[k], memory_order_acquire) + off;
+}
+
+cstacks_t cstacks_new(void)
+{
+  return cstacks_new_alloc(&allocators_std);
+}
+
+cstacks_t cstacks_new_alloc(const allocators_t *al)
+{
+  cstacks_t s;
+  s = (cstacks_t)_amalloc(al, sizeof(*s));
+  s->al = *al;
+  atomic_init(&s->head, 0);
+  atomic_init(&s->unused, 0);
+  atomic_init(&s->size, 0);
+  atomic_init(&s->fresh, 0);
+  for ( size_t k = 0; k < NCHUNKS; k++ ) atomic_init(&s->chunks[k], NULL);
+  pthread_mutex_init(&s->lock, NULL);
+  return s;
+}
+
+/* pop the top link of list *l, returning its index or 0 */
+static inline
+uint32_t _pop(cstacks_t s, _Atomic uint64_t *l)
+{
+  uint64_t h = atomic_load_explicit(l, memory_order_acquire);
+  uint32_t i;
+  do {
+    if ( (i = _index(h)) == 0 ) return 0;
+  } while ( !atomic_compare_exchange_weak_explicit(l, &h,
+              _tag(h, atomic_load_explicit(&_node(s, i)->next,
+                                            memory_order_relaxed)),
+              memory_order_acq_rel, memory_order_acquire) );
+  return i;
+}
+
+static inline
+void _push(cstacks_t s, _Atomic uint64_t *l, uint32_t i)
+{
+  node_t *n = _node(s, i);
+  uint64_t h = atomic_load_explicit(l, memory_order_relaxed);
+  do atomic_store_explicit(&n->next, _index(h), memory_order_relaxed);
+  while ( !atomic_compare_exchange_weak_explicit(l, &h, _tag(h, i),
+                                                 memory_order_release,
+                                                 memory_order_relaxed) );
+}
+
+/* a free link, from the free list or else from the chunks */
+static
+uint32_t _link(cstacks_t s)
+{
+  uint32_t i = _pop(s, &s->unused);
+  if ( i != 0 ) return i;
+  i = atomic_fetch_add_explicit(&s->fresh, 1, memory_order_relaxed) + 1;
+  if ( i == 0 ) error(1, ENOMEM, "cstacks_t links exhausted");
+  uint64_t off;
+  unsigned k = _chunk(i, &off);
+  if ( atomic_load_explicit(&s->chunks[k], memory_order_acquire) == NULL ) {
+    pthread_mutex_lock(&s->lock);
+    if ( atomic_load_explicit(&s->chunks[k], memory_order_relaxed) == NULL )
+      atomic_store_explicit(&s->chunks[k],
+                            (node_t*)_amalloc(&s->al, sizeof(node_t)
+                                              << (k + SHIFT)),
+                            memory_order_release);
+    pthread_mutex_unlock(&s->lock);
+  }
+  return i;
+}
+
+void cstacks_push(cstacks_t s, void *x)
+{
+  uint32_t i = _link(s);
+  _node(s, i)->x = x;
+  atomic_fetch_add_explicit(&s->size, 1, memory_order_relaxed);
+  _push(s, &s->head, i);
+}
+
+void *cstacks_pop(cstacks_t s)
+{
+  uint32_t i = _pop(s, &s->head);
+  if ( i == 0 ) return NULL;
+  void *x = _node(s, i)->x;
+  atomic_fetch_sub_explicit(&s->size, 1, memory_order_relaxed);
+  _push(s, &s->unused, i);
+  return x;
+}
+
+int cstacks_empty(cstacks_t s)
+{
+  return _index(atomic_load(&s->head)) == 0;
+}
+
+size_t cstacks_size(cstacks_t s)
+{
+  return atomic_load_explicit(&s->size, memory_order_relaxed);
+}
+
+void cstacks_free(cstacks_t *s)
+{
+  if ( s == NULL || *s == NULL ) return;
+  allocators_t al = (*s)->al;
+  for ( size_t k = 0; k < NCHUNKS; k++ )
+    _afree(&al, atomic_load(&(*s)->chunks[k]));
+  pthread_mutex_destroy(&(*s)->lock);
+  _afree(&al, *s);
+  *s = NULL;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file counters.c
+ * @brief Implementation of the operation counters.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <counters.h>
+# include <string.h>
+# include "counts.h"
+
+/**
+ * @brief Names of the kinds of containers, as printed by
+ * <tt>counters_report</tt>.
+ */
+static const char *const names[COUNTERS_KINDS] = {
+  "arrays", "bitmatrices", "btrees", "columns", "concurrentqueues",
+  "concurrentstacks", "deephashtabs", "deepqueues", "deepstacks", "deques",
+  "eytzingers", "flathashtabs", "hashtabs", "heaps", "pools", "queues",
+  "roarings", "skiplists", "stacks", "unrolledstacks", "wsdeques", "other"
+};
+
+# if ENABLE_COUNTERS
+counters_t _counts[COUNTERS_KINDS];
+
+static counters_hook hook;
+
+static void *hook_arg;
+
+void _counts_max(size_t *p, size_t n)
+{
+  size_t m = __atomic_load_n(p, __ATOMIC_RELAXED);
+  while ( n > m && !__atomic_compare_exchange_n(p, &m, n, 1, __ATOMIC_RELAXED,
+                                                __ATOMIC_RELAXED) );
+}
+
+void _counts_event(counters_kind_t kind, counters_event_t e, size_t from,
+                   size_t to)
+{
+  __atomic_fetch_add(&_counts[kind].resizes, 1, __ATOMIC_RELAXED);
+  counters_hook h = __atomic_load_n(&hook, __ATOMIC_ACQUIRE);
+  if ( h != NULL ) h(kind, e, from, to, __atomic_load_n(&hook_arg,
+                                                        __ATOMIC_RELAXED));
+}
+# endif
+
+int counters_enabled(void)
+{
+# if ENABLE_COUNTERS
+  return 1;
+# else
+  return -1;
+# endif
+}
+
+void counters_get(counters_kind_t kind, counters_t *c)
+{
+# if ENABLE_COUNTERS
+  c->mallocs = __atomic_load_n(&_counts[kind].mallocs, __ATOMIC_RELAXED);
+  c->frees = __atomic_load_n(&_counts[kind].frees, __ATOMIC_RELAXED);
+  c->cmps = __atomic_load_n(&_counts[kind].cmps, __ATOMIC_RELAXED);
+  c->hashes = __atomic_load_n(&_counts[kind].hashes, __ATOMIC_RELAXED);
+  c->resizes = __atomic_load_n(&_counts[kind].resizes, __ATOMIC_RELAXED);
+  c->max_chain = __atomic_load_n(&_counts[kind].max_chain, __ATOMIC_RELAXED);
+# else
+  (void)kind;
+  memset(c, 0, sizeof(*c));
+# endif
+}
+
+void counters_reset(void)
+{
+# if ENABLE_COUNTERS
+  for ( size_t i = 0; i < COUNTERS_KINDS; i++ ) {
+    __atomic_store_n(&_counts[i].mallocs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_counts[i].frees, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_counts[i].cmps, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_counts[i].hashes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_counts[i].resizes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_counts[i].max_chain, 0, __ATOMIC_RELAXED);
+  }
+# endif
+}
+
+void counters_report(FILE *f)
+{
+  counters_t c;
+  fprintf(f, "%-18s %12s %12s %12s %12s %10s %10s\n", "container", "mallocs",
+          "frees", "cmps", "hashes", "resizes", "max chain");
+  for ( size_t i = 0; i < COUNTERS_KINDS; i++ ) {
+    counters_get((counters_kind_t)i, &c);
+    if ( (c.mallocs | c.frees | c.cmps | c.hashes | c.resizes | c.max_chain)
+         == 0 )
+      continue;
+    fprintf(f, "%-18s %12zu %12zu %12zu %12zu %10zu %10zu\n", names[i],
+            c.mallocs, c.frees, c.cmps, c.hashes, c.resizes, c.max_chain);
+  }
+}
+
+void counters_sethook(counters_hook h, void *arg)
+{
+# if ENABLE_COUNTERS
+  __atomic_store_n(&hook_arg, arg, __ATOMIC_RELAXED);
+  __atomic_store_n(&hook, h, __ATOMIC_RELEASE);
+# else
+  (void)h;
+  (void)arg;
+# endif
+}
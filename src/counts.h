@@ -0,0 +1,75 @@
+/**
+ * @file counts.h
+ * @brief Increments of the operation counters of <tt>counters.h</tt>.
+ *
+ * A translation unit defines <tt>COUNTS_KIND</tt> to the kind of its container
+ * before including this header, or <tt>allocs.h</tt>, whose allocations are
+ * then counted under that kind. Containers keeping counts of their own, such
+ * as the statistics of the hash tables, go through <tt>COUNTS_OBJ</tt> and
+ * <tt>COUNTS_PTR</tt>. Every macro expands to nothing unless the library is
+ * configured with <tt>--enable-counters</tt>.
+ *
+ * This header is private to the library.
+ * @author Thomas Pender
+ */
+# ifndef INCLUDED_COUNTS_H
+# define INCLUDED_COUNTS_H
+
+# include <counters.h>
+
+/**
+ * @brief Kind of container counted by the translation unit.
+ */
+# ifndef COUNTS_KIND
+#  define COUNTS_KIND COUNTERS_OTHER
+# endif
+
+# if ENABLE_COUNTERS
+extern counters_t _counts[COUNTERS_KINDS];
+extern void _counts_max(size_t *p, size_t n);
+extern void _counts_event(counters_kind_t kind, counters_event_t e, size_t from,
+                          size_t to);
+
+/**
+ * @brief Evaluate <tt>x</tt> only if operation counters are enabled.
+ */
+#  define COUNTS(x) (x)
+
+/**
+ * @brief Add <tt>n</tt> to count <tt>f</tt> of the translation unit.
+ */
+#  define COUNTS_ADD(f, n) \
+  ((void)__atomic_fetch_add(&_counts[COUNTS_KIND].f, (n), __ATOMIC_RELAXED))
+
+/**
+ * @brief Add <tt>n</tt> to count <tt>f</tt> of object <tt>o</tt>, a member the
+ * object declares only if operation counters are enabled.
+ */
+#  define COUNTS_OBJ(o, f, n) ((void)((o)->f += (n)))
+
+/**
+ * @brief Pointer to count <tt>f</tt> of object <tt>o</tt>, <tt>NULL</tt> if
+ * operation counters are disabled.
+ */
+#  define COUNTS_PTR(o, f) (&(o)->f)
+
+/**
+ * @brief Raise the longest chain of the translation unit to <tt>n</tt>.
+ */
+#  define COUNTS_CHAIN(n) _counts_max(&_counts[COUNTS_KIND].max_chain, (n))
+
+/**
+ * @brief Count a resize or rehash from capacity <tt>from</tt> to <tt>to</tt>
+ * and call the hook.
+ */
+#  define COUNTS_EVENT(e, from, to) _counts_event(COUNTS_KIND, (e), (from), (to))
+# else
+#  define COUNTS(x) ((void)0)
+#  define COUNTS_ADD(f, n) ((void)0)
+#  define COUNTS_OBJ(o, f, n) ((void)0)
+#  define COUNTS_PTR(o, f) ((size_t*)NULL)
+#  define COUNTS_CHAIN(n) ((void)0)
+#  define COUNTS_EVENT(e, from, to) ((void)0)
+# endif
+
+# endif
@@ -0,0 +1,436 @@
+/**
+ * @file cowhashtabs.c
+ * @brief Implementation of <tt>cowhashtabs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <cowhashtabs.h>
+# include <stdatomic.h>
+# include <string.h>
+# include "allocs.h"
+# include "primes.h"
+# include "epochs.h"
+
+/**
+ * @brief Buckets of a chunk, the unit copied on write.
+ */
+# define CHUNK 64
+
+/**
+ * @brief Link of a hash table bucket, owned by its chunk.
+ *
+ * Buckets are ordered by hash value, and data with equal hash values by the
+ * user provided compare function, as in <tt>hashtabs_t</tt>.
+ */
+typedef struct node_t {
+  void *x;             ///< pointer to data
+  uint64_t hash;       ///< hash value of data
+  struct node_t *next; ///< next link of bucket
+} node_t;
+
+/**
+ * @brief Buckets shared by the versions counted in <tt>refs</tt>.
+ *
+ * A chunk counted once is only reachable from the writer's version, and is
+ * changed in place; a chunk counted more than once never changes.
+ */
+typedef struct {
+  atomic_size_t refs;  ///< number of versions holding the chunk
+  node_t *b[CHUNK];    ///< buckets
+} chunk_t;
+
+/**
+ * @brief Version of a hash table, shared by the holders counted in
+ * <tt>refs</tt>: the writer, the publication and the readers.
+ *
+ * A version counted once is only held by the writer, and is changed in place;
+ * a version counted more than once never changes. Chunks of empty buckets are
+ * <tt>NULL</tt>.
+ */
+struct cowhashtabs_snap_t {
+  atomic_size_t refs;      ///< number of holders of the version
+  size_t size;             ///< number of elements
+  size_t cap_index;        ///< index to prime array corr. to prime length
+  size_t nchunks;          ///< number of chunks
+  cowhashtabs_t t;         ///< hash table of the version
+  chunk_t *c[];            ///< chunks
+};
+
+typedef struct cowhashtabs_snap_t version_t;
+
+/**
+ * @brief <tt>cowhashtabs_t</tt> class object.
+ */
+struct cowhashtabs_t {
+  cowhashtabs_data_cmp cmp;     ///< user defined compare function
+  cowhashtabs_data_cmp_r cmp_r; ///< user defined reentrant compare function
+  cowhashtabs_hash hash;        ///< user defined hashing function
+  cowhashtabs_hash_r hash_r;    ///< user defined reentrant hashing function
+  size_t maxload;               ///< elements per bucket triggering growth
+  version_t *w;                 ///< version of the writer
+  _Atomic(version_t*) pub;      ///< published version, if any
+  allocators_t al;              ///< allocator of the hash table
+};
+
+static inline
+int _cmp(cowhashtabs_t t, const void *x, const void *y, void *queue_arg, int r)
+{
+  return r ? t->cmp_r(x, y, queue_arg) : t->cmp(x, y);
+}
+
+static inline
+uint64_t _hash(cowhashtabs_t t, const void *x, const void *hash_arg, int r)
+{
+  return r ? t->hash_r(x, hash_arg) : t->hash(x);
+}
+
+static
+chunk_t *_chunk_new(cowhashtabs_t t)
+{
+  chunk_t *c = (chunk_t*)_amalloc(&t->al, sizeof(chunk_t));
+  atomic_init(&c->refs, 1);
+  memset(c->b, 0, sizeof(c->b));
+  return c;
+}
+
+static
+void _chunk_unref(cowhashtabs_t t, chunk_t *c)
+{
+  node_t *n, *next;
+  if ( c == NULL ) return;
+  if ( atomic_fetch_sub_explicit(&c->refs, 1, memory_order_acq_rel) != 1 )
+    return;
+  for ( size_t i = 0; i < CHUNK; i++ )
+    for ( n = c->b[i]; n != NULL; n = next ) {
+      next = n->next;
+      _afree(&t->al, n);
+    }
+  _afree(&t->al, c);
+}
+
+/* a chunk of the writer's own, with copies of the links of c */
+static
+chunk_t *_chunk_copy(cowhashtabs_t t, const chunk_t *c)
+{
+  chunk_t *d = _chunk_new(t);
+  for ( size_t i = 0; i < CHUNK; i++ ) {
+    node_t **p = &d->b[i];
+    for ( const node_t *n = c->b[i]; n != NULL; n = n->next ) {
+      *p = (node_t*)_amalloc(&t->al, sizeof(node_t));
+      (*p)->x = n->x;
+      (*p)->hash = n->hash;
+      p = &(*p)->next;
+    }
+    *p = NULL;
+  }
+  return d;
+}
+
+static
+version_t *_version_new(cowhashtabs_t t, size_t cap_index)
+{
+  size_t nchunks = (_primes[cap_index] + CHUNK - 1) / CHUNK;
+  version_t *v = (version_t*)_amalloc(&t->al, sizeof(version_t)
+                                      + nchunks * sizeof(chunk_t*));
+  atomic_init(&v->refs, 1);
+  v->size = 0;
+  v->cap_index = cap_index;
+  v->nchunks = nchunks;
+  v->t = t;
+  memset(v->c, 0, nchunks * sizeof(chunk_t*));
+  return v;
+}
+
+static
+void _version_unref(version_t *v)
+{
+  if ( atomic_fetch_sub_explicit(&v->refs, 1, memory_order_acq_rel) != 1 )
+    return;
+  for ( size_t i = 0; i < v->nchunks; i++ ) _chunk_unref(v->t, v->c[i]);
+  _afree(&v->t->al, v);
+}
+
+/* destructor of the publication of a version, run after an epoch */
+static
+void _version_retire(void *v)
+{
+  _version_unref((version_t*)v);
+}
+
+cowhashtabs_t cowhashtabs_new(cowhashtabs_data_cmp cmp,
+                              cowhashtabs_data_cmp_r cmp_r,
+                              cowhashtabs_hash hash, cowhashtabs_hash_r hash_r,
+                              size_t n)
+{
+  return cowhashtabs_new_alloc(cmp, cmp_r, hash, hash_r, n, &allocators_std);
+}
+
+cowhashtabs_t cowhashtabs_new_alloc(cowhashtabs_data_cmp cmp,
+                                    cowhashtabs_data_cmp_r cmp_r,
+                                    cowhashtabs_hash hash,
+                                    cowhashtabs_hash_r hash_r,
+                                    size_t n, const allocators_t *al)
+{
+  cowhashtabs_t t;
+  t = (cowhashtabs_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
+  t->cmp = cmp;
+  t->cmp_r = cmp_r;
+  t->hash = hash;
+  t->hash_r = hash_r;
+  t->maxload = COWHASHTABS_MAXLOAD;
+  t->w = _version_new(t, _get_cap_index(n));
+  atomic_init(&t->pub, NULL);
+  return t;
+}
+
+/* bucket of hash value h in version v, NULL if its chunk is empty */
+static inline
+node_t **_bucket(const version_t *v, uint64_t h)
+{
+  size_t i = _reduce(h, v->cap_index);
+  chunk_t *c = v->c[i / CHUNK];
+  return c == NULL ? NULL : &c->b[i % CHUNK];
+}
+
+/*
+ * link of bucket p at which data x of hash h sits or would be inserted; *found
+ * tells which
+ */
+static
+node_t **_search(cowhashtabs_t t, node_t **p, const void *x, uint64_t h,
+                 void *queue_arg, int r, int *found)
+{
+  int c;
+  *found = 0;
+  for ( ; *p != NULL && (*p)->hash < h; p = &(*p)->next );
+  for ( ; *p != NULL && (*p)->hash == h; p = &(*p)->next )
+    if ( (c = _cmp(t, x, (*p)->x, queue_arg, r)) <= 0 ) {
+      *found = c == 0;
+      break;
+    }
+  return p;
+}
+
+static
+void *_find(const version_t *v, const void *x, uint64_t h, void *queue_arg,
+            int r)
+{
+  node_t **p = _bucket(v, h);
+  int found;
+  if ( p == NULL ) return NULL;
+  p = _search(v->t, p, x, h, queue_arg, r, &found);
+  return found ? (*p)->x : NULL;
+}
+
+/* the writer's version, copied first if it is shared */
+static
+version_t *_own_version(cowhashtabs_t t)
+{
+  version_t *v = t->w, *n;
+  if ( atomic_load_explicit(&v->refs, memory_order_acquire) == 1 ) return v;
+  n = _version_new(t, v->cap_index);
+  n->size = v->size;
+  for ( size_t i = 0; i < v->nchunks; i++ )
+    if ( (n->c[i] = v->c[i]) != NULL )
+      atomic_fetch_add_explicit(&n->c[i]->refs, 1, memory_order_relaxed);
+  _version_unref(v);
+  return t->w = n;
+}
+
+/* bucket of hash value h in the writer's own copy of its chunk */
+static
+node_t **_own_bucket(cowhashtabs_t t, uint64_t h)
+{
+  version_t *v = _own_version(t);
+  size_t i = _reduce(h, v->cap_index);
+  chunk_t **c = &v->c[i / CHUNK];
+  if ( *c == NULL ) *c = _chunk_new(t);
+  else if ( atomic_load_explicit(&(*c)->refs, memory_order_acquire) > 1 ) {
+    chunk_t *d = _chunk_copy(t, *c);
+    _chunk_unref(t, *c);
+    *c = d;
+  }
+  return &(*c)->b[i % CHUNK];
+}
+
+/* move the writer to a version of the next prime length */
+static
+void _grow(cowhashtabs_t t)
+{
+  version_t *v = t->w, *n;
+  if ( t->maxload == 0 || v->cap_index + 1 >= NPRIMES ) return;
+  if ( v->size <= t->maxload * _primes[v->cap_index] ) return;
+  n = _version_new(t, v->cap_index + 1);
+  n->size = v->size;
+  for ( size_t i = 0; i < v->nchunks; i++ ) {
+    if ( v->c[i] == NULL ) continue;
+    for ( size_t j = 0; j < CHUNK; j++ )
+      for ( node_t *m = v->c[i]->b[j]; m != NULL; m = m->next ) {
+        size_t k = _reduce(m->hash, n->cap_index);
+        chunk_t **c = &n->c[k / CHUNK];
+        if ( *c == NULL ) *c = _chunk_new(t);
+        node_t **p = &(*c)->b[k % CHUNK], *l;
+        /* equal hashes come from one old bucket, already in order */
+        for ( ; *p != NULL && (*p)->hash <= m->hash; p = &(*p)->next );
+        l = (node_t*)_amalloc(&t->al, sizeof(node_t));
+        l->x = m->x;
+        l->hash = m->hash;
+        l->next = *p;
+        *p = l;
+      }
+  }
+  _version_unref(v);
+  t->w = n;
+}
+
+static
+void _insert(cowhashtabs_t t, const void *x, uint64_t h, void *queue_arg,
+             int r)
+{
+  node_t **p, *n;
+  int found;
+  if ( _find(t->w, x, h, queue_arg, r) != NULL ) return;
+  p = _search(t, _own_bucket(t, h), x, h, queue_arg, r, &found);
+  n = (node_t*)_amalloc(&t->al, sizeof(node_t));
+  n->x = (void*)x;
+  n->hash = h;
+  n->next = *p;
+  *p = n;
+  t->w->size++;
+  _grow(t);
+}
+
+void cowhashtabs_insert(cowhashtabs_t t, const void *x)
+{
+  _insert(t, x, _hash(t, x, NULL, 0), NULL, 0);
+}
+
+void cowhashtabs_insert_r(cowhashtabs_t t, const void *x, const void *hash_arg,
+                          void *queue_arg)
+{
+  _insert(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1);
+}
+
+static
+void *_remove(cowhashtabs_t t, const void *x, uint64_t h, void *queue_arg,
+              int r)
+{
+  node_t **p, *n;
+  int found;
+  void *y;
+  if ( _find(t->w, x, h, queue_arg, r) == NULL ) return NULL;
+  p = _search(t, _own_bucket(t, h), x, h, queue_arg, r, &found);
+  n = *p;
+  y = n->x;
+  *p = n->next;
+  _afree(&t->al, n);
+  t->w->size--;
+  return y;
+}
+
+void *cowhashtabs_remove(cowhashtabs_t t, const void *x)
+{
+  return _remove(t, x, _hash(t, x, NULL, 0), NULL, 0);
+}
+
+void *cowhashtabs_remove_r(cowhashtabs_t t, const void *x,
+                           const void *hash_arg, void *queue_arg)
+{
+  return _remove(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1);
+}
+
+void *cowhashtabs_find(cowhashtabs_t t, const void *x)
+{
+  return _find(t->w, x, _hash(t, x, NULL, 0), NULL, 0);
+}
+
+void *cowhashtabs_find_r(cowhashtabs_t t, const void *x, const void *hash_arg,
+                         void *queue_arg)
+{
+  return _find(t->w, x, _hash(t, x, hash_arg, 1), queue_arg, 1);
+}
+
+size_t cowhashtabs_size(cowhashtabs_t t)
+{
+  return t->w->size;
+}
+
+void cowhashtabs_publish(cowhashtabs_t t)
+{
+  version_t *old;
+  atomic_fetch_add_explicit(&t->w->refs, 1, memory_order_relaxed);
+  old = atomic_exchange_explicit(&t->pub, t->w, memory_order_acq_rel);
+  /* readers may still be counting themselves into the old publication */
+  if ( old != NULL ) epochs_retire(old, _version_retire);
+}
+
+cowhashtabs_snap_t cowhashtabs_acquire(cowhashtabs_t t)
+{
+  version_t *v;
+  epochs_enter();
+  if ( (v = atomic_load_explicit(&t->pub, memory_order_acquire)) != NULL )
+    atomic_fetch_add_explicit(&v->refs, 1, memory_order_relaxed);
+  epochs_exit();
+  return v;
+}
+
+void cowhashtabs_release(cowhashtabs_snap_t *s)
+{
+  if ( *s == NULL ) return;
+  _version_unref(*s);
+  *s = NULL;
+}
+
+void *cowhashtabs_snap_find(cowhashtabs_snap_t s, const void *x)
+{
+  return _find(s, x, _hash(s->t, x, NULL, 0), NULL, 0);
+}
+
+void *cowhashtabs_snap_find_r(cowhashtabs_snap_t s, const void *x,
+                              const void *hash_arg, void *queue_arg)
+{
+  return _find(s, x, _hash(s->t, x, hash_arg, 1), queue_arg, 1);
+}
+
+static
+int _snap_map(cowhashtabs_snap_t s, int apply(void*), int apply_r(void*, void*),
+              void *y)
+{
+  for ( size_t i = 0; i < s->nchunks; i++ ) {
+    if ( s->c[i] == NULL ) continue;
+    for ( size_t j = 0; j < CHUNK; j++ )
+      for ( node_t *n = s->c[i]->b[j]; n != NULL; n = n->next )
+        if ( (apply != NULL ? apply(n->x) : apply_r(n->x, y)) < 0 ) return -1;
+  }
+  return 1;
+}
+
+int cowhashtabs_snap_map(cowhashtabs_snap_t s, int apply(void *x))
+{
+  return _snap_map(s, apply, NULL, NULL);
+}
+
+int cowhashtabs_snap_map_r(cowhashtabs_snap_t s, int apply(void *x, void *y),
+                           void *y)
+{
+  return _snap_map(s, NULL, apply, y);
+}
+
+size_t cowhashtabs_snap_size(cowhashtabs_snap_t s)
+{
+  return s->size;
+}
+
+void cowhashtabs_free(cowhashtabs_t *t)
+{
+  version_t *v;
+  if ( *t == NULL ) return;
+  allocators_t al = (*t)->al;
+  if ( (v = atomic_exchange(&(*t)->pub, NULL)) != NULL ) _version_unref(v);
+  /* retired publications still name the table */
+  epochs_synchronize();
+  _version_unref((*t)->w);
+  _afree(&al, *t);
+  *t = NULL;
+}
@@ -6,17 +6,59 @@
 # include <config.h>
 # include <deephashtabs.h>
 # include <deepqueues.h>
+# include <hashes.h>
+# include <string.h>
+# define COUNTS_KIND COUNTERS_DEEPHASHTABS
+# include "allocs.h"
+# include "primes.h"
+# include "sweeps.h"
 
-# define NPRIMES 45
+/**
+ * @brief First bytes written by <tt>dhashtabs_write</tt>.
+ */
+# define MAGIC "CDHASHT"
 
-static volatile
-size_t _primes[] = {
-  11, 17, 29, 43, 67, 101, 151, 227, 347, 521, 787, 1181, 1777, 2671, 4007,
-  6011, 9029, 13553, 20333, 30509, 45763, 68659, 103001, 154501, 231779, 347671,
-  521519, 782297, 1173463, 1760203, 2640317, 3960497, 5940761, 8911141, 13366711,
-  20050081, 30075127, 45112693, 67669079, 101503627, 152255461, 228383273,
-  342574909, 513862367, 770793589, SIZE_MAX,
-};
+/**
+ * @brief Header written by <tt>dhashtabs_write</tt>.
+ */
+typedef struct {
+  char magic[8];   ///< <tt>MAGIC</tt>
+  uint64_t size;   ///< total size of data objects
+  uint64_t ksize;  ///< size of keys in map mode, 0 otherwise
+  uint64_t nmems;  ///< number of data objects
+} header_t;
+
+/**
+ * @brief Stream written by <tt>_write</tt>.
+ */
+typedef struct {
+  FILE *f;         ///< stream being written to
+  size_t size;     ///< total size of data objects
+} stream_t;
+
+/**
+ * @brief Copies of data held inline by a bucket before it spills.
+ */
+# define SMALL 2
+
+/**
+ * @brief Marks the last slot of a bucket spilt into a deep queue.
+ */
+# define SPILT ((void*)&_spilt_mark)
+
+static const char _spilt_mark;
+
+/**
+ * @brief Bucket of a hash table.
+ *
+ * Most buckets hold one or two elements, whose copies are kept in the slots of
+ * the bucket; unused slots are <tt>NULL</tt>. A bucket overflowing moves its
+ * copies into a <tt>dqueues_t</tt> held in the first slot, the last slot then
+ * being <tt>SPILT</tt>.
+ */
+typedef struct {
+  void *x[SMALL]; ///< copies of data, or queue of a spilt bucket
+} bucket_t;
 
 /**
  * @brief Structure for rehashing hash table.
@@ -39,17 +81,16 @@ struct dhashtabs_t {
   dhashtabs_data_cmp_r cmp_r; ///< user defined reentrant compare function
   dhashtabs_hash hash;        ///< user defined hashing function
   dhashtabs_hash_r hash_r;    ///< user defined reentrant hashing function
-  dqueues_t *A;               ///< bucket array
+  size_t ksize;               ///< size of keys in map mode, 0 otherwise
+  char *rec;                  ///< scratch record in map mode
+  allocators_t al;            ///< allocator of the hash table
+  bucket_t *A;                ///< bucket array
+# if ENABLE_COUNTERS
+  size_t inserts;             ///< number of inserts
+  size_t finds;               ///< number of finds and removes
+# endif
 };
 
-static inline
-size_t _get_cap_index(size_t n)
-{
-  size_t i;
-  for ( i = 0; i < NPRIMES && n >= _primes[i]; i++ );
-  return i;
-}
-
 uint64_t dhashtabs_stdhash(const void *_a, const void *_n)
 {
   size_t n = *(size_t*)_n;
@@ -68,9 +109,18 @@ uint64_t dhashtabs_stdhash(const void *_a, const void *_n)
 dhashtabs_t dhashtabs_new(dhashtabs_data_cmp cmp, dhashtabs_data_cmp_r cmp_r,
                         dhashtabs_hash hash, dhashtabs_hash_r hash_r,
                         size_t n, size_t size)
+{
+  return dhashtabs_new_alloc(cmp, cmp_r, hash, hash_r, n, size, &allocators_std);
+}
+
+dhashtabs_t dhashtabs_new_alloc(dhashtabs_data_cmp cmp,
+                                dhashtabs_data_cmp_r cmp_r,
+                                dhashtabs_hash hash, dhashtabs_hash_r hash_r,
+                                size_t n, size_t size, const allocators_t *al)
 {
   dhashtabs_t t;
-  t = (dhashtabs_t)malloc(sizeof(*t));
+  t = (dhashtabs_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
   t->cap_index = _get_cap_index(n);
   t->size = size;
   t->nmems = 0;
@@ -79,78 +129,291 @@ dhashtabs_t dhashtabs_new(dhashtabs_data_cmp cmp, dhashtabs_data_cmp_r cmp_r,
   t->cmp_r = cmp_r;
   t->hash = hash;
   t->hash_r = hash_r;
-  t->A = (dqueues_t*)calloc(_primes[t->cap_index], sizeof(dqueues_t));
+  t->ksize = 0;
+  t->rec = NULL;
+  t->A = (bucket_t*)_acalloc(al, _primes[t->cap_index], sizeof(bucket_t));
+# if ENABLE_COUNTERS
+  t->inserts = t->finds = 0;
+# endif
   return t;
 }
 
-void dhashtabs_insert(dhashtabs_t t, const void *x)
+static inline
+uint64_t _hash(dhashtabs_t t, const void *x, const void *hash_arg, int r)
 {
-  uint64_t val = t->hash(x) % _primes[t->cap_index];
-  if ( t->A[val] == NULL ) {
-    t->load++;
-    t->A[val] = dqueues_new(t->cmp, t->cmp_r, t->size);
-  }
-  dqueues_enqueu(t->A[val], x);
-  t->size++;
+  COUNTS_ADD(hashes, 1);
+  return r ? t->hash_r(x, hash_arg) : t->hash(x);
 }
 
-void dhashtabs_insert_r(dhashtabs_t t, const void *x,
-                       const void *hash_arg, void *dqueues_arg)
+static inline
+int _spilt(const bucket_t *b)
+{
+  return b->x[SMALL - 1] == SPILT;
+}
+
+static inline
+int _cmp(dhashtabs_t t, const void *x, const void *y, void *arg, int r)
+{
+  COUNTS_ADD(cmps, 1);
+  return r ? t->cmp_r(x, y, arg) : t->cmp(x, y);
+}
+
+/* number of elements of bucket b */
+static inline
+size_t _count(const bucket_t *b)
+{
+  size_t k = 0;
+  if ( _spilt(b) ) return dqueues_size((dqueues_t)b->x[0]);
+  while ( k < SMALL && b->x[k] != NULL ) k++;
+  return k;
+}
+
+static
+void *_bfind(dhashtabs_t t, bucket_t *b, const void *x, void *arg, int r)
+{
+  if ( _spilt(b) )
+    return r ? dqueues_find_r((dqueues_t)b->x[0], x, arg)
+      : dqueues_find((dqueues_t)b->x[0], x);
+  for ( size_t k = 0; k < SMALL && b->x[k] != NULL; k++ )
+    if ( _cmp(t, x, b->x[k], arg, r) == 0 ) return b->x[k];
+  return NULL;
+}
+
+static inline
+int _adopt(dqueues_t q, void *x, void *arg, int r)
 {
-  uint64_t val = t->hash_r(x, hash_arg) % _primes[t->cap_index];
-  if ( t->A[val] == NULL ) {
-    t->load++;
-    t->A[val] = dqueues_new(t->cmp, t->cmp_r, t->size);
+  return r ? dqueues_enqueu_adopt_r(q, x, arg) : dqueues_enqueu_adopt(q, x);
+}
+
+/* moves the records of a full bucket into a new deep queue */
+static
+void _spill(dhashtabs_t t, bucket_t *b, void *arg, int r)
+{
+  dqueues_t q = dqueues_new_alloc(t->cmp, t->cmp_r, t->size, &t->al);
+  for ( size_t k = 0; k < SMALL; k++ ) (void)_adopt(q, b->x[k], arg, r);
+  b->x[0] = q;
+  b->x[SMALL - 1] = SPILT;
+}
+
+/*
+ * Inserts x into bucket b, a copy of x unless adopt is set, x then being a
+ * record itself, unless equal data is there. Returns the data in the bucket, or
+ * NULL if a record is not adopted, *added telling whether x was inserted.
+ */
+static
+void *_binsert(dhashtabs_t t, bucket_t *b, const void *x, void *arg, int r,
+               int adopt, int *added)
+{
+  size_t k;
+  dqueues_t q;
+  *added = 0;
+  if ( !_spilt(b) ) {
+    for ( k = 0; k < SMALL && b->x[k] != NULL; k++ )
+      if ( _cmp(t, x, b->x[k], arg, r) == 0 ) return adopt ? NULL : b->x[k];
+    if ( k < SMALL ) {
+      *added = 1;
+      return b->x[k] = adopt ? (void*)x
+        : memcpy(_amalloc(&t->al, RECORD(t->size)), x, t->size);
+    }
+    _spill(t, b, arg, r);
   }
-  dqueues_enqueu_r(t->A[val], x, dqueues_arg);
-  t->size++;
+  q = (dqueues_t)b->x[0];
+  if ( adopt ) {
+    *added = _adopt(q, (void*)x, arg, r) > 0;
+    return *added ? (void*)x : NULL;
+  }
+  return r ? dqueues_find_or_enqueu_r(q, x, arg, added)
+    : dqueues_find_or_enqueu(q, x, added);
 }
 
-void *dhashtabs_remove(dhashtabs_t t, const void *_x)
+static
+void *_bremove(dhashtabs_t t, bucket_t *b, const void *x, void *arg, int r)
 {
-  void *x;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (x = dqueues_remove(t->A[i], _x)) != NULL ) {
-      t->size--;
-      if ( dqueues_size(t->A[i]) == 0 ) t->load--;
-      return x;
+  void *y;
+  if ( _spilt(b) )
+    return r ? dqueues_remove_r((dqueues_t)b->x[0], x, arg)
+      : dqueues_remove((dqueues_t)b->x[0], x);
+  for ( size_t k = 0; k < SMALL && b->x[k] != NULL; k++ )
+    if ( _cmp(t, x, b->x[k], arg, r) == 0 ) {
+      y = b->x[k];
+      for ( ; k + 1 < SMALL; k++ ) b->x[k] = b->x[k + 1];
+      b->x[SMALL - 1] = NULL;
+      return y;
     }
   return NULL;
 }
 
-void *dhashtabs_remove_r(dhashtabs_t t, const void *_x, void *queue_arg)
+/*
+ * Inserts x into the table as _binsert, returning the data in the table; sets
+ * *inserted, if inserted is not NULL, to whether x was inserted.
+ */
+static
+void *_insert(dhashtabs_t t, const void *x, uint64_t h, void *arg, int r,
+              int adopt, int *inserted)
+{
+  bucket_t *b = &t->A[_reduce(h, t->cap_index)];
+  int empty = _count(b) == 0, added;
+  void *y;
+  COUNTS_OBJ(t, inserts, 1);
+  y = _binsert(t, b, x, arg, r, adopt, &added);
+  if ( added ) {
+    t->nmems++;
+    if ( empty ) t->load++;
+  }
+  if ( inserted != NULL ) *inserted = added;
+  return y;
+}
+
+static
+void *_remove(dhashtabs_t t, const void *_x, uint64_t h, void *arg, int r)
 {
   void *x;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (x = dqueues_remove_r(t->A[i], _x, queue_arg)) != NULL ) {
-      t->size--;
-      if ( dqueues_size(t->A[i]) == 0 ) t->load--;
-      return x;
+  bucket_t *b = &t->A[_reduce(h, t->cap_index)];
+  COUNTS_OBJ(t, finds, 1);
+  if ( (x = _bremove(t, b, _x, arg, r)) != NULL ) {
+    t->nmems--;
+    if ( _count(b) == 0 ) t->load--;
+  }
+  return x;
+}
+
+void dhashtabs_insert(dhashtabs_t t, const void *x)
+{
+  (void)_insert(t, x, _hash(t, x, NULL, 0), NULL, 0, 0, NULL);
+}
+
+void dhashtabs_insert_r(dhashtabs_t t, const void *x,
+                       const void *hash_arg, void *dqueues_arg)
+{
+  (void)_insert(t, x, _hash(t, x, hash_arg, 1), dqueues_arg, 1, 0, NULL);
+}
+
+int dhashtabs_insert_adopt(dhashtabs_t t, void *x)
+{
+  int added;
+  (void)_insert(t, x, _hash(t, x, NULL, 0), NULL, 0, 1, &added);
+  return added ? 1 : -1;
+}
+
+int dhashtabs_insert_adopt_r(dhashtabs_t t, void *x, const void *hash_arg,
+                             void *queue_arg)
+{
+  int added;
+  (void)_insert(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1, 1, &added);
+  return added ? 1 : -1;
+}
+
+void *dhashtabs_find_or_insert(dhashtabs_t t, const void *x, int *inserted)
+{
+  return _insert(t, x, _hash(t, x, NULL, 0), NULL, 0, 0, inserted);
+}
+
+void *dhashtabs_find_or_insert_r(dhashtabs_t t, const void *x,
+                                 const void *hash_arg, void *queue_arg,
+                                 int *inserted)
+{
+  return _insert(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1, 0, inserted);
+}
+
+void *dhashtabs_remove(dhashtabs_t t, const void *_x)
+{
+  return _remove(t, _x, _hash(t, _x, NULL, 0), NULL, 0);
+}
+
+void *dhashtabs_remove_r(dhashtabs_t t, const void *_x,
+                         const void *hash_arg, void *queue_arg)
+{
+  return _remove(t, _x, _hash(t, _x, hash_arg, 1), queue_arg, 1);
+}
+
+/* free every record of bucket b passing the sweep */
+static
+size_t _bremove_if(dhashtabs_t t, bucket_t *b, const sweeps_t *s)
+{
+  size_t j = 0, k;
+  if ( _spilt(b) )
+    return s->pred != NULL
+      ? dqueues_remove_if((dqueues_t)b->x[0], s->pred, s->dispose)
+      : dqueues_remove_if_r((dqueues_t)b->x[0], s->pred_r, s->dispose_r, s->y);
+  for ( k = 0; k < SMALL && b->x[k] != NULL; k++ ) {
+    if ( !_sweep_test(s, b->x[k]) ) {
+      b->x[j++] = b->x[k];
+      continue;
     }
-  return NULL;
+    _sweep_dispose(s, b->x[k]);
+    _afree(&t->al, b->x[k]);
+  }
+  for ( size_t i = j; i < k; i++ ) b->x[i] = NULL;
+  return k - j;
+}
+
+static
+size_t _remove_if(dhashtabs_t t, const sweeps_t *s)
+{
+  size_t k = 0, n;
+  if ( t == NULL ) return 0;
+  for ( size_t i = 0; i < _primes[t->cap_index]; i++ ) {
+    bucket_t *b = &t->A[i];
+    if ( b->x[0] == NULL || (n = _bremove_if(t, b, s)) == 0 ) continue;
+    k += n;
+    if ( _count(b) == 0 ) t->load--;
+  }
+  t->nmems -= k;
+  return k;
+}
+
+size_t dhashtabs_remove_if(dhashtabs_t t, int pred(const void *x),
+                           void dispose(void *x))
+{
+  sweeps_t s = { pred, NULL, dispose, NULL, NULL };
+  return _remove_if(t, &s);
+}
+
+size_t dhashtabs_remove_if_r(dhashtabs_t t, int pred(const void *x, void *y),
+                             void dispose(void *x, void *y), void *y)
+{
+  sweeps_t s = { NULL, pred, NULL, dispose, y };
+  return _remove_if(t, &s);
 }
 
 void *dhashtabs_find(dhashtabs_t t, const void *x)
 {
-  void *ptr;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (ptr = dqueues_find(t->A[i], x)) != NULL ) return ptr;
-  return NULL;
+  COUNTS_OBJ(t, finds, 1);
+  uint64_t val = _reduce(_hash(t, x, NULL, 0), t->cap_index);
+  return _bfind(t, &t->A[val], x, NULL, 0);
 }
 
-void *dhashtabs_find_r(dhashtabs_t t, const void *x, void *queue_arg)
+void *dhashtabs_find_r(dhashtabs_t t, const void *x,
+                       const void *hash_arg, void *queue_arg)
 {
-  void *ptr;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (ptr = dqueues_find_r(t->A[i], x, queue_arg)) != NULL ) return ptr;
-  return NULL;
+  COUNTS_OBJ(t, finds, 1);
+  uint64_t val = _reduce(_hash(t, x, hash_arg, 1), t->cap_index);
+  return _bfind(t, &t->A[val], x, queue_arg, 1);
+}
+
+static
+int _bmap(bucket_t *b, int apply(void **x))
+{
+  if ( _spilt(b) ) return dqueues_map((dqueues_t)b->x[0], apply);
+  for ( size_t k = 0; k < SMALL && b->x[k] != NULL; k++ )
+    if ( apply(&b->x[k]) < 0 ) return -1;
+  return 1;
+}
+
+static
+int _bmap_r(bucket_t *b, int apply(void **x, void *y), void *y)
+{
+  if ( _spilt(b) ) return dqueues_map_r((dqueues_t)b->x[0], apply, y);
+  for ( size_t k = 0; k < SMALL && b->x[k] != NULL; k++ )
+    if ( apply(&b->x[k], y) < 0 ) return -1;
+  return 1;
 }
 
 int dhashtabs_map(dhashtabs_t t, int apply(void **x))
 {
   if ( t == NULL ) return 1;
   for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( dqueues_map(t->A[i], apply) < 0 ) return -1;
+    if ( _bmap(&t->A[i], apply) < 0 ) return -1;
   return 1;
 }
 
@@ -159,20 +422,123 @@ int dhashtabs_map_r(dhashtabs_t t,
 {
   if ( t == NULL ) return 1;
   for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( dqueues_map_r(t->A[i], apply, queue_arg) < 0 ) return -1;
+    if ( _bmap_r(&t->A[i], apply, queue_arg) < 0 ) return -1;
   return 1;
 }
 
+/* cursor at first element of the first nonempty bucket from i on */
+static
+int _scan(dhashtabs_iter_t *it, size_t i)
+{
+  dhashtabs_t t = it->t;
+  for ( ; i < it->end; i++ ) {
+    bucket_t *b = &t->A[i];
+    it->bucket = i;
+    it->slot = SMALL;
+    if ( _spilt(b) ) {
+      if ( dqueues_iterinit((dqueues_t)b->x[0], &it->q) > 0 ) return 1;
+    }
+    else if ( b->x[0] != NULL ) {
+      it->slot = 0;
+      it->q.x = b->x[0];
+      return 1;
+    }
+  }
+  it->bucket = i;
+  return -1;
+}
+
+int dhashtabs_iterinit(dhashtabs_t t, dhashtabs_iter_t *it)
+{
+  return dhashtabs_iterrange(t, it, 0, _primes[t->cap_index]);
+}
+
+int dhashtabs_iterrange(dhashtabs_t t, dhashtabs_iter_t *it, size_t lo,
+                        size_t hi)
+{
+  it->t = t;
+  it->end = hi;
+  return _scan(it, lo);
+}
+
+int dhashtabs_iternext(dhashtabs_iter_t *it)
+{
+  bucket_t *b = &it->t->A[it->bucket];
+  if ( it->slot == SMALL ) {
+    if ( dqueues_iternext(&it->q) > 0 ) return 1;
+  }
+  else if ( ++it->slot < SMALL && b->x[it->slot] != NULL ) {
+    it->q.x = b->x[it->slot];
+    return 1;
+  }
+  return _scan(it, it->bucket + 1);
+}
+
 void dhashtabs_free(dhashtabs_t *t)
 {
   if ( *t == NULL ) return;
-  for ( size_t i = 0; i < _primes[(*t)->cap_index]; i++ )
-    dqueues_free((dqueues_t*)(&((*t)->A[i])));
-  free((dqueues_t*)(*t)->A);
-  free(*t);
+  allocators_t al = (*t)->al;
+  for ( size_t i = 0; i < _primes[(*t)->cap_index]; i++ ) {
+    bucket_t *b = &(*t)->A[i];
+    if ( _spilt(b) ) dqueues_free((dqueues_t*)&b->x[0]);
+    else for ( size_t k = 0; k < SMALL; k++ ) _afree(&al, b->x[k]);
+  }
+  _afree(&al, (*t)->A);
+  _afree(&al, (*t)->rec);
+  _afree(&al, *t);
   *t = NULL;
 }
 
+static
+int _write(void **x, void *_y)
+{
+  stream_t *y = (stream_t*)_y;
+  return fwrite(*x, y->size, 1, y->f) == 1 ? 1 : -1;
+}
+
+int dhashtabs_write(dhashtabs_t t, FILE *f)
+{
+  header_t h = { MAGIC, t->size, t->ksize, t->nmems };
+  stream_t y = { f, t->size };
+  if ( fwrite(&h, sizeof(h), 1, f) != 1 ) return -1;
+  return dhashtabs_map_r(t, _write, &y);
+}
+
+static
+int _read(dhashtabs_t t, FILE *f, const void *hash_arg, void *queue_arg, int r)
+{
+  header_t h;
+  if ( fread(&h, sizeof(h), 1, f) != 1 ) return -1;
+  if ( memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.size != t->size
+       || h.ksize != t->ksize ) {
+    errno = EINVAL;
+    return -1;
+  }
+  char *x = (char*)_amalloc(&t->al, t->size);
+  for ( uint64_t i = 0; i < h.nmems; i++ ) {
+    if ( fread(x, t->size, 1, f) != 1 ) {
+      _afree(&t->al, x);
+      return -1;
+    }
+    if ( t->ksize != 0 ) dhashtabs_put(t, x, x + t->ksize);
+    else if ( r ) dhashtabs_insert_r(t, x, hash_arg, queue_arg);
+    else dhashtabs_insert(t, x);
+  }
+  _afree(&t->al, x);
+  return 1;
+}
+
+int dhashtabs_read(dhashtabs_t t, FILE *f)
+{
+  return _read(t, f, NULL, NULL, 0);
+}
+
+int dhashtabs_read_r(dhashtabs_t t, FILE *f,
+                     const void *hash_arg, void *queue_arg)
+{
+  return _read(t, f, hash_arg, queue_arg, 1);
+}
+
 size_t dhashtabs_capacity(dhashtabs_t t)
 {
   return _primes[t->cap_index];
@@ -182,19 +548,26 @@ static
 int _rehash(void **x, void *_y)
 {
   rehash_t *y = (rehash_t*)_y;
-  dhashtabs_insert(y->t, *x);
+  if ( y->t->ksize != 0 )
+    dhashtabs_put(y->t, *x, (char*)*x + y->t->ksize);
+  else dhashtabs_insert(y->t, *x);
   return 1;
 }
 
 dhashtabs_t dhashtabs_rehash(dhashtabs_t t)
 {
   rehash_t rehash = {
-    .t = dhashtabs_new(t->cmp, t->cmp_r, t->hash, t->hash_r,
-                       _primes[t->cap_index], t->size),
+    .t = t->ksize != 0
+    ? dhashtabs_new_map_alloc(t->hash, _primes[t->cap_index], t->ksize,
+                              t->size - t->ksize, &t->al)
+    : dhashtabs_new_alloc(t->cmp, t->cmp_r, t->hash, t->hash_r,
+                          _primes[t->cap_index], t->size, &t->al),
     .hash_arg = NULL, .queue_arg = NULL,
   };
   for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    (void)dqueues_map_r(t->A[i], _rehash, &rehash);
+    (void)_bmap_r(&t->A[i], _rehash, &rehash);
+  COUNTS_EVENT(COUNTERS_REHASH, _primes[t->cap_index],
+               _primes[rehash.t->cap_index]);
   return rehash.t;
 }
 
@@ -202,28 +575,189 @@ static
 int _rehash_r(void **x, void *_y)
 {
   rehash_t *y = (rehash_t*)_y;
-  dhashtabs_insert_r(y->t, *x, y->hash_arg, y->queue_arg);
+  if ( y->t->ksize != 0 )
+    dhashtabs_put(y->t, *x, (char*)*x + y->t->ksize);
+  else dhashtabs_insert_r(y->t, *x, y->hash_arg, y->queue_arg);
   return 1;
 }
 
 dhashtabs_t dhashtabs_rehash_r(dhashtabs_t t, void *hash_arg, void *queue_arg)
 {
   rehash_t rehash = {
-    .t = dhashtabs_new(t->cmp, t->cmp_r, t->hash, t->hash_r,
-                       _primes[t->cap_index], t->size),
+    .t = t->ksize != 0
+    ? dhashtabs_new_map_alloc(t->hash, _primes[t->cap_index], t->ksize,
+                              t->size - t->ksize, &t->al)
+    : dhashtabs_new_alloc(t->cmp, t->cmp_r, t->hash, t->hash_r,
+                          _primes[t->cap_index], t->size, &t->al),
     .hash_arg = hash_arg, .queue_arg = queue_arg
   };
   for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    (void)dqueues_map_r(t->A[i], _rehash_r, &rehash);
+    (void)_bmap_r(&t->A[i], _rehash_r, &rehash);
+  COUNTS_EVENT(COUNTERS_REHASH, _primes[t->cap_index],
+               _primes[rehash.t->cap_index]);
   return rehash.t;
 }
 
 size_t dhashtabs_size(dhashtabs_t t)
 {
-  return t->size;
+  return t->nmems;
 }
 
 size_t dhashtabs_loadfactor(dhashtabs_t t)
 {
-  return t->load == 0 ? 0 : t->size / t->load;
+  return t->load == 0 ? 0 : t->nmems / t->load;
+}
+
+void dhashtabs_stats(dhashtabs_t t, dhashtabs_stats_t *s)
+{
+  size_t k;
+  memset(s, 0, sizeof(*s));
+  s->buckets = _primes[t->cap_index];
+  s->bytes = sizeof(*t) + s->buckets * sizeof(bucket_t);
+  for ( size_t i = 0; i < s->buckets; i++ ) {
+    k = _count(&t->A[i]);
+    s->histogram[k < DHASHTABS_HISTOGRAM ? k : DHASHTABS_HISTOGRAM - 1]++;
+    if ( k == 0 ) s->empty++;
+    if ( k > s->max_chain ) s->max_chain = k;
+    if ( _spilt(&t->A[i]) ) s->bytes += dqueues_bytes((dqueues_t)t->A[i].x[0]);
+    else s->bytes += k * RECORD(t->size);
+  }
+  if ( s->buckets > s->empty )
+    s->mean_chain = (double)t->nmems / (double)(s->buckets - s->empty);
+# if ENABLE_COUNTERS
+  s->inserts = t->inserts;
+  s->finds = t->finds;
+# endif
+}
+
+/* keys are compared as integers when they fit one, else bytewise */
+static
+int _keycmp(const void *a, const void *b, void *_t)
+{
+  dhashtabs_t t = (dhashtabs_t)_t;
+  int c;
+  switch ( t->ksize ) {
+  case 4: {
+    uint32_t x, y;
+    memcpy(&x, a, 4);
+    memcpy(&y, b, 4);
+    return (x > y) - (x < y);
+  }
+  case 8: {
+    uint64_t x, y;
+    memcpy(&x, a, 8);
+    memcpy(&y, b, 8);
+    return (x > y) - (x < y);
+  }
+  default:
+    c = memcmp(a, b, t->ksize);
+    return (c > 0) - (c < 0);
+  }
+}
+
+static inline
+uint64_t _keyhash(dhashtabs_t t, const void *k)
+{
+  COUNTS_ADD(hashes, 1);
+  return t->hash != NULL ? t->hash(k) : hashes_bytes(k, t->ksize, 0);
+}
+
+dhashtabs_t dhashtabs_new_map(dhashtabs_hash hash, size_t n,
+                              size_t ksize, size_t vsize)
+{
+  return dhashtabs_new_map_alloc(hash, n, ksize, vsize, &allocators_std);
+}
+
+dhashtabs_t dhashtabs_new_map_alloc(dhashtabs_hash hash, size_t n,
+                                    size_t ksize, size_t vsize,
+                                    const allocators_t *al)
+{
+  dhashtabs_t t = dhashtabs_new_alloc(NULL, _keycmp, hash, NULL, n,
+                                      ksize + vsize, al);
+  t->ksize = ksize;
+  t->rec = (char*)_amalloc(&t->al, t->size);
+  return t;
+}
+
+void dhashtabs_put(dhashtabs_t t, const void *k, const void *v)
+{
+  char *x;
+  int added;
+  bucket_t *b = &t->A[_reduce(_keyhash(t, k), t->cap_index)];
+  int empty = _count(b) == 0;
+  COUNTS_OBJ(t, inserts, 1);
+  memcpy(t->rec, k, t->ksize);
+  memcpy(t->rec + t->ksize, v, t->size - t->ksize);
+  x = (char*)_binsert(t, b, t->rec, t, 1, 0, &added);
+  if ( !added ) {
+    memcpy(x + t->ksize, v, t->size - t->ksize);
+    return;
+  }
+  t->nmems++;
+  if ( empty ) t->load++;
+}
+
+void *dhashtabs_get(dhashtabs_t t, const void *k)
+{
+  char *x;
+  uint64_t val = _reduce(_keyhash(t, k), t->cap_index);
+  COUNTS_OBJ(t, finds, 1);
+  if ( (x = (char*)_bfind(t, &t->A[val], k, t, 1)) == NULL ) return NULL;
+  return x + t->ksize;
+}
+
+void *dhashtabs_del(dhashtabs_t t, const void *k)
+{
+  return _remove(t, k, _keyhash(t, k), t, 1);
+}
+
+/**
+ * @brief Data objects being frozen, gathered by <tt>_gather</tt>.
+ */
+typedef struct {
+  dhashtabs_t t;        ///< hash table being frozen
+  const void *hash_arg; ///< argument to user defined reentrant hashing function
+  int r;                ///< hash with the reentrant hashing function
+  char *x;              ///< copies of data objects
+  uint64_t *h;          ///< hash values of data objects
+  size_t k;             ///< number of data objects gathered
+} freeze_t;
+
+static
+int _gather(void **x, void *_y)
+{
+  freeze_t *y = (freeze_t*)_y;
+  dhashtabs_t t = y->t;
+  memcpy(y->x + y->k * t->size, *x, t->size);
+  y->h[y->k++] = t->ksize != 0 ? _keyhash(t, *x)
+                                : _hash(t, *x, y->hash_arg, y->r);
+  return 1;
+}
+
+static
+fhashtabs_t _freeze(dhashtabs_t t, const void *hash_arg, int r)
+{
+  freeze_t y = { t, hash_arg, r, NULL, NULL, 0 };
+  fhashtabs_t f;
+  y.x = (char*)_amalloc(&t->al, t->nmems * t->size + 1);
+  y.h = (uint64_t*)_amalloc(&t->al, (t->nmems + 1) * sizeof(uint64_t));
+  (void)dhashtabs_map_r(t, _gather, &y);
+  if ( t->ksize != 0 )
+    f = fhashtabs_new_map_alloc(t->hash, y.x, y.h, y.k, t->ksize,
+                                t->size - t->ksize, &t->al);
+  else f = fhashtabs_new_alloc(t->cmp, t->cmp_r, t->hash, t->hash_r, y.x, y.h,
+                               y.k, t->size, &t->al);
+  _afree(&t->al, y.x);
+  _afree(&t->al, y.h);
+  return f;
+}
+
+fhashtabs_t dhashtabs_freeze(dhashtabs_t t)
+{
+  return _freeze(t, NULL, 0);
+}
+
+fhashtabs_t dhashtabs_freeze_r(dhashtabs_t t, const void *hash_arg)
+{
+  return _freeze(t, hash_arg, 1);
 }
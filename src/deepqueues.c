@@ -5,179 +5,208 @@
  */
 # include <config.h>
 # include <deepqueues.h>
+# define COUNTS_KIND COUNTERS_DEEPQUEUES
+# include "allocs.h"
+# include "sweeps.h"
 
 /**
  * @brief Internal structure for <tt>dqueues_t</tt> object.
  */
 struct dqueues_node_t {
-  char *x;                     ///< pointer to data object
   struct dqueues_node_t *prev; ///< pointer to previous element of queue
   struct dqueues_node_t *next; ///< pointer to next element of queue
 };
 typedef struct dqueues_node_t dqueues_node_t;
 
+_Static_assert(sizeof(dqueues_node_t) == 2 * sizeof(void*),
+               "the links of a queue fit the room left by a record");
+
+/*
+ * A data object and its links share one allocation, the data object first so
+ * that pointers handed back to the user may be passed to free. The links follow
+ * at offset off, the data size rounded up to pointer alignment.
+ */
+
 /**
  * @brief <tt>dqueues_t</tt> class object.
  */
 struct dqueues_t {
   size_t size;              ///< total size of elements of queue
   size_t nmems;             ///< number of elements of queue
+  size_t off;               ///< offset of links within an allocation
   dqueues_data_cmp cmp;     ///< user provided compare function
   dqueues_data_cmp_r cmp_r; ///< user provided reentrant compare function
   dqueues_node_t *head;     ///< pointer to head of queue
   dqueues_node_t *tail;     ///< pointer to tail of queue
+  allocators_t al;          ///< allocator of the queue
 };
 
+static inline
+char *_data(dqueues_t q, dqueues_node_t *node)
+{
+  return (char*)node - q->off;
+}
+
+static inline
+int _cmp(dqueues_t q, const void *x, const void *y, void *arg, int r)
+{
+  COUNTS_ADD(cmps, 1);
+  return r ? q->cmp_r(x, y, arg) : q->cmp(x, y);
+}
+
+/* links of record x, already holding its data */
+static inline
+dqueues_node_t *_link(dqueues_t q, const void *x)
+{
+  return (dqueues_node_t*)((char*)x + q->off);
+}
+
+static inline
+dqueues_node_t *_node(dqueues_t q, const void *x)
+{
+  char *p = (char*)_amalloc(&q->al, RECORD(q->size));
+  memcpy(p, x, q->size);
+  return _link(q, p);
+}
+
 dqueues_t dqueues_new(dqueues_data_cmp cmp, dqueues_data_cmp_r cmp_r, size_t size)
+{
+  return dqueues_new_alloc(cmp, cmp_r, size, &allocators_std);
+}
+
+dqueues_t dqueues_new_alloc(dqueues_data_cmp cmp, dqueues_data_cmp_r cmp_r,
+                            size_t size, const allocators_t *al)
 {
   if ( cmp == NULL && cmp_r == NULL ) error(1, errno, "cmp pointers null");
   dqueues_t q;
-  q = (dqueues_t)malloc(sizeof(*q));
+  q = (dqueues_t)_amalloc(al, sizeof(*q));
+  q->al = *al;
   q->cmp = cmp;
   q->cmp_r = cmp_r;
   q->size = size;
+  q->off = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
   q->nmems = 0;
   q->head = NULL;
   q->tail = NULL;
   return q;
 }
 
-void dqueues_enqueu(dqueues_t q, const void *x)
+/*
+ * Links the record of x into the queue in order, a copy of x unless adopt is
+ * set, x then being a record itself, unless equal data is in the queue. Returns
+ * the data in the queue, *added telling whether it was linked.
+ */
+static inline
+void *_enqueu(dqueues_t q, const void *x, void *y, int r, int adopt, int *added)
 {
+  dqueues_node_t *new, *tmp;
+
+  *added = 1;
+
   /* queue is empty */
   if ( q->head == NULL ) {
-    q->head = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-    q->head->x = (char*)malloc(q->size);
-    memcpy(q->head->x, x, q->size);
+    q->head = adopt ? _link(q, x) : _node(q, x);
     q->head->prev = NULL;
     q->head->next = NULL;
     q->tail = q->head;
     q->nmems = 1;
-    return;
+    return _data(q, q->head);
   }
 
   /* check tail */
-  switch ( q->cmp(x, q->tail->x) ) {
-  case 0: return;
-  case 1: {
-    dqueues_node_t *new = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-    new->x = (char*)malloc(q->size);
-    memcpy(new->x, x, q->size);
+  switch ( _cmp(q, x, _data(q, q->tail), y, r) ) {
+  case 0:
+    *added = 0;
+    return _data(q, q->tail);
+  case 1:
+    new = adopt ? _link(q, x) : _node(q, x);
     new->next = NULL;
     new->prev = q->tail;
     q->tail->next = new;
     q->tail = new;
     q->nmems++;
-    return;
-  }
+    return _data(q, new);
   }
 
   /* check head */
-  switch ( q->cmp(x, q->head->x) ) {
-  case -1: {
-    dqueues_node_t *new = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-    new->x = (char*)malloc(q->size);
-    memcpy(new->x, x, q->size);
+  switch ( _cmp(q, x, _data(q, q->head), y, r) ) {
+  case -1:
+    new = adopt ? _link(q, x) : _node(q, x);
     new->prev = NULL;
     new->next = q->head;
     q->head->prev = new;
     q->head = new;
     q->nmems++;
-    return;
-  }
-  case 0: return;
+    return _data(q, new);
+  case 0:
+    *added = 0;
+    return _data(q, q->head);
   }
 
   /* check body */
-  dqueues_node_t *tmp = q->head;
+  tmp = q->head;
   while ( tmp->next != NULL ) {
-    switch ( q->cmp(x, tmp->next->x) ) {
-    case -1: {
-      dqueues_node_t *new = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-      new->x = (char*)malloc(q->size);
-      memcpy(new->x, x, q->size);
+    switch ( _cmp(q, x, _data(q, tmp->next), y, r) ) {
+    case -1:
+      new = adopt ? _link(q, x) : _node(q, x);
       new->prev = tmp;
       new->next = tmp->next;
       tmp->next->prev = new;
       tmp->next = new;
       q->nmems++;
-      return;
-    }
-    case 0: return;
+      return _data(q, new);
+    case 0:
+      *added = 0;
+      return _data(q, tmp->next);
     case 1: tmp = tmp->next; break;
     }
   }
 
-  return;
+  *added = 0;
+  return NULL;
+}
+
+void dqueues_enqueu(dqueues_t q, const void *x)
+{
+  int added;
+  (void)_enqueu(q, x, NULL, 0, 0, &added);
 }
 
 void dqueues_enqueu_r(dqueues_t q, const void *x, void *y)
 {
-  /* queue is empty */
-  if ( q->head == NULL ) {
-    q->head = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-    q->head->x = (char*)malloc(q->size);
-    memcpy(q->head->x, x, q->size);
-    q->head->prev = NULL;
-    q->head->next = NULL;
-    q->tail = q->head;
-    q->nmems = 1;
-    return;
-  }
+  int added;
+  (void)_enqueu(q, x, y, 1, 0, &added);
+}
 
-  /* check tail */
-  switch ( q->cmp_r(x, q->tail->x, y) ) {
-  case 0: return;
-  case 1: {
-    dqueues_node_t *new = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-    new->x = (char*)malloc(q->size);
-    memcpy(new->x, x, q->size);
-    new->next = NULL;
-    new->prev = q->tail;
-    q->tail->next = new;
-    q->tail = new;
-    q->nmems++;
-    return;
-  }
-  }
+int dqueues_enqueu_adopt(dqueues_t q, void *x)
+{
+  int added;
+  (void)_enqueu(q, x, NULL, 0, 1, &added);
+  return added ? 1 : -1;
+}
 
-  /* check head */
-  switch ( q->cmp_r(x, q->head->x, y) ) {
-  case -1: {
-    dqueues_node_t *new = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-    new->x = (char*)malloc(q->size);
-    memcpy(new->x, x, q->size);
-    new->prev = NULL;
-    new->next = q->head;
-    q->head->prev = new;
-    q->head = new;
-    q->nmems++;
-    return;
-  }
-  case 0: return;
-  }
+int dqueues_enqueu_adopt_r(dqueues_t q, void *x, void *y)
+{
+  int added;
+  (void)_enqueu(q, x, y, 1, 1, &added);
+  return added ? 1 : -1;
+}
 
-  /* check body */
-  dqueues_node_t *tmp = q->head;
-  while ( tmp->next != NULL ) {
-    switch ( q->cmp_r(x, tmp->next->x, y) ) {
-    case -1: {
-      dqueues_node_t *new = (dqueues_node_t*)malloc(sizeof(dqueues_node_t));
-      new->x = (char*)malloc(q->size);
-      memcpy(new->x, x, q->size);
-      new->prev = tmp;
-      new->next = tmp->next;
-      tmp->next->prev = new;
-      tmp->next = new;
-      q->nmems++;
-      return;
-    }
-    case 0: return;
-    case 1: tmp = tmp->next; break;
-    }
-  }
+void *dqueues_find_or_enqueu(dqueues_t q, const void *x, int *inserted)
+{
+  int added;
+  void *z = _enqueu(q, x, NULL, 0, 0, &added);
+  if ( inserted != NULL ) *inserted = added;
+  return z;
+}
 
-  return;
+void *dqueues_find_or_enqueu_r(dqueues_t q, const void *x, void *y,
+                               int *inserted)
+{
+  int added;
+  void *z = _enqueu(q, x, y, 1, 0, &added);
+  if ( inserted != NULL ) *inserted = added;
+  return z;
 }
 
 void *dqueues_dequeue_front(dqueues_t q)
@@ -185,9 +214,8 @@ void *dqueues_dequeue_front(dqueues_t q)
   if ( q->head == NULL ) return NULL;
   if ( q->head->next == NULL ) q->tail = NULL;
   dqueues_node_t *tmp = q->head;
-  char *x = tmp->x;
+  char *x = _data(q, tmp);
   q->head = q->head->next;
-  free(tmp);
   if ( q->head != NULL ) q->head->prev = NULL;
   q->nmems--;
   return x;
@@ -198,9 +226,8 @@ void *dqueues_dequeue_back(dqueues_t q)
   if ( q->tail == NULL ) return NULL;
   if ( q->tail->prev == NULL ) q->head = NULL;
   dqueues_node_t *tmp = q->tail;
-  char *x = tmp->x;
+  char *x = _data(q, tmp);
   q->tail = q->tail->prev;
-  free(tmp);
   if ( q->tail != NULL ) q->tail->next = NULL;
   q->nmems--;
   return x;
@@ -211,9 +238,9 @@ void *dqueues_find(dqueues_t q, const void *x)
   if ( q == NULL ) return NULL;
   dqueues_node_t *tmp = q->head;
   while ( tmp != NULL ) {
-    switch ( q->cmp(x, tmp->x) ) {
+    switch ( _cmp(q, x, _data(q, tmp), NULL, 0) ) {
     case -1: return NULL;
-    case 0: return tmp->x;
+    case 0: return _data(q, tmp);
     }
     tmp = tmp->next;
   }
@@ -225,9 +252,9 @@ void *dqueues_find_r(dqueues_t q, const void *x, void *y)
   if ( q == NULL ) return NULL;
   dqueues_node_t *tmp = q->head;
   while ( tmp != NULL ) {
-    switch ( q->cmp_r(x, tmp->x, y) ) {
+    switch ( _cmp(q, x, _data(q, tmp), y, 1) ) {
     case -1: return NULL;
-    case 0: return tmp->x;
+    case 0: return _data(q, tmp);
     }
     tmp = tmp->next;
   }
@@ -243,25 +270,23 @@ void *dqueues_remove(dqueues_t q, const void *x)
 
   /* check head */
   tmp = q->head;
-  switch ( q->cmp(x, tmp->x) ) {
+  switch ( _cmp(q, x, _data(q, tmp), NULL, 0) ) {
   case -1: return NULL;
   case 0:
     if ( q->head->next != NULL ) q->head->next->prev = NULL;
     q->head = q->head->next;
-    _x = tmp->x;
-    free(tmp);
+    _x = _data(q, tmp);
     q->nmems--;
     return _x;
   }
 
   /* check tail */
   tmp = q->tail;
-  switch ( q->cmp(x, tmp->x) ) {
+  switch ( _cmp(q, x, _data(q, tmp), NULL, 0) ) {
   case 0:
     if ( q->tail->prev != NULL ) q->tail->prev->next = NULL;
     q->tail = q->tail->prev;
-    _x = tmp->x;
-    free(tmp);
+    _x = _data(q, tmp);
     q->nmems--;
     return _x;
   case 1: return NULL;
@@ -270,13 +295,12 @@ void *dqueues_remove(dqueues_t q, const void *x)
   /* check body */
   tmp = q->head->next;
   while ( tmp != q->tail )
-    switch ( q->cmp(x, tmp->x) ) {
+    switch ( _cmp(q, x, _data(q, tmp), NULL, 0) ) {
     case -1: return NULL;
     case 0:
       tmp->prev->next = tmp->next;
       tmp->next->prev = tmp->prev;
-      _x = tmp->x;
-      free(tmp);
+      _x = _data(q, tmp);
       q->nmems--;
       return _x;
     case 1: tmp = tmp->next; break;
@@ -294,25 +318,23 @@ void *dqueues_remove_r(dqueues_t q, const void *x, void *y)
 
   /* check head */
   tmp = q->head;
-  switch ( q->cmp_r(x, tmp->x, y) ) {
+  switch ( _cmp(q, x, _data(q, tmp), y, 1) ) {
   case -1: return NULL;
   case 0:
     if ( q->head->next != NULL ) q->head->next->prev = NULL;
     q->head = q->head->next;
-    _x = tmp->x;
-    free(tmp);
+    _x = _data(q, tmp);
     q->nmems--;
     return _x;
   }
 
   /* check tail */
   tmp = q->tail;
-  switch ( q->cmp_r(x, tmp->x, y) ) {
+  switch ( _cmp(q, x, _data(q, tmp), y, 1) ) {
   case 0:
     if ( q->tail->prev != NULL ) q->tail->prev->next = NULL;
     q->tail = q->tail->prev;
-    _x = tmp->x;
-    free(tmp);
+    _x = _data(q, tmp);
     q->nmems--;
     return _x;
   case 1: return NULL;
@@ -321,13 +343,12 @@ void *dqueues_remove_r(dqueues_t q, const void *x, void *y)
   /* check body */
   tmp = q->head->next;
   while ( tmp != q->tail )
-    switch ( q->cmp_r(x, tmp->x, y) ) {
+    switch ( _cmp(q, x, _data(q, tmp), y, 1) ) {
     case -1: return NULL;
     case 0:
       tmp->prev->next = tmp->next;
       tmp->next->prev = tmp->prev;
-      _x = tmp->x;
-      free(tmp);
+      _x = _data(q, tmp);
       q->nmems--;
       return _x;
     case 1: tmp = tmp->next; break;
@@ -336,13 +357,49 @@ void *dqueues_remove_r(dqueues_t q, const void *x, void *y)
   return NULL;
 }
 
+/* unlink and free every record passing the sweep */
+static
+size_t _remove_if(dqueues_t q, const sweeps_t *s)
+{
+  size_t k = 0;
+  dqueues_node_t *tmp, *next;
+  if ( q == NULL ) return 0;
+  for ( tmp = q->head; tmp != NULL; tmp = next ) {
+    next = tmp->next;
+    if ( !_sweep_test(s, _data(q, tmp)) ) continue;
+    if ( tmp->prev != NULL ) tmp->prev->next = next;
+    else q->head = next;
+    if ( next != NULL ) next->prev = tmp->prev;
+    else q->tail = tmp->prev;
+    _sweep_dispose(s, _data(q, tmp));
+    _afree(&q->al, _data(q, tmp));
+    k++;
+  }
+  q->nmems -= k;
+  return k;
+}
+
+size_t dqueues_remove_if(dqueues_t q, int pred(const void *x),
+                         void dispose(void *x))
+{
+  sweeps_t s = { pred, NULL, dispose, NULL, NULL };
+  return _remove_if(q, &s);
+}
+
+size_t dqueues_remove_if_r(dqueues_t q, int pred(const void *x, void *y),
+                           void dispose(void *x, void *y), void *y)
+{
+  sweeps_t s = { NULL, pred, NULL, dispose, y };
+  return _remove_if(q, &s);
+}
+
 int dqueues_map(dqueues_t q, int apply(void **x))
 {
   if ( q == NULL ) return 1;
-  dqueues_node_t *tmp = q->head;
-  while ( tmp != NULL ) {
-    if ( apply((void**)&tmp->x) < 0 ) return -1;
-    tmp = tmp->next;
+  void *x;
+  for ( dqueues_node_t *tmp = q->head; tmp != NULL; tmp = tmp->next ) {
+    x = _data(q, tmp);
+    if ( apply(&x) < 0 ) return -1;
   }
   return 1;
 }
@@ -350,23 +407,40 @@ int dqueues_map(dqueues_t q, int apply(void **x))
 int dqueues_map_r(dqueues_t q, int apply(void **x, void *y), void *y)
 {
   if ( q == NULL ) return 1;
-  dqueues_node_t *tmp = q->head;
-  while ( tmp != NULL ) {
-    if ( apply((void**)&tmp->x, y) < 0 ) return -1;
-    tmp = tmp->next;
+  void *x;
+  for ( dqueues_node_t *tmp = q->head; tmp != NULL; tmp = tmp->next ) {
+    x = _data(q, tmp);
+    if ( apply(&x, y) < 0 ) return -1;
   }
   return 1;
 }
 
+int dqueues_iterinit(dqueues_t q, dqueues_iter_t *it)
+{
+  it->x = NULL;
+  if ( q == NULL || q->head == NULL ) return -1;
+  it->off = q->off;
+  it->x = _data(q, q->head);
+  return 1;
+}
+
+int dqueues_iternext(dqueues_iter_t *it)
+{
+  dqueues_node_t *n = ((dqueues_node_t*)((char*)it->x + it->off))->next;
+  it->x = n == NULL ? NULL : (char*)n - it->off;
+  return n == NULL ? -1 : 1;
+}
+
 void dqueues_free(dqueues_t *q)
 {
   if ( *q == NULL ) return;
+  allocators_t al = (*q)->al;
   while ( (*q)->head != NULL ) {
     dqueues_node_t *tmp = (*q)->head;
     (*q)->head = (*q)->head->next;
-    free(tmp);
+    _afree(&al, _data(*q, tmp));
   }
-  free(*q);
+  _afree(&al, *q);
   *q = NULL;
 }
 
@@ -374,3 +448,14 @@ size_t dqueues_size(dqueues_t q)
 {
   return q->nmems;
 }
+
+size_t dqueues_bytes(dqueues_t q)
+{
+  return sizeof(*q) + q->nmems * RECORD(q->size);
+}
+
+size_t dqueues_memory_usage(dqueues_t q, size_t *payload)
+{
+  if ( payload != NULL ) *payload = q->nmems * q->size;
+  return dqueues_bytes(q);
+}
@@ -4,40 +4,67 @@
  */
 # include <config.h>
 # include <deepstacks.h>
+# define COUNTS_KIND COUNTERS_DEEPSTACKS
+# include "allocs.h"
 
 /**
  * @brief Internal structure for <tt>dstacks_t</tt> object.
  */
 struct dstacks_node_t {
-  char *x;                     ///< dynamically allocated data
   struct dstacks_node_t *next; ///< pointer to next element in stack
 };
 typedef struct dstacks_node_t dstacks_node_t;
 
+/*
+ * A data object and its link share one allocation, the data object first so
+ * that pointers handed back to the user may be passed to free. The link follows
+ * at offset off, the data size rounded up to pointer alignment.
+ */
+
 /**
  * @brief <tt>dstacks_t</tt> class object.
  */
 struct dstacks_t {
   size_t nmems;         ///< number elements in stack
   size_t size;          ///< total size of data objects
+  size_t off;           ///< offset of link within an allocation
   dstacks_node_t *head; ///< pointer to head of stack
+  allocators_t al;      ///< allocator of the stack
 };
 
+static inline
+char *_data(dstacks_t s, dstacks_node_t *node)
+{
+  return (char*)node - s->off;
+}
+
 dstacks_t dstacks_new(size_t size)
+{
+  return dstacks_new_alloc(size, &allocators_std);
+}
+
+dstacks_t dstacks_new_alloc(size_t size, const allocators_t *al)
 {
   dstacks_t s;
-  s = (dstacks_t)malloc(sizeof(*s));
+  s = (dstacks_t)_amalloc(al, sizeof(*s));
+  s->al = *al;
   s->nmems = 0;
   s->size = size;
+  s->off = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
   s->head = NULL;
   return s;
 }
 
 void dstacks_push(dstacks_t s, void *x)
 {
-  dstacks_node_t *node = (dstacks_node_t*)malloc(sizeof(dstacks_node_t));
-  node->x = (char*)malloc(s->size);
-  memcpy(node->x, x, s->size);
+  char *p = (char*)_amalloc(&s->al, RECORD(s->size));
+  memcpy(p, x, s->size);
+  dstacks_push_adopt(s, p);
+}
+
+void dstacks_push_adopt(dstacks_t s, void *x)
+{
+  dstacks_node_t *node = (dstacks_node_t*)((char*)x + s->off);
   node->next = s->head;
   s->head = node;
   s->nmems++;
@@ -47,22 +74,20 @@ char *dstacks_pop(dstacks_t s)
 {
   dstacks_node_t *tmp = s->head;
   s->head = s->head->next;
-  char *x = tmp->x;
-  free(tmp);
   s->nmems--;
-  return x;
+  return _data(s, tmp);
 }
 
 void dstacks_free(dstacks_t *s)
 {
   if ( *s == NULL ) return;
+  allocators_t al = (*s)->al;
   while ( (*s)->head != NULL ) {
     dstacks_node_t *tmp = (*s)->head;
     (*s)->head = (*s)->head->next;
-    free(tmp->x);
-    free(tmp);
+    _afree(&al, _data(*s, tmp));
   }
-  free(*s);
+  _afree(&al, *s);
   *s = NULL;
 }
 
@@ -79,10 +104,10 @@ size_t dstacks_size(dstacks_t s)
 int dstacks_map(dstacks_t s, int apply(void **x))
 {
   if ( s == NULL ) return 1;
-  dstacks_node_t *tmp = s->head;
-  while ( tmp != NULL ) {
-    if ( apply((void**)&tmp->x) < 0 ) return -1;
-    tmp = tmp->next;
+  void *x;
+  for ( dstacks_node_t *tmp = s->head; tmp != NULL; tmp = tmp->next ) {
+    x = _data(s, tmp);
+    if ( apply(&x) < 0 ) return -1;
   }
   return 1;
 }
@@ -90,10 +115,10 @@ int dstacks_map(dstacks_t s, int apply(void **x))
 int dstacks_map_r(dstacks_t s, int apply(void **x, void *y), void *y)
 {
   if ( s == NULL ) return 1;
-  dstacks_node_t *tmp = s->head;
-  while ( tmp != NULL ) {
-    if ( apply((void**)&tmp->x, y) < 0 ) return -1;
-    tmp = tmp->next;
+  void *x;
+  for ( dstacks_node_t *tmp = s->head; tmp != NULL; tmp = tmp->next ) {
+    x = _data(s, tmp);
+    if ( apply(&x, y) < 0 ) return -1;
   }
   return 1;
 }
@@ -0,0 +1,169 @@
+/**
+ * @file deques.c
+ * @brief Implementation of <tt>deques_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <deques.h>
+
+# define COUNTS_KIND COUNTERS_DEQUES
+# include "allocs.h"
+
+/**
+ * @brief <tt>deques_t</tt> class object.
+ */
+struct deques_t {
+  size_t size;     ///< size of elements of deque
+  size_t mask;     ///< capacity - 1; capacity is zero or a power of two
+  size_t head;     ///< index of front element
+  size_t nmem;     ///< number of elements currently in deque
+  char *x;         ///< ring buffer
+  allocators_t al; ///< allocator of the deque
+};
+
+/* slot of the ith element from the front */
+static inline
+char *_slot(deques_t d, size_t i)
+{
+  return d->x + (((d->head + i) & d->mask) * d->size);
+}
+
+static inline
+size_t _pow2(size_t n)
+{
+  size_t c = 1;
+  while ( c < n ) c <<= 1;
+  return c;
+}
+
+/* move the ring into a buffer of capacity c, unwrapped from index 0 */
+static
+void _grow(deques_t d, size_t c)
+{
+  char *x = (char*)_amalloc(&d->al, c * d->size);
+  size_t cap = d->x == NULL ? 0 : d->mask + 1;
+  if ( d->nmem > 0 ) {
+    size_t n = cap - d->head;
+    if ( n > d->nmem ) n = d->nmem;
+    memcpy(x, d->x + d->head * d->size, n * d->size);
+    memcpy(x + n * d->size, d->x, (d->nmem - n) * d->size);
+  }
+  _afree(&d->al, d->x);
+  d->x = x;
+  d->head = 0;
+  d->mask = c - 1;
+}
+
+deques_t deques_new(size_t size, size_t capacity)
+{
+  return deques_new_alloc(size, capacity, &allocators_std);
+}
+
+deques_t deques_new_alloc(size_t size, size_t capacity, const allocators_t *al)
+{
+  deques_t d;
+  d = (deques_t)_amalloc(al, sizeof(*d));
+  d->al = *al;
+  d->size = size;
+  d->head = d->nmem = d->mask = 0;
+  d->x = NULL;
+  if ( capacity > 0 ) _grow(d, _pow2(capacity));
+  return d;
+}
+
+void deques_push_back(deques_t d, const void *x)
+{
+  if ( d->x == NULL || d->nmem > d->mask )
+    _grow(d, d->x == NULL ? 8 : (d->mask + 1) << 1);
+  memcpy(_slot(d, d->nmem), x, d->size);
+  d->nmem++;
+}
+
+void deques_push_front(deques_t d, const void *x)
+{
+  if ( d->x == NULL || d->nmem > d->mask )
+    _grow(d, d->x == NULL ? 8 : (d->mask + 1) << 1);
+  d->head = (d->head - 1) & d->mask;
+  memcpy(d->x + d->head * d->size, x, d->size);
+  d->nmem++;
+}
+
+int deques_pop_front(deques_t d, void *x)
+{
+  if ( d->nmem == 0 ) return -1;
+  if ( x != NULL ) memcpy(x, d->x + d->head * d->size, d->size);
+  d->head = (d->head + 1) & d->mask;
+  d->nmem--;
+  return 1;
+}
+
+int deques_pop_back(deques_t d, void *x)
+{
+  if ( d->nmem == 0 ) return -1;
+  d->nmem--;
+  if ( x != NULL ) memcpy(x, _slot(d, d->nmem), d->size);
+  return 1;
+}
+
+void *deques_front(deques_t d)
+{
+  return d->nmem == 0 ? NULL : d->x + d->head * d->size;
+}
+
+void *deques_back(deques_t d)
+{
+  return d->nmem == 0 ? NULL : _slot(d, d->nmem - 1);
+}
+
+void *deques_at(deques_t d, size_t i)
+{
+  return _slot(d, i);
+}
+
+int deques_map(deques_t d, int apply(void *x))
+{
+  for ( size_t i = 0; i < d->nmem; i++ )
+    if ( apply(_slot(d, i)) < 0 ) return -1;
+  return 1;
+}
+
+int deques_map_r(deques_t d, int apply(void *x, void *y), void *y)
+{
+  for ( size_t i = 0; i < d->nmem; i++ )
+    if ( apply(_slot(d, i), y) < 0 ) return -1;
+  return 1;
+}
+
+void deques_reserve(deques_t d, size_t nmem)
+{
+  if ( nmem > (d->x == NULL ? 0 : d->mask + 1) ) _grow(d, _pow2(nmem));
+}
+
+void deques_clear(deques_t d)
+{
+  d->head = d->nmem = 0;
+}
+
+void deques_free(deques_t *d)
+{
+  if ( d == NULL || *d == NULL ) return;
+  allocators_t al = (*d)->al;
+  _afree(&al, (*d)->x);
+  _afree(&al, *d);
+  *d = NULL;
+}
+
+size_t deques_nmem(deques_t d)
+{
+  return d->nmem;
+}
+
+size_t deques_capacity(deques_t d)
+{
+  return d->x == NULL ? 0 : d->mask + 1;
+}
+
+size_t deques_size(deques_t d)
+{
+  return d->size;
+}
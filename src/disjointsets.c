@@ -0,0 +1,119 @@
+/**
+ * @file disjointsets.c
+ * @brief Implementation of <tt>disjointsets_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <disjointsets.h>
+# include "allocs.h"
+
+/**
+ * @brief <tt>disjointsets_t</tt> class object.
+ */
+struct disjointsets_t {
+  size_t n;        ///< number of elements
+  size_t count;    ///< number of sets
+  uint32_t *p;     ///< parent of every element, roots being their own
+  uint32_t *sz;    ///< number of elements of the set of every root
+  allocators_t al; ///< allocator of the partition
+};
+
+disjointsets_t disjointsets_new(size_t n)
+{
+  return disjointsets_new_alloc(n, &allocators_std);
+}
+
+disjointsets_t disjointsets_new_alloc(size_t n, const allocators_t *al)
+{
+  disjointsets_t d;
+  d = (disjointsets_t)_amalloc(al, sizeof(*d));
+  d->al = *al;
+  d->n = d->count = n;
+  d->p = (uint32_t*)_amalloc(al, (n ? n : 1) * sizeof(uint32_t));
+  d->sz = (uint32_t*)_amalloc(al, (n ? n : 1) * sizeof(uint32_t));
+  for ( size_t i = 0; i < n; i++ ) {
+    d->p[i] = (uint32_t)i;
+    d->sz[i] = 1;
+  }
+  return d;
+}
+
+void disjointsets_free(disjointsets_t *d)
+{
+  if ( *d == NULL ) return;
+  allocators_t al = (*d)->al;
+  _afree(&al, (*d)->p);
+  _afree(&al, (*d)->sz);
+  _afree(&al, *d);
+  *d = NULL;
+}
+
+/* root of x, every other node of the path linked to its grandparent */
+static inline
+uint32_t _find(uint32_t *p, uint32_t x)
+{
+  while ( p[x] != x ) {
+    p[x] = p[p[x]];
+    x = p[x];
+  }
+  return x;
+}
+
+uint32_t disjointsets_find(disjointsets_t d, uint32_t x)
+{
+  return _find(d->p, x);
+}
+
+static inline
+int _union(disjointsets_t d, uint32_t x, uint32_t y)
+{
+  uint32_t t;
+  if ( (x = _find(d->p, x)) == (y = _find(d->p, y)) ) return -1;
+  if ( d->sz[x] < d->sz[y] ) {
+    t = x;
+    x = y;
+    y = t;
+  }
+  d->p[y] = x;
+  d->sz[x] += d->sz[y];
+  d->count--;
+  return 1;
+}
+
+int disjointsets_union(disjointsets_t d, uint32_t x, uint32_t y)
+{
+  return _union(d, x, y);
+}
+
+size_t disjointsets_union_edges(disjointsets_t d, const uint32_t *e, size_t m)
+{
+  size_t k = 0;
+  for ( size_t i = 0; i < m; i++ ) k += _union(d, e[2 * i], e[2 * i + 1]) > 0;
+  return k;
+}
+
+int disjointsets_same(disjointsets_t d, uint32_t x, uint32_t y)
+{
+  return _find(d->p, x) == _find(d->p, y) ? 1 : -1;
+}
+
+size_t disjointsets_setsize(disjointsets_t d, uint32_t x)
+{
+  return d->sz[_find(d->p, x)];
+}
+
+void disjointsets_labels(disjointsets_t d, uint32_t *out)
+{
+  for ( size_t i = 0; i < d->n; i++ )
+    out[i] = d->p[i] = _find(d->p, (uint32_t)i);
+}
+
+size_t disjointsets_count(disjointsets_t d)
+{
+  return d->count;
+}
+
+size_t disjointsets_size(disjointsets_t d)
+{
+  return d->n;
+}
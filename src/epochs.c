@@ -0,0 +1,155 @@
+/**
+ * @file epochs.c
+ * @brief Implementation of epoch based reclamation.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include "epochs.h"
+# include <stdlib.h>
+# include <stdint.h>
+# include <stdatomic.h>
+# include <pthread.h>
+# include <sched.h>
+# include <errno.h>
+# include <error.h>
+
+/**
+ * @brief Per thread record of the epoch observed.
+ */
+typedef struct rec_t {
+  _Atomic uint64_t epoch; ///< global epoch seen on entering
+  atomic_int active;      ///< inside a critical section
+  atomic_int used;        ///< owned by a live thread
+  struct rec_t *next;     ///< next record of registry
+} rec_t;
+
+/**
+ * @brief Object awaiting reclamation.
+ */
+typedef struct garbage_t {
+  void *p;                ///< retired memory
+  void (*dtor)(void*);    ///< destructor of <tt>p</tt>
+  struct garbage_t *next; ///< next retired object
+} garbage_t;
+
+static _Atomic uint64_t _epoch;
+static _Atomic(rec_t*) _recs;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+static garbage_t *_limbo[3];
+static pthread_once_t _once = PTHREAD_ONCE_INIT;
+static pthread_key_t _key;
+
+static _Thread_local rec_t *_self;
+static _Thread_local unsigned _nest;
+
+/* release the record of an exiting thread for reuse */
+static
+void _release(void *r)
+{
+  atomic_store(&((rec_t*)r)->active, 0);
+  atomic_store(&((rec_t*)r)->used, 0);
+}
+
+static
+void _init(void)
+{
+  if ( pthread_key_create(&_key, _release) != 0 )
+    error(1, errno, "pthread_key_create failure");
+}
+
+static
+rec_t *_acquire(void)
+{
+  rec_t *r;
+  int z;
+  pthread_once(&_once, _init);
+  for ( r = atomic_load(&_recs); r != NULL; r = r->next )
+    if ( (z = 0, atomic_compare_exchange_strong(&r->used, &z, 1)) ) break;
+  if ( r == NULL ) {
+    if ( (r = (rec_t*)malloc(sizeof(*r))) == NULL )
+      error(1, errno, "malloc failure");
+    atomic_init(&r->epoch, 0);
+    atomic_init(&r->active, 0);
+    atomic_init(&r->used, 1);
+    r->next = atomic_load(&_recs);
+    while ( !atomic_compare_exchange_weak(&_recs, &r->next, r) );
+  }
+  pthread_setspecific(_key, r);
+  return r;
+}
+
+void epochs_enter(void)
+{
+  if ( _nest++ > 0 ) return;
+  if ( _self == NULL ) _self = _acquire();
+  atomic_store(&_self->active, 1);
+  atomic_store(&_self->epoch, atomic_load(&_epoch));
+}
+
+void epochs_exit(void)
+{
+  if ( --_nest > 0 ) return;
+  atomic_store_explicit(&_self->active, 0, memory_order_release);
+}
+
+static
+void _drain(garbage_t *g)
+{
+  garbage_t *next;
+  for ( ; g != NULL; g = next ) {
+    next = g->next;
+    g->dtor(g->p);
+    free(g);
+  }
+}
+
+/*
+ * advance the global epoch if every active thread has seen it; returns the
+ * objects which became unreachable, _lock being held
+ */
+static
+garbage_t *_advance(int *ok)
+{
+  uint64_t e = atomic_load(&_epoch);
+  garbage_t *g;
+  *ok = 0;
+  for ( rec_t *r = atomic_load(&_recs); r != NULL; r = r->next )
+    if ( atomic_load(&r->active) && atomic_load(&r->epoch) != e ) return NULL;
+  atomic_store(&_epoch, e + 1);
+  /* objects retired two epochs ago */
+  g = _limbo[(e + 1) % 3];
+  _limbo[(e + 1) % 3] = NULL;
+  *ok = 1;
+  return g;
+}
+
+void epochs_retire(void *p, void (*dtor)(void*))
+{
+  garbage_t *g;
+  int ok;
+  if ( (g = (garbage_t*)malloc(sizeof(*g))) == NULL )
+    error(1, errno, "malloc failure");
+  g->p = p;
+  g->dtor = dtor;
+  pthread_mutex_lock(&_lock);
+  uint64_t e = atomic_load(&_epoch);
+  g->next = _limbo[e % 3];
+  _limbo[e % 3] = g;
+  g = _advance(&ok);
+  pthread_mutex_unlock(&_lock);
+  _drain(g);
+}
+
+void epochs_synchronize(void)
+{
+  garbage_t *g;
+  int ok;
+  for ( int i = 0; i < 3; ) {
+    pthread_mutex_lock(&_lock);
+    g = _advance(&ok);
+    pthread_mutex_unlock(&_lock);
+    _drain(g);
+    if ( ok ) i++;
+    else sched_yield();
+  }
+}
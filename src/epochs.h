@@ -0,0 +1,41 @@
+/**
+ * @file epochs.h
+ * @brief Epoch based reclamation shared by the concurrent containers.
+ *
+ * A thread reading shared links brackets the reads by <tt>epochs_enter</tt> and
+ * <tt>epochs_exit</tt>. Memory unlinked by a writer is handed to
+ * <tt>epochs_retire</tt>, and its destructor runs only after every thread which
+ * was inside such a bracket at the time has left it. Brackets may be nested.
+ *
+ * This header is private to the library.
+ * @author Thomas Pender
+ */
+# ifndef INCLUDED_EPOCHS_H
+# define INCLUDED_EPOCHS_H
+
+/**
+ * @brief Enter a read-side critical section.
+ */
+extern void epochs_enter(void);
+
+/**
+ * @brief Leave a read-side critical section.
+ */
+extern void epochs_exit(void);
+
+/**
+ * @brief Run <tt>dtor(p)</tt> once no thread can still be reading <tt>p</tt>.
+ *
+ * @param[in] p Memory unlinked from every shared structure.
+ * @param[in] dtor Function releasing <tt>p</tt>.
+ */
+extern void epochs_retire(void *p, void (*dtor)(void*));
+
+/**
+ * @brief Wait until every retired object has been released.
+ *
+ * Must not be called inside a read-side critical section.
+ */
+extern void epochs_synchronize(void);
+
+# endif
@@ -0,0 +1,167 @@
+/**
+ * @file eytzingers.c
+ * @brief Implementation of <tt>eytzingers_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <eytzingers.h>
+# include <string.h>
+# define COUNTS_KIND COUNTERS_EYTZINGERS
+# include "allocs.h"
+
+/**
+ * @brief Number of queries descended together by
+ * <tt>eytzingers_lower_bound_batch</tt>.
+ */
+# define BATCH 16
+
+/**
+ * @brief Levels ahead of the current level that are prefetched. The 16
+ * positions four levels below position <tt>k</tt> start at <tt>16k</tt>.
+ */
+# define AHEAD 4
+
+/**
+ * @brief <tt>eytzingers_t</tt> class object.
+ */
+struct eytzingers_t {
+  size_t nmem;                 ///< number of elements
+  size_t size;                 ///< size of elements
+  size_t depth;                ///< number of levels of the tree
+  eytzingers_data_cmp cmp;     ///< user provided compare function
+  eytzingers_data_cmp_r cmp_r; ///< user provided reentrant compare function
+  allocators_t al;             ///< allocator of the index
+  char *x;                     ///< elements in Eytzinger order, from position 1
+};
+
+static inline
+int _cmp(eytzingers_t e, const void *x, const void *y, void *arg, int r)
+{
+  return r ? e->cmp_r(x, y, arg) : e->cmp(x, y);
+}
+
+static inline
+char *_at(eytzingers_t e, size_t k)
+{
+  return e->x + k * e->size;
+}
+
+/* in-order walk of the positions, taking the sorted elements in turn */
+static
+void _build(eytzingers_t e, const char **src, size_t k)
+{
+  if ( k > e->nmem ) return;
+  _build(e, src, 2 * k);
+  memcpy(_at(e, k), *src, e->size);
+  *src += e->size;
+  _build(e, src, 2 * k + 1);
+}
+
+eytzingers_t eytzingers_new(arrays_t a, eytzingers_data_cmp cmp,
+                            eytzingers_data_cmp_r cmp_r)
+{
+  return eytzingers_new_alloc(a, cmp, cmp_r, &allocators_std);
+}
+
+eytzingers_t eytzingers_new_alloc(arrays_t a, eytzingers_data_cmp cmp,
+                                  eytzingers_data_cmp_r cmp_r,
+                                  const allocators_t *al)
+{
+  if ( cmp == NULL && cmp_r == NULL ) error(1, errno, "cmp pointers null");
+  eytzingers_t e;
+  e = (eytzingers_t)_amalloc(al, sizeof(*e));
+  e->al = *al;
+  e->nmem = arrays_nmem(a);
+  e->size = arrays_size(a);
+  e->cmp = cmp;
+  e->cmp_r = cmp_r;
+  for ( e->depth = 0; (e->nmem >> e->depth) != 0; e->depth++ );
+  e->x = (char*)_amalloc(al, (e->nmem + 1) * e->size);
+  if ( e->nmem != 0 ) {
+    const char *src = (const char*)arrays_at(a, 0);
+    _build(e, &src, 1);
+  }
+  return e;
+}
+
+/* position reached below the leaves back to the position of the lower bound */
+static inline
+void *_result(eytzingers_t e, size_t k)
+{
+  k >>= __builtin_ctzll(~(unsigned long long)k) + 1;
+  return k == 0 ? NULL : _at(e, k);
+}
+
+static inline
+void *_lower_bound(eytzingers_t e, const void *x, void *y, int r)
+{
+  size_t k = 1;
+  while ( k <= e->nmem ) {
+    __builtin_prefetch(_at(e, k << AHEAD));
+    k = 2 * k + (_cmp(e, _at(e, k), x, y, r) < 0);
+  }
+  return _result(e, k);
+}
+
+void *eytzingers_lower_bound(eytzingers_t e, const void *x)
+{
+  return _lower_bound(e, x, NULL, 0);
+}
+
+void *eytzingers_lower_bound_r(eytzingers_t e, const void *x, void *y)
+{
+  return _lower_bound(e, x, y, 1);
+}
+
+/*
+ * Every query takes depth steps. A query reaching a missing position of the
+ * last level goes right, which leaves its lower bound unchanged.
+ */
+static
+void _lower_bound_batch(eytzingers_t e, const void *const *x, size_t n,
+                        void **res, void *y, int r)
+{
+  size_t k[BATCH];
+  for ( size_t i = 0; i < n; i += BATCH ) {
+    size_t m = n - i < BATCH ? n - i : BATCH;
+    for ( size_t j = 0; j < m; j++ ) k[j] = 1;
+    for ( size_t d = 0; d < e->depth; d++ )
+      for ( size_t j = 0; j < m; j++ ) {
+        int c = k[j] > e->nmem || _cmp(e, _at(e, k[j]), x[i + j], y, r) < 0;
+        k[j] = 2 * k[j] + c;
+        __builtin_prefetch(_at(e, k[j] << AHEAD));
+      }
+    for ( size_t j = 0; j < m; j++ ) res[i + j] = _result(e, k[j]);
+  }
+}
+
+void eytzingers_lower_bound_batch(eytzingers_t e, const void *const *x,
+                                  size_t n, void **r)
+{
+  _lower_bound_batch(e, x, n, r, NULL, 0);
+}
+
+void eytzingers_lower_bound_batch_r(eytzingers_t e, const void *const *x,
+                                    size_t n, void **r, void *y)
+{
+  _lower_bound_batch(e, x, n, r, y, 1);
+}
+
+void eytzingers_free(eytzingers_t *e)
+{
+  if ( *e == NULL ) return;
+  allocators_t al = (*e)->al;
+  _afree(&al, (*e)->x);
+  _afree(&al, *e);
+  *e = NULL;
+}
+
+size_t eytzingers_nmem(eytzingers_t e)
+{
+  return e->nmem;
+}
+
+size_t eytzingers_size(eytzingers_t e)
+{
+  return e->size;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file fenwicks.c
+ * @brief Implementation of <tt>fenwicks_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <fenwicks.h>
+# include "allocs.h"
+
+/**
+ * @brief <tt>fenwicks_t</tt> class object.
+ */
+struct fenwicks_t {
+  size_t n;        ///< number of elements
+  size_t capacity; ///< number of elements the tree has room for
+  uint64_t *t;     ///< partial sums, from position 1
+  allocators_t al; ///< allocator of the tree
+};
+
+/* lowest set bit of k */
+static inline
+size_t _low(size_t k)
+{
+  return k & -k;
+}
+
+fenwicks_t fenwicks_new(size_t n)
+{
+  return fenwicks_new_alloc(n, &allocators_std);
+}
+
+fenwicks_t fenwicks_new_alloc(size_t n, const allocators_t *al)
+{
+  fenwicks_t f;
+  f = (fenwicks_t)_amalloc(al, sizeof(*f));
+  f->al = *al;
+  f->n = n;
+  f->capacity = n ? n : 1;
+  f->t = (uint64_t*)_acalloc(al, f->capacity + 1, sizeof(uint64_t));
+  return f;
+}
+
+/* every position adds its sum into the next position covering it */
+fenwicks_t fenwicks_new_array(arrays_t a)
+{
+  size_t n = arrays_nmem(a);
+  fenwicks_t f = fenwicks_new(n);
+  if ( n != 0 ) memcpy(f->t + 1, arrays_at(a, 0), n * sizeof(uint64_t));
+  for ( size_t k = 1; k <= n; k++ )
+    if ( k + _low(k) <= n ) f->t[k + _low(k)] += f->t[k];
+  return f;
+}
+
+void fenwicks_free(fenwicks_t *f)
+{
+  if ( *f == NULL ) return;
+  allocators_t al = (*f)->al;
+  _afree(&al, (*f)->t);
+  _afree(&al, *f);
+  *f = NULL;
+}
+
+void fenwicks_add(fenwicks_t f, size_t i, int64_t d)
+{
+  for ( size_t k = i + 1; k <= f->n; k += _low(k) ) f->t[k] += (uint64_t)d;
+}
+
+void fenwicks_set(fenwicks_t f, size_t i, uint64_t x)
+{
+  fenwicks_add(f, i, (int64_t)(x - fenwicks_get(f, i)));
+}
+
+/* position i + 1 less the positions it covers below i */
+uint64_t fenwicks_get(fenwicks_t f, size_t i)
+{
+  size_t k = i + 1, z = k - _low(k);
+  uint64_t x = f->t[k];
+  for ( size_t j = k - 1; j > z; j -= _low(j) ) x -= f->t[j];
+  return x;
+}
+
+uint64_t fenwicks_prefix(fenwicks_t f, size_t i)
+{
+  uint64_t s = 0;
+  for ( ; i != 0; i -= _low(i) ) s += f->t[i];
+  return s;
+}
+
+uint64_t fenwicks_range(fenwicks_t f, size_t lo, size_t hi)
+{
+  return fenwicks_prefix(f, hi) - fenwicks_prefix(f, lo);
+}
+
+/* descends from the largest power of two, keeping the positions that fit */
+size_t fenwicks_search(fenwicks_t f, uint64_t s)
+{
+  size_t k = 0, step = f->n;
+  if ( step == 0 ) return 0;
+  while ( step & (step - 1) ) step &= step - 1;
+  for ( ; step != 0; step >>= 1 )
+    if ( k + step <= f->n && f->t[k + step] <= s ) {
+      k += step;
+      s -= f->t[k];
+    }
+  return k;
+}
+
+/* the new position sums x with the positions it covers below it */
+void fenwicks_push(fenwicks_t f, uint64_t x)
+{
+  if ( f->n == f->capacity ) {
+    f->capacity <<= 1;
+    f->t = (uint64_t*)_arealloc(&f->al, f->t,
+                                (f->capacity + 1) * sizeof(uint64_t));
+  }
+  size_t k = ++f->n, z = k - _low(k);
+  for ( size_t j = k - 1; j > z; j -= _low(j) ) x += f->t[j];
+  f->t[k] = x;
+}
+
+size_t fenwicks_nmem(fenwicks_t f)
+{
+  return f->n;
+}
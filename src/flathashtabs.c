@@ -0,0 +1,499 @@
+/**
+ * @file flathashtabs.c
+ * @brief Implementation of <tt>flathashtabs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <flathashtabs.h>
+# include <hashes.h>
+# define COUNTS_KIND COUNTERS_FLATHASHTABS
+# include "allocs.h"
+
+# if HAVE_AVX2
+#  include <immintrin.h>
+# elif HAVE_SSE2
+#  include <emmintrin.h>
+# endif
+
+/**
+ * @brief Number of control bytes examined together while probing.
+ */
+# if HAVE_AVX2
+#  define GROUP 32
+# else
+#  define GROUP 16
+# endif
+
+/**
+ * @brief First bytes written by <tt>flathashtabs_write</tt>.
+ */
+# define MAGIC "CFLATHT"
+
+# define CTRL_EMPTY   ((uint8_t)0x80)
+# define CTRL_DELETED ((uint8_t)0xFE)
+
+/**
+ * @brief One bit per slot of a group.
+ */
+typedef uint32_t bitmask_t;
+
+/**
+ * @brief <tt>flathashtabs_t</tt> class object.
+ */
+struct flathashtabs_t {
+  size_t size;                   ///< size of data objects
+  size_t nmems;                  ///< number of elements in hash table
+  size_t ndeleted;               ///< number of slots marked deleted
+  size_t capacity;               ///< number of slots, a power of two
+  size_t gmask;                  ///< number of groups less one
+  flathashtabs_data_cmp cmp;     ///< user provided compare function
+  flathashtabs_data_cmp_r cmp_r; ///< user provided reentrant compare function
+  flathashtabs_hash hash;        ///< user provided hashing function
+  flathashtabs_hash_r hash_r;    ///< user provided reentrant hashing function
+  size_t words;                  ///< setwords of set keys, 0 for user functions
+  uint8_t *ctrl;                 ///< control bytes, one per slot
+  char *slots;                   ///< slot array
+  allocators_t al;               ///< allocator of the hash table
+};
+
+/**
+ * @brief Header written by <tt>flathashtabs_write</tt>.
+ */
+typedef struct {
+  char magic[8];                 ///< <tt>MAGIC</tt>
+  uint64_t size;                 ///< size of data objects
+  uint64_t nmems;                ///< number of elements
+  uint64_t ndeleted;             ///< number of slots marked deleted
+  uint64_t capacity;             ///< number of slots
+  uint64_t group;                ///< control bytes probed together
+} header_t;
+
+static inline
+unsigned _lowbit(bitmask_t m)
+{
+  return (unsigned)__builtin_ctz(m);
+}
+
+# if HAVE_AVX2
+
+static inline
+bitmask_t _match(const uint8_t *g, uint8_t h2)
+{
+  __m256i c = _mm256_loadu_si256((const __m256i*)g);
+  return (bitmask_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c,
+                                         _mm256_set1_epi8((char)h2)));
+}
+
+static inline
+bitmask_t _match_empty(const uint8_t *g)
+{
+  __m256i c = _mm256_loadu_si256((const __m256i*)g);
+  return (bitmask_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c,
+                                         _mm256_set1_epi8((char)CTRL_EMPTY)));
+}
+
+/* empty or deleted */
+static inline
+bitmask_t _match_free(const uint8_t *g)
+{
+  return (bitmask_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)g));
+}
+
+# elif HAVE_SSE2
+
+static inline
+bitmask_t _match(const uint8_t *g, uint8_t h2)
+{
+  __m128i c = _mm_loadu_si128((const __m128i*)g);
+  return (bitmask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8((char)h2)));
+}
+
+static inline
+bitmask_t _match_empty(const uint8_t *g)
+{
+  __m128i c = _mm_loadu_si128((const __m128i*)g);
+  return (bitmask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c,
+                                      _mm_set1_epi8((char)CTRL_EMPTY)));
+}
+
+/* empty or deleted */
+static inline
+bitmask_t _match_free(const uint8_t *g)
+{
+  return (bitmask_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+}
+
+# else
+
+static inline
+bitmask_t _match(const uint8_t *g, uint8_t h2)
+{
+  bitmask_t m = 0;
+  for ( unsigned i = 0; i < GROUP; i++ ) m |= (bitmask_t)(g[i] == h2) << i;
+  return m;
+}
+
+static inline
+bitmask_t _match_empty(const uint8_t *g)
+{
+  bitmask_t m = 0;
+  for ( unsigned i = 0; i < GROUP; i++ ) m |= (bitmask_t)(g[i] == CTRL_EMPTY) << i;
+  return m;
+}
+
+/* empty or deleted */
+static inline
+bitmask_t _match_free(const uint8_t *g)
+{
+  bitmask_t m = 0;
+  for ( unsigned i = 0; i < GROUP; i++ ) m |= (bitmask_t)(g[i] >> 7) << i;
+  return m;
+}
+
+# endif
+
+static inline
+size_t _get_capacity(size_t n)
+{
+  size_t c = GROUP;
+  while ( (c >> 3) * 7 < n ) c <<= 1;
+  return c;
+}
+
+/* set keys are compared a word at a time, without early exit */
+static inline
+int _wordseq(const uint64_t *x, const uint64_t *y, size_t m)
+{
+  uint64_t d = 0;
+  for ( size_t i = 0; i < m; i++ ) d |= x[i] ^ y[i];
+  return d == 0;
+}
+
+static inline
+int _eq(flathashtabs_t t, const void *x, const void *y, void *cmp_arg, int r)
+{
+  if ( t->words != 0 )
+    return _wordseq((const uint64_t*)x, (const uint64_t*)y, t->words);
+  COUNTS_ADD(cmps, 1);
+  return (r ? t->cmp_r(x, y, cmp_arg) : t->cmp(x, y)) == 0;
+}
+
+static inline
+uint64_t _hash(flathashtabs_t t, const void *x, const void *hash_arg, int r)
+{
+  COUNTS_ADD(hashes, 1);
+  if ( t->words != 0 ) return hashes_bytes(x, t->size, 0);
+  return r ? t->hash_r(x, hash_arg) : t->hash(x);
+}
+
+static
+void _alloc(flathashtabs_t t, size_t capacity)
+{
+  t->capacity = capacity;
+  t->gmask = capacity / GROUP - 1;
+  t->ctrl = (uint8_t*)_amalloc(&t->al, capacity);
+  t->slots = (char*)_amalloc(&t->al, capacity * t->size);
+  memset(t->ctrl, CTRL_EMPTY, capacity);
+  t->ndeleted = 0;
+}
+
+/* index of the given element's slot, or capacity if absent */
+static
+size_t _find(flathashtabs_t t, const void *x, uint64_t h, void *cmp_arg, int r)
+{
+  size_t g = (h >> 7) & t->gmask;
+  uint8_t h2 = h & 0x7F;
+  for ( size_t i = 1; ; i++ ) {
+    const uint8_t *c = t->ctrl + g * GROUP;
+    bitmask_t m = _match(c, h2);
+    while ( m != 0 ) {
+      size_t j = g * GROUP + _lowbit(m);
+      if ( _eq(t, x, t->slots + j * t->size, cmp_arg, r) ) {
+        COUNTS_CHAIN(i);
+        return j;
+      }
+      m &= m - 1;
+    }
+    if ( _match_empty(c) != 0 ) {
+      COUNTS_CHAIN(i);
+      return t->capacity;
+    }
+    g = (g + i) & t->gmask;
+  }
+}
+
+/* index of first empty or deleted slot on the probe sequence of h */
+static
+size_t _find_free(flathashtabs_t t, uint64_t h)
+{
+  size_t g = (h >> 7) & t->gmask;
+  for ( size_t i = 1; ; i++ ) {
+    bitmask_t m = _match_free(t->ctrl + g * GROUP);
+    if ( m != 0 ) return g * GROUP + _lowbit(m);
+    g = (g + i) & t->gmask;
+  }
+}
+
+/*
+ * rehash every element within the arrays the table already owns: full slots are
+ * marked deleted and deleted slots empty, then each marked slot is kept in place,
+ * moved to an empty slot, or swapped with another marked slot
+ */
+static
+void _rehash(flathashtabs_t t, const void *hash_arg, int r)
+{
+  size_t i, j;
+  char *tmp = (char*)_amalloc(&t->al, t->size);
+  for ( i = 0; i < t->capacity; i++ )
+    t->ctrl[i] = t->ctrl[i] & 0x80 ? CTRL_EMPTY : CTRL_DELETED;
+  for ( i = 0; i < t->capacity; ) {
+    if ( t->ctrl[i] != CTRL_DELETED ) {
+      i++;
+      continue;
+    }
+    char *x = t->slots + i * t->size;
+    uint64_t h = _hash(t, x, hash_arg, r);
+    j = _find_free(t, h);
+    char *y = t->slots + j * t->size;
+    if ( j / GROUP == i / GROUP ) {
+      t->ctrl[i++] = h & 0x7F;
+    }
+    else if ( t->ctrl[j] == CTRL_EMPTY ) {
+      memcpy(y, x, t->size);
+      t->ctrl[j] = h & 0x7F;
+      t->ctrl[i++] = CTRL_EMPTY;
+    }
+    else {
+      /* slot i now holds the displaced element, which is handled next */
+      memcpy(tmp, y, t->size);
+      memcpy(y, x, t->size);
+      memcpy(x, tmp, t->size);
+      t->ctrl[j] = h & 0x7F;
+    }
+  }
+  t->ndeleted = 0;
+  _afree(&t->al, tmp);
+}
+
+/* double the capacity by extending the arrays and rehashing in place */
+static
+void _grow(flathashtabs_t t, const void *hash_arg, int r)
+{
+  size_t capacity = t->capacity << 1;
+  t->ctrl = (uint8_t*)_arealloc(&t->al, t->ctrl, capacity);
+  t->slots = (char*)_arealloc(&t->al, t->slots, capacity * t->size);
+  memset(t->ctrl + t->capacity, CTRL_EMPTY, t->capacity);
+  t->capacity = capacity;
+  t->gmask = capacity / GROUP - 1;
+  _rehash(t, hash_arg, r);
+  COUNTS_EVENT(COUNTERS_REHASH, capacity >> 1, capacity);
+}
+
+static
+void _insert(flathashtabs_t t, const void *x,
+             const void *hash_arg, void *cmp_arg, int r)
+{
+  uint64_t h = _hash(t, x, hash_arg, r);
+  if ( _find(t, x, h, cmp_arg, r) != t->capacity ) return;
+  size_t j = _find_free(t, h);
+  if ( t->ctrl[j] == CTRL_EMPTY
+       && t->nmems + t->ndeleted + 1 > (t->capacity >> 3) * 7 ) {
+    /* purge deleted slots in place of growing when they are the bulk */
+    if ( t->nmems + 1 > (t->capacity >> 4) * 7 ) _grow(t, hash_arg, r);
+    else {
+      _rehash(t, hash_arg, r);
+      COUNTS_EVENT(COUNTERS_REHASH, t->capacity, t->capacity);
+    }
+    j = _find_free(t, h);
+  }
+  if ( t->ctrl[j] == CTRL_DELETED ) t->ndeleted--;
+  t->ctrl[j] = h & 0x7F;
+  memcpy(t->slots + j * t->size, x, t->size);
+  t->nmems++;
+}
+
+static
+int _remove(flathashtabs_t t, const void *x, void *out,
+            const void *hash_arg, void *cmp_arg, int r)
+{
+  size_t j = _find(t, x, _hash(t, x, hash_arg, r), cmp_arg, r);
+  if ( j == t->capacity ) return -1;
+  if ( out != NULL ) memcpy(out, t->slots + j * t->size, t->size);
+  /* a group holding an empty slot never caused a probe to continue past it */
+  if ( _match_empty(t->ctrl + (j / GROUP) * GROUP) != 0 ) t->ctrl[j] = CTRL_EMPTY;
+  else {
+    t->ctrl[j] = CTRL_DELETED;
+    t->ndeleted++;
+  }
+  t->nmems--;
+  return 1;
+}
+
+flathashtabs_t flathashtabs_new(flathashtabs_data_cmp cmp,
+                                flathashtabs_data_cmp_r cmp_r,
+                                flathashtabs_hash hash,
+                                flathashtabs_hash_r hash_r,
+                                size_t n, size_t size)
+{
+  return flathashtabs_new_alloc(cmp, cmp_r, hash, hash_r, n, size,
+                                &allocators_std);
+}
+
+flathashtabs_t flathashtabs_new_alloc(flathashtabs_data_cmp cmp,
+                                      flathashtabs_data_cmp_r cmp_r,
+                                      flathashtabs_hash hash,
+                                      flathashtabs_hash_r hash_r,
+                                      size_t n, size_t size,
+                                      const allocators_t *al)
+{
+  flathashtabs_t t;
+  t = (flathashtabs_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
+  t->size = size;
+  t->nmems = 0;
+  t->cmp = cmp;
+  t->cmp_r = cmp_r;
+  t->hash = hash;
+  t->hash_r = hash_r;
+  t->words = 0;
+  _alloc(t, _get_capacity(n));
+  return t;
+}
+
+flathashtabs_t flathashtabs_new_sets(size_t m, size_t n)
+{
+  return flathashtabs_new_sets_alloc(m, n, &allocators_std);
+}
+
+flathashtabs_t flathashtabs_new_sets_alloc(size_t m, size_t n,
+                                           const allocators_t *al)
+{
+  flathashtabs_t t;
+  t = flathashtabs_new_alloc(NULL, NULL, NULL, NULL, n,
+                             m * sizeof(uint64_t), al);
+  t->words = m;
+  return t;
+}
+
+void flathashtabs_insert(flathashtabs_t t, const void *x)
+{
+  _insert(t, x, NULL, NULL, 0);
+}
+
+void flathashtabs_insert_r(flathashtabs_t t, const void *x,
+                           const void *hash_arg, void *cmp_arg)
+{
+  _insert(t, x, hash_arg, cmp_arg, 1);
+}
+
+int flathashtabs_remove(flathashtabs_t t, const void *x, void *out)
+{
+  return _remove(t, x, out, NULL, NULL, 0);
+}
+
+int flathashtabs_remove_r(flathashtabs_t t, const void *x, void *out,
+                          const void *hash_arg, void *cmp_arg)
+{
+  return _remove(t, x, out, hash_arg, cmp_arg, 1);
+}
+
+void *flathashtabs_find(flathashtabs_t t, const void *x)
+{
+  size_t j = _find(t, x, _hash(t, x, NULL, 0), NULL, 0);
+  return j == t->capacity ? NULL : t->slots + j * t->size;
+}
+
+void *flathashtabs_find_r(flathashtabs_t t, const void *x,
+                          const void *hash_arg, void *cmp_arg)
+{
+  size_t j = _find(t, x, _hash(t, x, hash_arg, 1), cmp_arg, 1);
+  return j == t->capacity ? NULL : t->slots + j * t->size;
+}
+
+int flathashtabs_map(flathashtabs_t t, int apply(void *x))
+{
+  if ( t == NULL ) return 1;
+  for ( size_t i = 0; i < t->capacity; i++ )
+    if ( !(t->ctrl[i] & 0x80) && apply(t->slots + i * t->size) < 0 ) return -1;
+  return 1;
+}
+
+int flathashtabs_map_r(flathashtabs_t t, int apply(void *x, void *y), void *y)
+{
+  if ( t == NULL ) return 1;
+  for ( size_t i = 0; i < t->capacity; i++ )
+    if ( !(t->ctrl[i] & 0x80) && apply(t->slots + i * t->size, y) < 0 ) return -1;
+  return 1;
+}
+
+int flathashtabs_write(flathashtabs_t t, FILE *f)
+{
+  header_t h = { MAGIC, t->size, t->nmems, t->ndeleted, t->capacity, GROUP };
+  if ( fwrite(&h, sizeof(h), 1, f) != 1
+       || fwrite(t->ctrl, 1, t->capacity, f) != t->capacity
+       || fwrite(t->slots, t->size, t->capacity, f) != t->capacity ) return -1;
+  return 1;
+}
+
+/*
+ * the slots are read where they were written; a table written with another
+ * group width is then rehashed in place, in at least a group of slots
+ */
+static
+int _read(flathashtabs_t t, FILE *f, const void *hash_arg, int r)
+{
+  header_t h;
+  if ( fread(&h, sizeof(h), 1, f) != 1 ) return -1;
+  if ( memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.size != t->size
+       || h.capacity == 0 || (h.capacity & (h.capacity - 1)) != 0
+       || h.capacity < h.group || h.nmems + h.ndeleted > h.capacity ) {
+    errno = EINVAL;
+    return -1;
+  }
+  _afree(&t->al, t->ctrl);
+  _afree(&t->al, t->slots);
+  _alloc(t, h.capacity < GROUP ? GROUP : h.capacity);
+  t->nmems = 0;
+  if ( fread(t->ctrl, 1, h.capacity, f) != h.capacity
+       || fread(t->slots, t->size, h.capacity, f) != h.capacity ) {
+    memset(t->ctrl, CTRL_EMPTY, t->capacity);
+    return -1;
+  }
+  t->nmems = h.nmems;
+  t->ndeleted = h.ndeleted;
+  if ( h.group != GROUP ) {
+    _rehash(t, hash_arg, r);
+    COUNTS_EVENT(COUNTERS_REHASH, t->capacity, t->capacity);
+  }
+  return 1;
+}
+
+int flathashtabs_read(flathashtabs_t t, FILE *f)
+{
+  return _read(t, f, NULL, 0);
+}
+
+int flathashtabs_read_r(flathashtabs_t t, FILE *f, const void *hash_arg)
+{
+  return _read(t, f, hash_arg, 1);
+}
+
+void flathashtabs_free(flathashtabs_t *t)
+{
+  if ( *t == NULL ) return;
+  allocators_t al = (*t)->al;
+  _afree(&al, (*t)->ctrl);
+  _afree(&al, (*t)->slots);
+  _afree(&al, *t);
+  *t = NULL;
+}
+
+size_t flathashtabs_capacity(flathashtabs_t t)
+{
+  return t->capacity;
+}
+
+size_t flathashtabs_size(flathashtabs_t t)
+{
+  return t->nmems;
+}
@@ -0,0 +1,507 @@
+/**
+ * @file frozenhashtabs.c
+ * @brief Implementation of <tt>fhashtabs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <frozenhashtabs.h>
+# include <errno.h>
+# include <string.h>
+# include <hashes.h>
+# include "allocs.h"
+
+# if defined(HAVE_MMAP)
+#  define MAPPED 1
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+# endif
+
+/**
+ * @brief First bytes of the image of a table.
+ */
+# define MAGIC "CFHASHT"
+
+/**
+ * @brief Bytes before the pilots of an image, and alignment of its sections.
+ */
+# define HEADER 64
+# define ALIGN(n) (((n) + 15) & ~(size_t)15)
+
+/**
+ * @brief Mean number of elements per bucket of the perfect hash function.
+ */
+# define LAMBDA 4
+
+/**
+ * @brief Pilots tried per bucket, and seeds tried per table, before giving up.
+ */
+# define PILOTS 65536
+# define SEEDS 16
+
+/**
+ * @brief Header of the image of a table.
+ */
+typedef struct {
+  char magic[8];     ///< <tt>MAGIC</tt>
+  uint64_t size;     ///< size of data objects
+  uint64_t ksize;    ///< size of keys in map mode, 0 otherwise
+  uint64_t n;        ///< number of data objects
+  uint64_t m;        ///< number of slots hashed onto
+  uint64_t nbuckets; ///< number of buckets
+  uint64_t seed;     ///< seed of the perfect hash function
+} header_t;
+
+/**
+ * @brief <tt>fhashtabs_t</tt> class object.
+ *
+ * The image is laid out as the header, the pilots of the buckets, the slots
+ * of the data objects hashed past <tt>n</tt>, and the data objects.
+ */
+struct fhashtabs_t {
+  size_t n;                    ///< number of data objects
+  size_t size;                 ///< size of data objects
+  size_t ksize;                ///< size of keys in map mode, 0 otherwise
+  size_t m;                    ///< number of slots hashed onto
+  size_t nbuckets;             ///< number of buckets
+  uint64_t seed;               ///< seed of the perfect hash function
+  fhashtabs_data_cmp cmp;      ///< user defined compare function
+  fhashtabs_data_cmp_r cmp_r;  ///< user defined reentrant compare function
+  fhashtabs_hash hash;         ///< user defined hashing function
+  fhashtabs_hash_r hash_r;     ///< user defined reentrant hashing function
+  const uint16_t *pilot;       ///< pilot of each bucket
+  const uint32_t *remap;       ///< slot of each slot from <tt>n</tt> on
+  const char *x;               ///< data objects, by slot
+  char *img;                   ///< image of the table
+  size_t len;                  ///< bytes of the image
+  int mapped;                  ///< the image is a mapped file
+  allocators_t al;             ///< allocator of the table
+};
+
+/* finalizer of splitmix64 */
+static inline
+uint64_t _mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+/* x scaled onto [0, m) */
+static inline
+size_t _range(uint64_t x, size_t m)
+{
+# ifdef __SIZEOF_INT128__
+  return (size_t)(((__uint128_t)x * m) >> 64);
+# else
+  return (size_t)(x % m);
+# endif
+}
+
+static inline
+size_t _bucket(uint64_t k, size_t nbuckets)
+{
+  return (size_t)(((k >> 32) * nbuckets) >> 32);
+}
+
+static inline
+size_t _position(uint64_t k, uint16_t pilot, size_t m)
+{
+  return _range(_mix(k ^ ((uint64_t)pilot * 0x9e3779b97f4a7c15ull)), m);
+}
+
+/* lays out the sections of the image of t */
+static
+void _layout(fhashtabs_t t, size_t *off_r, size_t *off_x)
+{
+  *off_r = HEADER + ALIGN(t->nbuckets * sizeof(uint16_t));
+  *off_x = *off_r + ALIGN((t->m - t->n) * sizeof(uint32_t));
+  t->len = *off_x + t->n * t->size;
+}
+
+static
+void _attach(fhashtabs_t t)
+{
+  size_t off_r, off_x;
+  _layout(t, &off_r, &off_x);
+  t->pilot = (const uint16_t*)(t->img + HEADER);
+  t->remap = (const uint32_t*)(t->img + off_r);
+  t->x = t->img + off_x;
+}
+
+static
+fhashtabs_t _table(fhashtabs_data_cmp cmp, fhashtabs_data_cmp_r cmp_r,
+                   fhashtabs_hash hash, fhashtabs_hash_r hash_r,
+                   const allocators_t *al)
+{
+  fhashtabs_t t = (fhashtabs_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
+  t->cmp = cmp;
+  t->cmp_r = cmp_r;
+  t->hash = hash;
+  t->hash_r = hash_r;
+  t->img = NULL;
+  t->mapped = 0;
+  return t;
+}
+
+/**
+ * @brief Scratch space of a build.
+ */
+typedef struct {
+  uint64_t *k;       ///< seeded hash value of each element
+  uint32_t *order;   ///< elements by bucket
+  uint32_t *end;     ///< end of each bucket in <tt>order</tt>
+  uint32_t *buckets; ///< buckets by decreasing size
+  uint32_t *slot;    ///< slot of each element
+  uint16_t *pilot;   ///< pilot of each bucket
+  uint8_t *taken;    ///< slots taken
+} build_t;
+
+/*
+ * places the elements of hash values h with t->seed; 1 upon success, 0 if a
+ * bucket holds equal hash values, -1 if it has no pilot
+ */
+static
+int _place(fhashtabs_t t, build_t *b, const uint64_t *h)
+{
+  size_t n = t->n, nb = t->nbuckets, max = 0, i, j, lo;
+  uint32_t *cnt;
+  memset(b->end, 0, nb * sizeof(uint32_t));
+  memset(b->taken, 0, t->m);
+  for ( i = 0; i < n; i++ ) {
+    b->k[i] = _mix(h[i] ^ t->seed);
+    b->end[_bucket(b->k[i], nb)]++;
+  }
+  for ( i = 0; i < nb; i++ ) if ( b->end[i] > max ) max = b->end[i];
+  /* buckets by decreasing size, by counting sort */
+  cnt = (uint32_t*)_acalloc(&t->al, max + 2, sizeof(uint32_t));
+  for ( i = 0; i < nb; i++ ) cnt[max - b->end[i] + 1]++;
+  for ( i = 1; i <= max + 1; i++ ) cnt[i] += cnt[i - 1];
+  for ( i = 0; i < nb; i++ )
+    b->buckets[cnt[max - b->end[i]]++] = (uint32_t)i;
+  _afree(&t->al, cnt);
+  for ( i = 1; i < nb; i++ ) b->end[i] += b->end[i - 1];
+  for ( i = n; i-- > 0; )
+    b->order[--b->end[_bucket(b->k[i], nb)]] = (uint32_t)i;
+  /* end[i] is now the start of bucket i */
+  for ( size_t s = 0; s < nb; s++ ) {
+    size_t bi = b->buckets[s], hi, p;
+    lo = b->end[bi];
+    hi = bi + 1 < nb ? b->end[bi + 1] : n;
+    if ( lo == hi ) break;
+    for ( p = 0; p < PILOTS; p++ ) {
+      for ( j = lo; j < hi; j++ ) {
+        size_t q = _position(b->k[b->order[j]], (uint16_t)p, t->m);
+        if ( b->taken[q] ) break;
+        b->taken[q] = 1;
+        b->slot[b->order[j]] = (uint32_t)q;
+      }
+      if ( j == hi ) break;
+      while ( j-- > lo ) b->taken[b->slot[b->order[j]]] = 0;
+    }
+    if ( p < PILOTS ) {
+      b->pilot[bi] = (uint16_t)p;
+      continue;
+    }
+    for ( j = lo; j < hi; j++ )
+      for ( size_t l = lo; l < j; l++ )
+        if ( h[b->order[j]] == h[b->order[l]] ) return 0;
+    return -1;
+  }
+  return 1;
+}
+
+/* image of the n data objects at x, of hash values h, into t */
+static
+fhashtabs_t _build(fhashtabs_t t, const char *x, const uint64_t *h)
+{
+  build_t b;
+  size_t off_r, off_x, n = t->n, i, f;
+  int r = -1;
+  t->m = n == 0 ? 0 : n + n / 100 + 1;
+  t->nbuckets = n == 0 ? 0 : n / LAMBDA + 1;
+  b.k = (uint64_t*)_amalloc(&t->al, (n + 1) * sizeof(uint64_t));
+  b.order = (uint32_t*)_amalloc(&t->al, (n + 1) * sizeof(uint32_t));
+  b.slot = (uint32_t*)_amalloc(&t->al, (n + 1) * sizeof(uint32_t));
+  b.end = (uint32_t*)_amalloc(&t->al, (t->nbuckets + 1) * sizeof(uint32_t));
+  b.buckets = (uint32_t*)_amalloc(&t->al,
+                                  (t->nbuckets + 1) * sizeof(uint32_t));
+  b.pilot = (uint16_t*)_acalloc(&t->al, t->nbuckets + 1, sizeof(uint16_t));
+  b.taken = (uint8_t*)_amalloc(&t->al, t->m + 1);
+  for ( size_t s = 0; s < SEEDS; s++ ) {
+    t->seed = _mix(s + 1);
+    if ( (r = _place(t, &b, h)) >= 0 ) break;
+  }
+  if ( r > 0 ) {
+    _layout(t, &off_r, &off_x);
+    t->img = (char*)_acalloc(&t->al, 1, t->len);
+    header_t hd = { MAGIC, t->size, t->ksize, n, t->m, t->nbuckets, t->seed };
+    memcpy(t->img, &hd, sizeof(hd));
+    memcpy(t->img + HEADER, b.pilot, t->nbuckets * sizeof(uint16_t));
+    _attach(t);
+    /* slots past n onto the free slots below it */
+    uint32_t *remap = (uint32_t*)(t->img + off_r);
+    for ( i = n, f = 0; i < t->m; i++ ) {
+      if ( !b.taken[i] ) continue;
+      while ( b.taken[f] ) f++;
+      remap[i - n] = (uint32_t)f++;
+    }
+    for ( i = 0; i < n; i++ ) {
+      size_t q = b.slot[i] < n ? b.slot[i] : remap[b.slot[i] - n];
+      memcpy(t->img + off_x + q * t->size, x + i * t->size, t->size);
+    }
+  }
+  _afree(&t->al, b.k);
+  _afree(&t->al, b.order);
+  _afree(&t->al, b.slot);
+  _afree(&t->al, b.end);
+  _afree(&t->al, b.buckets);
+  _afree(&t->al, b.pilot);
+  _afree(&t->al, b.taken);
+  if ( r > 0 ) return t;
+  _afree(&t->al, t);
+  errno = EINVAL;
+  return NULL;
+}
+
+static inline
+uint64_t _keyhash(fhashtabs_t t, const void *k)
+{
+  return t->hash != NULL ? t->hash(k) : hashes_bytes(k, t->ksize, 0);
+}
+
+fhashtabs_t fhashtabs_new(fhashtabs_data_cmp cmp, fhashtabs_data_cmp_r cmp_r,
+                          fhashtabs_hash hash, fhashtabs_hash_r hash_r,
+                          const void *x, size_t n, size_t size)
+{
+  return fhashtabs_new_alloc(cmp, cmp_r, hash, hash_r, x, NULL, n, size,
+                             &allocators_std);
+}
+
+fhashtabs_t fhashtabs_new_alloc(fhashtabs_data_cmp cmp,
+                                fhashtabs_data_cmp_r cmp_r,
+                                fhashtabs_hash hash, fhashtabs_hash_r hash_r,
+                                const void *x, const uint64_t *h,
+                                size_t n, size_t size, const allocators_t *al)
+{
+  fhashtabs_t t = _table(cmp, cmp_r, hash, hash_r, al);
+  uint64_t *g = NULL;
+  t->n = n;
+  t->size = size;
+  t->ksize = 0;
+  if ( h == NULL ) {
+    g = (uint64_t*)_amalloc(al, (n + 1) * sizeof(uint64_t));
+    for ( size_t i = 0; i < n; i++ )
+      g[i] = hash((const char*)x + i * size);
+  }
+  t = _build(t, (const char*)x, h != NULL ? h : g);
+  _afree(al, g);
+  return t;
+}
+
+fhashtabs_t fhashtabs_new_map(fhashtabs_hash hash, const void *x, size_t n,
+                              size_t ksize, size_t vsize)
+{
+  return fhashtabs_new_map_alloc(hash, x, NULL, n, ksize, vsize,
+                                 &allocators_std);
+}
+
+fhashtabs_t fhashtabs_new_map_alloc(fhashtabs_hash hash, const void *x,
+                                    const uint64_t *h, size_t n,
+                                    size_t ksize, size_t vsize,
+                                    const allocators_t *al)
+{
+  fhashtabs_t t = _table(NULL, NULL, hash, NULL, al);
+  uint64_t *g = NULL;
+  t->n = n;
+  t->size = ksize + vsize;
+  t->ksize = ksize;
+  if ( h == NULL ) {
+    g = (uint64_t*)_amalloc(al, (n + 1) * sizeof(uint64_t));
+    for ( size_t i = 0; i < n; i++ )
+      g[i] = _keyhash(t, (const char*)x + i * t->size);
+  }
+  t = _build(t, (const char*)x, h != NULL ? h : g);
+  _afree(al, g);
+  return t;
+}
+
+/* slot of hash value h */
+static inline
+const char *_slot(fhashtabs_t t, uint64_t h)
+{
+  uint64_t k = _mix(h ^ t->seed);
+  size_t q = _position(k, t->pilot[_bucket(k, t->nbuckets)], t->m);
+  if ( q >= t->n ) q = t->remap[q - t->n];
+  return t->x + q * t->size;
+}
+
+void *fhashtabs_find(fhashtabs_t t, const void *x)
+{
+  const char *y;
+  if ( t->n == 0 ) return NULL;
+  y = _slot(t, t->hash(x));
+  return t->cmp(x, y) == 0 ? (void*)y : NULL;
+}
+
+void *fhashtabs_find_r(fhashtabs_t t, const void *x, const void *hash_arg,
+                       void *queue_arg)
+{
+  const char *y;
+  if ( t->n == 0 ) return NULL;
+  y = _slot(t, t->hash_r(x, hash_arg));
+  return t->cmp_r(x, y, queue_arg) == 0 ? (void*)y : NULL;
+}
+
+void *fhashtabs_get(fhashtabs_t t, const void *k)
+{
+  const char *y;
+  if ( t->n == 0 ) return NULL;
+  y = _slot(t, _keyhash(t, k));
+  return memcmp(k, y, t->ksize) == 0 ? (void*)(y + t->ksize) : NULL;
+}
+
+int fhashtabs_map(fhashtabs_t t, int apply(const void *x))
+{
+  for ( size_t i = 0; i < t->n; i++ )
+    if ( apply(t->x + i * t->size) < 0 ) return -1;
+  return 1;
+}
+
+int fhashtabs_map_r(fhashtabs_t t, int apply(const void *x, void *y), void *y)
+{
+  for ( size_t i = 0; i < t->n; i++ )
+    if ( apply(t->x + i * t->size, y) < 0 ) return -1;
+  return 1;
+}
+
+int fhashtabs_write(fhashtabs_t t, FILE *f)
+{
+  return fwrite(t->img, 1, t->len, f) == t->len ? 1 : -1;
+}
+
+/* table of header h, checked against an image of len bytes */
+static
+fhashtabs_t _load(const header_t *h, size_t len, fhashtabs_data_cmp cmp,
+                  fhashtabs_data_cmp_r cmp_r, fhashtabs_hash hash,
+                  fhashtabs_hash_r hash_r)
+{
+  fhashtabs_t t;
+  size_t off_r, off_x;
+  if ( memcmp(h->magic, MAGIC, sizeof(h->magic)) != 0 || h->m < h->n
+       || h->ksize > h->size || (h->n != 0 && h->nbuckets == 0) ) {
+    errno = EINVAL;
+    return NULL;
+  }
+  t = _table(cmp, cmp_r, hash, hash_r, &allocators_std);
+  t->n = h->n;
+  t->size = h->size;
+  t->ksize = h->ksize;
+  t->m = h->m;
+  t->nbuckets = h->nbuckets;
+  t->seed = h->seed;
+  _layout(t, &off_r, &off_x);
+  if ( len < t->len ) {
+    _afree(&t->al, t);
+    errno = EINVAL;
+    return NULL;
+  }
+  return t;
+}
+
+fhashtabs_t fhashtabs_read(FILE *f, fhashtabs_data_cmp cmp,
+                           fhashtabs_data_cmp_r cmp_r, fhashtabs_hash hash,
+                           fhashtabs_hash_r hash_r)
+{
+  char buf[HEADER];
+  header_t h;
+  fhashtabs_t t;
+  if ( fread(buf, HEADER, 1, f) != 1 ) return NULL;
+  memcpy(&h, buf, sizeof(h));
+  if ( (t = _load(&h, SIZE_MAX, cmp, cmp_r, hash, hash_r)) == NULL )
+    return NULL;
+  t->img = (char*)_amalloc(&t->al, t->len);
+  memcpy(t->img, buf, HEADER);
+  if ( fread(t->img + HEADER, 1, t->len - HEADER, f) != t->len - HEADER ) {
+    fhashtabs_free(&t);
+    return NULL;
+  }
+  _attach(t);
+  return t;
+}
+
+# ifdef MAPPED
+fhashtabs_t fhashtabs_open(const char *path, fhashtabs_data_cmp cmp,
+                           fhashtabs_data_cmp_r cmp_r, fhashtabs_hash hash,
+                           fhashtabs_hash_r hash_r)
+{
+  int fd, e;
+  struct stat st;
+  header_t h;
+  fhashtabs_t t = NULL;
+  void *p;
+  if ( (fd = open(path, O_RDONLY)) < 0 ) return NULL;
+  if ( fstat(fd, &st) < 0 ) goto done;
+  if ( (size_t)st.st_size < HEADER
+       || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) ) {
+    errno = EINVAL;
+    goto done;
+  }
+  if ( (t = _load(&h, st.st_size, cmp, cmp_r, hash, hash_r)) == NULL )
+    goto done;
+  p = mmap(NULL, t->len, PROT_READ, MAP_SHARED, fd, 0);
+  if ( p == MAP_FAILED ) {
+    e = errno;
+    _afree(&t->al, t);
+    errno = e;
+    t = NULL;
+    goto done;
+  }
+  t->img = (char*)p;
+  t->mapped = 1;
+  _attach(t);
+done:
+  /* the mapping outlives the descriptor */
+  e = errno;
+  close(fd);
+  errno = e;
+  return t;
+}
+# else
+fhashtabs_t fhashtabs_open(const char *path, fhashtabs_data_cmp cmp,
+                           fhashtabs_data_cmp_r cmp_r, fhashtabs_hash hash,
+                           fhashtabs_hash_r hash_r)
+{
+  (void)path, (void)cmp, (void)cmp_r, (void)hash, (void)hash_r;
+  errno = ENOSYS;
+  return NULL;
+}
+# endif
+
+void fhashtabs_free(fhashtabs_t *t)
+{
+  if ( *t == NULL ) return;
+  allocators_t al = (*t)->al;
+# ifdef MAPPED
+  if ( (*t)->mapped ) munmap((*t)->img, (*t)->len);
+  else _afree(&al, (*t)->img);
+# else
+  _afree(&al, (*t)->img);
+# endif
+  _afree(&al, *t);
+  *t = NULL;
+}
+
+size_t fhashtabs_size(fhashtabs_t t)
+{
+  return t->n;
+}
+
+size_t fhashtabs_bytes(fhashtabs_t t)
+{
+  return t->nbuckets * sizeof(uint16_t) + (t->m - t->n) * sizeof(uint32_t);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file hashes.c
+ * @brief Implementation of hash functions.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <hashes.h>
+# include <string.h>
+
+static const
+uint64_t _secret[4] = {
+  0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+  0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+};
+
+/* 128-bit product of *a and *b, low half in *a and high half in *b */
+static inline
+void _mum(uint64_t *a, uint64_t *b)
+{
+# ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t)*a * *b;
+  *a = (uint64_t)r;
+  *b = (uint64_t)(r >> 64);
+# else
+  uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32), c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+# endif
+}
+
+static inline
+uint64_t _mix(uint64_t a, uint64_t b)
+{
+  _mum(&a, &b);
+  return a ^ b;
+}
+
+static inline
+uint64_t _r8(const uint8_t *p)
+{
+  uint64_t v;
+  memcpy(&v, p, 8);
+  return v;
+}
+
+static inline
+uint64_t _r4(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+static inline
+uint64_t _r3(const uint8_t *p, size_t n)
+{
+  return ((uint64_t)p[0] << 16) | ((uint64_t)p[n >> 1] << 8) | p[n - 1];
+}
+
+static inline
+uint64_t _seed(uint64_t seed)
+{
+  return seed ^ _mix(seed ^ _secret[0], _secret[1]);
+}
+
+/* last round shared by every length */
+static inline
+uint64_t _final(uint64_t a, uint64_t b, uint64_t seed, size_t n)
+{
+  a ^= _secret[1];
+  b ^= seed;
+  _mum(&a, &b);
+  return _mix(a ^ _secret[0] ^ n, b ^ _secret[1]);
+}
+
+uint64_t hashes_bytes(const void *x, size_t n, uint64_t seed)
+{
+  const uint8_t *p = (const uint8_t*)x;
+  uint64_t a, b;
+  seed = _seed(seed);
+  if ( n <= 16 ) {
+    if ( n >= 4 ) {
+      a = (_r4(p) << 32) | _r4(p + ((n >> 3) << 2));
+      b = (_r4(p + n - 4) << 32) | _r4(p + n - 4 - ((n >> 3) << 2));
+    }
+    else if ( n > 0 ) {
+      a = _r3(p, n);
+      b = 0;
+    }
+    else a = b = 0;
+  }
+  else {
+    size_t i = n;
+    if ( i >= 48 ) {
+      /* three independent lanes keep the multipliers busy */
+      uint64_t s1 = seed, s2 = seed;
+      do {
+        seed = _mix(_r8(p) ^ _secret[1], _r8(p + 8) ^ seed);
+        s1 = _mix(_r8(p + 16) ^ _secret[2], _r8(p + 24) ^ s1);
+        s2 = _mix(_r8(p + 32) ^ _secret[3], _r8(p + 40) ^ s2);
+        p += 48;
+        i -= 48;
+      } while ( i >= 48 );
+      seed ^= s1 ^ s2;
+    }
+    for ( ; i > 16; i -= 16, p += 16 )
+      seed = _mix(_r8(p) ^ _secret[1], _r8(p + 8) ^ seed);
+    a = _r8(p + i - 16);
+    b = _r8(p + i - 8);
+  }
+  return _final(a, b, seed, n);
+}
+
+uint64_t hashes_u32(uint32_t x, uint64_t seed)
+{
+  uint64_t a = ((uint64_t)x << 32) | x;
+  return _final(a, a, _seed(seed), 4);
+}
+
+uint64_t hashes_u64(uint64_t x, uint64_t seed)
+{
+  uint8_t p[8];
+  memcpy(p, &x, 8);
+  uint64_t lo = _r4(p), hi = _r4(p + 4);
+  return _final((lo << 32) | hi, (hi << 32) | lo, _seed(seed), 8);
+}
+
+uint64_t hashes_u128(const void *x, uint64_t seed)
+{
+  const uint8_t *p = (const uint8_t*)x;
+  return _final((_r4(p) << 32) | _r4(p + 8), (_r4(p + 12) << 32) | _r4(p + 4),
+                _seed(seed), 16);
+}
+
+uint64_t hashes_bytes_r(const void *x, const void *key)
+{
+  const hashes_key_t *k = (const hashes_key_t*)key;
+  return hashes_bytes(x, k->n, k->seed);
+}
+
+uint64_t hashes_u32_r(const void *x, const void *seed)
+{
+  uint32_t v;
+  memcpy(&v, x, 4);
+  return hashes_u32(v, seed == NULL ? 0 : *(const uint64_t*)seed);
+}
+
+uint64_t hashes_u64_r(const void *x, const void *seed)
+{
+  uint64_t v;
+  memcpy(&v, x, 8);
+  return hashes_u64(v, seed == NULL ? 0 : *(const uint64_t*)seed);
+}
+
+uint64_t hashes_u128_r(const void *x, const void *seed)
+{
+  return hashes_u128(x, seed == NULL ? 0 : *(const uint64_t*)seed);
+}
@@ -4,50 +4,101 @@
  * @author Thomas Pender
  */
 # include <config.h>
+# undef CONTAINERS_INLINE
 # include <hashtabs.h>
-# include <queues.h>
+# include <errno.h>
+# include <error.h>
+# include <string.h>
+# include <pools.h>
+# include <bit_sets.h>
+# define COUNTS_KIND COUNTERS_HASHTABS
+# include "allocs.h"
+# include "primes.h"
+# include "sweeps.h"
+# if CONTAINERS_THREADS
+#  include <arrays.h>
+#  include "ranges.h"
+# endif
 
-# define NPRIMES 45
+/**
+ * @brief Number of old buckets migrated by each insert, find or remove while the
+ * table is growing.
+ */
+# define MIGRATE_STEP 4
 
-static volatile
-size_t _primes[] = {
-  11, 17, 29, 43, 67, 101, 151, 227, 347, 521, 787, 1181, 1777, 2671, 4007,
-  6011, 9029, 13553, 20333, 30509, 45763, 68659, 103001, 154501, 231779, 347671,
-  521519, 782297, 1173463, 1760203, 2640317, 3960497, 5940761, 8911141, 13366711,
-  20050081, 30075127, 45112693, 67669079, 101503627, 152255461, 228383273,
-  342574909, 513862367, 770793589, SIZE_MAX,
-};
+/**
+ * @brief Number of keys hashed and prefetched together by the batch routines.
+ */
+# define BATCH 16
 
 /**
- * @brief Structure for rehashing hash table.
+ * @brief Setwords of the occupancy set of a bucket array of prime index
+ * <tt>i</tt>.
  */
-typedef struct {
-  hashtabs_t t;    ///< hash table being rehashed
-  void *hash_arg;  ///< argument to user provided reentrant hashing function
-  void *queue_arg; ///< argument to user defined reentrant compare function
-} rehash_t;
+# define OCCWORDS(i) _SETWORDSNEEDED(_primes[i])
+
+/**
+ * @brief Lookups kept in flight by the interleaved finds, by default and at
+ * most.
+ */
+# define INFLIGHT 16
+# define MAXINFLIGHT 64
+
+/**
+ * @brief Link of a hash table bucket.
+ *
+ * Buckets are ordered by hash value so that a search stops as soon as it passes
+ * the hash of the data being looked for. Data with equal hash values are ordered
+ * by the user provided compare function.
+ */
+typedef struct node_t {
+  void *x;             ///< pointer to data
+  uint64_t hash;       ///< hash value of data
+  struct node_t *next; ///< next link of bucket
+} node_t;
 
 /**
  * @brief <tt>hashtabs_t</tt> class object.
+ *
+ * While the table grows, the previous bucket array is kept in <tt>B</tt> and
+ * its buckets are moved into <tt>A</tt> a few at a time. Every element lives in
+ * exactly one of the two arrays.
+ *
+ * Each bucket array has an occupancy set holding the indices of its nonnull
+ * buckets, so that walks over every element skip empty buckets a setword at a
+ * time.
  */
 struct hashtabs_t {
   size_t size;               ///< number of elements in hash table
   size_t load;               ///< number of nonnull buckets
   size_t cap_index;          ///< index to prime array corr. to prime length
+  size_t maxload;            ///< elements per bucket triggering growth
+  size_t old_cap_index;      ///< prime index of bucket array being migrated
+  size_t migrate;            ///< next bucket of <tt>B</tt> to migrate
   hashtabs_data_cmp cmp;     ///< user defined compare function
   hashtabs_data_cmp_r cmp_r; ///< user defined reentrant compare function
   hashtabs_hash hash;        ///< user defined hashing function
   hashtabs_hash_r hash_r;    ///< user defined reentrant hashing function
-  queues_t *A;               ///< bucket array
+  node_t **A;                ///< bucket array
+  node_t **B;                ///< bucket array being migrated, if any
+  sets_t *occA;              ///< occupancy set of <tt>A</tt>
+  sets_t *occB;              ///< occupancy set of <tt>B</tt>
+  pools_t pool;              ///< pool of nodes, <tt>NULL</tt> if not pooled
+  blooms_t filter;           ///< filter of hash values, <tt>NULL</tt> if none
+  allocators_t al;           ///< allocator of the hash table
+# if ENABLE_COUNTERS
+  size_t inserts;            ///< number of inserts
+  size_t insert_cmps;        ///< compare calls made by inserts
+  size_t finds;              ///< number of finds and removes
+  size_t find_cmps;          ///< compare calls made by finds
+# endif
 };
 
-static inline
-size_t _get_cap_index(size_t n)
-{
-  size_t i;
-  for ( i = 0; i < NPRIMES && n >= _primes[i]; i++ );
-  return i;
-}
+_Static_assert(offsetof(struct hashtabs_t, size) == 0,
+               "inline hashtabs_size reads the first member");
+
+_Static_assert(offsetof(node_t, x) == 0,
+               "the link of a cursor is led by the pointer to its element");
 
 uint64_t hashtabs_stdhash(const void *_a, const void *_n)
 {
@@ -66,151 +117,950 @@ uint64_t hashtabs_stdhash(const void *_a, const void *_n)
 
 hashtabs_t hashtabs_new(hashtabs_data_cmp cmp, hashtabs_data_cmp_r cmp_r,
                         hashtabs_hash hash, hashtabs_hash_r hash_r, size_t n)
+{
+  return hashtabs_new_alloc(cmp, cmp_r, hash, hash_r, n, &allocators_std);
+}
+
+hashtabs_t hashtabs_new_alloc(hashtabs_data_cmp cmp, hashtabs_data_cmp_r cmp_r,
+                              hashtabs_hash hash, hashtabs_hash_r hash_r,
+                              size_t n, const allocators_t *al)
 {
   hashtabs_t t;
-  t = (hashtabs_t)malloc(sizeof(*t));
+  t = (hashtabs_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
   t->cap_index = _get_cap_index(n);
   t->size = 0;
   t->load = 0;
+  t->maxload = HASHTABS_MAXLOAD;
+  t->old_cap_index = 0;
+  t->migrate = 0;
   t->cmp = cmp;
   t->cmp_r = cmp_r;
   t->hash = hash;
   t->hash_r = hash_r;
-  t->A = (queues_t*)calloc(_primes[t->cap_index], sizeof(queues_t));
+  t->A = (node_t**)_acalloc(al, _primes[t->cap_index], sizeof(node_t*));
+  t->B = NULL;
+  t->occA = (sets_t*)_acalloc(al, OCCWORDS(t->cap_index), sizeof(sets_t));
+  t->occB = NULL;
+  t->pool = NULL;
+  t->filter = NULL;
+# if ENABLE_COUNTERS
+  t->inserts = t->insert_cmps = t->finds = t->find_cmps = 0;
+# endif
   return t;
 }
 
-void hashtabs_insert(hashtabs_t t, const void *x)
+hashtabs_t hashtabs_new_pooled(hashtabs_data_cmp cmp, hashtabs_data_cmp_r cmp_r,
+                               hashtabs_hash hash, hashtabs_hash_r hash_r,
+                               size_t n)
+{
+  hashtabs_t t = hashtabs_new(cmp, cmp_r, hash, hash_r, n);
+  t->pool = pools_new_alloc(sizeof(node_t), 0, &t->al);
+  return t;
+}
+
+static inline
+node_t *_alloc(hashtabs_t t)
+{
+  if ( t->pool != NULL ) return (node_t*)pools_alloc(t->pool);
+  return (node_t*)_amalloc(&t->al, sizeof(node_t));
+}
+
+static inline
+void _release(hashtabs_t t, node_t *n)
+{
+  if ( t->pool != NULL ) pools_release(t->pool, n);
+  else _afree(&t->al, n);
+}
+
+static inline
+int _cmp(hashtabs_t t, const void *x, const void *y, void *queue_arg, int r)
+{
+  COUNTS_ADD(cmps, 1);
+  return r ? t->cmp_r(x, y, queue_arg) : t->cmp(x, y);
+}
+
+static inline
+uint64_t _hash(hashtabs_t t, const void *x, const void *hash_arg, int r)
+{
+  COUNTS_ADD(hashes, 1);
+  return r ? t->hash_r(x, hash_arg) : t->hash(x);
+}
+
+/*
+ * link of bucket p at which data x of hash h sits or would be inserted; *found
+ * tells which
+ */
+static
+node_t **_search(hashtabs_t t, node_t **p, const void *x, uint64_t h,
+                 void *queue_arg, int r, int *found, size_t *cmps)
 {
-  uint64_t val = t->hash(x) % _primes[t->cap_index];
-  if ( t->A[val] == NULL ) {
+  int c;
+# if ENABLE_COUNTERS
+  size_t k = 0;
+# endif
+  (void)cmps;
+  *found = 0;
+  for ( ; *p != NULL && (*p)->hash < h; p = &(*p)->next ) COUNTS(k++);
+  for ( ; *p != NULL && (*p)->hash == h; p = &(*p)->next, COUNTS(k++) )
+    if ( (COUNTS((*cmps)++), c = _cmp(t, x, (*p)->x, queue_arg, r)) <= 0 ) {
+      *found = c == 0;
+      break;
+    }
+  COUNTS_CHAIN(k);
+  return p;
+}
+
+/* link n into the bucket array of t by its stored hash */
+static
+void _link(hashtabs_t t, node_t *n)
+{
+  size_t i = _reduce(n->hash, t->cap_index);
+  node_t **p = &t->A[i];
+  if ( *p == NULL ) {
     t->load++;
-    t->A[val] = queues_new(t->cmp, t->cmp_r);
+    _ADDELEMENT(t->occA, i);
   }
-  queues_enqueu(t->A[val], x);
-  t->size++;
+  /* equal hashes always come from one old bucket, already in order */
+  for ( ; *p != NULL && (*p)->hash <= n->hash; p = &(*p)->next );
+  n->next = *p;
+  *p = n;
 }
 
-void hashtabs_insert_r(hashtabs_t t, const void *x,
-                       const void *hash_arg, void *queues_arg)
+/* move every link of bucket *p into the bucket array of t */
+static
+void _relink(hashtabs_t t, node_t **p)
 {
-  uint64_t val = t->hash_r(x, hash_arg) % _primes[t->cap_index];
-  if ( t->A[val] == NULL ) {
+  node_t *n, *next;
+  if ( (n = *p) == NULL ) return;
+  t->load--;
+  for ( ; n != NULL; n = next ) {
+    next = n->next;
+    _link(t, n);
+  }
+  *p = NULL;
+}
+
+/* move every element of old bucket i into the new bucket array */
+static inline
+void _migrate_bucket(hashtabs_t t, size_t i)
+{
+  _relink(t, &t->B[i]);
+  _DELELEMENT(t->occB, i);
+}
+
+static
+void _migrate(hashtabs_t t, size_t n)
+{
+  if ( t->B == NULL ) return;
+  for ( ; n > 0 && t->migrate < _primes[t->old_cap_index]; n--, t->migrate++ )
+    _migrate_bucket(t, t->migrate);
+  if ( t->migrate < _primes[t->old_cap_index] ) return;
+  _afree(&t->al, t->B);
+  _afree(&t->al, t->occB);
+  t->B = NULL;
+  t->occB = NULL;
+}
+
+/* start migrating to the next prime length if the load is exceeded */
+static
+void _grow(hashtabs_t t)
+{
+  if ( t->B != NULL || t->maxload == 0 || t->cap_index + 1 >= NPRIMES ) return;
+  if ( t->size <= t->maxload * _primes[t->cap_index] ) return;
+  size_t n = _primes[t->cap_index + 1] * sizeof(node_t*);
+  size_t m = OCCWORDS(t->cap_index + 1) * sizeof(sets_t);
+  node_t **A = (node_t**)t->al.alloc(n, t->al.ctx);
+  if ( A == NULL ) return;
+  sets_t *occ = (sets_t*)t->al.alloc(m, t->al.ctx);
+  if ( occ == NULL ) {
+    t->al.free(A, t->al.ctx);
+    return;
+  }
+  COUNTS_ADD(mallocs, 2);
+  memset(A, 0, n);
+  memset(occ, 0, m);
+  t->B = t->A;
+  t->A = A;
+  t->occB = t->occA;
+  t->occA = occ;
+  t->old_cap_index = t->cap_index;
+  t->cap_index++;
+  t->migrate = 0;
+  COUNTS_EVENT(COUNTERS_REHASH, _primes[t->old_cap_index],
+               _primes[t->cap_index]);
+}
+
+/*
+ * Inserts x unless equal data is in the table. Returns the data in the table,
+ * *inserted, if inserted is not NULL, telling whether it is x.
+ */
+static
+void *_insert(hashtabs_t t, const void *x, uint64_t h, void *queue_arg, int r,
+              int *inserted)
+{
+  node_t **p, *n;
+  int found;
+  COUNTS_OBJ(t, inserts, 1);
+  _migrate(t, MIGRATE_STEP);
+  if ( t->B != NULL ) _migrate_bucket(t, _reduce(h, t->old_cap_index));
+  size_t i = _reduce(h, t->cap_index);
+  p = &t->A[i];
+  if ( *p == NULL ) {
     t->load++;
-    t->A[val] = queues_new(t->cmp, t->cmp_r);
+    _ADDELEMENT(t->occA, i);
+  }
+  else {
+    p = _search(t, p, x, h, queue_arg, r, &found, COUNTS_PTR(t, insert_cmps));
+    if ( found ) {
+      if ( inserted != NULL ) *inserted = 0;
+      return (*p)->x;
+    }
   }
-  queues_enqueu_r(t->A[val], x, queues_arg);
+  n = _alloc(t);
+  n->x = (void*)x;
+  n->hash = h;
+  n->next = *p;
+  *p = n;
   t->size++;
+  if ( t->filter != NULL ) blooms_add(t->filter, h);
+  _grow(t);
+  if ( inserted != NULL ) *inserted = 1;
+  return (void*)x;
 }
 
-void *hashtabs_remove(hashtabs_t t, const void *_x)
+void hashtabs_insert(hashtabs_t t, const void *x)
 {
-  void *x;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (x = queues_remove(t->A[i], _x)) != NULL ) {
-      t->size--;
-      if ( queues_size(t->A[i]) == 0 ) t->load--;
-      return x;
-    }
-  return NULL;
+  (void)_insert(t, x, _hash(t, x, NULL, 0), NULL, 0, NULL);
+}
+
+void hashtabs_insert_r(hashtabs_t t, const void *x,
+                       const void *hash_arg, void *queue_arg)
+{
+  (void)_insert(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1, NULL);
+}
+
+void *hashtabs_find_or_insert(hashtabs_t t, const void *x, int *inserted)
+{
+  return _insert(t, x, _hash(t, x, NULL, 0), NULL, 0, inserted);
 }
 
-void *hashtabs_remove_r(hashtabs_t t, const void *_x, void *queue_arg)
+void *hashtabs_find_or_insert_r(hashtabs_t t, const void *x,
+                                const void *hash_arg, void *queue_arg,
+                                int *inserted)
 {
+  return _insert(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1, inserted);
+}
+
+/* link holding data equal to x or NULL; *bucket is set to its bucket */
+static
+node_t **_find(hashtabs_t t, const void *x, uint64_t h, void *queue_arg, int r,
+               node_t ***bucket)
+{
+  node_t **p;
+  int found;
+  COUNTS_OBJ(t, finds, 1);
+  /* a miss of the filter leaves the buckets untouched */
+  if ( t->filter != NULL && blooms_contains(t->filter, h) < 0 ) return NULL;
+  _migrate(t, MIGRATE_STEP);
+  *bucket = &t->A[_reduce(h, t->cap_index)];
+  p = _search(t, *bucket, x, h, queue_arg, r, &found, COUNTS_PTR(t, find_cmps));
+  if ( found ) return p;
+  if ( t->B == NULL ) return NULL;
+  *bucket = &t->B[_reduce(h, t->old_cap_index)];
+  p = _search(t, *bucket, x, h, queue_arg, r, &found, COUNTS_PTR(t, find_cmps));
+  return found ? p : NULL;
+}
+
+static
+void *_remove(hashtabs_t t, const void *_x, uint64_t h, void *queue_arg, int r)
+{
+  node_t **p, **bucket, *n;
   void *x;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (x = queues_remove_r(t->A[i], _x, queue_arg)) != NULL ) {
-      t->size--;
-      if ( queues_size(t->A[i]) == 0 ) t->load--;
-      return x;
+  if ( (p = _find(t, _x, h, queue_arg, r, &bucket)) == NULL ) return NULL;
+  n = *p;
+  x = n->x;
+  *p = n->next;
+  _release(t, n);
+  t->size--;
+  if ( *bucket == NULL ) {
+    t->load--;
+    size_t i = _reduce(h, t->cap_index);
+    if ( bucket == &t->A[i] ) _DELELEMENT(t->occA, i);
+    else _DELELEMENT(t->occB, _reduce(h, t->old_cap_index));
+  }
+  return x;
+}
+
+void *hashtabs_remove(hashtabs_t t, const void *x)
+{
+  return _remove(t, x, _hash(t, x, NULL, 0), NULL, 0);
+}
+
+void *hashtabs_remove_r(hashtabs_t t, const void *x,
+                        const void *hash_arg, void *queue_arg)
+{
+  return _remove(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1);
+}
+
+/*
+ * unlink and release every link of the nonnull buckets of A, of occupancy set
+ * occ, whose data passes the sweep
+ */
+static
+size_t _remove_if_buckets(hashtabs_t t, node_t **A, sets_t *occ, size_t m,
+                          const sweeps_t *s)
+{
+  size_t i, k = 0;
+  node_t **p, *n;
+  _FOREACHELEMENT(i, occ, m) {
+    for ( p = &A[i]; (n = *p) != NULL; ) {
+      if ( !_sweep_test(s, n->x) ) {
+        p = &n->next;
+        continue;
+      }
+      *p = n->next;
+      _sweep_dispose(s, n->x);
+      _release(t, n);
+      k++;
+    }
+    if ( A[i] == NULL ) {
+      t->load--;
+      _DELELEMENT(occ, i);
     }
-  return NULL;
+  }
+  return k;
+}
+
+static
+size_t _remove_if(hashtabs_t t, const sweeps_t *s)
+{
+  size_t k;
+  if ( t == NULL ) return 0;
+  k = _remove_if_buckets(t, t->A, t->occA, OCCWORDS(t->cap_index), s);
+  if ( t->B != NULL )
+    k += _remove_if_buckets(t, t->B, t->occB, OCCWORDS(t->old_cap_index), s);
+  t->size -= k;
+  return k;
+}
+
+size_t hashtabs_remove_if(hashtabs_t t, int pred(const void *x),
+                          void dispose(void *x))
+{
+  sweeps_t s = { pred, NULL, dispose, NULL, NULL };
+  return _remove_if(t, &s);
+}
+
+size_t hashtabs_remove_if_r(hashtabs_t t, int pred(const void *x, void *y),
+                            void dispose(void *x, void *y), void *y)
+{
+  sweeps_t s = { NULL, pred, NULL, dispose, y };
+  return _remove_if(t, &s);
 }
 
 void *hashtabs_find(hashtabs_t t, const void *x)
 {
-  void *ptr;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (ptr = queues_find(t->A[i], x)) != NULL ) return ptr;
-  return NULL;
+  node_t **p, **bucket;
+  p = _find(t, x, _hash(t, x, NULL, 0), NULL, 0, &bucket);
+  return p == NULL ? NULL : (*p)->x;
+}
+
+void *hashtabs_find_r(hashtabs_t t, const void *x,
+                      const void *hash_arg, void *queue_arg)
+{
+  node_t **p, **bucket;
+  p = _find(t, x, _hash(t, x, hash_arg, 1), queue_arg, 1, &bucket);
+  return p == NULL ? NULL : (*p)->x;
+}
+
+/* hash keys x[0..n-1] into h and prefetch their buckets, then their first links */
+static
+void _prefetch(hashtabs_t t, const void *const *x, size_t n, uint64_t *h,
+               const void *hash_arg, int r)
+{
+  size_t i;
+  for ( i = 0; i < n; i++ ) {
+    h[i] = _hash(t, x[i], hash_arg, r);
+    __builtin_prefetch(&t->A[_reduce(h[i], t->cap_index)]);
+  }
+  for ( i = 0; i < n; i++ )
+    __builtin_prefetch(t->A[_reduce(h[i], t->cap_index)]);
+}
+
+static
+void _insert_batch(hashtabs_t t, const void *const *x, size_t n,
+                   const void *hash_arg, void *queue_arg, int r)
+{
+  uint64_t h[BATCH];
+  for ( size_t i = 0, m; i < n; i += m ) {
+    m = n - i < BATCH ? n - i : BATCH;
+    _prefetch(t, x + i, m, h, hash_arg, r);
+    for ( size_t j = 0; j < m; j++ )
+      (void)_insert(t, x[i + j], h[j], queue_arg, r, NULL);
+  }
+}
+
+void hashtabs_insert_batch(hashtabs_t t, const void *const *x, size_t n)
+{
+  _insert_batch(t, x, n, NULL, NULL, 0);
+}
+
+void hashtabs_insert_batch_r(hashtabs_t t, const void *const *x, size_t n,
+                             const void *hash_arg, void *queue_arg)
+{
+  _insert_batch(t, x, n, hash_arg, queue_arg, 1);
+}
+
+static
+size_t _find_batch(hashtabs_t t, const void *const *x, void **out, size_t n,
+                   const void *hash_arg, void *queue_arg, int r)
+{
+  uint64_t h[BATCH];
+  node_t **p, **bucket;
+  size_t found = 0;
+  for ( size_t i = 0, m; i < n; i += m ) {
+    m = n - i < BATCH ? n - i : BATCH;
+    _prefetch(t, x + i, m, h, hash_arg, r);
+    for ( size_t j = 0; j < m; j++ ) {
+      p = _find(t, x[i + j], h[j], queue_arg, r, &bucket);
+      out[i + j] = p == NULL ? NULL : (*p)->x;
+      found += p != NULL;
+    }
+  }
+  return found;
+}
+
+size_t hashtabs_find_batch(hashtabs_t t, const void *const *x, void **out,
+                           size_t n)
+{
+  return _find_batch(t, x, out, n, NULL, NULL, 0);
+}
+
+size_t hashtabs_find_batch_r(hashtabs_t t, const void *const *x, void **out,
+                             size_t n, const void *hash_arg, void *queue_arg)
+{
+  return _find_batch(t, x, out, n, hash_arg, queue_arg, 1);
+}
+
+/*
+ * interleaved finds
+ */
+
+/**
+ * @brief Stages of an interleaved lookup: the bucket or link prefetched next
+ * is read by the following step.
+ */
+enum { SLOT, LINK };
+
+/**
+ * @brief State of a lookup in flight.
+ */
+typedef struct {
+  size_t i;          ///< index of key
+  const void *x;     ///< key
+  uint64_t h;        ///< hash value of key
+  int stage;         ///< <tt>SLOT</tt> or <tt>LINK</tt>
+  int old;           ///< the lookup has passed on to <tt>B</tt>
+  node_t **slot;     ///< bucket being read, at stage <tt>SLOT</tt>
+  node_t *n;         ///< link being read, at stage <tt>LINK</tt>
+} lookup_t;
+
+/* the lookup l misses in A: on to B if growing, else it ends */
+static inline
+int _lookup_pass(hashtabs_t t, lookup_t *l, void **out)
+{
+  if ( l->old || t->B == NULL ) {
+    out[l->i] = NULL;
+    return 0;
+  }
+  l->old = 1;
+  l->stage = SLOT;
+  l->slot = &t->B[_reduce(l->h, t->old_cap_index)];
+  __builtin_prefetch(l->slot);
+  return 1;
+}
+
+static inline
+int _lookup_link(hashtabs_t t, lookup_t *l, node_t *n, void **out)
+{
+  if ( n == NULL ) return _lookup_pass(t, l, out);
+  l->stage = LINK;
+  l->n = n;
+  __builtin_prefetch(n);
+  return 1;
+}
+
+/* begin a lookup of key i at x; 0 if it ended at once */
+static inline
+int _lookup_begin(hashtabs_t t, lookup_t *l, size_t i, const void *x,
+                  const void *hash_arg, int r, void **out)
+{
+  COUNTS_OBJ(t, finds, 1);
+  l->i = i;
+  l->x = x;
+  l->h = _hash(t, x, hash_arg, r);
+  if ( t->filter != NULL && blooms_contains(t->filter, l->h) < 0 ) {
+    out[i] = NULL;
+    return 0;
+  }
+  l->old = 0;
+  l->stage = SLOT;
+  l->slot = &t->A[_reduce(l->h, t->cap_index)];
+  __builtin_prefetch(l->slot);
+  return 1;
+}
+
+/* one step of lookup l; 0 once it has ended */
+static inline
+int _lookup_step(hashtabs_t t, lookup_t *l, void *queue_arg, int r, void **out)
+{
+  node_t *n;
+  int c;
+  if ( l->stage == SLOT ) return _lookup_link(t, l, *l->slot, out);
+  n = l->n;
+  if ( n->hash < l->h ) return _lookup_link(t, l, n->next, out);
+  if ( n->hash == l->h ) {
+    COUNTS_OBJ(t, find_cmps, 1);
+    if ( (c = _cmp(t, l->x, n->x, queue_arg, r)) == 0 ) {
+      out[l->i] = n->x;
+      return 0;
+    }
+    if ( c > 0 ) return _lookup_link(t, l, n->next, out);
+  }
+  return _lookup_pass(t, l, out);
+}
+
+static
+size_t _find_interleaved(hashtabs_t t, arrays_t a, void **out, size_t width,
+                         const void *hash_arg, void *queue_arg, int r)
+{
+  lookup_t s[MAXINFLIGHT];
+  size_t n = arrays_nmem(a), size = arrays_size(a), next = 0, live = 0, k;
+  size_t found = 0;
+  const char *x = n ? (const char*)arrays_at(a, 0) : NULL;
+  if ( width == 0 ) width = INFLIGHT;
+  if ( width > MAXINFLIGHT ) width = MAXINFLIGHT;
+  while ( live < width && next < n ) {
+    if ( _lookup_begin(t, &s[live], next, x + next * size, hash_arg, r, out) )
+      live++;
+    next++;
+  }
+  while ( live > 0 )
+    for ( k = 0; k < live; ) {
+      if ( _lookup_step(t, &s[k], queue_arg, r, out) ) {
+        k++;
+        continue;
+      }
+      found += out[s[k].i] != NULL;
+      /* the next key that does not end at once takes the place of s[k] */
+      while ( next < n
+              && !_lookup_begin(t, &s[k], next, x + next * size, hash_arg, r,
+                                out) )
+        next++;
+      if ( next < n ) {
+        next++;
+        k++;
+      }
+      else s[k] = s[--live];
+    }
+  return found;
+}
+
+size_t hashtabs_find_interleaved(hashtabs_t t, arrays_t a, void **out,
+                                 size_t width)
+{
+  return _find_interleaved(t, a, out, width, NULL, NULL, 0);
+}
+
+size_t hashtabs_find_interleaved_r(hashtabs_t t, arrays_t a, void **out,
+                                   size_t width, const void *hash_arg,
+                                   void *queue_arg)
+{
+  return _find_interleaved(t, a, out, width, hash_arg, queue_arg, 1);
+}
+
+# if CONTAINERS_THREADS
+/*
+ * bulk build
+ */
+
+/**
+ * @brief Counts of the buckets of one part of a bulk build.
+ */
+typedef struct {
+  size_t size;               ///< elements linked
+  size_t load;               ///< buckets made nonnull
+  size_t cmps;               ///< compare calls made
+} part_t;
+
+/**
+ * @brief Shared state of a bulk build.
+ *
+ * The keys are cut into <tt>k</tt> chunks, and the buckets into <tt>k</tt>
+ * parts of <tt>per</tt> buckets, a multiple of the setword size so that no two
+ * parts share a setword of the occupancy set.
+ */
+typedef struct {
+  hashtabs_t t;              ///< table being built
+  const char *x;             ///< keys
+  size_t size;               ///< size of keys
+  size_t n;                  ///< number of keys
+  size_t k;                  ///< number of chunks, and of parts
+  size_t per;                ///< buckets of a part
+  const void *hash_arg;      ///< argument to reentrant hash function
+  void *queue_arg;           ///< argument to reentrant compare function
+  int r;                     ///< reentrant functions are used
+  uint64_t *h;               ///< hash value of each key
+  size_t *at;                ///< keys of chunk c in part p, then their places
+  size_t *perm;              ///< keys in order of part
+  part_t *parts;             ///< counts of each part
+} bulk_t;
+
+/* part of the bucket of hash value h */
+static inline
+size_t _part(const bulk_t *b, uint64_t h)
+{
+  return _reduce(h, b->t->cap_index) / b->per;
 }
 
-void *hashtabs_find_r(hashtabs_t t, const void *x, void *queue_arg)
+/* hash the keys of chunk c, counting them by part */
+static
+void _bulk_hash(workers_t w, size_t c, void *y)
+{
+  bulk_t *b = (bulk_t*)y;
+  size_t lo = c * b->n / b->k, hi = (c + 1) * b->n / b->k;
+  size_t *at = b->at + c * b->k;
+  (void)w;
+  for ( size_t i = lo; i < hi; i++ ) {
+    b->h[i] = _hash(b->t, b->x + i * b->size, b->hash_arg, b->r);
+    at[_part(b, b->h[i])]++;
+  }
+}
+
+/* place the keys of chunk c in the order of their parts */
+static
+void _bulk_scatter(workers_t w, size_t c, void *y)
 {
-  void *ptr;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( (ptr = queues_find_r(t->A[i], x, queue_arg)) != NULL ) return ptr;
-  return NULL;
+  bulk_t *b = (bulk_t*)y;
+  size_t lo = c * b->n / b->k, hi = (c + 1) * b->n / b->k;
+  size_t *at = b->at + c * b->k;
+  (void)w;
+  for ( size_t i = lo; i < hi; i++ ) b->perm[at[_part(b, b->h[i])]++] = i;
+}
+
+/* link the keys of part p into its buckets, in the order of the keys */
+static
+void _bulk_link(workers_t w, size_t p, void *y)
+{
+  bulk_t *b = (bulk_t*)y;
+  hashtabs_t t = b->t;
+  size_t last = (b->k - 1) * b->k;
+  size_t lo = p ? b->at[last + p - 1] : 0, hi = b->at[last + p];
+  part_t c = { 0, 0, 0 };
+  (void)w;
+  for ( size_t j = lo; j < hi; j++ ) {
+    const void *x = b->x + b->perm[j] * b->size;
+    uint64_t h = b->h[b->perm[j]];
+    size_t i = _reduce(h, t->cap_index);
+    node_t **q = &t->A[i];
+    int found;
+    if ( *q == NULL ) {
+      c.load++;
+      _ADDELEMENT(t->occA, i);
+    }
+    else {
+      q = _search(t, q, x, h, b->queue_arg, b->r, &found, &c.cmps);
+      if ( found ) continue;
+    }
+    node_t *n = _alloc(t);
+    n->x = (void*)x;
+    n->hash = h;
+    n->next = *q;
+    *q = n;
+    c.size++;
+  }
+  b->parts[p] = c;
+}
+
+static
+hashtabs_t _bulk(hashtabs_t t, arrays_t a, const void *hash_arg,
+                 void *queue_arg, int r, workers_t w)
+{
+  size_t n = arrays_nmem(a), k, cap = _primes[t->cap_index];
+  if ( n == 0 ) return t;
+  k = SPLIT * workers_count(w);
+  bulk_t b = { t, (const char*)arrays_at(a, 0), arrays_size(a), n, k,
+               (cap + k * _WORDSIZE - 1) / (k * _WORDSIZE) * _WORDSIZE,
+               hash_arg, queue_arg, r, NULL, NULL, NULL, NULL };
+  b.h = (uint64_t*)_amalloc(&t->al, n * sizeof(uint64_t));
+  b.at = (size_t*)_acalloc(&t->al, k * k, sizeof(size_t));
+  b.perm = (size_t*)_amalloc(&t->al, n * sizeof(size_t));
+  b.parts = (part_t*)_amalloc(&t->al, k * sizeof(part_t));
+  _spread(w, k, _bulk_hash, &b);
+  /* counts to places: part by part, and chunk by chunk within a part */
+  for ( size_t p = 0, off = 0; p < k; p++ )
+    for ( size_t c = 0; c < k; c++ ) {
+      size_t m = b.at[c * k + p];
+      b.at[c * k + p] = off;
+      off += m;
+    }
+  _spread(w, k, _bulk_scatter, &b);
+  _spread(w, k, _bulk_link, &b);
+  for ( size_t p = 0; p < k; p++ ) {
+    t->size += b.parts[p].size;
+    t->load += b.parts[p].load;
+    COUNTS_OBJ(t, insert_cmps, b.parts[p].cmps);
+  }
+  COUNTS_OBJ(t, inserts, n);
+  _afree(&t->al, b.h);
+  _afree(&t->al, b.at);
+  _afree(&t->al, b.perm);
+  _afree(&t->al, b.parts);
+  return t;
+}
+
+hashtabs_t hashtabs_new_bulk(hashtabs_data_cmp cmp, hashtabs_data_cmp_r cmp_r,
+                             hashtabs_hash hash, hashtabs_hash_r hash_r,
+                             arrays_t a, workers_t w)
+{
+  hashtabs_t t = hashtabs_new(cmp, cmp_r, hash, hash_r, arrays_nmem(a));
+  return _bulk(t, a, NULL, NULL, 0, w);
+}
+
+hashtabs_t hashtabs_new_bulk_r(hashtabs_data_cmp cmp, hashtabs_data_cmp_r cmp_r,
+                               hashtabs_hash hash, hashtabs_hash_r hash_r,
+                               arrays_t a, const void *hash_arg,
+                               void *queue_arg, workers_t w)
+{
+  hashtabs_t t = hashtabs_new(cmp, cmp_r, hash, hash_r, arrays_nmem(a));
+  return _bulk(t, a, hash_arg, queue_arg, 1, w);
+}
+# endif
+
+/* apply to the data of the nonnull buckets of A, of occupancy set occ */
+static
+int _map_buckets(node_t **A, const sets_t *occ, size_t m,
+                 int apply(void **x))
+{
+  size_t i;
+  _FOREACHELEMENT(i, occ, m)
+    for ( node_t *tmp = A[i]; tmp != NULL; tmp = tmp->next )
+      if ( apply(&tmp->x) < 0 ) return -1;
+  return 1;
+}
+
+static
+int _map_buckets_r(node_t **A, const sets_t *occ, size_t m,
+                   int apply(void **x, void *queue_arg), void *queue_arg)
+{
+  size_t i;
+  _FOREACHELEMENT(i, occ, m)
+    for ( node_t *tmp = A[i]; tmp != NULL; tmp = tmp->next )
+      if ( apply(&tmp->x, queue_arg) < 0 ) return -1;
+  return 1;
 }
 
 int hashtabs_map(hashtabs_t t, int apply(void **x))
 {
   if ( t == NULL ) return 1;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( queues_map(t->A[i], apply) < 0 ) return -1;
-  return 1;
+  if ( _map_buckets(t->A, t->occA, OCCWORDS(t->cap_index), apply) < 0 )
+    return -1;
+  if ( t->B == NULL ) return 1;
+  return _map_buckets(t->B, t->occB, OCCWORDS(t->old_cap_index), apply);
 }
 
 int hashtabs_map_r(hashtabs_t t,
                    int apply(void **x, void *queue_arg), void *queue_arg)
 {
   if ( t == NULL ) return 1;
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    if ( queues_map_r(t->A[i], apply, queue_arg) < 0 ) return -1;
+  if ( _map_buckets_r(t->A, t->occA, OCCWORDS(t->cap_index), apply,
+                      queue_arg) < 0 )
+    return -1;
+  if ( t->B == NULL ) return 1;
+  return _map_buckets_r(t->B, t->occB, OCCWORDS(t->old_cap_index), apply,
+                        queue_arg);
+}
+
+/* cursor at the first element of the first nonnull bucket from i on */
+static
+int _scan(hashtabs_iter_t *it, size_t i)
+{
+  hashtabs_t t = it->t;
+  if ( i >= it->end ) {
+    it->node = NULL;
+    return -1;
+  }
+  size_t w = _SETWD(i), m = _SETWD(it->end - 1) + 1;
+  setwords_t x = t->occA[w] & (~(setwords_t)0 << _SETBT(i));
+  while ( x == 0 ) {
+    if ( ++w >= m ) {
+      it->node = NULL;
+      return -1;
+    }
+    x = t->occA[w];
+  }
+  it->bucket = _TIMESWORDSIZE(w) + _FIRSTBITNZ(x);
+  if ( it->bucket >= it->end ) {
+    it->node = NULL;
+    return -1;
+  }
+  node_t *n = t->A[it->bucket];
+  it->node = n;
+  it->x = n->x;
   return 1;
 }
 
+int hashtabs_iterinit(hashtabs_t t, hashtabs_iter_t *it)
+{
+  return hashtabs_iterrange(t, it, 0, _primes[t->cap_index]);
+}
+
+int hashtabs_iterrange(hashtabs_t t, hashtabs_iter_t *it, size_t lo, size_t hi)
+{
+  _migrate(t, SIZE_MAX);
+  it->t = t;
+  it->end = hi;
+  return _scan(it, lo);
+}
+
+int hashtabs_iternext(hashtabs_iter_t *it)
+{
+  node_t *n = ((node_t*)it->node)->next;
+  if ( n == NULL ) return _scan(it, it->bucket + 1);
+  it->node = n;
+  it->x = n->x;
+  return 1;
+}
+
+/* free the links of the nonnull buckets of A, then A and its occupancy set */
+static
+void _free_buckets(hashtabs_t t, node_t **A, sets_t *occ, size_t m)
+{
+  node_t *tmp, *next;
+  size_t i;
+  _FOREACHELEMENT(i, occ, m)
+    for ( tmp = A[i]; tmp != NULL; tmp = next ) {
+      next = tmp->next;
+      _afree(&t->al, tmp);
+    }
+  _afree(&t->al, A);
+  _afree(&t->al, occ);
+}
+
 void hashtabs_free(hashtabs_t *t)
 {
   if ( *t == NULL ) return;
-  for ( size_t i = 0; i < _primes[(*t)->cap_index]; i++ )
-    queues_free((queues_t*)(&((*t)->A[i])));
-  free((queues_t*)(*t)->A);
-  free(*t);
+  allocators_t al = (*t)->al;
+  if ( (*t)->pool != NULL ) {
+    /* the nodes go with their slabs */
+    pools_free(&(*t)->pool);
+    _afree(&al, (*t)->A);
+    _afree(&al, (*t)->B);
+    _afree(&al, (*t)->occA);
+    _afree(&al, (*t)->occB);
+  }
+  else {
+    _free_buckets(*t, (*t)->A, (*t)->occA, OCCWORDS((*t)->cap_index));
+    if ( (*t)->B != NULL )
+      _free_buckets(*t, (*t)->B, (*t)->occB, OCCWORDS((*t)->old_cap_index));
+  }
+  _afree(&al, *t);
   *t = NULL;
 }
 
+/* free the links of the nonnull buckets of A, leaving every bucket empty */
+static
+void _clear_buckets(hashtabs_t t, node_t **A, sets_t *occ, size_t m)
+{
+  node_t *tmp, *next;
+  size_t i;
+  _FOREACHELEMENT(i, occ, m) {
+    if ( t->pool == NULL )
+      for ( tmp = A[i]; tmp != NULL; tmp = next ) {
+        next = tmp->next;
+        _afree(&t->al, tmp);
+      }
+    A[i] = NULL;
+  }
+  _EMPTYSET(occ, m);
+}
+
+void hashtabs_clear(hashtabs_t t)
+{
+  if ( t->pool != NULL ) pools_clear(t->pool);
+  _clear_buckets(t, t->A, t->occA, OCCWORDS(t->cap_index));
+  if ( t->B != NULL ) {
+    _clear_buckets(t, t->B, t->occB, OCCWORDS(t->old_cap_index));
+    _afree(&t->al, t->B);
+    _afree(&t->al, t->occB);
+    t->B = NULL;
+    t->occB = NULL;
+  }
+  t->size = 0;
+  t->load = 0;
+}
+
 size_t hashtabs_capacity(hashtabs_t t)
 {
   return _primes[t->cap_index];
 }
 
+/* copy the links of the nonnull buckets of A into the bucket array of s */
 static
-int _rehash(void **x, void *_y)
+void _copy_buckets(hashtabs_t s, node_t **A, const sets_t *occ, size_t m)
 {
-  rehash_t *y = (rehash_t*)_y;
-  hashtabs_insert(y->t, *x);
-  return 1;
+  node_t *n;
+  size_t i;
+  _FOREACHELEMENT(i, occ, m)
+    for ( node_t *tmp = A[i]; tmp != NULL; tmp = tmp->next ) {
+      n = _alloc(s);
+      n->x = tmp->x;
+      n->hash = tmp->hash;
+      _link(s, n);
+    }
 }
 
 hashtabs_t hashtabs_rehash(hashtabs_t t)
 {
-  rehash_t rehash = {
-    .t = hashtabs_new(t->cmp, t->cmp_r, t->hash, t->hash_r, _primes[t->cap_index]),
-    .hash_arg = NULL, .queue_arg = NULL,
-  };
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    (void)queues_map_r(t->A[i], _rehash, &rehash);
-  return rehash.t;
+  hashtabs_t s = hashtabs_new_alloc(t->cmp, t->cmp_r, t->hash, t->hash_r,
+                                    _primes[t->cap_index], &t->al);
+  if ( t->pool != NULL ) s->pool = pools_new_alloc(sizeof(node_t), 0, &s->al);
+  s->maxload = t->maxload;
+  s->size = t->size;
+  s->filter = t->filter;
+  _copy_buckets(s, t->A, t->occA, OCCWORDS(t->cap_index));
+  if ( t->B != NULL )
+    _copy_buckets(s, t->B, t->occB, OCCWORDS(t->old_cap_index));
+  COUNTS_EVENT(COUNTERS_REHASH, _primes[t->cap_index], _primes[s->cap_index]);
+  return s;
 }
 
-static
-int _rehash_r(void **x, void *_y)
+hashtabs_t hashtabs_rehash_r(hashtabs_t t, void *hash_arg, void *queue_arg)
 {
-  rehash_t *y = (rehash_t*)_y;
-  hashtabs_insert_r(y->t, *x, y->hash_arg, y->queue_arg);
-  return 1;
+  (void)hash_arg;
+  (void)queue_arg;
+  return hashtabs_rehash(t);
 }
 
-hashtabs_t hashtabs_rehash_r(hashtabs_t t, void *hash_arg, void *queue_arg)
+void hashtabs_resize(hashtabs_t t, size_t n)
 {
-  rehash_t rehash = {
-    .t = hashtabs_new(t->cmp, t->cmp_r, t->hash, t->hash_r, _primes[t->cap_index]),
-    .hash_arg = hash_arg, .queue_arg = queue_arg
-  };
-  for ( size_t i = 0; i < _primes[t->cap_index]; i++ )
-    (void)queues_map_r(t->A[i], _rehash_r, &rehash);
-  return rehash.t;
+  node_t **A = t->A, **B = t->B;
+  sets_t *occA = t->occA, *occB = t->occB;
+  size_t cap_index = t->cap_index, i;
+  t->cap_index = _get_cap_index(n);
+  t->A = (node_t**)_acalloc(&t->al, _primes[t->cap_index], sizeof(node_t*));
+  t->occA = (sets_t*)_acalloc(&t->al, OCCWORDS(t->cap_index), sizeof(sets_t));
+  t->B = NULL;
+  t->occB = NULL;
+  _FOREACHELEMENT(i, occA, OCCWORDS(cap_index)) _relink(t, &A[i]);
+  _afree(&t->al, A);
+  _afree(&t->al, occA);
+  if ( B != NULL ) {
+    _FOREACHELEMENT(i, occB, OCCWORDS(t->old_cap_index)) _relink(t, &B[i]);
+    _afree(&t->al, B);
+    _afree(&t->al, occB);
+  }
+  COUNTS_EVENT(COUNTERS_REHASH, _primes[cap_index], _primes[t->cap_index]);
 }
 
 size_t hashtabs_size(hashtabs_t t)
@@ -218,7 +1068,115 @@ size_t hashtabs_size(hashtabs_t t)
   return t->size;
 }
 
+size_t hashtabs_memory_usage(hashtabs_t t, size_t *payload)
+{
+  size_t n = sizeof(*t) + _primes[t->cap_index] * sizeof(node_t*)
+    + OCCWORDS(t->cap_index) * sizeof(sets_t);
+  if ( t->B != NULL )
+    n += _primes[t->old_cap_index] * sizeof(node_t*)
+      + OCCWORDS(t->old_cap_index) * sizeof(sets_t);
+  n += t->pool != NULL ? pools_bytes(t->pool) : t->size * sizeof(node_t);
+  if ( payload != NULL ) *payload = t->size * sizeof(void*);
+  return n;
+}
+
 size_t hashtabs_loadfactor(hashtabs_t t)
 {
   return t->load == 0 ? 0 : t->size / t->load;
 }
+
+void hashtabs_setmaxload(hashtabs_t t, size_t maxload)
+{
+  t->maxload = maxload;
+}
+
+/* add the stored hash values of the nonnull buckets of A to filter f */
+static
+void _filter_buckets(blooms_t f, node_t **A, const sets_t *occ, size_t m)
+{
+  size_t i;
+  _FOREACHELEMENT(i, occ, m)
+    for ( node_t *tmp = A[i]; tmp != NULL; tmp = tmp->next )
+      blooms_add(f, tmp->hash);
+}
+
+void hashtabs_setfilter(hashtabs_t t, blooms_t f)
+{
+  t->filter = f;
+  if ( f == NULL ) return;
+  _filter_buckets(f, t->A, t->occA, OCCWORDS(t->cap_index));
+  if ( t->B != NULL )
+    _filter_buckets(f, t->B, t->occB, OCCWORDS(t->old_cap_index));
+}
+
+/* copies of the data of buckets of A into x, and their hash values into h */
+static
+size_t _freeze_buckets(node_t **A, const sets_t *occ, size_t m, char *x,
+                       uint64_t *h, size_t k, size_t size)
+{
+  size_t i;
+  _FOREACHELEMENT(i, occ, m)
+    for ( node_t *tmp = A[i]; tmp != NULL; tmp = tmp->next, k++ ) {
+      memcpy(x + k * size, tmp->x, size);
+      h[k] = tmp->hash;
+    }
+  return k;
+}
+
+fhashtabs_t hashtabs_freeze(hashtabs_t t, size_t size)
+{
+  fhashtabs_t f;
+  char *x = (char*)_amalloc(&t->al, t->size * size + 1);
+  uint64_t *h = (uint64_t*)_amalloc(&t->al, (t->size + 1) * sizeof(uint64_t));
+  size_t k = _freeze_buckets(t->A, t->occA, OCCWORDS(t->cap_index), x, h, 0,
+                             size);
+  if ( t->B != NULL )
+    k = _freeze_buckets(t->B, t->occB, OCCWORDS(t->old_cap_index), x, h, k,
+                        size);
+  f = fhashtabs_new_alloc(t->cmp, t->cmp_r, t->hash, t->hash_r, x, h, k, size,
+                          &t->al);
+  _afree(&t->al, x);
+  _afree(&t->al, h);
+  return f;
+}
+
+int hashtabs_growing(hashtabs_t t)
+{
+  return t->B != NULL;
+}
+
+static
+void _stats_buckets(hashtabs_stats_t *s, node_t **A, size_t i, size_t n)
+{
+  size_t k;
+  for ( ; i < n; i++ ) {
+    k = 0;
+    for ( node_t *tmp = A[i]; tmp != NULL; tmp = tmp->next ) k++;
+    s->buckets++;
+    s->histogram[k < HASHTABS_HISTOGRAM ? k : HASHTABS_HISTOGRAM - 1]++;
+    if ( k == 0 ) s->empty++;
+    if ( k > s->max_chain ) s->max_chain = k;
+  }
+}
+
+void hashtabs_stats(hashtabs_t t, hashtabs_stats_t *s)
+{
+  memset(s, 0, sizeof(*s));
+  _stats_buckets(s, t->A, 0, _primes[t->cap_index]);
+  s->bytes = sizeof(*t) + _primes[t->cap_index] * sizeof(node_t*)
+    + OCCWORDS(t->cap_index) * sizeof(sets_t)
+    + (t->pool != NULL ? pools_bytes(t->pool) : t->size * sizeof(node_t));
+  if ( t->B != NULL ) {
+    _stats_buckets(s, t->B, t->migrate, _primes[t->old_cap_index]);
+    s->bytes += _primes[t->old_cap_index] * sizeof(node_t*)
+      + OCCWORDS(t->old_cap_index) * sizeof(sets_t);
+  }
+  if ( s->buckets > s->empty )
+    s->mean_chain = (double)t->size / (double)(s->buckets - s->empty);
+# if ENABLE_COUNTERS
+  s->inserts = t->inserts;
+  s->insert_cmps = t->insert_cmps;
+  s->finds = t->finds;
+  s->find_cmps = t->find_cmps;
+# endif
+}
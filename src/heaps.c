@@ -0,0 +1,262 @@
+/**
+ * @file heaps.c
+ * @brief Implementation of <tt>heaps_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <heaps.h>
+# include <stdint.h>
+# define COUNTS_KIND COUNTERS_HEAPS
+# include "allocs.h"
+
+# define NONE SIZE_MAX
+
+/**
+ * @brief Internal structure for <tt>heaps_t</tt> object.
+ */
+typedef struct {
+  void *x;   ///< pointer to data object
+  size_t id; ///< handle of the data object
+} heaps_entry_t;
+
+/**
+ * @brief <tt>heaps_t</tt> class object.
+ */
+struct heaps_t {
+  size_t size;            ///< number of elements in heap
+  size_t capacity;        ///< number of entries allocated
+  size_t ids;             ///< number of handles ever issued
+  size_t unused;          ///< head of list of released handles
+  heaps_data_cmp cmp;     ///< user provided compare function
+  heaps_data_cmp_r cmp_r; ///< user provided reentrant compare function
+  heaps_entry_t *e;       ///< heap ordered entries
+  size_t *pos;            ///< position in e of each handle
+  allocators_t al;        ///< allocator of the heap
+};
+
+heaps_t heaps_new(heaps_data_cmp cmp, heaps_data_cmp_r cmp_r)
+{
+  return heaps_new_alloc(cmp, cmp_r, &allocators_std);
+}
+
+heaps_t heaps_new_alloc(heaps_data_cmp cmp, heaps_data_cmp_r cmp_r,
+                        const allocators_t *al)
+{
+  if ( cmp == NULL && cmp_r == NULL ) error(1, errno, "cmp pointers null");
+  heaps_t h;
+  h = (heaps_t)_amalloc(al, sizeof(*h));
+  h->al = *al;
+  h->size = h->capacity = h->ids = 0;
+  h->unused = NONE;
+  h->cmp = cmp;
+  h->cmp_r = cmp_r;
+  h->e = NULL;
+  h->pos = NULL;
+  return h;
+}
+
+static inline
+int _cmp(heaps_t h, const void *x, const void *y, void *arg, int r)
+{
+  return r ? h->cmp_r(x, y, arg) : h->cmp(x, y);
+}
+
+/* make room for n entries; handles never outnumber entries allocated */
+static
+void _reserve(heaps_t h, size_t n)
+{
+  if ( n <= h->capacity ) return;
+  size_t c = h->capacity < 2 ? n + 1 : (3 * h->capacity) >> 1;
+  if ( c < n ) c = n;
+  h->e = (heaps_entry_t*)_arealloc(&h->al, h->e, c * sizeof(heaps_entry_t));
+  h->pos = (size_t*)_arealloc(&h->al, h->pos, c * sizeof(size_t));
+  h->capacity = c;
+}
+
+static inline
+size_t _id(heaps_t h)
+{
+  size_t id = h->unused;
+  if ( id == NONE ) return h->ids++;
+  h->unused = h->pos[id];
+  return id;
+}
+
+static inline
+void _place(heaps_t h, size_t i, heaps_entry_t e)
+{
+  h->e[i] = e;
+  h->pos[e.id] = i;
+}
+
+static
+void _up(heaps_t h, size_t i, void *arg, int r)
+{
+  heaps_entry_t e = h->e[i];
+  while ( i > 0 ) {
+    size_t p = (i - 1) / HEAPS_ARITY;
+    if ( _cmp(h, e.x, h->e[p].x, arg, r) >= 0 ) break;
+    _place(h, i, h->e[p]);
+    i = p;
+  }
+  _place(h, i, e);
+}
+
+static
+void _down(heaps_t h, size_t i, void *arg, int r)
+{
+  heaps_entry_t e = h->e[i];
+  for ( ;; ) {
+    size_t c = HEAPS_ARITY * i + 1, m, k;
+    if ( c >= h->size ) break;
+    m = c;
+    for ( k = c + 1; k < c + HEAPS_ARITY && k < h->size; k++ )
+      if ( _cmp(h, h->e[k].x, h->e[m].x, arg, r) < 0 ) m = k;
+    if ( _cmp(h, h->e[m].x, e.x, arg, r) >= 0 ) break;
+    _place(h, i, h->e[m]);
+    i = m;
+  }
+  _place(h, i, e);
+}
+
+static inline
+heaps_handle_t _push(heaps_t h, const void *x, void *arg, int r)
+{
+  _reserve(h, h->size + 1);
+  heaps_entry_t e = { (void*)x, _id(h) };
+  h->e[h->size++] = e;
+  _up(h, h->size - 1, arg, r);
+  return e.id;
+}
+
+heaps_handle_t heaps_push(heaps_t h, const void *x)
+{
+  return _push(h, x, NULL, 0);
+}
+
+heaps_handle_t heaps_push_r(heaps_t h, const void *x, void *y)
+{
+  return _push(h, x, y, 1);
+}
+
+/* remove entry at position i, releasing its handle */
+static inline
+void *_take(heaps_t h, size_t i, void *arg, int r)
+{
+  heaps_entry_t e = h->e[i];
+  h->pos[e.id] = h->unused;
+  h->unused = e.id;
+  if ( --h->size > i ) {
+    heaps_entry_t m = h->e[h->size];
+    _place(h, i, m);
+    _up(h, i, arg, r);
+    _down(h, h->pos[m.id], arg, r);
+  }
+  return e.x;
+}
+
+void *heaps_pop(heaps_t h)
+{
+  return h->size == 0 ? NULL : _take(h, 0, NULL, 0);
+}
+
+void *heaps_pop_r(heaps_t h, void *y)
+{
+  return h->size == 0 ? NULL : _take(h, 0, y, 1);
+}
+
+void *heaps_peek(heaps_t h)
+{
+  return h->size == 0 ? NULL : h->e[0].x;
+}
+
+void *heaps_get(heaps_t h, heaps_handle_t k)
+{
+  return h->e[h->pos[k]].x;
+}
+
+void heaps_decrease(heaps_t h, heaps_handle_t k)
+{
+  _up(h, h->pos[k], NULL, 0);
+}
+
+void heaps_decrease_r(heaps_t h, heaps_handle_t k, void *y)
+{
+  _up(h, h->pos[k], y, 1);
+}
+
+void heaps_update(heaps_t h, heaps_handle_t k)
+{
+  _up(h, h->pos[k], NULL, 0);
+  _down(h, h->pos[k], NULL, 0);
+}
+
+void heaps_update_r(heaps_t h, heaps_handle_t k, void *y)
+{
+  _up(h, h->pos[k], y, 1);
+  _down(h, h->pos[k], y, 1);
+}
+
+void *heaps_remove(heaps_t h, heaps_handle_t k)
+{
+  return _take(h, h->pos[k], NULL, 0);
+}
+
+void *heaps_remove_r(heaps_t h, heaps_handle_t k, void *y)
+{
+  return _take(h, h->pos[k], y, 1);
+}
+
+static
+void _heapify(heaps_t h, void **x, size_t n, void *arg, int r)
+{
+  size_t i, s = h->size;
+  _reserve(h, s + n);
+  for ( i = 0; i < n; i++ ) {
+    heaps_entry_t e = { x[i], _id(h) };
+    _place(h, s + i, e);
+  }
+  h->size += n;
+  /* sift down from the last parent; O(n) however many were already held */
+  if ( h->size > 1 )
+    for ( i = (h->size - 2) / HEAPS_ARITY + 1; i-- > 0; ) _down(h, i, arg, r);
+}
+
+void heaps_heapify(heaps_t h, void **x, size_t n)
+{
+  _heapify(h, x, n, NULL, 0);
+}
+
+void heaps_heapify_r(heaps_t h, void **x, size_t n, void *y)
+{
+  _heapify(h, x, n, y, 1);
+}
+
+int heaps_map(heaps_t h, int apply(void *x))
+{
+  for ( size_t i = 0; i < h->size; i++ )
+    if ( apply(h->e[i].x) < 0 ) return -1;
+  return 1;
+}
+
+int heaps_map_r(heaps_t h, int apply(void *x, void *y), void *y)
+{
+  for ( size_t i = 0; i < h->size; i++ )
+    if ( apply(h->e[i].x, y) < 0 ) return -1;
+  return 1;
+}
+
+void heaps_free(heaps_t *h)
+{
+  if ( h == NULL || *h == NULL ) return;
+  allocators_t al = (*h)->al;
+  _afree(&al, (*h)->e);
+  _afree(&al, (*h)->pos);
+  _afree(&al, *h);
+  *h = NULL;
+}
+
+size_t heaps_size(heaps_t h)
+{
+  return h->size;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file hyperloglogs.c
+ * @brief Implementation of <tt>hyperloglogs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <hyperloglogs.h>
+# include <bit_sets.h>
+# include <string.h>
+# include <math.h>
+# include "allocs.h"
+
+/**
+ * @brief <tt>hyperloglogs_t</tt> class object.
+ */
+struct hyperloglogs_t {
+  unsigned p;      ///< register index bits
+  size_t m;        ///< number of registers, <tt>2^p</tt>
+  uint8_t *M;      ///< registers
+  allocators_t al; ///< allocator of the sketch
+};
+
+hyperloglogs_t hyperloglogs_new(unsigned p)
+{
+  return hyperloglogs_new_alloc(p, &allocators_std);
+}
+
+hyperloglogs_t hyperloglogs_new_alloc(unsigned p, const allocators_t *al)
+{
+  hyperloglogs_t s;
+  s = (hyperloglogs_t)_amalloc(al, sizeof(*s));
+  s->al = *al;
+  s->p = p;
+  s->m = (size_t)1 << p;
+  s->M = (uint8_t*)_acalloc(al, s->m, sizeof(uint8_t));
+  return s;
+}
+
+void hyperloglogs_free(hyperloglogs_t *s)
+{
+  if ( *s == NULL ) return;
+  allocators_t al = (*s)->al;
+  _afree(&al, (*s)->M);
+  _afree(&al, *s);
+  *s = NULL;
+}
+
+void hyperloglogs_add(hyperloglogs_t s, uint64_t h)
+{
+  uint64_t w = h >> s->p;
+  /* rank of the first set bit, 64 - p + 1 if none */
+  uint8_t rank = (uint8_t)((w ? (unsigned)_FIRSTBITNZ(w) : 64 - s->p) + 1);
+  uint8_t *r = &s->M[h & (s->m - 1)];
+  if ( rank > *r ) *r = rank;
+}
+
+void hyperloglogs_merge(hyperloglogs_t d, hyperloglogs_t s)
+{
+  for ( size_t i = 0; i < d->m; i++ )
+    if ( s->M[i] > d->M[i] ) d->M[i] = s->M[i];
+}
+
+static
+double _estimate(hyperloglogs_t s)
+{
+  double m = (double)s->m, sum = 0, alpha;
+  size_t zeros = 0;
+  for ( size_t i = 0; i < s->m; i++ ) {
+    sum += ldexp(1.0, -(int)s->M[i]);
+    zeros += s->M[i] == 0;
+  }
+  switch ( s->p ) {
+  case 4: alpha = 0.673; break;
+  case 5: alpha = 0.697; break;
+  case 6: alpha = 0.709; break;
+  default: alpha = 0.7213 / (1 + 1.079 / m);
+  }
+  double e = alpha * m * m / sum;
+  /* linear counting is the better estimate while registers are empty */
+  if ( e <= 2.5 * m && zeros > 0 ) e = m * log(m / (double)zeros);
+  return e;
+}
+
+size_t hyperloglogs_estimate(hyperloglogs_t s)
+{
+  return (size_t)(_estimate(s) + 0.5);
+}
+
+size_t hyperloglogs_hint(hyperloglogs_t s)
+{
+  double e = _estimate(s);
+  return (size_t)(e * (1 + 3 * 1.04 / sqrt((double)s->m)) + 1);
+}
+
+void hyperloglogs_clear(hyperloglogs_t s)
+{
+  memset(s->M, 0, s->m);
+}
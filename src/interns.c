@@ -0,0 +1,155 @@
+/**
+ * @file interns.c
+ * @brief Implementation of <tt>interns_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <interns.h>
+# include <hashes.h>
+# include "allocs.h"
+
+/**
+ * @brief Seed of the hash of the strings.
+ */
+# define SEED 0x9e3779b97f4a7c15ULL
+
+/**
+ * @brief Initial number of slots, a power of two.
+ */
+# define SLOTS 16
+
+/**
+ * @brief Entry of a string.
+ */
+typedef struct {
+  uint64_t off;  ///< offset of string in arena
+  uint32_t len;  ///< number of bytes of string
+  uint32_t hash; ///< high half of the hash of string
+} entry_t;
+
+/**
+ * @brief <tt>interns_t</tt> class object.
+ */
+struct interns_t {
+  char *arena;     ///< strings, each followed by a null byte
+  size_t used;     ///< bytes of arena in use
+  size_t room;     ///< bytes of arena allocated
+  entry_t *e;      ///< entries, indexed by identifier
+  size_t n;        ///< number of strings
+  size_t ecap;     ///< number of entries allocated
+  uint64_t *slot;  ///< hash above identifier plus one, 0 if empty
+  size_t mask;     ///< number of slots less one
+  size_t payload;  ///< bytes of the strings
+  allocators_t al; ///< allocator of the table
+};
+
+interns_t interns_new(void)
+{
+  return interns_new_alloc(&allocators_std);
+}
+
+interns_t interns_new_alloc(const allocators_t *al)
+{
+  interns_t t;
+  t = (interns_t)_amalloc(al, sizeof(*t));
+  t->al = *al;
+  t->arena = NULL;
+  t->used = t->room = t->n = t->ecap = t->payload = 0;
+  t->e = NULL;
+  t->slot = (uint64_t*)_acalloc(al, SLOTS, sizeof(uint64_t));
+  t->mask = SLOTS - 1;
+  return t;
+}
+
+void interns_free(interns_t *t)
+{
+  if ( *t == NULL ) return;
+  allocators_t al = (*t)->al;
+  _afree(&al, (*t)->arena);
+  _afree(&al, (*t)->e);
+  _afree(&al, (*t)->slot);
+  _afree(&al, *t);
+  *t = NULL;
+}
+
+/* slot of the string of hash h, or the empty slot ending its probe */
+static inline
+size_t _probe(interns_t t, const void *s, size_t n, uint32_t h)
+{
+  size_t i = h & t->mask;
+  for ( ; t->slot[i] != 0; i = (i + 1) & t->mask ) {
+    if ( (uint32_t)(t->slot[i] >> 32) != h ) continue;
+    const entry_t *e = &t->e[(uint32_t)t->slot[i] - 1];
+    if ( e->len == n && memcmp(t->arena + e->off, s, n) == 0 ) return i;
+  }
+  return i;
+}
+
+/* twice the slots, refilled from the entries in order of identifier */
+static
+void _rehash(interns_t t)
+{
+  COUNTS_EVENT(COUNTERS_REHASH, t->mask + 1, 2 * (t->mask + 1));
+  _afree(&t->al, t->slot);
+  t->mask = 2 * t->mask + 1;
+  t->slot = (uint64_t*)_acalloc(&t->al, t->mask + 1, sizeof(uint64_t));
+  for ( size_t id = 0; id < t->n; id++ ) {
+    size_t i = t->e[id].hash & t->mask;
+    while ( t->slot[i] != 0 ) i = (i + 1) & t->mask;
+    t->slot[i] = (uint64_t)t->e[id].hash << 32 | (id + 1);
+  }
+}
+
+uint32_t interns_intern(interns_t t, const void *s, size_t n)
+{
+  uint32_t h = (uint32_t)(hashes_bytes(s, n, SEED) >> 32);
+  size_t i = _probe(t, s, n, h);
+  if ( t->slot[i] != 0 ) return (uint32_t)t->slot[i] - 1;
+  if ( t->used + n + 1 > t->room ) {
+    do t->room = t->room ? 2 * t->room : 4096;
+    while ( t->used + n + 1 > t->room );
+    t->arena = (char*)_arealloc(&t->al, t->arena, t->room);
+  }
+  if ( t->n == t->ecap ) {
+    t->ecap = t->ecap ? 2 * t->ecap : SLOTS;
+    t->e = (entry_t*)_arealloc(&t->al, t->e, t->ecap * sizeof(entry_t));
+  }
+  uint32_t id = (uint32_t)t->n++;
+  t->e[id] = (entry_t){ t->used, (uint32_t)n, h };
+  memcpy(t->arena + t->used, s, n);
+  t->arena[t->used + n] = '\0';
+  t->used += n + 1;
+  t->payload += n;
+  t->slot[i] = (uint64_t)h << 32 | (id + 1);
+  if ( 4 * t->n > 3 * (t->mask + 1) ) _rehash(t);
+  return id;
+}
+
+uint32_t interns_find(interns_t t, const void *s, size_t n)
+{
+  uint32_t h = (uint32_t)(hashes_bytes(s, n, SEED) >> 32);
+  size_t i = _probe(t, s, n, h);
+  return t->slot[i] != 0 ? (uint32_t)t->slot[i] - 1 : INTERNS_NONE;
+}
+
+const char *interns_str(interns_t t, uint32_t id)
+{
+  return t->arena + t->e[id].off;
+}
+
+size_t interns_len(interns_t t, uint32_t id)
+{
+  return t->e[id].len;
+}
+
+size_t interns_nmem(interns_t t)
+{
+  return t->n;
+}
+
+size_t interns_memory_usage(interns_t t, size_t *payload)
+{
+  if ( payload != NULL ) *payload = t->payload;
+  return sizeof(*t) + t->room + t->ecap * sizeof(entry_t)
+    + (t->mask + 1) * sizeof(uint64_t);
+}
@@ -0,0 +1,303 @@
+/**
+ * @file parallelarrays.c
+ * @brief Implementation of the parallel routines of <tt>arrays_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <arrays.h>
+# include <workers.h>
+# include <stdatomic.h>
+# include <errno.h>
+# include <error.h>
+# define COUNTS_KIND COUNTERS_ARRAYS
+# include "ranges.h"
+
+/**
+ * @brief Compare function of a sort, reentrant or not.
+ */
+typedef struct {
+  int (*cmp)(const void*, const void*);          ///< compare function
+  int (*cmp_r)(const void*, const void*, void*); ///< reentrant compare function
+  void *z;                                       ///< argument to cmp_r
+} order_t;
+
+static inline
+int _cmp(const order_t *o, const void *x, const void *y)
+{
+  return o->cmp != NULL ? o->cmp(x, y) : o->cmp_r(x, y, o->z);
+}
+
+static
+void *_malloc(size_t n)
+{
+  void *p;
+  if ( (p = malloc(n)) == NULL ) error(1, errno, "malloc failure");
+  return p;
+}
+
+/*
+ * map
+ */
+
+/**
+ * @brief Shared state of a parallel map.
+ */
+typedef struct {
+  char *x;                         ///< data array
+  size_t size;                     ///< size of elements
+  int (*apply)(void*);             ///< user function
+  int (*apply_r)(void*, void*);    ///< reentrant user function
+  void *y;                         ///< argument to apply_r
+} map_t;
+
+static
+int _map_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  map_t *m = (map_t*)y;
+  (void)w;
+  for ( size_t i = lo; i < hi; i++ ) {
+    char *p = m->x + i * m->size;
+    if ( (m->apply != NULL ? m->apply(p) : m->apply_r(p, m->y)) < 0 )
+      return -1;
+  }
+  return 1;
+}
+
+static
+int _map(arrays_t a, map_t *m, workers_t w)
+{
+  size_t n = arrays_nmem(a);
+  if ( n == 0 ) return 1;
+  m->x = (char*)arrays_at(a, 0);
+  m->size = arrays_size(a);
+  return _ranges(w, n, _map_range, m);
+}
+
+int arrays_map_parallel(arrays_t a, int apply(void *x), workers_t w)
+{
+  map_t m = { .apply = apply, .apply_r = NULL, .y = NULL };
+  return _map(a, &m, w);
+}
+
+int arrays_map_parallel_r(arrays_t a, int apply(void *x, void *y), void *y,
+                          workers_t w)
+{
+  map_t m = { .apply = NULL, .apply_r = apply, .y = y };
+  return _map(a, &m, w);
+}
+
+/*
+ * reduce
+ */
+
+/**
+ * @brief Shared state of a parallel reduction of an array.
+ */
+typedef struct {
+  char *x;                         ///< data array
+  size_t size;                     ///< size of elements
+  reduce_t r;                      ///< fold and merge functions
+} fold_t;
+
+static
+int _reduce_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  fold_t *f = (fold_t*)y;
+  void *acc = _reduce_acc(&f->r, w);
+  for ( size_t i = lo; i < hi; i++ )
+    if ( _reduce_fold(&f->r, acc, f->x + i * f->size) < 0 ) return -1;
+  return 1;
+}
+
+static
+int _reduce(arrays_t a, fold_t *f, void *acc, workers_t w)
+{
+  size_t n = arrays_nmem(a);
+  if ( n == 0 ) return 1;
+  f->x = (char*)arrays_at(a, 0);
+  f->size = arrays_size(a);
+  _reduce_begin(&f->r, w, acc);
+  int ret = _ranges(w, n, _reduce_range, f);
+  _reduce_end(&f->r, w, acc);
+  return ret;
+}
+
+int arrays_reduce_parallel(arrays_t a, int fold(void *acc, const void *x),
+                           void merge(void *acc, const void *part), void *acc,
+                           size_t size, workers_t w)
+{
+  fold_t f = { .r = { .fold = fold, .merge = merge, .size = size } };
+  return _reduce(a, &f, acc, w);
+}
+
+int arrays_reduce_parallel_r(arrays_t a,
+                             int fold(void *acc, const void *x, void *y),
+                             void merge(void *acc, const void *part, void *y),
+                             void *acc, size_t size, void *y, workers_t w)
+{
+  fold_t f = { .r = { .fold_r = fold, .merge_r = merge, .y = y,
+                      .size = size } };
+  return _reduce(a, &f, acc, w);
+}
+
+/*
+ * sort
+ */
+
+/**
+ * @brief Shared state of a parallel sort.
+ */
+typedef struct {
+  size_t size;                     ///< size of elements
+  size_t grain;                    ///< elements merged without splitting
+  order_t o;                       ///< compare function
+  void *round;                     ///< root task of the current round
+} sort_t;
+
+/**
+ * @brief Task of a parallel sort: sort one run, or merge two runs into out.
+ */
+typedef struct {
+  char *a;                         ///< first run, or run being sorted
+  size_t na;                       ///< length of first run
+  char *b;                         ///< second run, <tt>NULL</tt> if sorting
+  size_t nb;                       ///< length of second run
+  char *out;                       ///< destination of merge
+} job_t;
+
+static
+job_t *_job(char *a, size_t na, char *b, size_t nb, char *out)
+{
+  job_t *j = (job_t*)_malloc(sizeof(job_t));
+  *j = (job_t) { a, na, b, nb, out };
+  return j;
+}
+
+/* first element of the n at x not less than key */
+static
+size_t _lower(const sort_t *s, const char *x, size_t n, const char *key)
+{
+  size_t lo = 0, hi = n;
+  while ( lo < hi ) {
+    size_t mid = lo + (hi - lo) / 2;
+    if ( _cmp(&s->o, x + mid * s->size, key) < 0 ) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static
+void _merge(const sort_t *s, const job_t *j)
+{
+  const char *a = j->a, *ea = j->a + j->na * s->size;
+  const char *b = j->b, *eb = j->b + j->nb * s->size;
+  char *out = j->out;
+  while ( a < ea && b < eb ) {
+    if ( _cmp(&s->o, b, a) < 0 ) memcpy(out, b, s->size), b += s->size;
+    else memcpy(out, a, s->size), a += s->size;
+    out += s->size;
+  }
+  memcpy(out, a, ea - a);
+  memcpy(out + (ea - a), b, eb - b);
+}
+
+static
+void _sort_task(workers_t w, void *x, void *y)
+{
+  job_t *j = (job_t*)x;
+  sort_t *s = (sort_t*)y;
+  if ( x == s->round ) {
+    /* root of a round: spawn the jobs of the round */
+    for ( job_t **r = (job_t**)x; *r != NULL; r++ ) workers_spawn(w, *r);
+    return;
+  }
+  if ( j->b == NULL ) {
+    if ( s->o.cmp != NULL ) qsort(j->a, j->na, s->size, s->o.cmp);
+    else qsort_r(j->a, j->na, s->size, s->o.cmp_r, s->o.z);
+  }
+  else if ( j->na + j->nb <= s->grain ) _merge(s, j);
+  else {
+    /* split the longer run at its middle and the other run at that value */
+    size_t ma, mb;
+    if ( j->na >= j->nb ) {
+      ma = j->na / 2;
+      mb = _lower(s, j->b, j->nb, j->a + ma * s->size);
+    }
+    else {
+      mb = j->nb / 2;
+      ma = _lower(s, j->a, j->na, j->b + mb * s->size);
+    }
+    workers_spawn(w, _job(j->a + ma * s->size, j->na - ma,
+                          j->b + mb * s->size, j->nb - mb,
+                          j->out + (ma + mb) * s->size));
+    workers_spawn(w, _job(j->a, ma, j->b, mb, j->out));
+  }
+  free(j);
+}
+
+static
+void _sort(arrays_t a, const order_t *o, workers_t w)
+{
+  size_t n = arrays_nmem(a), size = arrays_size(a), k, i;
+  if ( n < 2 ) return;
+  sort_t s = { size, _grain(w, n), *o, NULL };
+  k = (n + s.grain - 1) / s.grain;
+  if ( k > SPLIT * workers_count(w) ) k = SPLIT * workers_count(w);
+  char *src = (char*)arrays_at(a, 0), *dst, *tmp;
+  if ( k < 2 ) {
+    _sort_task(w, _job(src, n, NULL, 0, NULL), &s);
+    return;
+  }
+
+  size_t *b = (size_t*)_malloc((k + 1) * sizeof(size_t));
+  job_t **jobs = (job_t**)_malloc((k + 1) * sizeof(job_t*));
+  for ( i = 0; i <= k; i++ ) b[i] = i * n / k;
+  for ( i = 0; i < k; i++ )
+    jobs[i] = _job(src + b[i] * size, b[i + 1] - b[i], NULL, 0, NULL);
+  jobs[k] = NULL;
+  s.round = jobs;
+  workers_run(w, _sort_task, jobs, &s);
+
+  /* merge runs pairwise, going back and forth between array and buffer */
+  dst = tmp = (char*)_malloc(n * size);
+  while ( k > 1 ) {
+    size_t m = 0;
+    for ( i = 0; i + 1 < k; i += 2 ) {
+      jobs[m++] = _job(src + b[i] * size, b[i + 1] - b[i],
+                       src + b[i + 1] * size, b[i + 2] - b[i + 1],
+                       dst + b[i] * size);
+      b[i / 2] = b[i];
+    }
+    if ( k & 1 ) {
+      memcpy(dst + b[k - 1] * size, src + b[k - 1] * size,
+             (b[k] - b[k - 1]) * size);
+      b[k / 2] = b[k - 1];
+    }
+    b[(k + 1) / 2] = n;
+    k = (k + 1) / 2;
+    jobs[m] = NULL;
+    workers_run(w, _sort_task, jobs, &s);
+    char *t = src;
+    src = dst;
+    dst = t;
+  }
+  if ( src != (char*)arrays_at(a, 0) ) memcpy(arrays_at(a, 0), src, n * size);
+  free(tmp);
+  free(jobs);
+  free(b);
+}
+
+void arrays_sort_parallel(arrays_t a, int cmp(const void *x, const void *y),
+                          workers_t w)
+{
+  order_t o = { cmp, NULL, NULL };
+  _sort(a, &o, w);
+}
+
+void arrays_sort_parallel_r(arrays_t a,
+                            int cmp(const void *x, const void *y, void *z),
+                            void *z, workers_t w)
+{
+  order_t o = { NULL, cmp, z };
+  _sort(a, &o, w);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file parallelhashtabs.c
+ * @brief Implementation of the parallel routines of <tt>hashtabs_t</tt> and
+ * <tt>dhashtabs_t</tt> classes.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <hashtabs.h>
+# include <deephashtabs.h>
+# include <workers.h>
+# include "ranges.h"
+
+/*
+ * The buckets are split into ranges visited with the range cursors of the
+ * tables. hashtabs_iterinit is called first, on the calling thread, so that
+ * no bucket migration is left for the cursors of the workers to do.
+ */
+
+/**
+ * @brief Shared state of a parallel map of a hash table.
+ */
+typedef struct {
+  void *t;                         ///< hash table
+  int (*apply)(void**);            ///< user function
+  int (*apply_r)(void**, void*);   ///< reentrant user function
+  void *y;                         ///< argument to apply_r
+} map_t;
+
+static inline
+int _apply(const map_t *m, void **x)
+{
+  return m->apply != NULL ? m->apply(x) : m->apply_r(x, m->y);
+}
+
+static
+int _hmap_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  map_t *m = (map_t*)y;
+  hashtabs_iter_t it;
+  (void)w;
+  for ( int r = hashtabs_iterrange((hashtabs_t)m->t, &it, lo, hi); r > 0;
+        r = hashtabs_iternext(&it) )
+    if ( _apply(m, (void**)it.node) < 0 ) return -1;
+  return 1;
+}
+
+static
+int _hmap(hashtabs_t t, map_t *m, workers_t w)
+{
+  hashtabs_iter_t it;
+  if ( hashtabs_iterinit(t, &it) < 0 ) return 1;
+  return _ranges(w, hashtabs_capacity(t), _hmap_range, m);
+}
+
+int hashtabs_map_parallel(hashtabs_t t, int apply(void **x), workers_t w)
+{
+  map_t m = { .t = t, .apply = apply };
+  return _hmap(t, &m, w);
+}
+
+int hashtabs_map_parallel_r(hashtabs_t t, int apply(void **x, void *y),
+                            void *y, workers_t w)
+{
+  map_t m = { .t = t, .apply_r = apply, .y = y };
+  return _hmap(t, &m, w);
+}
+
+static
+int _dmap_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  map_t *m = (map_t*)y;
+  dhashtabs_iter_t it;
+  (void)w;
+  for ( int r = dhashtabs_iterrange((dhashtabs_t)m->t, &it, lo, hi); r > 0;
+        r = dhashtabs_iternext(&it) ) {
+    void *x = dhashtabs_iterget(&it);
+    if ( _apply(m, &x) < 0 ) return -1;
+  }
+  return 1;
+}
+
+int dhashtabs_map_parallel(dhashtabs_t t, int apply(void **x), workers_t w)
+{
+  map_t m = { .t = t, .apply = apply };
+  return _ranges(w, dhashtabs_capacity(t), _dmap_range, &m);
+}
+
+int dhashtabs_map_parallel_r(dhashtabs_t t, int apply(void **x, void *y),
+                             void *y, workers_t w)
+{
+  map_t m = { .t = t, .apply_r = apply, .y = y };
+  return _ranges(w, dhashtabs_capacity(t), _dmap_range, &m);
+}
+
+/**
+ * @brief Shared state of a parallel reduction of a hash table.
+ */
+typedef struct {
+  void *t;                         ///< hash table
+  reduce_t r;                      ///< fold and merge functions
+} fold_t;
+
+static
+int _hreduce_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  fold_t *f = (fold_t*)y;
+  hashtabs_iter_t it;
+  void *acc = _reduce_acc(&f->r, w);
+  for ( int r = hashtabs_iterrange((hashtabs_t)f->t, &it, lo, hi); r > 0;
+        r = hashtabs_iternext(&it) )
+    if ( _reduce_fold(&f->r, acc, hashtabs_iterget(&it)) < 0 ) return -1;
+  return 1;
+}
+
+static
+int _hreduce(hashtabs_t t, fold_t *f, void *acc, workers_t w)
+{
+  hashtabs_iter_t it;
+  if ( hashtabs_iterinit(t, &it) < 0 ) return 1;
+  _reduce_begin(&f->r, w, acc);
+  int ret = _ranges(w, hashtabs_capacity(t), _hreduce_range, f);
+  _reduce_end(&f->r, w, acc);
+  return ret;
+}
+
+int hashtabs_reduce_parallel(hashtabs_t t, int fold(void *acc, const void *x),
+                             void merge(void *acc, const void *part),
+                             void *acc, size_t size, workers_t w)
+{
+  fold_t f = { .t = t, .r = { .fold = fold, .merge = merge, .size = size } };
+  return _hreduce(t, &f, acc, w);
+}
+
+int hashtabs_reduce_parallel_r(hashtabs_t t,
+                               int fold(void *acc, const void *x, void *y),
+                               void merge(void *acc, const void *part, void *y),
+                               void *acc, size_t size, void *y, workers_t w)
+{
+  fold_t f = { .t = t, .r = { .fold_r = fold, .merge_r = merge, .y = y,
+                              .size = size } };
+  return _hreduce(t, &f, acc, w);
+}
+
+static
+int _dreduce_range(workers_t w, size_t lo, size_t hi, void *y)
+{
+  fold_t *f = (fold_t*)y;
+  dhashtabs_iter_t it;
+  void *acc = _reduce_acc(&f->r, w);
+  for ( int r = dhashtabs_iterrange((dhashtabs_t)f->t, &it, lo, hi); r > 0;
+        r = dhashtabs_iternext(&it) )
+    if ( _reduce_fold(&f->r, acc, dhashtabs_iterget(&it)) < 0 ) return -1;
+  return 1;
+}
+
+static
+int _dreduce(dhashtabs_t t, fold_t *f, void *acc, workers_t w)
+{
+  if ( dhashtabs_size(t) == 0 ) return 1;
+  _reduce_begin(&f->r, w, acc);
+  int ret = _ranges(w, dhashtabs_capacity(t), _dreduce_range, f);
+  _reduce_end(&f->r, w, acc);
+  return ret;
+}
+
+int dhashtabs_reduce_parallel(dhashtabs_t t, int fold(void *acc, const void *x),
+                              void merge(void *acc, const void *part),
+                              void *acc, size_t size, workers_t w)
+{
+  fold_t f = { .t = t, .r = { .fold = fold, .merge = merge, .size = size } };
+  return _dreduce(t, &f, acc, w);
+}
+
+int dhashtabs_reduce_parallel_r(dhashtabs_t t,
+                                int fold(void *acc, const void *x, void *y),
+                                void merge(void *acc, const void *part,
+                                           void *y),
+                                void *acc, size_t size, void *y, workers_t w)
+{
+  fold_t f = { .t = t, .r = { .fold_r = fold, .merge_r = merge, .y = y,
+                              .size = size } };
+  return _dreduce(t, &f, acc, w);
+}
@@ -0,0 +1,285 @@
+/**
+ * @file pipes.c
+ * @brief Implementation of <tt>pipes_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <pipes.h>
+# include "allocs.h"
+
+/**
+ * @brief Stage of a pipeline.
+ */
+typedef struct {
+  void *(*map)(const void*, void*);          ///< map function, if any
+  void *(*map_r)(const void*, void*, void*); ///< reentrant map function
+  int (*pred)(const void*);                  ///< filter predicate, if any
+  int (*pred_r)(const void*, void*);         ///< reentrant filter predicate
+  void *y;                                   ///< argument to reentrant stage
+  void *out;                                 ///< buffer of map stage
+} stage_t;
+
+/**
+ * @brief <tt>pipes_t</tt> class object.
+ */
+struct pipes_t {
+  pipes_source first; ///< gives first element of source
+  pipes_source next;  ///< gives next element of source
+  void *src;          ///< argument to <tt>first</tt> and <tt>next</tt>
+  void *c;            ///< container of a built in source
+  union {
+    struct {
+      char *x;        ///< next element of array
+      char *end;      ///< end of array
+      size_t size;    ///< size of elements of array
+    } a;
+    queues_iter_t q;
+    stacks_iter_t s;
+    hashtabs_iter_t t;
+    dhashtabs_iter_t d;
+  } it;               ///< cursor of a built in source
+  size_t nstages;     ///< number of stages
+  size_t capacity;    ///< capacity of stage array
+  stage_t *stages;    ///< stages, in order
+  allocators_t al;    ///< allocator of the pipeline
+};
+
+pipes_t pipes_new(pipes_source first, pipes_source next, void *src)
+{
+  pipes_t p;
+  p = (pipes_t)_amalloc(&allocators_std, sizeof(*p));
+  p->al = allocators_std;
+  p->first = first;
+  p->next = next;
+  p->src = src;
+  p->c = NULL;
+  p->nstages = 0;
+  p->capacity = 0;
+  p->stages = NULL;
+  return p;
+}
+
+static
+int _arrays_next(void *_p, void **x)
+{
+  pipes_t p = (pipes_t)_p;
+  if ( p->it.a.x == p->it.a.end ) return -1;
+  *x = p->it.a.x;
+  p->it.a.x += p->it.a.size;
+  return 1;
+}
+
+static
+int _arrays_first(void *_p, void **x)
+{
+  pipes_t p = (pipes_t)_p;
+  arrays_t a = (arrays_t)p->c;
+  size_t n = arrays_nmem(a);
+  p->it.a.size = arrays_size(a);
+  p->it.a.x = p->it.a.end = NULL;
+  if ( n ) {
+    p->it.a.x = (char*)arrays_at(a, 0);
+    p->it.a.end = p->it.a.x + n * p->it.a.size;
+  }
+  return _arrays_next(_p, x);
+}
+
+/**
+ * @brief Define the source functions of a container with cursors.
+ *
+ * @param[in] name Prefix of the cursor functions of the container.
+ * @param[in] f Member of the cursor union.
+ */
+# define CURSOR_SOURCE(name, f)                                       \
+  static                                                              \
+  int _##name##_first(void *_p, void **x)                             \
+  {                                                                   \
+    pipes_t p = (pipes_t)_p;                                          \
+    if ( name##_iterinit((name##_t)p->c, &p->it.f) < 0 ) return -1;   \
+    *x = name##_iterget(&p->it.f);                                    \
+    return 1;                                                         \
+  }                                                                   \
+  static                                                              \
+  int _##name##_next(void *_p, void **x)                              \
+  {                                                                   \
+    pipes_t p = (pipes_t)_p;                                          \
+    if ( name##_iternext(&p->it.f) < 0 ) return -1;                   \
+    *x = name##_iterget(&p->it.f);                                    \
+    return 1;                                                         \
+  }                                                                   \
+  pipes_t pipes_new_##name(name##_t c)                                \
+  {                                                                   \
+    pipes_t p = pipes_new(_##name##_first, _##name##_next, NULL);     \
+    p->src = p;                                                       \
+    p->c = c;                                                         \
+    return p;                                                         \
+  }
+
+CURSOR_SOURCE(queues, q)
+CURSOR_SOURCE(stacks, s)
+CURSOR_SOURCE(hashtabs, t)
+CURSOR_SOURCE(dhashtabs, d)
+
+pipes_t pipes_new_arrays(arrays_t a)
+{
+  pipes_t p = pipes_new(_arrays_first, _arrays_next, NULL);
+  p->src = p;
+  p->c = a;
+  return p;
+}
+
+void pipes_free(pipes_t *p)
+{
+  if ( *p == NULL ) return;
+  allocators_t al = (*p)->al;
+  for ( size_t i = 0; i < (*p)->nstages; i++ )
+    _afree(&al, (*p)->stages[i].out);
+  _afree(&al, (*p)->stages);
+  _afree(&al, *p);
+  *p = NULL;
+}
+
+/* a new zeroed stage at the end of the pipeline */
+static
+stage_t *_stage(pipes_t p)
+{
+  if ( p->nstages == p->capacity ) {
+    p->capacity = p->capacity < 2 ? 4 : p->capacity + (p->capacity >> 1);
+    p->stages = (stage_t*)_arealloc(&p->al, p->stages,
+                                    p->capacity * sizeof(stage_t));
+  }
+  return (stage_t*)memset(p->stages + p->nstages++, 0, sizeof(stage_t));
+}
+
+void pipes_map(pipes_t p, void *f(const void *x, void *out), size_t size)
+{
+  stage_t *s = _stage(p);
+  s->map = f;
+  if ( size ) s->out = _amalloc(&p->al, size);
+}
+
+void pipes_map_r(pipes_t p, void *f(const void *x, void *out, void *y),
+                 size_t size, void *y)
+{
+  stage_t *s = _stage(p);
+  s->map_r = f;
+  s->y = y;
+  if ( size ) s->out = _amalloc(&p->al, size);
+}
+
+void pipes_filter(pipes_t p, int pred(const void *x))
+{
+  _stage(p)->pred = pred;
+}
+
+void pipes_filter_r(pipes_t p, int pred(const void *x, void *y), void *y)
+{
+  stage_t *s = _stage(p);
+  s->pred_r = pred;
+  s->y = y;
+}
+
+/*
+ * Takes each element of the source through every stage and hands the elements
+ * leaving the last stage to sink, stopping early if sink returns a negative
+ * int. Inlined into each run below, so that sink is called directly.
+ */
+static inline
+int _run(pipes_t p, int sink(void *ctx, const void *x), void *ctx)
+{
+  void *x;
+  const stage_t *end = p->stages + p->nstages;
+  for ( int r = p->first(p->src, &x); r > 0; r = p->next(p->src, &x) ) {
+    const stage_t *s;
+    for ( s = p->stages; s != end; s++ ) {
+      if ( s->map != NULL ) x = s->map(x, s->out);
+      else if ( s->map_r != NULL ) x = s->map_r(x, s->out, s->y);
+      else if ( (s->pred != NULL ? s->pred(x) : s->pred_r(x, s->y)) <= 0 )
+        break;
+    }
+    if ( s == end && sink(ctx, x) < 0 ) return -1;
+  }
+  return 1;
+}
+
+/**
+ * @brief Arguments of the sink of <tt>pipes_reduce</tt> and
+ * <tt>pipes_reduce_r</tt>.
+ */
+typedef struct {
+  int (*f)(void*, const void*);          ///< fold function
+  int (*f_r)(void*, const void*, void*); ///< reentrant fold function
+  void *acc;                             ///< accumulator
+  void *y;                               ///< argument to reentrant fold
+} fold_t;
+
+static
+int _fold(void *_c, const void *x)
+{
+  fold_t *c = (fold_t*)_c;
+  return c->f != NULL ? c->f(c->acc, x) : c->f_r(c->acc, x, c->y);
+}
+
+int pipes_reduce(pipes_t p, int f(void *acc, const void *x), void *acc)
+{
+  fold_t c = { f, NULL, acc, NULL };
+  return _run(p, _fold, &c);
+}
+
+int pipes_reduce_r(pipes_t p, int f(void *acc, const void *x, void *y),
+                   void *acc, void *y)
+{
+  fold_t c = { NULL, f, acc, y };
+  return _run(p, _fold, &c);
+}
+
+static
+int _count(void *n, const void *x)
+{
+  (void)x;
+  ++*(size_t*)n;
+  return 1;
+}
+
+size_t pipes_count(pipes_t p)
+{
+  size_t n = 0;
+  _run(p, _count, &n);
+  return n;
+}
+
+static
+int _push(void *a, const void *x)
+{
+  arrays_dynpush((arrays_t)a, x);
+  return 1;
+}
+
+void pipes_collect(pipes_t p, arrays_t a)
+{
+  _run(p, _push, a);
+}
+
+static
+int _insert(void *t, const void *x)
+{
+  hashtabs_insert((hashtabs_t)t, x);
+  return 1;
+}
+
+void pipes_collect_hashtabs(pipes_t p, hashtabs_t t)
+{
+  _run(p, _insert, t);
+}
+
+static
+int _dinsert(void *t, const void *x)
+{
+  dhashtabs_insert((dhashtabs_t)t, x);
+  return 1;
+}
+
+void pipes_collect_dhashtabs(pipes_t p, dhashtabs_t t)
+{
+  _run(p, _dinsert, t);
+}
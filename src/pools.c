@@ -0,0 +1,120 @@
+/**
+ * @file pools.c
+ * @brief Implementation of <tt>pools_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <pools.h>
+# define COUNTS_KIND COUNTERS_POOLS
+# include "allocs.h"
+
+/**
+ * @brief Header of slab, followed by its objects.
+ */
+typedef union slab_t {
+  union slab_t *next; ///< next slab of pool
+  max_align_t align;  ///< alignment of the objects following the header
+} slab_t;
+
+/**
+ * @brief <tt>pools_t</tt> class object.
+ */
+struct pools_t {
+  size_t size;     ///< size of objects, rounded up to pointer alignment
+  size_t n;        ///< number of objects per slab
+  size_t nmems;    ///< number of objects in use
+  size_t nslabs;   ///< number of slabs
+  void *free;      ///< free list of released objects
+  char *next;      ///< next unused object of current slab
+  char *end;       ///< end of current slab
+  slab_t *slabs;   ///< list of slabs, in order of allocation
+  slab_t *cur;     ///< slab <tt>next</tt> points into
+  allocators_t al; ///< allocator of the slabs
+};
+
+pools_t pools_new(size_t size, size_t n)
+{
+  return pools_new_alloc(size, n, &allocators_std);
+}
+
+pools_t pools_new_alloc(size_t size, size_t n, const allocators_t *al)
+{
+  pools_t p;
+  p = (pools_t)_amalloc(al, sizeof(*p));
+  p->al = *al;
+  if ( size < sizeof(void*) ) size = sizeof(void*);
+  p->size = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+  p->n = n != 0 ? n : POOLS_SLAB / p->size + (POOLS_SLAB < p->size);
+  p->nmems = 0;
+  p->nslabs = 0;
+  p->free = NULL;
+  p->next = p->end = NULL;
+  p->slabs = p->cur = NULL;
+  return p;
+}
+
+void *pools_alloc(pools_t p)
+{
+  void *x;
+  p->nmems++;
+  if ( (x = p->free) != NULL ) {
+    p->free = *(void**)x;
+    return x;
+  }
+  if ( p->next == p->end ) {
+    slab_t *s;
+    /* slabs past the current one are left over from before pools_clear */
+    if ( p->cur != NULL && p->cur->next != NULL ) s = p->cur->next;
+    else {
+      s = (slab_t*)_amalloc(&p->al, sizeof(slab_t) + p->n * p->size);
+      s->next = NULL;
+      if ( p->cur != NULL ) p->cur->next = s;
+      else p->slabs = s;
+      p->nslabs++;
+    }
+    p->cur = s;
+    p->next = (char*)(s + 1);
+    p->end = p->next + p->n * p->size;
+  }
+  x = p->next;
+  p->next += p->size;
+  return x;
+}
+
+void pools_release(pools_t p, void *x)
+{
+  *(void**)x = p->free;
+  p->free = x;
+  p->nmems--;
+}
+
+void pools_clear(pools_t p)
+{
+  p->nmems = 0;
+  p->free = NULL;
+  if ( (p->cur = p->slabs) == NULL ) return;
+  p->next = (char*)(p->cur + 1);
+  p->end = p->next + p->n * p->size;
+}
+
+void pools_free(pools_t *p)
+{
+  if ( *p == NULL ) return;
+  allocators_t al = (*p)->al;
+  for ( slab_t *s = (*p)->slabs, *next; s != NULL; s = next ) {
+    next = s->next;
+    _afree(&al, s);
+  }
+  _afree(&al, *p);
+  *p = NULL;
+}
+
+size_t pools_size(pools_t p)
+{
+  return p->nmems;
+}
+
+size_t pools_bytes(pools_t p)
+{
+  return sizeof(*p) + p->nslabs * (sizeof(slab_t) + p->n * p->size);
+}
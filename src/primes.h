@@ -0,0 +1,75 @@
+/**
+ * @file primes.h
+ * @brief Prime bucket counts shared by the chained hash tables.
+ *
+ * Bucket indices are computed without a division: for each prime d the table
+ * <tt>_magic</tt> holds ceil(2^64 / d), and the remainder of a 32-bit x modulo d
+ * is the high half of the 128-bit product of the low half of x * ceil(2^64 / d)
+ * with d (D. Lemire, O. Kaser, N. Kurz, "Faster remainder by direct computation",
+ * 2019). The 64-bit hash value is first folded to 32 bits; every prime is below
+ * 2^32.
+ *
+ * This header is private to the library.
+ * @author Thomas Pender
+ */
+# ifndef INCLUDED_PRIMES_H
+# define INCLUDED_PRIMES_H
+
+# include <stdint.h>
+# include <stddef.h>
+
+# define NPRIMES 45
+
+static const
+size_t _primes[] = {
+  11, 17, 29, 43, 67, 101, 151, 227, 347, 521, 787, 1181, 1777, 2671, 4007,
+  6011, 9029, 13553, 20333, 30509, 45763, 68659, 103001, 154501, 231779, 347671,
+  521519, 782297, 1173463, 1760203, 2640317, 3960497, 5940761, 8911141, 13366711,
+  20050081, 30075127, 45112693, 67669079, 101503627, 152255461, 228383273,
+  342574909, 513862367, 770793589, SIZE_MAX,
+};
+
+/**
+ * @brief ceil(2^64 / _primes[i]), unused for the last entry.
+ */
+static const
+uint64_t _magic[] = {
+  0x1745d1745d1745d2ull, 0x0f0f0f0f0f0f0f10ull, 0x08d3dcb08d3dcb09ull,
+  0x05f417d05f417d06ull, 0x03d226357e16ece6ull, 0x0288df0cac5b3f5eull,
+  0x01b2036406c80d91ull, 0x0120b470c67c0d89ull, 0x00bcdd535db1cc5cull,
+  0x007dc9f3397d4c2aull, 0x005345efbc572d37ull, 0x00377df0d3902627ull,
+  0x0024e15087fed8f6ull, 0x0018893fbc8690baull, 0x00105afa0ef32892ull,
+  0x000ae715eee11f8full, 0x00074225d2b117e7ull, 0x0004d5e597ec345dull,
+  0x0003391f5cd42c45ull, 0x000225e90f21006eull, 0x00016e9c65ec6327ull,
+  0x0000f45b0d3d7afdull, 0x0000a2e24e88b8faull, 0x00006c96f60da815ull,
+  0x0000486271212ac4ull, 0x000030418a032121ull, 0x0000202b7eced364ull,
+  0x00001572334ce293ull, 0x00000e4c143a09aeull, 0x000009880a77d0c0ull,
+  0x0000065aafac80baull, 0x0000043c739bda07ull, 0x000002d2f7419d52ull,
+  0x000001e1fa2d83eeull, 0x00000141517476f0ull, 0x000000d636437d92ull,
+  0x0000008eced5f2e4ull, 0x0000005f348e496aull, 0x0000003f785c6e08ull,
+  0x0000002a503d633dull, 0x0000001c357e0270ull, 0x00000012ce539109ull,
+  0x0000000c898d0baaull, 0x000000085bb35c28ull, 0x0000000592778e1aull,
+  0,
+};
+
+static inline
+size_t _get_cap_index(size_t n)
+{
+  size_t i;
+  for ( i = 0; i < NPRIMES && n >= _primes[i]; i++ );
+  return i;
+}
+
+/* bucket index of hash value h in a bucket array of prime index i */
+static inline
+size_t _reduce(uint64_t h, size_t i)
+{
+# ifdef __SIZEOF_INT128__
+  uint32_t x = (uint32_t)(h ^ (h >> 32));
+  return (size_t)(((__uint128_t)(_magic[i] * x) * _primes[i]) >> 64);
+# else
+  return (size_t)((h ^ (h >> 32)) % _primes[i]);
+# endif
+}
+
+# endif
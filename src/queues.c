@@ -4,7 +4,27 @@
  * @author Thomas Pender
  */
 # include <config.h>
+# undef CONTAINERS_INLINE
 # include <queues.h>
+# include <pools.h>
+# include <stdint.h>
+# include <errno.h>
+# include <error.h>
+# define COUNTS_KIND COUNTERS_QUEUES
+# include "allocs.h"
+# include "sweeps.h"
+
+/**
+ * @brief Number of links of the first chunk of a compact queue, as a power of
+ * two.
+ */
+# define SHIFT 6
+
+/**
+ * @brief Number of chunks of a compact queue; chunk k holds
+ * <tt>2^(k + SHIFT)</tt> links.
+ */
+# define NCHUNKS (33 - SHIFT)
 
 /**
  * @brief Internal structure for <tt>queues_t</tt> object.
@@ -16,8 +36,22 @@ struct queues_node_t {
 };
 typedef struct queues_node_t queues_node_t;
 
+/**
+ * @brief Link of a compact queue.
+ */
+typedef struct {
+  void *x;       ///< pointer to data object
+  uint32_t prev; ///< index of previous element of queue, 0 if none
+  uint32_t next; ///< index of next element of queue, 0 if none
+} queues_slot_t;
+
 /**
  * @brief <tt>queues_t</tt> class object.
+ *
+ * Links are handled as <tt>queues_node_t</tt> pointers. In a compact queue such
+ * a pointer is not an address but the 32-bit index of a link in the chunks, 0
+ * standing for <tt>NULL</tt>, and links are only reached through
+ * <tt>_x</tt>, <tt>_prev</tt> and <tt>_next</tt>.
  */
 struct queues_t {
   size_t size;             ///< number of elements in queue
@@ -25,43 +59,188 @@ struct queues_t {
   queues_data_cmp_r cmp_r; ///< user provided reentrant compare function
   queues_node_t *head;     ///< pointer to head of queue
   queues_node_t *tail;     ///< pointer to tail of queue
+  queues_node_t *finger;   ///< link last touched by a hinted call, or NULL
+  pools_t pool;            ///< pool of links, <tt>NULL</tt> if not pooled
+  queues_slot_t **chunks;  ///< chunks of links, <tt>NULL</tt> if not compact
+  uint32_t fresh;          ///< links ever taken from the chunks
+  uint32_t unused;         ///< index of top free link of chunks, 0 if none
+  allocators_t al;         ///< allocator of the queue
 };
 
+_Static_assert(offsetof(struct queues_t, size) == 0,
+               "inline queues_size reads the first member of struct queues_t");
+
 queues_t queues_new(queues_data_cmp cmp, queues_data_cmp_r cmp_r)
+{
+  return queues_new_alloc(cmp, cmp_r, &allocators_std);
+}
+
+queues_t queues_new_alloc(queues_data_cmp cmp, queues_data_cmp_r cmp_r,
+                          const allocators_t *al)
 {
   if ( cmp == NULL && cmp_r == NULL ) error(1, errno, "cmp pointers null");
   queues_t q;
-  q = (queues_t)malloc(sizeof(*q));
+  q = (queues_t)_amalloc(al, sizeof(*q));
+  q->al = *al;
   q->cmp = cmp;
   q->cmp_r = cmp_r;
   q->size = 0;
   q->head = NULL;
   q->tail = NULL;
+  q->finger = NULL;
+  q->pool = NULL;
+  q->chunks = NULL;
+  q->fresh = q->unused = 0;
+  return q;
+}
+
+queues_t queues_new_pooled(queues_data_cmp cmp, queues_data_cmp_r cmp_r)
+{
+  queues_t q = queues_new(cmp, cmp_r);
+  q->pool = pools_new(sizeof(queues_node_t), 0);
+  return q;
+}
+
+queues_t queues_new_compact(queues_data_cmp cmp, queues_data_cmp_r cmp_r)
+{
+  queues_t q = queues_new(cmp, cmp_r);
+  q->chunks = (queues_slot_t**)
+    _acalloc(&q->al, NCHUNKS, sizeof(queues_slot_t*));
   return q;
 }
 
+static inline
+uint32_t _index(const queues_node_t *n)
+{
+  return (uint32_t)(uintptr_t)n;
+}
+
+static inline
+queues_node_t *_handle(uint32_t i)
+{
+  return (queues_node_t*)(uintptr_t)i;
+}
+
+/* chunk of link i > 0 of a compact queue, and its offset in the chunk */
+static inline
+unsigned _chunk(uint32_t i, uint64_t *off)
+{
+  uint64_t j = (uint64_t)i + (1u << SHIFT) - 1;
+  unsigned k = 63 - __builtin_clzll(j) - SHIFT;
+  *off = j - ((uint64_t)1 << (k + SHIFT));
+  return k;
+}
+
+static inline
+queues_slot_t *_slot(queues_t q, uint32_t i)
+{
+  uint64_t off;
+  unsigned k = _chunk(i, &off);
+  return q->chunks[k] + off;
+}
+
+/* the data pointer, previous and next links of link n */
+static inline
+void **_x(queues_t q, queues_node_t *n)
+{
+  return q->chunks != NULL ? &_slot(q, _index(n))->x : &n->x;
+}
+
+static inline
+queues_node_t *_prev(queues_t q, queues_node_t *n)
+{
+  return q->chunks != NULL ? _handle(_slot(q, _index(n))->prev) : n->prev;
+}
+
+static inline
+queues_node_t *_next(queues_t q, queues_node_t *n)
+{
+  return q->chunks != NULL ? _handle(_slot(q, _index(n))->next) : n->next;
+}
+
+static inline
+void _set_prev(queues_t q, queues_node_t *n, queues_node_t *p)
+{
+  if ( q->chunks != NULL ) _slot(q, _index(n))->prev = _index(p);
+  else n->prev = p;
+}
+
+static inline
+void _set_next(queues_t q, queues_node_t *n, queues_node_t *p)
+{
+  if ( q->chunks != NULL ) _slot(q, _index(n))->next = _index(p);
+  else n->next = p;
+}
+
+/* free link of the chunks, allocating the chunk of a fresh one if need be */
+static
+queues_node_t *_take(queues_t q)
+{
+  uint32_t i = q->unused;
+  if ( i != 0 ) {
+    q->unused = _slot(q, i)->next;
+    return _handle(i);
+  }
+  i = ++q->fresh;
+  if ( i == 0 ) error(1, ENOMEM, "queues_t links exhausted");
+  uint64_t off;
+  unsigned k = _chunk(i, &off);
+  if ( q->chunks[k] == NULL )
+    q->chunks[k] = (queues_slot_t*)
+      _amalloc(&q->al, ((size_t)1 << (k + SHIFT)) * sizeof(queues_slot_t));
+  return _handle(i);
+}
+
+/* new link holding x between links prev and next, which are left unchanged */
+static inline
+queues_node_t *_alloc(queues_t q, const void *x, queues_node_t *prev,
+                      queues_node_t *next)
+{
+  queues_node_t *n;
+  if ( q->chunks != NULL ) n = _take(q);
+  else if ( q->pool != NULL ) n = (queues_node_t*)pools_alloc(q->pool);
+  else n = (queues_node_t*)_amalloc(&q->al, sizeof(queues_node_t));
+  *_x(q, n) = (void*)x;
+  _set_prev(q, n, prev);
+  _set_next(q, n, next);
+  return n;
+}
+
+static inline
+void _release(queues_t q, queues_node_t *n)
+{
+  if ( q->finger == n ) q->finger = NULL;
+  if ( q->chunks != NULL ) {
+    _slot(q, _index(n))->next = q->unused;
+    q->unused = _index(n);
+  }
+  else if ( q->pool != NULL ) pools_release(q->pool, n);
+  else _afree(&q->al, n);
+}
+
+static inline
+int _cmp(queues_t q, const void *x, const void *y, void *arg, int r)
+{
+  COUNTS_ADD(cmps, 1);
+  return r ? q->cmp_r(x, y, arg) : q->cmp(x, y);
+}
+
 void queues_enqueu(queues_t q, const void *x)
 {
   /* queue is empty */
   if ( q->head == NULL ) {
-    q->head = (queues_node_t*)malloc(sizeof(queues_node_t));
-    q->head->x = (void*)x;
-    q->head->prev = NULL;
-    q->head->next = NULL;
+    q->head = _alloc(q, x, NULL, NULL);
     q->tail = q->head;
     q->size = 1;
     return;
   }
 
   /* check tail */
-  switch ( q->cmp(x, q->tail->x) ) {
+  switch ( _cmp(q, x, *_x(q, q->tail), NULL, 0) ) {
   case 0: return;
   case 1: {
-    queues_node_t *new = (queues_node_t*)malloc(sizeof(queues_node_t));
-    new->x = (void*)x;
-    new->next = NULL;
-    new->prev = q->tail;
-    q->tail->next = new;
+    queues_node_t *new = _alloc(q, x, q->tail, NULL);
+    _set_next(q, q->tail, new);
     q->tail = new;
     q->size++;
     return;
@@ -69,13 +248,10 @@ void queues_enqueu(queues_t q, const void *x)
   }
 
   /* check head */
-  switch ( q->cmp(x, q->head->x) ) {
+  switch ( _cmp(q, x, *_x(q, q->head), NULL, 0) ) {
   case -1: {
-    queues_node_t *new = (queues_node_t*)malloc(sizeof(queues_node_t));
-    new->x = (void*)x;
-    new->prev = NULL;
-    new->next = q->head;
-    q->head->prev = new;
+    queues_node_t *new = _alloc(q, x, NULL, q->head);
+    _set_prev(q, q->head, new);
     q->head = new;
     q->size++;
     return;
@@ -84,21 +260,18 @@ void queues_enqueu(queues_t q, const void *x)
   }
 
   /* check body */
-  queues_node_t *tmp = q->head;
-  while ( tmp->next != NULL ) {
-    switch ( q->cmp(x, tmp->next->x) ) {
+  queues_node_t *tmp = q->head, *next;
+  while ( (next = _next(q, tmp)) != NULL ) {
+    switch ( _cmp(q, x, *_x(q, next), NULL, 0) ) {
     case -1: {
-      queues_node_t *new = (queues_node_t*)malloc(sizeof(queues_node_t));
-      new->x = (void*)x;
-      new->prev = tmp;
-      new->next = tmp->next;
-      tmp->next->prev = new;
-      tmp->next = new;
+      queues_node_t *new = _alloc(q, x, tmp, next);
+      _set_prev(q, next, new);
+      _set_next(q, tmp, new);
       q->size++;
       return;
     }
     case 0: return;
-    case 1: tmp = tmp->next; break;
+    case 1: tmp = next; break;
     }
   }
 
@@ -109,24 +282,18 @@ void queues_enqueu_r(queues_t q, const void *x, void *y)
 {
   /* queue is empty */
   if ( q->head == NULL ) {
-    q->head = (queues_node_t*)malloc(sizeof(queues_node_t));
-    q->head->x = (void*)x;
-    q->head->prev = NULL;
-    q->head->next = NULL;
+    q->head = _alloc(q, x, NULL, NULL);
     q->tail = q->head;
     q->size = 1;
     return;
   }
 
   /* check tail */
-  switch ( q->cmp_r(x, q->tail->x, y) ) {
+  switch ( _cmp(q, x, *_x(q, q->tail), y, 1) ) {
   case 0: return;
   case 1: {
-    queues_node_t *new = (queues_node_t*)malloc(sizeof(queues_node_t));
-    new->x = (void*)x;
-    new->next = NULL;
-    new->prev = q->tail;
-    q->tail->next = new;
+    queues_node_t *new = _alloc(q, x, q->tail, NULL);
+    _set_next(q, q->tail, new);
     q->tail = new;
     q->size++;
     return;
@@ -134,13 +301,10 @@ void queues_enqueu_r(queues_t q, const void *x, void *y)
   }
 
   /* check head */
-  switch ( q->cmp_r(x, q->head->x, y) ) {
+  switch ( _cmp(q, x, *_x(q, q->head), y, 1) ) {
   case -1: {
-    queues_node_t *new = (queues_node_t*)malloc(sizeof(queues_node_t));
-    new->x = (void*)x;
-    new->prev = NULL;
-    new->next = q->head;
-    q->head->prev = new;
+    queues_node_t *new = _alloc(q, x, NULL, q->head);
+    _set_prev(q, q->head, new);
     q->head = new;
     q->size++;
     return;
@@ -149,36 +313,173 @@ void queues_enqueu_r(queues_t q, const void *x, void *y)
   }
 
   /* check body */
-  queues_node_t *tmp = q->head;
-  while ( tmp->next != NULL ) {
-    switch ( q->cmp_r(x, tmp->next->x, y) ) {
+  queues_node_t *tmp = q->head, *next;
+  while ( (next = _next(q, tmp)) != NULL ) {
+    switch ( _cmp(q, x, *_x(q, next), y, 1) ) {
     case -1: {
-      queues_node_t *new = (queues_node_t*)malloc(sizeof(queues_node_t));
-      new->x = (void*)x;
-      new->prev = tmp;
-      new->next = tmp->next;
-      tmp->next->prev = new;
-      tmp->next = new;
+      queues_node_t *new = _alloc(q, x, tmp, next);
+      _set_prev(q, next, new);
+      _set_next(q, tmp, new);
       q->size++;
       return;
     }
     case 0: return;
-    case 1: tmp = tmp->next; break;
+    case 1: tmp = next; break;
     }
   }
 
   return;
 }
 
+/* the cursor is the first link not less than the data objects to come */
+static
+void _merge(queues_t q, void *const *x, size_t n, void *y, int r)
+{
+  queues_node_t *p = q->head, *prev = NULL;
+  for ( size_t i = 0; i < n; i++ ) {
+    int c = 1;
+    while ( p != NULL && (c = _cmp(q, x[i], *_x(q, p), y, r)) > 0 ) {
+      prev = p;
+      p = _next(q, p);
+    }
+    if ( p != NULL && c == 0 ) continue;
+    queues_node_t *new = _alloc(q, x[i], prev, p);
+    if ( prev != NULL ) _set_next(q, prev, new);
+    else q->head = new;
+    if ( p != NULL ) _set_prev(q, p, new);
+    else q->tail = new;
+    q->size++;
+    p = new;
+  }
+}
+
+void queues_merge(queues_t q, void *const *x, size_t n)
+{
+  _merge(q, x, n, NULL, 0);
+}
+
+void queues_merge_r(queues_t q, void *const *x, size_t n, void *y)
+{
+  _merge(q, x, n, y, 1);
+}
+
+/*
+ * Walks from link p of a nonempty queue towards data x. Returns the link
+ * holding data equal to x, *found set, or else the last link before x, NULL if x
+ * is before the head.
+ */
+static
+queues_node_t *_seek(queues_t q, const void *x, queues_node_t *p, void *y,
+                     int r, int *found)
+{
+  queues_node_t *s;
+  int c;
+  *found = 0;
+  if ( (c = _cmp(q, x, *_x(q, p), y, r)) == 0 ) {
+    *found = 1;
+    return p;
+  }
+  if ( c > 0 ) {
+    while ( (s = _next(q, p)) != NULL && (c = _cmp(q, x, *_x(q, s), y, r)) > 0 )
+      p = s;
+    if ( s != NULL && c == 0 ) {
+      *found = 1;
+      return s;
+    }
+    return p;
+  }
+  while ( (s = _prev(q, p)) != NULL && (c = _cmp(q, x, *_x(q, s), y, r)) < 0 )
+    p = s;
+  if ( s != NULL && c == 0 ) *found = 1;
+  return s;
+}
+
+/* link at which a hinted call starts: the cursor, the finger, or the tail */
+static inline
+queues_node_t *_start(queues_t q, const queues_iter_t *it)
+{
+  if ( it != NULL && it->node != NULL ) return (queues_node_t*)it->node;
+  return q->finger != NULL ? q->finger : q->tail;
+}
+
+/* leave the finger, and cursor it if not NULL, at link n */
+static inline
+void _touch(queues_t q, queues_iter_t *it, queues_node_t *n)
+{
+  q->finger = n;
+  if ( it != NULL ) {
+    it->q = q;
+    it->node = n;
+    it->x = n != NULL ? *_x(q, n) : NULL;
+  }
+}
+
+static
+void _enqueu_hint(queues_t q, const void *x, void *y, int r,
+                  queues_iter_t *it)
+{
+  queues_node_t *prev, *new;
+  int found;
+  if ( q->head == NULL ) prev = NULL;
+  else {
+    prev = _seek(q, x, _start(q, it), y, r, &found);
+    if ( found ) {
+      _touch(q, it, prev);
+      return;
+    }
+  }
+  new = _alloc(q, x, prev, prev != NULL ? _next(q, prev) : q->head);
+  if ( prev != NULL ) _set_next(q, prev, new);
+  else q->head = new;
+  if ( _next(q, new) != NULL ) _set_prev(q, _next(q, new), new);
+  else q->tail = new;
+  q->size++;
+  _touch(q, it, new);
+}
+
+void queues_enqueu_hint(queues_t q, const void *x, queues_iter_t *it)
+{
+  _enqueu_hint(q, x, NULL, 0, it);
+}
+
+void queues_enqueu_hint_r(queues_t q, const void *x, void *y,
+                          queues_iter_t *it)
+{
+  _enqueu_hint(q, x, y, 1, it);
+}
+
+static
+void *_find_hint(queues_t q, const void *x, void *y, int r, queues_iter_t *it)
+{
+  queues_node_t *p;
+  int found;
+  if ( q->head == NULL ) return NULL;
+  p = _seek(q, x, _start(q, it), y, r, &found);
+  /* a miss leaves the finger next to where x would be */
+  _touch(q, it, p != NULL ? p : q->head);
+  return found ? *_x(q, p) : NULL;
+}
+
+void *queues_find_hint(queues_t q, const void *x, queues_iter_t *it)
+{
+  return _find_hint(q, x, NULL, 0, it);
+}
+
+void *queues_find_hint_r(queues_t q, const void *x, void *y,
+                         queues_iter_t *it)
+{
+  return _find_hint(q, x, y, 1, it);
+}
+
 void *queues_dequeue_front(queues_t q)
 {
   if ( q->head == NULL ) return NULL;
-  if ( q->head->next == NULL ) q->tail = NULL;
   queues_node_t *tmp = q->head;
-  void *x = tmp->x;
-  q->head = q->head->next;
-  free(tmp);
-  if ( q->head != NULL ) q->head->prev = NULL;
+  void *x = *_x(q, tmp);
+  q->head = _next(q, tmp);
+  if ( q->head == NULL ) q->tail = NULL;
+  _release(q, tmp);
+  if ( q->head != NULL ) _set_prev(q, q->head, NULL);
   q->size--;
   return x;
 }
@@ -186,12 +487,12 @@ void *queues_dequeue_front(queues_t q)
 void *queues_dequeue_back(queues_t q)
 {
   if ( q->tail == NULL ) return NULL;
-  if ( q->tail->prev == NULL ) q->head = NULL;
   queues_node_t *tmp = q->tail;
-  void *x = tmp->x;
-  q->tail = q->tail->prev;
-  free(tmp);
-  if ( q->tail != NULL ) q->tail->next = NULL;
+  void *x = *_x(q, tmp);
+  q->tail = _prev(q, tmp);
+  if ( q->tail == NULL ) q->head = NULL;
+  _release(q, tmp);
+  if ( q->tail != NULL ) _set_next(q, q->tail, NULL);
   q->size--;
   return x;
 }
@@ -201,11 +502,11 @@ void *queues_find(queues_t q, const void *x)
   if ( q == NULL ) return NULL;
   queues_node_t *tmp = q->head;
   while ( tmp != NULL ) {
-    switch ( q->cmp(x, tmp->x) ) {
+    switch ( _cmp(q, x, *_x(q, tmp), NULL, 0) ) {
     case -1: return NULL;
-    case 0: return tmp->x;
+    case 0: return *_x(q, tmp);
     }
-    tmp = tmp->next;
+    tmp = _next(q, tmp);
   }
   return NULL;
 }
@@ -215,61 +516,57 @@ void *queues_find_r(queues_t q, const void *x, void *y)
   if ( q == NULL ) return NULL;
   queues_node_t *tmp = q->head;
   while ( tmp != NULL ) {
-    switch ( q->cmp_r(x, tmp->x, y) ) {
+    switch ( _cmp(q, x, *_x(q, tmp), y, 1) ) {
     case -1: return NULL;
-    case 0: return tmp->x;
+    case 0: return *_x(q, tmp);
     }
-    tmp = tmp->next;
+    tmp = _next(q, tmp);
   }
   return NULL;
 }
 
+/* unlink and release link n, returning its data */
+static
+void *_unlink(queues_t q, queues_node_t *n)
+{
+  queues_node_t *prev = _prev(q, n), *next = _next(q, n);
+  void *x = *_x(q, n);
+  if ( prev != NULL ) _set_next(q, prev, next);
+  else q->head = next;
+  if ( next != NULL ) _set_prev(q, next, prev);
+  else q->tail = prev;
+  _release(q, n);
+  q->size--;
+  return x;
+}
+
 void *queues_remove(queues_t q, const void *x)
 {
   if ( q == NULL || q->head == NULL ) return NULL;
 
-  void *_x;
   queues_node_t *tmp;
 
   /* check head */
   tmp = q->head;
-  switch ( q->cmp(x, tmp->x) ) {
+  switch ( _cmp(q, x, *_x(q, tmp), NULL, 0) ) {
   case -1: return NULL;
-  case 0:
-    if ( q->head->next != NULL ) q->head->next->prev = NULL;
-    q->head = q->head->next;
-    _x = tmp->x;
-    free(tmp);
-    q->size--;
-    return _x;
+  case 0: return _unlink(q, tmp);
   }
 
   /* check tail */
   tmp = q->tail;
-  switch ( q->cmp(x, tmp->x) ) {
-  case 0:
-    if ( q->tail->prev != NULL ) q->tail->prev->next = NULL;
-    q->tail = q->tail->prev;
-    _x = tmp->x;
-    free(tmp);
-    q->size--;
-    return _x;
+  switch ( _cmp(q, x, *_x(q, tmp), NULL, 0) ) {
+  case 0: return _unlink(q, tmp);
   case 1: return NULL;
   }
 
   /* check body */
-  tmp = q->head->next;
+  tmp = _next(q, q->head);
   while ( tmp != q->tail )
-    switch ( q->cmp(x, tmp->x) ) {
+    switch ( _cmp(q, x, *_x(q, tmp), NULL, 0) ) {
     case -1: return NULL;
-    case 0:
-      tmp->prev->next = tmp->next;
-      tmp->next->prev = tmp->prev;
-      _x = tmp->x;
-      free(tmp);
-      q->size--;
-      return _x;
-    case 1: tmp = tmp->next; break;
+    case 0: return _unlink(q, tmp);
+    case 1: tmp = _next(q, tmp); break;
     }
 
   return NULL;
@@ -279,60 +576,71 @@ void *queues_remove_r(queues_t q, const void *x, void *y)
 {
   if ( q == NULL || q->head == NULL ) return NULL;
 
-  void *_x;
   queues_node_t *tmp;
 
   /* check head */
   tmp = q->head;
-  switch ( q->cmp_r(x, tmp->x, y) ) {
+  switch ( _cmp(q, x, *_x(q, tmp), y, 1) ) {
   case -1: return NULL;
-  case 0:
-    if ( q->head->next != NULL ) q->head->next->prev = NULL;
-    q->head = q->head->next;
-    _x = tmp->x;
-    free(tmp);
-    q->size--;
-    return _x;
+  case 0: return _unlink(q, tmp);
   }
 
   /* check tail */
   tmp = q->tail;
-  switch ( q->cmp_r(x, tmp->x, y) ) {
-  case 0:
-    if ( q->tail->prev != NULL ) q->tail->prev->next = NULL;
-    q->tail = q->tail->prev;
-    _x = tmp->x;
-    free(tmp);
-    q->size--;
-    return _x;
+  switch ( _cmp(q, x, *_x(q, tmp), y, 1) ) {
+  case 0: return _unlink(q, tmp);
   case 1: return NULL;
   }
 
   /* check body */
-  tmp = q->head->next;
+  tmp = _next(q, q->head);
   while ( tmp != q->tail )
-    switch ( q->cmp_r(x, tmp->x, y) ) {
+    switch ( _cmp(q, x, *_x(q, tmp), y, 1) ) {
     case -1: return NULL;
-    case 0:
-      tmp->prev->next = tmp->next;
-      tmp->next->prev = tmp->prev;
-      _x = tmp->x;
-      free(tmp);
-      q->size--;
-      return _x;
-    case 1: tmp = tmp->next; break;
+    case 0: return _unlink(q, tmp);
+    case 1: tmp = _next(q, tmp); break;
     }
 
   return NULL;
 }
 
+/* unlink and release every link whose data passes the sweep */
+static
+size_t _remove_if(queues_t q, const sweeps_t *s)
+{
+  size_t k = 0;
+  queues_node_t *tmp, *next;
+  if ( q == NULL ) return 0;
+  for ( tmp = q->head; tmp != NULL; tmp = next ) {
+    next = _next(q, tmp);
+    if ( !_sweep_test(s, *_x(q, tmp)) ) continue;
+    _sweep_dispose(s, _unlink(q, tmp));
+    k++;
+  }
+  return k;
+}
+
+size_t queues_remove_if(queues_t q, int pred(const void *x),
+                        void dispose(void *x))
+{
+  sweeps_t s = { pred, NULL, dispose, NULL, NULL };
+  return _remove_if(q, &s);
+}
+
+size_t queues_remove_if_r(queues_t q, int pred(const void *x, void *y),
+                          void dispose(void *x, void *y), void *y)
+{
+  sweeps_t s = { NULL, pred, NULL, dispose, y };
+  return _remove_if(q, &s);
+}
+
 int queues_map(queues_t q, int apply(void **x))
 {
   if ( q == NULL ) return 1;
   queues_node_t *tmp = q->head;
   while ( tmp != NULL ) {
-    if ( apply(&tmp->x) < 0 ) return -1;
-    tmp = tmp->next;
+    if ( apply(_x(q, tmp)) < 0 ) return -1;
+    tmp = _next(q, tmp);
   }
   return 1;
 }
@@ -342,25 +650,84 @@ int queues_map_r(queues_t q, int apply(void **x, void *y), void *y)
   if ( q == NULL ) return 1;
   queues_node_t *tmp = q->head;
   while ( tmp != NULL ) {
-    if ( apply(&tmp->x, y) < 0 ) return -1;
-    tmp = tmp->next;
+    if ( apply(_x(q, tmp), y) < 0 ) return -1;
+    tmp = _next(q, tmp);
   }
   return 1;
 }
 
+/* cursor at link n of queue q, or past the end if n is NULL */
+static inline
+int _at(queues_t q, queues_iter_t *it, queues_node_t *n)
+{
+  it->q = q;
+  it->node = n;
+  if ( n == NULL ) return -1;
+  it->x = *_x(q, n);
+  return 1;
+}
+
+int queues_iterinit(queues_t q, queues_iter_t *it)
+{
+  return _at(q, it, q->head);
+}
+
+int queues_iternext(queues_iter_t *it)
+{
+  return _at(it->q, it, _next(it->q, (queues_node_t*)it->node));
+}
+
+/* chunks of a compact queue, and the array of them */
+static
+void _free_chunks(queues_t q)
+{
+  for ( size_t k = 0; k < NCHUNKS; k++ ) _afree(&q->al, q->chunks[k]);
+  _afree(&q->al, q->chunks);
+}
+
 void queues_free(queues_t *q)
 {
   if ( *q == NULL ) return;
-  while ( (*q)->head != NULL ) {
+  allocators_t al = (*q)->al;
+  if ( (*q)->chunks != NULL ) _free_chunks(*q);
+  else if ( (*q)->pool != NULL ) pools_free(&(*q)->pool);
+  else while ( (*q)->head != NULL ) {
     queues_node_t *tmp = (*q)->head;
     (*q)->head = (*q)->head->next;
-    free(tmp);
+    _afree(&al, tmp);
   }
-  free(*q);
+  _afree(&al, *q);
   *q = NULL;
 }
 
+void queues_clear(queues_t q)
+{
+  if ( q->chunks != NULL ) q->fresh = q->unused = 0;
+  else if ( q->pool != NULL ) pools_clear(q->pool);
+  else while ( q->head != NULL ) {
+    queues_node_t *tmp = q->head;
+    q->head = q->head->next;
+    _afree(&q->al, tmp);
+  }
+  q->head = q->tail = q->finger = NULL;
+  q->size = 0;
+}
+
 size_t queues_size(queues_t q)
 {
   return q->size;
 }
+
+size_t queues_memory_usage(queues_t q, size_t *payload)
+{
+  size_t n = sizeof(*q);
+  if ( q->chunks != NULL ) {
+    n += NCHUNKS * sizeof(queues_slot_t*);
+    for ( size_t k = 0; k < NCHUNKS && q->chunks[k] != NULL; k++ )
+      n += ((size_t)1 << (k + SHIFT)) * sizeof(queues_slot_t);
+  }
+  else n += q->pool != NULL ? pools_bytes(q->pool)
+         : q->size * sizeof(queues_node_t);
+  if ( payload != NULL ) *payload = q->size * sizeof(void*);
+  return n;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file ranges.h
+ * @brief Parallel visits of the ranges of an index space.
+ *
+ * The indices from 0 to <tt>n - 1</tt>, of the elements of an array or the
+ * buckets of a hash table, are halved recursively on the threads of a worker
+ * pool into ranges of at least <tt>grain</tt> indices, each of which is handed
+ * to a user of this header to visit. A fixed number of tasks may also be run
+ * with <tt>_spread</tt>, for work split ahead of time.
+ *
+ * This header is private to the library.
+ * @author Thomas Pender
+ */
+# ifndef INCLUDED_RANGES_H
+# define INCLUDED_RANGES_H
+
+# include <stdatomic.h>
+# include <workers.h>
+# include "allocs.h"
+
+/**
+ * @brief Fewest indices handed to a task.
+ */
+# define GRAIN 4096
+
+/**
+ * @brief Tasks per worker, so that uneven tasks still balance.
+ */
+# define SPLIT 4
+
+/**
+ * @brief Range of indices of a task, and its place in the split tree.
+ */
+typedef struct {
+  size_t lo;                       ///< first index
+  size_t hi;                       ///< one past last index
+  size_t id;                       ///< index of range in split tree
+} range_t;
+
+/**
+ * @brief Shared state of the visit of the ranges of an index space.
+ */
+typedef struct {
+  size_t grain;                    ///< indices below which ranges are not split
+  int (*visit)(workers_t, size_t, size_t, void*); ///< visits one range
+  void *arg;                       ///< argument to visit
+  atomic_int stopped;              ///< some visit returned negative
+} ranges_t;
+
+/* indices per task for n indices over the workers of w */
+static inline
+size_t _grain(workers_t w, size_t n)
+{
+  size_t g = n / (SPLIT * workers_count(w));
+  return g < GRAIN ? GRAIN : g;
+}
+
+static inline
+void _ranges_task(workers_t w, void *x, void *y)
+{
+  range_t *r = (range_t*)x, *t = r - r->id;
+  ranges_t *s = (ranges_t*)y;
+  if ( r->hi - r->lo > s->grain ) {
+    size_t mid = r->lo + (r->hi - r->lo) / 2, c = 2 * r->id + 1;
+    t[c] = (range_t) { r->lo, mid, c };
+    t[c + 1] = (range_t) { mid, r->hi, c + 1 };
+    workers_spawn(w, &t[c + 1]);
+    workers_spawn(w, &t[c]);
+    return;
+  }
+  if ( s->visit(w, r->lo, r->hi, s->arg) < 0 ) {
+    atomic_store(&s->stopped, 1);
+    workers_stop(w);
+  }
+}
+
+/*
+ * Visits the ranges of indices 0 to n - 1 on the threads of w. Returns -1 if
+ * some visit returned negative, the pool being stopped, and 1 otherwise.
+ */
+static inline
+int _ranges(workers_t w, size_t n, int visit(workers_t, size_t, size_t, void*),
+            void *arg)
+{
+  size_t leaves, nodes = 1;
+  if ( n == 0 ) return 1;
+  ranges_t s = { .grain = _grain(w, n), .visit = visit, .arg = arg };
+  atomic_init(&s.stopped, 0);
+  /* halving ranges of at least grain indices: a tree below 4 * leaves nodes */
+  leaves = (n + s.grain - 1) / s.grain;
+  while ( nodes < 4 * leaves ) nodes <<= 1;
+  range_t *t = (range_t*)_amalloc(&allocators_std, nodes * sizeof(range_t));
+  t[0] = (range_t) { 0, n, 0 };
+  workers_run(w, _ranges_task, &t[0], &s);
+  _afree(&allocators_std, t);
+  return atomic_load(&s.stopped) ? -1 : 1;
+}
+
+/**
+ * @brief Shared state of <tt>k</tt> tasks run by <tt>_spread</tt>.
+ */
+typedef struct {
+  size_t k;                        ///< number of tasks
+  void (*visit)(workers_t, size_t, void*); ///< runs one task
+  void *arg;                       ///< argument to visit
+  size_t *ids;                     ///< index of each task
+} spread_t;
+
+static inline
+void _spread_task(workers_t w, void *x, void *y)
+{
+  size_t id = *(size_t*)x;
+  spread_t *s = (spread_t*)y;
+  if ( id == 0 )
+    for ( size_t j = s->k; j-- > 1; ) workers_spawn(w, &s->ids[j]);
+  s->visit(w, id, s->arg);
+}
+
+/* runs visit on tasks 0 to k - 1 on the threads of w */
+static inline
+void _spread(workers_t w, size_t k, void visit(workers_t, size_t, void*),
+             void *arg)
+{
+  if ( k == 0 ) return;
+  spread_t s = { k, visit, arg, NULL };
+  s.ids = (size_t*)_amalloc(&allocators_std, k * sizeof(size_t));
+  for ( size_t j = 0; j < k; j++ ) s.ids[j] = j;
+  workers_run(w, _spread_task, &s.ids[0], &s);
+  _afree(&allocators_std, s.ids);
+}
+
+/**
+ * @brief Bytes between the accumulators of two workers of a reduction.
+ */
+# define PARTIAL(size) (((size) + 63) & ~(size_t)63)
+
+/**
+ * @brief Fold and merge functions of a parallel reduction, reentrant or not.
+ */
+typedef struct {
+  int (*fold)(void*, const void*);              ///< fold function
+  int (*fold_r)(void*, const void*, void*);     ///< reentrant fold function
+  void (*merge)(void*, const void*);            ///< merge function
+  void (*merge_r)(void*, const void*, void*);   ///< reentrant merge function
+  void *y;                                      ///< argument to reentrant ones
+  size_t size;                                  ///< size of accumulator
+  char *partials;                               ///< accumulators of workers
+} reduce_t;
+
+static inline
+int _reduce_fold(const reduce_t *r, void *acc, const void *x)
+{
+  return r->fold != NULL ? r->fold(acc, x) : r->fold_r(acc, x, r->y);
+}
+
+/* accumulator of the calling worker */
+static inline
+void *_reduce_acc(const reduce_t *r, workers_t w)
+{
+  return r->partials + workers_self(w) * PARTIAL(r->size);
+}
+
+/* a copy of acc, the identity of the merge, for each worker of w */
+static inline
+void _reduce_begin(reduce_t *r, workers_t w, const void *acc)
+{
+  size_t n = workers_count(w);
+  r->partials = (char*)_amalloc(&allocators_std, n * PARTIAL(r->size));
+  for ( size_t i = 0; i < n; i++ )
+    memcpy(r->partials + i * PARTIAL(r->size), acc, r->size);
+}
+
+/* merge the accumulators of the workers of w into acc, in worker order */
+static inline
+void _reduce_end(reduce_t *r, workers_t w, void *acc)
+{
+  size_t n = workers_count(w);
+  for ( size_t i = 0; i < n; i++ ) {
+    const char *p = r->partials + i * PARTIAL(r->size);
+    if ( r->merge != NULL ) r->merge(acc, p);
+    else r->merge_r(acc, p, r->y);
+  }
+  _afree(&allocators_std, r->partials);
+}
+
+# endif
@@ -0,0 +1,476 @@
+/**
+ * @file roarings.c
+ * @brief Implementation of <tt>roarings_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <roarings.h>
+# include <bit_sets.h>
+# include <string.h>
+# define COUNTS_KIND COUNTERS_ROARINGS
+# include "allocs.h"
+
+/**
+ * @brief Setwords of a bitmap chunk, covering 65536 elements.
+ */
+# define WORDS 1024
+
+/**
+ * @brief Largest number of elements of an array chunk. Past it an array chunk
+ * would outgrow the 8 KB of a bitmap chunk.
+ */
+# define ARRAYMAX 4096
+
+/**
+ * @brief Representations of a chunk.
+ */
+enum { ARRAY, BITMAP, RUN };
+
+/**
+ * @brief Elements of a set sharing their 16 high bits.
+ */
+typedef struct {
+  uint32_t key;  ///< 16 high bits of the elements
+  uint32_t type; ///< <tt>ARRAY</tt>, <tt>BITMAP</tt> or <tt>RUN</tt>
+  uint32_t card; ///< number of elements
+  uint32_t n;    ///< number of entries: low bits, setwords or runs
+  uint32_t cap;  ///< capacity of an array chunk
+  void *x;       ///< sorted low bits, setwords, or (start, length - 1) pairs
+} chunk_t;
+
+/**
+ * @brief <tt>roarings_t</tt> class object.
+ */
+struct roarings_t {
+  size_t n;        ///< number of chunks
+  size_t capacity; ///< capacity of chunks
+  chunk_t *c;      ///< chunks in increasing order of key
+  allocators_t al; ///< allocator of the set
+};
+
+roarings_t roarings_new(void)
+{
+  return roarings_new_alloc(&allocators_std);
+}
+
+roarings_t roarings_new_alloc(const allocators_t *al)
+{
+  roarings_t r;
+  r = (roarings_t)_amalloc(al, sizeof(*r));
+  r->al = *al;
+  r->n = 0;
+  r->capacity = 0;
+  r->c = NULL;
+  return r;
+}
+
+void roarings_free(roarings_t *r)
+{
+  if ( *r == NULL ) return;
+  allocators_t al = (*r)->al;
+  for ( size_t i = 0; i < (*r)->n; i++ ) _afree(&al, (*r)->c[i].x);
+  _afree(&al, (*r)->c);
+  _afree(&al, *r);
+  *r = NULL;
+}
+
+/* first chunk with key not less than key */
+static inline
+size_t _find(const chunk_t *c, size_t n, uint32_t key)
+{
+  size_t lo = 0, hi = n;
+  while ( lo < hi ) {
+    size_t mid = lo + (hi - lo) / 2;
+    if ( c[mid].key < key ) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/* first of n sorted values not less than v */
+static inline
+size_t _lower(const uint16_t *x, size_t n, size_t stride, uint32_t v)
+{
+  size_t lo = 0, hi = n;
+  while ( lo < hi ) {
+    size_t mid = lo + (hi - lo) / 2;
+    if ( x[mid * stride] < v ) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static
+int _contains(const chunk_t *c, uint32_t lo)
+{
+  const uint16_t *x = (const uint16_t*)c->x;
+  size_t j;
+  switch ( c->type ) {
+  case ARRAY:
+    j = _lower(x, c->n, 1, lo);
+    return j < c->n && x[j] == lo;
+  case BITMAP:
+    return _ISELEMENT((const sets_t*)c->x, lo);
+  default:
+    j = _lower(x, c->n, 2, lo + 1);
+    return j > 0 && lo - x[2 * (j - 1)] <= x[2 * (j - 1) + 1];
+  }
+}
+
+/* least element of chunk not less than lo, or -1 */
+static
+int32_t _next(const chunk_t *c, uint32_t lo)
+{
+  const uint16_t *x = (const uint16_t*)c->x;
+  size_t j;
+  switch ( c->type ) {
+  case ARRAY:
+    j = _lower(x, c->n, 1, lo);
+    return j < c->n ? x[j] : -1;
+  case BITMAP:
+    return bit_nextelement((const sets_t*)c->x, WORDS, (int)lo - 1);
+  default:
+    j = _lower(x, c->n, 2, lo + 1);
+    if ( j > 0 && lo - x[2 * (j - 1)] <= x[2 * (j - 1) + 1] ) return lo;
+    return j < c->n ? x[2 * j] : -1;
+  }
+}
+
+/* adds elements a through b of a chunk to setwords w */
+static
+void _range(sets_t *w, uint32_t a, uint32_t b)
+{
+  while ( a <= b ) {
+    uint32_t bit = _SETBT(a), span = b - a + 1;
+    if ( span > _WORDSIZE - bit ) span = _WORDSIZE - bit;
+    w[_SETWD(a)] |= (span == _WORDSIZE ? ~(uint64_t)0
+                     : ((((uint64_t)1) << span) - 1) << bit);
+    a += span;
+  }
+}
+
+static
+void _tobitmap(const chunk_t *c, sets_t *w)
+{
+  const uint16_t *x = (const uint16_t*)c->x;
+  if ( c->type == BITMAP ) {
+    memcpy(w, c->x, WORDS * sizeof(sets_t));
+    return;
+  }
+  memset(w, 0, WORDS * sizeof(sets_t));
+  if ( c->type == ARRAY )
+    for ( uint32_t j = 0; j < c->n; j++ ) _ADDELEMENT(w, x[j]);
+  else
+    for ( uint32_t j = 0; j < c->n; j++ )
+      _range(w, x[2 * j], (uint32_t)x[2 * j] + x[2 * j + 1]);
+}
+
+/* sets chunk to the elements of w, as an array or bitmap */
+static
+void _fromwords(roarings_t r, chunk_t *c, const sets_t *w, uint32_t card)
+{
+  c->card = card;
+  if ( card > ARRAYMAX ) {
+    c->type = BITMAP;
+    c->n = c->cap = WORDS;
+    c->x = memcpy(_amalloc(&r->al, WORDS * sizeof(sets_t)), w,
+                  WORDS * sizeof(sets_t));
+    return;
+  }
+  uint16_t *x = (uint16_t*)_amalloc(&r->al, (card ? card : 1) * sizeof(*x));
+  uint32_t n = 0, b;
+  for ( uint32_t k = 0; k < WORDS; k++ )
+    for ( setwords_t word = w[k]; word != 0; ) {
+      _TAKEBIT(b, word);
+      x[n++] = (uint16_t)(_TIMESWORDSIZE(k) + b);
+    }
+  c->type = ARRAY;
+  c->n = n;
+  c->cap = card ? card : 1;
+  c->x = x;
+}
+
+/* replaces a run chunk by an array or bitmap chunk before it changes */
+static
+void _unrun(roarings_t r, chunk_t *c)
+{
+  sets_t w[WORDS];
+  _tobitmap(c, w);
+  _afree(&r->al, c->x);
+  _fromwords(r, c, w, c->card);
+}
+
+int roarings_add(roarings_t r, uint32_t x)
+{
+  uint32_t key = x >> 16, lo = x & 0xFFFF;
+  size_t i = _find(r->c, r->n, key);
+
+  if ( i == r->n || r->c[i].key != key ) {
+    if ( r->n == r->capacity ) {
+      r->capacity = r->capacity ? r->capacity + r->capacity / 2 + 1 : 4;
+      r->c = (chunk_t*)_arealloc(&r->al, r->c, r->capacity * sizeof(chunk_t));
+    }
+    memmove(r->c + i + 1, r->c + i, (r->n - i) * sizeof(chunk_t));
+    r->n++;
+    r->c[i] = (chunk_t){ key, ARRAY, 0, 0, 4,
+                         _amalloc(&r->al, 4 * sizeof(uint16_t)) };
+  }
+
+  chunk_t *c = r->c + i;
+  if ( c->type == RUN ) {
+    if ( _contains(c, lo) ) return -1;
+    _unrun(r, c);
+  }
+
+  if ( c->type == ARRAY ) {
+    uint16_t *a = (uint16_t*)c->x;
+    size_t j = _lower(a, c->n, 1, lo);
+    if ( j < c->n && a[j] == lo ) return -1;
+    if ( c->n < ARRAYMAX ) {
+      if ( c->n == c->cap ) {
+        c->cap += c->cap / 2 + 1;
+        if ( c->cap > ARRAYMAX ) c->cap = ARRAYMAX;
+        c->x = a = (uint16_t*)_arealloc(&r->al, a, c->cap * sizeof(*a));
+      }
+      memmove(a + j + 1, a + j, (c->n - j) * sizeof(*a));
+      a[j] = (uint16_t)lo;
+      c->n++;
+      c->card++;
+      return 1;
+    }
+    sets_t w[WORDS];
+    _tobitmap(c, w);
+    _ADDELEMENT(w, lo);
+    _afree(&r->al, c->x);
+    _fromwords(r, c, w, c->card + 1);
+    return 1;
+  }
+
+  sets_t *w = (sets_t*)c->x;
+  if ( _ISELEMENT(w, lo) ) return -1;
+  _ADDELEMENT(w, lo);
+  c->card++;
+  return 1;
+}
+
+int roarings_remove(roarings_t r, uint32_t x)
+{
+  uint32_t key = x >> 16, lo = x & 0xFFFF;
+  size_t i = _find(r->c, r->n, key);
+  if ( i == r->n || r->c[i].key != key ) return -1;
+
+  chunk_t *c = r->c + i;
+  if ( !_contains(c, lo) ) return -1;
+  if ( c->type == RUN ) _unrun(r, c);
+
+  if ( c->type == ARRAY ) {
+    uint16_t *a = (uint16_t*)c->x;
+    size_t j = _lower(a, c->n, 1, lo);
+    memmove(a + j, a + j + 1, (c->n - j - 1) * sizeof(*a));
+    c->n--;
+    c->card--;
+  }
+  else {
+    sets_t *w = (sets_t*)c->x;
+    _DELELEMENT(w, lo);
+    if ( --c->card == ARRAYMAX ) {
+      _fromwords(r, c, w, c->card);
+      _afree(&r->al, w);
+    }
+  }
+
+  if ( c->card == 0 ) {
+    _afree(&r->al, c->x);
+    memmove(c, c + 1, (r->n - i - 1) * sizeof(chunk_t));
+    r->n--;
+  }
+  return 1;
+}
+
+int roarings_contains(roarings_t r, uint32_t x)
+{
+  uint32_t key = x >> 16;
+  size_t i = _find(r->c, r->n, key);
+  if ( i == r->n || r->c[i].key != key ) return -1;
+  return _contains(r->c + i, x & 0xFFFF) ? 1 : -1;
+}
+
+size_t roarings_cardinality(roarings_t r)
+{
+  size_t card = 0;
+  for ( size_t i = 0; i < r->n; i++ ) card += r->c[i].card;
+  return card;
+}
+
+int64_t roarings_nextelement(roarings_t r, int64_t pos)
+{
+  uint64_t v = (uint64_t)(pos + 1);
+  if ( v > UINT32_MAX ) return -1;
+  uint32_t key = (uint32_t)(v >> 16);
+  for ( size_t i = _find(r->c, r->n, key); i < r->n; i++ ) {
+    int32_t lo = _next(r->c + i, r->c[i].key == key ? v & 0xFFFF : 0);
+    if ( lo >= 0 ) return ((int64_t)r->c[i].key << 16) | lo;
+  }
+  return -1;
+}
+
+/* deep copy of chunk */
+static
+void _copy(roarings_t r, chunk_t *dst, const chunk_t *src)
+{
+  size_t n = src->type == ARRAY ? src->n * sizeof(uint16_t)
+    : src->type == BITMAP ? WORDS * sizeof(sets_t)
+    : src->n * 2 * sizeof(uint16_t);
+  *dst = *src;
+  if ( src->type == ARRAY ) dst->cap = src->n ? src->n : 1;
+  dst->x = memcpy(_amalloc(&r->al, n ? n : 1), src->x, n);
+}
+
+static
+void _union(roarings_t r, chunk_t *dst, const chunk_t *a, const chunk_t *b)
+{
+  dst->key = a->key;
+  if ( a->type == ARRAY && b->type == ARRAY && a->card + b->card <= ARRAYMAX ) {
+    const uint16_t *x = (const uint16_t*)a->x, *y = (const uint16_t*)b->x;
+    uint16_t *z = (uint16_t*)_amalloc(&r->al, (a->n + b->n) * sizeof(*z));
+    uint32_t i = 0, j = 0, n = 0;
+    while ( i < a->n && j < b->n ) {
+      if ( x[i] < y[j] ) z[n++] = x[i++];
+      else if ( y[j] < x[i] ) z[n++] = y[j++];
+      else {
+        z[n++] = x[i++];
+        j++;
+      }
+    }
+    while ( i < a->n ) z[n++] = x[i++];
+    while ( j < b->n ) z[n++] = y[j++];
+    *dst = (chunk_t){ a->key, ARRAY, n, n, a->n + b->n, z };
+    return;
+  }
+  sets_t w[WORDS], v[WORDS];
+  _tobitmap(a, w);
+  _tobitmap(b, v);
+  bit_union(w, w, v, WORDS);
+  _fromwords(r, dst, w, (uint32_t)bit_setsize(w, WORDS));
+}
+
+/* returns 0 and allocates nothing if the intersection is empty */
+static
+int _intersect(roarings_t r, chunk_t *dst, const chunk_t *a, const chunk_t *b)
+{
+  if ( b->type == ARRAY && (a->type != ARRAY || b->n < a->n) ) {
+    const chunk_t *t = a;
+    a = b;
+    b = t;
+  }
+  if ( a->type == ARRAY ) {
+    const uint16_t *x = (const uint16_t*)a->x;
+    uint16_t *z = (uint16_t*)_amalloc(&r->al, a->n * sizeof(*z));
+    uint32_t n = 0;
+    for ( uint32_t i = 0; i < a->n; i++ ) if ( _contains(b, x[i]) ) z[n++] = x[i];
+    if ( n == 0 ) {
+      _afree(&r->al, z);
+      return 0;
+    }
+    *dst = (chunk_t){ a->key, ARRAY, n, n, a->n, z };
+    return 1;
+  }
+  sets_t w[WORDS], v[WORDS];
+  _tobitmap(a, w);
+  _tobitmap(b, v);
+  size_t card = bit_intersectioncount(w, w, v, WORDS);
+  if ( card == 0 ) return 0;
+  dst->key = a->key;
+  _fromwords(r, dst, w, (uint32_t)card);
+  return 1;
+}
+
+/* takes the chunks of the result, which may have been built from d */
+static
+void _replace(roarings_t d, chunk_t *c, size_t n, size_t capacity)
+{
+  for ( size_t i = 0; i < d->n; i++ ) _afree(&d->al, d->c[i].x);
+  _afree(&d->al, d->c);
+  d->c = c;
+  d->n = n;
+  d->capacity = capacity;
+}
+
+void roarings_union(roarings_t d, roarings_t a, roarings_t b)
+{
+  size_t capacity = a->n + b->n, i = 0, j = 0, n = 0;
+  chunk_t *c = (chunk_t*)_amalloc(&d->al, (capacity ? capacity : 1)
+                                  * sizeof(chunk_t));
+  while ( i < a->n && j < b->n ) {
+    if ( a->c[i].key < b->c[j].key ) _copy(d, c + n++, a->c + i++);
+    else if ( b->c[j].key < a->c[i].key ) _copy(d, c + n++, b->c + j++);
+    else _union(d, c + n++, a->c + i++, b->c + j++);
+  }
+  while ( i < a->n ) _copy(d, c + n++, a->c + i++);
+  while ( j < b->n ) _copy(d, c + n++, b->c + j++);
+  _replace(d, c, n, capacity ? capacity : 1);
+}
+
+void roarings_intersect(roarings_t d, roarings_t a, roarings_t b)
+{
+  size_t capacity = a->n < b->n ? a->n : b->n, i = 0, j = 0, n = 0;
+  chunk_t *c = (chunk_t*)_amalloc(&d->al, (capacity ? capacity : 1)
+                                  * sizeof(chunk_t));
+  while ( i < a->n && j < b->n ) {
+    if ( a->c[i].key < b->c[j].key ) i++;
+    else if ( b->c[j].key < a->c[i].key ) j++;
+    else n += _intersect(d, c + n, a->c + i++, b->c + j++);
+  }
+  _replace(d, c, n, capacity ? capacity : 1);
+}
+
+/* number of maximal runs of consecutive elements of w */
+static
+uint32_t _runs(const sets_t *w)
+{
+  uint32_t n = 0;
+  setwords_t carry = 0;
+  for ( uint32_t k = 0; k < WORDS; k++ ) {
+    n += (uint32_t)_POPCOUNT(w[k] & ~((w[k] << 1) | carry));
+    carry = w[k] >> (_WORDSIZE - 1);
+  }
+  return n;
+}
+
+void roarings_optimize(roarings_t r)
+{
+  sets_t w[WORDS];
+  for ( size_t i = 0; i < r->n; i++ ) {
+    chunk_t *c = r->c + i;
+    _tobitmap(c, w);
+    uint32_t nruns = _runs(w);
+    size_t plain = c->card > ARRAYMAX ? WORDS * sizeof(sets_t)
+      : c->card * sizeof(uint16_t);
+    if ( 2 * nruns * sizeof(uint16_t) >= plain ) {
+      if ( c->type == RUN ) _unrun(r, c);
+      continue;
+    }
+    if ( c->type == RUN ) continue;
+
+    uint16_t *x = (uint16_t*)_amalloc(&r->al, 2 * nruns * sizeof(*x));
+    uint32_t n = 0, b;
+    int64_t last = -2;
+    for ( uint32_t k = 0; k < WORDS; k++ )
+      for ( setwords_t word = w[k]; word != 0; ) {
+        _TAKEBIT(b, word);
+        uint32_t e = _TIMESWORDSIZE(k) + b;
+        if ( (int64_t)e == last + 1 ) x[2 * n - 1]++;
+        else {
+          x[2 * n] = (uint16_t)e;
+          x[2 * n + 1] = 0;
+          n++;
+        }
+        last = e;
+      }
+    _afree(&r->al, c->x);
+    c->type = RUN;
+    c->n = n;
+    c->cap = n;
+    c->x = x;
+  }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file segtrees.c
+ * @brief Implementation of <tt>segtrees_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <segtrees.h>
+# include <limits.h>
+# include "allocs.h"
+
+/**
+ * @brief <tt>segtrees_t</tt> class object.
+ */
+struct segtrees_t {
+  size_t n;                          ///< number of elements
+  size_t size;                       ///< size of elements
+  segtrees_data_combine combine;     ///< user provided combine function
+  segtrees_data_combine_r combine_r; ///< user provided reentrant combine
+  void *y;                           ///< argument to <tt>combine_r</tt>
+  char *id;                          ///< identity element
+  char *x;                           ///< tree, from position 1
+};
+
+static inline
+char *_at(segtrees_t t, size_t k)
+{
+  return t->x + k * t->size;
+}
+
+static inline
+void _combine(segtrees_t t, void *r, const void *x)
+{
+  if ( t->combine != NULL ) t->combine(r, x);
+  else t->combine_r(r, x, t->y);
+}
+
+/* position k from its children */
+static inline
+void _pull(segtrees_t t, size_t k)
+{
+  memcpy(_at(t, k), _at(t, 2 * k), t->size);
+  _combine(t, _at(t, k), _at(t, 2 * k + 1));
+}
+
+static
+segtrees_t _new(arrays_t a, const void *id, segtrees_data_combine combine,
+                segtrees_data_combine_r combine_r, void *y)
+{
+  segtrees_t t;
+  t = (segtrees_t)_amalloc(&allocators_std, sizeof(*t));
+  t->n = arrays_nmem(a);
+  t->size = arrays_size(a);
+  t->combine = combine;
+  t->combine_r = combine_r;
+  t->y = y;
+  t->id = (char*)_amalloc(&allocators_std, t->size);
+  memcpy(t->id, id, t->size);
+  t->x = (char*)_amalloc(&allocators_std, (2 * t->n + 1) * t->size);
+  if ( t->n != 0 ) memcpy(_at(t, t->n), arrays_at(a, 0), t->n * t->size);
+  for ( size_t k = t->n; k-- > 1; ) _pull(t, k);
+  return t;
+}
+
+segtrees_t segtrees_new(arrays_t a, const void *id,
+                        segtrees_data_combine combine)
+{
+  if ( combine == NULL ) error(1, errno, "combine pointer null");
+  return _new(a, id, combine, NULL, NULL);
+}
+
+segtrees_t segtrees_new_r(arrays_t a, const void *id,
+                          segtrees_data_combine_r combine_r, void *y)
+{
+  if ( combine_r == NULL ) error(1, errno, "combine pointer null");
+  return _new(a, id, NULL, combine_r, y);
+}
+
+void segtrees_free(segtrees_t *t)
+{
+  if ( *t == NULL ) return;
+  _afree(&allocators_std, (*t)->x);
+  _afree(&allocators_std, (*t)->id);
+  _afree(&allocators_std, *t);
+  *t = NULL;
+}
+
+void segtrees_set(segtrees_t t, size_t i, const void *x)
+{
+  size_t k = t->n + i;
+  memcpy(_at(t, k), x, t->size);
+  for ( k >>= 1; k != 0; k >>= 1 ) _pull(t, k);
+}
+
+const void *segtrees_at(segtrees_t t, size_t i)
+{
+  return _at(t, t->n + i);
+}
+
+/*
+ * The positions of the left end are combined as they are climbed past, those
+ * of the right end, one a level at most, once the ends meet, in reverse.
+ */
+void segtrees_query(segtrees_t t, size_t lo, size_t hi, void *r)
+{
+  size_t right[CHAR_BIT * sizeof(size_t)], m = 0;
+  memcpy(r, t->id, t->size);
+  for ( lo += t->n, hi += t->n; lo < hi; lo >>= 1, hi >>= 1 ) {
+    if ( lo & 1 ) _combine(t, r, _at(t, lo++));
+    if ( hi & 1 ) right[m++] = --hi;
+  }
+  while ( m != 0 ) _combine(t, r, _at(t, right[--m]));
+}
+
+size_t segtrees_nmem(segtrees_t t)
+{
+  return t->n;
+}
+
+size_t segtrees_size(segtrees_t t)
+{
+  return t->size;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file shardedhashtabs.c
+ * @brief Implementation of <tt>shashtabs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <shardedhashtabs.h>
+# include "allocs.h"
+
+/**
+ * @brief <tt>shashtabs_t</tt> class object.
+ */
+struct shashtabs_t {
+  size_t nshards;             ///< number of shards, a power of two
+  unsigned bits;              ///< high hash bits selecting a shard
+  shashtabs_data_cmp cmp;     ///< user defined compare function
+  shashtabs_data_cmp_r cmp_r; ///< user defined reentrant compare function
+  shashtabs_hash hash;        ///< user defined hashing function
+  shashtabs_hash_r hash_r;    ///< user defined reentrant hashing function
+  allocators_t al;            ///< allocator of the object and shard array
+  hashtabs_t *shards;         ///< shards
+};
+
+/**
+ * @brief State of one operation, handed to a shard as both of its reentrant
+ * arguments so that data is hashed once, by the sharded table.
+ */
+typedef struct {
+  shashtabs_t t;   ///< sharded table
+  void *queue_arg; ///< argument to user defined reentrant compare function
+  uint64_t h;      ///< hash value of data of the operation
+  int r;           ///< the operation is reentrant
+} op_t;
+
+/* hash of an operation, already computed */
+static
+uint64_t _op_hash(const void *x, const void *_c)
+{
+  (void)x;
+  return ((const op_t*)_c)->h;
+}
+
+static
+int _op_cmp(const void *x, const void *y, void *_c)
+{
+  op_t *c = (op_t*)_c;
+  return c->r ? c->t->cmp_r(x, y, c->queue_arg) : c->t->cmp(x, y);
+}
+
+static inline
+uint64_t _hash(shashtabs_t t, const void *x, const void *hash_arg, int r)
+{
+  return r ? t->hash_r(x, hash_arg) : t->hash(x);
+}
+
+static inline
+size_t _shardof(shashtabs_t t, uint64_t h)
+{
+  return t->bits ? (size_t)(h >> (64 - t->bits)) : 0;
+}
+
+shashtabs_t shashtabs_new(shashtabs_data_cmp cmp, shashtabs_data_cmp_r cmp_r,
+                          shashtabs_hash hash, shashtabs_hash_r hash_r,
+                          size_t n, size_t shards)
+{
+  shashtabs_t t;
+  size_t k = 1;
+  while ( k < shards ) k <<= 1;
+  allocators_t *al = (allocators_t*)_amalloc(&allocators_std,
+                                             k * sizeof(allocators_t));
+  for ( size_t i = 0; i < k; i++ ) al[i] = allocators_std;
+  t = shashtabs_new_alloc(cmp, cmp_r, hash, hash_r, n, k, al);
+  _afree(&allocators_std, al);
+  return t;
+}
+
+shashtabs_t shashtabs_new_alloc(shashtabs_data_cmp cmp,
+                                shashtabs_data_cmp_r cmp_r,
+                                shashtabs_hash hash, shashtabs_hash_r hash_r,
+                                size_t n, size_t shards,
+                                const allocators_t *al)
+{
+  shashtabs_t t;
+  t = (shashtabs_t)_amalloc(&al[0], sizeof(*t));
+  t->al = al[0];
+  t->cmp = cmp;
+  t->cmp_r = cmp_r;
+  t->hash = hash;
+  t->hash_r = hash_r;
+  t->nshards = 1;
+  t->bits = 0;
+  while ( t->nshards < shards ) t->nshards <<= 1, t->bits++;
+  t->shards = (hashtabs_t*)_amalloc(&t->al, t->nshards * sizeof(hashtabs_t));
+  /* shards hash through _op_hash; their own hash and cmp serve rehash */
+  for ( size_t i = 0; i < t->nshards; i++ )
+    t->shards[i] = hashtabs_new_alloc(cmp, _op_cmp, hash, _op_hash,
+                                      n / t->nshards + 1, &al[i]);
+  return t;
+}
+
+void shashtabs_insert(shashtabs_t t, const void *x)
+{
+  op_t c = { t, NULL, _hash(t, x, NULL, 0), 0 };
+  hashtabs_insert_r(t->shards[_shardof(t, c.h)], x, &c, &c);
+}
+
+void shashtabs_insert_r(shashtabs_t t, const void *x, const void *hash_arg,
+                        void *queue_arg)
+{
+  op_t c = { t, queue_arg, _hash(t, x, hash_arg, 1), 1 };
+  hashtabs_insert_r(t->shards[_shardof(t, c.h)], x, &c, &c);
+}
+
+void *shashtabs_remove(shashtabs_t t, const void *x)
+{
+  op_t c = { t, NULL, _hash(t, x, NULL, 0), 0 };
+  return hashtabs_remove_r(t->shards[_shardof(t, c.h)], x, &c, &c);
+}
+
+void *shashtabs_remove_r(shashtabs_t t, const void *x, const void *hash_arg,
+                         void *queue_arg)
+{
+  op_t c = { t, queue_arg, _hash(t, x, hash_arg, 1), 1 };
+  return hashtabs_remove_r(t->shards[_shardof(t, c.h)], x, &c, &c);
+}
+
+void *shashtabs_find(shashtabs_t t, const void *x)
+{
+  op_t c = { t, NULL, _hash(t, x, NULL, 0), 0 };
+  return hashtabs_find_r(t->shards[_shardof(t, c.h)], x, &c, &c);
+}
+
+void *shashtabs_find_r(shashtabs_t t, const void *x, const void *hash_arg,
+                       void *queue_arg)
+{
+  op_t c = { t, queue_arg, _hash(t, x, hash_arg, 1), 1 };
+  return hashtabs_find_r(t->shards[_shardof(t, c.h)], x, &c, &c);
+}
+
+int shashtabs_map(shashtabs_t t, int apply(void **x))
+{
+  for ( size_t i = 0; i < t->nshards; i++ )
+    if ( hashtabs_map(t->shards[i], apply) < 0 ) return -1;
+  return 1;
+}
+
+int shashtabs_map_r(shashtabs_t t, int apply(void **x, void *y), void *y)
+{
+  for ( size_t i = 0; i < t->nshards; i++ )
+    if ( hashtabs_map_r(t->shards[i], apply, y) < 0 ) return -1;
+  return 1;
+}
+
+void shashtabs_free(shashtabs_t *t)
+{
+  if ( *t == NULL ) return;
+  allocators_t al = (*t)->al;
+  for ( size_t i = 0; i < (*t)->nshards; i++ )
+    hashtabs_free(&(*t)->shards[i]);
+  _afree(&al, (*t)->shards);
+  _afree(&al, *t);
+  *t = NULL;
+}
+
+size_t shashtabs_size(shashtabs_t t)
+{
+  size_t n = 0;
+  for ( size_t i = 0; i < t->nshards; i++ ) n += hashtabs_size(t->shards[i]);
+  return n;
+}
+
+size_t shashtabs_shards(shashtabs_t t)
+{
+  return t->nshards;
+}
+
+size_t shashtabs_shardof(shashtabs_t t, const void *x)
+{
+  return _shardof(t, _hash(t, x, NULL, 0));
+}
+
+size_t shashtabs_shardof_r(shashtabs_t t, const void *x, const void *hash_arg)
+{
+  return _shardof(t, _hash(t, x, hash_arg, 1));
+}
+
+hashtabs_t shashtabs_shard(shashtabs_t t, size_t i)
+{
+  return t->shards[i];
+}
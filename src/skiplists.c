@@ -0,0 +1,235 @@
+/**
+ * @file skiplists.c
+ * @brief Implementation of <tt>skiplists_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <skiplists.h>
+# include <stdint.h>
+# define COUNTS_KIND COUNTERS_SKIPLISTS
+# include "allocs.h"
+
+/**
+ * @brief Internal structure for <tt>skiplists_t</tt> object.
+ */
+struct skiplists_node_t {
+  void *x;                         ///< pointer to data object
+  struct skiplists_node_t *next[]; ///< successors, one per level of the node
+};
+typedef struct skiplists_node_t skiplists_node_t;
+
+/**
+ * @brief <tt>skiplists_t</tt> class object.
+ */
+struct skiplists_t {
+  size_t size;                ///< number of elements in skip list
+  size_t level;               ///< number of levels in use
+  uint64_t rand;              ///< state of the level generator
+  skiplists_data_cmp cmp;     ///< user provided compare function
+  skiplists_data_cmp_r cmp_r; ///< user provided reentrant compare function
+  skiplists_node_t *head;     ///< sentinel holding the first node of each level
+  skiplists_node_t *tail;     ///< last node of the bottom level
+  allocators_t al;            ///< allocator of the skip list
+};
+
+skiplists_t skiplists_new(skiplists_data_cmp cmp, skiplists_data_cmp_r cmp_r)
+{
+  return skiplists_new_alloc(cmp, cmp_r, &allocators_std);
+}
+
+skiplists_t skiplists_new_alloc(skiplists_data_cmp cmp,
+                                skiplists_data_cmp_r cmp_r,
+                                const allocators_t *al)
+{
+  if ( cmp == NULL && cmp_r == NULL ) error(1, errno, "cmp pointers null");
+  skiplists_t s;
+  s = (skiplists_t)_amalloc(al, sizeof(*s));
+  s->al = *al;
+  s->size = 0;
+  s->level = 1;
+  s->rand = 0x9e3779b97f4a7c15ull;
+  s->cmp = cmp;
+  s->cmp_r = cmp_r;
+  s->head = (skiplists_node_t*)_acalloc(al, 1, sizeof(skiplists_node_t)
+                                        + SKIPLISTS_MAXLEVEL
+                                        * sizeof(skiplists_node_t*));
+  s->tail = NULL;
+  return s;
+}
+
+static inline
+int _cmp(skiplists_t s, const void *x, const void *y, void *arg, int r)
+{
+  return r ? s->cmp_r(x, y, arg) : s->cmp(x, y);
+}
+
+/* level of a new node: each level is kept with probability 1/4 */
+static inline
+size_t _level(skiplists_t s)
+{
+  size_t level = 1;
+  s->rand ^= s->rand << 13;
+  s->rand ^= s->rand >> 7;
+  s->rand ^= s->rand << 17;
+  for ( uint64_t b = s->rand; (b & 3) == 0 && level < SKIPLISTS_MAXLEVEL;
+        b >>= 2 )
+    level++;
+  return level;
+}
+
+/*
+ * fill p with the last node before x on each level in use, and return the node
+ * after it on the bottom level if it holds data equal to x, else NULL
+ */
+static
+skiplists_node_t *_search(skiplists_t s, const void *x, void *arg, int r,
+                          skiplists_node_t **p)
+{
+  skiplists_node_t *n = s->head;
+  int c = 1;
+  for ( size_t i = s->level; i-- > 0; ) {
+    while ( n->next[i] != NULL && (c = _cmp(s, x, n->next[i]->x, arg, r)) > 0 )
+      n = n->next[i];
+    p[i] = n;
+    if ( c == 0 ) {
+      /* x is found; lower levels need no further compares */
+      skiplists_node_t *t = n->next[i];
+      while ( i-- > 0 ) {
+        while ( n->next[i] != t ) n = n->next[i];
+        p[i] = n;
+      }
+      return t;
+    }
+  }
+  return NULL;
+}
+
+/* unlink node n whose predecessors are p */
+static
+void _unlink(skiplists_t s, skiplists_node_t *n, skiplists_node_t **p)
+{
+  for ( size_t i = 0; i < s->level && p[i]->next[i] == n; i++ )
+    p[i]->next[i] = n->next[i];
+  if ( s->tail == n ) s->tail = p[0] == s->head ? NULL : p[0];
+  while ( s->level > 1 && s->head->next[s->level - 1] == NULL ) s->level--;
+  _afree(&s->al, n);
+  s->size--;
+}
+
+static
+void _insert(skiplists_t s, const void *x, void *arg, int r)
+{
+  skiplists_node_t *p[SKIPLISTS_MAXLEVEL], *n;
+  if ( _search(s, x, arg, r, p) != NULL ) return;
+  size_t level = _level(s);
+  for ( ; s->level < level; s->level++ ) p[s->level] = s->head;
+  n = (skiplists_node_t*)_amalloc(&s->al, sizeof(skiplists_node_t)
+                                  + level * sizeof(skiplists_node_t*));
+  n->x = (void*)x;
+  for ( size_t i = 0; i < level; i++ ) {
+    n->next[i] = p[i]->next[i];
+    p[i]->next[i] = n;
+  }
+  if ( n->next[0] == NULL ) s->tail = n;
+  s->size++;
+}
+
+void skiplists_insert(skiplists_t s, const void *x)
+{
+  _insert(s, x, NULL, 0);
+}
+
+void skiplists_insert_r(skiplists_t s, const void *x, void *y)
+{
+  _insert(s, x, y, 1);
+}
+
+void *skiplists_dequeue_front(skiplists_t s)
+{
+  skiplists_node_t *p[SKIPLISTS_MAXLEVEL], *n = s->head->next[0];
+  if ( n == NULL ) return NULL;
+  void *x = n->x;
+  for ( size_t i = 0; i < s->level; i++ ) p[i] = s->head;
+  _unlink(s, n, p);
+  return x;
+}
+
+void *skiplists_dequeue_back(skiplists_t s)
+{
+  skiplists_node_t *p[SKIPLISTS_MAXLEVEL], *n = s->head, *tail = s->tail;
+  if ( tail == NULL ) return NULL;
+  void *x = tail->x;
+  /* search for a key above every other, stopping in front of the tail */
+  for ( size_t i = s->level; i-- > 0; ) {
+    while ( n->next[i] != NULL && n->next[i] != tail ) n = n->next[i];
+    p[i] = n;
+  }
+  _unlink(s, tail, p);
+  return x;
+}
+
+void *skiplists_find(skiplists_t s, const void *x)
+{
+  skiplists_node_t *p[SKIPLISTS_MAXLEVEL], *n = _search(s, x, NULL, 0, p);
+  return n == NULL ? NULL : n->x;
+}
+
+void *skiplists_find_r(skiplists_t s, const void *x, void *y)
+{
+  skiplists_node_t *p[SKIPLISTS_MAXLEVEL], *n = _search(s, x, y, 1, p);
+  return n == NULL ? NULL : n->x;
+}
+
+static
+void *_remove(skiplists_t s, const void *_x, void *arg, int r)
+{
+  skiplists_node_t *p[SKIPLISTS_MAXLEVEL], *n;
+  if ( (n = _search(s, _x, arg, r, p)) == NULL ) return NULL;
+  void *x = n->x;
+  _unlink(s, n, p);
+  return x;
+}
+
+void *skiplists_remove(skiplists_t s, const void *x)
+{
+  return _remove(s, x, NULL, 0);
+}
+
+void *skiplists_remove_r(skiplists_t s, const void *x, void *y)
+{
+  return _remove(s, x, y, 1);
+}
+
+int skiplists_map(skiplists_t s, int apply(void **x))
+{
+  if ( s == NULL ) return 1;
+  for ( skiplists_node_t *n = s->head->next[0]; n != NULL; n = n->next[0] )
+    if ( apply(&n->x) < 0 ) return -1;
+  return 1;
+}
+
+int skiplists_map_r(skiplists_t s, int apply(void **x, void *y), void *y)
+{
+  if ( s == NULL ) return 1;
+  for ( skiplists_node_t *n = s->head->next[0]; n != NULL; n = n->next[0] )
+    if ( apply(&n->x, y) < 0 ) return -1;
+  return 1;
+}
+
+void skiplists_free(skiplists_t *s)
+{
+  if ( *s == NULL ) return;
+  allocators_t al = (*s)->al;
+  skiplists_node_t *n = (*s)->head, *next;
+  for ( ; n != NULL; n = next ) {
+    next = n->next[0];
+    _afree(&al, n);
+  }
+  _afree(&al, *s);
+  *s = NULL;
+}
+
+size_t skiplists_size(skiplists_t s)
+{
+  return s->size;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file spillqueues.c
+ * @brief Implementation of <tt>spillqueues_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <spillqueues.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include "allocs.h"
+
+/**
+ * @brief Bytes of a segment if none are given.
+ */
+# define SEGMENT (1UL << 20)
+
+/**
+ * @brief <tt>spillqueues_t</tt> class object.
+ */
+struct spillqueues_t {
+  size_t size;  ///< size of elements
+  size_t seg;   ///< number of elements of a segment
+  size_t nmem;  ///< number of elements
+  char *head;   ///< elements popped next, from <tt>hr</tt> to <tt>hn</tt>
+  size_t hr;    ///< index of front element in head
+  size_t hn;    ///< number of elements of head
+  char *tail;   ///< elements pushed last, after those of the file
+  size_t tn;    ///< number of elements of tail
+  int fd;       ///< unlinked temporary file, -1 until the first spill
+  off_t rd;     ///< offset of the oldest segment of the file
+  off_t wr;     ///< end of the segments of the file
+  char *dir;    ///< directory of the temporary file
+};
+
+spillqueues_t spillqueues_new(size_t size, size_t segment, const char *dir)
+{
+  spillqueues_t q;
+  if ( dir == NULL && (dir = getenv("TMPDIR")) == NULL ) dir = "/tmp";
+  q = (spillqueues_t)_amalloc(&allocators_std, sizeof(*q));
+  q->size = size;
+  q->seg = (segment ? segment : SEGMENT) / size;
+  if ( q->seg == 0 ) q->seg = 1;
+  q->nmem = q->hr = q->hn = q->tn = 0;
+  q->head = (char*)_amalloc(&allocators_std, q->seg * size);
+  q->tail = (char*)_amalloc(&allocators_std, q->seg * size);
+  q->fd = -1;
+  q->rd = q->wr = 0;
+  q->dir = (char*)_amalloc(&allocators_std, strlen(dir) + 1);
+  strcpy(q->dir, dir);
+  return q;
+}
+
+void spillqueues_free(spillqueues_t *q)
+{
+  if ( *q == NULL ) return;
+  if ( (*q)->fd >= 0 ) close((*q)->fd);
+  _afree(&allocators_std, (*q)->head);
+  _afree(&allocators_std, (*q)->tail);
+  _afree(&allocators_std, (*q)->dir);
+  _afree(&allocators_std, *q);
+  *q = NULL;
+}
+
+/* temporary file, unlinked at once so that it goes with its descriptor */
+static
+void _open(spillqueues_t q)
+{
+  static const char name[] = "/spillqueues-XXXXXX";
+  size_t n = strlen(q->dir);
+  char *path = (char*)_amalloc(&allocators_std, n + sizeof(name));
+  memcpy(path, q->dir, n);
+  memcpy(path + n, name, sizeof(name));
+  if ( (q->fd = mkstemp(path)) < 0 ) error(1, errno, "%s", path);
+  unlink(path);
+  _afree(&allocators_std, path);
+}
+
+/* the tail, full, written as the newest segment */
+static
+void _spill(spillqueues_t q)
+{
+  size_t len = q->seg * q->size, done = 0;
+  if ( q->fd < 0 ) _open(q);
+  while ( done < len ) {
+    ssize_t r = pwrite(q->fd, q->tail + done, len - done, q->wr + done);
+    if ( r < 0 && errno == EINTR ) continue;
+    if ( r < 0 ) error(1, errno, "spill write failure");
+    done += (size_t)r;
+  }
+  q->wr += len;
+  q->tn = 0;
+}
+
+/*
+ * the oldest segment read into the head; the file is emptied once all are
+ * read, and otherwise the next segment is read ahead and the space of this
+ * one given back
+ */
+static
+void _unspill(spillqueues_t q)
+{
+  size_t len = q->seg * q->size, done = 0;
+  while ( done < len ) {
+    ssize_t r = pread(q->fd, q->head + done, len - done, q->rd + done);
+    if ( r < 0 && errno == EINTR ) continue;
+    if ( r <= 0 ) error(1, r < 0 ? errno : EIO, "spill read failure");
+    done += (size_t)r;
+  }
+  q->hr = 0;
+  q->hn = q->seg;
+  q->rd += len;
+  if ( q->rd == q->wr ) {
+    if ( ftruncate(q->fd, 0) < 0 ) error(1, errno, "spill truncate failure");
+    q->rd = q->wr = 0;
+    return;
+  }
+# ifdef HAVE_POSIX_FADVISE
+  (void)posix_fadvise(q->fd, q->rd, (off_t)len, POSIX_FADV_WILLNEED);
+# endif
+# if defined(HAVE_FALLOCATE) && defined(FALLOC_FL_PUNCH_HOLE)
+  (void)fallocate(q->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  q->rd - (off_t)len, (off_t)len);
+# endif
+}
+
+/* while file and tail are empty, the back of the head is that of the queue */
+void spillqueues_push(spillqueues_t q, const void *x)
+{
+  if ( q->nmem == 0 ) q->hr = q->hn = 0;
+  if ( q->rd == q->wr && q->tn == 0 && q->hn < q->seg )
+    memcpy(q->head + q->hn++ * q->size, x, q->size);
+  else {
+    memcpy(q->tail + q->tn++ * q->size, x, q->size);
+    if ( q->tn == q->seg ) _spill(q);
+  }
+  q->nmem++;
+}
+
+int spillqueues_pop(spillqueues_t q, void *x)
+{
+  if ( q->hr == q->hn ) {
+    if ( q->rd != q->wr ) _unspill(q);
+    else if ( q->tn != 0 ) {
+      char *t = q->head;
+      q->head = q->tail;
+      q->tail = t;
+      q->hr = 0;
+      q->hn = q->tn;
+      q->tn = 0;
+    }
+    else return -1;
+  }
+  if ( x != NULL ) memcpy(x, q->head + q->hr * q->size, q->size);
+  q->hr++;
+  q->nmem--;
+  return 1;
+}
+
+size_t spillqueues_nmem(spillqueues_t q)
+{
+  return q->nmem;
+}
+
+size_t spillqueues_spilled(spillqueues_t q)
+{
+  return (size_t)(q->wr - q->rd) / q->size;
+}
+
+size_t spillqueues_size(spillqueues_t q)
+{
+  return q->size;
+}
@@ -3,7 +3,26 @@
  * @author Thomas Pender
  */
 # include <config.h>
+# undef CONTAINERS_INLINE
 # include <stacks.h>
+# include <pools.h>
+# include <stdint.h>
+# include <errno.h>
+# include <error.h>
+# define COUNTS_KIND COUNTERS_STACKS
+# include "allocs.h"
+
+/**
+ * @brief Number of links of the first chunk of a compact stack, as a power of
+ * two.
+ */
+# define SHIFT 6
+
+/**
+ * @brief Number of chunks of a compact stack; chunk k holds
+ * <tt>2^(k + SHIFT)</tt> links.
+ */
+# define NCHUNKS (33 - SHIFT)
 
 /**
  * @brief Internal structure for <tt>stacks_t</tt> object.
@@ -16,26 +35,138 @@ typedef struct stacks_node_t stacks_node_t;
 
 /**
  * @brief <tt>stacks_t</tt> class object.
+ *
+ * Links are handled as <tt>stacks_node_t</tt> pointers. In a compact stack such
+ * a pointer is not an address but the 32-bit index of a link in the chunks, 0
+ * standing for <tt>NULL</tt>. A chunk of a compact stack holds the data
+ * pointers of its links followed by their next indices, since a link of a
+ * pointer and an index would be padded back to the size of a pooled one.
  */
 struct stacks_t {
   size_t size;         ///< number of elements in stack
   stacks_node_t *head; ///< pointer to top of stack
+  pools_t pool;        ///< pool of links, <tt>NULL</tt> if not pooled
+  void ***chunks;      ///< chunks of links, <tt>NULL</tt> if not compact
+  uint32_t fresh;      ///< links ever taken from the chunks
+  uint32_t unused;     ///< index of top free link of chunks, 0 if none
+  allocators_t al;     ///< allocator of the stack
 };
 
+_Static_assert(offsetof(struct stacks_t, size) == 0,
+               "inline stacks_size reads the first member of struct stacks_t");
+
 stacks_t stacks_new(void)
+{
+  return stacks_new_alloc(&allocators_std);
+}
+
+stacks_t stacks_new_alloc(const allocators_t *al)
 {
   stacks_t s;
-  s = (stacks_t)malloc(sizeof(*s));
+  s = (stacks_t)_amalloc(al, sizeof(*s));
+  s->al = *al;
   s->size = 0;
   s->head = NULL;
+  s->pool = NULL;
+  s->chunks = NULL;
+  s->fresh = s->unused = 0;
+  return s;
+}
+
+stacks_t stacks_new_pooled(void)
+{
+  stacks_t s = stacks_new();
+  s->pool = pools_new(sizeof(stacks_node_t), 0);
   return s;
 }
 
+stacks_t stacks_new_compact(void)
+{
+  stacks_t s = stacks_new();
+  s->chunks = (void***)_acalloc(&s->al, NCHUNKS, sizeof(void**));
+  return s;
+}
+
+static inline
+uint32_t _index(const stacks_node_t *n)
+{
+  return (uint32_t)(uintptr_t)n;
+}
+
+static inline
+stacks_node_t *_handle(uint32_t i)
+{
+  return (stacks_node_t*)(uintptr_t)i;
+}
+
+/* chunk of link i > 0 of a compact stack, and its offset in the chunk */
+static inline
+unsigned _chunk(uint32_t i, uint64_t *off)
+{
+  uint64_t j = (uint64_t)i + (1u << SHIFT) - 1;
+  unsigned k = 63 - __builtin_clzll(j) - SHIFT;
+  *off = j - ((uint64_t)1 << (k + SHIFT));
+  return k;
+}
+
+/* next index of link i > 0 of a compact stack */
+static inline
+uint32_t *_link(stacks_t s, uint32_t i)
+{
+  uint64_t off;
+  unsigned k = _chunk(i, &off);
+  return (uint32_t*)(s->chunks[k] + ((size_t)1 << (k + SHIFT))) + off;
+}
+
+/* the data pointer and next link of link n */
+static inline
+void **_x(stacks_t s, stacks_node_t *n)
+{
+  uint64_t off;
+  if ( s->chunks == NULL ) return &n->x;
+  unsigned k = _chunk(_index(n), &off);
+  return s->chunks[k] + off;
+}
+
+static inline
+stacks_node_t *_next(stacks_t s, stacks_node_t *n)
+{
+  return s->chunks != NULL ? _handle(*_link(s, _index(n))) : n->next;
+}
+
+/* free link of the chunks, allocating the chunk of a fresh one if need be */
+static
+stacks_node_t *_take(stacks_t s)
+{
+  uint32_t i = s->unused;
+  if ( i != 0 ) {
+    s->unused = *_link(s, i);
+    return _handle(i);
+  }
+  i = ++s->fresh;
+  if ( i == 0 ) error(1, ENOMEM, "stacks_t links exhausted");
+  uint64_t off;
+  unsigned k = _chunk(i, &off);
+  if ( s->chunks[k] == NULL )
+    s->chunks[k] = (void**)_amalloc(&s->al, ((size_t)1 << (k + SHIFT))
+                                    * (sizeof(void*) + sizeof(uint32_t)));
+  return _handle(i);
+}
+
 void stacks_push(stacks_t s, void *x)
 {
-  stacks_node_t *tmp = (stacks_node_t*)malloc(sizeof(stacks_node_t));
-  tmp->x = (void*)x;
-  tmp->next = s->head;
+  stacks_node_t *tmp;
+  if ( s->chunks != NULL ) {
+    tmp = _take(s);
+    *_link(s, _index(tmp)) = _index(s->head);
+  }
+  else {
+    tmp = s->pool != NULL
+      ? (stacks_node_t*)pools_alloc(s->pool)
+      : (stacks_node_t*)_amalloc(&s->al, sizeof(stacks_node_t));
+    tmp->next = s->head;
+  }
+  *_x(s, tmp) = (void*)x;
   s->head = tmp;
   s->size++;
 }
@@ -43,25 +174,54 @@ void stacks_push(stacks_t s, void *x)
 void *stacks_pop(stacks_t s)
 {
   stacks_node_t *tmp = s->head;
-  s->head = s->head->next;
-  void *x = tmp->x;
-  free(tmp);
+  void *x = *_x(s, tmp);
+  s->head = _next(s, tmp);
+  if ( s->chunks != NULL ) {
+    *_link(s, _index(tmp)) = s->unused;
+    s->unused = _index(tmp);
+  }
+  else if ( s->pool != NULL ) pools_release(s->pool, tmp);
+  else _afree(&s->al, tmp);
   s->size--;
   return x;
 }
 
+/* chunks of a compact stack, and the array of them */
+static
+void _free_chunks(stacks_t s)
+{
+  for ( size_t k = 0; k < NCHUNKS; k++ ) _afree(&s->al, s->chunks[k]);
+  _afree(&s->al, s->chunks);
+}
+
 void stacks_free(stacks_t *s)
 {
   if ( *s == NULL ) return;
-  while ( (*s)->head != NULL ) {
+  allocators_t al = (*s)->al;
+  if ( (*s)->chunks != NULL ) _free_chunks(*s);
+  else if ( (*s)->pool != NULL ) pools_free(&(*s)->pool);
+  else while ( (*s)->head != NULL ) {
     stacks_node_t *tmp = (*s)->head;
     (*s)->head = (*s)->head->next;
-    free(tmp);
+    _afree(&al, tmp);
   }
-  free(*s);
+  _afree(&al, *s);
   *s = NULL;
 }
 
+void stacks_clear(stacks_t s)
+{
+  if ( s->chunks != NULL ) s->fresh = s->unused = 0;
+  else if ( s->pool != NULL ) pools_clear(s->pool);
+  else while ( s->head != NULL ) {
+    stacks_node_t *tmp = s->head;
+    s->head = s->head->next;
+    _afree(&s->al, tmp);
+  }
+  s->head = NULL;
+  s->size = 0;
+}
+
 int stacks_empty(stacks_t s)
 {
   return s->size == 0;
@@ -77,8 +237,8 @@ int stacks_map(stacks_t s, int apply(void **x))
   if ( s == NULL ) return 1;
   stacks_node_t *tmp = s->head;
   while ( tmp != NULL ) {
-    if ( apply(&tmp->x) < 0 ) return -1;
-    tmp = tmp->next;
+    if ( apply(_x(s, tmp)) < 0 ) return -1;
+    tmp = _next(s, tmp);
   }
   return 1;
 }
@@ -88,8 +248,29 @@ int stacks_map_r(stacks_t s, int apply(void **x, void *y), void *y)
   if ( s == NULL ) return 1;
   stacks_node_t *tmp = s->head;
   while ( tmp != NULL ) {
-    if ( apply(&tmp->x, y) < 0 ) return -1;
-    tmp = tmp->next;
+    if ( apply(_x(s, tmp), y) < 0 ) return -1;
+    tmp = _next(s, tmp);
   }
   return 1;
 }
+
+/* cursor at link n of stack s, or past the end if n is NULL */
+static inline
+int _at(stacks_t s, stacks_iter_t *it, stacks_node_t *n)
+{
+  it->s = s;
+  it->node = n;
+  if ( n == NULL ) return -1;
+  it->x = *_x(s, n);
+  return 1;
+}
+
+int stacks_iterinit(stacks_t s, stacks_iter_t *it)
+{
+  return _at(s, it, s->head);
+}
+
+int stacks_iternext(stacks_iter_t *it)
+{
+  return _at(it->s, it, _next(it->s, (stacks_node_t*)it->node));
+}
@@ -0,0 +1,44 @@
+/**
+ * @file sweeps.h
+ * @brief Predicate and disposal of the bulk removals of the containers.
+ *
+ * The <tt>remove_if</tt> calls of the queues and hash tables, reentrant or
+ * not, walk their container once and unlink every element passing a user
+ * predicate, handing each to an optional disposal function before its link or
+ * record is released.
+ *
+ * This header is private to the library.
+ * @author Thomas Pender
+ */
+# ifndef INCLUDED_SWEEPS_H
+# define INCLUDED_SWEEPS_H
+
+# include <stddef.h>
+
+/**
+ * @brief Predicate and disposal functions of a sweep, reentrant or not.
+ */
+typedef struct {
+  int (*pred)(const void*);            ///< predicate
+  int (*pred_r)(const void*, void*);   ///< reentrant predicate
+  void (*dispose)(void*);              ///< disposal, or NULL
+  void (*dispose_r)(void*, void*);     ///< reentrant disposal, or NULL
+  void *y;                             ///< argument to reentrant ones
+} sweeps_t;
+
+/* whether x is to be removed */
+static inline
+int _sweep_test(const sweeps_t *s, const void *x)
+{
+  return (s->pred != NULL ? s->pred(x) : s->pred_r(x, s->y)) > 0;
+}
+
+/* hand removed x to the disposal function, if any */
+static inline
+void _sweep_dispose(const sweeps_t *s, void *x)
+{
+  if ( s->dispose != NULL ) s->dispose(x);
+  else if ( s->dispose_r != NULL ) s->dispose_r(x, s->y);
+}
+
+# endif
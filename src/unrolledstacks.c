@@ -0,0 +1,147 @@
+/**
+ * @file unrolledstacks.c
+ * @brief Implementation of <tt>ustacks_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <unrolledstacks.h>
+# include <stdalign.h>
+# define COUNTS_KIND COUNTERS_UNROLLEDSTACKS
+# include "allocs.h"
+
+/**
+ * @brief Chunk of elements of a stack.
+ */
+typedef struct chunk_t {
+  struct chunk_t *next;          ///< chunk below, <tt>NULL</tt> if bottom
+  alignas(max_align_t) char x[]; ///< elements, bottom first
+} chunk_t;
+
+/**
+ * @brief <tt>ustacks_t</tt> class object.
+ */
+struct ustacks_t {
+  size_t size;     ///< size of elements of stack
+  size_t per;      ///< number of elements per chunk
+  size_t nmem;     ///< number of elements in stack
+  size_t top;      ///< number of elements in top chunk
+  chunk_t *head;   ///< top chunk, <tt>NULL</tt> if never pushed
+  chunk_t *spare;  ///< chunks emptied since the last push, linked by next
+  allocators_t al; ///< allocator of the stack
+};
+
+ustacks_t ustacks_new(size_t size)
+{
+  return ustacks_new_alloc(size, &allocators_std);
+}
+
+ustacks_t ustacks_new_alloc(size_t size, const allocators_t *al)
+{
+  ustacks_t s;
+  s = (ustacks_t)_amalloc(al, sizeof(*s));
+  s->al = *al;
+  s->size = size;
+  s->per = size >= USTACKS_CHUNK - sizeof(chunk_t)
+    ? 1 : (USTACKS_CHUNK - sizeof(chunk_t)) / size;
+  s->nmem = s->top = 0;
+  s->head = s->spare = NULL;
+  return s;
+}
+
+/* free the spares but the first, the elements popped from them being dead */
+static
+void _trim(ustacks_t s)
+{
+  chunk_t *c = s->spare->next;
+  s->spare->next = NULL;
+  while ( c != NULL ) {
+    chunk_t *next = c->next;
+    _afree(&s->al, c);
+    c = next;
+  }
+}
+
+void ustacks_push(ustacks_t s, const void *x)
+{
+  if ( s->spare != NULL && s->spare->next != NULL ) _trim(s);
+  if ( s->head == NULL || s->top == s->per ) {
+    chunk_t *c = s->spare;
+    if ( c != NULL ) s->spare = NULL;
+    else c = (chunk_t*)_amalloc(&s->al, sizeof(chunk_t) + s->per * s->size);
+    c->next = s->head;
+    s->head = c;
+    s->top = 0;
+  }
+  memcpy(s->head->x + s->top * s->size, x, s->size);
+  s->top++;
+  s->nmem++;
+}
+
+void *ustacks_pop(ustacks_t s)
+{
+  if ( s->nmem == 0 ) return NULL;
+  chunk_t *c = s->head;
+  void *x = c->x + --s->top * s->size;
+  s->nmem--;
+  if ( s->top == 0 && c->next != NULL ) {
+    /* keep the emptied chunk; x stays valid until the next push */
+    s->head = c->next;
+    s->top = s->per;
+    c->next = s->spare;
+    s->spare = c;
+  }
+  return x;
+}
+
+void *ustacks_top(ustacks_t s)
+{
+  return s->nmem == 0 ? NULL : s->head->x + (s->top - 1) * s->size;
+}
+
+void ustacks_free(ustacks_t *s)
+{
+  if ( s == NULL || *s == NULL ) return;
+  allocators_t al = (*s)->al;
+  while ( (*s)->head != NULL ) {
+    chunk_t *c = (*s)->head;
+    (*s)->head = c->next;
+    _afree(&al, c);
+  }
+  while ( (*s)->spare != NULL ) {
+    chunk_t *c = (*s)->spare;
+    (*s)->spare = c->next;
+    _afree(&al, c);
+  }
+  _afree(&al, *s);
+  *s = NULL;
+}
+
+int ustacks_empty(ustacks_t s)
+{
+  return s->nmem == 0;
+}
+
+size_t ustacks_size(ustacks_t s)
+{
+  return s->nmem;
+}
+
+int ustacks_map(ustacks_t s, int apply(void *x))
+{
+  if ( s->nmem == 0 ) return 1;
+  size_t n = s->top;
+  for ( chunk_t *c = s->head; c != NULL; c = c->next, n = s->per )
+    while ( n-- > 0 )
+      if ( apply(c->x + n * s->size) < 0 ) return -1;
+  return 1;
+}
+
+int ustacks_map_r(ustacks_t s, int apply(void *x, void *y), void *y)
+{
+  if ( s->nmem == 0 ) return 1;
+  size_t n = s->top;
+  for ( chunk_t *c = s->head; c != NULL; c = c->next, n = s->per )
+    while ( n-- > 0 )
+      if ( apply(c->x + n * s->size, y) < 0 ) return -1;
+  return 1;
+}
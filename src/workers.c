@@ -0,0 +1,208 @@
+/**
+ * @file workers.c
+ * @brief Implementation of <tt>workers_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <workers.h>
+# include <wsdeques.h>
+# include <stdint.h>
+# include <stdatomic.h>
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+# include <errno.h>
+# include <error.h>
+
+/**
+ * @brief Initial capacity of the deque of each worker.
+ */
+# define DEQUE 256
+
+/**
+ * @brief <tt>workers_t</tt> class object.
+ */
+struct workers_t {
+  size_t n;              ///< number of workers, the caller of run included
+  pthread_t *th;         ///< threads of workers 1 to n - 1
+  wsdeques_t *dq;        ///< deque of tasks of each worker
+  workers_task apply;    ///< task function of the current run
+  void *y;               ///< argument to apply of the current run
+  atomic_size_t pending; ///< tasks spawned and not yet finished
+  atomic_int stop;       ///< remaining tasks are to be dropped
+  pthread_mutex_t lock;  ///< guards the fields below
+  pthread_cond_t go;     ///< a run has started, or the pool is being freed
+  pthread_cond_t done;   ///< a worker has left the run
+  size_t gen;            ///< number of runs started
+  size_t active;         ///< workers 1 to n - 1 still in the current run
+  int quit;              ///< the pool is being freed
+};
+
+/**
+ * @brief Worker of the calling thread.
+ */
+typedef struct {
+  workers_t w;   ///< pool being worked for
+  size_t id;     ///< index of worker
+  uint64_t rand; ///< state of victim choice
+} self_t;
+
+static _Thread_local self_t _self;
+
+/* take a task from the deque of another worker, starting at a random one */
+static
+void *_steal(workers_t w, size_t id)
+{
+  void *x;
+  _self.rand ^= _self.rand << 13;
+  _self.rand ^= _self.rand >> 7;
+  _self.rand ^= _self.rand << 17;
+  for ( size_t k = 0, v = _self.rand % w->n; k < w->n; k++, v++ ) {
+    if ( v == w->n ) v = 0;
+    if ( v != id && (x = wsdeques_steal(w->dq[v])) != NULL ) return x;
+  }
+  return NULL;
+}
+
+static
+void _work(workers_t w, size_t id)
+{
+  void *x;
+  unsigned spins = 0;
+  _self.w = w;
+  _self.id = id;
+  _self.rand = 0x9e3779b97f4a7c15ull * (id + 1);
+  for ( ;; ) {
+    if ( (x = wsdeques_pop(w->dq[id])) == NULL
+         && (x = _steal(w, id)) == NULL ) {
+      if ( atomic_load_explicit(&w->pending, memory_order_acquire) == 0 ) break;
+      if ( ++spins > 64 ) sched_yield();
+      continue;
+    }
+    spins = 0;
+    if ( !atomic_load_explicit(&w->stop, memory_order_relaxed) )
+      w->apply(w, x, w->y);
+    atomic_fetch_sub_explicit(&w->pending, 1, memory_order_acq_rel);
+  }
+  _self.w = NULL;
+}
+
+static
+void *_thread(void *arg)
+{
+  workers_t w = (workers_t)((void**)arg)[0];
+  size_t id = (size_t)(uintptr_t)((void**)arg)[1], gen = 0;
+  free(arg);
+  pthread_mutex_lock(&w->lock);
+  for ( ;; ) {
+    while ( w->gen == gen && !w->quit ) pthread_cond_wait(&w->go, &w->lock);
+    if ( w->quit ) break;
+    gen = w->gen;
+    pthread_mutex_unlock(&w->lock);
+    _work(w, id);
+    pthread_mutex_lock(&w->lock);
+    if ( --w->active == 0 ) pthread_cond_signal(&w->done);
+  }
+  pthread_mutex_unlock(&w->lock);
+  return NULL;
+}
+
+workers_t workers_new(size_t n)
+{
+  workers_t w;
+  if ( n == 0 ) {
+    long c = sysconf(_SC_NPROCESSORS_ONLN);
+    n = c < 1 ? 1 : (size_t)c;
+  }
+  if ( (w = (workers_t)malloc(sizeof(*w))) == NULL )
+    error(1, errno, "malloc failure");
+  w->n = n;
+  if ( (w->th = (pthread_t*)malloc(n * sizeof(pthread_t))) == NULL
+       || (w->dq = (wsdeques_t*)malloc(n * sizeof(wsdeques_t))) == NULL )
+    error(1, errno, "malloc failure");
+  for ( size_t i = 0; i < n; i++ ) w->dq[i] = wsdeques_new(DEQUE);
+  atomic_init(&w->pending, 0);
+  atomic_init(&w->stop, 0);
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->go, NULL);
+  pthread_cond_init(&w->done, NULL);
+  w->gen = w->active = 0;
+  w->quit = 0;
+  for ( size_t i = 1; i < n; i++ ) {
+    void **arg;
+    if ( (arg = (void**)malloc(2 * sizeof(void*))) == NULL )
+      error(1, errno, "malloc failure");
+    arg[0] = w;
+    arg[1] = (void*)(uintptr_t)i;
+    if ( (errno = pthread_create(&w->th[i], NULL, _thread, arg)) != 0 )
+      error(1, errno, "pthread_create failure");
+  }
+  return w;
+}
+
+int workers_run(workers_t w, workers_task apply, void *x, void *y)
+{
+  w->apply = apply;
+  w->y = y;
+  atomic_store(&w->stop, 0);
+  atomic_store(&w->pending, 1);
+  wsdeques_push(w->dq[0], x);
+  pthread_mutex_lock(&w->lock);
+  w->gen++;
+  w->active = w->n - 1;
+  pthread_cond_broadcast(&w->go);
+  pthread_mutex_unlock(&w->lock);
+
+  _work(w, 0);
+
+  pthread_mutex_lock(&w->lock);
+  while ( w->active > 0 ) pthread_cond_wait(&w->done, &w->lock);
+  pthread_mutex_unlock(&w->lock);
+  return atomic_load(&w->stop) ? -1 : 1;
+}
+
+void workers_spawn(workers_t w, void *x)
+{
+  atomic_fetch_add_explicit(&w->pending, 1, memory_order_relaxed);
+  wsdeques_push(w->dq[_self.id], x);
+}
+
+void workers_stop(workers_t w)
+{
+  atomic_store_explicit(&w->stop, 1, memory_order_relaxed);
+}
+
+int workers_stopped(workers_t w)
+{
+  return atomic_load_explicit(&w->stop, memory_order_relaxed) ? 1 : -1;
+}
+
+size_t workers_self(workers_t w)
+{
+  (void)w;
+  return _self.id;
+}
+
+size_t workers_count(workers_t w)
+{
+  return w->n;
+}
+
+void workers_free(workers_t *w)
+{
+  if ( w == NULL || *w == NULL ) return;
+  workers_t p = *w;
+  pthread_mutex_lock(&p->lock);
+  p->quit = 1;
+  pthread_cond_broadcast(&p->go);
+  pthread_mutex_unlock(&p->lock);
+  for ( size_t i = 1; i < p->n; i++ ) pthread_join(p->th[i], NULL);
+  for ( size_t i = 0; i < p->n; i++ ) wsdeques_free(&p->dq[i]);
+  pthread_mutex_destroy(&p->lock);
+  pthread_cond_destroy(&p->go);
+  pthread_cond_destroy(&p->done);
+  free(p->th);
+  free(p->dq);
+  free(p);
+  *w = NULL;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file wsdeques.c
+ * @brief Implementation of <tt>wsdeques_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <wsdeques.h>
+# include <stdint.h>
+# include <stdatomic.h>
+# define COUNTS_KIND COUNTERS_WSDEQUES
+# include "allocs.h"
+# include "epochs.h"
+
+/**
+ * @brief Circular array of a deque, replaced when full.
+ */
+typedef struct {
+  int64_t mask;       ///< capacity - 1
+  allocators_t al;    ///< allocator of the array
+  _Atomic(void*) x[]; ///< slots
+} ring_t;
+
+/**
+ * @brief <tt>wsdeques_t</tt> class object.
+ */
+struct wsdeques_t {
+  _Atomic int64_t top;    ///< next slot to be stolen
+  _Atomic int64_t bottom; ///< next slot to be pushed by the owner
+  _Atomic(ring_t*) ring;  ///< current array
+  allocators_t al;        ///< allocator of the deque
+};
+
+static
+ring_t *_ring_new(const allocators_t *al, int64_t cap)
+{
+  ring_t *a = (ring_t*)_amalloc(al, sizeof(ring_t) + cap * sizeof(a->x[0]));
+  a->mask = cap - 1;
+  a->al = *al;
+  return a;
+}
+
+static
+void _ring_free(void *p)
+{
+  ring_t *a = (ring_t*)p;
+  allocators_t al = a->al;
+  _afree(&al, a);
+}
+
+wsdeques_t wsdeques_new(size_t capacity)
+{
+  return wsdeques_new_alloc(capacity, &allocators_std);
+}
+
+wsdeques_t wsdeques_new_alloc(size_t capacity, const allocators_t *al)
+{
+  wsdeques_t d;
+  int64_t c = 2;
+  while ( (size_t)c < capacity ) c <<= 1;
+  d = (wsdeques_t)_amalloc(al, sizeof(*d));
+  d->al = *al;
+  atomic_init(&d->top, 0);
+  atomic_init(&d->bottom, 0);
+  atomic_init(&d->ring, _ring_new(al, c));
+  return d;
+}
+
+/* copy the live slots into an array twice as long; thieves may still read a */
+static
+ring_t *_grow(wsdeques_t d, ring_t *a, int64_t t, int64_t b)
+{
+  ring_t *n = _ring_new(&d->al, (a->mask + 1) << 1);
+  for ( int64_t i = t; i < b; i++ )
+    atomic_store_explicit(&n->x[i & n->mask],
+                          atomic_load_explicit(&a->x[i & a->mask],
+                                               memory_order_relaxed),
+                          memory_order_relaxed);
+  atomic_store_explicit(&d->ring, n, memory_order_release);
+  epochs_retire(a, _ring_free);
+  return n;
+}
+
+void wsdeques_push(wsdeques_t d, void *x)
+{
+  int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+  int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  ring_t *a = atomic_load_explicit(&d->ring, memory_order_relaxed);
+  if ( b - t > a->mask ) a = _grow(d, a, t, b);
+  atomic_store_explicit(&a->x[b & a->mask], x, memory_order_relaxed);
+  atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+}
+
+void *wsdeques_pop(wsdeques_t d)
+{
+  int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+  ring_t *a = atomic_load_explicit(&d->ring, memory_order_relaxed);
+  atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+  void *x = NULL;
+  if ( t <= b ) {
+    x = atomic_load_explicit(&a->x[b & a->mask], memory_order_relaxed);
+    if ( t == b ) {
+      /* last element: race the thieves for it */
+      if ( !atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                    memory_order_seq_cst,
+                                                    memory_order_relaxed) )
+        x = NULL;
+      atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+  }
+  else atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+  return x;
+}
+
+void *wsdeques_steal(wsdeques_t d)
+{
+  void *x = NULL;
+  epochs_enter();
+  int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+  if ( t < b ) {
+    ring_t *a = atomic_load_explicit(&d->ring, memory_order_acquire);
+    x = atomic_load_explicit(&a->x[t & a->mask], memory_order_relaxed);
+    if ( !atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                  memory_order_seq_cst,
+                                                  memory_order_relaxed) )
+      x = NULL;
+  }
+  epochs_exit();
+  return x;
+}
+
+size_t wsdeques_size(wsdeques_t d)
+{
+  int64_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+  int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  return b > t ? (size_t)(b - t) : 0;
+}
+
+void wsdeques_free(wsdeques_t *d)
+{
+  if ( d == NULL || *d == NULL ) return;
+  allocators_t al = (*d)->al;
+  _ring_free(atomic_load(&(*d)->ring));
+  _afree(&al, *d);
+  *d = NULL;
+}
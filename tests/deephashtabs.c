@@ -0,0 +1,63 @@
+/**
+ * @file deephashtabs.c
+ * @brief Tests of <tt>dhashtabs_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <deephashtabs.h>
+
+enum { N = 64 };
+
+static int *fresh[N];
+
+static
+int _cmp(const void *x, const void *y)
+{
+  int a = *(const int*)x, b = *(const int*)y;
+  return (a > b) - (a < b);
+}
+
+static
+uint64_t _hash(const void *x)
+{
+  return (uint64_t)*(const int*)x;
+}
+
+/* replaces the element by a new record of the same value */
+static
+int _replace(void **x)
+{
+  int *p = (int*)malloc(sizeof(int));
+  if ( p == NULL ) return -1;
+  *p = *(int*)*x;
+  free(*x);
+  *x = fresh[*p] = p;
+  return 1;
+}
+
+/* elements replaced through dhashtabs_map in inline buckets are kept */
+static
+int _map_replace(void)
+{
+  dhashtabs_t t = dhashtabs_new(_cmp, NULL, _hash, NULL, 16 * N, sizeof(int));
+  dhashtabs_stats_t st;
+  int bad = 0;
+  for ( int i = 0; i < N; i++ ) dhashtabs_insert(t, &i);
+  dhashtabs_stats(t, &st);
+  bad += st.max_chain > 2;
+  bad += dhashtabs_map(t, _replace) != 1;
+  for ( int i = 0; i < N; i++ ) bad += dhashtabs_find(t, &i) != fresh[i];
+  dhashtabs_free(&t);
+  return bad;
+}
+
+int main(void)
+{
+  if ( _map_replace() ) {
+    fprintf(stderr, "elements replaced by dhashtabs_map lost\n");
+    return 1;
+  }
+  return 0;
+}
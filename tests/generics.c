@@ -0,0 +1,42 @@
+/**
+ * @file generics.c
+ * @brief Tests of the containers emitted by <tt>generics.h</tt>.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <stdio.h>
+# include <stdint.h>
+# include <generics.h>
+
+# define HASH(k) ((uint64_t)(k) * 0x9E3779B97F4A7C15u)
+# define EQ(a, b) ((a) == (b))
+
+DEFINE_HASHTAB(ints, int, HASH, EQ)
+
+/* each grow past a load of 3/4 doubles the slots, starting from 8 */
+static
+int _grow_doubles(void)
+{
+  ints_t t;
+  size_t slots = 8;
+  int bad = 0;
+  ints_init(&t, 0);
+  bad += t.mask + 1 != slots;
+  for ( int i = 0; i < 1 << 12; i++ ) {
+    if ( t.size == slots - (slots >> 2) ) slots <<= 1;
+    bad += ints_insert(&t, i) != 1;
+    bad += t.mask + 1 != slots;
+  }
+  for ( int i = 0; i < 1 << 12; i++ ) bad += ints_find(&t, i) == NULL;
+  ints_destroy(&t);
+  return bad;
+}
+
+int main(void)
+{
+  if ( _grow_doubles() ) {
+    fprintf(stderr, "hash table capacity not doubled by a grow\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file unrolledstacks.c
+ * @brief Tests of <tt>ustacks_t</tt> class.
+ * @author Thomas Pender
+ */
+# include <config.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <malloc.h>
+# include <unrolledstacks.h>
+
+/* frees after overwriting the block, so that reads of freed chunks show */
+static
+void *_alloc(size_t n, void *ctx)
+{
+  (void)ctx;
+  return malloc(n);
+}
+
+static
+void *_realloc(void *p, size_t n, void *ctx)
+{
+  (void)ctx;
+  return realloc(p, n);
+}
+
+static
+void _free(void *p, void *ctx)
+{
+  (void)ctx;
+  if ( p != NULL ) memset(p, 0xA5, malloc_usable_size(p));
+  free(p);
+}
+
+static const allocators_t scribble = { _alloc, _realloc, _free, NULL };
+
+/* pops many elements without a push between, then reads every one of them */
+static
+int _pop_then_read(void)
+{
+  enum { N = 100000 };
+  static const int *popped[N];
+  ustacks_t s = ustacks_new_alloc(sizeof(int), &scribble);
+  int bad = 0;
+  for ( int i = 0; i < N; i++ ) ustacks_push(s, &i);
+  for ( int i = 0; i < N; i++ ) popped[i] = (const int*)ustacks_pop(s);
+  for ( int i = 0; i < N; i++ ) bad += *popped[i] != N - 1 - i;
+  ustacks_free(&s);
+  return bad;
+}
+
+/* a push after the pops reuses and frees the emptied chunks */
+static
+int _pop_then_push(void)
+{
+  ustacks_t s = ustacks_new_alloc(sizeof(int), &scribble);
+  int bad = 0;
+  for ( int round = 0; round < 4; round++ ) {
+    for ( int i = 0; i < 50000; i++ ) ustacks_push(s, &i);
+    for ( int i = 49999; i >= 25000; i-- )
+      bad += *(const int*)ustacks_pop(s) != i;
+  }
+  bad += ustacks_size(s) != 100000;
+  for ( int round = 3; round >= 0; round-- )
+    for ( int i = 24999; i >= 0; i-- )
+      bad += *(const int*)ustacks_pop(s) != i;
+  bad += ustacks_pop(s) != NULL;
+  ustacks_free(&s);
+  return bad;
+}
+
+int main(void)
+{
+  int bad = 0;
+  if ( _pop_then_read() ) {
+    fprintf(stderr, "popped elements overwritten before the next push\n");
+    bad = 1;
+  }
+  if ( _pop_then_push() ) {
+    fprintf(stderr, "elements lost across pops and pushes\n");
+    bad = 1;
+  }
+  return bad;
+}